@@ -0,0 +1,260 @@
+using System.Diagnostics;
+using System.Globalization;
+using System.Runtime.InteropServices;
+using System.Text;
+using GoldsrcFramework.Bsp;
+using GoldsrcFramework.Engine.Native;
+using NativeInterop;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of one <see cref="EntityLumpBenchmark"/> run.
+/// </summary>
+public readonly record struct EntityLumpBenchmarkResult(
+    int Entities,
+    int Pairs,
+    int LumpBytes,
+    int ManagedEntities,
+    double PerPairMilliseconds,
+    double ParseMilliseconds,
+    double BindMilliseconds,
+    double DispatchMilliseconds,
+    long PerPairAllocatedBytes,
+    long BulkAllocatedBytes);
+
+/// <summary>
+/// Headless benchmark of map-load keyvalue handling on a synthetic map (lights, brush entities, monsters and a
+/// managed <c>info_marker</c> class), or on the entity lump of a real .bsp.
+///
+/// Per pair: what a managed KeyValue does today for every DispatchKeyValue call — marshal classname, key and value
+/// to strings, switch on the key, parse with the BCL. Bulk: <see cref="EntityLump.Parse"/> over the whole lump,
+/// <see cref="MapEntities.Load"/> with compiled setters, then the same DispatchKeyValue sequence answered by
+/// <see cref="MapEntities.TryHandleKeyValue"/>. The engine's own parsing of the lump is not timed in either.
+/// </summary>
+public static unsafe class EntityLumpBenchmark
+{
+    private enum MarkerMode { Off, Pulse, Orbit }
+
+    private sealed class Marker
+    {
+        [KeyValue("origin")] public System.Numerics.Vector3 Origin;
+        [KeyValue("angles")] public System.Numerics.Vector3 Angles;
+        [KeyValue("targetname")] public string? TargetName;
+        [KeyValue("radius")] public float Radius;
+        [KeyValue("count")] public int Count;
+        [KeyValue("spawnflags")] public int SpawnFlags;
+        [KeyValue("mode")] public MarkerMode Mode;
+        [KeyValue("enabled")] public bool Enabled { get; set; }
+
+        public double Checksum() =>
+            Origin.X + Origin.Y * 3 + Origin.Z * 7 + Angles.Y + Radius + Count * 11 + SpawnFlags + (int)Mode * 13 +
+            (Enabled ? 17 : 0) + (TargetName?.Length ?? 0);
+    }
+
+    public static void RunAndPrint(int entities = 8000, int iterations = 20, string? bspPath = null)
+    {
+        var r = bspPath != null ? RunFile(bspPath, iterations) : Run(entities, iterations);
+        Console.WriteLine($"[EntityLumpBenchmark] {r.Entities} entities, {r.Pairs} keyvalues, {r.LumpBytes / 1024} KB lump, {r.ManagedEntities} managed");
+        Console.WriteLine($"[EntityLumpBenchmark] per pair: {r.PerPairMilliseconds:F2} ms/map, {r.PerPairAllocatedBytes / 1024} KB allocated");
+        Console.WriteLine($"[EntityLumpBenchmark] bulk:     {r.ParseMilliseconds + r.BindMilliseconds + r.DispatchMilliseconds:F2} ms/map " +
+                          $"(parse {r.ParseMilliseconds:F2}, {r.LumpBytes / 1e3 / r.ParseMilliseconds:F0} MB/s; bind {r.BindMilliseconds:F2}; dispatch {r.DispatchMilliseconds:F2}), " +
+                          $"{r.BulkAllocatedBytes / 1024} KB allocated");
+    }
+
+    public static EntityLumpBenchmarkResult Run(int entities, int iterations) => Run(BuildLump(entities), iterations);
+
+    /// <summary>
+    /// Benchmark the entity lump of <paramref name="bspPath"/>.
+    /// </summary>
+    public static EntityLumpBenchmarkResult RunFile(string bspPath, int iterations)
+    {
+        using var bsp = BspFile.Open(bspPath);
+        return Run(bsp.Entities.ToArray(), iterations);
+    }
+
+    private static EntityLumpBenchmarkResult Run(byte[] text, int iterations)
+    {
+        var classes = new MapEntityClasses();
+        classes.Register<Marker>("info_marker");
+
+        // Stand-in for the engine: every pair as native strings, in dispatch order.
+        var reference = EntityLump.Parse(text);
+        var natives = new List<nint>();
+        var pairs = new (int Entity, nint Classname, nint Key, nint Value)[reference.PairCount];
+        int n = 0;
+        for (int e = 0; e < reference.Count; e++)
+        {
+            var record = reference[e];
+            nint classname = Native(record.Classname.Span, natives);
+            for (int p = 0; p < record.PairCount; p++)
+                pairs[n++] = (e, classname, Native(record.Key(p).Span, natives), Native(record.Value(p).Span, natives));
+        }
+        var edicts = (edict_t*)NativeMemory.AllocZeroed((nuint)Math.Max(reference.Count, 1), (nuint)sizeof(edict_t));
+
+        try
+        {
+            double perPairChecksum = 0, bulkChecksum = 0;
+            PerPair(pairs, ref perPairChecksum);
+            Bulk(text, classes, pairs, edicts, ref bulkChecksum, out _, out _, out _);
+
+            long allocated = GC.GetAllocatedBytesForCurrentThread();
+            long start = Stopwatch.GetTimestamp();
+            for (int i = 0; i < iterations; i++)
+            {
+                perPairChecksum = 0;
+                PerPair(pairs, ref perPairChecksum);
+            }
+            var perPairTime = Stopwatch.GetElapsedTime(start);
+            long perPairAllocated = (GC.GetAllocatedBytesForCurrentThread() - allocated) / iterations;
+
+            TimeSpan parse = default, bind = default, dispatch = default;
+            int managed = 0;
+            allocated = GC.GetAllocatedBytesForCurrentThread();
+            for (int i = 0; i < iterations; i++)
+            {
+                bulkChecksum = 0;
+                managed = Bulk(text, classes, pairs, edicts, ref bulkChecksum, out var p, out var b, out var d);
+                parse += p;
+                bind += b;
+                dispatch += d;
+            }
+            long bulkAllocated = (GC.GetAllocatedBytesForCurrentThread() - allocated) / iterations;
+
+            return new EntityLumpBenchmarkResult(reference.Count, reference.PairCount, text.Length, managed,
+                perPairTime.TotalMilliseconds / iterations,
+                parse.TotalMilliseconds / iterations,
+                bind.TotalMilliseconds / iterations,
+                dispatch.TotalMilliseconds / iterations,
+                perPairAllocated,
+                bulkAllocated);
+        }
+        finally
+        {
+            foreach (var p in natives)
+                NativeMemory.Free((void*)p);
+            NativeMemory.Free(edicts);
+        }
+    }
+
+    // A hand-written managed KeyValue, one call per pair.
+    private static void PerPair((int Entity, nint Classname, nint Key, nint Value)[] pairs, ref double checksum)
+    {
+        Marker? current = null;
+        int currentEntity = -1;
+        foreach (var (entity, classnamePtr, keyPtr, valuePtr) in pairs)
+        {
+            string classname = Marshal.PtrToStringUTF8(classnamePtr)!;
+            if (entity != currentEntity)
+            {
+                if (current != null)
+                    checksum += current.Checksum();
+                currentEntity = entity;
+                current = classname == "info_marker" ? new Marker() : null;
+            }
+            if (current == null)
+                continue;
+
+            string key = Marshal.PtrToStringUTF8(keyPtr)!;
+            string value = Marshal.PtrToStringUTF8(valuePtr)!;
+            switch (key)
+            {
+                case "origin": current.Origin = ParseVector(value); break;
+                case "angles": current.Angles = ParseVector(value); break;
+                case "targetname": current.TargetName = value; break;
+                case "radius": current.Radius = float.Parse(value, CultureInfo.InvariantCulture); break;
+                case "count": current.Count = int.Parse(value, CultureInfo.InvariantCulture); break;
+                case "spawnflags": current.SpawnFlags = int.Parse(value, CultureInfo.InvariantCulture); break;
+                case "mode": current.Mode = (MarkerMode)int.Parse(value, CultureInfo.InvariantCulture); break;
+                case "enabled": current.Enabled = int.Parse(value, CultureInfo.InvariantCulture) != 0; break;
+            }
+        }
+        if (current != null)
+            checksum += current.Checksum();
+    }
+
+    private static System.Numerics.Vector3 ParseVector(string value)
+    {
+        var parts = value.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+        float Get(int i) => i < parts.Length ? float.Parse(parts[i], CultureInfo.InvariantCulture) : 0;
+        return new System.Numerics.Vector3(Get(0), Get(1), Get(2));
+    }
+
+    private static int Bulk(byte[] text, MapEntityClasses classes, (int Entity, nint Classname, nint Key, nint Value)[] pairs,
+        edict_t* edicts, ref double checksum, out TimeSpan parse, out TimeSpan bind, out TimeSpan dispatch)
+    {
+        long start = Stopwatch.GetTimestamp();
+        var lump = EntityLump.Parse(text);
+        parse = Stopwatch.GetElapsedTime(start);
+
+        start = Stopwatch.GetTimestamp();
+        var entities = MapEntities.Load(lump, classes);
+        bind = Stopwatch.GetElapsedTime(start);
+
+        start = Stopwatch.GetTimestamp();
+        KeyValueData kvd = default;
+        int currentEntity = -1;
+        foreach (var (entity, classname, key, value) in pairs)
+        {
+            if (entity != currentEntity)
+            {
+                if (currentEntity >= 0)
+                    entities.OnSpawn(&edicts[currentEntity]);
+                currentEntity = entity;
+            }
+            kvd.szClassName = (NChar*)classname;
+            kvd.szKeyName = (NChar*)key;
+            kvd.szValue = (NChar*)value;
+            kvd.fHandled = 0;
+            entities.TryHandleKeyValue(&edicts[entity], &kvd);
+        }
+        entities.EndLoad();
+        dispatch = Stopwatch.GetElapsedTime(start);
+
+        for (int e = 0; e < lump.Count; e++)
+        {
+            if (entities.Get<Marker>(&edicts[e]) is { } marker)
+                checksum += marker.Checksum();
+        }
+        return entities.ManagedCount;
+    }
+
+    private static nint Native(ReadOnlySpan<byte> text, List<nint> natives)
+    {
+        var p = (byte*)NativeMemory.AllocZeroed((nuint)text.Length + 1);
+        text.CopyTo(new Span<byte>(p, text.Length));
+        natives.Add((nint)p);
+        return (nint)p;
+    }
+
+    private static byte[] BuildLump(int entities)
+    {
+        var sb = new StringBuilder(entities * 160);
+        sb.Append("{\n\"classname\" \"worldspawn\"\n\"wad\" \"\\half-life\\valve\\halflife.wad\"\n\"mapversion\" \"220\"\n}\n");
+        var random = new Random(1234);
+        for (int i = 1; i < entities; i++)
+        {
+            string origin = $"{random.Next(-4096, 4096)} {random.Next(-4096, 4096)} {random.Next(-512, 512)}";
+            sb.Append("{\n");
+            switch (i % 4)
+            {
+                case 0:
+                    sb.Append($"\"origin\" \"{origin}\"\n\"targetname\" \"marker{i}\"\n\"radius\" \"{random.Next(8, 512)}.5\"\n");
+                    sb.Append($"\"count\" \"{i % 17}\"\n\"spawnflags\" \"{i % 8}\"\n\"mode\" \"{i % 3}\"\n\"enabled\" \"{i % 2}\"\n");
+                    sb.Append($"\"angles\" \"0 {i % 360} 0\"\n\"classname\" \"info_marker\"\n");
+                    break;
+                case 1:
+                    sb.Append($"\"origin\" \"{origin}\"\n\"_light\" \"255 255 128 {100 + i % 200}\"\n\"style\" \"{i % 12}\"\n\"classname\" \"light\"\n");
+                    break;
+                case 2:
+                    sb.Append($"\"model\" \"*{i}\"\n\"rendermode\" \"4\"\n\"renderamt\" \"255\"\n\"classname\" \"func_wall\"\n");
+                    break;
+                default:
+                    sb.Append($"\"origin\" \"{origin}\"\n\"angles\" \"0 {i % 360} 0\"\n\"targetname\" \"zombie{i}\"\n// spawn later\n\"spawnflags\" \"32\"\n\"classname\" \"monster_zombie\"\n");
+                    break;
+            }
+            sb.Append("}\n");
+        }
+        return Encoding.UTF8.GetBytes(sb.ToString() + "\0");
+    }
+}
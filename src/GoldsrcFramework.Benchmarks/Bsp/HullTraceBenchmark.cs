@@ -0,0 +1,88 @@
+using System.Diagnostics;
+using GoldsrcFramework.Bsp;
+using GoldsrcFramework.LinearMath;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of a <see cref="HullTraceBenchmark"/> run.
+/// </summary>
+public readonly record struct HullTraceBenchmarkResult(
+    int TraceCount,
+    double SerialMilliseconds,
+    double BatchMilliseconds,
+    double SerialNanosecondsPerTrace,
+    double BatchNanosecondsPerTrace,
+    int Hits);
+
+/// <summary>
+/// Headless benchmark for <see cref="HullCollisionModel"/>: random traces across the world bounds of a .bsp,
+/// all four hulls, single-threaded and through <see cref="HullCollisionModel.TraceBatch"/>.
+/// </summary>
+public static class HullTraceBenchmark
+{
+    /// <summary>
+    /// Run against <paramref name="bspPath"/> and print the results to the console.
+    /// </summary>
+    public static void RunAndPrint(string bspPath, int traceCount = 200_000)
+    {
+        var r = Run(bspPath, traceCount);
+        Console.WriteLine($"[HullTraceBenchmark] {Path.GetFileName(bspPath)}: {r.TraceCount} traces, {r.Hits} hits; " +
+                          $"serial {r.SerialMilliseconds:F1} ms ({r.SerialNanosecondsPerTrace:F0} ns/trace), " +
+                          $"batch {r.BatchMilliseconds:F1} ms ({r.BatchNanosecondsPerTrace:F0} ns/trace) on {Environment.ProcessorCount} cores");
+    }
+
+    public static HullTraceBenchmarkResult Run(string bspPath, int traceCount = 200_000, int seed = 1234)
+    {
+        HullCollisionModel model;
+        Vector3 mins, maxs;
+        using (var bsp = BspFile.Open(bspPath))
+        {
+            model = HullCollisionModel.LoadWorld(bsp);
+            ref readonly var world = ref bsp.Models[0];
+            mins = new Vector3(world.mins[0], world.mins[1], world.mins[2]);
+            maxs = new Vector3(world.maxs[0], world.maxs[1], world.maxs[2]);
+        }
+
+        var rng = new Random(seed);
+        var requests = new HullTraceRequest[traceCount];
+        for (int i = 0; i < requests.Length; i++)
+        {
+            var start = RandomPoint(rng, mins, maxs);
+            var end = RandomPoint(rng, mins, maxs);
+            requests[i] = new HullTraceRequest(start, end, i & 3);
+        }
+
+        var results = new HullTraceResult[traceCount];
+
+        // Warm up both paths.
+        model.TraceRange(requests.AsSpan(0, Math.Min(1024, traceCount)), results);
+        model.TraceBatch(requests.AsMemory(0, Math.Min(4096, traceCount)), results);
+
+        long start0 = Stopwatch.GetTimestamp();
+        model.TraceRange(requests, results);
+        var serial = Stopwatch.GetElapsedTime(start0);
+
+        long start1 = Stopwatch.GetTimestamp();
+        model.TraceBatch(requests, results);
+        var batch = Stopwatch.GetElapsedTime(start1);
+
+        int hits = 0;
+        foreach (ref readonly var r in results.AsSpan())
+        {
+            if (r.Fraction < 1)
+                hits++;
+        }
+
+        return new HullTraceBenchmarkResult(traceCount, serial.TotalMilliseconds, batch.TotalMilliseconds,
+            serial.TotalMilliseconds * 1_000_000.0 / traceCount, batch.TotalMilliseconds * 1_000_000.0 / traceCount, hits);
+    }
+
+    private static Vector3 RandomPoint(Random rng, Vector3 mins, Vector3 maxs)
+    {
+        return new Vector3(
+            mins.X + rng.NextSingle() * (maxs.X - mins.X),
+            mins.Y + rng.NextSingle() * (maxs.Y - mins.Y),
+            mins.Z + rng.NextSingle() * (maxs.Z - mins.Z));
+    }
+}
@@ -0,0 +1,288 @@
+using System.Diagnostics;
+using GoldsrcFramework.Bsp;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of a <see cref="VisibilityBenchmark"/> run. PVS and entity times are per client, union times per frame.
+/// </summary>
+public readonly record struct VisibilityBenchmarkResult(
+    int Leafs,
+    int Entities,
+    int Clients,
+    double DecodeNanoseconds,
+    double CachedNanoseconds,
+    double ScanMicroseconds,
+    double CollectMicroseconds,
+    double UnionScalarNanoseconds,
+    double UnionNanoseconds,
+    double AllPasMilliseconds,
+    double LazyPasMilliseconds,
+    int PasRowsUsed,
+    VisibilityCacheStats Stats);
+
+/// <summary>
+/// Headless benchmark for <see cref="VisibilityCache"/> and <see cref="EntityLeafMap"/>, on a .bsp or on a synthetic
+/// grid map: per-call visdata decoding (what ENGINE_SET_PVS does) against cached rows, testing every entity's leafs
+/// against a PVS (AddToFullPack's CheckVisibility) against walking the occupied leafs of the PVS, a scalar against a
+/// vectorized union of client PVS rows, and SV_CalcPAS's all-leafs PAS against the PAS of the leafs clients use.
+/// </summary>
+public static class VisibilityBenchmark
+{
+    private const float CellSize = 128;
+
+    /// <summary>
+    /// Run on a synthetic <paramref name="grid"/> x <paramref name="grid"/> map where each leaf sees the leafs within
+    /// <paramref name="sight"/> cells, and print the results to the console.
+    /// </summary>
+    public static void RunAndPrint(int grid = 64, int sight = 8, int entities = 1024, int clients = 32)
+    {
+        var r = Run(CreateGrid(grid, sight), new Vector3(0, 0, 0), new Vector3(grid * CellSize, grid * CellSize, 256), entities, clients);
+        Print($"grid {grid}x{grid}, sight {sight}", r);
+    }
+
+    /// <summary>
+    /// Run against <paramref name="bspPath"/> with random entities and viewers inside the world bounds.
+    /// </summary>
+    public static void RunAndPrint(string bspPath, int entities = 1024, int clients = 32)
+    {
+        VisibilityCache cache;
+        Vector3 mins, maxs;
+        using (var bsp = BspFile.Open(bspPath))
+        {
+            cache = VisibilityCache.Load(bsp);
+            ref readonly var world = ref bsp.Models[0];
+            mins = new Vector3(world.mins[0], world.mins[1], world.mins[2]);
+            maxs = new Vector3(world.maxs[0], world.maxs[1], world.maxs[2]);
+        }
+        Print(Path.GetFileName(bspPath), Run(cache, mins, maxs, entities, clients));
+    }
+
+    private static void Print(string name, in VisibilityBenchmarkResult r)
+    {
+        Console.WriteLine($"[VisibilityBenchmark] {name}: {r.Leafs} leafs, {r.Entities} entities, {r.Clients} clients");
+        Console.WriteLine($"[VisibilityBenchmark]   pvs: decode {r.DecodeNanoseconds:F0} ns, cached {r.CachedNanoseconds:F0} ns per client");
+        Console.WriteLine($"[VisibilityBenchmark]   entities in pvs: scan {r.ScanMicroseconds:F2} us, leaf map {r.CollectMicroseconds:F2} us per client");
+        Console.WriteLine($"[VisibilityBenchmark]   union of {r.Clients} clients: scalar {r.UnionScalarNanoseconds:F0} ns, vector {r.UnionNanoseconds:F0} ns");
+        Console.WriteLine($"[VisibilityBenchmark]   pas: all leafs {r.AllPasMilliseconds:F1} ms, lazy {r.LazyPasMilliseconds:F2} ms for {r.PasRowsUsed} rows");
+        Console.WriteLine($"[VisibilityBenchmark]   cache: {r.Stats}");
+    }
+
+    public static VisibilityBenchmarkResult Run(VisibilityCache cache, Vector3 mins, Vector3 maxs, int entityCount = 1024,
+        int clientCount = 32, int frames = 200, int seed = 1234)
+    {
+        var rng = new Random(seed);
+        var map = new EntityLeafMap(cache, entityCount);
+        for (int i = 0; i < entityCount; i++)
+        {
+            var center = RandomPoint(rng, mins, maxs);
+            var half = new Vector3(16 + rng.Next(64), 16 + rng.Next(64), 16 + rng.Next(64));
+            map.Update(i, center - half, center + half);
+        }
+
+        var eyes = new Vector3[clientCount];
+        var leafs = new int[clientCount];
+        for (int i = 0; i < clientCount; i++)
+        {
+            eyes[i] = RandomPoint(rng, mins, maxs);
+            leafs[i] = cache.LeafAt(eyes[i]);
+        }
+
+        int words = cache.RowWords;
+        var row = new ulong[words];
+        var entitySet = new ulong[map.EntityWords];
+        var rows = new ulong[clientCount * words];
+        var union = new ulong[words];
+
+        // Decode on every call vs cached rows, warmed so the cached pass measures hits.
+        for (int c = 0; c < clientCount; c++)
+            cache.GetPvs(leafs[c]);
+        long start = Stopwatch.GetTimestamp();
+        for (int f = 0; f < frames; f++)
+        {
+            for (int c = 0; c < clientCount; c++)
+                cache.DecompressPvs(cache.LeafAt(eyes[c]), row);
+        }
+        double decode = PerCall(start, frames * clientCount) * 1000;
+
+        start = Stopwatch.GetTimestamp();
+        for (int f = 0; f < frames; f++)
+        {
+            for (int c = 0; c < clientCount; c++)
+                cache.GetPvs(cache.LeafAt(eyes[c])).CopyTo(row);
+        }
+        double cached = PerCall(start, frames * clientCount) * 1000;
+
+        // Entities in each client's PVS: per-entity leaf tests vs occupied-leaf walk.
+        for (int c = 0; c < clientCount; c++)
+            cache.GetPvs(leafs[c]).CopyTo(rows.AsSpan(c * words, words));
+
+        int scanned = 0, collected = 0;
+        start = Stopwatch.GetTimestamp();
+        for (int f = 0; f < frames; f++)
+        {
+            for (int c = 0; c < clientCount; c++)
+            {
+                var pvs = rows.AsSpan(c * words, words);
+                for (int e = 0; e < entityCount; e++)
+                {
+                    if (map.IsInSet(e, pvs))
+                        scanned++;
+                }
+            }
+        }
+        double scanTime = PerCall(start, frames * clientCount);
+
+        start = Stopwatch.GetTimestamp();
+        for (int f = 0; f < frames; f++)
+        {
+            for (int c = 0; c < clientCount; c++)
+                collected += map.CollectInSet(rows.AsSpan(c * words, words), entitySet);
+        }
+        double collect = PerCall(start, frames * clientCount);
+
+        // Union of every client's PVS.
+        var scalarUnion = new ulong[words];
+        start = Stopwatch.GetTimestamp();
+        for (int f = 0; f < frames * 10; f++)
+        {
+            Array.Clear(scalarUnion);
+            for (int c = 0; c < clientCount; c++)
+            {
+                for (int w = 0; w < words; w++)
+                    scalarUnion[w] |= rows[c * words + w];
+            }
+        }
+        double unionScalar = PerCall(start, frames * 10) * 1000;
+
+        start = Stopwatch.GetTimestamp();
+        for (int f = 0; f < frames * 10; f++)
+        {
+            union.AsSpan().Clear();
+            for (int c = 0; c < clientCount; c++)
+                VisBits.Or(union, rows.AsSpan(c * words, words));
+        }
+        double unionVector = PerCall(start, frames * 10) * 1000;
+
+        // SV_CalcPAS builds every leaf's PAS at load; the cache only builds those asked for.
+        start = Stopwatch.GetTimestamp();
+        var pas = new ulong[words];
+        var scan = new ulong[words];
+        for (int leaf = 1; leaf <= cache.LeafCount; leaf++)
+        {
+            cache.DecompressPvs(leaf, scan);
+            scan.CopyTo(pas, 0);
+            for (int bit = 0; bit < cache.LeafCount; bit++)
+            {
+                if (VisBits.Test(scan, bit))
+                {
+                    cache.DecompressPvs(bit + 1, row);
+                    VisBits.Or(pas, row);
+                }
+            }
+        }
+        double allPas = Stopwatch.GetElapsedTime(start).TotalMilliseconds;
+
+        start = Stopwatch.GetTimestamp();
+        for (int c = 0; c < clientCount; c++)
+            cache.GetPas(leafs[c]);
+        double lazyPas = Stopwatch.GetElapsedTime(start).TotalMilliseconds;
+
+        return new VisibilityBenchmarkResult(cache.LeafCount, entityCount, clientCount, decode, cached, scanTime, collect,
+            unionScalar, unionVector, allPas, lazyPas, cache.Stats.PasRows, cache.Stats);
+    }
+
+    /// <summary>
+    /// Flat map of <paramref name="grid"/> x <paramref name="grid"/> leafs split by a kd-tree of axial planes,
+    /// where each leaf sees every leaf within <paramref name="sight"/> cells; visdata compressed as vis does.
+    /// </summary>
+    public static VisibilityCache CreateGrid(int grid, int sight, int budgetBytes = VisibilityCache.DefaultBudgetBytes)
+    {
+        int leafCount = grid * grid;
+        var nodes = new List<dnode_t>();
+        var planes = new List<dplane_t>();
+        int head = BuildNode(nodes, planes, 0, grid, 0, grid, grid);
+
+        int rowBytes = (leafCount + 7) >> 3;
+        var row = new byte[rowBytes];
+        var vis = new List<byte>();
+        var offsets = new int[leafCount + 1];
+        var contents = new int[leafCount + 1];
+        offsets[0] = -1;
+        contents[0] = BspConstants.CONTENTS_SOLID;
+        for (int leaf = 1; leaf <= leafCount; leaf++)
+        {
+            contents[leaf] = BspConstants.CONTENTS_EMPTY;
+            int x = (leaf - 1) % grid, y = (leaf - 1) / grid;
+            Array.Clear(row);
+            for (int oy = Math.Max(y - sight, 0); oy <= Math.Min(y + sight, grid - 1); oy++)
+            {
+                for (int ox = Math.Max(x - sight, 0); ox <= Math.Min(x + sight, grid - 1); ox++)
+                {
+                    int bit = oy * grid + ox;
+                    row[bit >> 3] |= (byte)(1 << (bit & 7));
+                }
+            }
+            offsets[leaf] = vis.Count;
+            Compress(row, vis);
+        }
+
+        return new VisibilityCache(vis.ToArray(), offsets, contents, nodes.ToArray(), planes.ToArray(), head, leafCount, budgetBytes);
+    }
+
+    // Cells [x0, x1) x [y0, y1); leaf of cell (x, y) is 1 + y * grid + x.
+    private static int BuildNode(List<dnode_t> nodes, List<dplane_t> planes, int x0, int x1, int y0, int y1, int grid)
+    {
+        if (x1 - x0 == 1 && y1 - y0 == 1)
+            return -1 - (1 + y0 * grid + x0);
+
+        bool splitX = x1 - x0 >= y1 - y0;
+        int mid = splitX ? (x0 + x1) / 2 : (y0 + y1) / 2;
+        int plane = planes.Count;
+        planes.Add(new dplane_t
+        {
+            normal = splitX ? new Vector3(1, 0, 0) : new Vector3(0, 1, 0),
+            dist = mid * CellSize,
+            type = splitX ? 0 : 1,
+        });
+
+        int index = nodes.Count;
+        nodes.Add(default);
+        int front = splitX ? BuildNode(nodes, planes, mid, x1, y0, y1, grid) : BuildNode(nodes, planes, x0, x1, mid, y1, grid);
+        int back = splitX ? BuildNode(nodes, planes, x0, mid, y0, y1, grid) : BuildNode(nodes, planes, x0, x1, y0, mid, grid);
+
+        var node = new dnode_t { planenum = plane };
+        node.children[0] = (short)front;
+        node.children[1] = (short)back;
+        nodes[index] = node;
+        return index;
+    }
+
+    // CompressVis: runs of zero bytes become 0, count.
+    private static void Compress(ReadOnlySpan<byte> row, List<byte> output)
+    {
+        for (int i = 0; i < row.Length; i++)
+        {
+            output.Add(row[i]);
+            if (row[i] != 0)
+                continue;
+
+            int rep = 1;
+            while (i + 1 < row.Length && row[i + 1] == 0 && rep < 255)
+            {
+                i++;
+                rep++;
+            }
+            output.Add((byte)rep);
+        }
+    }
+
+    private static double PerCall(long start, int calls) => Stopwatch.GetElapsedTime(start).TotalMicroseconds / calls;
+
+    private static Vector3 RandomPoint(Random rng, Vector3 mins, Vector3 maxs) => new(
+        mins.X + (float)rng.NextDouble() * (maxs.X - mins.X),
+        mins.Y + (float)rng.NextDouble() * (maxs.Y - mins.Y),
+        mins.Z + (float)rng.NextDouble() * (maxs.Z - mins.Z));
+}
@@ -0,0 +1,182 @@
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Commands;
+using GoldsrcFramework.Engine.Native;
+using NativeInterop;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of one <see cref="CommandRouterBenchmark"/> run.
+/// </summary>
+public readonly record struct CommandRouterBenchmarkResult(
+    int Commands,
+    int Iterations,
+    double StringNanosecondsPerCommand,
+    double RouterNanosecondsPerCommand,
+    long StringAllocatedBytes,
+    long RouterAllocatedBytes);
+
+/// <summary>
+/// Headless benchmark: a stream of ClientCommands (say, buy, menuselect, ...) dispatched the way mods do it today
+/// (marshal Cmd_Argv to strings, look up a string dictionary, parse) versus through <see cref="CommandRouter"/>,
+/// against a fake engine whose Cmd_Argc / Cmd_Argv / Cmd_Args stubs serve pre-tokenized native strings.
+/// </summary>
+public static unsafe class CommandRouterBenchmark
+{
+    private static readonly string[] Names =
+    {
+        "say", "say_team", "buy", "buyammo1", "buyammo2", "menuselect", "fullupdate", "drop", "nightvision",
+        "jointeam", "joinclass", "spectate", "vote", "votemap", "listmaps", "timeleft", "chooseteam", "showbriefing",
+        "radio1", "radio2", "radio3", "follow", "lastinv", "specmode", "unpause", "VModEnable", "vban",
+        "gsf_debug", "kill", "use", "god", "noclip",
+    };
+
+    private static readonly string[] Lines =
+    {
+        "say \"gg wp everyone\"", "buy ak47", "menuselect 3", "SAY_TEAM \"rush B\"", "drop", "buyammo1",
+        "vote 2", "VModEnable 1", "vban 00000000", "specmode 4", "unknown_cmd 1 2", "radio2", "menuselect 10",
+    };
+
+    // Pre-tokenized native copies of Lines, served by the stubs.
+    private static NChar*** _argv;
+    private static int* _argc;
+    private static NChar** _args;
+    private static int _current;
+    private static long _sink;
+
+    public static void RunAndPrint(int iterations = 200_000)
+    {
+        var r = Run(iterations);
+        Console.WriteLine($"[CommandRouterBenchmark] {r.Commands} commands, {r.Iterations} dispatches");
+        Console.WriteLine($"[CommandRouterBenchmark] strings: {r.StringNanosecondsPerCommand:F1} ns/command, {r.StringAllocatedBytes} bytes allocated");
+        Console.WriteLine($"[CommandRouterBenchmark] router:  {r.RouterNanosecondsPerCommand:F1} ns/command, {r.RouterAllocatedBytes} bytes allocated");
+    }
+
+    public static CommandRouterBenchmarkResult Run(int iterations)
+    {
+        var engine = (ServerEngineFuncs*)NativeMemory.AllocZeroed((nuint)sizeof(ServerEngineFuncs));
+        var strings = new List<nint>();
+        try
+        {
+            engine->Cmd_Argc = &StubArgc;
+            engine->Cmd_Argv = &StubArgv;
+            engine->Cmd_Args = &StubArgs;
+            BuildLines(strings);
+
+            var router = new CommandRouter();
+            var legacy = new Dictionary<string, Action<string[], string>>(StringComparer.OrdinalIgnoreCase);
+            for (int i = 0; i < Names.Length; i++)
+            {
+                int id = i + 1;
+                router.Add(Names[i], (client, args) => _sink += id * 31 + args[1].ToInt32() + args.Args.Length);
+                legacy.Add(Names[i], (argv, args) => _sink += id * 31 + (argv.Length > 1 && int.TryParse(argv[1], out int n) ? n : 0) + args.Length);
+            }
+
+            // Warm up both paths.
+            DispatchStrings(engine, legacy, Lines.Length);
+            DispatchRouter(engine, router, Lines.Length);
+
+            _sink = 0;
+            long allocated = GC.GetAllocatedBytesForCurrentThread();
+            long start = Stopwatch.GetTimestamp();
+            DispatchStrings(engine, legacy, iterations);
+            var stringTime = Stopwatch.GetElapsedTime(start);
+            long stringAllocated = GC.GetAllocatedBytesForCurrentThread() - allocated;
+
+            allocated = GC.GetAllocatedBytesForCurrentThread();
+            start = Stopwatch.GetTimestamp();
+            DispatchRouter(engine, router, iterations);
+            var routerTime = Stopwatch.GetElapsedTime(start);
+            long routerAllocated = GC.GetAllocatedBytesForCurrentThread() - allocated;
+
+            return new CommandRouterBenchmarkResult(Names.Length, iterations,
+                stringTime.TotalNanoseconds / iterations,
+                routerTime.TotalNanoseconds / iterations,
+                stringAllocated,
+                routerAllocated);
+        }
+        finally
+        {
+            foreach (var p in strings)
+                NativeMemory.Free((void*)p);
+            NativeMemory.Free(engine);
+            _argv = null;
+            _argc = null;
+            _args = null;
+        }
+    }
+
+    // What a mod's ClientCommand does today.
+    private static void DispatchStrings(ServerEngineFuncs* engine, Dictionary<string, Action<string[], string>> handlers, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            _current = i % Lines.Length;
+            int argc = engine->Cmd_Argc();
+            var argv = new string[argc];
+            for (int a = 0; a < argc; a++)
+                argv[a] = Marshal.PtrToStringUTF8((nint)engine->Cmd_Argv(a))!;
+            string args = (Marshal.PtrToStringUTF8((nint)engine->Cmd_Args()) ?? string.Empty).Trim();
+
+            if (argc > 0 && handlers.TryGetValue(argv[0], out var handler))
+                handler(argv, args);
+        }
+    }
+
+    private static void DispatchRouter(ServerEngineFuncs* engine, CommandRouter router, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            _current = i % Lines.Length;
+            router.TryDispatch(null, CommandArgs.FromServer(engine));
+        }
+    }
+
+    private static void BuildLines(List<nint> strings)
+    {
+        _argv = (NChar***)NativeMemory.AllocZeroed((nuint)Lines.Length, (nuint)sizeof(NChar**));
+        _argc = (int*)NativeMemory.AllocZeroed((nuint)Lines.Length, sizeof(int));
+        _args = (NChar**)NativeMemory.AllocZeroed((nuint)Lines.Length, (nuint)sizeof(NChar*));
+        strings.Add((nint)_argv);
+        strings.Add((nint)_argc);
+        strings.Add((nint)_args);
+
+        Span<Range> tokens = stackalloc Range[16];
+        for (int l = 0; l < Lines.Length; l++)
+        {
+            var line = System.Text.Encoding.UTF8.GetBytes(Lines[l]);
+            var args = CommandArgs.Tokenize(line, tokens);
+
+            _argc[l] = args.Count;
+            _argv[l] = (NChar**)NativeMemory.AllocZeroed((nuint)args.Count, (nuint)sizeof(NChar*));
+            strings.Add((nint)_argv[l]);
+            for (int a = 0; a < args.Count; a++)
+                _argv[l][a] = Native(args[a].Span, strings);
+
+            // Cmd_Args keeps quotes and a trailing newline, as the engine's does.
+            int space = Lines[l].IndexOf(' ');
+            _args[l] = Native(space < 0 ? "\n"u8 : line.AsSpan(space + 1), strings, newline: space >= 0);
+        }
+    }
+
+    private static NChar* Native(ReadOnlySpan<byte> text, List<nint> strings, bool newline = false)
+    {
+        var p = (byte*)NativeMemory.AllocZeroed((nuint)text.Length + 2);
+        text.CopyTo(new Span<byte>(p, text.Length));
+        if (newline)
+            p[text.Length] = (byte)'\n';
+        strings.Add((nint)p);
+        return (NChar*)p;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int StubArgc() => _argc[_current];
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static NChar* StubArgv(int index) => index < _argc[_current] ? _argv[_current][index] : null;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static NChar* StubArgs() => _args[_current];
+}
@@ -0,0 +1,285 @@
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Delta;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Strings;
+using NativeInterop;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of one <see cref="DeltaEncoderBenchmark"/> run.
+/// </summary>
+public readonly record struct DeltaEncoderBenchmarkResult(
+    int Entities,
+    int Snapshots,
+    double MaskNanoseconds,
+    double ScalarMaskNanoseconds,
+    double IndexedEncodeNanoseconds,
+    double NamedEncodeNanoseconds,
+    DeltaFieldStatistics[] TopFields);
+
+/// <summary>
+/// Headless benchmark for <see cref="EntityEncoder"/> against a fake delta description.
+/// Compares the Vector256 change mask with a scalar word loop, and cached-index toggles with a name-based
+/// encoder that calls DeltaSetField / DeltaUnsetField (which the engine resolves by linear strcmp) on every call.
+/// </summary>
+public static unsafe class DeltaEncoderBenchmark
+{
+    // Same order as the entity_state_t part of a stock delta.lst.
+    private static readonly string[] s_fieldNames =
+    {
+        "animtime", "frame", "origin[0]", "angles[0]", "angles[1]", "origin[1]", "origin[2]", "sequence",
+        "modelindex", "movetype", "solid", "mins[0]", "mins[1]", "mins[2]", "maxs[0]", "maxs[1]", "maxs[2]",
+        "endpos[0]", "endpos[1]", "endpos[2]", "startpos[0]", "startpos[1]", "startpos[2]", "impacttime",
+        "starttime", "weaponmodel", "owner", "effects", "angles[2]", "colormap", "framerate", "skin",
+        "controller[0]", "controller[1]", "controller[2]", "controller[3]", "blending[0]", "blending[1]",
+        "body", "rendermode", "renderamt", "renderfx", "scale", "rendercolor.r", "rendercolor.g", "rendercolor.b",
+        "aiment", "basevelocity[0]", "basevelocity[1]", "basevelocity[2]",
+    };
+
+    private static NChar** s_names;
+    private static int s_nameCount;
+    private static ulong s_sendBits;
+    private static long s_engineCalls;
+    private static ulong s_maskSink;
+
+    /// <summary>
+    /// Name-based equivalent of <see cref="EntityEncoder"/>: what a direct port without index caching does.
+    /// </summary>
+    private sealed class NamedEntityEncoder : DeltaEncoder<entity_state_t>
+    {
+        private readonly NChar* _origin0 = Utf8StringPool.Shared.Intern("origin[0]");
+        private readonly NChar* _origin1 = Utf8StringPool.Shared.Intern("origin[1]");
+        private readonly NChar* _origin2 = Utf8StringPool.Shared.Intern("origin[2]");
+        private readonly NChar* _angles0 = Utf8StringPool.Shared.Intern("angles[0]");
+        private readonly NChar* _angles1 = Utf8StringPool.Shared.Intern("angles[1]");
+        private readonly NChar* _angles2 = Utf8StringPool.Shared.Intern("angles[2]");
+
+        public NamedEntityEncoder() : base("Entity_Encode")
+        {
+        }
+
+        protected override void Encode(ref DeltaEncodeContext<entity_state_t> context)
+        {
+            var f = context.From;
+            var t = context.To;
+            var fields = context.Fields;
+
+            if (t->number - 1 == Engine->GetCurrentPlayer())
+            {
+                Engine->DeltaUnsetField(fields, _origin0);
+                Engine->DeltaUnsetField(fields, _origin1);
+                Engine->DeltaUnsetField(fields, _origin2);
+            }
+
+            if (t->impacttime != 0 && t->starttime != 0)
+            {
+                Engine->DeltaUnsetField(fields, _origin0);
+                Engine->DeltaUnsetField(fields, _origin1);
+                Engine->DeltaUnsetField(fields, _origin2);
+                Engine->DeltaUnsetField(fields, _angles0);
+                Engine->DeltaUnsetField(fields, _angles1);
+                Engine->DeltaUnsetField(fields, _angles2);
+            }
+
+            if (t->movetype == 12 && t->aiment != 0)
+            {
+                Engine->DeltaUnsetField(fields, _origin0);
+                Engine->DeltaUnsetField(fields, _origin1);
+                Engine->DeltaUnsetField(fields, _origin2);
+            }
+            else if (t->aiment != f->aiment)
+            {
+                Engine->DeltaSetField(fields, _origin0);
+                Engine->DeltaSetField(fields, _origin1);
+                Engine->DeltaSetField(fields, _origin2);
+            }
+        }
+    }
+
+    public static void RunAndPrint(int entities = 512, int snapshots = 200)
+    {
+        var r = Run(entities, snapshots);
+        Console.WriteLine($"[DeltaEncoderBenchmark] {r.Entities} entities x {r.Snapshots} snapshots");
+        Console.WriteLine($"[DeltaEncoderBenchmark] change mask: {r.MaskNanoseconds:F1} ns (SIMD) vs {r.ScalarMaskNanoseconds:F1} ns (scalar)");
+        Console.WriteLine($"[DeltaEncoderBenchmark] encode: {r.IndexedEncodeNanoseconds:F1} ns (cached index) vs {r.NamedEncodeNanoseconds:F1} ns (by name)");
+        foreach (var f in r.TopFields)
+            Console.WriteLine($"[DeltaEncoderBenchmark]   {f.Name,-16} {f.Rate,8:P1}");
+    }
+
+    public static DeltaEncoderBenchmarkResult Run(int entities, int snapshots)
+    {
+        var engine = (ServerEngineFuncs*)NativeMemory.AllocZeroed((nuint)sizeof(ServerEngineFuncs));
+        var states = (entity_state_t*)NativeMemory.AllocZeroed((nuint)(entities * 2), (nuint)sizeof(entity_state_t));
+        var delta = (delta_s*)NativeMemory.AllocZeroed(16);
+        InitNames();
+
+        try
+        {
+            engine->DeltaFindField = &StubFindField;
+            engine->DeltaSetFieldByIndex = &StubSetByIndex;
+            engine->DeltaUnsetFieldByIndex = &StubUnsetByIndex;
+            engine->DeltaSetField = &StubSetField;
+            engine->DeltaUnsetField = &StubUnsetField;
+            engine->GetCurrentPlayer = &StubGetCurrentPlayer;
+
+            var indexed = new EntityEncoder { Engine = engine };
+            var named = new NamedEntityEncoder { Engine = engine, CollectStatistics = false };
+
+            uint seed = 12345;
+            for (int i = 0; i < entities; i++)
+            {
+                ref var s = ref states[i * 2 + 1];
+                s.number = i + 1;
+                s.modelindex = 1 + (i & 7);
+                s.movetype = (i % 10) switch { 0 => 12, 1 => 7, _ => 3 };
+                s.aiment = (i % 10) == 0 ? 1 : 0;
+                if (i % 17 == 0)
+                {
+                    s.impacttime = 1;
+                    s.starttime = 1;
+                }
+                s.origin = new Vector3(NextFloat(ref seed) * 4096, NextFloat(ref seed) * 4096, 0);
+            }
+
+            double maskNs = 0, scalarNs = 0, indexedNs = 0, namedNs = 0;
+            long calls = 0;
+
+            for (int snap = 0; snap < snapshots; snap++)
+            {
+                // Advance the world: "to" becomes "from", movers move, some animate, a few retarget.
+                for (int i = 0; i < entities; i++)
+                {
+                    ref var from = ref states[i * 2];
+                    ref var to = ref states[i * 2 + 1];
+                    from = to;
+                    if (to.movetype == 3 && (i + snap) % 3 == 0)
+                        to.origin += new Vector3(NextFloat(ref seed) * 8, NextFloat(ref seed) * 8, 0);
+                    if ((i + snap) % 5 == 0)
+                        to.angles.Y = NextFloat(ref seed) * 360;
+                    to.frame = (to.frame + 1) % 30;
+                    to.animtime = snap * 0.1f;
+                    if (to.movetype == 7 && snap % 20 == 0)
+                        to.aiment = to.aiment == 0 ? 2 : 0;
+                }
+
+                long t0 = Stopwatch.GetTimestamp();
+                ulong sink = 0;
+                for (int i = 0; i < entities; i++)
+                    sink += DeltaChangeMask.Compute((byte*)&states[i * 2], (byte*)&states[i * 2 + 1], sizeof(entity_state_t))[0];
+                long t1 = Stopwatch.GetTimestamp();
+                for (int i = 0; i < entities; i++)
+                    sink -= DeltaChangeMask.ComputeScalar((byte*)&states[i * 2], (byte*)&states[i * 2 + 1], sizeof(entity_state_t))[0];
+                long t2 = Stopwatch.GetTimestamp();
+                s_maskSink ^= sink;
+
+                // Untimed pass that feeds the per-field statistics.
+                for (int i = 0; i < entities; i++)
+                    indexed.Invoke(delta, (byte*)&states[i * 2], (byte*)&states[i * 2 + 1]);
+
+                // Timed passes without statistics, so both encoders do the same work apart from the toggles.
+                indexed.CollectStatistics = false;
+                long e0 = Stopwatch.GetTimestamp();
+                for (int i = 0; i < entities; i++)
+                    indexed.Invoke(delta, (byte*)&states[i * 2], (byte*)&states[i * 2 + 1]);
+                long e1 = Stopwatch.GetTimestamp();
+                for (int i = 0; i < entities; i++)
+                    named.Invoke(delta, (byte*)&states[i * 2], (byte*)&states[i * 2 + 1]);
+                long e2 = Stopwatch.GetTimestamp();
+                indexed.CollectStatistics = true;
+
+                indexedNs += Stopwatch.GetElapsedTime(e0, e1).TotalNanoseconds;
+                namedNs += Stopwatch.GetElapsedTime(e1, e2).TotalNanoseconds;
+
+                maskNs += Stopwatch.GetElapsedTime(t0, t1).TotalNanoseconds;
+                scalarNs += Stopwatch.GetElapsedTime(t1, t2).TotalNanoseconds;
+                calls += entities;
+            }
+
+            var top = indexed.GetStatistics().Where(f => f.Changes > 0).OrderByDescending(f => f.Changes).Take(8).ToArray();
+            return new DeltaEncoderBenchmarkResult(entities, snapshots,
+                maskNs / calls, scalarNs / calls, indexedNs / calls, namedNs / calls, top);
+        }
+        finally
+        {
+            NativeMemory.Free(delta);
+            NativeMemory.Free(states);
+            NativeMemory.Free(engine);
+        }
+    }
+
+    private static void InitNames()
+    {
+        if (s_names != null)
+            return;
+
+        s_nameCount = s_fieldNames.Length;
+        s_names = (NChar**)NativeMemory.Alloc((nuint)s_nameCount, (nuint)sizeof(NChar*));
+        for (int i = 0; i < s_nameCount; i++)
+        {
+            s_names[i] = Utf8StringPool.Shared.Intern(s_fieldNames[i]);
+        }
+    }
+
+    private static float NextFloat(ref uint state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (state & 0xFFFFFF) / (float)0x1000000;
+    }
+
+    // Mirrors the engine: a linear strcmp over the description's fields.
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static int FindByName(NChar* name)
+    {
+        var wanted = MemoryMarshal.CreateReadOnlySpanFromNullTerminated((byte*)name);
+        for (int i = 0; i < s_nameCount; i++)
+        {
+            if (MemoryMarshal.CreateReadOnlySpanFromNullTerminated((byte*)s_names[i]).SequenceEqual(wanted))
+                return i;
+        }
+        return -1;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int StubFindField(delta_s* fields, NChar* name) => FindByName(name);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubSetByIndex(delta_s* fields, int index)
+    {
+        s_engineCalls++;
+        s_sendBits |= 1UL << index;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubUnsetByIndex(delta_s* fields, int index)
+    {
+        s_engineCalls++;
+        s_sendBits &= ~(1UL << index);
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubSetField(delta_s* fields, NChar* name)
+    {
+        s_engineCalls++;
+        int index = FindByName(name);
+        if (index >= 0)
+            s_sendBits |= 1UL << index;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubUnsetField(delta_s* fields, NChar* name)
+    {
+        s_engineCalls++;
+        int index = FindByName(name);
+        if (index >= 0)
+            s_sendBits &= ~(1UL << index);
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int StubGetCurrentPlayer() => 0;
+}
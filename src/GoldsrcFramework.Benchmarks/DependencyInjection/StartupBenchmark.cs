@@ -0,0 +1,86 @@
+using System.Diagnostics;
+using GoldsrcFramework.Configuration;
+using GoldsrcFramework.DependencyInjection;
+using GoldsrcFramework.Engine.Native;
+using Microsoft.Extensions.Options;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of one <see cref="StartupBenchmark"/> mode
+/// </summary>
+public readonly record struct StartupBenchmarkResult(
+    StartupMode Requested,
+    StartupMode Active,
+    int Iterations,
+    double FirstMilliseconds,
+    double MeanMilliseconds,
+    double MinMilliseconds,
+    long AllocatedBytesPerStart,
+    string ServerType,
+    string ClientType);
+
+/// <summary>
+/// Headless benchmark for <see cref="ServiceContainer"/> startup with the source-generated registration and
+/// settings binders against assembly scanning and ConfigurationBinder.
+/// Each start is Initialize plus resolving the exports and the settings, as ServerMain / ClientMain do. Pass the
+/// mod's modSettings.json to include its game assembly. The first start of a mode also pays for JIT of the code
+/// it does not share with the mode before it; run one mode per process to see a true cold start.
+/// </summary>
+public static class StartupBenchmark
+{
+    /// <summary>
+    /// Run both modes and print the results to the console
+    /// </summary>
+    public static void RunAndPrint(string? configurationPath = null, int iterations = 50)
+    {
+        foreach (var mode in new[] { StartupMode.Generated, StartupMode.Reflection })
+        {
+            var r = Run(mode, iterations, configurationPath);
+            Console.WriteLine($"[StartupBenchmark] {r.Requested,-10} (ran {r.Active}): first {r.FirstMilliseconds:F2} ms, " +
+                              $"then mean {r.MeanMilliseconds:F3} ms / min {r.MinMilliseconds:F3} ms, {r.AllocatedBytesPerStart / 1024.0:F1} KB per start, " +
+                              $"server {r.ServerType}, client {r.ClientType}");
+        }
+    }
+
+    public static StartupBenchmarkResult Run(StartupMode mode, int iterations, string? configurationPath = null)
+    {
+        iterations = Math.Max(iterations, 2);
+        double first = 0, total = 0, min = double.MaxValue;
+        long allocated = 0;
+        string serverType = "", clientType = "";
+        var active = mode;
+
+        for (int i = 0; i < iterations; i++)
+        {
+            ServiceContainer.Reset();
+            long bytes = GC.GetAllocatedBytesForCurrentThread();
+            long start = Stopwatch.GetTimestamp();
+
+            ServiceContainer.Initialize(configurationPath, mode);
+            var server = ServiceContainer.GetService<IServerExportFuncs>();
+            var client = ServiceContainer.GetService<IClientExportFuncs>();
+            _ = ServiceContainer.GetService<IOptions<FrameworkSettings>>().Value;
+            _ = ServiceContainer.GetService<IOptions<GameSettings>>().Value;
+
+            double ms = Stopwatch.GetElapsedTime(start).TotalMilliseconds;
+            if (i == 0)
+            {
+                first = ms;
+            }
+            else
+            {
+                total += ms;
+                min = Math.Min(min, ms);
+                allocated += GC.GetAllocatedBytesForCurrentThread() - bytes;
+            }
+            active = ServiceContainer.ActiveMode;
+            serverType = server.GetType().Name;
+            clientType = client.GetType().Name;
+        }
+
+        ServiceContainer.Reset();
+        return new StartupBenchmarkResult(mode, active, iterations, first, total / (iterations - 1), min,
+                                          allocated / (iterations - 1), serverType, clientType);
+    }
+}
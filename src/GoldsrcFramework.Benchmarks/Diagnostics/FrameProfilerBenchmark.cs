@@ -0,0 +1,169 @@
+using System.Diagnostics;
+using System.Reflection.Emit;
+using GoldsrcFramework.Diagnostics;
+using GoldsrcFramework.Replay;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of one <see cref="FrameProfilerBenchmark"/> run.
+/// </summary>
+public readonly record struct FrameProfilerBenchmarkResult(
+    int Frames,
+    double NanosecondsPerCall,
+    double NanosecondsPerFrame,
+    int InjectedGc,
+    int InjectedJit,
+    int InjectedSlowThink,
+    FrameProfilerStats Stats,
+    int CsvRows,
+    string Summary);
+
+/// <summary>
+/// Headless benchmark for <see cref="FrameProfiler"/>.
+/// Measures what the export wrappers and the per-frame bookkeeping cost, then plays a frame loop with a fixed amount
+/// of work per frame and injects the three kinds of hitch it is meant to tell apart: a blocking gen2 collection
+/// over a large live heap, a burst of first-time JIT compilation and one Think that runs long. The injected counts
+/// should line up with the hitches attributed to each cause. No engine required.
+/// </summary>
+public static class FrameProfilerBenchmark
+{
+    private static long s_sink;
+
+    /// <summary>
+    /// Run the benchmark and print the result to the console.
+    /// </summary>
+    public static void RunAndPrint(int frames = 600)
+    {
+        var r = Run(frames);
+        Console.WriteLine($"[FrameProfilerBenchmark] {r.NanosecondsPerCall:F1} ns per wrapped call, {r.NanosecondsPerFrame:F1} ns per frame");
+        Console.WriteLine($"[FrameProfilerBenchmark] injected {r.InjectedGc} gc, {r.InjectedJit} jit, {r.InjectedSlowThink} slow Think; " +
+                          $"detected {r.Stats.GcHitches} gc, {r.Stats.JitHitches} jit, {r.Stats.ModHitches} mod, {r.Stats.EngineHitches} engine; " +
+                          $"{r.CsvRows} CSV rows");
+        Console.WriteLine($"[FrameProfilerBenchmark] {r.Summary}");
+    }
+
+    /// <param name="frames">Frames in the hitch simulation.</param>
+    /// <param name="budgetMilliseconds">Frame budget; each frame does about a fifth of it.</param>
+    /// <param name="hitchInterval">Frames between injected hitches, cycling GC, JIT and slow Think.</param>
+    public static FrameProfilerBenchmarkResult Run(int frames, double budgetMilliseconds = 10, int hitchInterval = 50)
+    {
+        const int Calls = 10_000_000;
+        const int Frames = 1_000_000;
+
+        // Overhead, without the watchdog thread.
+        double perCall, perFrame;
+        using (var profiler = new FrameProfiler("bench", 1000, watchdog: false))
+        {
+            var stopwatch = Stopwatch.StartNew();
+            for (int i = 0; i < Calls; i++)
+            {
+                var previous = profiler.Enter(TraceCall.Think);
+                s_sink += i;
+                profiler.Exit(previous);
+            }
+            perCall = stopwatch.Elapsed.TotalMilliseconds * 1e6 / Calls;
+
+            stopwatch.Restart();
+            for (int i = 0; i < Frames; i++)
+                profiler.BeginFrame(i * 0.01);
+            perFrame = stopwatch.Elapsed.TotalMilliseconds * 1e6 / Frames;
+        }
+
+        var csvPath = Path.Combine(Path.GetTempPath(), $"frame_hitches_{Environment.ProcessId}.csv");
+        File.Delete(csvPath);
+
+        // Live data for the gen2 collections to walk.
+        var heap = new object[1 << 20];
+        for (int i = 0; i < heap.Length; i++)
+            heap[i] = new int[4];
+
+        int gc = 0, jit = 0, slow = 0;
+        FrameProfilerStats stats;
+        string summary;
+        using (var profiler = new FrameProfiler("bench", budgetMilliseconds, csvPath))
+        {
+            double work = budgetMilliseconds / 5;
+            for (int frame = 1; frame <= frames; frame++)
+            {
+                profiler.BeginFrame(frame * budgetMilliseconds / 1000);
+
+                var previous = profiler.Enter(TraceCall.StartFrame);
+                Spin(work / 2);
+                profiler.Exit(previous);
+
+                for (int e = 0; e < 16; e++)
+                {
+                    previous = profiler.Enter(TraceCall.Think);
+                    Spin(work / 32);
+                    profiler.Exit(previous);
+                }
+
+                if (frame % hitchInterval == 0)
+                {
+                    switch (frame / hitchInterval % 3)
+                    {
+                        case 0:
+                            GC.Collect(2, GCCollectionMode.Forced, blocking: true, compacting: true);
+                            gc++;
+                            break;
+                        case 1:
+                            previous = profiler.Enter(TraceCall.Spawn);
+                            CompileFresh(frame, budgetMilliseconds * 2);
+                            profiler.Exit(previous);
+                            jit++;
+                            break;
+                        default:
+                            previous = profiler.Enter(TraceCall.Think);
+                            Spin(budgetMilliseconds * 2);
+                            profiler.Exit(previous);
+                            slow++;
+                            break;
+                    }
+                }
+            }
+            profiler.BeginFrame(frames * budgetMilliseconds / 1000);
+            stats = profiler.Stats;
+            summary = profiler.Summary();
+        }
+
+        GC.KeepAlive(heap);
+        int rows = File.Exists(csvPath) ? File.ReadLines(csvPath).Count() - 1 : 0;
+        File.Delete(csvPath);
+        return new FrameProfilerBenchmarkResult(frames, perCall, perFrame, gc, jit, slow, stats, Math.Max(rows, 0), summary);
+    }
+
+    private static void Spin(double milliseconds)
+    {
+        long end = Stopwatch.GetTimestamp() + (long)(milliseconds * Stopwatch.Frequency / 1000);
+        while (Stopwatch.GetTimestamp() < end)
+            s_sink++;
+    }
+
+    // Stand-in for a mod hitting code paths for the first time: large dynamic methods, each JIT-compiled on first call,
+    // until at least the given time has gone into compiling.
+    private static void CompileFresh(int seed, double milliseconds)
+    {
+        var start = System.Runtime.JitInfo.GetCompilationTime(currentThread: true);
+        for (int m = 0; m < 256 && (System.Runtime.JitInfo.GetCompilationTime(currentThread: true) - start).TotalMilliseconds < milliseconds; m++)
+        {
+            var method = new DynamicMethod($"Fresh{seed}_{m}", typeof(long), new[] { typeof(long) });
+            var il = method.GetILGenerator();
+            var local = il.DeclareLocal(typeof(long));
+            il.Emit(OpCodes.Ldarg_0);
+            il.Emit(OpCodes.Stloc, local);
+            for (int i = 0; i < 2000; i++)
+            {
+                il.Emit(OpCodes.Ldloc, local);
+                il.Emit(OpCodes.Ldc_I8, (long)(i * 2654435761L ^ seed));
+                il.Emit((i & 1) == 0 ? OpCodes.Xor : OpCodes.Add);
+                il.Emit(OpCodes.Ldc_I4, i % 7 + 1);
+                il.Emit(OpCodes.Shl);
+                il.Emit(OpCodes.Stloc, local);
+            }
+            il.Emit(OpCodes.Ldloc, local);
+            il.Emit(OpCodes.Ret);
+            s_sink += ((Func<long, long>)method.CreateDelegate(typeof(Func<long, long>)))(m);
+        }
+    }
+}
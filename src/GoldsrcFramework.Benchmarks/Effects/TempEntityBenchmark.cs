@@ -0,0 +1,186 @@
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Effects;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of a <see cref="TempEntityBenchmark"/> run.
+/// </summary>
+public readonly record struct TempEntityBenchmarkResult(
+    int EntityCount,
+    int Frames,
+    bool Vectorized,
+    double TotalMilliseconds,
+    double NanosecondsPerEntity,
+    long AllocatedBytes,
+    TempEntityFrameStats LastFrame);
+
+/// <summary>
+/// Headless benchmark for <see cref="TempEntitySimulator"/>.
+/// Builds a fake client engine (event API with a z = 0 floor trace, counting AddVisibleEntity)
+/// and a native temp entity pool, then times a number of simulated frames. No engine required.
+/// </summary>
+public static unsafe class TempEntityBenchmark
+{
+    private static int s_submitted;
+
+    /// <summary>
+    /// Run both the scalar and the vectorized path and print the results to the console.
+    /// </summary>
+    public static void RunAndPrint(int entityCount = 16384, int frames = 1000)
+    {
+        foreach (var vectorized in new[] { false, true })
+        {
+            var r = Run(entityCount, frames, vectorized);
+            Console.WriteLine($"[TempEntityBenchmark] {(r.Vectorized ? "simd  " : "scalar")} {r.EntityCount} tents x {r.Frames} frames: " +
+                              $"{r.TotalMilliseconds:F2} ms, {r.NanosecondsPerEntity:F2} ns/tent, {r.AllocatedBytes} bytes allocated, " +
+                              $"active={r.LastFrame.Active} integrated={r.LastFrame.Integrated} collided={r.LastFrame.Collided} submitted={r.LastFrame.Submitted}");
+        }
+    }
+
+    /// <summary>
+    /// Simulate <paramref name="entityCount"/> temp entities for <paramref name="frames"/> frames at 100 fps.
+    /// </summary>
+    public static TempEntityBenchmarkResult Run(int entityCount = 16384, int frames = 1000, bool vectorized = true)
+    {
+        var engine = (ClientEngineFuncs*)NativeMemory.AllocZeroed((nuint)sizeof(ClientEngineFuncs));
+        var eventApi = (event_api_t*)NativeMemory.AllocZeroed((nuint)sizeof(event_api_t));
+        var pool = (TEMPENTITY*)NativeMemory.AllocZeroed((nuint)entityCount, (nuint)sizeof(TEMPENTITY));
+
+        try
+        {
+            eventApi->EV_SetUpPlayerPrediction = &StubSetUpPlayerPrediction;
+            eventApi->EV_PushPMStates = &StubPMStates;
+            eventApi->EV_PopPMStates = &StubPMStates;
+            eventApi->EV_SetSolidPlayers = &StubInt;
+            eventApi->EV_SetTraceHull = &StubInt;
+            eventApi->EV_PlayerTrace = &StubFloorTrace;
+            engine->pEventAPI = eventApi;
+
+            var simulator = new TempEntitySimulator(engine) { Vectorized = vectorized };
+
+            const double frametime = 0.01;
+            const double gravity = 800;
+            double time = 0;
+
+            TEMPENTITY* free = null;
+            TEMPENTITY* active = Spawn(pool, entityCount, time);
+
+            // Warm up so the simulator's buffers are sized before measuring.
+            simulator.Update(frametime, time += frametime, gravity, &free, &active, &StubAddVisibleEntity, &StubPlaySound);
+
+            s_submitted = 0;
+            long allocated = GC.GetAllocatedBytesForCurrentThread();
+            long start = Stopwatch.GetTimestamp();
+
+            for (int i = 0; i < frames; i++)
+            {
+                // Respawn the whole pool periodically so bouncing entities never all come to rest.
+                if (i % 200 == 199)
+                {
+                    free = null;
+                    active = Spawn(pool, entityCount, time);
+                }
+
+                simulator.Update(frametime, time += frametime, gravity, &free, &active, &StubAddVisibleEntity, &StubPlaySound);
+            }
+
+            var elapsed = Stopwatch.GetElapsedTime(start);
+            allocated = GC.GetAllocatedBytesForCurrentThread() - allocated;
+
+            return new TempEntityBenchmarkResult(entityCount, frames, vectorized, elapsed.TotalMilliseconds,
+                elapsed.TotalMilliseconds * 1_000_000.0 / ((double)entityCount * frames), allocated, simulator.LastFrame);
+        }
+        finally
+        {
+            NativeMemory.Free(pool);
+            NativeMemory.Free(eventApi);
+            NativeMemory.Free(engine);
+        }
+    }
+
+    /// <summary>
+    /// Link the pool into an active list with a mix of the common gib/shell/sprite behaviours.
+    /// </summary>
+    private static TEMPENTITY* Spawn(TEMPENTITY* pool, int count, double time)
+    {
+        uint rng = 1234;
+        for (int i = 0; i < count; i++)
+        {
+            var p = &pool[i];
+            *p = default;
+            p->next = i + 1 < count ? &pool[i + 1] : null;
+            p->die = (float)time + 1000;
+            p->bounceFactor = 1;
+            p->frameMax = 8;
+            p->entity.origin = new Vector3(NextSingle(ref rng) * 1024 - 512, NextSingle(ref rng) * 1024 - 512, NextSingle(ref rng) * 256 + 1);
+            p->entity.baseline.origin = new Vector3(NextSingle(ref rng) * 200 - 100, NextSingle(ref rng) * 200 - 100, NextSingle(ref rng) * 300);
+            p->entity.baseline.angles = new Vector3(NextSingle(ref rng) * 360, NextSingle(ref rng) * 360, 0);
+            p->entity.curstate.framerate = 10;
+
+            p->flags = (i % 4) switch
+            {
+                0 => (int)(TempEntityFlags.FTENT_GRAVITY | TempEntityFlags.FTENT_ROTATE | TempEntityFlags.FTENT_COLLIDEWORLD),
+                1 => (int)(TempEntityFlags.FTENT_SLOWGRAVITY | TempEntityFlags.FTENT_COLLIDEWORLD),
+                2 => (int)(TempEntityFlags.FTENT_SPRANIMATE | TempEntityFlags.FTENT_SPRANIMATELOOP),
+                _ => (int)TempEntityFlags.FTENT_NONE,
+            };
+        }
+
+        return count > 0 ? pool : null;
+    }
+
+    // xorshift32; keeps respawning inside the timed loop allocation free.
+    private static float NextSingle(ref uint state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (state >> 8) * (1.0f / (1 << 24));
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubSetUpPlayerPrediction(int dopred, int bIncludeLocalClient) { }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubPMStates() { }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubInt(int value) { }
+
+    /// <summary>
+    /// Trace against an infinite floor plane at z = 0.
+    /// </summary>
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubFloorTrace(float* start, float* end, int traceFlags, int ignore_pe, pmtrace_t* tr)
+    {
+        *tr = default;
+        tr->fraction = 1;
+
+        if (end[2] < 0 && start[2] >= 0)
+        {
+            float frac = start[2] / (start[2] - end[2]);
+            tr->fraction = frac;
+            tr->endpos = new Vector3(start[0] + (end[0] - start[0]) * frac, start[1] + (end[1] - start[1]) * frac, 0);
+            tr->plane.normal = new Vector3(0, 0, 1);
+        }
+        else
+        {
+            tr->endpos = new Vector3(end[0], end[1], end[2]);
+        }
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int StubAddVisibleEntity(cl_entity_t* ent)
+    {
+        s_submitted++;
+        return 1;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubPlaySound(TEMPENTITY* pTemp, float damp) { }
+}
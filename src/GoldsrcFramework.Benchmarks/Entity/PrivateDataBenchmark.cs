@@ -0,0 +1,126 @@
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Entity;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of one <see cref="PrivateDataBenchmark"/> run.
+/// </summary>
+public readonly record struct PrivateDataBenchmarkResult(
+    string Mode,
+    int Edicts,
+    long Spawns,
+    double NanosecondsPerSpawn,
+    long AllocatedBytes,
+    PrivateDataStats Stats);
+
+/// <summary>
+/// Headless benchmark for <see cref="PrivateDataAllocator"/>: projectile churn over a fake edict array. Each frame the
+/// oldest projectiles are freed and as many spawned, cycling through three classes of different sizes, each with a
+/// managed owner object. Compared with a native allocation plus a GCHandle per entity. No engine required.
+/// </summary>
+public static unsafe class PrivateDataBenchmark
+{
+    private static readonly int[] s_sizes = { 96, 224, 480 };
+
+    private sealed class Projectile
+    {
+        public int Index;
+    }
+
+    /// <summary>
+    /// Run both modes and print the results to the console.
+    /// </summary>
+    public static void RunAndPrint(int edicts = 2048, int frames = 2000, int spawnsPerFrame = 64)
+    {
+        foreach (var slab in new[] { false, true })
+        {
+            var r = Run(edicts, frames, spawnsPerFrame, slab);
+            Console.WriteLine($"[PrivateDataBenchmark] {r.Mode,-16} {r.Edicts} edicts, {r.Spawns} spawns: {r.NanosecondsPerSpawn:F1} ns/spawn+free, " +
+                              $"{r.AllocatedBytes} bytes allocated" +
+                              (slab ? $", {r.Stats.Slabs} slabs, occupancy {r.Stats.Occupancy:P1}, fragmentation {r.Stats.Fragmentation:P1}" : ""));
+        }
+    }
+
+    public static PrivateDataBenchmarkResult Run(int edicts, int frames, int spawnsPerFrame, bool slab)
+    {
+        var edictArray = (edict_t*)NativeMemory.AllocZeroed((nuint)edicts, (nuint)sizeof(edict_t));
+        var handles = new GCHandle[edicts];
+        var owners = new Projectile[edicts];
+        for (int i = 0; i < edicts; i++)
+            owners[i] = new Projectile { Index = i };
+
+        using var allocator = new PrivateDataAllocator();
+        var classes = new int[s_sizes.Length];
+        for (int i = 0; i < s_sizes.Length; i++)
+            classes[i] = allocator.RegisterClass($"projectile_{i}", s_sizes[i]);
+
+        try
+        {
+            long spawns = 0;
+            int next = 0;
+
+            // Fill every edict once, then churn: free the oldest, spawn into it.
+            for (int i = 0; i < edicts; i++)
+                Spawn(i);
+
+            long allocated = GC.GetAllocatedBytesForCurrentThread();
+            long start = Stopwatch.GetTimestamp();
+            for (int frame = 0; frame < frames; frame++)
+            {
+                for (int n = 0; n < spawnsPerFrame; n++)
+                {
+                    Free(next);
+                    Spawn(next);
+                    next = (next + 1) % edicts;
+                    spawns++;
+                }
+            }
+            var elapsed = Stopwatch.GetElapsedTime(start);
+            allocated = GC.GetAllocatedBytesForCurrentThread() - allocated;
+
+            var stats = allocator.Stats;
+            for (int i = 0; i < edicts; i++)
+                Free(i);
+
+            return new PrivateDataBenchmarkResult(slab ? "slab" : "native+GCHandle", edicts, spawns,
+                elapsed.TotalMilliseconds * 1e6 / Math.Max(spawns, 1), allocated, stats);
+
+            void Spawn(int index)
+            {
+                var edict = &edictArray[index];
+                int size = s_sizes[index % s_sizes.Length];
+                if (slab)
+                {
+                    allocator.Allocate(edict, classes[index % s_sizes.Length], owners[index]);
+                }
+                else
+                {
+                    edict->pvPrivateData = NativeMemory.AllocZeroed((nuint)size);
+                    handles[index] = GCHandle.Alloc(owners[index]);
+                }
+            }
+
+            void Free(int index)
+            {
+                var edict = &edictArray[index];
+                if (slab)
+                {
+                    allocator.Free(edict);
+                }
+                else if (edict->pvPrivateData != null)
+                {
+                    handles[index].Free();
+                    NativeMemory.Free(edict->pvPrivateData);
+                    edict->pvPrivateData = null;
+                }
+            }
+        }
+        finally
+        {
+            NativeMemory.Free(edictArray);
+        }
+    }
+}
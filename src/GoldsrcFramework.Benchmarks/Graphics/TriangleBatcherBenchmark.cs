@@ -0,0 +1,263 @@
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Graphics;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of one <see cref="TriangleBatcherBenchmark"/> run.
+/// </summary>
+public readonly record struct TriangleBatcherBenchmarkResult(
+    int Primitives,
+    int Frames,
+    bool NativeReplay,
+    double DirectMicrosecondsPerFrame,
+    double BatchedMicrosecondsPerFrame,
+    double RecordMicrosecondsPerFrame,
+    long DirectCallsPerFrame,
+    long BatchedCallsPerFrame,
+    long DirectStateChangesPerFrame,
+    long BatchedStateChangesPerFrame,
+    long DirectBeginsPerFrame,
+    long BatchedBeginsPerFrame,
+    long BatchedAllocatedBytes);
+
+/// <summary>
+/// Headless benchmark: a particle / beam / alpha-sprite frame drawn call by call versus recorded into a
+/// <see cref="TriangleBatcher"/>, against a stub triangleapi_t that counts calls, state changes and Begin/End pairs.
+/// Like <see cref="Messages.MessageWriterBenchmark"/>, the stubs are managed, so calls made by the native replay
+/// transition back into managed code; against the engine they stay native.
+/// </summary>
+public static unsafe class TriangleBatcherBenchmark
+{
+    private const int kRenderNormal = 0;
+    private const int kRenderTransTexture = 2;
+    private const int kRenderTransAdd = 5;
+
+    private const int Sprites = 4;
+
+    private static long _calls, _stateChanges, _begins;
+
+    public static void RunAndPrint(int primitives = 2048, int frames = 500)
+    {
+        var r = Run(primitives, frames);
+        Console.WriteLine($"[TriangleBatcherBenchmark] {r.Primitives} primitives x {r.Frames} frames, native replay {(r.NativeReplay ? "on" : "off")}");
+        Console.WriteLine($"[TriangleBatcherBenchmark] direct:  {r.DirectMicrosecondsPerFrame:F1} us/frame, {r.DirectCallsPerFrame} calls, " +
+                          $"{r.DirectStateChangesPerFrame} state changes, {r.DirectBeginsPerFrame} Begin/End");
+        Console.WriteLine($"[TriangleBatcherBenchmark] batched: {r.BatchedMicrosecondsPerFrame:F1} us/frame, {r.BatchedCallsPerFrame} calls, " +
+                          $"{r.BatchedStateChangesPerFrame} state changes, {r.BatchedBeginsPerFrame} Begin/End, {r.BatchedAllocatedBytes} bytes allocated");
+        Console.WriteLine($"[TriangleBatcherBenchmark] record + sort + encode only: {r.RecordMicrosecondsPerFrame:F1} us/frame");
+    }
+
+    /// <param name="nativeReplay">Replay entry to use (e.g. the loader's ReplayTriangleStream); 0 uses <see cref="TriangleReplay.NativeReplay"/>.</param>
+    public static TriangleBatcherBenchmarkResult Run(int primitives, int frames, nint nativeReplay = 0)
+    {
+        var triApi = (triangleapi_t*)NativeMemory.AllocZeroed((nuint)sizeof(triangleapi_t));
+        var previous = TriangleReplay.NativeReplay;
+        var batcher = new TriangleBatcher();
+
+        try
+        {
+            triApi->RenderMode = &StubRenderMode;
+            triApi->Begin = &StubBegin;
+            triApi->End = &StubEnd;
+            triApi->Color4f = &StubColor4f;
+            triApi->TexCoord2f = &StubTexCoord2f;
+            triApi->Vertex3f = &StubVertex3f;
+            triApi->CullFace = &StubCullFace;
+            triApi->SpriteTexture = &StubSpriteTexture;
+
+            if (nativeReplay != 0)
+                TriangleReplay.NativeReplay = (delegate* unmanaged[Cdecl]<triangleapi_t*, byte*, int, int>)nativeReplay;
+            bool native = TriangleReplay.NativeReplay != null;
+
+            // Warm up both paths.
+            DrawFrame(new DirectSink(triApi), primitives, 0);
+            DrawFrame(new BatchedSink(batcher), primitives, 0);
+            batcher.Flush(triApi);
+
+            Reset();
+            long start = Stopwatch.GetTimestamp();
+            for (int f = 0; f < frames; f++)
+                DrawFrame(new DirectSink(triApi), primitives, f);
+            var directTime = Stopwatch.GetElapsedTime(start);
+            var direct = (_calls, _stateChanges, _begins);
+
+            Reset();
+            long allocated = GC.GetAllocatedBytesForCurrentThread();
+            start = Stopwatch.GetTimestamp();
+            for (int f = 0; f < frames; f++)
+            {
+                DrawFrame(new BatchedSink(batcher), primitives, f);
+                batcher.Flush(triApi);
+            }
+            var batchedTime = Stopwatch.GetElapsedTime(start);
+            allocated = GC.GetAllocatedBytesForCurrentThread() - allocated;
+            var batched = (_calls, _stateChanges, _begins);
+
+            start = Stopwatch.GetTimestamp();
+            for (int f = 0; f < frames; f++)
+            {
+                DrawFrame(new BatchedSink(batcher), primitives, f);
+                batcher.EncodePending();
+                batcher.Clear();
+            }
+            var recordTime = Stopwatch.GetElapsedTime(start);
+
+            return new TriangleBatcherBenchmarkResult(primitives, frames, native,
+                directTime.TotalMicroseconds / frames,
+                batchedTime.TotalMicroseconds / frames,
+                recordTime.TotalMicroseconds / frames,
+                direct._calls / frames,
+                batched._calls / frames,
+                direct._stateChanges / frames,
+                batched._stateChanges / frames,
+                direct._begins / frames,
+                batched._begins / frames,
+                allocated);
+        }
+        finally
+        {
+            TriangleReplay.NativeReplay = previous;
+            NativeMemory.Free(triApi);
+        }
+    }
+
+    private interface ISink
+    {
+        void RenderMode(int mode);
+        void SpriteTexture(model_t* sprite, int frame);
+        void Begin(TriPrimitive primitive);
+        void Color4f(float r, float g, float b, float a);
+        void TexCoord2f(float u, float v);
+        void Vertex3f(float x, float y, float z);
+        void End();
+    }
+
+    private readonly struct DirectSink(triangleapi_t* tri) : ISink
+    {
+        public void RenderMode(int mode) => tri->RenderMode(mode);
+        public void SpriteTexture(model_t* sprite, int frame) => tri->SpriteTexture(sprite, frame);
+        public void Begin(TriPrimitive primitive) => tri->Begin((int)primitive);
+        public void Color4f(float r, float g, float b, float a) => tri->Color4f(r, g, b, a);
+        public void TexCoord2f(float u, float v) => tri->TexCoord2f(u, v);
+        public void Vertex3f(float x, float y, float z) => tri->Vertex3f(x, y, z);
+        public void End() => tri->End();
+    }
+
+    private readonly struct BatchedSink(TriangleBatcher batcher) : ISink
+    {
+        public void RenderMode(int mode) => batcher.RenderMode(mode);
+        public void SpriteTexture(model_t* sprite, int frame) => batcher.SpriteTexture(sprite, frame);
+        public void Begin(TriPrimitive primitive) => batcher.Begin(primitive);
+        public void Color4f(float r, float g, float b, float a) => batcher.Color4f(r, g, b, a);
+        public void TexCoord2f(float u, float v) => batcher.TexCoord2f(u, v);
+        public void Vertex3f(float x, float y, float z) => batcher.Vertex3f(x, y, z);
+        public void End() => batcher.End();
+    }
+
+    // What a typical effects pass looks like: additive particles cycling through a few sprites, beam segments,
+    // then alpha-blended sprites that must be drawn back to front. Each primitive sets its own state, as HUD code does.
+    private static void DrawFrame<TSink>(TSink sink, int primitives, int frame) where TSink : ISink
+    {
+        int alpha = primitives / 16;
+        int beams = primitives / 8;
+        int particles = primitives - alpha - beams;
+
+        for (int i = 0; i < particles; i++)
+        {
+            sink.RenderMode(kRenderTransAdd);
+            sink.SpriteTexture(Sprite(i % Sprites), i & 1);
+            float x = i * 0.25f, y = frame, z = i & 15;
+            float c = (i & 7) / 8f;
+            sink.Begin(TriPrimitive.Quads);
+            sink.Color4f(1, c, c, 0.5f);
+            sink.TexCoord2f(0, 0); sink.Vertex3f(x, y, z);
+            sink.TexCoord2f(0, 1); sink.Vertex3f(x, y + 4, z);
+            sink.TexCoord2f(1, 1); sink.Vertex3f(x + 4, y + 4, z);
+            sink.TexCoord2f(1, 0); sink.Vertex3f(x + 4, y, z);
+            sink.End();
+        }
+
+        for (int i = 0; i < beams; i++)
+        {
+            sink.RenderMode(kRenderTransAdd);
+            sink.SpriteTexture(Sprite(Sprites), 0);
+            float x = i, y = -frame;
+            sink.Begin(TriPrimitive.TriangleStrip);
+            sink.Color4f(0.2f, 0.6f, 1, 1);
+            for (int s = 0; s < 4; s++)
+            {
+                sink.TexCoord2f(0, s); sink.Vertex3f(x, y + s * 8, 0);
+                sink.TexCoord2f(1, s); sink.Vertex3f(x + 2, y + s * 8, 0);
+            }
+            sink.End();
+        }
+
+        for (int i = 0; i < alpha; i++)
+        {
+            sink.RenderMode(kRenderTransTexture);
+            sink.SpriteTexture(Sprite(i % Sprites), 0);
+            float z = alpha - i;
+            sink.Begin(TriPrimitive.Quads);
+            sink.Color4f(1, 1, 1, (i & 3) / 4f);
+            sink.TexCoord2f(0, 0); sink.Vertex3f(0, 0, z);
+            sink.TexCoord2f(0, 1); sink.Vertex3f(0, 8, z);
+            sink.TexCoord2f(1, 1); sink.Vertex3f(8, 8, z);
+            sink.TexCoord2f(1, 0); sink.Vertex3f(8, 0, z);
+            sink.End();
+        }
+
+        sink.RenderMode(kRenderNormal);
+    }
+
+    private static model_t* Sprite(int index) => (model_t*)(nint)(0x10000 + index * 0x100);
+
+    private static void Reset()
+    {
+        _calls = _stateChanges = _begins = 0;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubRenderMode(int mode)
+    {
+        _calls++;
+        _stateChanges++;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubCullFace(TRICULLSTYLE style)
+    {
+        _calls++;
+        _stateChanges++;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int StubSpriteTexture(model_t* sprite, int frame)
+    {
+        _calls++;
+        _stateChanges++;
+        return 1;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubBegin(int primitive)
+    {
+        _calls++;
+        _begins++;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubEnd() => _calls++;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubColor4f(float r, float g, float b, float a) => _calls++;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubTexCoord2f(float u, float v) => _calls++;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubVertex3f(float x, float y, float z) => _calls++;
+}
@@ -0,0 +1,202 @@
+using System.Diagnostics;
+using GoldsrcFramework.Jobs;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of one <see cref="JobSchedulerBenchmark"/> case at one worker count.
+/// </summary>
+public readonly record struct JobSchedulerBenchmarkResult(
+    string Case,
+    int Workers,
+    int Frames,
+    double MicrosecondsPerFrame,
+    double ThreadPoolMicrosecondsPerFrame,
+    double Speedup,
+    long AllocatedBytesPerFrame,
+    long ThreadPoolAllocatedBytesPerFrame,
+    long Checksum);
+
+/// <summary>
+/// Headless scaling benchmark for <see cref="JobScheduler"/> against Parallel.For on the thread pool with the same
+/// number of threads (workers plus the main thread). Each frame ends with <see cref="JobScheduler.CompleteFrame"/>,
+/// as StartFrame does.
+/// <list type="bullet">
+/// <item><term>parallel-for</term><description>one large ParallelFor over an array: throughput.</description></item>
+/// <item><term>fan-out</term><description>many small jobs, a combined handle and a reduction depending on it:
+/// per-job overhead and wake-up latency, which dominate the short bursts a game frame hands out.</description></item>
+/// </list>
+/// Speedup is against the scheduler with one worker. Allocation is measured on all threads; after warm-up the scheduler should report 0.
+/// </summary>
+public static class JobSchedulerBenchmark
+{
+    private const int FanOutJobs = 256;
+
+    private struct WaveJob : IJobRange
+    {
+        public float[] Input;
+        public float[] Output;
+        public float Time;
+
+        public void Execute(int start, int end)
+        {
+            var input = Input.AsSpan(start, end - start);
+            var output = Output.AsSpan(start, end - start);
+            for (int i = 0; i < input.Length; i++)
+            {
+                float x = input[i];
+                output[i] = MathF.Sin(x + Time) * MathF.Sqrt(x + 1) + MathF.Cos(x * 0.5f);
+            }
+        }
+    }
+
+    private struct PartialSumJob : IJob
+    {
+        public float[] Values;
+        public double[] Sums;
+        public int Index;
+
+        public void Execute()
+        {
+            int count = Values.Length / FanOutJobs;
+            double sum = 0;
+            foreach (float v in Values.AsSpan(Index * count, count))
+                sum += MathF.Sqrt(v * v + 1);
+            Sums[Index] = sum;
+        }
+    }
+
+    private struct ReduceJob : IJob
+    {
+        public double[] Sums;
+        public double[] Result;
+
+        public void Execute()
+        {
+            double total = 0;
+            foreach (double s in Sums)
+                total += s;
+            Result[0] = total;
+        }
+    }
+
+    /// <summary>
+    /// Run both cases at 1..ProcessorCount - 1 workers and print the results to the console.
+    /// </summary>
+    public static void RunAndPrint(int frames = 200, int maxWorkers = 0)
+    {
+        foreach (var r in RunScaling(frames, maxWorkers))
+        {
+            Console.WriteLine($"[JobSchedulerBenchmark] {r.Case,-12} {r.Workers} workers: {r.MicrosecondsPerFrame:F1} us/frame " +
+                              $"(thread pool {r.ThreadPoolMicrosecondsPerFrame:F1}), x{r.Speedup:F2}, " +
+                              $"{r.AllocatedBytesPerFrame} B/frame (thread pool {r.ThreadPoolAllocatedBytesPerFrame}), checksum {r.Checksum:X}");
+        }
+    }
+
+    /// <param name="maxWorkers">Most workers to try; 0 uses Environment.ProcessorCount - 1.</param>
+    public static List<JobSchedulerBenchmarkResult> RunScaling(int frames = 200, int maxWorkers = 0)
+    {
+        if (maxWorkers <= 0)
+            maxWorkers = Math.Max(Environment.ProcessorCount - 1, 1);
+
+        var results = new List<JobSchedulerBenchmarkResult>();
+        foreach (bool fanOut in new[] { false, true })
+        {
+            double baseline = 0;
+            for (int workers = 1; workers <= maxWorkers; workers++)
+            {
+                var r = Run(fanOut, frames, workers);
+                if (workers == 1)
+                    baseline = r.MicrosecondsPerFrame;
+                results.Add(r with { Speedup = baseline / r.MicrosecondsPerFrame });
+            }
+        }
+        return results;
+    }
+
+    public static JobSchedulerBenchmarkResult Run(bool fanOut, int frames, int workers)
+    {
+        int length = fanOut ? FanOutJobs * 256 : 1 << 20;
+        var input = new float[length];
+        var output = new float[length];
+        var rng = new Random(1234);
+        for (int i = 0; i < length; i++)
+            input[i] = rng.NextSingle() * 100;
+        var sums = new double[FanOutJobs];
+        var result = new double[1];
+        var handles = new JobHandle[FanOutJobs];
+
+        long checksum;
+        double schedulerUs, poolUs;
+        long schedulerBytes, poolBytes;
+
+        using (var scheduler = new JobScheduler(workers))
+        {
+            void Frame(int f)
+            {
+                if (fanOut)
+                {
+                    for (int i = 0; i < FanOutJobs; i++)
+                        handles[i] = scheduler.Schedule(new PartialSumJob { Values = input, Sums = sums, Index = i });
+                    scheduler.Schedule(new ReduceJob { Sums = sums, Result = result }, scheduler.CombineDependencies(handles));
+                }
+                else
+                {
+                    scheduler.ParallelFor(new WaveJob { Input = input, Output = output, Time = f * 0.01f }, length);
+                }
+                scheduler.CompleteFrame();
+            }
+
+            (schedulerUs, schedulerBytes) = Measure(frames, Frame);
+            checksum = Checksum(fanOut, output, result);
+        }
+
+        var options = new ParallelOptions { MaxDegreeOfParallelism = workers + 1 };
+        int batch = Math.Max(length / ((workers + 1) * 4), 1);
+        void PoolFrame(int f)
+        {
+            if (fanOut)
+            {
+                Parallel.For(0, FanOutJobs, options, i => new PartialSumJob { Values = input, Sums = sums, Index = i }.Execute());
+                new ReduceJob { Sums = sums, Result = result }.Execute();
+            }
+            else
+            {
+                var job = new WaveJob { Input = input, Output = output, Time = f * 0.01f };
+                Parallel.For(0, (length + batch - 1) / batch, options, b => job.Execute(b * batch, Math.Min(b * batch + batch, length)));
+            }
+        }
+
+        (poolUs, poolBytes) = Measure(frames, PoolFrame);
+
+        return new JobSchedulerBenchmarkResult(fanOut ? "fan-out" : "parallel-for", workers, frames, schedulerUs, poolUs, 1,
+                                               schedulerBytes, poolBytes, checksum);
+    }
+
+    private static (double MicrosecondsPerFrame, long BytesPerFrame) Measure(int frames, Action<int> frame)
+    {
+        // Warm-up: JIT, job type registration, thread start.
+        for (int f = 0; f < 10; f++)
+            frame(f);
+
+        long bytes = GC.GetTotalAllocatedBytes(true);
+        long start = Stopwatch.GetTimestamp();
+        for (int f = 0; f < frames; f++)
+            frame(f);
+        var elapsed = Stopwatch.GetElapsedTime(start);
+        bytes = GC.GetTotalAllocatedBytes(true) - bytes;
+
+        return (elapsed.TotalMilliseconds * 1000 / frames, bytes / frames);
+    }
+
+    private static long Checksum(bool fanOut, float[] output, double[] result)
+    {
+        if (fanOut)
+            return BitConverter.DoubleToInt64Bits(result[0]);
+
+        long checksum = 17;
+        for (int i = 0; i < output.Length; i += 97)
+            checksum = checksum * 31 + BitConverter.SingleToInt32Bits(output[i]);
+        return checksum;
+    }
+}
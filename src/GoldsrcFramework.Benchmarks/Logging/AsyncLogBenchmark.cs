@@ -0,0 +1,152 @@
+using System.Diagnostics;
+using GoldsrcFramework.Logging;
+using Microsoft.Extensions.Logging;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of an <see cref="AsyncLogBenchmark"/> run. Times are on the calling thread, per call.
+/// </summary>
+public readonly record struct AsyncLogBenchmarkResult(
+    int Calls,
+    double FilteredNanoseconds,
+    double TemplateNanoseconds,
+    double TemplateBytesPerCall,
+    double LoggerNanoseconds,
+    double LoggerBytesPerCall,
+    double SyncNanoseconds,
+    double SyncBytesPerCall,
+    double BurstAsyncP999Microseconds,
+    double BurstAsyncMaxMicroseconds,
+    double BurstSyncP999Microseconds,
+    double BurstSyncMaxMicroseconds,
+    long BurstDropped,
+    int Rotations);
+
+/// <summary>
+/// Headless benchmark for <see cref="AsyncLog"/>: cost per call on the game thread of a filtered call, a template
+/// call, an ILogger call through <see cref="AsyncLoggerProvider"/>, and a line formatted and written synchronously
+/// to an auto-flushed writer as the console provider does; then a burst into a small ring, where the async path
+/// drops instead of blocking. Lines go to a rotating file in a temp directory.
+///
+/// Reconfigures the process-wide <see cref="AsyncLog"/> and stops it when done.
+/// </summary>
+public static class AsyncLogBenchmark
+{
+    private static readonly LogTemplate s_filtered = AsyncLog.Define(LogLevel.Trace, "Bench", "filtered {A}");
+    private static readonly LogTemplate s_spawn = AsyncLog.Define(LogLevel.Information, "Bench", "{Class} #{Index} at {X:F1}");
+    private static (double P999, double Max) s_burst;
+
+    public static void RunAndPrint(int calls = 200_000)
+    {
+        var r = Run(calls);
+        Console.WriteLine($"[AsyncLogBenchmark] {r.Calls} calls: filtered {r.FilteredNanoseconds:F1} ns, " +
+                          $"template {r.TemplateNanoseconds:F1} ns ({r.TemplateBytesPerCall:F1} B), " +
+                          $"ILogger {r.LoggerNanoseconds:F1} ns ({r.LoggerBytesPerCall:F0} B), " +
+                          $"sync write {r.SyncNanoseconds:F1} ns ({r.SyncBytesPerCall:F0} B)");
+        Console.WriteLine($"[AsyncLogBenchmark] burst p99.9 / max per call: async {r.BurstAsyncP999Microseconds:F2} / {r.BurstAsyncMaxMicroseconds:F1} us " +
+                          $"({r.BurstDropped} dropped), sync {r.BurstSyncP999Microseconds:F2} / {r.BurstSyncMaxMicroseconds:F1} us; " +
+                          $"{r.Rotations} file rotations");
+    }
+
+    public static AsyncLogBenchmarkResult Run(int calls = 200_000)
+    {
+        var directory = Path.Combine(Path.GetTempPath(), "gsf-asynclog-" + Environment.ProcessId);
+        Directory.CreateDirectory(directory);
+        var file = new RotatingFileLogSink(Path.Combine(directory, "bench.log"), maxBytes: 4 << 20, maxFiles: 3);
+        AsyncLog.Start(LogLevel.Information, new ILogSink[] { file });
+
+        try
+        {
+            using var factory = LoggerFactory.Create(builder => builder.SetMinimumLevel(LogLevel.Information).AddProvider(new AsyncLoggerProvider()));
+            var logger = factory.CreateLogger("Bench");
+            const string name = "monster_scientist";
+
+            // Warm up every path, then let the log thread catch up so each measurement starts with empty rings.
+            for (int i = 0; i < 1000; i++)
+            {
+                AsyncLog.Write(s_filtered, i);
+                AsyncLog.Write(s_spawn, name, i, i * 0.5f);
+                logger.LogInformation("{Class} #{Index}", name, i);
+            }
+            AsyncLog.Flush();
+
+            double filtered = Measure(calls, i => AsyncLog.Write(s_filtered, i), out _);
+            double template = Measure(calls, i => AsyncLog.Write(s_spawn, name, i, i * 0.5f), out double templateBytes);
+            double loggerNs = Measure(calls, i => logger.LogInformation("{Class} #{Index}", name, i), out double loggerBytes);
+
+            double sync, syncBytes;
+            using (var writer = TextWriter.Synchronized(new StreamWriter(Path.Combine(directory, "sync.log")) { AutoFlush = true }))
+            {
+                sync = Measure(calls, i => writer.WriteLine($"{DateTime.Now:HH:mm:ss.fff} info Bench: {name} #{i} at {i * 0.5f:F1}"), out syncBytes);
+            }
+
+            // Burst: tail latency of single calls while logging flat out into a small ring.
+            AsyncLog.Start(LogLevel.Information, new ILogSink[] { file = new RotatingFileLogSink(Path.Combine(directory, "burst.log"), 4 << 20, 3) }, ringCapacity: 4096);
+            long droppedBefore = AsyncLog.Stats.Dropped;
+            var burstThread = new Thread(() => BurstAsync(calls, name));
+            burstThread.Start();
+            burstThread.Join();
+            var asyncTail = s_burst;
+            long dropped = AsyncLog.Stats.Dropped - droppedBefore;
+
+            (double P999, double Max) syncTail;
+            using (var writer = TextWriter.Synchronized(new StreamWriter(Path.Combine(directory, "burst-sync.log")) { AutoFlush = true }))
+                syncTail = TailLatency(calls, i => writer.WriteLine($"{DateTime.Now:HH:mm:ss.fff} info Bench: {name} #{i} at {i * 0.5f:F1}"));
+
+            AsyncLog.Flush();
+            return new AsyncLogBenchmarkResult(calls, filtered, template, templateBytes, loggerNs, loggerBytes, sync, syncBytes,
+                asyncTail.P999, asyncTail.Max, syncTail.P999, syncTail.Max, dropped, file.Rotations);
+        }
+        finally
+        {
+            AsyncLog.Stop();
+            try
+            {
+                Directory.Delete(directory, recursive: true);
+            }
+            catch (IOException)
+            {
+            }
+        }
+    }
+
+    // On a fresh thread, so the burst gets its own small ring.
+    private static void BurstAsync(int calls, string name) =>
+        s_burst = TailLatency(calls, i => AsyncLog.Write(s_spawn, name, i, i * 0.5f));
+
+    // Timed in chunks of half a ring with a flush between them (not timed), so no call is measured as a drop.
+    private static double Measure(int calls, Action<int> call, out double bytesPerCall)
+    {
+        const int chunk = AsyncLog.DefaultRingCapacity / 2;
+        long ticks = 0, allocated = 0;
+        for (int done = 0; done < calls; done += chunk)
+        {
+            AsyncLog.Flush();
+            int end = Math.Min(done + chunk, calls);
+            long bytes = GC.GetAllocatedBytesForCurrentThread();
+            long start = Stopwatch.GetTimestamp();
+            for (int i = done; i < end; i++)
+                call(i);
+            ticks += Stopwatch.GetTimestamp() - start;
+            allocated += GC.GetAllocatedBytesForCurrentThread() - bytes;
+        }
+        AsyncLog.Flush();
+        bytesPerCall = (double)allocated / calls;
+        return ticks * 1e9 / Stopwatch.Frequency / calls;
+    }
+
+    private static (double P999, double Max) TailLatency(int calls, Action<int> call)
+    {
+        var ticks = new long[calls];
+        for (int i = 0; i < calls; i++)
+        {
+            long t0 = Stopwatch.GetTimestamp();
+            call(i);
+            ticks[i] = Stopwatch.GetTimestamp() - t0;
+        }
+        Array.Sort(ticks);
+        double us = 1_000_000.0 / Stopwatch.Frequency;
+        return (ticks[Math.Min((int)(calls * 0.999), calls - 1)] * us, ticks[^1] * us);
+    }
+}
@@ -0,0 +1,214 @@
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Messages;
+using NativeInterop;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of one <see cref="MessageWriterBenchmark"/> run.
+/// </summary>
+public readonly record struct MessageWriterBenchmarkResult(
+    int Clients,
+    int Bursts,
+    bool NativeReplay,
+    double DirectNanosecondsPerMessage,
+    double BufferedNanosecondsPerMessage,
+    double EncodeNanosecondsPerMessage,
+    long DirectTransitionsPerBurst,
+    long BufferedTransitionsPerBurst,
+    long BufferedAllocatedBytes);
+
+/// <summary>
+/// Headless benchmark: a scoreboard + HUD text burst to every client, written call by call versus
+/// batched through <see cref="MessageWriter"/>, against a fake engine table whose Write* stubs hash what they receive.
+///
+/// The stubs are managed [UnmanagedCallersOnly] methods, so each engine call made by the native replay is itself a
+/// transition back into managed code; against the real engine those calls stay native. The encode-only figure is
+/// the managed cost that replaces the per-call transitions.
+/// </summary>
+public static unsafe class MessageWriterBenchmark
+{
+    private const int MSG_ONE = 1;
+    private const int ScoreInfo = 85;
+    private const int HudText = 86;
+
+    private static long _checksum;
+    private static long _calls;
+
+    public static void RunAndPrint(int clients = 32, int bursts = 2000)
+    {
+        var r = Run(clients, bursts);
+        Console.WriteLine($"[MessageWriterBenchmark] {r.Clients} clients x {r.Bursts} bursts, native replay {(r.NativeReplay ? "on" : "off")}");
+        Console.WriteLine($"[MessageWriterBenchmark] direct:   {r.DirectNanosecondsPerMessage:F1} ns/message, {r.DirectTransitionsPerBurst} transitions/burst");
+        Console.WriteLine($"[MessageWriterBenchmark] buffered: {r.BufferedNanosecondsPerMessage:F1} ns/message, {r.BufferedTransitionsPerBurst} transitions/burst, " +
+                          $"{r.BufferedAllocatedBytes} bytes allocated");
+        Console.WriteLine($"[MessageWriterBenchmark] encode only: {r.EncodeNanosecondsPerMessage:F1} ns/message");
+    }
+
+    /// <param name="nativeReplay">Replay entry to use (e.g. the loader's ReplayMessageStream); 0 uses <see cref="MessageReplay.NativeReplay"/>.</param>
+    public static MessageWriterBenchmarkResult Run(int clients, int bursts, nint nativeReplay = 0)
+    {
+        var engine = (ServerEngineFuncs*)NativeMemory.AllocZeroed((nuint)sizeof(ServerEngineFuncs));
+        var edicts = (edict_t*)NativeMemory.AllocZeroed((nuint)(clients + 1), (nuint)sizeof(edict_t));
+        var previous = MessageReplay.NativeReplay;
+
+        try
+        {
+            engine->MessageBegin = &StubMessageBegin;
+            engine->MessageEnd = &StubMessageEnd;
+            engine->WriteByte = &StubWriteInt;
+            engine->WriteChar = &StubWriteInt;
+            engine->WriteShort = &StubWriteInt;
+            engine->WriteLong = &StubWriteInt;
+            engine->WriteEntity = &StubWriteInt;
+            engine->WriteAngle = &StubWriteFloat;
+            engine->WriteCoord = &StubWriteFloat;
+            engine->WriteString = &StubWriteString;
+
+            if (nativeReplay != 0)
+                MessageReplay.NativeReplay = (delegate* unmanaged[Cdecl]<ServerEngineFuncs*, byte*, int, int>)nativeReplay;
+            bool native = MessageReplay.NativeReplay != null;
+
+            // Warm up both paths.
+            Direct(engine, edicts, clients, 0);
+            Buffered(engine, edicts, clients, 0);
+
+            _checksum = _calls = 0;
+            long start = Stopwatch.GetTimestamp();
+            for (int b = 0; b < bursts; b++)
+                Direct(engine, edicts, clients, b);
+            var directTime = Stopwatch.GetElapsedTime(start);
+            long directCalls = _calls;
+
+            _checksum = _calls = 0;
+            long allocated = GC.GetAllocatedBytesForCurrentThread();
+            start = Stopwatch.GetTimestamp();
+            for (int b = 0; b < bursts; b++)
+                Buffered(engine, edicts, clients, b);
+            var bufferedTime = Stopwatch.GetElapsedTime(start);
+            allocated = GC.GetAllocatedBytesForCurrentThread() - allocated;
+
+            start = Stopwatch.GetTimestamp();
+            for (int b = 0; b < bursts; b++)
+                Buffered(null, edicts, clients, b);
+            var encodeTime = Stopwatch.GetElapsedTime(start);
+
+            long messages = (long)bursts * clients * clients * 2;
+            long directPerBurst = directCalls / bursts;
+            return new MessageWriterBenchmarkResult(clients, bursts, native,
+                directTime.TotalNanoseconds / messages,
+                bufferedTime.TotalNanoseconds / messages,
+                encodeTime.TotalNanoseconds / messages,
+                directPerBurst,
+                native ? 1 : directPerBurst,
+                allocated);
+        }
+        finally
+        {
+            MessageReplay.NativeReplay = previous;
+            NativeMemory.Free(edicts);
+            NativeMemory.Free(engine);
+        }
+    }
+
+    // Every client receives every player's score line plus one HUD string per player.
+    private static void Direct(ServerEngineFuncs* engine, edict_t* edicts, int clients, int burst)
+    {
+        for (int to = 1; to <= clients; to++)
+        {
+            for (int player = 1; player <= clients; player++)
+            {
+                engine->MessageBegin(MSG_ONE, ScoreInfo, null, &edicts[to]);
+                engine->WriteByte(player);
+                engine->WriteShort(burst + player);
+                engine->WriteShort(player);
+                engine->WriteShort(0);
+                engine->WriteShort(player & 3);
+                engine->MessageEnd();
+
+                engine->MessageBegin(MSG_ONE, HudText, null, &edicts[to]);
+                engine->WriteByte(player);
+                engine->WriteCoord(burst * 0.5f);
+                fixed (byte* text = "#Player_Scored\0"u8)
+                    engine->WriteString((NChar*)text);
+                engine->MessageEnd();
+            }
+        }
+    }
+
+    // A null engine only encodes.
+    private static void Buffered(ServerEngineFuncs* engine, edict_t* edicts, int clients, int burst)
+    {
+        var msg = new MessageWriter(stackalloc byte[1024], direct: null);
+        for (int to = 1; to <= clients; to++)
+        {
+            for (int player = 1; player <= clients; player++)
+            {
+                msg.Begin(MSG_ONE, ScoreInfo, null, &edicts[to]);
+                msg.WriteByte(player);
+                msg.WriteShort(burst + player);
+                msg.WriteShort(player);
+                msg.WriteShort(0);
+                msg.WriteShort(player & 3);
+                msg.End();
+
+                msg.Begin(MSG_ONE, HudText, null, &edicts[to]);
+                msg.WriteByte(player);
+                msg.WriteCoord(burst * 0.5f);
+                msg.WriteString("#Player_Scored"u8);
+                msg.End();
+            }
+        }
+        if (engine != null)
+            msg.Flush(engine);
+        msg.Dispose();
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static void Mix(long value)
+    {
+        _checksum = _checksum * 31 + value;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubMessageBegin(int dest, int type, float* origin, edict_t* edict)
+    {
+        _calls++;
+        Mix(dest * 1000 + type);
+        Mix((long)edict & 0xFFFF);
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubMessageEnd()
+    {
+        _calls++;
+        Mix(-1);
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubWriteInt(int value)
+    {
+        _calls++;
+        Mix(value);
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubWriteFloat(float value)
+    {
+        _calls++;
+        Mix(BitConverter.SingleToInt32Bits(value));
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubWriteString(NChar* text)
+    {
+        _calls++;
+        long h = 0;
+        for (byte* p = (byte*)text; *p != 0; p++)
+            h = h * 131 + *p;
+        Mix(h);
+    }
+}
@@ -0,0 +1,269 @@
+using System.Diagnostics;
+using System.Text;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Models;
+using GoldsrcFramework.Strings;
+using StudioConstants = GoldsrcFramework.Engine.Native.Deprecation.StudioConstants;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of one <see cref="ModelPrewarmBenchmark"/> run.
+/// </summary>
+public readonly record struct ModelPrewarmBenchmarkResult(
+    int Models,
+    long Bytes,
+    int Workers,
+    double SerialMilliseconds,
+    double ParallelMilliseconds,
+    double FirstUseMicroseconds,
+    double NameMergeNanoseconds,
+    double RemapMergeNanoseconds);
+
+/// <summary>
+/// Headless benchmark of <see cref="ModelPrewarm"/> over synthetic studio models written to a temp directory (or a
+/// real models directory).
+///
+/// Serial vs parallel: the same prewarm with one worker and with <see cref="Environment.ProcessorCount"/>; first use
+/// is what each model costs when it is built lazily on the frame that first draws it. The merge numbers compare
+/// StudioMergeBones' per-frame bone name scan for a weapon on a player against the prewarmed remap table.
+/// </summary>
+public static unsafe class ModelPrewarmBenchmark
+{
+    public static void RunAndPrint(int models = 96, int iterations = 5, string? modelsDirectory = null)
+    {
+        var r = modelsDirectory != null ? RunDirectory(modelsDirectory, iterations) : Run(models, iterations);
+        Console.WriteLine($"[ModelPrewarmBenchmark] {r.Models} models, {r.Bytes / 1024} KB");
+        Console.WriteLine($"[ModelPrewarmBenchmark] prewarm serial: {r.SerialMilliseconds:F2} ms, {r.Workers} workers: {r.ParallelMilliseconds:F2} ms " +
+                          $"({r.SerialMilliseconds / r.ParallelMilliseconds:F2}x)");
+        Console.WriteLine($"[ModelPrewarmBenchmark] first use without prewarm: {r.FirstUseMicroseconds:F1} us/model on the frame that draws it");
+        Console.WriteLine($"[ModelPrewarmBenchmark] merge bones: name scan {r.NameMergeNanoseconds:F0} ns, remap {r.RemapMergeNanoseconds:F0} ns per merge");
+    }
+
+    public static ModelPrewarmBenchmarkResult Run(int models, int iterations)
+    {
+        string root = Path.Combine(Path.GetTempPath(), "gsf_prewarm_" + Environment.ProcessId);
+        Directory.CreateDirectory(Path.Combine(root, "models"));
+        try
+        {
+            var names = new List<string>();
+            for (int i = 0; i < models; i++)
+            {
+                // Every fourth model is a weapon sharing the player's hand bones.
+                bool weapon = i % 4 == 3;
+                string name = weapon ? $"models/p_weapon{i}.mdl" : $"models/monster{i}.mdl";
+                File.WriteAllBytes(Path.Combine(root, name), BuildModel(weapon ? 12 : 48, weapon ? 4 : 20, weapon ? 8 : 60, i));
+                names.Add(name);
+            }
+            return Run(root, names, iterations);
+        }
+        finally
+        {
+            Directory.Delete(root, true);
+        }
+    }
+
+    /// <summary>
+    /// Benchmark every .mdl under <paramref name="modelsDirectory"/> (e.g. valve/models).
+    /// </summary>
+    public static ModelPrewarmBenchmarkResult RunDirectory(string modelsDirectory, int iterations)
+    {
+        string root = Path.GetDirectoryName(Path.GetFullPath(modelsDirectory).TrimEnd(Path.DirectorySeparatorChar))!;
+        var names = Directory.EnumerateFiles(modelsDirectory, "*.mdl", SearchOption.AllDirectories)
+            .Select(path => Path.GetRelativePath(root, path).Replace('\\', '/'))
+            .ToList();
+        return Run(root, names, iterations);
+    }
+
+    private static ModelPrewarmBenchmarkResult Run(string root, List<string> names, int iterations)
+    {
+        int workers = Environment.ProcessorCount;
+        ModelPrewarmReport serial = default, parallel = default;
+        double serialMs = double.MaxValue, parallelMs = double.MaxValue;
+
+        // Warm the page cache and the JIT, then keep the best of each.
+        Prewarm(root, names, 1);
+        for (int i = 0; i < iterations; i++)
+        {
+            serial = Prewarm(root, names, 1);
+            serialMs = Math.Min(serialMs, serial.WallMilliseconds);
+            parallel = Prewarm(root, names, workers);
+            parallelMs = Math.Min(parallelMs, parallel.WallMilliseconds);
+        }
+
+        // Lazy path: the cache builds each model on its first lookup.
+        double firstUse = double.MaxValue;
+        for (int i = 0; i < iterations; i++)
+        {
+            var lazy = new StudioModelCache { GameDirectory = root };
+            long start = Stopwatch.GetTimestamp();
+            foreach (var name in names)
+                lazy.Get(new Utf8View(Encoding.UTF8.GetBytes(name)));
+            firstUse = Math.Min(firstUse, Stopwatch.GetElapsedTime(start).TotalMilliseconds * 1000 / Math.Max(names.Count, 1));
+        }
+
+        var cache = new StudioModelCache { GameDirectory = root };
+        ModelPrewarm.Run(cache, names, workers);
+
+        var (nameNs, remapNs) = MeasureMerge(cache, names);
+        return new ModelPrewarmBenchmarkResult(names.Count, parallel.Bytes, Math.Min(workers, Math.Max(names.Count, 1)),
+            serialMs, parallelMs, firstUse, nameNs, remapNs);
+    }
+
+    private static ModelPrewarmReport Prewarm(string root, List<string> names, int workers)
+    {
+        var cache = new StudioModelCache { GameDirectory = root };
+        return ModelPrewarm.Run(cache, names, workers);
+    }
+
+    // Player + weapon pair: the largest model merged with the smallest one, both directions of StudioMergeBones.
+    private static (double NameNs, double RemapNs) MeasureMerge(StudioModelCache cache, List<string> names)
+    {
+        var infos = names.Select(n => cache.TryGet(new Utf8View(Encoding.UTF8.GetBytes(n)), out var info) ? info! : null)
+            .Where(i => i != null).Cast<StudioModelInfo>().ToList();
+        if (infos.Count < 2)
+            return (0, 0);
+
+        var parent = infos.MaxBy(i => i.BoneCount)!;
+        var child = infos.Where(i => i != parent).MinBy(i => i.BoneCount)!;
+        var parentNames = parent.BoneNames.Select(n => Encoding.UTF8.GetBytes(n.PadRight(32, '\0')[..32])).ToArray();
+        var childNames = child.BoneNames.Select(n => Encoding.UTF8.GetBytes(n.PadRight(32, '\0')[..32])).ToArray();
+
+        var byName = new int[child.BoneCount];
+        var byRemap = new int[child.BoneCount];
+        const int Rounds = 20000;
+
+        long start = Stopwatch.GetTimestamp();
+        for (int r = 0; r < Rounds; r++)
+            MatchByName(childNames, parentNames, byName);
+        double nameNs = Stopwatch.GetElapsedTime(start).TotalMilliseconds * 1e6 / Rounds;
+
+        start = Stopwatch.GetTimestamp();
+        for (int r = 0; r < Rounds; r++)
+            MatchByRemap(child, parent, byRemap);
+        double remapNs = Stopwatch.GetElapsedTime(start).TotalMilliseconds * 1e6 / Rounds;
+
+        return (nameNs, remapNs);
+    }
+
+    // StudioMergeBones' search, over the same 32-byte name buffers.
+    private static void MatchByName(byte[][] child, byte[][] parent, int[] result)
+    {
+        for (int i = 0; i < child.Length; i++)
+        {
+            int j;
+            for (j = 0; j < parent.Length; j++)
+            {
+                bool match = true;
+                for (int k = 0; k < 32; k++)
+                {
+                    if (child[i][k] != parent[j][k])
+                    {
+                        match = false;
+                        break;
+                    }
+                    if (child[i][k] == 0)
+                        break;
+                }
+                if (match)
+                    break;
+            }
+            result[i] = j < parent.Length ? j : -1;
+        }
+    }
+
+    private static void MatchByRemap(StudioModelInfo child, StudioModelInfo parent, int[] result)
+    {
+        var ids = child.BoneNameIds;
+        for (int i = 0; i < ids.Length; i++)
+            result[i] = parent.BoneForNameId(ids[i]);
+    }
+
+    /// <summary>
+    /// A valid IDST v10 model: a bone chain with "Bip01 ..." names (shared between models, as on real player and weapon
+    /// models), hitboxes, sequences across two groups with activities, attachments and one body part.
+    /// </summary>
+    private static byte[] BuildModel(int boneCount, int hitboxCount, int sequenceCount, int seed)
+    {
+        int groups = 2;
+        int offset = sizeof(studiohdr_t);
+        int boneIndex = offset; offset += boneCount * sizeof(mstudiobone_t);
+        int hitboxIndex = offset; offset += hitboxCount * sizeof(mstudiobbox_t);
+        int seqIndex = offset; offset += sequenceCount * sizeof(mstudioseqdesc_t);
+        int groupIndex = offset; offset += groups * sizeof(mstudioseqgroup_t);
+        int attachmentIndex = offset; offset += 2 * sizeof(mstudioattachment_t);
+        int bodyPartIndex = offset; offset += sizeof(mstudiobodyparts_t);
+        int modelIndex = offset; offset += sizeof(mstudiomodel_t);
+        int animIndex = offset; offset += sequenceCount * boneCount * sizeof(mstudioanim_t);
+
+        var data = new byte[offset];
+        fixed (byte* b = data)
+        {
+            var h = (studiohdr_t*)b;
+            h->id = StudioConstants.IDSTUDIOHEADER;
+            h->version = StudioConstants.STUDIO_VERSION;
+            h->length = data.Length;
+            h->numbones = boneCount;
+            h->boneindex = boneIndex;
+            h->numhitboxes = hitboxCount;
+            h->hitboxindex = hitboxIndex;
+            h->numseq = sequenceCount;
+            h->seqindex = seqIndex;
+            h->numseqgroups = groups;
+            h->seqgroupindex = groupIndex;
+            h->numattachments = 2;
+            h->attachmentindex = attachmentIndex;
+            h->numbodyparts = 1;
+            h->bodypartindex = bodyPartIndex;
+
+            var bones = (mstudiobone_t*)(b + boneIndex);
+            for (int i = 0; i < boneCount; i++)
+            {
+                WriteName(&bones[i].name, i == 0 ? "Bip01" : $"Bip01 Bone{i}");
+                bones[i].parent = i == 0 ? -1 : (i - 1) / 2;
+            }
+
+            var hitboxes = (mstudiobbox_t*)(b + hitboxIndex);
+            for (int i = 0; i < hitboxCount; i++)
+            {
+                hitboxes[i].bone = (i * 7 + seed) % boneCount;
+                hitboxes[i].group = i % 8;
+            }
+
+            var seqs = (mstudioseqdesc_t*)(b + seqIndex);
+            for (int i = 0; i < sequenceCount; i++)
+            {
+                WriteName(&seqs[i].label, $"seq{i}");
+                seqs[i].fps = 30;
+                seqs[i].numframes = 10 + i % 20;
+                seqs[i].numblends = 1;
+                seqs[i].activity = i % 5 == 0 ? 0 : 1 + i % 12;
+                seqs[i].actweight = 1;
+                seqs[i].seqgroup = i % 3 == 2 ? 1 : 0;
+                seqs[i].animindex = seqs[i].seqgroup == 0 ? animIndex + i * boneCount * sizeof(mstudioanim_t) : 0;
+            }
+
+            var seqGroups = (mstudioseqgroup_t*)(b + groupIndex);
+            WriteName(&seqGroups[0].name, "default");
+            WriteName(&seqGroups[1].name, $"models/monster{seed}01.mdl");
+
+            var attachments = (mstudioattachment_t*)(b + attachmentIndex);
+            attachments[0].bone = boneCount - 1;
+            attachments[1].bone = boneCount / 2;
+
+            var part = (mstudiobodyparts_t*)(b + bodyPartIndex);
+            WriteName(&part->name, "body");
+            part->nummodels = 1;
+            part->@base = 1;
+            part->modelindex = modelIndex;
+        }
+        return data;
+    }
+
+    private static void WriteName<T>(T* field, string name) where T : unmanaged
+    {
+        var bytes = new Span<byte>(field, sizeof(T));
+        bytes.Clear();
+        Encoding.ASCII.GetBytes(name.AsSpan(0, Math.Min(name.Length, sizeof(T) - 1)), bytes);
+    }
+}
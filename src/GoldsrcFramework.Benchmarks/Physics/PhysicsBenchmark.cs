@@ -0,0 +1,78 @@
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Physics;
+using SQuaternion = Stride.Core.Mathematics.Quaternion;
+using SVector3 = Stride.Core.Mathematics.Vector3;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of a <see cref="PhysicsBenchmark"/> run.
+/// </summary>
+public readonly record struct PhysicsBenchmarkResult(
+    int BodyCount,
+    int ThreadCount,
+    int Frames,
+    double TotalMilliseconds,
+    double StepMillisecondsPerFrame,
+    double SyncMillisecondsPerFrame);
+
+/// <summary>
+/// Headless benchmark for <see cref="PhysicsWorld"/>: a grid of boxes dropped onto a static floor, every body
+/// bound to a fake edict so the per-frame batch sync is part of the measurement. No engine required.
+/// </summary>
+public static unsafe class PhysicsBenchmark
+{
+    /// <summary>
+    /// Run with 1 thread and with one thread per core, and print the results to the console.
+    /// </summary>
+    public static void RunAndPrint(int bodyCount = 4096, int frames = 600)
+    {
+        foreach (var threads in new[] { 1, Environment.ProcessorCount }.Distinct())
+        {
+            var r = Run(bodyCount, frames, threads);
+            Console.WriteLine($"[PhysicsBenchmark] {r.BodyCount} bodies, {r.ThreadCount} threads, {r.Frames} frames: " +
+                              $"{r.TotalMilliseconds:F1} ms total, step {r.StepMillisecondsPerFrame:F3} ms/frame, sync {r.SyncMillisecondsPerFrame:F3} ms/frame");
+        }
+    }
+
+    /// <summary>
+    /// Simulate <paramref name="bodyCount"/> boxes for <paramref name="frames"/> server frames at 60 fps.
+    /// </summary>
+    public static PhysicsBenchmarkResult Run(int bodyCount = 4096, int frames = 600, int threadCount = 0)
+    {
+        var edicts = (edict_t*)NativeMemory.AllocZeroed((nuint)bodyCount, (nuint)sizeof(edict_t));
+
+        try
+        {
+            using var world = new PhysicsWorld(updateRate: 60, substeps: 1, maxStepsPerFrame: 4, threadCount: threadCount);
+            world.AddStaticBox(new SVector3(4096, 4096, 16), new SVector3(0, 0, -16));
+
+            int side = (int)MathF.Ceiling(MathF.Sqrt(bodyCount));
+            for (int i = 0; i < bodyCount; i++)
+            {
+                var position = new SVector3((i % side - side / 2) * 24f, (i / side % side - side / 2) * 24f, 32f + (i / (side * side)) * 24f + (i % 7) * 4f);
+                var node = world.AddBox(new SVector3(8, 8, 8), position, SQuaternion.Identity);
+                edicts[i].serialnumber = i + 1;
+                node.Bind(&edicts[i]);
+            }
+
+            double step = 0, sync = 0;
+            long start = Stopwatch.GetTimestamp();
+            for (int i = 0; i < frames; i++)
+            {
+                world.Update(1f / 60f);
+                step += world.LastFrame.StepMilliseconds;
+                sync += world.LastFrame.SyncMilliseconds;
+            }
+            var elapsed = Stopwatch.GetElapsedTime(start);
+
+            return new PhysicsBenchmarkResult(bodyCount, world.ThreadCount, frames, elapsed.TotalMilliseconds, step / frames, sync / frames);
+        }
+        finally
+        {
+            NativeMemory.Free(edicts);
+        }
+    }
+}
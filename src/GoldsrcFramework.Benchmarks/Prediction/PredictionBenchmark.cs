@@ -0,0 +1,217 @@
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Prediction;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of one <see cref="PredictionBenchmark"/> configuration.
+/// </summary>
+public readonly record struct PredictionBenchmarkResult(
+    int LatencyCommands,
+    int Frames,
+    bool Cached,
+    double MicrosecondsPerFrame,
+    double WeaponThinksPerFrame,
+    PredictionStats Stats);
+
+/// <summary>
+/// Headless benchmark for <see cref="PredictionRing"/>.
+/// Plays the engine's side of client prediction at 100 fps: the server runs each command <c>latency</c> frames
+/// late and sends its (delta-quantized) state every few frames, and every frame re-runs all unacknowledged commands
+/// through movement and a stand-in for the legacy HUD_WeaponsPostThink, with and without the ring. The server
+/// occasionally changes the clip on its own to force mispredicts. No engine required.
+/// </summary>
+public static unsafe class PredictionBenchmark
+{
+    private const int IN_ATTACK = 1 << 0;
+    private const int MaxWeapons = 64;
+    private const int ServerBackup = 128;
+    private const float FrameTime = 0.01f;
+
+    private static float s_sink;
+
+    /// <summary>
+    /// Run a few latencies with and without the ring and print the results to the console.
+    /// </summary>
+    public static void RunAndPrint(int frames = 5000)
+    {
+        foreach (var latency in new[] { 4, 12, 24, 48 })
+        {
+            foreach (var cached in new[] { false, true })
+            {
+                var r = Run(latency, frames, cached);
+                Console.WriteLine($"[PredictionBenchmark] {r.LatencyCommands,2} commands in flight, {(r.Cached ? "ring  " : "re-run")}: " +
+                                  $"{r.MicrosecondsPerFrame:F2} us/frame, {r.WeaponThinksPerFrame:F2} weapon thinks/frame, " +
+                                  $"reused={r.Stats.Reused} confirmed={r.Stats.Confirmed} mispredicts={r.Stats.Mispredicts}");
+            }
+        }
+    }
+
+    /// <param name="latency">Commands the server is behind (ping / frame time); at most 60.</param>
+    /// <param name="packetInterval">Frames between server updates.</param>
+    /// <param name="mispredictInterval">Every this many server commands the server takes a bullet off the clip; 0 never.</param>
+    /// <param name="thinkCost">Busy work per weapon think, standing in for the legacy weapon code.</param>
+    public static PredictionBenchmarkResult Run(int latency, int frames, bool cached, int packetInterval = 3, int mispredictInterval = 97, int thinkCost = 256)
+    {
+        latency = Math.Clamp(latency, 1, PredictionRing.DefaultCapacity - 4);
+        var predicted = (local_state_t*)NativeMemory.AllocZeroed(PredictionRing.DefaultCapacity, (nuint)sizeof(local_state_t));
+        var server = (local_state_t*)NativeMemory.AllocZeroed(ServerBackup, (nuint)sizeof(local_state_t));
+        var acknowledged = (local_state_t*)NativeMemory.AllocZeroed((nuint)sizeof(local_state_t));
+        var commands = (usercmd_t*)NativeMemory.AllocZeroed((nuint)frames + 1, (nuint)sizeof(usercmd_t));
+        using var ring = new PredictionRing();
+
+        try
+        {
+            InitialState(server);
+            *acknowledged = *server;
+            for (int i = 1; i <= frames; i++)
+            {
+                commands[i].msec = (byte)(FrameTime * 1000);
+                commands[i].forwardmove = 250;
+                // Bursts of fire with pauses, so reloads and idle time both happen.
+                commands[i].buttons = (ushort)((i / 40) % 3 != 2 ? IN_ATTACK : 0);
+            }
+
+            long thinks = 0;
+            int ack = 0;
+            var stopwatch = Stopwatch.StartNew();
+
+            for (int frame = 1; frame <= frames; frame++)
+            {
+                // Server side: run the command that arrives now.
+                int serverCommand = frame - latency;
+                if (serverCommand >= 1)
+                {
+                    var previous = &server[(serverCommand - 1) % ServerBackup];
+                    var current = &server[serverCommand % ServerBackup];
+                    *current = *previous;
+                    Move(current, &commands[serverCommand]);
+                    Think(previous, current, &commands[serverCommand], thinkCost);
+                    if (mispredictInterval > 0 && serverCommand % mispredictInterval == 0)
+                        Weapons(current)[current->client.m_iId].m_iClip--;
+
+                    if (frame % packetInterval == 0)
+                    {
+                        ack = serverCommand;
+                        *acknowledged = *current;
+                        Quantize(acknowledged);
+                        if (cached)
+                            ring.Acknowledge(&acknowledged->client, (weapon_data_t*)&acknowledged->weapondata);
+                    }
+                }
+
+                // Client side: re-run everything the server has not acknowledged yet.
+                var from = acknowledged;
+                for (int command = ack + 1; command <= frame; command++)
+                {
+                    var to = &predicted[command % PredictionRing.DefaultCapacity];
+                    var cmd = &commands[command];
+                    double time = command * (double)FrameTime;
+                    int runfuncs = command == frame ? 1 : 0;
+
+                    *to = *from;
+                    Move(to, cmd);
+                    if (!cached || !ring.TryReuse(from, to, cmd, runfuncs, time, (uint)command))
+                    {
+                        Think(from, to, cmd, thinkCost);
+                        thinks++;
+                        if (cached)
+                            ring.Store(from, to, cmd, time, (uint)command);
+                    }
+                    from = to;
+                }
+            }
+
+            stopwatch.Stop();
+            return new PredictionBenchmarkResult(latency, frames, cached, stopwatch.Elapsed.TotalMilliseconds * 1000 / frames,
+                                                 (double)thinks / frames, ring.Stats);
+        }
+        finally
+        {
+            NativeMemory.Free(commands);
+            NativeMemory.Free(acknowledged);
+            NativeMemory.Free(server);
+            NativeMemory.Free(predicted);
+        }
+    }
+
+    private static Span<weapon_data_t> Weapons(local_state_t* state) => new(&state->weapondata, MaxWeapons);
+
+    private static void InitialState(local_state_t* state)
+    {
+        state->client.m_iId = 1;
+        state->client.velocity = new Vector3(250, 0, 0);
+        state->client.health = 100;
+        state->client.fov = 90;
+        state->client.maxspeed = 320;
+        var weapons = Weapons(state);
+        for (int i = 1; i <= 4; i++)
+        {
+            weapons[i].m_iId = i;
+            weapons[i].m_iClip = 30;
+        }
+    }
+
+    // Engine movement: runs before HUD_PostRunCmd and leaves its result in to->client.
+    private static void Move(local_state_t* to, usercmd_t* cmd)
+    {
+        float dt = cmd->msec / 1000f;
+        to->client.origin += to->client.velocity * dt;
+    }
+
+    // Stand-in for HUD_WeaponsPostThink: timers, fire, reload, plus a fixed amount of busy work.
+    private static void Think(local_state_t* from, local_state_t* to, usercmd_t* cmd, int cost)
+    {
+        float dt = cmd->msec / 1000f;
+        var fromWeapons = Weapons(from);
+        var weapons = Weapons(to);
+        for (int i = 0; i < MaxWeapons; i++)
+        {
+            if (fromWeapons[i].m_iId == 0)
+                continue;
+            weapons[i].m_flNextPrimaryAttack = MathF.Max(fromWeapons[i].m_flNextPrimaryAttack - dt, -0.001f);
+            weapons[i].m_flTimeWeaponIdle = MathF.Max(fromWeapons[i].m_flTimeWeaponIdle - dt, -0.001f);
+        }
+
+        // Timers count as expired within half a millisecond, so 1 ms quantization does not move the threshold.
+        ref var active = ref weapons[from->client.m_iId];
+        bool ready = active.m_flNextPrimaryAttack <= 0.0005f;
+        to->client.weaponanim = 0;
+        if (active.m_iClip == 0 && ready)
+        {
+            active.m_iClip = 30;
+            active.m_flNextPrimaryAttack = 1.0f;
+            to->client.weaponanim = 2;
+        }
+        else if ((cmd->buttons & IN_ATTACK) != 0 && active.m_iClip > 0 && ready)
+        {
+            active.m_iClip--;
+            active.m_flNextPrimaryAttack = 0.1f;
+            active.m_flTimeWeaponIdle = 2.0f;
+            to->client.weaponanim = 1;
+        }
+
+        float acc = 0;
+        for (int i = 0; i < cost; i++)
+            acc += MathF.Sin(i * 0.37f + active.m_iClip);
+        s_sink = acc;
+    }
+
+    // What survives the trip through the delta encoder: 1/8 unit positions, 1 ms timers.
+    private static void Quantize(local_state_t* state)
+    {
+        state->client.origin = Round(state->client.origin, 8);
+        state->client.velocity = Round(state->client.velocity, 8);
+        foreach (ref var weapon in Weapons(state))
+        {
+            weapon.m_flNextPrimaryAttack = MathF.Round(weapon.m_flNextPrimaryAttack * 1000) / 1000;
+            weapon.m_flTimeWeaponIdle = MathF.Round(weapon.m_flTimeWeaponIdle * 1000) / 1000;
+        }
+    }
+
+    private static Vector3 Round(Vector3 v, float scale)
+        => new(MathF.Round(v.X * scale) / scale, MathF.Round(v.Y * scale) / scale, MathF.Round(v.Z * scale) / scale);
+}
@@ -0,0 +1,90 @@
+﻿namespace GoldsrcFramework.Benchmarks
+{
+    /// <summary>
+    /// Runs the headless benchmarks and prints their results:
+    /// GoldsrcFramework.Benchmarks [--map file.bsp] [--settings modSettings.json] [name ...], every benchmark when no
+    /// name is given. Build in Release; the numbers are only comparable between runs on the same machine.
+    /// </summary>
+    internal class Program
+    {
+        /// <summary>
+        /// Map for the benchmarks that read a .bsp (--map)
+        /// </summary>
+        private static string? s_mapPath;
+
+        /// <summary>
+        /// Mod settings for the startup benchmark, to include the mod's game assembly (--settings)
+        /// </summary>
+        private static string? s_settingsPath;
+
+        private static readonly Dictionary<string, Action> s_benchmarks = new(StringComparer.OrdinalIgnoreCase)
+        {
+            ["asynclog"] = () => AsyncLogBenchmark.RunAndPrint(),
+            ["commands"] = () => CommandRouterBenchmark.RunAndPrint(),
+            ["delta"] = () => DeltaEncoderBenchmark.RunAndPrint(),
+            ["entitylump"] = () => EntityLumpBenchmark.RunAndPrint(bspPath: s_mapPath),
+            ["frameprofiler"] = () => FrameProfilerBenchmark.RunAndPrint(),
+            ["hulltrace"] = () => WithMap("HullTraceBenchmark", path => HullTraceBenchmark.RunAndPrint(path)),
+            ["jobs"] = () => JobSchedulerBenchmark.RunAndPrint(),
+            ["messagewriter"] = () => MessageWriterBenchmark.RunAndPrint(),
+            ["modelprewarm"] = () => ModelPrewarmBenchmark.RunAndPrint(),
+            ["paralleltick"] = () => ParallelTickBenchmark.RunAndPrint(),
+            ["physics"] = () => PhysicsBenchmark.RunAndPrint(),
+            ["prediction"] = () => PredictionBenchmark.RunAndPrint(),
+            ["privatedata"] = () => PrivateDataBenchmark.RunAndPrint(),
+            ["startup"] = () => StartupBenchmark.RunAndPrint(s_settingsPath),
+            ["tempentity"] = () => TempEntityBenchmark.RunAndPrint(),
+            ["triangles"] = () => TriangleBatcherBenchmark.RunAndPrint(),
+            ["visibility"] = () =>
+            {
+                if (s_mapPath != null)
+                    VisibilityBenchmark.RunAndPrint(s_mapPath);
+                else
+                    VisibilityBenchmark.RunAndPrint();
+            },
+        };
+
+        static int Main(string[] args)
+        {
+#if DEBUG
+            Console.WriteLine("Warning: Debug build, timings are not representative.");
+#endif
+            var names = new List<string>();
+            for (int i = 0; i < args.Length; i++)
+            {
+                if (args[i] == "--map" && i + 1 < args.Length)
+                    s_mapPath = args[++i];
+                else if (args[i] == "--settings" && i + 1 < args.Length)
+                    s_settingsPath = args[++i];
+                else if (s_benchmarks.ContainsKey(args[i]))
+                    names.Add(args[i]);
+                else
+                {
+                    ShowUsage();
+                    return 1;
+                }
+            }
+
+            if (names.Count == 0)
+                names.AddRange(s_benchmarks.Keys);
+
+            foreach (var name in names)
+                s_benchmarks[name]();
+            return 0;
+        }
+
+        private static void WithMap(string benchmark, Action<string> run)
+        {
+            if (s_mapPath == null)
+                Console.WriteLine($"[{benchmark}] Skipped: needs --map <file.bsp>");
+            else
+                run(s_mapPath);
+        }
+
+        private static void ShowUsage()
+        {
+            Console.WriteLine("Usage: GoldsrcFramework.Benchmarks [--map file.bsp] [--settings modSettings.json] [name ...]");
+            Console.WriteLine("Benchmarks: " + string.Join(", ", s_benchmarks.Keys));
+        }
+    }
+}
@@ -0,0 +1,148 @@
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Tick;
+
+namespace GoldsrcFramework.Benchmarks;
+
+/// <summary>
+/// Result of one <see cref="ParallelTickBenchmark"/> configuration.
+/// </summary>
+public readonly record struct ParallelTickBenchmarkResult(
+    int Bots,
+    int Workers,
+    int Frames,
+    double MillisecondsPerFrame,
+    double TickMillisecondsPerFrame,
+    double ApplyMillisecondsPerFrame,
+    double Speedup);
+
+/// <summary>
+/// Headless scaling benchmark for <see cref="ParallelTick"/>.
+/// Every bot scans the snapshot for the nearest living enemy (O(n) per bot), steers toward it and fires when close,
+/// against a fake edict array and engine table, with 1..N workers.
+/// </summary>
+public static unsafe class ParallelTickBenchmark
+{
+    private sealed class BotBehaviour : EntityBehaviour
+    {
+        public int Shots;
+
+        public override void Tick(WorldSnapshot world, in EntitySnapshot self, ref TickCommandWriter commands)
+        {
+            var entities = world.Entities;
+            int best = 0;
+            float bestDist = float.MaxValue;
+            for (int i = 1; i < entities.Length; i++)
+            {
+                ref readonly var other = ref entities[i];
+                if (!other.InUse || other.Team == self.Team || other.Health <= 0)
+                    continue;
+
+                float dist = (other.Origin - self.Origin).LengthSquared();
+                if (dist < bestDist)
+                {
+                    bestDist = dist;
+                    best = i;
+                }
+            }
+
+            if (best == 0)
+                return;
+
+            var delta = world[best].Origin - self.Origin;
+            float length = MathF.Sqrt(bestDist);
+            var dir = length > 0 ? delta * (1 / length) : default;
+
+            commands.SetVelocity(dir * 250);
+            commands.SetAngles(new Vector3(0, MathF.Atan2(dir.Y, dir.X) * (180 / MathF.PI), 0));
+            commands.Move(self.Origin + dir * (250 * world.FrameTime));
+            if (length < 64)
+                commands.Fire(dir);
+            commands.SetNextThink(world.Time + 0.1f);
+        }
+
+        public override void OnCommand(edict_t* edict, in TickCommand command)
+        {
+            if (command.Kind == TickCommandKind.Fire)
+                Shots++;
+        }
+    }
+
+    /// <summary>
+    /// Run 1..ProcessorCount workers and print the results to the console.
+    /// </summary>
+    public static void RunAndPrint(int bots = 1024, int frames = 200)
+    {
+        foreach (var r in RunScaling(bots, frames))
+        {
+            Console.WriteLine($"[ParallelTickBenchmark] {r.Bots} bots, {r.Workers} workers: {r.MillisecondsPerFrame:F3} ms/frame " +
+                              $"(tick {r.TickMillisecondsPerFrame:F3}, apply {r.ApplyMillisecondsPerFrame:F3}), x{r.Speedup:F2}");
+        }
+    }
+
+    public static List<ParallelTickBenchmarkResult> RunScaling(int bots = 1024, int frames = 200)
+    {
+        var results = new List<ParallelTickBenchmarkResult>();
+        double baseline = 0;
+        for (int workers = 1; workers <= Environment.ProcessorCount; workers++)
+        {
+            var r = Run(bots, frames, workers);
+            if (workers == 1)
+                baseline = r.MillisecondsPerFrame;
+            results.Add(r with { Speedup = baseline / r.MillisecondsPerFrame });
+        }
+        return results;
+    }
+
+    public static ParallelTickBenchmarkResult Run(int bots, int frames, int workers)
+    {
+        int edictCount = bots + 1;
+        var edicts = (edict_t*)NativeMemory.AllocZeroed((nuint)edictCount, (nuint)sizeof(edict_t));
+        var engine = (ServerEngineFuncs*)NativeMemory.AllocZeroed((nuint)sizeof(ServerEngineFuncs));
+
+        try
+        {
+            engine->SetOrigin = &StubSetOrigin;
+
+            var tick = new ParallelTick(workers);
+            var rng = new Random(1234);
+            for (int i = 1; i < edictCount; i++)
+            {
+                edicts[i].serialnumber = i;
+                edicts[i].pvPrivateData = &edicts[i];
+                edicts[i].v.origin = new Vector3(rng.NextSingle() * 4096 - 2048, rng.NextSingle() * 4096 - 2048, 0);
+                edicts[i].v.health = 100;
+                edicts[i].v.team = i & 1;
+                tick.Register(new BotBehaviour(), i);
+            }
+
+            double tickMs = 0, applyMs = 0;
+            float time = 1;
+            long start = Stopwatch.GetTimestamp();
+            for (int f = 0; f < frames; f++)
+            {
+                tick.Run(engine, edicts, edictCount, time += 0.01f, 0.01f);
+                tickMs += tick.LastTick.TickMilliseconds;
+                applyMs += tick.LastTick.ApplyMilliseconds;
+            }
+            var elapsed = Stopwatch.GetElapsedTime(start);
+
+            return new ParallelTickBenchmarkResult(bots, workers, frames, elapsed.TotalMilliseconds / frames,
+                tickMs / frames, applyMs / frames, 1);
+        }
+        finally
+        {
+            NativeMemory.Free(engine);
+            NativeMemory.Free(edicts);
+        }
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void StubSetOrigin(edict_t* e, float* origin)
+    {
+        e->v.origin = new Vector3(origin[0], origin[1], origin[2]);
+    }
+}
@@ -0,0 +1,44 @@
+namespace GoldsrcFramework.Engine.Native;
+
+/// <summary>
+/// Lump indices and limits from bspfile.h (BSPVERSION 30).
+/// </summary>
+public static class BspConstants
+{
+    public const int BSPVERSION = 30;
+    public const int MAX_MAP_HULLS = 4;
+
+    public const int LUMP_ENTITIES = 0;
+    public const int LUMP_PLANES = 1;
+    public const int LUMP_TEXTURES = 2;
+    public const int LUMP_VERTEXES = 3;
+    public const int LUMP_VISIBILITY = 4;
+    public const int LUMP_NODES = 5;
+    public const int LUMP_TEXINFO = 6;
+    public const int LUMP_FACES = 7;
+    public const int LUMP_LIGHTING = 8;
+    public const int LUMP_CLIPNODES = 9;
+    public const int LUMP_LEAFS = 10;
+    public const int LUMP_MARKSURFACES = 11;
+    public const int LUMP_EDGES = 12;
+    public const int LUMP_SURFEDGES = 13;
+    public const int LUMP_MODELS = 14;
+    public const int HEADER_LUMPS = 15;
+
+    public const int CONTENTS_EMPTY = -1;
+    public const int CONTENTS_SOLID = -2;
+    public const int CONTENTS_WATER = -3;
+    public const int CONTENTS_SLIME = -4;
+    public const int CONTENTS_LAVA = -5;
+    public const int CONTENTS_SKY = -6;
+    public const int CONTENTS_ORIGIN = -7;      // removed at csg time
+    public const int CONTENTS_CLIP = -8;        // changed to contents_solid
+    public const int CONTENTS_CURRENT_0 = -9;
+    public const int CONTENTS_CURRENT_90 = -10;
+    public const int CONTENTS_CURRENT_180 = -11;
+    public const int CONTENTS_CURRENT_270 = -12;
+    public const int CONTENTS_CURRENT_UP = -13;
+    public const int CONTENTS_CURRENT_DOWN = -14;
+    public const int CONTENTS_TRANSLUCENT = -15;
+    public const int CONTENTS_LADDER = -16;
+}
@@ -0,0 +1,14 @@
+using System.Runtime.InteropServices;
+using NativeInterop;
+
+namespace GoldsrcFramework.Engine.Native;
+
+/// <remarks>
+/// Original: typedef struct { int version; lump_t lumps[HEADER_LUMPS]; } dheader_t;
+/// </remarks>
+[StructLayout(LayoutKind.Sequential)]
+public struct dheader_t
+{
+    public int version;
+    public InlineArray15<lump_t> lumps;
+}
@@ -0,0 +1,25 @@
+using System.Runtime.InteropServices;
+using NativeInterop;
+
+namespace GoldsrcFramework.Engine.Native;
+
+/// <remarks>
+/// Original: typedef struct { int contents; int visofs; short mins[3]; short maxs[3]; unsigned short firstmarksurface; unsigned short nummarksurfaces; byte ambient_level[NUM_AMBIENTS]; } dleaf_t;
+/// </remarks>
+[StructLayout(LayoutKind.Sequential)]
+public struct dleaf_t
+{
+    public int contents;
+    /// <remarks>
+    /// -1 = no visibility info
+    /// </remarks>
+    public int visofs;
+    /// <remarks>
+    /// for frustum culling
+    /// </remarks>
+    public InlineArray3<short> mins;
+    public InlineArray3<short> maxs;
+    public ushort firstmarksurface;
+    public ushort nummarksurfaces;
+    public InlineArray4<byte> ambient_level;
+}
@@ -0,0 +1,27 @@
+using System.Runtime.InteropServices;
+using NativeInterop;
+
+namespace GoldsrcFramework.Engine.Native;
+
+/// <remarks>
+/// Original: typedef struct { int planenum; short children[2]; short mins[3]; short maxs[3]; unsigned short firstface; unsigned short numfaces; } dnode_t;
+/// </remarks>
+[StructLayout(LayoutKind.Sequential)]
+public struct dnode_t
+{
+    public int planenum;
+    /// <remarks>
+    /// negative numbers are -(leafs+1), not nodes
+    /// </remarks>
+    public InlineArray2<short> children;
+    /// <remarks>
+    /// for sphere culling
+    /// </remarks>
+    public InlineArray3<short> mins;
+    public InlineArray3<short> maxs;
+    public ushort firstface;
+    /// <remarks>
+    /// counting both sides
+    /// </remarks>
+    public ushort numfaces;
+}
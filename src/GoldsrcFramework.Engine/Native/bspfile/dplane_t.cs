@@ -0,0 +1,18 @@
+using System.Runtime.InteropServices;
+using GoldsrcFramework.LinearMath;
+
+namespace GoldsrcFramework.Engine.Native;
+
+/// <remarks>
+/// Original: typedef struct { float normal[3]; float dist; int type; } dplane_t;
+/// </remarks>
+[StructLayout(LayoutKind.Sequential)]
+public struct dplane_t
+{
+    public Vector3 normal;
+    public float dist;
+    /// <remarks>
+    /// PLANE_X - PLANE_ANYZ ?remove? trivial to regenerate
+    /// </remarks>
+    public int type;
+}
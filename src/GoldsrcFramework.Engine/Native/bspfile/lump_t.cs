@@ -0,0 +1,13 @@
+using System.Runtime.InteropServices;
+
+namespace GoldsrcFramework.Engine.Native;
+
+/// <remarks>
+/// Original: typedef struct { int fileofs, filelen; } lump_t;
+/// </remarks>
+[StructLayout(LayoutKind.Sequential)]
+public struct lump_t
+{
+    public int fileofs;
+    public int filelen;
+}
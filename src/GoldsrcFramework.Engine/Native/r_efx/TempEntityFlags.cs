@@ -0,0 +1,32 @@
+namespace GoldsrcFramework.Engine.Native;
+
+/// <summary>
+/// TEMPENTITY::flags values.
+/// Original: #define FTENT_* in r_efx.h
+/// </summary>
+[Flags]
+public enum TempEntityFlags
+{
+    FTENT_NONE = 0x00000000,
+    FTENT_SINEWAVE = 0x00000001,
+    FTENT_GRAVITY = 0x00000002,
+    FTENT_ROTATE = 0x00000004,
+    FTENT_SLOWGRAVITY = 0x00000008,
+    FTENT_SMOKETRAIL = 0x00000010,
+    FTENT_COLLIDEWORLD = 0x00000020,
+    FTENT_FLICKER = 0x00000040,
+    FTENT_FADEOUT = 0x00000080,
+    FTENT_SPRANIMATE = 0x00000100,
+    FTENT_HITSOUND = 0x00000200,
+    FTENT_SPIRAL = 0x00000400,
+    FTENT_SPRCYCLE = 0x00000800,
+    FTENT_COLLIDEALL = 0x00001000,      // will collide with world and slideboxes
+    FTENT_PERSIST = 0x00002000,         // tent is not removed when unable to draw
+    FTENT_COLLIDEKILL = 0x00004000,     // tent is removed upon collision with anything
+    FTENT_PLYRATTACHMENT = 0x00008000,  // tent is attached to a player (owner)
+    FTENT_SPRANIMATELOOP = 0x00010000,  // animating sprite doesn't die when last frame is displayed
+    FTENT_SPARKSHOWER = 0x00020000,
+    FTENT_NOMODEL = 0x00040000,         // Doesn't have a model, never try to draw ( it just triggers other things )
+    FTENT_CLIENTCUSTOM = 0x00080000,    // Must specify callback. Callback function is responsible for killing tempent and updating fields
+    FTENT_SCALE = 0x00100000            // An experiment
+}
@@ -1,4 +1,6 @@
 #include<string>
+#include<cstring>
+#include<cstdint>
 #include<nethost.h>
 #include<coreclr_delegates.h>
 #include<hostfxr.h>
@@ -469,3 +471,309 @@ int GetNewDLLFunctions(void* pFunctionTable, int* interfaceVersion)
 }
 
 #pragma endregion
+
+#pragma region Message replay
+// Replays a GoldsrcFramework.Messages.MessageWriter op-stream into the engine's pfnMessageBegin/pfnWrite*/pfnMessageEnd,
+// so a whole batch of user messages costs one managed-to-native transition.
+// Opcodes and layout must match MessageOp.cs.
+
+enum MessageStreamOp : unsigned char
+{
+	MSG_OP_BEGIN = 1,
+	MSG_OP_END = 2,
+	MSG_OP_BYTE = 3,
+	MSG_OP_CHAR = 4,
+	MSG_OP_SHORT = 5,
+	MSG_OP_LONG = 6,
+	MSG_OP_ANGLE = 7,
+	MSG_OP_COORD = 8,
+	MSG_OP_STRING = 9,
+	MSG_OP_ENTITY = 10,
+};
+
+// Leading part of enginefuncs_t, up to pfnWriteEntity
+struct MessageEngineFuncs
+{
+	void* _unused[46];	// pfnPrecacheModel .. pfnPointContents
+	void (__cdecl* pfnMessageBegin)(int msg_dest, int msg_type, const float* pOrigin, void* ed);
+	void (__cdecl* pfnMessageEnd)();
+	void (__cdecl* pfnWriteByte)(int iValue);
+	void (__cdecl* pfnWriteChar)(int iValue);
+	void (__cdecl* pfnWriteShort)(int iValue);
+	void (__cdecl* pfnWriteLong)(int iValue);
+	void (__cdecl* pfnWriteAngle)(float flValue);
+	void (__cdecl* pfnWriteCoord)(float flValue);
+	void (__cdecl* pfnWriteString)(const char* sz);
+	void (__cdecl* pfnWriteEntity)(int iValue);
+};
+
+template<typename T>
+static inline T ReadStream(const unsigned char* p)
+{
+	T value;
+	memcpy(&value, p, sizeof(T));
+	return value;
+}
+
+// Returns the number of ops, or -1 if the stream is truncated, has an unknown op or an unterminated string, nests
+// a Begin, writes or ends outside a message, or leaves a message open. Same rules as MessageReplay.Validate.
+static int ValidateMessageStream(const unsigned char* stream, int length)
+{
+	const unsigned char* p = stream;
+	const unsigned char* end = stream + length;
+	bool open = false;
+	int ops = 0;
+
+	while (p < end)
+	{
+		unsigned char op = *p++;
+		ptrdiff_t size;
+		switch (op)
+		{
+		case MSG_OP_BEGIN:
+			if (open)
+				return -1;
+			open = true;
+			size = 29;
+			break;
+		case MSG_OP_END:
+			if (!open)
+				return -1;
+			open = false;
+			size = 0;
+			break;
+		case MSG_OP_BYTE:
+		case MSG_OP_CHAR:
+		case MSG_OP_SHORT:
+		case MSG_OP_LONG:
+		case MSG_OP_ENTITY:
+		case MSG_OP_ANGLE:
+		case MSG_OP_COORD:
+			size = 4;
+			break;
+		case MSG_OP_STRING:
+		{
+			const unsigned char* terminator = (const unsigned char*)memchr(p, 0, end - p);
+			if (terminator == nullptr)
+				return -1;
+			size = terminator + 1 - p;
+			break;
+		}
+		default:
+			return -1;
+		}
+		if (op != MSG_OP_BEGIN && op != MSG_OP_END && !open)
+			return -1;
+		if (end - p < size)
+			return -1;
+		p += size;
+		ops++;
+	}
+
+	return open ? -1 : ops;
+}
+
+// Returns the number of ops replayed, or -1 if the stream is malformed. The stream is validated before the first
+// engine call, so a bad one never leaves a MessageBegin without its MessageEnd.
+extern "C" __declspec(dllexport) int __cdecl ReplayMessageStream(void* pengfuncs, const unsigned char* stream, int length)
+{
+	if (ValidateMessageStream(stream, length) < 0)
+		return -1;
+
+	const MessageEngineFuncs* eng = (const MessageEngineFuncs*)pengfuncs;
+	const unsigned char* p = stream;
+	const unsigned char* end = stream + length;
+	int ops = 0;
+
+	while (p < end)
+	{
+		unsigned char op = *p++;
+		switch (op)
+		{
+		case MSG_OP_BEGIN:
+		{
+			if (end - p < 29)
+				return -1;
+			float origin[3];
+			memcpy(origin, p + 9, sizeof(origin));
+			void* ed = (void*)(uintptr_t)ReadStream<unsigned long long>(p + 21);
+			eng->pfnMessageBegin(ReadStream<int>(p), ReadStream<int>(p + 4), p[8] ? origin : nullptr, ed);
+			p += 29;
+			break;
+		}
+		case MSG_OP_END:
+			eng->pfnMessageEnd();
+			break;
+		case MSG_OP_BYTE:
+		case MSG_OP_CHAR:
+		case MSG_OP_SHORT:
+		case MSG_OP_LONG:
+		case MSG_OP_ENTITY:
+		{
+			if (end - p < 4)
+				return -1;
+			int value = ReadStream<int>(p);
+			p += 4;
+			switch (op)
+			{
+			case MSG_OP_BYTE: eng->pfnWriteByte(value); break;
+			case MSG_OP_CHAR: eng->pfnWriteChar(value); break;
+			case MSG_OP_SHORT: eng->pfnWriteShort(value); break;
+			case MSG_OP_LONG: eng->pfnWriteLong(value); break;
+			default: eng->pfnWriteEntity(value); break;
+			}
+			break;
+		}
+		case MSG_OP_ANGLE:
+		case MSG_OP_COORD:
+		{
+			if (end - p < 4)
+				return -1;
+			float value = ReadStream<float>(p);
+			p += 4;
+			if (op == MSG_OP_ANGLE)
+				eng->pfnWriteAngle(value);
+			else
+				eng->pfnWriteCoord(value);
+			break;
+		}
+		case MSG_OP_STRING:
+		{
+			const unsigned char* terminator = (const unsigned char*)memchr(p, 0, end - p);
+			if (terminator == nullptr)
+				return -1;
+			eng->pfnWriteString((const char*)p);
+			p = terminator + 1;
+			break;
+		}
+		default:
+			return -1;
+		}
+		ops++;
+	}
+
+	return ops;
+}
+
+#pragma endregion
+
+#pragma region Triangle replay
+// Replays a GoldsrcFramework.Graphics.TriangleBatcher op-stream into the client's triangleapi_t,
+// so a frame of batched TriAPI geometry costs one managed-to-native transition.
+// Opcodes and layout must match TriangleOp.cs.
+
+enum TriangleStreamOp : unsigned char
+{
+	TRI_OP_RENDERMODE = 1,
+	TRI_OP_BEGIN = 2,
+	TRI_OP_END = 3,
+	TRI_OP_TEXTURE = 4,
+	TRI_OP_COLOR = 5,
+	TRI_OP_VERTEX = 6,
+	TRI_OP_CULLFACE = 7,
+	TRI_OP_TEXCOORD = 8,
+};
+
+// Leading part of triangleapi_t, up to SpriteTexture
+struct TriangleApiFuncs
+{
+	int version;
+	void (__cdecl* RenderMode)(int mode);
+	void (__cdecl* Begin)(int primitiveCode);
+	void (__cdecl* End)();
+	void (__cdecl* Color4f)(float r, float g, float b, float a);
+	void (__cdecl* Color4ub)(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+	void (__cdecl* TexCoord2f)(float u, float v);
+	void (__cdecl* Vertex3fv)(const float* worldPnt);
+	void (__cdecl* Vertex3f)(float x, float y, float z);
+	void (__cdecl* Brightness)(float brightness);
+	void (__cdecl* CullFace)(int style);
+	int (__cdecl* SpriteTexture)(void* pSpriteModel, int frame);
+};
+
+// Returns the number of TriAPI calls made, or -1 if the stream is malformed
+extern "C" __declspec(dllexport) int __cdecl ReplayTriangleStream(void* ptriapi, const unsigned char* stream, int length)
+{
+	const TriangleApiFuncs* tri = (const TriangleApiFuncs*)ptriapi;
+	const unsigned char* p = stream;
+	const unsigned char* end = stream + length;
+	int calls = 0;
+
+	while (p < end)
+	{
+		unsigned char op = *p++;
+		switch (op)
+		{
+		case TRI_OP_RENDERMODE:
+		case TRI_OP_BEGIN:
+		case TRI_OP_CULLFACE:
+		{
+			if (end - p < 4)
+				return -1;
+			int value = ReadStream<int>(p);
+			p += 4;
+			switch (op)
+			{
+			case TRI_OP_RENDERMODE: tri->RenderMode(value); break;
+			case TRI_OP_BEGIN: tri->Begin(value); break;
+			default: tri->CullFace(value); break;
+			}
+			calls++;
+			break;
+		}
+		case TRI_OP_END:
+			tri->End();
+			calls++;
+			break;
+		case TRI_OP_TEXTURE:
+		{
+			if (end - p < 12)
+				return -1;
+			void* model = (void*)(uintptr_t)ReadStream<unsigned long long>(p);
+			tri->SpriteTexture(model, ReadStream<int>(p + 8));
+			p += 12;
+			calls++;
+			break;
+		}
+		case TRI_OP_COLOR:
+		{
+			if (end - p < 16)
+				return -1;
+			float c[4];
+			memcpy(c, p, sizeof(c));
+			tri->Color4f(c[0], c[1], c[2], c[3]);
+			p += 16;
+			calls++;
+			break;
+		}
+		case TRI_OP_TEXCOORD:
+		{
+			if (end - p < 8)
+				return -1;
+			float t[2];
+			memcpy(t, p, sizeof(t));
+			tri->TexCoord2f(t[0], t[1]);
+			p += 8;
+			calls++;
+			break;
+		}
+		case TRI_OP_VERTEX:
+		{
+			if (end - p < 12)
+				return -1;
+			float v[3];
+			memcpy(v, p, sizeof(v));
+			tri->Vertex3f(v[0], v[1], v[2]);
+			p += 12;
+			calls++;
+			break;
+		}
+		default:
+			return -1;
+		}
+	}
+
+	return calls;
+}
+
+#pragma endregion
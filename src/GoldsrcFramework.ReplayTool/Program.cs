@@ -0,0 +1,153 @@
+﻿using System.Globalization;
+using GoldsrcFramework.DependencyInjection;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Replay;
+
+namespace GoldsrcFramework.ReplayTool
+{
+    /// <summary>
+    /// Replays a trace recorded with Framework:CaptureTracePath against the mod's exports and a mock engine, and
+    /// reports per-call timing and divergences.
+    /// </summary>
+    internal class Program
+    {
+        static int Main(string[] args)
+        {
+            string? tracePath = null;
+            string? configPath = null;
+            string? csvPath = null;
+            string? saveDigests = null;
+            string? compareDigests = null;
+            var options = new TraceReplayOptions();
+            bool server = true, client = true;
+
+            for (int i = 0; i < args.Length; i++)
+            {
+                switch (args[i])
+                {
+                    case "--config" when i + 1 < args.Length: configPath = args[++i]; break;
+                    case "--iterations" when i + 1 < args.Length:
+                        if (!int.TryParse(args[++i], NumberStyles.Integer, CultureInfo.InvariantCulture, out int iterations) || iterations < 1)
+                        {
+                            ShowUsage();
+                            return 1;
+                        }
+                        options.Iterations = iterations;
+                        break;
+                    case "--game" when i + 1 < args.Length: options.GameDirectory = args[++i]; break;
+                    case "--csv" when i + 1 < args.Length: csvPath = args[++i]; break;
+                    case "--save-digests" when i + 1 < args.Length: saveDigests = args[++i]; break;
+                    case "--compare-digests" when i + 1 < args.Length: compareDigests = args[++i]; break;
+                    case "--nested": options.IncludeNested = true; break;
+                    case "--legacy-server": options.StubLegacyServer = false; break;
+                    case "--server-only": client = false; break;
+                    case "--client-only": server = false; break;
+                    default:
+                        if (args[i].StartsWith("--", StringComparison.Ordinal) || tracePath != null)
+                        {
+                            ShowUsage();
+                            return 1;
+                        }
+                        tracePath = args[i];
+                        break;
+                }
+            }
+
+            if (tracePath == null)
+            {
+                ShowUsage();
+                return 1;
+            }
+
+            try
+            {
+                if (compareDigests != null)
+                    options.Baseline = ReadDigests(compareDigests);
+
+                ServiceContainer.Initialize(configPath);
+                var replayer = new TraceReplayer(
+                    server ? ServiceContainer.GetService<IServerExportFuncs>() : null,
+                    client ? ServiceContainer.GetService<IClientExportFuncs>() : null,
+                    options);
+
+                using var trace = TraceReader.Open(tracePath);
+                if (trace.Truncated)
+                    Console.WriteLine("Warning: the trace ends in a partial record; replaying up to it.");
+
+                var report = replayer.Replay(trace);
+                Print(report, options.Baseline != null);
+
+                if (csvPath != null)
+                    WriteCsv(csvPath, report);
+                if (saveDigests != null)
+                    WriteDigests(saveDigests, report.Digests);
+
+                return report.Failed > 0 || report.BaselineDivergent > 0 ? 2 : 0;
+            }
+            catch (Exception ex) when (ex is IOException or InvalidDataException or UnauthorizedAccessException)
+            {
+                Console.Error.WriteLine($"Error: {ex.Message}");
+                return 1;
+            }
+        }
+
+        private static void Print(TraceReplayReport report, bool baseline)
+        {
+            Console.WriteLine($"{report.Calls} calls recorded, {report.Replayed} replayed x{report.Iterations}, {report.Skipped} skipped, " +
+                              $"{report.Failed} failed, {report.Divergent} diverged from the recording" +
+                              (baseline ? $", {report.BaselineDivergent} from the baseline" : ""));
+            Console.WriteLine($"Recorded {report.RecordedMilliseconds:F1} ms in calls, replay {report.ReplayMilliseconds:F1} ms per pass");
+            if (report.FirstFailure != null)
+                Console.WriteLine($"First failure: {report.FirstFailure}");
+            Console.WriteLine();
+
+            Console.WriteLine($"{"Call",-28} {"Recorded",9} {"Replayed",9} {"Diverged",9} {"Failed",7} {"rec us",9} {"mean us",9} {"p50 us",9} {"p99 us",9}");
+            foreach (var s in report.PerCall.OrderByDescending(s => s.ReplayMeanMicroseconds * s.Replayed))
+            {
+                Console.WriteLine($"{s.Call,-28} {s.Recorded,9} {s.Replayed,9} {(baseline ? s.BaselineDivergent : s.Divergent),9} {s.Failed,7} " +
+                                  $"{s.RecordedMeanMicroseconds,9:F2} {s.ReplayMeanMicroseconds,9:F2} {s.ReplayP50Microseconds,9:F2} {s.ReplayP99Microseconds,9:F2}");
+            }
+        }
+
+        private static void WriteCsv(string path, TraceReplayReport report)
+        {
+            using var writer = new StreamWriter(path);
+            writer.WriteLine("call,recorded,replayed,divergent,baseline_divergent,failed,recorded_mean_us,replay_mean_us,replay_p50_us,replay_p99_us");
+            foreach (var s in report.PerCall)
+            {
+                writer.WriteLine(string.Create(CultureInfo.InvariantCulture,
+                    $"{s.Call},{s.Recorded},{s.Replayed},{s.Divergent},{s.BaselineDivergent},{s.Failed},{s.RecordedMeanMicroseconds:F3},{s.ReplayMeanMicroseconds:F3},{s.ReplayP50Microseconds:F3},{s.ReplayP99Microseconds:F3}"));
+            }
+        }
+
+        private static void WriteDigests(string path, ulong[] digests)
+        {
+            using var writer = new BinaryWriter(File.Create(path));
+            foreach (var digest in digests)
+                writer.Write(digest);
+        }
+
+        private static ulong[] ReadDigests(string path)
+        {
+            var bytes = File.ReadAllBytes(path);
+            var digests = new ulong[bytes.Length / sizeof(ulong)];
+            Buffer.BlockCopy(bytes, 0, digests, 0, digests.Length * sizeof(ulong));
+            return digests;
+        }
+
+        private static void ShowUsage()
+        {
+            Console.WriteLine("Usage: GoldsrcFramework.ReplayTool <trace> [options]");
+            Console.WriteLine();
+            Console.WriteLine("  --config <modSettings.json>   Extra configuration (mod assemblies) on top of the framework's");
+            Console.WriteLine("  --iterations <n>              Replay the trace n times (default 1)");
+            Console.WriteLine("  --game <dir>                  Game directory reported to the mod (default valve)");
+            Console.WriteLine("  --nested                      Also replay calls made from inside other calls");
+            Console.WriteLine("  --legacy-server               Load libserver instead of stubbing the legacy server DLL");
+            Console.WriteLine("  --server-only | --client-only Replay one side only");
+            Console.WriteLine("  --csv <file>                  Write per-call statistics as CSV");
+            Console.WriteLine("  --save-digests <file>         Save the digest of every replayed call");
+            Console.WriteLine("  --compare-digests <file>      Compare with digests saved from a known-good build");
+        }
+    }
+}
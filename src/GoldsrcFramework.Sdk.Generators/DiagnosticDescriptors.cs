@@ -0,0 +1,32 @@
+using Microsoft.CodeAnalysis;
+
+namespace GoldsrcFramework.Sdk.Generators;
+
+internal static class DiagnosticDescriptors
+{
+    private const string Category = "GoldsrcFramework";
+
+    public static readonly DiagnosticDescriptor MultipleImplementations = new(
+        "GSF001",
+        "More than one implementation found",
+        "'{0}' and '{1}' both implement {2}; the generated registration uses '{0}'",
+        Category, DiagnosticSeverity.Warning, isEnabledByDefault: true);
+
+    public static readonly DiagnosticDescriptor NoDefaultConstructor = new(
+        "GSF002",
+        "No public parameterless constructor",
+        "'{0}' implements {1} but has no public parameterless constructor, so it cannot be created at startup",
+        Category, DiagnosticSeverity.Warning, isEnabledByDefault: true);
+
+    public static readonly DiagnosticDescriptor UnsupportedSettingsProperty = new(
+        "GSF003",
+        "Settings property is not bound",
+        "Property '{0}.{1}' of type '{2}' is not bound from configuration; use a string, bool, number, enum, Dictionary<string, string>, List<string>, string[] or a class",
+        Category, DiagnosticSeverity.Warning, isEnabledByDefault: true);
+
+    public static readonly DiagnosticDescriptor ExportWrapperNotPartial = new(
+        "GSF004",
+        "Export wrapper is not a partial top-level class",
+        "'{0}' is marked [ExportWrapper] but is not a non-generic, top-level partial class, so its members cannot be generated",
+        Category, DiagnosticSeverity.Error, isEnabledByDefault: true);
+}
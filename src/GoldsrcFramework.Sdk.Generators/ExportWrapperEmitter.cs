@@ -0,0 +1,201 @@
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+
+namespace GoldsrcFramework.Sdk.Generators;
+
+/// <summary>
+/// Describes [ExportWrapper] classes and writes the interface members they do not declare themselves, each one a
+/// call to <c>inner</c> with the profiler or trace capture around it. The generated members follow the hand-written
+/// ones they replace, so a wrapper only spells out the calls that need something else.
+/// </summary>
+internal static class ExportWrapperEmitter
+{
+    public const string AttributeName = "GoldsrcFramework.Replay.ExportWrapperAttribute";
+
+    private const string TraceCall = "global::GoldsrcFramework.Replay.TraceCall";
+
+    private static readonly SymbolDisplayFormat s_typeFormat = SymbolDisplayFormat.FullyQualifiedFormat
+        .WithMiscellaneousOptions(SymbolDisplayMiscellaneousOptions.UseSpecialTypes | SymbolDisplayMiscellaneousOptions.EscapeKeywordIdentifiers);
+
+    public static ExportWrapper Describe(GeneratorAttributeSyntaxContext context, CancellationToken cancellationToken)
+    {
+        var type = (INamedTypeSymbol)context.TargetSymbol;
+        var kind = context.Attributes[0].ConstructorArguments.FirstOrDefault().Value is int value ? (ExportWrapperKind)value : ExportWrapperKind.Profiling;
+        string ns = type.ContainingNamespace.IsGlobalNamespace ? "" : type.ContainingNamespace.ToDisplayString();
+
+        var diagnostics = new List<DiagnosticInfo>();
+        bool partial = type.DeclaringSyntaxReferences.All(r => r.GetSyntax(cancellationToken) is ClassDeclarationSyntax c &&
+                                                                c.Modifiers.Any(SyntaxKind.PartialKeyword));
+        if (!partial || type.ContainingType != null || type.IsGenericType)
+        {
+            diagnostics.Add(DiagnosticInfo.Create(DiagnosticDescriptors.ExportWrapperNotPartial, type.Locations.FirstOrDefault(), type.Name));
+            return new ExportWrapper(ns, type.Name, kind, default, new(diagnostics.ToImmutableArray()));
+        }
+
+        var members = new List<ExportMember>();
+        foreach (var i in type.Interfaces)
+        {
+            foreach (var method in i.GetMembers().OfType<IMethodSymbol>())
+            {
+                cancellationToken.ThrowIfCancellationRequested();
+                if (method.MethodKind != MethodKind.Ordinary || method.IsStatic || type.FindImplementationForInterfaceMember(method) != null)
+                    continue;
+
+                var parameters = method.Parameters.Select(p => new ExportParameter(
+                    Identifier(p.Name), RefKind(p.RefKind) + p.Type.ToDisplayString(s_typeFormat), RefKind(p.RefKind), TraceArgument(p.Type)));
+                members.Add(new ExportMember(method.Name, method.ReturnType.ToDisplayString(s_typeFormat), TraceResult(method.ReturnType),
+                                             new(parameters.ToImmutableArray())));
+            }
+        }
+        return new ExportWrapper(ns, type.Name, kind, new(members.ToImmutableArray()), new(diagnostics.ToImmutableArray()));
+    }
+
+    // What TraceCallScope records for a parameter; pointers to anything but edicts and strings are left out.
+    private static TraceArgumentKind TraceArgument(ITypeSymbol type)
+    {
+        switch (type.SpecialType)
+        {
+            case SpecialType.System_Int32: return TraceArgumentKind.Int;
+            case SpecialType.System_UInt32: return TraceArgumentKind.UInt;
+            case SpecialType.System_Single: return TraceArgumentKind.Float;
+            case SpecialType.System_Double: return TraceArgumentKind.Double;
+        }
+        if (type.Name == "qboolean")
+            return TraceArgumentKind.QBoolean;
+        if (type is IPointerTypeSymbol pointer)
+        {
+            switch (pointer.PointedAtType.Name)
+            {
+                case "edict_t": return TraceArgumentKind.Edict;
+                case "NChar": return TraceArgumentKind.Text;
+            }
+        }
+        return TraceArgumentKind.None;
+    }
+
+    private static TraceResultKind TraceResult(ITypeSymbol type)
+    {
+        if (type.SpecialType == SpecialType.System_Void)
+            return TraceResultKind.Void;
+        if (type.SpecialType == SpecialType.System_Int32)
+            return TraceResultKind.Int;
+        if (type.Name == "qboolean")
+            return TraceResultKind.QBoolean;
+        if (type.Name == "NChar")
+            return TraceResultKind.Char;
+        if (type is IPointerTypeSymbol { PointedAtType.Name: "NChar" })
+            return TraceResultKind.Text;
+        return TraceResultKind.Other;
+    }
+
+    public static string Emit(ExportWrapper wrapper)
+    {
+        var sb = new StringBuilder();
+        sb.AppendLine("// <auto-generated/>");
+        sb.AppendLine("#nullable enable");
+        sb.AppendLine();
+        string indent = "";
+        if (wrapper.Namespace.Length > 0)
+        {
+            sb.AppendLine($"namespace {wrapper.Namespace}");
+            sb.AppendLine("{");
+            indent = "    ";
+        }
+        sb.AppendLine($"{indent}[global::System.CodeDom.Compiler.GeneratedCode(\"GoldsrcFramework.Sdk.Generators\", \"1.0\")]");
+        sb.AppendLine($"{indent}unsafe partial class {wrapper.Name}");
+        sb.AppendLine($"{indent}{{");
+        for (int i = 0; i < wrapper.Members.Length; i++)
+        {
+            if (i > 0)
+                sb.AppendLine();
+            var m = wrapper.Members[i];
+            string parameters = string.Join(", ", m.Parameters.Select(p => $"{p.Type} {p.Name}"));
+            string forward = $"inner.{m.Name}({string.Join(", ", m.Parameters.Select(p => p.RefKind + p.Name))})";
+
+            sb.AppendLine($"{indent}    public {m.ReturnType} {m.Name}({parameters})");
+            sb.AppendLine($"{indent}    {{");
+            var body = wrapper.Kind == ExportWrapperKind.Recording ? Recording(m, forward) : Profiling(m, forward);
+            foreach (var line in body)
+                sb.AppendLine($"{indent}        {line}".TrimEnd());
+            sb.AppendLine($"{indent}    }}");
+        }
+        sb.AppendLine($"{indent}}}");
+        if (indent.Length > 0)
+            sb.AppendLine("}");
+        return sb.ToString();
+    }
+
+    private static IEnumerable<string> Profiling(ExportMember m, string forward)
+    {
+        yield return $"var previous = profiler.Enter({TraceCall}.{m.Name});";
+        yield return "try";
+        yield return "{";
+        yield return m.Result == TraceResultKind.Void ? $"    {forward};" : $"    return {forward};";
+        yield return "}";
+        yield return "finally";
+        yield return "{";
+        yield return "    profiler.Exit(previous);";
+        yield return "}";
+    }
+
+    private static IEnumerable<string> Recording(ExportMember m, string forward)
+    {
+        var begin = new StringBuilder($"var call = global::GoldsrcFramework.Replay.TraceCapture.Begin({TraceCall}.{m.Name})");
+        foreach (var p in m.Parameters)
+        {
+            switch (p.Trace)
+            {
+                case TraceArgumentKind.Edict: begin.Append($".Edict({p.Name})"); break;
+                case TraceArgumentKind.Text: begin.Append($".Text({p.Name})"); break;
+                case TraceArgumentKind.Int: begin.Append($".Int({p.Name})"); break;
+                case TraceArgumentKind.UInt: begin.Append($".Int((int){p.Name})"); break;
+                case TraceArgumentKind.Float: begin.Append($".Float({p.Name})"); break;
+                case TraceArgumentKind.Double: begin.Append($".Double({p.Name})"); break;
+                case TraceArgumentKind.QBoolean: begin.Append($".Int({p.Name}.Value)"); break;
+            }
+        }
+        yield return begin.Append(';').ToString();
+
+        switch (m.Result)
+        {
+            case TraceResultKind.Void:
+                yield return $"{forward};";
+                yield return "call.End();";
+                break;
+            case TraceResultKind.Int:
+            case TraceResultKind.Text:
+                yield return $"return call.End({forward});";
+                break;
+            case TraceResultKind.Char:
+                yield return $"return (byte)call.End((byte){forward});";
+                break;
+            case TraceResultKind.QBoolean:
+                yield return $"var result = {forward};";
+                yield return "call.End(result.Value);";
+                yield return "return result;";
+                break;
+            default:
+                // Pointers into the engine or the mod mean nothing in another process.
+                yield return $"var result = {forward};";
+                yield return "call.End();";
+                yield return "return result;";
+                break;
+        }
+    }
+
+    private static string RefKind(RefKind kind) => kind switch
+    {
+        Microsoft.CodeAnalysis.RefKind.Ref => "ref ",
+        Microsoft.CodeAnalysis.RefKind.Out => "out ",
+        Microsoft.CodeAnalysis.RefKind.In => "in ",
+        _ => "",
+    };
+
+    private static string Identifier(string name) => SyntaxFacts.GetKeywordKind(name) != SyntaxKind.None ? "@" + name : name;
+}
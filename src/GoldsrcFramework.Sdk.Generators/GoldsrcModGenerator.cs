@@ -0,0 +1,190 @@
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+using Microsoft.CodeAnalysis.Text;
+
+namespace GoldsrcFramework.Sdk.Generators;
+
+/// <summary>
+/// Does at compile time what ServiceContainer otherwise does with reflection at boot:
+/// <list type="bullet">
+/// <item>finds the mod's <c>IGoldsrcModStartup</c> class and its <c>IServerExportFuncs</c> / <c>IClientExportFuncs</c>
+/// implementations and emits <c>GoldsrcModRegistration</c>, which creates them with <c>new</c> and registers itself
+/// with <c>GoldsrcModRegistry</c> from a module initializer;</item>
+/// <item>emits <c>GoldsrcSettingsBinder</c> for every class marked <c>[GoldsrcSettings]</c>, so modSettings.json
+/// sections are bound without ConfigurationBinder.</item>
+/// </list>
+/// The framework assembly itself gets no registration. It also gets the interface members its <c>[ExportWrapper]</c>
+/// classes (the profiling and recording exports) do not declare themselves.
+/// </summary>
+[Generator(LanguageNames.CSharp)]
+public sealed class GoldsrcModGenerator : IIncrementalGenerator
+{
+    private const string FrameworkAssembly = "GoldsrcFramework";
+    private const string RegistrationInterface = "GoldsrcFramework.IGoldsrcModRegistration";
+    private const string StartupInterface = "GoldsrcFramework.IGoldsrcModStartup";
+    private const string ServerInterface = "GoldsrcFramework.Engine.Native.IServerExportFuncs";
+    private const string ClientInterface = "GoldsrcFramework.Engine.Native.IClientExportFuncs";
+
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        var settings = context.SyntaxProvider.ForAttributeWithMetadataName(
+                SettingsBinderEmitter.AttributeName,
+                static (node, _) => node is ClassDeclarationSyntax,
+                static (ctx, ct) =>
+                {
+                    var type = (INamedTypeSymbol)ctx.TargetSymbol;
+                    var section = ctx.Attributes[0].ConstructorArguments.FirstOrDefault().Value as string;
+                    return SettingsBinderEmitter.Describe(type, string.IsNullOrEmpty(section) ? type.Name : section!, ct);
+                })
+            .Collect();
+
+        var wrappers = context.SyntaxProvider.ForAttributeWithMetadataName(
+            ExportWrapperEmitter.AttributeName,
+            static (node, _) => node is ClassDeclarationSyntax,
+            static (ctx, ct) => ExportWrapperEmitter.Describe(ctx, ct));
+
+        var candidates = context.SyntaxProvider.CreateSyntaxProvider(
+                static (node, _) => node is ClassDeclarationSyntax { BaseList: not null } c &&
+                                    !c.Modifiers.Any(SyntaxKind.AbstractKeyword) && !c.Modifiers.Any(SyntaxKind.StaticKeyword),
+                static (ctx, ct) => Candidate(ctx, ct))
+            .Where(static c => c != null)
+            .Collect();
+
+        var target = context.CompilationProvider.Select(static (c, _) =>
+            (Assembly: c.AssemblyName ?? "", Registration: c.GetTypeByMetadataName(RegistrationInterface) != null));
+
+        context.RegisterSourceOutput(settings, static (spc, roots) =>
+        {
+            foreach (var root in roots)
+            {
+                foreach (var diagnostic in root.Diagnostics)
+                    spc.ReportDiagnostic(diagnostic.ToDiagnostic());
+            }
+            if (roots.Length > 0)
+                spc.AddSource("GoldsrcSettingsBinder.g.cs", SourceText.From(SettingsBinderEmitter.Emit(roots), Encoding.UTF8));
+        });
+
+        context.RegisterSourceOutput(wrappers, static (spc, wrapper) =>
+        {
+            foreach (var diagnostic in wrapper.Diagnostics)
+                spc.ReportDiagnostic(diagnostic.ToDiagnostic());
+            if (wrapper.Diagnostics.Length == 0)
+                spc.AddSource($"{wrapper.Namespace}.{wrapper.Name}.g.cs", SourceText.From(ExportWrapperEmitter.Emit(wrapper), Encoding.UTF8));
+        });
+
+        context.RegisterSourceOutput(candidates.Combine(settings).Combine(target), static (spc, input) =>
+        {
+            var ((types, roots), (assembly, registration)) = input;
+            if (assembly == FrameworkAssembly || !registration)
+                return;
+            spc.AddSource("GoldsrcModRegistration.g.cs", SourceText.From(EmitRegistration(spc, types!, roots.Length > 0), Encoding.UTF8));
+        });
+    }
+
+    private static ModTypeCandidate? Candidate(GeneratorSyntaxContext context, CancellationToken cancellationToken)
+    {
+        if (context.SemanticModel.GetDeclaredSymbol(context.Node, cancellationToken) is not INamedTypeSymbol type ||
+            type.IsAbstract || type.IsStatic || type.IsGenericType || !Reachable(type))
+        {
+            return null;
+        }
+
+        bool startup = false, server = false, client = false;
+        foreach (var i in type.AllInterfaces)
+        {
+            switch (i.ToDisplayString())
+            {
+                case StartupInterface: startup = true; break;
+                case ServerInterface: server = true; break;
+                case ClientInterface: client = true; break;
+            }
+        }
+        if (!startup && !server && !client)
+            return null;
+
+        bool defaultConstructor = type.InstanceConstructors.Any(c => c.Parameters.Length == 0 &&
+            c.DeclaredAccessibility is Accessibility.Public or Accessibility.Internal);
+        return new ModTypeCandidate(type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat), startup, server, client,
+                                    defaultConstructor, LocationInfo.From(type.Locations.FirstOrDefault()));
+    }
+
+    // Generated code lives in the same assembly, so anything but private / protected nesting is reachable.
+    private static bool Reachable(INamedTypeSymbol type)
+    {
+        for (ISymbol? s = type; s is INamedTypeSymbol t; s = t.ContainingType)
+        {
+            if (t.DeclaredAccessibility is not (Accessibility.Public or Accessibility.Internal or Accessibility.ProtectedOrInternal))
+                return false;
+        }
+        return true;
+    }
+
+    private static string EmitRegistration(SourceProductionContext context, ImmutableArray<ModTypeCandidate?> types, bool settings)
+    {
+        // Partial classes show up once per declaration.
+        var distinct = types.Where(t => t != null).GroupBy(t => t!.TypeName).Select(g => g.First()!).ToList();
+        var startup = Pick(context, distinct.Where(t => t.IsStartup).ToList(), StartupInterface);
+        var server = Pick(context, distinct.Where(t => t.IsServer).ToList(), ServerInterface);
+        var client = Pick(context, distinct.Where(t => t.IsClient).ToList(), ClientInterface);
+
+        var sb = new StringBuilder();
+        sb.AppendLine("// <auto-generated/>");
+        sb.AppendLine("#nullable enable");
+        sb.AppendLine("#pragma warning disable CA2255");
+        sb.AppendLine();
+        sb.AppendLine("namespace GoldsrcFramework.Generated");
+        sb.AppendLine("{");
+        sb.AppendLine("    /// <summary>");
+        sb.AppendLine("    /// Startup class and export implementations of this assembly, found at compile time. Registers itself with");
+        sb.AppendLine("    /// GoldsrcModRegistry when the module is initialized, so the framework never scans the assembly.");
+        sb.AppendLine("    /// </summary>");
+        sb.AppendLine("    [global::System.CodeDom.Compiler.GeneratedCode(\"GoldsrcFramework.Sdk.Generators\", \"1.0\")]");
+        sb.AppendLine("    internal sealed class GoldsrcModRegistration : global::GoldsrcFramework.IGoldsrcModRegistration");
+        sb.AppendLine("    {");
+        sb.AppendLine("        [global::System.Runtime.CompilerServices.ModuleInitializer]");
+        sb.AppendLine("        internal static void Register() => global::GoldsrcFramework.GoldsrcModRegistry.Register(new GoldsrcModRegistration());");
+        sb.AppendLine();
+        sb.AppendLine($"        public global::GoldsrcFramework.IGoldsrcModStartup? CreateStartup() => {Create(startup)};");
+        sb.AppendLine();
+        sb.AppendLine($"        public global::GoldsrcFramework.Engine.Native.IServerExportFuncs? CreateServerExports() => {Create(server)};");
+        sb.AppendLine();
+        sb.AppendLine($"        public global::GoldsrcFramework.Engine.Native.IClientExportFuncs? CreateClientExports() => {Create(client)};");
+        sb.AppendLine();
+        sb.AppendLine("        public void ConfigureSettings(global::Microsoft.Extensions.DependencyInjection.IServiceCollection services, global::Microsoft.Extensions.Configuration.IConfiguration configuration)");
+        sb.AppendLine("        {");
+        if (settings)
+            sb.AppendLine("            GoldsrcSettingsBinder.AddGoldsrcSettings(services, configuration);");
+        sb.AppendLine("        }");
+        sb.AppendLine("    }");
+        sb.AppendLine("}");
+        return sb.ToString();
+    }
+
+    // Same choice as the reflection path (the first match), but only among types that can be constructed.
+    private static ModTypeCandidate? Pick(SourceProductionContext context, List<ModTypeCandidate> types, string interfaceName)
+    {
+        var creatable = types.Where(t => t.HasDefaultConstructor).ToList();
+        if (creatable.Count == 0)
+        {
+            foreach (var t in types)
+                context.ReportDiagnostic(DiagnosticInfo.Create(DiagnosticDescriptors.NoDefaultConstructor, t.Location?.ToLocation(), Short(t), interfaceName).ToDiagnostic());
+            return null;
+        }
+        for (int i = 1; i < creatable.Count; i++)
+        {
+            context.ReportDiagnostic(DiagnosticInfo.Create(DiagnosticDescriptors.MultipleImplementations, creatable[i].Location?.ToLocation(),
+                                                           Short(creatable[0]), Short(creatable[i]), interfaceName).ToDiagnostic());
+        }
+        return creatable[0];
+    }
+
+    private static string Create(ModTypeCandidate? type) => type == null ? "null" : $"new {type.TypeName}()";
+
+    private static string Short(ModTypeCandidate type) => type.TypeName.StartsWith("global::") ? type.TypeName.Substring(8) : type.TypeName;
+}
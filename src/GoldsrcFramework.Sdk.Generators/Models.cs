@@ -0,0 +1,148 @@
+using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using Microsoft.CodeAnalysis;
+
+namespace GoldsrcFramework.Sdk.Generators;
+
+/// <summary>
+/// How a settings property is read from its configuration section.
+/// </summary>
+internal enum SettingsMemberKind
+{
+    String,
+    Boolean,
+    /// <summary>Anything with a static Parse(string, IFormatProvider): the numeric types.</summary>
+    Parsable,
+    Enum,
+    StringDictionary,
+    StringList,
+    StringArray,
+    Object,
+}
+
+/// <param name="TypeName">Fully qualified, with global::; the underlying type for nullables.</param>
+/// <param name="Settable">Has a public setter; collections and objects without one are filled in place.</param>
+internal sealed record SettingsMember(string Name, SettingsMemberKind Kind, string TypeName, bool Settable);
+
+/// <param name="Section">Configuration section for classes marked [GoldsrcSettings]; null for nested classes.</param>
+internal sealed record SettingsType(string TypeName, string? Section, EquatableArray<SettingsMember> Members);
+
+/// <summary>
+/// A [GoldsrcSettings] class and every class reachable from its properties.
+/// </summary>
+internal sealed record SettingsRoot(SettingsType Root, EquatableArray<SettingsType> Nested, EquatableArray<DiagnosticInfo> Diagnostics);
+
+/// <summary>
+/// A class that could be the mod's startup class or export implementation.
+/// </summary>
+internal sealed record ModTypeCandidate(string TypeName, bool IsStartup, bool IsServer, bool IsClient, bool HasDefaultConstructor, LocationInfo? Location);
+
+/// <summary>
+/// Same values as GoldsrcFramework.Replay.ExportWrapperKind.
+/// </summary>
+internal enum ExportWrapperKind
+{
+    Profiling,
+    Recording,
+}
+
+/// <summary>
+/// How a recording wrapper passes a parameter to TraceCallScope; None is not recorded.
+/// </summary>
+internal enum TraceArgumentKind
+{
+    None,
+    Edict,
+    Text,
+    Int,
+    UInt,
+    Float,
+    Double,
+    QBoolean,
+}
+
+/// <summary>
+/// How a recording wrapper ends the call with the return value; Other returns it without recording it.
+/// </summary>
+internal enum TraceResultKind
+{
+    Void,
+    Int,
+    QBoolean,
+    Char,
+    Text,
+    Other,
+}
+
+/// <param name="Type">Fully qualified, with its ref / out / in modifier.</param>
+internal sealed record ExportParameter(string Name, string Type, string RefKind, TraceArgumentKind Trace);
+
+internal sealed record ExportMember(string Name, string ReturnType, TraceResultKind Result, EquatableArray<ExportParameter> Parameters);
+
+/// <summary>
+/// An [ExportWrapper] class and the interface members it leaves to the generator.
+/// </summary>
+internal sealed record ExportWrapper(string Namespace, string Name, ExportWrapperKind Kind, EquatableArray<ExportMember> Members,
+                                     EquatableArray<DiagnosticInfo> Diagnostics);
+
+internal sealed record LocationInfo(string FilePath, Microsoft.CodeAnalysis.Text.TextSpan Span, Microsoft.CodeAnalysis.Text.LinePositionSpan LineSpan)
+{
+    public Location ToLocation() => Location.Create(FilePath, Span, LineSpan);
+
+    public static LocationInfo? From(Location? location)
+        => location?.SourceTree == null ? null : new(location.SourceTree.FilePath, location.SourceSpan, location.GetLineSpan().Span);
+}
+
+internal sealed record DiagnosticInfo(DiagnosticDescriptor Descriptor, LocationInfo? Location, EquatableArray<string> Arguments)
+{
+    public static DiagnosticInfo Create(DiagnosticDescriptor descriptor, Location? location, params string[] arguments)
+        => new(descriptor, LocationInfo.From(location), new EquatableArray<string>(arguments.ToImmutableArray()));
+
+    public Diagnostic ToDiagnostic() => Diagnostic.Create(Descriptor, Location?.ToLocation(), Arguments.ToArray());
+}
+
+/// <summary>
+/// Immutable array with value equality, so pipeline outputs compare equal when nothing changed and the incremental
+/// generator can skip the later steps.
+/// </summary>
+internal readonly struct EquatableArray<T> : IEquatable<EquatableArray<T>>, IEnumerable<T> where T : IEquatable<T>
+{
+    private readonly ImmutableArray<T> _items;
+
+    public EquatableArray(ImmutableArray<T> items) => _items = items;
+
+    public int Length => _items.IsDefault ? 0 : _items.Length;
+
+    public T this[int index] => _items[index];
+
+    public T[] ToArray() => _items.IsDefault ? Array.Empty<T>() : _items.ToArray();
+
+    public bool Equals(EquatableArray<T> other)
+    {
+        if (Length != other.Length)
+            return false;
+        for (int i = 0; i < Length; i++)
+        {
+            if (!_items[i].Equals(other._items[i]))
+                return false;
+        }
+        return true;
+    }
+
+    public override bool Equals(object? obj) => obj is EquatableArray<T> other && Equals(other);
+
+    public override int GetHashCode()
+    {
+        int hash = 17;
+        for (int i = 0; i < Length; i++)
+            hash = hash * 31 + _items[i].GetHashCode();
+        return hash;
+    }
+
+    public IEnumerator<T> GetEnumerator() => ((IEnumerable<T>)ToArray()).GetEnumerator();
+
+    IEnumerator IEnumerable.GetEnumerator() => GetEnumerator();
+}
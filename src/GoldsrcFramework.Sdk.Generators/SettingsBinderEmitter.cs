@@ -0,0 +1,294 @@
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+
+namespace GoldsrcFramework.Sdk.Generators;
+
+/// <summary>
+/// Describes [GoldsrcSettings] classes and writes GoldsrcSettingsBinder, which fills them from IConfiguration with
+/// plain property assignments instead of ConfigurationBinder's reflection. Follows the binder's rules: keys are
+/// matched case-insensitively by IConfiguration, missing keys leave the default, collections are filled in place,
+/// and a value that does not parse throws InvalidOperationException.
+/// </summary>
+internal static class SettingsBinderEmitter
+{
+    public const string AttributeName = "GoldsrcFramework.Configuration.GoldsrcSettingsAttribute";
+
+    private static readonly SymbolDisplayFormat s_typeFormat = SymbolDisplayFormat.FullyQualifiedFormat
+        .WithMiscellaneousOptions(SymbolDisplayMiscellaneousOptions.UseSpecialTypes | SymbolDisplayMiscellaneousOptions.EscapeKeywordIdentifiers);
+
+    public static SettingsRoot Describe(INamedTypeSymbol type, string section, CancellationToken cancellationToken)
+    {
+        var nested = new List<SettingsType>();
+        var seen = new HashSet<string> { Name(type) };
+        var diagnostics = new List<DiagnosticInfo>();
+        var root = DescribeType(type, section, nested, seen, diagnostics, cancellationToken);
+        return new SettingsRoot(root, new(nested.ToImmutableArray()), new(diagnostics.ToImmutableArray()));
+    }
+
+    private static SettingsType DescribeType(INamedTypeSymbol type, string? section, List<SettingsType> nested, HashSet<string> seen,
+                                             List<DiagnosticInfo> diagnostics, CancellationToken cancellationToken)
+    {
+        var members = new List<SettingsMember>();
+        var names = new HashSet<string>();
+        for (var current = type; current != null && current.SpecialType != SpecialType.System_Object; current = current.BaseType)
+        {
+            foreach (var property in current.GetMembers().OfType<IPropertySymbol>())
+            {
+                cancellationToken.ThrowIfCancellationRequested();
+                if (property.IsStatic || property.IsIndexer || property.DeclaredAccessibility != Accessibility.Public ||
+                    property.GetMethod?.DeclaredAccessibility != Accessibility.Public || !names.Add(property.Name))
+                {
+                    continue;
+                }
+
+                bool settable = property.SetMethod is { DeclaredAccessibility: Accessibility.Public, IsInitOnly: false };
+                var kind = Classify(property.Type, out var valueType);
+                if (kind == null)
+                {
+                    diagnostics.Add(DiagnosticInfo.Create(DiagnosticDescriptors.UnsupportedSettingsProperty,
+                        property.Locations.FirstOrDefault(), type.Name, property.Name, property.Type.ToDisplayString()));
+                    continue;
+                }
+
+                bool scalar = kind is SettingsMemberKind.String or SettingsMemberKind.Boolean or SettingsMemberKind.Parsable
+                                   or SettingsMemberKind.Enum or SettingsMemberKind.StringArray;
+                if (scalar && !settable)
+                    continue;
+
+                if (kind == SettingsMemberKind.Object)
+                {
+                    var objectType = (INamedTypeSymbol)valueType;
+                    settable &= objectType.InstanceConstructors.Any(c => c.Parameters.Length == 0 && c.DeclaredAccessibility == Accessibility.Public);
+                    if (seen.Add(Name(objectType)))
+                        nested.Add(DescribeType(objectType, null, nested, seen, diagnostics, cancellationToken));
+                }
+
+                members.Add(new SettingsMember(property.Name, kind.Value, Name(valueType), settable));
+            }
+        }
+        return new SettingsType(Name(type), section, new(members.ToImmutableArray()));
+    }
+
+    private static SettingsMemberKind? Classify(ITypeSymbol type, out ITypeSymbol valueType)
+    {
+        valueType = type;
+        if (type is INamedTypeSymbol { OriginalDefinition.SpecialType: SpecialType.System_Nullable_T } nullable)
+            valueType = type = nullable.TypeArguments[0];
+
+        switch (type.SpecialType)
+        {
+            case SpecialType.System_String:
+                return SettingsMemberKind.String;
+            case SpecialType.System_Boolean:
+                return SettingsMemberKind.Boolean;
+            case SpecialType.System_Byte:
+            case SpecialType.System_SByte:
+            case SpecialType.System_Int16:
+            case SpecialType.System_UInt16:
+            case SpecialType.System_Int32:
+            case SpecialType.System_UInt32:
+            case SpecialType.System_Int64:
+            case SpecialType.System_UInt64:
+            case SpecialType.System_Single:
+            case SpecialType.System_Double:
+            case SpecialType.System_Decimal:
+                return SettingsMemberKind.Parsable;
+        }
+
+        if (type.TypeKind == TypeKind.Enum)
+            return SettingsMemberKind.Enum;
+
+        if (type is IArrayTypeSymbol { Rank: 1, ElementType.SpecialType: SpecialType.System_String })
+            return SettingsMemberKind.StringArray;
+
+        if (type is INamedTypeSymbol named)
+        {
+            var definition = named.OriginalDefinition.ToDisplayString();
+            if (named.TypeArguments.Length == 2 && named.TypeArguments.All(a => a.SpecialType == SpecialType.System_String) &&
+                definition is "System.Collections.Generic.Dictionary<TKey, TValue>" or "System.Collections.Generic.IDictionary<TKey, TValue>")
+            {
+                return SettingsMemberKind.StringDictionary;
+            }
+            if (named.TypeArguments.Length == 1 && named.TypeArguments[0].SpecialType == SpecialType.System_String &&
+                definition is "System.Collections.Generic.List<T>" or "System.Collections.Generic.IList<T>" or "System.Collections.Generic.ICollection<T>")
+            {
+                return SettingsMemberKind.StringList;
+            }
+            if (named.TypeKind == TypeKind.Class && !named.IsAbstract && !named.IsGenericType &&
+                named.ContainingNamespace?.ToDisplayString().StartsWith("System", System.StringComparison.Ordinal) != true)
+            {
+                return SettingsMemberKind.Object;
+            }
+        }
+        return null;
+    }
+
+    private static string Name(ITypeSymbol type) => type.ToDisplayString(s_typeFormat);
+
+    public static string Emit(IReadOnlyList<SettingsRoot> roots)
+    {
+        var sb = new StringBuilder();
+        sb.AppendLine("// <auto-generated/>");
+        sb.AppendLine("#nullable enable");
+        sb.AppendLine();
+        sb.AppendLine("namespace GoldsrcFramework.Generated");
+        sb.AppendLine("{");
+        sb.AppendLine("    /// <summary>");
+        sb.AppendLine("    /// Binds configuration sections to the [GoldsrcSettings] classes of this assembly without reflection.");
+        sb.AppendLine("    /// </summary>");
+        sb.AppendLine("    [global::System.CodeDom.Compiler.GeneratedCode(\"GoldsrcFramework.Sdk.Generators\", \"1.0\")]");
+        sb.AppendLine("    internal static class GoldsrcSettingsBinder");
+        sb.AppendLine("    {");
+        sb.AppendLine("        /// <summary>");
+        sb.AppendLine("        /// Register the options of every [GoldsrcSettings] class, bound from its section of <paramref name=\"configuration\"/>.");
+        sb.AppendLine("        /// </summary>");
+        sb.AppendLine("        public static void AddGoldsrcSettings(global::Microsoft.Extensions.DependencyInjection.IServiceCollection services, global::Microsoft.Extensions.Configuration.IConfiguration configuration)");
+        sb.AppendLine("        {");
+        foreach (var root in roots)
+        {
+            sb.AppendLine($"            global::Microsoft.Extensions.DependencyInjection.OptionsServiceCollectionExtensions.Configure<{root.Root.TypeName}>(services,");
+            sb.AppendLine($"                options => Bind(configuration.GetSection({Literal(root.Root.Section!)}), options));");
+        }
+        sb.AppendLine("        }");
+
+        var emitted = new HashSet<string>();
+        foreach (var type in roots.SelectMany(r => new[] { r.Root }.Concat(r.Nested)))
+        {
+            if (emitted.Add(type.TypeName))
+                EmitBind(sb, type);
+        }
+
+        sb.AppendLine(Helpers);
+        sb.AppendLine("    }");
+        sb.AppendLine("}");
+        return sb.ToString();
+    }
+
+    private static void EmitBind(StringBuilder sb, SettingsType type)
+    {
+        sb.AppendLine();
+        sb.AppendLine($"        public static void Bind(global::Microsoft.Extensions.Configuration.IConfiguration configuration, {type.TypeName} target)");
+        sb.AppendLine("        {");
+        foreach (var m in type.Members)
+        {
+            string key = Literal(m.Name);
+            switch (m.Kind)
+            {
+                case SettingsMemberKind.String:
+                    sb.AppendLine($"            if (configuration[{key}] is string {Local(m)})");
+                    sb.AppendLine($"                target.{m.Name} = {Local(m)};");
+                    break;
+                case SettingsMemberKind.Boolean:
+                    sb.AppendLine($"            if (configuration[{key}] is string {Local(m)})");
+                    sb.AppendLine($"                target.{m.Name} = ParseBoolean({Local(m)}, configuration, {key});");
+                    break;
+                case SettingsMemberKind.Parsable:
+                    sb.AppendLine($"            if (configuration[{key}] is string {Local(m)})");
+                    sb.AppendLine($"                target.{m.Name} = Parse<{m.TypeName}>({Local(m)}, configuration, {key});");
+                    break;
+                case SettingsMemberKind.Enum:
+                    sb.AppendLine($"            if (configuration[{key}] is string {Local(m)})");
+                    sb.AppendLine($"                target.{m.Name} = ParseEnum<{m.TypeName}>({Local(m)}, configuration, {key});");
+                    break;
+                case SettingsMemberKind.StringDictionary:
+                    OpenSection(sb, m);
+                    sb.AppendLine(m.Settable
+                        ? $"                    var map = target.{m.Name} ??= new global::System.Collections.Generic.Dictionary<string, string>();"
+                        : $"                    var map = target.{m.Name};");
+                    sb.AppendLine("                    foreach (var child in section.GetChildren())");
+                    sb.AppendLine("                        map[child.Key] = child.Value ?? string.Empty;");
+                    CloseSection(sb);
+                    break;
+                case SettingsMemberKind.StringList:
+                    OpenSection(sb, m);
+                    sb.AppendLine(m.Settable
+                        ? $"                    var list = target.{m.Name} ??= new global::System.Collections.Generic.List<string>();"
+                        : $"                    var list = target.{m.Name};");
+                    sb.AppendLine("                    foreach (var child in section.GetChildren())");
+                    sb.AppendLine("                        list.Add(child.Value ?? string.Empty);");
+                    CloseSection(sb);
+                    break;
+                case SettingsMemberKind.StringArray:
+                    OpenSection(sb, m);
+                    sb.AppendLine($"                    var items = new global::System.Collections.Generic.List<string>(target.{m.Name} ?? global::System.Array.Empty<string>());");
+                    sb.AppendLine("                    foreach (var child in section.GetChildren())");
+                    sb.AppendLine("                        items.Add(child.Value ?? string.Empty);");
+                    sb.AppendLine($"                    target.{m.Name} = items.ToArray();");
+                    CloseSection(sb);
+                    break;
+                case SettingsMemberKind.Object:
+                    OpenSection(sb, m);
+                    if (m.Settable)
+                    {
+                        sb.AppendLine($"                    Bind(section, target.{m.Name} ??= new {m.TypeName}());");
+                    }
+                    else
+                    {
+                        sb.AppendLine($"                    if (target.{m.Name} is {{ }} value)");
+                        sb.AppendLine("                        Bind(section, value);");
+                    }
+                    CloseSection(sb);
+                    break;
+            }
+        }
+        sb.AppendLine("        }");
+    }
+
+    private static void OpenSection(StringBuilder sb, SettingsMember m)
+    {
+        sb.AppendLine("            {");
+        sb.AppendLine($"                var section = configuration.GetSection({Literal(m.Name)});");
+        sb.AppendLine("                if (global::Microsoft.Extensions.Configuration.ConfigurationExtensions.Exists(section))");
+        sb.AppendLine("                {");
+    }
+
+    private static void CloseSection(StringBuilder sb)
+    {
+        sb.AppendLine("                }");
+        sb.AppendLine("            }");
+    }
+
+    private static string Local(SettingsMember m) => "value" + m.Name;
+
+    private static string Literal(string s) => "\"" + s.Replace("\\", "\\\\").Replace("\"", "\\\"") + "\"";
+
+    private const string Helpers = @"
+        private static bool ParseBoolean(string value, global::Microsoft.Extensions.Configuration.IConfiguration configuration, string key)
+        {
+            if (bool.TryParse(value, out var result))
+                return result;
+            throw Fail(value, configuration, key, ""bool"", null);
+        }
+
+        private static T Parse<T>(string value, global::Microsoft.Extensions.Configuration.IConfiguration configuration, string key)
+            where T : global::System.IParsable<T>
+        {
+            try
+            {
+                return T.Parse(value, global::System.Globalization.CultureInfo.InvariantCulture);
+            }
+            catch (global::System.Exception ex) when (ex is global::System.FormatException or global::System.OverflowException)
+            {
+                throw Fail(value, configuration, key, typeof(T).Name, ex);
+            }
+        }
+
+        private static T ParseEnum<T>(string value, global::Microsoft.Extensions.Configuration.IConfiguration configuration, string key)
+            where T : struct, global::System.Enum
+        {
+            if (global::System.Enum.TryParse<T>(value, ignoreCase: true, out var result))
+                return result;
+            throw Fail(value, configuration, key, typeof(T).Name, null);
+        }
+
+        private static global::System.InvalidOperationException Fail(string value, global::Microsoft.Extensions.Configuration.IConfiguration configuration,
+                                                                      string key, string type, global::System.Exception? inner)
+        {
+            var path = configuration is global::Microsoft.Extensions.Configuration.IConfigurationSection section ? section.Path + "":"" + key : key;
+            return new global::System.InvalidOperationException($""Failed to convert configuration value '{value}' at '{path}' to type '{type}'."", inner);
+        }";
+}
@@ -0,0 +1,255 @@
+using System.Runtime.InteropServices;
+using System.Text;
+using GoldsrcFramework.Bsp;
+using GoldsrcFramework.Engine.Native;
+using NativeInterop;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public unsafe class EntityLumpTests
+{
+    private enum Mode { Off, Pulse, Orbit }
+
+    private sealed class Marker
+    {
+        [KeyValue("origin")] public System.Numerics.Vector3 Origin;
+        [KeyValue("targetname")] public string? TargetName;
+        [KeyValue("radius")] public float Radius;
+        [KeyValue] public int count;
+        [KeyValue("mode")] public Mode Mode;
+        [KeyValue("enabled")] public bool Enabled { get; set; }
+    }
+
+    private sealed class Light
+    {
+        [KeyValue("style")] public int Style;
+    }
+
+    private const string Markers =
+        "{\n\"classname\" \"worldspawn\"\n}\n" +
+        "{\n\"origin\" \"1 -2.5 3\"\n\"targetname\" \"m1\"\n\"radius\" \"64.5\"\n\"count\" \"7\"\n\"mode\" \"2\"\n\"enabled\" \"1\"\n\"classname\" \"info_marker\"\n}\n" +
+        "{\n\"classname\" \"light\"\n\"style\" \"5\"\n}\n" +
+        "{\n\"classname\" \"info_marker\"\n\"Origin\" \"9 9 9\"\n\"origin\" \"4\"\n}\n";
+
+    [Fact]
+    public void BulkLoadBindsWhatPerPairKeyValueWould()
+    {
+        // Markers between lights and monsters, with the values a hand-written KeyValue would parse from each pair.
+        var text = new StringBuilder("{\n\"classname\" \"worldspawn\"\n\"wad\" \"halflife.wad\"\n}\n");
+        for (int i = 1; i < 40; i++)
+        {
+            text.Append((i % 4) switch
+            {
+                0 => $"{{\n\"origin\" \"{i} -{i}.5 8\"\n\"targetname\" \"marker{i}\"\n\"radius\" \"{i}.25\"\n\"count\" \"{i % 17}\"\n" +
+                     $"\"mode\" \"{i % 3}\"\n\"enabled\" \"{i % 2}\"\n\"classname\" \"info_marker\"\n}}\n",
+                1 => $"{{\n\"origin\" \"{i} 0 0\"\n\"style\" \"{i % 12}\"\n\"classname\" \"light\"\n}}\n",
+                _ => $"{{\n\"targetname\" \"zombie{i}\"\n// spawn later\n\"spawnflags\" \"32\"\n\"classname\" \"monster_zombie\"\n}}\n",
+            });
+        }
+
+        var classes = new MapEntityClasses();
+        classes.Register<Marker>("info_marker");
+        var lump = EntityLump.Parse(Encoding.UTF8.GetBytes(text.ToString()));
+        var entities = MapEntities.Load(lump, classes);
+        var edicts = (edict_t*)NativeMemory.AllocZeroed((nuint)lump.Count, (nuint)sizeof(edict_t));
+        var natives = new List<nint>();
+
+        try
+        {
+            // The engine's DispatchKeyValue sequence: every pair of every entity, in lump order.
+            int markerPairs = 0;
+            for (int e = 0; e < lump.Count; e++)
+            {
+                var record = lump[e];
+                for (int p = 0; p < record.PairCount; p++)
+                {
+                    var kvd = new KeyValueData
+                    {
+                        szClassName = Utf8(record.Classname.ToString()),
+                        szKeyName = Utf8(record.Key(p).ToString()),
+                        szValue = Utf8(record.Value(p).ToString()),
+                    };
+                    if (entities.TryHandleKeyValue(&edicts[e], &kvd))
+                        markerPairs++;
+                }
+                entities.OnSpawn(&edicts[e]);
+            }
+            entities.EndLoad();
+
+            Assert.Equal(40, lump.Count);
+            Assert.Equal(9, entities.ManagedCount);
+            Assert.Equal(9 * 7, markerPairs);
+            Assert.Equal(markerPairs, entities.HandledKeyValues);
+            for (int i = 0; i < 40; i++)
+            {
+                var marker = entities.Get<Marker>(&edicts[i]);
+                if (i % 4 != 0 || i == 0)
+                {
+                    Assert.Null(marker);
+                    continue;
+                }
+
+                Assert.NotNull(marker);
+                Assert.Equal(new System.Numerics.Vector3(i, -i - 0.5f, 8), marker.Origin);
+                Assert.Equal($"marker{i}", marker.TargetName);
+                Assert.Equal(i + 0.25f, marker.Radius);
+                Assert.Equal(i % 17, marker.count);
+                Assert.Equal((Mode)(i % 3), marker.Mode);
+                Assert.Equal(i % 2 != 0, marker.Enabled);
+            }
+        }
+        finally
+        {
+            foreach (var p in natives)
+                Marshal.FreeCoTaskMem(p);
+            NativeMemory.Free(edicts);
+        }
+
+        NChar* Utf8(string s)
+        {
+            var p = Marshal.StringToCoTaskMemUTF8(s);
+            natives.Add(p);
+            return (NChar*)p;
+        }
+    }
+
+    [Fact]
+    public void LoadReadsTheLumpOfAMapFile()
+    {
+        var path = Path.Combine(Path.GetTempPath(), $"room-{Guid.NewGuid():N}.bsp");
+        try
+        {
+            File.WriteAllBytes(path, TestMaps.BoxRoom("{\n\"classname\" \"info_marker\"\n\"radius\" \"8\"\n}\n"));
+            using var bsp = BspFile.Open(path);
+
+            var classes = new MapEntityClasses();
+            classes.Register<Marker>("info_marker");
+            var entities = MapEntities.Load(EntityLump.Load(bsp), classes);
+
+            Assert.Equal(2, entities.Lump.Count);
+            Assert.True(entities.Lump[0].Classname.Equals("worldspawn"));
+            Assert.Equal(1, entities.ManagedCount);
+            Assert.Equal(8f, ((Marker)entities[1]!).Radius);
+        }
+        finally
+        {
+            File.Delete(path);
+        }
+    }
+
+    [Fact]
+    public void ParseReadsPairsAndClassnames()
+    {
+        var lump = EntityLump.Parse(Encoding.UTF8.GetBytes(Markers + "\0trailing garbage"));
+
+        Assert.Equal(4, lump.Count);
+        Assert.Equal(13, lump.PairCount);
+        Assert.True(lump[1].Classname.Equals("info_marker"));
+        Assert.True(lump[1].TryGetValue(new Strings.Utf8View("radius"u8), out var radius));
+        Assert.True(radius.Equals("64.5"));
+        Assert.True(lump[2].Key(1).Equals("style"));
+        Assert.True(lump[2].Value(1).Equals("5"));
+    }
+
+    [Fact]
+    public void ParseHandlesCommentsAndLongStrings()
+    {
+        var text = "// header comment { \"not\" \"a pair\" }\n{\n\"classname\" \"worldspawn\"\n// \"skipped\" \"pair\"\n" +
+                   $"\"message\" \"{new string('x', 150)}\nsecond / line\"\n}}\n";
+        var lump = EntityLump.Parse(Encoding.UTF8.GetBytes(text));
+
+        Assert.Equal(1, lump.Count);
+        Assert.Equal(2, lump[0].PairCount);
+        Assert.Equal(150 + "\nsecond / line".Length, lump[0].Value(1).Length);
+    }
+
+    [Theory]
+    [InlineData("{ { }")]
+    [InlineData("}")]
+    [InlineData("{ \"key\" }")]
+    [InlineData("{ \"key\" \"value }")]
+    [InlineData("{ \"key\" \"value\"")]
+    [InlineData("\"key\" \"value\"")]
+    public void ParseRejectsMalformedLumps(string text)
+    {
+        Assert.Throws<InvalidDataException>(() => EntityLump.Parse(Encoding.UTF8.GetBytes(text)));
+    }
+
+    [Fact]
+    public void BinderSetsDeclaredKeysOnly()
+    {
+        var lump = EntityLump.Parse(Encoding.UTF8.GetBytes(Markers));
+        var marker = new Marker();
+
+        Assert.Equal(6, KeyValueBinder<Marker>.Apply(marker, lump[1]));
+        Assert.Equal(new System.Numerics.Vector3(1, -2.5f, 3), marker.Origin);
+        Assert.Equal("m1", marker.TargetName);
+        Assert.Equal(64.5f, marker.Radius);
+        Assert.Equal(7, marker.count);
+        Assert.Equal(Mode.Orbit, marker.Mode);
+        Assert.True(marker.Enabled);
+
+        // Keys are case-sensitive and missing vector components are 0.
+        var second = new Marker();
+        Assert.Equal(1, KeyValueBinder<Marker>.Apply(second, lump[3]));
+        Assert.Equal(new System.Numerics.Vector3(4, 0, 0), second.Origin);
+    }
+
+    [Fact]
+    public void ExclusiveClassesAnswerDispatchKeyValue()
+    {
+        var classes = new MapEntityClasses();
+        classes.Register<Marker>("info_marker");
+        classes.Register<Light>("light", exclusive: false);
+        var entities = MapEntities.Load(EntityLump.Parse(Encoding.UTF8.GetBytes(Markers)), classes);
+        var edicts = (edict_t*)NativeMemory.AllocZeroed(4, (nuint)sizeof(edict_t));
+        var natives = new List<nint>();
+
+        try
+        {
+            Assert.Equal(3, entities.ManagedCount);
+            Assert.Equal(5, ((Light)entities[2]!).Style);
+
+            // The engine spawns worldspawn itself, then dispatches each entity's pairs in lump order.
+            Assert.True(Dispatch(&edicts[1], "info_marker", "origin"));
+            Assert.True(Dispatch(&edicts[1], "info_marker", "radius"));
+            entities.OnSpawn(&edicts[1]);
+            Assert.False(Dispatch(&edicts[1], "light", "style"));
+            entities.OnSpawn(&edicts[1]);
+            Assert.True(Dispatch(&edicts[2], "info_marker", "origin"));
+            entities.EndLoad();
+            Assert.False(Dispatch(&edicts[3], "info_marker", "origin"));
+
+            Assert.Equal(3, entities.HandledKeyValues);
+            Assert.Equal(64.5f, ((Marker)entities[1]!).Radius);
+            Assert.Same(entities[3], entities.Get<Marker>(&edicts[2]));
+        }
+        finally
+        {
+            foreach (var p in natives)
+                Marshal.FreeCoTaskMem(p);
+            NativeMemory.Free(edicts);
+        }
+
+        bool Dispatch(edict_t* edict, string classname, string key)
+        {
+            var kvd = new KeyValueData
+            {
+                szClassName = Utf8(classname),
+                szKeyName = Utf8(key),
+                szValue = Utf8("1"),
+            };
+            bool handled = entities.TryHandleKeyValue(edict, &kvd);
+            Assert.Equal(handled ? 1 : 0, kvd.fHandled);
+            return handled;
+        }
+
+        NChar* Utf8(string s)
+        {
+            var p = Marshal.StringToCoTaskMemUTF8(s);
+            natives.Add(p);
+            return (NChar*)p;
+        }
+    }
+}
@@ -0,0 +1,184 @@
+using GoldsrcFramework.Bsp;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public class HullCollisionModelTests
+{
+    private const float E = HullCollisionModel.DIST_EPSILON;
+
+    /// <summary>
+    /// What the engine's SV_RecursiveHullCheck returns for traces in <see cref="TestMaps.BoxRoom"/>: a hit stops
+    /// DIST_EPSILON short of the plane, the normal faces the trace, a start in solid only clears allsolid once the
+    /// trace reaches open space.
+    /// </summary>
+    private static HullTraceRecord[] BoxRoomReference() =>
+    [
+        // Open space.
+        Record(0, new(0, 0, 64), new(50, 50, 100), 1, new(50, 50, 100), default),
+        // Walls, floor and the first wall of a diagonal.
+        Record(0, new(0, 0, 64), new(200, 0, 64), (128 - E) / 200, new(128 - E, 0, 64), new(-1, 0, 0)),
+        Record(0, new(0, 0, 64), new(0, 0, -64), (64 - E) / 128, new(0, 0, E), new(0, 0, 1)),
+        Record(0, new(0, 0, 64), new(256, 128, 64), (128 - E) / 256, new(128 - E, (128 - E) / 2, 64), new(-1, 0, 0)),
+        // Starts in the wall and moves into the room.
+        Record(0, new(-200, 0, 64), new(0, 0, 64), 1, new(0, 0, 64), default, startSolid: true),
+        // Never leaves the wall.
+        Record(0, new(-300, 0, 64), new(-200, 0, 64), 1, new(-200, 0, 64), default, startSolid: true, allSolid: true),
+        // Hulls 1-3 are the room shrunk by the hull size: floor at 36, wall at 96, ceiling at 110.
+        Record(1, new(0, 0, 64), new(0, 0, -64), (28 - E) / 128, new(0, 0, 36 + E), new(0, 0, 1)),
+        Record(2, new(0, 0, 64), new(0, 300, 64), (96 - E) / 300, new(0, 96 - E, 64), new(0, -1, 0)),
+        Record(3, new(0, 0, 64), new(0, 0, 200), (46 - E) / 136, new(0, 0, 110 - E), new(0, 0, -1)),
+    ];
+
+    private static HullTraceRecord Record(int hull, Vector3 start, Vector3 end, float fraction, Vector3 endPos, Vector3 normal,
+        bool startSolid = false, bool allSolid = false)
+    {
+        return new HullTraceRecord
+        {
+            Request = new HullTraceRequest(start, end, hull),
+            Expected = new HullTraceResult
+            {
+                AllSolid = allSolid,
+                StartSolid = startSolid,
+                Fraction = fraction,
+                EndPos = endPos,
+                PlaneNormal = normal,
+            },
+        };
+    }
+
+    private static HullCollisionModel LoadBoxRoom()
+    {
+        using var bsp = BspFile.FromBytes(TestMaps.BoxRoom());
+        return HullCollisionModel.LoadWorld(bsp);
+    }
+
+    [Fact]
+    public void TracesMatchTheEngineReference()
+    {
+        var model = LoadBoxRoom();
+        var records = BoxRoomReference();
+
+        foreach (var record in records)
+        {
+            var actual = model.TraceHull(record.Request.Start, record.Request.End, record.Request.Hull);
+            var expected = record.Expected;
+
+            Assert.Equal(expected.AllSolid, actual.AllSolid);
+            Assert.Equal(expected.StartSolid, actual.StartSolid);
+            Assert.Equal(expected.Fraction, actual.Fraction, 1e-5f);
+            Assert.Equal(expected.EndPos.X, actual.EndPos.X, 1e-3f);
+            Assert.Equal(expected.EndPos.Y, actual.EndPos.Y, 1e-3f);
+            Assert.Equal(expected.EndPos.Z, actual.EndPos.Z, 1e-3f);
+            if (expected.Fraction < 1)
+                Assert.Equal(expected.PlaneNormal, actual.PlaneNormal);
+        }
+    }
+
+    /// <summary>
+    /// Recordings go through the same file format and validator as the ones captured in game with
+    /// <see cref="HullTraceValidation.RecordEngineTrace"/>.
+    /// </summary>
+    [Fact]
+    public void RecordedTracesValidate()
+    {
+        var path = Path.Combine(Path.GetTempPath(), $"hulltrace-{Guid.NewGuid():N}.ghtr");
+        try
+        {
+            HullTraceValidation.Save(path, BoxRoomReference());
+            var report = HullTraceValidation.Validate(LoadBoxRoom(), HullTraceValidation.Load(path));
+
+            Assert.Equal(BoxRoomReference().Length, report.Total);
+            Assert.True(report.Mismatches == 0, report.ToString());
+        }
+        finally
+        {
+            File.Delete(path);
+        }
+    }
+
+    [Fact]
+    public void ValidationReportsMismatches()
+    {
+        var records = BoxRoomReference();
+        records[1].Expected.Fraction = 0.5f;
+        records[2].Expected.PlaneNormal = new Vector3(1, 0, 0);
+
+        var report = HullTraceValidation.Validate(LoadBoxRoom(), records);
+
+        Assert.Equal(2, report.Mismatches);
+        Assert.Equal(new[] { 1, 2 }, report.MismatchIndices);
+    }
+
+    [Fact]
+    public void PointContentsFollowTheHullSize()
+    {
+        var model = LoadBoxRoom();
+
+        Assert.Equal(BspConstants.CONTENTS_EMPTY, model.PointContents(new Vector3(0, 0, 20), 0));
+        Assert.Equal(BspConstants.CONTENTS_SOLID, model.PointContents(new Vector3(0, 0, 20), 1));
+        Assert.Equal(BspConstants.CONTENTS_SOLID, model.PointContents(new Vector3(0, 0, -1), 0));
+    }
+
+    [Fact]
+    public void BoxTracePicksTheHullAndReturnsBoxOrigins()
+    {
+        var model = LoadBoxRoom();
+        var mins = new Vector3(-16, -16, -36);
+        var maxs = new Vector3(16, 16, 36);
+
+        Assert.Equal(1, model.SelectHull(mins, maxs, out _));
+        Assert.Equal(3, model.SelectHull(new Vector3(-16, -16, -18), new Vector3(16, 16, 18), out _));
+        Assert.Equal(2, model.SelectHull(new Vector3(-32, -32, -32), new Vector3(32, 32, 32), out _));
+
+        var trace = model.TraceBox(new Vector3(0, 0, 64), mins, maxs, new Vector3(0, 0, -64));
+        Assert.Equal(36 + E, trace.EndPos.Z, 1e-3f);
+        Assert.Equal(new Vector3(0, 0, 1), trace.PlaneNormal);
+    }
+
+    [Fact]
+    public void BatchMatchesSerial()
+    {
+        var model = LoadBoxRoom();
+        var rng = new Random(1234);
+        var requests = new HullTraceRequest[5000];
+        for (int i = 0; i < requests.Length; i++)
+            requests[i] = new HullTraceRequest(RandomPoint(rng), RandomPoint(rng), i & 3);
+
+        var serial = new HullTraceResult[requests.Length];
+        var batch = new HullTraceResult[requests.Length];
+        model.TraceRange(requests, serial);
+        model.TraceBatch(requests, batch, chunkSize: 64);
+
+        for (int i = 0; i < requests.Length; i++)
+        {
+            Assert.Equal(serial[i].Fraction, batch[i].Fraction);
+            Assert.Equal(serial[i].EndPos, batch[i].EndPos);
+            Assert.Equal(serial[i].StartSolid, batch[i].StartSolid);
+            Assert.Equal(serial[i].AllSolid, batch[i].AllSolid);
+        }
+
+        static Vector3 RandomPoint(Random rng) => new(rng.Next(-160, 160), rng.Next(-160, 160), rng.Next(-32, 160));
+    }
+
+    [Fact]
+    public void MapFileOnDiskTracesLikeTheEngine()
+    {
+        var path = Path.Combine(Path.GetTempPath(), $"room-{Guid.NewGuid():N}.bsp");
+        try
+        {
+            File.WriteAllBytes(path, TestMaps.BoxRoom());
+            HullCollisionModel model;
+            using (var bsp = BspFile.Open(path))
+                model = HullCollisionModel.LoadWorld(bsp);
+
+            Assert.Equal(0, HullTraceValidation.Validate(model, BoxRoomReference()).Mismatches);
+        }
+        finally
+        {
+            File.Delete(path);
+        }
+    }
+}
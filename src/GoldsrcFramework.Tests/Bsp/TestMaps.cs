@@ -0,0 +1,236 @@
+using GoldsrcFramework.Bsp;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+
+namespace GoldsrcFramework.Tests;
+
+/// <summary>
+/// Hand-built BSP30 images and visibility data for tests that need a map without shipping one.
+/// </summary>
+internal static class TestMaps
+{
+    public static readonly Vector3 RoomMins = new(-128, -128, 0);
+    public static readonly Vector3 RoomMaxs = new(128, 128, 128);
+
+    private const float CellSize = 128;
+
+    // Mod_LoadClipnodes hull sizes.
+    private static readonly Vector3[] s_hullMins = [new(0, 0, 0), new(-16, -16, -36), new(-32, -32, -32), new(-16, -16, -18)];
+    private static readonly Vector3[] s_hullMaxs = [new(0, 0, 0), new(16, 16, 36), new(32, 32, 32), new(16, 16, 18)];
+
+    /// <summary>
+    /// A closed box room (<see cref="RoomMins"/> to <see cref="RoomMaxs"/>) with one empty leaf, as qbsp/qcsg would
+    /// compile it: axial planes with positive normals, a chain of six nodes per hull, hulls 1-3 expanded by the hull
+    /// size. Entity lump is a bare worldspawn plus <paramref name="entities"/>.
+    /// </summary>
+    public static byte[] BoxRoom(string entities = "")
+    {
+        var planes = new List<(Vector3 Normal, float Dist, int Type)>();
+        for (int hull = 0; hull < 4; hull++)
+        {
+            var lo = RoomMins - s_hullMins[hull];
+            var hi = RoomMaxs - s_hullMaxs[hull];
+            for (int axis = 0; axis < 3; axis++)
+            {
+                var normal = axis switch { 0 => new Vector3(1, 0, 0), 1 => new Vector3(0, 1, 0), _ => new Vector3(0, 0, 1) };
+                planes.Add((normal, Component(lo, axis), axis));
+                planes.Add((normal, Component(hi, axis), axis));
+            }
+        }
+
+        using var stream = new MemoryStream();
+        using var w = new BinaryWriter(stream);
+        w.Write(new byte[4 + BspConstants.HEADER_LUMPS * 8]);
+        var lumps = new (int Offset, int Length)[BspConstants.HEADER_LUMPS];
+
+        void Lump(int lump, Action write)
+        {
+            int offset = (int)stream.Position;
+            write();
+            lumps[lump] = (offset, (int)stream.Position - offset);
+        }
+
+        Lump(BspConstants.LUMP_ENTITIES, () =>
+        {
+            w.Write(System.Text.Encoding.ASCII.GetBytes("{\n\"classname\" \"worldspawn\"\n}\n" + entities));
+            w.Write((byte)0);
+        });
+
+        Lump(BspConstants.LUMP_PLANES, () =>
+        {
+            foreach (var p in planes)
+            {
+                w.Write(p.Normal.X); w.Write(p.Normal.Y); w.Write(p.Normal.Z);
+                w.Write(p.Dist);
+                w.Write(p.Type);
+            }
+        });
+
+        // Node k splits on plane k: the room is on the front of the low planes and the back of the high ones.
+        // Leaf 0 is solid, leaf 1 the room (children -1 and -2).
+        Lump(BspConstants.LUMP_NODES, () =>
+        {
+            for (int k = 0; k < 6; k++)
+            {
+                short next = k == 5 ? (short)-2 : (short)(k + 1);
+                w.Write(k);
+                w.Write((k & 1) == 0 ? next : (short)-1);
+                w.Write((k & 1) == 0 ? (short)-1 : next);
+                WriteShorts(w, RoomMins);
+                WriteShorts(w, RoomMaxs);
+                w.Write((ushort)0); w.Write((ushort)0);
+            }
+        });
+
+        Lump(BspConstants.LUMP_CLIPNODES, () =>
+        {
+            for (int hull = 1; hull < 4; hull++)
+            {
+                for (int k = 0; k < 6; k++)
+                {
+                    int index = (hull - 1) * 6 + k;
+                    short next = k == 5 ? (short)BspConstants.CONTENTS_EMPTY : (short)(index + 1);
+                    w.Write(hull * 6 + k);
+                    w.Write((k & 1) == 0 ? next : (short)BspConstants.CONTENTS_SOLID);
+                    w.Write((k & 1) == 0 ? (short)BspConstants.CONTENTS_SOLID : next);
+                }
+            }
+        });
+
+        Lump(BspConstants.LUMP_LEAFS, () =>
+        {
+            foreach (int contents in new[] { BspConstants.CONTENTS_SOLID, BspConstants.CONTENTS_EMPTY })
+            {
+                w.Write(contents);
+                w.Write(-1);
+                WriteShorts(w, RoomMins);
+                WriteShorts(w, RoomMaxs);
+                w.Write((ushort)0); w.Write((ushort)0);
+                w.Write(0);
+            }
+        });
+
+        Lump(BspConstants.LUMP_MODELS, () =>
+        {
+            WriteFloats(w, RoomMins);
+            WriteFloats(w, RoomMaxs);
+            WriteFloats(w, default);
+            w.Write(0); w.Write(0); w.Write(6); w.Write(12);
+            w.Write(1);
+            w.Write(0); w.Write(0);
+        });
+
+        for (int i = 0; i < lumps.Length; i++)
+        {
+            if (lumps[i].Length == 0)
+                lumps[i].Offset = (int)stream.Length;
+        }
+
+        stream.Position = 0;
+        w.Write(BspConstants.BSPVERSION);
+        foreach (var (offset, length) in lumps)
+        {
+            w.Write(offset);
+            w.Write(length);
+        }
+
+        return stream.ToArray();
+    }
+
+    /// <summary>
+    /// Flat map of <paramref name="grid"/> x <paramref name="grid"/> leafs split by a kd-tree of axial planes,
+    /// where each leaf sees every leaf within <paramref name="sight"/> cells; visdata compressed as vis does.
+    /// </summary>
+    public static VisibilityCache VisGrid(int grid, int sight, int budgetBytes = VisibilityCache.DefaultBudgetBytes)
+    {
+        int leafCount = grid * grid;
+        var nodes = new List<dnode_t>();
+        var planes = new List<dplane_t>();
+        int head = BuildNode(nodes, planes, 0, grid, 0, grid, grid);
+
+        int rowBytes = (leafCount + 7) >> 3;
+        var row = new byte[rowBytes];
+        var vis = new List<byte>();
+        var offsets = new int[leafCount + 1];
+        var contents = new int[leafCount + 1];
+        offsets[0] = -1;
+        contents[0] = BspConstants.CONTENTS_SOLID;
+        for (int leaf = 1; leaf <= leafCount; leaf++)
+        {
+            contents[leaf] = BspConstants.CONTENTS_EMPTY;
+            int x = (leaf - 1) % grid, y = (leaf - 1) / grid;
+            Array.Clear(row);
+            for (int oy = Math.Max(y - sight, 0); oy <= Math.Min(y + sight, grid - 1); oy++)
+            {
+                for (int ox = Math.Max(x - sight, 0); ox <= Math.Min(x + sight, grid - 1); ox++)
+                {
+                    int bit = oy * grid + ox;
+                    row[bit >> 3] |= (byte)(1 << (bit & 7));
+                }
+            }
+            offsets[leaf] = vis.Count;
+            Compress(row, vis);
+        }
+
+        return new VisibilityCache(vis.ToArray(), offsets, contents, nodes.ToArray(), planes.ToArray(), head, leafCount, budgetBytes);
+    }
+
+    // Cells [x0, x1) x [y0, y1); leaf of cell (x, y) is 1 + y * grid + x.
+    private static int BuildNode(List<dnode_t> nodes, List<dplane_t> planes, int x0, int x1, int y0, int y1, int grid)
+    {
+        if (x1 - x0 == 1 && y1 - y0 == 1)
+            return -1 - (1 + y0 * grid + x0);
+
+        bool splitX = x1 - x0 >= y1 - y0;
+        int mid = splitX ? (x0 + x1) / 2 : (y0 + y1) / 2;
+        int plane = planes.Count;
+        planes.Add(new dplane_t
+        {
+            normal = splitX ? new Vector3(1, 0, 0) : new Vector3(0, 1, 0),
+            dist = mid * CellSize,
+            type = splitX ? 0 : 1,
+        });
+
+        int index = nodes.Count;
+        nodes.Add(default);
+        int front = splitX ? BuildNode(nodes, planes, mid, x1, y0, y1, grid) : BuildNode(nodes, planes, x0, x1, mid, y1, grid);
+        int back = splitX ? BuildNode(nodes, planes, x0, mid, y0, y1, grid) : BuildNode(nodes, planes, x0, x1, y0, mid, grid);
+
+        var node = new dnode_t { planenum = plane };
+        node.children[0] = (short)front;
+        node.children[1] = (short)back;
+        nodes[index] = node;
+        return index;
+    }
+
+    // CompressVis: runs of zero bytes become 0, count.
+    private static void Compress(ReadOnlySpan<byte> row, List<byte> output)
+    {
+        for (int i = 0; i < row.Length; i++)
+        {
+            output.Add(row[i]);
+            if (row[i] != 0)
+                continue;
+
+            int rep = 1;
+            while (i + 1 < row.Length && row[i + 1] == 0 && rep < 255)
+            {
+                i++;
+                rep++;
+            }
+            output.Add((byte)rep);
+        }
+    }
+
+    private static float Component(Vector3 v, int axis) => axis switch { 0 => v.X, 1 => v.Y, _ => v.Z };
+
+    private static void WriteShorts(BinaryWriter w, Vector3 v)
+    {
+        w.Write((short)v.X); w.Write((short)v.Y); w.Write((short)v.Z);
+    }
+
+    private static void WriteFloats(BinaryWriter w, Vector3 v)
+    {
+        w.Write(v.X); w.Write(v.Y); w.Write(v.Z);
+    }
+}
@@ -0,0 +1,189 @@
+using GoldsrcFramework.Bsp;
+using GoldsrcFramework.LinearMath;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public class VisibilityCacheTests
+{
+    private const int Grid = 16;
+    private const int Sight = 2;
+
+    [Fact]
+    public void LeafMapCollectsWhatPerEntityTestsFind()
+    {
+        var cache = TestMaps.VisGrid(Grid, Sight);
+        var map = new EntityLeafMap(cache, 256);
+        var rng = new Random(1234);
+        for (int i = 0; i < 256; i++)
+        {
+            var center = RandomPoint(rng);
+            var half = new Vector3(16 + rng.Next(64), 16 + rng.Next(64), 16 + rng.Next(64));
+            map.Update(i, center - half, center + half);
+        }
+
+        var entities = new ulong[map.EntityWords];
+        for (int client = 0; client < 8; client++)
+        {
+            var pvs = cache.GetPvs(cache.LeafAt(RandomPoint(rng))).ToArray();
+            int collected = map.CollectInSet(pvs, entities);
+
+            int scanned = 0;
+            for (int e = 0; e < 256; e++)
+            {
+                bool inSet = map.IsInSet(e, pvs);
+                Assert.Equal(inSet, VisBits.Test(entities, e));
+                scanned += inSet ? 1 : 0;
+            }
+            Assert.Equal(scanned, collected);
+        }
+    }
+
+    [Fact]
+    public void UnionOfClientRowsMatchesScalar()
+    {
+        var cache = TestMaps.VisGrid(Grid, Sight);
+        var rng = new Random(99);
+        var union = new ulong[cache.RowWords];
+        var scalar = new ulong[cache.RowWords];
+        for (int client = 0; client < 8; client++)
+        {
+            int leaf = cache.LeafAt(RandomPoint(rng));
+            var pvs = cache.GetPvs(leaf);
+            VisBits.Or(union, pvs);
+            for (int w = 0; w < scalar.Length; w++)
+                scalar[w] |= pvs[w];
+            cache.GetPas(leaf);
+        }
+
+        Assert.Equal(scalar, union);
+        Assert.InRange(cache.Stats.PasRows, 1, 8);
+    }
+
+    [Fact]
+    public void LeafAtFindsTheCell()
+    {
+        var cache = TestMaps.VisGrid(Grid, Sight);
+
+        Assert.Equal(Leaf(0, 0), cache.LeafAt(Center(0, 0)));
+        Assert.Equal(Leaf(5, 3), cache.LeafAt(Center(5, 3)));
+        Assert.Equal(Leaf(15, 15), cache.LeafAt(Center(15, 15)));
+    }
+
+    [Fact]
+    public void PvsCoversTheSightRadius()
+    {
+        var cache = TestMaps.VisGrid(Grid, Sight);
+        int from = Leaf(3, 3);
+
+        Assert.True(cache.IsVisible(from, Leaf(5, 3)));
+        Assert.True(cache.IsVisible(from, Leaf(1, 5)));
+        Assert.False(cache.IsVisible(from, Leaf(6, 3)));
+        Assert.False(cache.IsVisible(from, Leaf(3, 6)));
+        Assert.Equal(25, VisBits.PopCount(cache.GetPvs(from)));
+    }
+
+    [Fact]
+    public void PasIsTheUnionOfVisiblePvs()
+    {
+        var cache = TestMaps.VisGrid(Grid, Sight);
+        var pas = cache.GetPas(Leaf(8, 8)).ToArray();
+
+        Assert.True(VisibilityCache.Contains(pas, Leaf(12, 8)));
+        Assert.True(VisibilityCache.Contains(pas, Leaf(4, 4)));
+        Assert.False(VisibilityCache.Contains(pas, Leaf(13, 8)));
+        Assert.Equal(81, VisBits.PopCount(pas));
+    }
+
+    [Fact]
+    public void CachedRowsMatchDecoding()
+    {
+        var cache = TestMaps.VisGrid(Grid, Sight);
+        var row = new ulong[cache.RowWords];
+        for (int leaf = 1; leaf <= cache.LeafCount; leaf++)
+        {
+            cache.DecompressPvs(leaf, row);
+            Assert.True(cache.GetPvs(leaf).SequenceEqual(row));
+        }
+
+        cache.GetPvs(1);
+        Assert.Equal(Grid * Grid, cache.Stats.PvsMisses);
+        Assert.Equal(1, cache.Stats.PvsHits);
+    }
+
+    [Fact]
+    public void LeafZeroSeesEverything()
+    {
+        var cache = TestMaps.VisGrid(Grid, Sight);
+
+        Assert.Equal(Grid * Grid, VisBits.PopCount(cache.GetPvs(0)));
+        Assert.Equal(Grid * Grid, VisBits.PopCount(cache.GetPas(0)));
+    }
+
+    [Fact]
+    public void SmallBudgetEvictsButStaysCorrect()
+    {
+        // 256 leafs are 32-byte rows, so 256 bytes hold four PVS and four PAS rows.
+        var cache = TestMaps.VisGrid(Grid, Sight, budgetBytes: 256);
+        var row = new ulong[cache.RowWords];
+        for (int leaf = 1; leaf <= 20; leaf++)
+        {
+            cache.DecompressPvs(leaf, row);
+            Assert.True(cache.GetPvs(leaf).SequenceEqual(row));
+        }
+
+        Assert.Equal(4, cache.Stats.PvsRows);
+        Assert.Equal(16, cache.Stats.Evictions);
+        Assert.True(cache.Stats.Bytes <= 256);
+    }
+
+    [Fact]
+    public void EntityLeafMapTracksMovesAndRemoval()
+    {
+        var cache = TestMaps.VisGrid(Grid, Sight);
+        var map = new EntityLeafMap(cache, 64);
+        var half = new Vector3(16, 16, 16);
+
+        map.Update(1, Center(2, 2) - half, Center(2, 2) + half);
+        Assert.Equal(new short[] { (short)Leaf(2, 2) }, map.GetLeafs(1).ToArray());
+
+        // Straddling a cell corner links four leafs.
+        var corner = new Vector3(5 * 128, 5 * 128, 64);
+        map.Update(2, corner - half, corner + half);
+        Assert.Equal(4, map.GetLeafs(2).Length);
+
+        var pvs = cache.GetPvs(Leaf(3, 3)).ToArray();
+        var entities = new ulong[map.EntityWords];
+        Assert.True(map.IsInSet(1, pvs));
+        Assert.True(map.IsInSet(2, pvs));
+        Assert.Equal(2, map.CollectInSet(pvs, entities));
+
+        map.Update(1, Center(12, 12) - half, Center(12, 12) + half);
+        Assert.False(map.IsInSet(1, pvs));
+        map.Remove(2);
+        Assert.False(map.IsInSet(2, pvs));
+        Assert.Equal(0, map.CollectInSet(pvs, entities));
+    }
+
+    [Fact]
+    public void EntityOverTooManyLeafsIsEverywhere()
+    {
+        var cache = TestMaps.VisGrid(Grid, Sight);
+        var map = new EntityLeafMap(cache, 8);
+        map.Update(3, new Vector3(0, 0, 0), new Vector3(Grid * 128, Grid * 128, 256));
+
+        var pvs = cache.GetPvs(Leaf(0, 0)).ToArray();
+        var entities = new ulong[map.EntityWords];
+        Assert.True(map.IsEverywhere(3));
+        Assert.True(map.IsInSet(3, pvs));
+        Assert.Equal(1, map.CollectInSet(pvs, entities));
+        Assert.True(VisBits.Test(entities, 3));
+    }
+
+    private static int Leaf(int x, int y) => 1 + y * Grid + x;
+
+    private static Vector3 RandomPoint(Random rng) =>
+        new((float)rng.NextDouble() * Grid * 128, (float)rng.NextDouble() * Grid * 128, (float)rng.NextDouble() * 256);
+
+    private static Vector3 Center(int x, int y) => new(x * 128 + 64, y * 128 + 64, 64);
+}
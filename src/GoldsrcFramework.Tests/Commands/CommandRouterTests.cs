@@ -0,0 +1,135 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Commands;
+using GoldsrcFramework.Engine.Native;
+using NativeInterop;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public unsafe class CommandRouterTests
+{
+    // The command the fake engine is executing: Cmd_Argv tokens and Cmd_Args text.
+    private static nint[] s_argv = Array.Empty<nint>();
+    private static nint s_args;
+
+    [Fact]
+    public void EngineCommandsDispatchWithoutAllocating()
+    {
+        var engine = (ServerEngineFuncs*)NativeMemory.AllocZeroed((nuint)sizeof(ServerEngineFuncs));
+        try
+        {
+            engine->Cmd_Argc = &Argc;
+            engine->Cmd_Argv = &Argv;
+            engine->Cmd_Args = &Args;
+
+            var router = new CommandRouter();
+            int menu = 0, said = 0;
+            router.Add("menuselect", (client, args) => menu = args[1].ToInt32());
+            router.Add("say", (client, args) =>
+            {
+                Assert.True(args[1].Equals("gg wp"));
+                Assert.True(args.Args.Equals("\"gg wp\""));
+                said++;
+            });
+
+            // Cmd_Args keeps the quotes and the trailing newline, as the engine's does.
+            Execute(new[] { "say", "gg wp" }, "\"gg wp\"\n");
+            Assert.True(router.TryDispatch(null, CommandArgs.FromServer(engine)));
+            Execute(new[] { "MENUSELECT", "3" }, "3\n");
+            Assert.True(router.TryDispatch(null, CommandArgs.FromServer(engine)));
+            Execute(new[] { "menuselec", "4" }, "4\n");
+            Assert.False(router.TryDispatch(null, CommandArgs.FromServer(engine)));
+
+            Assert.Equal(1, said);
+            Assert.Equal(3, menu);
+
+            Execute(new[] { "menuselect", "7" }, "7\n");
+            long allocated = GC.GetAllocatedBytesForCurrentThread();
+            for (int i = 0; i < 100; i++)
+                router.TryDispatch(null, CommandArgs.FromServer(engine));
+            Assert.Equal(0, GC.GetAllocatedBytesForCurrentThread() - allocated);
+            Assert.Equal(7, menu);
+        }
+        finally
+        {
+            Execute(Array.Empty<string>(), null);
+            NativeMemory.Free(engine);
+        }
+    }
+
+    [Fact]
+    public void TokenizeSplitsLikeCmdTokenizeString()
+    {
+        Span<Range> tokens = stackalloc Range[8];
+        var args = CommandArgs.Tokenize("say \"hello world\" 2 // comment"u8, tokens);
+
+        Assert.Equal(3, args.Count);
+        Assert.True(args.Name.Equals("say"));
+        Assert.True(args[1].Equals("hello world"));
+        Assert.Equal(2, args[2].ToInt32());
+        Assert.True(args[3].IsEmpty);
+        Assert.True(args.Args.Equals("\"hello world\" 2 // comment"));
+    }
+
+    [Fact]
+    public void TokenizeDropsTokensPastTheBuffer()
+    {
+        Span<Range> tokens = stackalloc Range[2];
+        var args = CommandArgs.Tokenize("a b c"u8, tokens);
+
+        Assert.Equal(2, args.Count);
+        Assert.True(args[1].Equals("b"));
+    }
+
+    [Fact]
+    public void DispatchIgnoresCaseAndCountsUnhandled()
+    {
+        var router = new CommandRouter();
+        int value = 0;
+        router.Add("menuselect", (client, args) => value = args[1].ToInt32());
+
+        Span<Range> tokens = stackalloc Range[4];
+        Assert.True(router.TryDispatch(null, CommandArgs.Tokenize("MenuSelect 3"u8, tokens)));
+        Assert.False(router.TryDispatch(null, CommandArgs.Tokenize("menuselec 4"u8, tokens)));
+        Assert.False(router.TryDispatch(null, CommandArgs.Tokenize("   "u8, tokens)));
+
+        Assert.Equal(3, value);
+        Assert.Equal(1, router.Dispatched);
+        Assert.Equal(2, router.Unhandled);
+    }
+
+    [Fact]
+    public void AddReplacesTheHandler()
+    {
+        var router = new CommandRouter();
+        int calls = 0;
+        router.Add("kill", (client, args) => calls += 1);
+        router.Add("KILL", (client, args) => calls += 10);
+
+        Span<Range> tokens = stackalloc Range[2];
+        router.TryDispatch(null, CommandArgs.Tokenize("kill"u8, tokens));
+
+        Assert.Equal(1, router.Count);
+        Assert.Equal(10, calls);
+    }
+
+    private static void Execute(string[] argv, string? args)
+    {
+        foreach (var p in s_argv)
+            Marshal.FreeCoTaskMem(p);
+        Marshal.FreeCoTaskMem(s_args);
+
+        s_argv = argv.Select(Marshal.StringToCoTaskMemUTF8).ToArray();
+        s_args = Marshal.StringToCoTaskMemUTF8(args);
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int Argc() => s_argv.Length;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static NChar* Argv(int index) => index < s_argv.Length ? (NChar*)s_argv[index] : null;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static NChar* Args() => (NChar*)s_args;
+}
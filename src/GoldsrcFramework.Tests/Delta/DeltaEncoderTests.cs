@@ -0,0 +1,198 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Delta;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using NativeInterop;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public unsafe class DeltaEncoderTests
+{
+    // Fake delta description: engine index = position in this list. angles[2] is left out on purpose.
+    private static readonly string[] s_fields = { "origin[0]", "origin[1]", "origin[2]", "angles[0]", "angles[1]", "frame" };
+
+    private const ulong Origin = 0b000111;
+    private const ulong Angles = 0b011000;
+    private const ulong Frame = 0b100000;
+
+    private static ulong s_sendBits;
+    private static int s_currentPlayer;
+
+    [Fact]
+    public void LocalPlayerOriginIsNotSent()
+    {
+        var from = new entity_state_t { number = 1 };
+        var to = from;
+        to.origin = new Vector3(8, 16, 0);
+        to.frame = 1;
+
+        Assert.Equal(Frame, Encode(from, to, (Origin & ~4UL) | Frame, currentPlayer: 0));
+        Assert.Equal((Origin & ~4UL) | Frame, Encode(from, to, (Origin & ~4UL) | Frame, currentPlayer: 3));
+    }
+
+    [Fact]
+    public void ClientSideProjectileOriginAndAnglesAreNotSent()
+    {
+        var from = new entity_state_t { number = 5 };
+        var to = from;
+        to.impacttime = 2;
+        to.starttime = 1;
+        to.origin = new Vector3(1, 2, 3);
+        to.angles = new Vector3(4, 5, 6);
+
+        Assert.Equal(0UL, Encode(from, to, Origin | Angles));
+    }
+
+    [Fact]
+    public void FollowingEntityOriginIsNotSent()
+    {
+        var from = new entity_state_t { number = 5, movetype = 12, aiment = 1 };
+        var to = from;
+        to.origin = new Vector3(1, 2, 3);
+        to.frame = 2;
+
+        Assert.Equal(Frame, Encode(from, to, Origin | Frame));
+    }
+
+    [Fact]
+    public void NewAimentSendsTheOriginEvenIfUnchanged()
+    {
+        var from = new entity_state_t { number = 5, movetype = 7, aiment = 2 };
+        var to = from;
+        to.aiment = 0;
+
+        Assert.Equal(Origin, Encode(from, to, 0));
+    }
+
+    [Fact]
+    public void OtherEntitiesKeepWhatTheEngineMarked()
+    {
+        var from = new entity_state_t { number = 5, movetype = 3 };
+        var to = from;
+        to.origin = new Vector3(1, 2, 3);
+        to.angles = new Vector3(0, 90, 0);
+        to.frame = 3;
+
+        Assert.Equal(Origin | (Angles & ~8UL) | Frame, Encode(from, to, Origin | (Angles & ~8UL) | Frame));
+    }
+
+    [Fact]
+    public void StatisticsCountChangedFields()
+    {
+        var encoder = new EntityEncoder();
+        var from = new entity_state_t { number = 5 };
+        var to = from;
+        for (int i = 0; i < 4; i++)
+        {
+            to.frame = i + 1;
+            if (i % 2 == 0)
+                to.origin.X += 8;
+            Encode(encoder, from, to, 0);
+            from = to;
+        }
+        Encode(encoder, from, to, 0);
+
+        var stats = encoder.GetStatistics().ToDictionary(f => f.Name);
+        Assert.Equal(4, stats["frame"].Changes);
+        Assert.Equal(0.8, stats["frame"].Rate, 6);
+        Assert.Equal(2, stats["origin"].Changes);
+        Assert.Equal(0, stats["angles"].Changes);
+    }
+
+    private static ulong Encode(entity_state_t from, entity_state_t to, ulong marks, int currentPlayer = 0)
+        => Encode(new EntityEncoder(), from, to, marks, currentPlayer);
+
+    // One engine call into the encoder, starting from the fields the engine marked as changed.
+    private static ulong Encode(EntityEncoder encoder, entity_state_t from, entity_state_t to, ulong marks, int currentPlayer = 0)
+    {
+        var engine = (ServerEngineFuncs*)NativeMemory.AllocZeroed((nuint)sizeof(ServerEngineFuncs));
+        var delta = (delta_s*)NativeMemory.AllocZeroed(16);
+        try
+        {
+            engine->DeltaFindField = &FindField;
+            engine->DeltaSetFieldByIndex = &SetByIndex;
+            engine->DeltaUnsetFieldByIndex = &UnsetByIndex;
+            engine->GetCurrentPlayer = &GetCurrentPlayer;
+            encoder.Engine = engine;
+
+            s_currentPlayer = currentPlayer;
+            s_sendBits = marks;
+            encoder.Invoke(delta, (byte*)&from, (byte*)&to);
+            return s_sendBits;
+        }
+        finally
+        {
+            NativeMemory.Free(delta);
+            NativeMemory.Free(engine);
+        }
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int FindField(delta_s* fields, NChar* name)
+        => Array.IndexOf(s_fields, Marshal.PtrToStringUTF8((nint)name));
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void SetByIndex(delta_s* fields, int index) => s_sendBits |= 1UL << index;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void UnsetByIndex(delta_s* fields, int index) => s_sendBits &= ~(1UL << index);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int GetCurrentPlayer() => s_currentPlayer;
+
+    [Theory]
+    [InlineData(340)]
+    [InlineData(37)]
+    [InlineData(3)]
+    [InlineData(DeltaChangeMask.MaxBytes)]
+    public void VectorMaskMatchesScalar(int size)
+    {
+        var rng = new Random(size);
+        var from = new byte[size];
+        var to = new byte[size];
+        rng.NextBytes(from);
+
+        for (int round = 0; round < 50; round++)
+        {
+            from.CopyTo(to, 0);
+            for (int k = rng.Next(4); k > 0; k--)
+                to[rng.Next(size)] ^= (byte)(1 + rng.Next(255));
+
+            fixed (byte* f = from, t = to)
+            {
+                var vector = DeltaChangeMask.Compute(f, t, size);
+                var scalar = DeltaChangeMask.ComputeScalar(f, t, size);
+                for (int lane = 0; lane < DeltaChangeMask.MaxWords / 64; lane++)
+                    Assert.Equal(scalar[lane], vector[lane]);
+            }
+        }
+    }
+
+    [Fact]
+    public void MaskMarksTheChangedWord()
+    {
+        var from = new byte[340];
+        var to = new byte[340];
+        to[101] = 1;
+        to[339] = 1;
+
+        fixed (byte* f = from, t = to)
+        {
+            var mask = DeltaChangeMask.Compute(f, t, 340);
+
+            Assert.Equal(2, mask.Count);
+            Assert.True(mask.IsWordChanged(25));
+            Assert.True(mask.IsWordChanged(84));
+            Assert.False(mask.IsWordChanged(24));
+            Assert.True(DeltaChangeMask.Compute(f, f, 340).IsEmpty);
+        }
+    }
+
+    [Fact]
+    public void MaskRejectsOversizedStructs()
+    {
+        Assert.Throws<ArgumentOutOfRangeException>(() => DeltaChangeMask.Compute(null, null, DeltaChangeMask.MaxBytes + 4));
+    }
+}
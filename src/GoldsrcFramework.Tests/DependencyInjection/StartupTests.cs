@@ -0,0 +1,125 @@
+using GoldsrcFramework.Configuration;
+using GoldsrcFramework.DependencyInjection;
+using GoldsrcFramework.Engine.Native;
+using Microsoft.Extensions.Options;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public class StartupTests
+{
+    // Logging stays synchronous and quiet so the tests do not replace the process-wide AsyncLog sinks.
+    private const string Settings = """
+        {
+          "Framework": { "FrameworkName": "StartupTests", "EnableDebug": true, "FrameBudgetMilliseconds": 12.5, "FrameHitchContextFrames": 3 },
+          "Logging": { "Async": false, "EnableConsole": false },
+          "Game": { "GameName": "Opposing Force", "MaxPlayers": 16, "EnablePhysics": false, "PhysicsSubsteps": 2 }
+        }
+        """;
+
+    [Theory]
+    [InlineData(StartupMode.Generated)]
+    [InlineData(StartupMode.Reflection)]
+    public void BothModesStartTheFrameworkExports(StartupMode mode)
+    {
+        WithSettings(Settings, path =>
+        {
+            // Started twice, as a server and client load in one process after a restart.
+            for (int i = 0; i < 2; i++)
+            {
+                try
+                {
+                    ServiceContainer.Initialize(path, mode);
+
+                    Assert.Equal(mode, ServiceContainer.ActiveMode);
+                    Assert.IsType<FrameworkServerExports>(ServiceContainer.GetService<IServerExportFuncs>());
+                    Assert.IsType<FrameworkClientExports>(ServiceContainer.GetService<IClientExportFuncs>());
+                }
+                finally
+                {
+                    ServiceContainer.Reset();
+                }
+                Assert.False(ServiceContainer.IsInitialized);
+            }
+        });
+    }
+
+    [Fact]
+    public void GeneratedBindersMatchConfigurationBinder()
+    {
+        WithSettings(Settings, path =>
+        {
+            var (generatedFramework, generatedGame) = Start(path, StartupMode.Generated);
+            var (boundFramework, boundGame) = Start(path, StartupMode.Reflection);
+
+            Assert.Equal("StartupTests", generatedFramework.FrameworkName);
+            Assert.Equal(12.5, generatedFramework.FrameBudgetMilliseconds);
+            Assert.Equal("Opposing Force", generatedGame.GameName);
+            Assert.Equal(16, generatedGame.MaxPlayers);
+
+            Assert.Equal(boundFramework.FrameworkName, generatedFramework.FrameworkName);
+            Assert.Equal(boundFramework.Version, generatedFramework.Version);
+            Assert.Equal(boundFramework.EnableDebug, generatedFramework.EnableDebug);
+            Assert.Equal(boundFramework.FrameBudgetMilliseconds, generatedFramework.FrameBudgetMilliseconds);
+            Assert.Equal(boundFramework.FrameHitchContextFrames, generatedFramework.FrameHitchContextFrames);
+            Assert.Equal(boundGame.GameName, generatedGame.GameName);
+            Assert.Equal(boundGame.MaxPlayers, generatedGame.MaxPlayers);
+            Assert.Equal(boundGame.EnablePhysics, generatedGame.EnablePhysics);
+            Assert.Equal(boundGame.PhysicsSubsteps, generatedGame.PhysicsSubsteps);
+            Assert.Equal(boundGame.PhysicsUpdateRate, generatedGame.PhysicsUpdateRate);
+        });
+    }
+
+    [Fact]
+    public void AutoFallsBackToReflectionForAMissingGameAssembly()
+    {
+        const string missing = """
+            {
+              "Framework": { "GameServerAssembly": "missing.dll" },
+              "Logging": { "Async": false, "EnableConsole": false }
+            }
+            """;
+        WithSettings(missing, path =>
+        {
+            try
+            {
+                ServiceContainer.Initialize(path, StartupMode.Auto);
+
+                Assert.Equal(StartupMode.Reflection, ServiceContainer.ActiveMode);
+                Assert.IsType<FrameworkServerExports>(ServiceContainer.GetService<IServerExportFuncs>());
+            }
+            finally
+            {
+                ServiceContainer.Reset();
+            }
+        });
+    }
+
+    private static (FrameworkSettings Framework, GameSettings Game) Start(string path, StartupMode mode)
+    {
+        try
+        {
+            ServiceContainer.Initialize(path, mode);
+            return (ServiceContainer.GetService<IOptions<FrameworkSettings>>().Value,
+                    ServiceContainer.GetService<IOptions<GameSettings>>().Value);
+        }
+        finally
+        {
+            ServiceContainer.Reset();
+        }
+    }
+
+    private static void WithSettings(string json, Action<string> test)
+    {
+        var path = Path.Combine(Path.GetTempPath(), $"gsf-startup-test-{Environment.ProcessId}.json");
+        File.WriteAllText(path, json);
+        try
+        {
+            test(path);
+        }
+        finally
+        {
+            File.Delete(path);
+        }
+    }
+}
@@ -0,0 +1,177 @@
+using System.Diagnostics;
+using System.Reflection.Emit;
+using GoldsrcFramework.Diagnostics;
+using GoldsrcFramework.Replay;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public class FrameProfilerTests
+{
+    [Fact]
+    public void InjectedHitchesAreAttributedToTheirCause()
+    {
+        const double Budget = 10;
+        var csvPath = Path.Combine(Path.GetTempPath(), $"frame_hitches_causes_{Environment.ProcessId}.csv");
+        File.Delete(csvPath);
+
+        // Live data for the gen2 collection to walk.
+        var heap = new object[1 << 20];
+        for (int i = 0; i < heap.Length; i++)
+            heap[i] = new int[4];
+
+        try
+        {
+            FrameProfilerStats stats;
+            using (var profiler = new FrameProfiler("test", Budget, csvPath))
+            {
+                // Frames of a fifth of the budget; frame 10 collects, 20 compiles fresh code in Spawn, 30 has a slow Think.
+                for (int frame = 1; frame <= 30; frame++)
+                {
+                    profiler.BeginFrame(frame * Budget / 1000);
+                    var previous = profiler.Enter(TraceCall.StartFrame);
+                    Spin(Budget / 5);
+                    profiler.Exit(previous);
+
+                    switch (frame)
+                    {
+                        case 10:
+                            GC.Collect(2, GCCollectionMode.Forced, blocking: true, compacting: true);
+                            break;
+                        case 20:
+                            previous = profiler.Enter(TraceCall.Spawn);
+                            CompileFresh(Budget * 2);
+                            profiler.Exit(previous);
+                            break;
+                        case 30:
+                            previous = profiler.Enter(TraceCall.Think);
+                            Spin(Budget * 2);
+                            profiler.Exit(previous);
+                            break;
+                    }
+                }
+                profiler.BeginFrame(31 * Budget / 1000);
+                stats = profiler.Stats;
+            }
+
+            // Each injected hitch is caught with its cause; a first-frame JIT burst may add one more.
+            Assert.True(stats.GcHitches >= 1);
+            Assert.True(stats.JitHitches >= 1);
+            Assert.True(stats.ModHitches >= 1);
+            Assert.Equal(0, stats.EngineHitches);
+            Assert.InRange(stats.Hitches, 3, 4);
+            Assert.True(File.ReadLines(csvPath).Count() - 1 >= stats.Hitches);
+        }
+        finally
+        {
+            GC.KeepAlive(heap);
+            File.Delete(csvPath);
+        }
+    }
+
+    [Fact]
+    public void EnterAndExitNest()
+    {
+        using var profiler = new FrameProfiler("test", 1000, watchdog: false);
+
+        var outer = profiler.Enter(TraceCall.StartFrame);
+        var inner = profiler.Enter(TraceCall.Think);
+        Assert.Equal(TraceCall.None, outer);
+        Assert.Equal(TraceCall.StartFrame, inner);
+        profiler.Exit(inner);
+        profiler.Exit(outer);
+
+        profiler.BeginFrame(0);
+        profiler.BeginFrame(0.01);
+        Assert.Equal(2, profiler.Frames);
+        Assert.Equal(0, profiler.Stats.Hitches);
+    }
+
+    [Fact]
+    public void SlowExportIsModCodeAndSlowEngineIsEngine()
+    {
+        using var profiler = new FrameProfiler("test", 5, watchdog: false);
+        profiler.BeginFrame(0);
+
+        // Frame 1: the time goes into an export.
+        var previous = profiler.Enter(TraceCall.Think);
+        Spin(20);
+        profiler.Exit(previous);
+        profiler.BeginFrame(0.01);
+
+        // Frame 2: the time goes by between exports.
+        Spin(20);
+        profiler.BeginFrame(0.02);
+
+        var stats = profiler.Stats;
+        Assert.Equal(2, stats.Hitches);
+        Assert.Equal(1, stats.ModHitches);
+        Assert.Equal(1, stats.EngineHitches);
+        Assert.True(stats.WorstMilliseconds >= 20);
+        Assert.Contains("2 over 5.0 ms", profiler.Summary());
+    }
+
+    [Fact]
+    public void HitchesAreWrittenWithTheirContextFrames()
+    {
+        var csvPath = Path.Combine(Path.GetTempPath(), $"frame_hitches_test_{Environment.ProcessId}.csv");
+        File.Delete(csvPath);
+        try
+        {
+            using (var profiler = new FrameProfiler("test", 5, csvPath, contextFrames: 2, watchdog: false))
+            {
+                // Frames 1-4 are quick, 5 and 6 go over: 3, 4 and 5 are written, then only 6.
+                for (int frame = 0; frame <= 6; frame++)
+                {
+                    if (frame >= 5)
+                        Spin(10);
+                    profiler.BeginFrame(frame * 0.01);
+                }
+                profiler.Flush();
+            }
+
+            var lines = File.ReadAllLines(csvPath);
+            Assert.StartsWith("profiler,frame,time,hitch,cause", lines[0]);
+            Assert.Equal(new[] { "3", "4", "5", "6" }, lines.Skip(1).Select(line => line.Split(',')[1]).ToArray());
+            Assert.Equal(new[] { "0", "0", "1", "1" }, lines.Skip(1).Select(line => line.Split(',')[3]).ToArray());
+        }
+        finally
+        {
+            File.Delete(csvPath);
+        }
+    }
+
+    private static void Spin(double milliseconds)
+    {
+        long end = Stopwatch.GetTimestamp() + (long)(milliseconds * Stopwatch.Frequency / 1000);
+        while (Stopwatch.GetTimestamp() < end)
+        {
+        }
+    }
+
+    // Large dynamic methods, each JIT-compiled on first call, until at least the given time has gone into compiling.
+    private static void CompileFresh(double milliseconds)
+    {
+        var start = System.Runtime.JitInfo.GetCompilationTime(currentThread: true);
+        for (int m = 0; m < 256 && (System.Runtime.JitInfo.GetCompilationTime(currentThread: true) - start).TotalMilliseconds < milliseconds; m++)
+        {
+            var method = new DynamicMethod($"Fresh{m}", typeof(long), new[] { typeof(long) });
+            var il = method.GetILGenerator();
+            var local = il.DeclareLocal(typeof(long));
+            il.Emit(OpCodes.Ldarg_0);
+            il.Emit(OpCodes.Stloc, local);
+            for (int i = 0; i < 2000; i++)
+            {
+                il.Emit(OpCodes.Ldloc, local);
+                il.Emit(OpCodes.Ldc_I8, i * 2654435761L);
+                il.Emit((i & 1) == 0 ? OpCodes.Xor : OpCodes.Add);
+                il.Emit(OpCodes.Ldc_I4, i % 7 + 1);
+                il.Emit(OpCodes.Shl);
+                il.Emit(OpCodes.Stloc, local);
+            }
+            il.Emit(OpCodes.Ldloc, local);
+            il.Emit(OpCodes.Ret);
+            ((Func<long, long>)method.CreateDelegate(typeof(Func<long, long>)))(m);
+        }
+    }
+}
@@ -0,0 +1,354 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Effects;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+/// <summary>
+/// <see cref="TempEntitySimulator"/> against HUD_TempEntUpdate's rules, on a fake client engine whose event API
+/// traces against a floor at z = 0.
+/// </summary>
+public unsafe class TempEntitySimulatorTests : IDisposable
+{
+    private const double FrameTime = 0.01;
+    private const double Gravity = 800;
+    private const float GravityStep = (float)(FrameTime * Gravity);
+    private const int kRenderTransTexture = 2;
+
+    // What the hit callback does to the flags of the entity it is called for.
+    private static int s_hitSetFlags;
+    private static int s_hitClearFlags;
+    private static int s_hits;
+    private static int s_sounds;
+    private static float s_soundDamp;
+
+    private readonly ClientEngineFuncs* _engine;
+    private readonly event_api_t* _eventApi;
+    private readonly TEMPENTITY* _pool;
+    private TEMPENTITY* _active;
+    private TEMPENTITY* _free;
+    private int _spawned;
+    private double _time = 1;
+
+    public TempEntitySimulatorTests()
+    {
+        _engine = (ClientEngineFuncs*)NativeMemory.AllocZeroed((nuint)sizeof(ClientEngineFuncs));
+        _eventApi = (event_api_t*)NativeMemory.AllocZeroed((nuint)sizeof(event_api_t));
+        _pool = (TEMPENTITY*)NativeMemory.AllocZeroed(1024, (nuint)sizeof(TEMPENTITY));
+
+        _eventApi->EV_SetUpPlayerPrediction = &SetUpPlayerPrediction;
+        _eventApi->EV_PushPMStates = &PMStates;
+        _eventApi->EV_PopPMStates = &PMStates;
+        _eventApi->EV_SetSolidPlayers = &IntArgument;
+        _eventApi->EV_SetTraceHull = &IntArgument;
+        _eventApi->EV_PlayerTrace = &FloorTrace;
+        _engine->pEventAPI = _eventApi;
+
+        s_hitSetFlags = s_hitClearFlags = s_hits = s_sounds = 0;
+        s_soundDamp = 0;
+    }
+
+    [Fact]
+    public void ExpiredEntityGoesToTheFreeList()
+    {
+        var simulator = new TempEntitySimulator(_engine);
+        var kept = Spawn(new Vector3(0, 0, 100), TempEntityFlags.FTENT_NONE);
+        var expired = Spawn(new Vector3(0, 0, 100), TempEntityFlags.FTENT_NONE);
+        expired->die = (float)_time;
+
+        var stats = Frame(simulator);
+
+        Assert.Equal(1, stats.Killed);
+        Assert.Equal(1, stats.Active);
+        Assert.True(_free == expired);
+        Assert.True(_active == kept && kept->next == null);
+    }
+
+    [Fact]
+    public void FadeOutLowersRenderAmountAfterDieTime()
+    {
+        var simulator = new TempEntitySimulator(_engine);
+        var p = Spawn(new Vector3(0, 0, 100), TempEntityFlags.FTENT_FADEOUT);
+        p->die = (float)_time + 0.01f - 0.25f;
+        p->fadeSpeed = 2;
+        p->entity.baseline.renderamt = 200;
+
+        // A quarter second past die at 2x speed: half the baseline amount, drawn blended.
+        Frame(simulator);
+        Assert.Equal(kRenderTransTexture, p->entity.curstate.rendermode);
+        Assert.InRange(p->entity.curstate.renderamt, 99, 100);
+
+        // Gone once the amount reaches zero.
+        while (_active != null && _time < 3)
+            Frame(simulator);
+        Assert.True(_active == null);
+        Assert.True(_time < 1.6);
+    }
+
+    [Fact]
+    public void GravityAndSlowGravityPullTheVelocityDown()
+    {
+        var simulator = new TempEntitySimulator(_engine);
+        var gravity = Spawn(new Vector3(0, 0, 1000), TempEntityFlags.FTENT_GRAVITY);
+        var slow = Spawn(new Vector3(0, 0, 1000), TempEntityFlags.FTENT_SLOWGRAVITY);
+        var none = Spawn(new Vector3(0, 0, 1000), TempEntityFlags.FTENT_NONE);
+
+        Frame(simulator);
+        Assert.Equal(-GravityStep, gravity->entity.baseline.origin.Z);
+        Assert.Equal(-GravityStep / 2, slow->entity.baseline.origin.Z);
+        Assert.Equal(0f, none->entity.baseline.origin.Z);
+        Assert.Equal(1000f, gravity->entity.origin.Z);
+
+        // Velocity moves the entity on the next frame.
+        Frame(simulator);
+        Assert.Equal(1000 - GravityStep * (float)FrameTime, gravity->entity.origin.Z, 1e-3f);
+        Assert.Equal(-GravityStep * 2, gravity->entity.baseline.origin.Z);
+    }
+
+    [Fact]
+    public void BounceReflectsAndDampsVelocityAtTheContactPoint()
+    {
+        var simulator = new TempEntitySimulator(_engine);
+        var elastic = Spawn(new Vector3(0, 0, 1), TempEntityFlags.FTENT_COLLIDEWORLD, new Vector3(100, 0, -200));
+        var damped = Spawn(new Vector3(0, 0, 1), TempEntityFlags.FTENT_COLLIDEWORLD, new Vector3(100, 0, -200));
+        damped->bounceFactor = 0.5f;
+        damped->hitSound = 1;
+
+        var stats = Frame(simulator);
+
+        Assert.Equal(2, stats.Collided);
+        Assert.Equal(0f, elastic->entity.origin.Z, 1e-4f);
+        Assert.Equal(0.5f, elastic->entity.origin.X, 1e-4f);
+        Assert.Equal(new Vector3(100, 0, 200), elastic->entity.baseline.origin);
+        Assert.Equal(new Vector3(50, 0, 100), damped->entity.baseline.origin);
+        Assert.Equal(1, s_sounds);
+        Assert.Equal(0.5f, s_soundDamp);
+    }
+
+    [Fact]
+    public void GravityHalvesTheBounceAndSlowLandingsStop()
+    {
+        var simulator = new TempEntitySimulator(_engine);
+        const TempEntityFlags flags = TempEntityFlags.FTENT_GRAVITY | TempEntityFlags.FTENT_COLLIDEWORLD | TempEntityFlags.FTENT_ROTATE;
+        var bouncing = Spawn(new Vector3(0, 0, 1), flags, new Vector3(0, 0, -150));
+        var landing = Spawn(new Vector3(0, 0, 0.1f), flags, new Vector3(0, 0, -20));
+
+        Frame(simulator);
+
+        // Reflected at half speed, then this frame's gravity.
+        Assert.Equal(75 - GravityStep, bouncing->entity.baseline.origin.Z);
+        Assert.Equal((int)flags, bouncing->flags);
+
+        // Slower than three gravity steps: comes to rest and stops simulating gravity, rotation and collision.
+        Assert.Equal(0f, landing->entity.baseline.origin.Z);
+        Assert.Equal(0, landing->flags & (int)(TempEntityFlags.FTENT_GRAVITY | TempEntityFlags.FTENT_COLLIDEWORLD | TempEntityFlags.FTENT_ROTATE));
+    }
+
+    [Fact]
+    public void CollideKillDiesOnImpact()
+    {
+        var simulator = new TempEntitySimulator(_engine);
+        var p = Spawn(new Vector3(0, 0, 1), TempEntityFlags.FTENT_COLLIDEWORLD | TempEntityFlags.FTENT_COLLIDEKILL | TempEntityFlags.FTENT_FADEOUT,
+                      new Vector3(0, 0, -200));
+
+        Frame(simulator);
+        Assert.Equal((float)_time, p->die);
+        Assert.Equal(0, p->flags & (int)TempEntityFlags.FTENT_FADEOUT);
+
+        Assert.Equal(1, Frame(simulator).Killed);
+        Assert.True(_active == null);
+    }
+
+    [Fact]
+    public void HitCallbackCanMakeTheImpactKill()
+    {
+        var simulator = new TempEntitySimulator(_engine);
+        var p = Spawn(new Vector3(0, 0, 1), TempEntityFlags.FTENT_COLLIDEWORLD, new Vector3(0, 0, -200));
+        p->hitcallback = &Hit;
+        s_hitSetFlags = (int)TempEntityFlags.FTENT_COLLIDEKILL;
+
+        Frame(simulator);
+
+        Assert.Equal(1, s_hits);
+        Assert.Equal((float)_time, p->die);
+        Assert.Equal(new Vector3(0, 0, -200), p->entity.baseline.origin);
+    }
+
+    [Fact]
+    public void HitCallbackCanTurnGravityOff()
+    {
+        var simulator = new TempEntitySimulator(_engine);
+        var p = Spawn(new Vector3(0, 0, 1), TempEntityFlags.FTENT_GRAVITY | TempEntityFlags.FTENT_COLLIDEALL, new Vector3(0, 0, -150));
+        p->hitcallback = &Hit;
+        s_hitClearFlags = (int)TempEntityFlags.FTENT_GRAVITY;
+
+        Frame(simulator);
+
+        // Without gravity the bounce is not halved, and no gravity is added after it.
+        Assert.Equal(1, s_hits);
+        Assert.Equal(150f, p->entity.baseline.origin.Z);
+    }
+
+    [Fact]
+    public void EntitiesTheClientDoesNotDrawDieUnlessPersistent()
+    {
+        var simulator = new TempEntitySimulator(_engine);
+        var dropped = Spawn(new Vector3(0, 0, 100), TempEntityFlags.FTENT_FADEOUT);
+        var persistent = Spawn(new Vector3(0, 0, 100), TempEntityFlags.FTENT_PERSIST);
+        var hidden = Spawn(new Vector3(0, 0, 100), TempEntityFlags.FTENT_NOMODEL);
+
+        var stats = Frame(simulator, &RejectVisibleEntity);
+
+        Assert.Equal(0, stats.Submitted);
+        Assert.Equal((float)_time, dropped->die);
+        Assert.Equal(0, dropped->flags & (int)TempEntityFlags.FTENT_FADEOUT);
+        Assert.True(persistent->die > _time);
+        Assert.True(hidden->die > _time);
+    }
+
+    [Fact]
+    public void VectorizedPathMatchesScalar()
+    {
+        var scalar = new TempEntitySimulator(_engine) { Vectorized = false };
+        var simd = new TempEntitySimulator(_engine) { Vectorized = true };
+        var rng = new Random(1234);
+        var a = new TEMPENTITY*[100];
+        var b = new TEMPENTITY*[a.Length];
+        for (int i = 0; i < a.Length; i++)
+        {
+            var origin = new Vector3(rng.Next(-512, 512), rng.Next(-512, 512), rng.Next(1, 256));
+            var velocity = new Vector3(rng.Next(-100, 100), rng.Next(-100, 100), rng.Next(-300, 300));
+            var flags = (i % 3) switch
+            {
+                0 => TempEntityFlags.FTENT_GRAVITY | TempEntityFlags.FTENT_ROTATE | TempEntityFlags.FTENT_COLLIDEWORLD,
+                1 => TempEntityFlags.FTENT_SLOWGRAVITY | TempEntityFlags.FTENT_COLLIDEWORLD,
+                _ => TempEntityFlags.FTENT_NONE,
+            };
+            a[i] = Spawn(origin, flags, velocity);
+        }
+        var scalarList = _active;
+        _active = null;
+        for (int i = 0; i < b.Length; i++)
+            b[i] = Spawn(a[i]->entity.origin, (TempEntityFlags)a[i]->flags, a[i]->entity.baseline.origin);
+        var simdList = _active;
+
+        double time = _time;
+        for (int frame = 0; frame < 200; frame++)
+        {
+            time += FrameTime;
+            TEMPENTITY* free = null;
+            scalar.Update(FrameTime, time, Gravity, &free, &scalarList, &AcceptVisibleEntity, &PlaySound);
+            simd.Update(FrameTime, time, Gravity, &free, &simdList, &AcceptVisibleEntity, &PlaySound);
+            Assert.Equal(scalar.LastFrame.Collided, simd.LastFrame.Collided);
+        }
+
+        Assert.True(scalar.LastFrame.Integrated > 0);
+        for (int i = 0; i < a.Length; i++)
+        {
+            Assert.Equal(a[i]->entity.origin, b[i]->entity.origin);
+            Assert.Equal(a[i]->entity.baseline.origin, b[i]->entity.baseline.origin);
+            Assert.Equal(a[i]->flags, b[i]->flags);
+        }
+    }
+
+    [Fact]
+    public void WarmFramesDoNotAllocate()
+    {
+        var simulator = new TempEntitySimulator(_engine);
+        for (int i = 0; i < 512; i++)
+            Spawn(new Vector3(i, 0, 100), TempEntityFlags.FTENT_GRAVITY | TempEntityFlags.FTENT_COLLIDEWORLD);
+        Frame(simulator);
+
+        long allocated = GC.GetAllocatedBytesForCurrentThread();
+        for (int i = 0; i < 20; i++)
+            Frame(simulator);
+
+        Assert.Equal(0, GC.GetAllocatedBytesForCurrentThread() - allocated);
+    }
+
+    public void Dispose()
+    {
+        NativeMemory.Free(_pool);
+        NativeMemory.Free(_eventApi);
+        NativeMemory.Free(_engine);
+    }
+
+    private TempEntityFrameStats Frame(TempEntitySimulator simulator) => Frame(simulator, &AcceptVisibleEntity);
+
+    private TempEntityFrameStats Frame(TempEntitySimulator simulator, delegate* unmanaged[Cdecl]<cl_entity_t*, int> addVisibleEntity)
+    {
+        TEMPENTITY* free = _free;
+        TEMPENTITY* active = _active;
+        simulator.Update(FrameTime, _time += FrameTime, Gravity, &free, &active, addVisibleEntity, &PlaySound);
+        _free = free;
+        _active = active;
+        return simulator.LastFrame;
+    }
+
+    // Appended to the active list, alive for ten seconds.
+    private TEMPENTITY* Spawn(Vector3 origin, TempEntityFlags flags, Vector3 velocity = default)
+    {
+        var tent = _pool + _spawned++;
+        tent->flags = (int)flags;
+        tent->die = (float)_time + 10;
+        tent->bounceFactor = 1;
+        tent->entity.origin = origin;
+        tent->entity.baseline.origin = velocity;
+
+        if (_active == null)
+        {
+            _active = tent;
+            return tent;
+        }
+        var last = _active;
+        while (last->next != null)
+            last = last->next;
+        last->next = tent;
+        return tent;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void SetUpPlayerPrediction(int dopred, int bIncludeLocalClient) { }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void PMStates() { }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void IntArgument(int value) { }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void FloorTrace(float* start, float* end, int traceFlags, int ignore_pe, pmtrace_t* tr)
+    {
+        *tr = default;
+        tr->fraction = 1;
+        tr->endpos = new Vector3(end[0], end[1], end[2]);
+        if (end[2] < 0 && start[2] >= 0)
+        {
+            tr->fraction = start[2] / (start[2] - end[2]);
+            tr->plane.normal = new Vector3(0, 0, 1);
+        }
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void Hit(TEMPENTITY* tent, pmtrace_t* trace)
+    {
+        s_hits++;
+        tent->flags = (tent->flags | s_hitSetFlags) & ~s_hitClearFlags;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int AcceptVisibleEntity(cl_entity_t* ent) => 1;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int RejectVisibleEntity(cl_entity_t* ent) => 0;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void PlaySound(TEMPENTITY* tent, float damp)
+    {
+        s_sounds++;
+        s_soundDamp = damp;
+    }
+}
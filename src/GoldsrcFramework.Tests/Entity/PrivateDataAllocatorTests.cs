@@ -0,0 +1,172 @@
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Entity;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public unsafe class PrivateDataAllocatorTests
+{
+    [Fact]
+    public void SlabChurnDoesNotAllocate()
+    {
+        const int Edicts = 256;
+        var sizes = new[] { 96, 224, 480 };
+        var edicts = AllocEdicts(Edicts);
+        var owners = Enumerable.Range(0, Edicts).Select(i => new object()).ToArray();
+        using var allocator = new PrivateDataAllocator();
+        try
+        {
+            var classes = sizes.Select((size, i) => allocator.RegisterClass($"projectile_{i}", size)).ToArray();
+            for (int i = 0; i < Edicts; i++)
+                allocator.Allocate(&edicts[i], classes[i % 3], owners[i]);
+
+            // Projectile churn: free the oldest and spawn into it, 1600 times.
+            long allocated = GC.GetAllocatedBytesForCurrentThread();
+            for (int n = 0; n < 1600; n++)
+            {
+                int i = n % Edicts;
+                Assert.True(allocator.Free(&edicts[i]));
+                allocator.Allocate(&edicts[i], classes[i % 3], owners[i]);
+            }
+            Assert.Equal(0, GC.GetAllocatedBytesForCurrentThread() - allocated);
+
+            var stats = allocator.Stats;
+            Assert.Equal(Edicts, stats.LiveBlocks);
+            Assert.Equal(1600, stats.Frees);
+            Assert.Equal(3, stats.Classes);
+            for (int i = 0; i < Edicts; i++)
+                Assert.Same(owners[i], allocator.GetOwner(&edicts[i]));
+        }
+        finally
+        {
+            for (int i = 0; i < Edicts; i++)
+                allocator.Free(&edicts[i]);
+            NativeMemory.Free(edicts);
+        }
+    }
+
+    [Fact]
+    public void FreedBlockIsReusedZeroed()
+    {
+        var edicts = AllocEdicts(2);
+        using var allocator = new PrivateDataAllocator();
+        try
+        {
+            int id = allocator.RegisterClass("monster_zombie", 64);
+            var owner = new object();
+            var data = (byte*)allocator.Allocate(&edicts[0], id, owner);
+            Assert.True(data == edicts[0].pvPrivateData);
+            Assert.Same(owner, allocator.GetOwner(&edicts[0]));
+            new Span<byte>(data, 64).Fill(0xCD);
+
+            Assert.True(allocator.Free(&edicts[0]));
+            Assert.True(edicts[0].pvPrivateData == null);
+
+            var again = (byte*)allocator.Allocate(&edicts[1], id, "next");
+            Assert.True(again == data);
+            Assert.Equal(-1, new Span<byte>(again, 64).IndexOfAnyExcept((byte)0));
+            Assert.Equal("next", allocator.GetOwner<string>(&edicts[1]));
+
+            var stats = allocator.Stats;
+            Assert.Equal(1, stats.LiveBlocks);
+            Assert.Equal(2, stats.Allocations);
+            Assert.Equal(1, stats.Frees);
+        }
+        finally
+        {
+            NativeMemory.Free(edicts);
+        }
+    }
+
+    [Fact]
+    public void ForeignPrivateDataIsLeftAlone()
+    {
+        var edicts = AllocEdicts(1);
+        using var allocator = new PrivateDataAllocator();
+        void* legacy = NativeMemory.AllocZeroed(64);
+        try
+        {
+            int id = allocator.RegisterClass("monster_zombie", 64);
+            edicts[0].pvPrivateData = legacy;
+
+            Assert.False(allocator.Owns(legacy));
+            Assert.Null(allocator.GetOwner(&edicts[0]));
+            Assert.False(allocator.Free(&edicts[0]));
+            Assert.True(edicts[0].pvPrivateData == legacy);
+            Assert.Throws<InvalidOperationException>(() => allocator.Allocate(&edicts[0], id));
+        }
+        finally
+        {
+            NativeMemory.Free(legacy);
+            NativeMemory.Free(edicts);
+        }
+    }
+
+    [Fact]
+    public void ClassesAreRegisteredOnce()
+    {
+        using var allocator = new PrivateDataAllocator();
+        int id = allocator.RegisterClass("weapon_crowbar", 100);
+
+        Assert.Equal(id, allocator.RegisterClass("weapon_crowbar", 100));
+        Assert.NotEqual(id, allocator.RegisterClass("weapon_9mmhandgun", 100));
+        Assert.Throws<InvalidOperationException>(() => allocator.RegisterClass("weapon_crowbar", 400));
+    }
+
+    [Fact]
+    public void ClassesDoNotShareSlabs()
+    {
+        var edicts = AllocEdicts(3);
+        using var allocator = new PrivateDataAllocator(arenaBytes: 64 << 10, slabBytes: 4096);
+        try
+        {
+            int small = allocator.RegisterClass("small", 32);
+            int other = allocator.RegisterClass("other", 32);
+            int huge = allocator.RegisterClass("huge", 10000);
+            allocator.Allocate(&edicts[0], small);
+            allocator.Allocate(&edicts[1], other);
+            allocator.Allocate(&edicts[2], huge);
+
+            var classes = allocator.ClassStats();
+            Assert.All(classes, c => Assert.Equal(1, c.Slabs));
+            Assert.Equal(4096 + 4096 + classes[huge].BlockSize, allocator.Stats.SlabBytes);
+            Assert.Equal(1, allocator.Stats.Arenas);
+        }
+        finally
+        {
+            NativeMemory.Free(edicts);
+        }
+    }
+
+    [Fact]
+    public void FreeAfterResetOnlyUnlinks()
+    {
+        var edicts = AllocEdicts(2);
+        using var allocator = new PrivateDataAllocator();
+        try
+        {
+            int id = allocator.RegisterClass("monster_zombie", 64);
+            allocator.Allocate(&edicts[0], id, "old level");
+            allocator.Reset();
+
+            Assert.Null(allocator.GetOwner(&edicts[0]));
+            allocator.Allocate(&edicts[1], id, "new level");
+            Assert.True(allocator.Free(&edicts[0]));
+            Assert.True(edicts[0].pvPrivateData == null);
+
+            // The new level's block is untouched by the stale free.
+            Assert.Equal("new level", allocator.GetOwner(&edicts[1]));
+            var stats = allocator.Stats;
+            Assert.Equal(1, stats.StaleFrees);
+            Assert.Equal(1, stats.Resets);
+            Assert.Equal(1, stats.LiveBlocks);
+        }
+        finally
+        {
+            NativeMemory.Free(edicts);
+        }
+    }
+
+    private static edict_t* AllocEdicts(int count) => (edict_t*)NativeMemory.AllocZeroed((nuint)count, (nuint)sizeof(edict_t));
+}
@@ -0,0 +1,414 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Graphics;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public unsafe class TriangleBatcherTests
+{
+    private const int kRenderNormal = 0;
+    private const int kRenderTransTexture = 2;
+    private const int kRenderTransAdd = 5;
+
+    private static readonly model_t* s_spriteA = (model_t*)0x10000;
+    private static readonly model_t* s_spriteB = (model_t*)0x20000;
+
+    private static readonly List<DrawnVertex> s_drawn = new();
+    private static DrawnVertex s_current;
+    private static int s_calls, s_begins;
+
+    // A vertex as the engine draws it, with the state it was emitted in.
+    private record struct DrawnVertex(int Mode, nint Texture, int Frame, float R, float G, float B, float A, float U, float V, float X, float Y, float Z);
+
+    [Fact]
+    public void BatchedFrameDrawsTheSameGeometryWithFewerCalls()
+    {
+        var previous = TriangleReplay.NativeReplay;
+        TriangleReplay.NativeReplay = null;
+        var triApi = (triangleapi_t*)NativeMemory.AllocZeroed((nuint)sizeof(triangleapi_t));
+        try
+        {
+            triApi->RenderMode = &RecordRenderMode;
+            triApi->SpriteTexture = &RecordSpriteTexture;
+            triApi->CullFace = &RecordCullFace;
+            triApi->Begin = &RecordBegin;
+            triApi->End = &RecordEnd;
+            triApi->Color4f = &RecordColor;
+            triApi->TexCoord2f = &RecordTexCoord;
+            triApi->Vertex3f = &RecordVertex;
+
+            var (direct, directCalls, directBegins) = Record(() => EffectsFrame(new DirectTriangles(triApi)));
+            var batcher = new TriangleBatcher();
+            var (batched, batchedCalls, batchedBegins) = Record(() =>
+            {
+                EffectsFrame(new BatchedTriangles(batcher));
+                batcher.Flush(triApi);
+            });
+
+            // Same vertices in the same state; alpha-blended ones also in the same order.
+            Assert.Equal(Sorted(direct), Sorted(batched));
+            Assert.Equal(direct.Where(v => v.Mode == kRenderTransTexture), batched.Where(v => v.Mode == kRenderTransTexture));
+            Assert.True(batchedCalls < directCalls);
+            Assert.True(batchedBegins < directBegins);
+        }
+        finally
+        {
+            TriangleReplay.NativeReplay = previous;
+            NativeMemory.Free(triApi);
+        }
+    }
+
+    [Fact]
+    public void UnsetColorAndTexCoordAreNotSent()
+    {
+        var batcher = new TriangleBatcher();
+        batcher.RenderMode(kRenderNormal);
+        Triangle(batcher, 0);
+
+        var ops = Ops(batcher.EncodePending());
+
+        Assert.DoesNotContain(TriangleOp.Color, ops);
+        Assert.DoesNotContain(TriangleOp.TexCoord, ops);
+        Assert.Equal(3, ops.Count(op => op == TriangleOp.Vertex));
+    }
+
+    [Fact]
+    public void RepeatedColorIsSentOnce()
+    {
+        var batcher = new TriangleBatcher();
+        batcher.Color4f(1, 0, 0, 1);
+        Triangle(batcher, 0);
+        Triangle(batcher, 1);
+
+        var ops = Ops(batcher.EncodePending());
+
+        Assert.Equal(1, ops.Count(op => op == TriangleOp.Color));
+        Assert.Equal(1, ops.Count(op => op == TriangleOp.Begin));
+    }
+
+    [Fact]
+    public void AdditiveRunsMergeByTextureAndAlphaKeepsItsOrder()
+    {
+        var batcher = new TriangleBatcher();
+        batcher.Color4f(1, 1, 1, 1);
+        batcher.TexCoord2f(0, 0);
+        batcher.RenderMode(kRenderTransAdd);
+        foreach (var sprite in new[] { s_spriteA, s_spriteB, s_spriteA })
+        {
+            batcher.SpriteTexture(sprite, 0);
+            Triangle(batcher, 0);
+        }
+
+        batcher.RenderMode(kRenderTransTexture);
+        foreach (var sprite in new[] { s_spriteB, s_spriteA, s_spriteB })
+        {
+            batcher.SpriteTexture(sprite, 0);
+            Triangle(batcher, 0);
+        }
+
+        var textures = Textures(batcher.EncodePending());
+
+        // Additive A, A, B; the first alpha primitive reuses B.
+        Assert.Equal(new[] { (nint)s_spriteA, (nint)s_spriteB, (nint)s_spriteA, (nint)s_spriteB }, textures);
+    }
+
+    [Fact]
+    public void PrimitivesWithoutColorAreNotSortedBehindColoredOnes()
+    {
+        var batcher = new TriangleBatcher();
+        batcher.RenderMode(kRenderTransAdd);
+        Triangle(batcher, 0);
+        batcher.RenderMode(kRenderNormal);
+        batcher.Color4f(1, 0, 0, 1);
+        batcher.TexCoord2f(0, 0);
+        Triangle(batcher, 1);
+
+        var ops = Ops(batcher.EncodePending());
+
+        // The additive triangle sorts after the normal one by mode, but it draws in the engine's color, not red.
+        Assert.Equal(new[] { 0f, 1f }, VertexDepths(batcher.EncodePending()).Distinct());
+        Assert.True(ops.IndexOf(TriangleOp.Vertex) < ops.IndexOf(TriangleOp.Color));
+    }
+
+    [Fact]
+    public void PrimitivesWithoutTexCoordsAreNotSortedBehindTexturedOnes()
+    {
+        var batcher = new TriangleBatcher();
+        batcher.Color4f(1, 1, 1, 1);
+        batcher.RenderMode(kRenderTransAdd);
+        Triangle(batcher, 0);
+        batcher.RenderMode(kRenderNormal);
+        batcher.TexCoord2f(0.5f, 0.5f);
+        Triangle(batcher, 1);
+
+        Assert.Equal(new[] { 0f, 1f }, VertexDepths(batcher.EncodePending()).Distinct());
+    }
+
+    [Fact]
+    public void FlushResetsRecordedAttributes()
+    {
+        var previous = TriangleReplay.NativeReplay;
+        TriangleReplay.NativeReplay = null;
+        var triApi = (triangleapi_t*)NativeMemory.AllocZeroed((nuint)sizeof(triangleapi_t));
+        try
+        {
+            triApi->RenderMode = &Ignore;
+            triApi->CullFace = &IgnoreCull;
+            triApi->Begin = &Ignore;
+            triApi->End = &IgnoreEnd;
+            triApi->Color4f = &IgnoreColor;
+            triApi->Vertex3f = &IgnoreVertex;
+
+            var batcher = new TriangleBatcher();
+            batcher.Color4f(1, 1, 1, 1);
+            Triangle(batcher, 0);
+            batcher.Flush(triApi);
+
+            Assert.Equal(1, batcher.LastFlush.Primitives);
+            Assert.Equal(0, batcher.PendingPrimitives);
+
+            Triangle(batcher, 0);
+            Assert.DoesNotContain(TriangleOp.Color, Ops(batcher.EncodePending()));
+        }
+        finally
+        {
+            TriangleReplay.NativeReplay = previous;
+            NativeMemory.Free(triApi);
+        }
+    }
+
+    [Fact]
+    public void FlushInsideAPrimitiveThrows()
+    {
+        var batcher = new TriangleBatcher();
+        batcher.Begin(TriPrimitive.Triangles);
+
+        Assert.Throws<InvalidOperationException>(() => batcher.Flush(null));
+    }
+
+    // Additive particles cycling through two sprites, beam strips, then alpha sprites drawn back to front.
+    private static void EffectsFrame(ITriangles tri)
+    {
+        for (int i = 0; i < 24; i++)
+        {
+            tri.RenderMode(kRenderTransAdd);
+            tri.SpriteTexture(i % 2 == 0 ? s_spriteA : s_spriteB, i & 1);
+            tri.Begin(TriPrimitive.Quads);
+            tri.Color4f(1, (i & 3) / 4f, 0, 0.5f);
+            tri.TexCoord2f(0, 0); tri.Vertex3f(i, 0, 0);
+            tri.TexCoord2f(0, 1); tri.Vertex3f(i, 4, 0);
+            tri.TexCoord2f(1, 1); tri.Vertex3f(i + 4, 4, 0);
+            tri.TexCoord2f(1, 0); tri.Vertex3f(i + 4, 0, 0);
+            tri.End();
+        }
+
+        for (int i = 0; i < 4; i++)
+        {
+            tri.RenderMode(kRenderTransAdd);
+            tri.SpriteTexture(s_spriteB, 0);
+            tri.Begin(TriPrimitive.TriangleStrip);
+            tri.Color4f(0.2f, 0.6f, 1, 1);
+            for (int s = 0; s < 3; s++)
+            {
+                tri.TexCoord2f(0, s); tri.Vertex3f(i, s * 8, 1);
+                tri.TexCoord2f(1, s); tri.Vertex3f(i + 2, s * 8, 1);
+            }
+            tri.End();
+        }
+
+        for (int i = 0; i < 6; i++)
+        {
+            tri.RenderMode(kRenderTransTexture);
+            tri.SpriteTexture(i % 2 == 0 ? s_spriteB : s_spriteA, 0);
+            tri.Begin(TriPrimitive.Quads);
+            tri.Color4f(1, 1, 1, (i & 3) / 4f);
+            tri.TexCoord2f(0, 0); tri.Vertex3f(0, 0, 6 - i);
+            tri.TexCoord2f(0, 1); tri.Vertex3f(0, 8, 6 - i);
+            tri.TexCoord2f(1, 1); tri.Vertex3f(8, 8, 6 - i);
+            tri.TexCoord2f(1, 0); tri.Vertex3f(8, 0, 6 - i);
+            tri.End();
+        }
+
+        tri.RenderMode(kRenderNormal);
+    }
+
+    private static (List<DrawnVertex> Vertices, int Calls, int Begins) Record(Action draw)
+    {
+        s_drawn.Clear();
+        s_current = new DrawnVertex(kRenderNormal, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0);
+        s_calls = s_begins = 0;
+        draw();
+        return (s_drawn.ToList(), s_calls, s_begins);
+    }
+
+    private static IEnumerable<DrawnVertex> Sorted(List<DrawnVertex> vertices)
+        => vertices.OrderBy(v => (v.Mode, v.Texture, v.Frame, v.R, v.G, v.B, v.A, v.U, v.V, v.X, v.Y, v.Z));
+
+    private static void Triangle(TriangleBatcher batcher, float z)
+    {
+        batcher.Begin(TriPrimitive.Triangles);
+        batcher.Vertex3f(0, 0, z);
+        batcher.Vertex3f(1, 0, z);
+        batcher.Vertex3f(0, 1, z);
+        batcher.End();
+    }
+
+    private static List<TriangleOp> Ops(ReadOnlySpan<byte> stream)
+    {
+        var ops = new List<TriangleOp>();
+        Walk(stream, (op, _) => ops.Add(op));
+        return ops;
+    }
+
+    private static List<nint> Textures(ReadOnlySpan<byte> stream)
+    {
+        var textures = new List<nint>();
+        Walk(stream, (op, args) =>
+        {
+            if (op == TriangleOp.Texture)
+                textures.Add((nint)BitConverter.ToUInt64(args));
+        });
+        return textures;
+    }
+
+    private static List<float> VertexDepths(ReadOnlySpan<byte> stream)
+    {
+        var depths = new List<float>();
+        Walk(stream, (op, args) =>
+        {
+            if (op == TriangleOp.Vertex)
+                depths.Add(BitConverter.ToSingle(args, 8));
+        });
+        return depths;
+    }
+
+    private static void Walk(ReadOnlySpan<byte> stream, Action<TriangleOp, byte[]> visit)
+    {
+        int pos = 0;
+        while (pos < stream.Length)
+        {
+            var op = (TriangleOp)stream[pos++];
+            int size = op switch
+            {
+                TriangleOp.RenderMode or TriangleOp.Begin or TriangleOp.CullFace => 4,
+                TriangleOp.End => 0,
+                TriangleOp.Texture or TriangleOp.Vertex => 12,
+                TriangleOp.Color => 16,
+                TriangleOp.TexCoord => 8,
+                _ => throw new InvalidDataException($"Unknown op {op}"),
+            };
+            visit(op, stream.Slice(pos, size).ToArray());
+            pos += size;
+        }
+    }
+
+    private interface ITriangles
+    {
+        void RenderMode(int mode);
+        void SpriteTexture(model_t* sprite, int frame);
+        void Begin(TriPrimitive primitive);
+        void Color4f(float r, float g, float b, float a);
+        void TexCoord2f(float u, float v);
+        void Vertex3f(float x, float y, float z);
+        void End();
+    }
+
+    private sealed class DirectTriangles(triangleapi_t* tri) : ITriangles
+    {
+        public void RenderMode(int mode) => tri->RenderMode(mode);
+        public void SpriteTexture(model_t* sprite, int frame) => tri->SpriteTexture(sprite, frame);
+        public void Begin(TriPrimitive primitive) => tri->Begin((int)primitive);
+        public void Color4f(float r, float g, float b, float a) => tri->Color4f(r, g, b, a);
+        public void TexCoord2f(float u, float v) => tri->TexCoord2f(u, v);
+        public void Vertex3f(float x, float y, float z) => tri->Vertex3f(x, y, z);
+        public void End() => tri->End();
+    }
+
+    private sealed class BatchedTriangles(TriangleBatcher batcher) : ITriangles
+    {
+        public void RenderMode(int mode) => batcher.RenderMode(mode);
+        public void SpriteTexture(model_t* sprite, int frame) => batcher.SpriteTexture(sprite, frame);
+        public void Begin(TriPrimitive primitive) => batcher.Begin(primitive);
+        public void Color4f(float r, float g, float b, float a) => batcher.Color4f(r, g, b, a);
+        public void TexCoord2f(float u, float v) => batcher.TexCoord2f(u, v);
+        public void Vertex3f(float x, float y, float z) => batcher.Vertex3f(x, y, z);
+        public void End() => batcher.End();
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void RecordRenderMode(int mode)
+    {
+        s_calls++;
+        s_current.Mode = mode;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int RecordSpriteTexture(model_t* sprite, int frame)
+    {
+        s_calls++;
+        s_current.Texture = (nint)sprite;
+        s_current.Frame = frame;
+        return 1;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void RecordCullFace(TRICULLSTYLE style) => s_calls++;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void RecordBegin(int primitive)
+    {
+        s_calls++;
+        s_begins++;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void RecordEnd() => s_calls++;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void RecordColor(float r, float g, float b, float a)
+    {
+        s_calls++;
+        (s_current.R, s_current.G, s_current.B, s_current.A) = (r, g, b, a);
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void RecordTexCoord(float u, float v)
+    {
+        s_calls++;
+        (s_current.U, s_current.V) = (u, v);
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void RecordVertex(float x, float y, float z)
+    {
+        s_calls++;
+        s_drawn.Add(s_current with { X = x, Y = y, Z = z });
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void Ignore(int value)
+    {
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void IgnoreEnd()
+    {
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void IgnoreCull(TRICULLSTYLE style)
+    {
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void IgnoreColor(float r, float g, float b, float a)
+    {
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void IgnoreVertex(float x, float y, float z)
+    {
+    }
+}
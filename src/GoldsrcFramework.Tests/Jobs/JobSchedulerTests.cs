@@ -0,0 +1,185 @@
+using GoldsrcFramework.Jobs;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public class JobSchedulerTests
+{
+    private struct SquareJob : IJobRange
+    {
+        public float[] Input;
+        public float[] Output;
+
+        public void Execute(int start, int end)
+        {
+            for (int i = start; i < end; i++)
+                Output[i] = MathF.Sqrt(Input[i] * Input[i] + 1);
+        }
+    }
+
+    private struct PartialSumJob : IJob
+    {
+        public float[] Values;
+        public double[] Sums;
+        public int Index;
+
+        public void Execute()
+        {
+            int count = Values.Length / Sums.Length;
+            double sum = 0;
+            foreach (float v in Values.AsSpan(Index * count, count))
+                sum += v;
+            Sums[Index] = sum;
+        }
+    }
+
+    private struct ReduceJob : IJob
+    {
+        public double[] Sums;
+        public double[] Result;
+
+        public void Execute() => Result[0] = Sums.Sum();
+    }
+
+    [Fact]
+    public void StructParallelForMatchesASerialLoop()
+    {
+        using var scheduler = new JobScheduler(2);
+        var input = Values(1 << 16);
+        var output = new float[input.Length];
+        var expected = new float[input.Length];
+        new SquareJob { Input = input, Output = expected }.Execute(0, input.Length);
+
+        for (int frame = 0; frame < 5; frame++)
+        {
+            Array.Clear(output);
+            scheduler.ParallelFor(new SquareJob { Input = input, Output = output }, input.Length);
+            scheduler.CompleteFrame();
+
+            Assert.Equal(expected, output);
+        }
+    }
+
+    [Fact]
+    public void StructFanOutReducesWhatASerialLoopSums()
+    {
+        using var scheduler = new JobScheduler(2);
+        var values = Values(256 * 64);
+        var sums = new double[256];
+        var result = new double[1];
+        var handles = new JobHandle[sums.Length];
+
+        for (int i = 0; i < sums.Length; i++)
+            new PartialSumJob { Values = values, Sums = sums, Index = i }.Execute();
+        double expected = sums.Sum();
+
+        for (int frame = 0; frame < 5; frame++)
+        {
+            Array.Clear(sums);
+            result[0] = 0;
+            for (int i = 0; i < sums.Length; i++)
+                handles[i] = scheduler.Schedule(new PartialSumJob { Values = values, Sums = sums, Index = i });
+            scheduler.Schedule(new ReduceJob { Sums = sums, Result = result }, scheduler.CombineDependencies(handles));
+            scheduler.CompleteFrame();
+
+            Assert.Equal(expected, result[0]);
+        }
+    }
+
+    [Fact]
+    public void WorkersStartOnTheFirstJob()
+    {
+        using var scheduler = new JobScheduler(2);
+        scheduler.CompleteFrame();
+        Assert.False(scheduler.IsStarted);
+
+        int ran = 0;
+        scheduler.Schedule(() => ran++).Complete();
+        Assert.True(scheduler.IsStarted);
+        Assert.Equal(1, ran);
+    }
+
+    [Fact]
+    public void DependentsRunAfterTheirDependencies()
+    {
+        using var scheduler = new JobScheduler(3);
+        var values = new int[16];
+        var handles = new JobHandle[values.Length];
+        int total = 0;
+
+        for (int round = 0; round < 20; round++)
+        {
+            for (int i = 0; i < values.Length; i++)
+            {
+                int index = i;
+                var first = scheduler.Schedule(() => values[index] = index + 1);
+                handles[i] = scheduler.Schedule(() => values[index] *= 2, first);
+            }
+            scheduler.Schedule(() => total = values.Sum(), scheduler.CombineDependencies(handles));
+            scheduler.CompleteFrame();
+
+            Assert.Equal(Enumerable.Range(1, values.Length).Sum() * 2, total);
+            Assert.True(handles[0].IsCompleted);
+        }
+
+        var stats = scheduler.Stats;
+        Assert.Equal(20, stats.Frames);
+        Assert.Equal(0, stats.Faults);
+    }
+
+    [Fact]
+    public void ParallelForCoversEveryIndexOnce()
+    {
+        using var scheduler = new JobScheduler(3);
+        var counts = new int[10_000];
+
+        scheduler.ParallelFor(counts.Length, (start, end) =>
+        {
+            for (int i = start; i < end; i++)
+                Interlocked.Increment(ref counts[i]);
+        }, batchSize: 64);
+        scheduler.CompleteFrame();
+
+        Assert.All(counts, count => Assert.Equal(1, count));
+    }
+
+    [Fact]
+    public void FullFrameRunsJobsInline()
+    {
+        // 64 is the fewest slots a scheduler has.
+        using var scheduler = new JobScheduler(2, jobsPerFrame: 64);
+        int ran = 0;
+        for (int i = 0; i < 100; i++)
+            scheduler.Schedule(() => Interlocked.Increment(ref ran));
+        scheduler.CompleteFrame();
+
+        var stats = scheduler.Stats;
+        Assert.Equal(100, ran);
+        Assert.Equal(36, stats.Inline);
+        Assert.Equal(100, stats.Jobs);
+        Assert.Equal(100, stats.PeakJobsPerFrame);
+    }
+
+    [Fact]
+    public void FaultingJobStillReleasesItsDependents()
+    {
+        using var scheduler = new JobScheduler(2);
+        bool ran = false;
+
+        var fault = scheduler.Schedule(() => throw new InvalidOperationException("test"));
+        scheduler.Schedule(() => ran = true, fault);
+        scheduler.CompleteFrame();
+
+        Assert.True(ran);
+        Assert.Equal(1, scheduler.Stats.Faults);
+    }
+
+    private static float[] Values(int count)
+    {
+        var rng = new Random(1234);
+        var values = new float[count];
+        for (int i = 0; i < values.Length; i++)
+            values[i] = rng.NextSingle() * 100;
+        return values;
+    }
+}
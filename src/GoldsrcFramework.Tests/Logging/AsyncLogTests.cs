@@ -0,0 +1,212 @@
+using System.Collections.Concurrent;
+using GoldsrcFramework.Logging;
+using Microsoft.Extensions.Logging;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public class AsyncLogTests
+{
+    private enum Team
+    {
+        Red,
+        Blue,
+    }
+
+    private const string Category = nameof(AsyncLogTests);
+    private static readonly LogTemplate s_spawn = AsyncLog.Define(LogLevel.Information, Category, "{Class} #{Index} at {X:F1}");
+    private static readonly LogTemplate s_braces = AsyncLog.Define(LogLevel.Information, Category, "{{literal}} {A} {B} {C}");
+    private static readonly LogTemplate s_trace = AsyncLog.Define(LogLevel.Trace, Category, "trace {A}");
+
+    [Fact]
+    public void TemplateWritesDoNotAllocateAndAllReachTheSink()
+    {
+        var sink = new MemorySink();
+        AsyncLog.Start(LogLevel.Information, new ILogSink[] { sink });
+        const int calls = AsyncLog.DefaultRingCapacity / 2;
+        try
+        {
+            // The first write on a thread creates its ring.
+            AsyncLog.Write(s_spawn, "monster_scientist", -1, 0f);
+            AsyncLog.Flush();
+            long dropped = AsyncLog.Stats.Dropped;
+
+            long allocated = GC.GetAllocatedBytesForCurrentThread();
+            for (int i = 0; i < calls; i++)
+                AsyncLog.Write(s_spawn, "monster_scientist", i, i * 0.5f);
+            Assert.Equal(0, GC.GetAllocatedBytesForCurrentThread() - allocated);
+
+            AsyncLog.Flush();
+            Assert.Equal(dropped, AsyncLog.Stats.Dropped);
+        }
+        finally
+        {
+            AsyncLog.Stop();
+        }
+
+        var lines = sink.Lines(Category);
+        Assert.Equal(calls + 1, lines.Length);
+        Assert.EndsWith($": monster_scientist #{calls - 1} at {(calls - 1) * 0.5f:F1}", lines[^1]);
+        Assert.False(AsyncLog.IsRunning);
+    }
+
+    [Fact]
+    public void LinesAreFormattedOnTheLogThread()
+    {
+        var sink = new MemorySink();
+        AsyncLog.Start(LogLevel.Information, new ILogSink[] { sink });
+        try
+        {
+            AsyncLog.Write(s_spawn, "monster_zombie", 7, 2.5f);
+            AsyncLog.Write(s_braces, Team.Blue, true, 'x');
+            AsyncLog.Flush();
+        }
+        finally
+        {
+            AsyncLog.Stop();
+        }
+
+        var lines = sink.Lines(Category);
+        Assert.Equal(2, lines.Length);
+        Assert.EndsWith($" info {Category}: monster_zombie #7 at 2.5", lines[0]);
+        Assert.EndsWith($" info {Category}: {{literal}} Blue true x", lines[1]);
+        Assert.True(sink.Disposed);
+    }
+
+    [Fact]
+    public void RecordsBelowTheLevelAreNotWritten()
+    {
+        var sink = new MemorySink();
+        AsyncLog.Start(LogLevel.Debug, new ILogSink[] { sink });
+        try
+        {
+            Assert.False(AsyncLog.IsEnabled(LogLevel.Trace));
+            Assert.True(AsyncLog.IsEnabled(LogLevel.Debug));
+            AsyncLog.Write(s_trace, 1);
+            AsyncLog.Flush();
+        }
+        finally
+        {
+            AsyncLog.Stop();
+        }
+
+        Assert.Empty(sink.Lines(Category));
+        Assert.False(AsyncLog.IsEnabled(LogLevel.Critical));
+    }
+
+    [Fact]
+    public void FullRingDropsAndReportsIt()
+    {
+        var sink = new MemorySink();
+        AsyncLog.Start(LogLevel.Information, new ILogSink[] { sink }, ringCapacity: 16);
+        try
+        {
+            long before = AsyncLog.Stats.Dropped;
+
+            // A fresh thread gets a ring of the configured size.
+            var thread = new Thread(() =>
+            {
+                for (int i = 0; i < 1000; i++)
+                    AsyncLog.Write(s_spawn, "monster_headcrab", i, 0f);
+            });
+            thread.Start();
+            thread.Join();
+            AsyncLog.Flush();
+
+            long dropped = AsyncLog.Stats.Dropped - before;
+            Assert.True(dropped > 0);
+            Assert.Equal(1000 - dropped, sink.Lines(Category).Length);
+            Assert.Contains(sink.Lines("AsyncLog"), line => line.Contains(" records (") && line.Contains("fell behind"));
+        }
+        finally
+        {
+            AsyncLog.Stop();
+        }
+    }
+
+    [Fact]
+    public void LoggerProviderDefersFormatting()
+    {
+        var sink = new MemorySink();
+        AsyncLog.Start(LogLevel.Information, new ILogSink[] { sink });
+        try
+        {
+            using var factory = LoggerFactory.Create(builder => builder.SetMinimumLevel(LogLevel.Information).AddProvider(new AsyncLoggerProvider()));
+            var logger = factory.CreateLogger(Category);
+            var value = new FormatCounter();
+
+            logger.LogInformation("value {Value}", value);
+            logger.LogDebug("hidden {Value}", value);
+            Assert.Equal(0, value.Calls);
+
+            AsyncLog.Flush();
+            Assert.Equal(1, value.Calls);
+        }
+        finally
+        {
+            AsyncLog.Stop();
+        }
+
+        var lines = sink.Lines(Category);
+        Assert.Single(lines);
+        Assert.EndsWith($" info {Category}: value formatted", lines[0]);
+    }
+
+    [Fact]
+    public void RotatingFileKeepsMaxFiles()
+    {
+        string directory = Path.Combine(Path.GetTempPath(), "gsf-asynclog-test-" + Environment.ProcessId);
+        try
+        {
+            var path = Path.Combine(directory, "game.log");
+            using (var sink = new RotatingFileLogSink(path, maxBytes: 4096, maxFiles: 3))
+            {
+                var line = new string('x', 1000);
+                for (int i = 0; i < 20; i++)
+                    sink.WriteLine(line);
+                sink.Flush();
+                Assert.True(sink.Rotations >= 4);
+            }
+
+            Assert.True(File.Exists(path));
+            Assert.True(File.Exists(Path.Combine(directory, "game.1.log")));
+            Assert.True(File.Exists(Path.Combine(directory, "game.2.log")));
+            Assert.False(File.Exists(Path.Combine(directory, "game.3.log")));
+            Assert.True(new FileInfo(Path.Combine(directory, "game.1.log")).Length >= 4096);
+        }
+        finally
+        {
+            if (Directory.Exists(directory))
+                Directory.Delete(directory, recursive: true);
+        }
+    }
+
+    private sealed class FormatCounter
+    {
+        public int Calls;
+
+        public override string ToString()
+        {
+            Calls++;
+            return "formatted";
+        }
+    }
+
+    // Other tests may log through the process-wide AsyncLog while one of these runs, so lines are picked by category.
+    private sealed class MemorySink : ILogSink
+    {
+        private readonly ConcurrentQueue<string> _lines = new();
+
+        public bool Disposed { get; private set; }
+
+        public string[] Lines(string category) => _lines.Where(line => line.Contains($" {category}: ")).ToArray();
+
+        public void WriteLine(ReadOnlySpan<char> line) => _lines.Enqueue(line.ToString());
+
+        public void Flush()
+        {
+        }
+
+        public void Dispose() => Disposed = true;
+    }
+}
@@ -0,0 +1,216 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Messages;
+using NativeInterop;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public unsafe class MessageWriterTests
+{
+    private const int MSG_ONE = 1;
+
+    [ThreadStatic]
+    private static List<string>? t_calls;
+
+    [Fact]
+    public void BurstLargerThanTheBufferReachesTheEngineUnchanged()
+    {
+        var previous = MessageReplay.NativeReplay;
+        MessageReplay.NativeReplay = null;
+        using var engine = new RecordingEngine();
+        try
+        {
+            var direct = new MessageWriter(stackalloc byte[64], engine.Funcs);
+            Burst(ref direct);
+            var directCalls = engine.TakeCalls();
+
+            var batched = new MessageWriter(stackalloc byte[64], direct: null);
+            Burst(ref batched);
+            Assert.Empty(engine.TakeCalls());
+            Assert.Equal(64, batched.MessageCount);
+            Assert.True(batched.Written.Length > 64);
+
+            batched.Flush(engine.Funcs);
+            batched.Dispose();
+
+            Assert.Equal(directCalls, engine.TakeCalls());
+        }
+        finally
+        {
+            MessageReplay.NativeReplay = previous;
+        }
+
+        // A scoreboard and HUD line per player to every client.
+        static void Burst(ref MessageWriter msg)
+        {
+            for (int to = 1; to <= 4; to++)
+            {
+                for (int player = 1; player <= 8; player++)
+                {
+                    msg.Begin(MSG_ONE, 85, null, (edict_t*)(0x1000 * to));
+                    msg.WriteByte(player);
+                    msg.WriteShort(player * 10);
+                    msg.WriteShort(-player);
+                    msg.End();
+
+                    msg.Begin(MSG_ONE, 86, null, (edict_t*)(0x1000 * to));
+                    msg.WriteCoord(player * 0.5f);
+                    msg.WriteString("#Player_Scored"u8);
+                    msg.End();
+                }
+            }
+        }
+    }
+
+    [Fact]
+    public void BatchedAndDirectWritersMakeTheSameCalls()
+    {
+        using var engine = new RecordingEngine();
+        var edict = (edict_t*)0x1000;
+
+        var direct = new MessageWriter(stackalloc byte[64], engine.Funcs);
+        Assert.False(direct.IsBatching);
+        Write(ref direct, edict);
+        Assert.True(direct.Written.IsEmpty);
+        var directCalls = engine.TakeCalls();
+
+        var batched = new MessageWriter(stackalloc byte[16], direct: null);
+        Assert.True(batched.IsBatching);
+        Write(ref batched, edict);
+        Assert.Empty(engine.TakeCalls());
+        Assert.Equal(2, batched.MessageCount);
+        Assert.Equal(10, MessageReplay.Validate(batched.Written));
+
+        batched.Flush(engine.Funcs);
+        batched.Dispose();
+
+        Assert.Equal(directCalls, engine.TakeCalls());
+        Assert.Equal("Begin 1 85 1000", directCalls[0]);
+        Assert.Contains("String héllo", directCalls);
+
+        static void Write(ref MessageWriter msg, edict_t* edict)
+        {
+            msg.Begin(MSG_ONE, 85, null, edict);
+            msg.WriteByte(3);
+            msg.WriteShort(-2);
+            msg.WriteString("héllo\0ignored");
+            msg.End();
+
+            msg.Begin(MSG_ONE, 86, null, edict);
+            msg.WriteCoord(1.5f);
+            msg.WriteString("#Text"u8);
+            msg.WriteEntity(7);
+            msg.End();
+        }
+    }
+
+    [Fact]
+    public void WriterRejectsMisplacedCalls()
+    {
+        Assert.Throws<InvalidOperationException>(() =>
+        {
+            var msg = new MessageWriter(stackalloc byte[64], direct: null);
+            msg.WriteByte(1);
+        });
+        Assert.Throws<InvalidOperationException>(() =>
+        {
+            var msg = new MessageWriter(stackalloc byte[64], direct: null);
+            msg.Begin(MSG_ONE, 85);
+            msg.Begin(MSG_ONE, 85);
+        });
+        Assert.Throws<InvalidOperationException>(() =>
+        {
+            var msg = new MessageWriter(stackalloc byte[64], direct: null);
+            msg.Begin(MSG_ONE, 85);
+            msg.Flush(null);
+        });
+    }
+
+    [Fact]
+    public void ValidateRejectsMalformedStreams()
+    {
+        byte[] begin = [(byte)MessageOp.Begin, .. new byte[29]];
+        byte[] end = [(byte)MessageOp.End];
+        byte[] write = [(byte)MessageOp.Byte, 1, 0, 0, 0];
+
+        Assert.Equal(3, MessageReplay.Validate([.. begin, .. write, .. end]));
+        Assert.Equal(0, MessageReplay.Validate([]));
+
+        Assert.Equal(-1, MessageReplay.Validate(write));
+        Assert.Equal(-1, MessageReplay.Validate(end));
+        Assert.Equal(-1, MessageReplay.Validate([.. begin, .. begin, .. end]));
+        Assert.Equal(-1, MessageReplay.Validate([.. begin, .. write]));
+        Assert.Equal(-1, MessageReplay.Validate([.. begin, (byte)MessageOp.String, 65, 66]));
+        Assert.Equal(-1, MessageReplay.Validate([.. begin, (byte)MessageOp.Short, 1, 0]));
+        Assert.Equal(-1, MessageReplay.Validate([.. begin, 99, .. end]));
+        Assert.Equal(-1, MessageReplay.Validate(begin.AsSpan(0, 20)));
+    }
+
+    [Fact]
+    public void MalformedStreamMakesNoEngineCalls()
+    {
+        using var engine = new RecordingEngine();
+        byte[] stream = [(byte)MessageOp.Begin, .. new byte[29], (byte)MessageOp.Byte, 1, 0, 0, 0];
+
+        Assert.Equal(-1, MessageReplay.ReplayManaged(engine.Funcs, stream));
+        Assert.Empty(engine.TakeCalls());
+    }
+
+    /// <summary>
+    /// Engine table whose message functions log what they receive on the calling thread.
+    /// </summary>
+    private sealed class RecordingEngine : IDisposable
+    {
+        public readonly ServerEngineFuncs* Funcs;
+
+        public RecordingEngine()
+        {
+            t_calls = new List<string>();
+            Funcs = (ServerEngineFuncs*)NativeMemory.AllocZeroed((nuint)sizeof(ServerEngineFuncs));
+            Funcs->MessageBegin = &MessageBegin;
+            Funcs->MessageEnd = &MessageEnd;
+            Funcs->WriteByte = &WriteByte;
+            Funcs->WriteShort = &WriteShort;
+            Funcs->WriteEntity = &WriteEntity;
+            Funcs->WriteCoord = &WriteCoord;
+            Funcs->WriteString = &WriteString;
+        }
+
+        public List<string> TakeCalls()
+        {
+            var calls = t_calls!;
+            t_calls = new List<string>();
+            return calls;
+        }
+
+        public void Dispose()
+        {
+            NativeMemory.Free(Funcs);
+            t_calls = null;
+        }
+
+        [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+        private static void MessageBegin(int dest, int type, float* origin, edict_t* edict)
+            => t_calls!.Add($"Begin {dest} {type} {(nint)edict:X}");
+
+        [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+        private static void MessageEnd() => t_calls!.Add("End");
+
+        [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+        private static void WriteByte(int value) => t_calls!.Add($"Byte {value}");
+
+        [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+        private static void WriteShort(int value) => t_calls!.Add($"Short {value}");
+
+        [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+        private static void WriteEntity(int value) => t_calls!.Add($"Entity {value}");
+
+        [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+        private static void WriteCoord(float value) => t_calls!.Add($"Coord {value}");
+
+        [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+        private static void WriteString(NChar* text) => t_calls!.Add($"String {Marshal.PtrToStringUTF8((nint)text)}");
+    }
+}
@@ -0,0 +1,150 @@
+using System.Text;
+using GoldsrcFramework.Models;
+using GoldsrcFramework.Strings;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public class ModelPrewarmTests
+{
+    [Fact]
+    public void SerialParallelAndLazyResultsMatch()
+    {
+        string root = Path.Combine(Path.GetTempPath(), "gsf_prewarm_match_" + Environment.ProcessId);
+        Directory.CreateDirectory(Path.Combine(root, "models"));
+        try
+        {
+            var names = new List<string>();
+            for (int i = 0; i < 12; i++)
+            {
+                names.Add($"models/monster{i}.mdl");
+                File.WriteAllBytes(Path.Combine(root, names[^1]), TestModels.Build(8 + i * 3, 2 + i, 4 + i * 2, i));
+            }
+
+            var serialCache = new StudioModelCache { GameDirectory = root };
+            var parallelCache = new StudioModelCache { GameDirectory = root };
+            var lazy = new StudioModelCache { GameDirectory = root };
+            var serial = ModelPrewarm.Run(serialCache, names, workers: 1);
+            var parallel = ModelPrewarm.Run(parallelCache, names, workers: 4);
+
+            Assert.Equal(12, parallel.Models);
+            Assert.Equal(0, parallel.Failed);
+            Assert.True(parallel.Bytes > 0);
+            Assert.Equal((serial.Models, serial.Failed, serial.Bones, serial.Hitboxes, serial.Sequences, serial.Bytes),
+                (parallel.Models, parallel.Failed, parallel.Bones, parallel.Hitboxes, parallel.Sequences, parallel.Bytes));
+
+            foreach (var name in names)
+            {
+                var expected = serialCache.Get(View(name))!;
+                foreach (var info in new[] { parallelCache.Get(View(name))!, lazy.Get(View(name))! })
+                {
+                    Assert.Equal(expected.BoneCount, info.BoneCount);
+                    Assert.Equal(expected.HitboxCount, info.HitboxCount);
+                    Assert.Equal(expected.Sequences.Length, info.Sequences.Length);
+                    Assert.Equal(expected.BoneParents.ToArray(), info.BoneParents.ToArray());
+                    Assert.Equal(expected.BoneNames, info.BoneNames);
+                }
+            }
+            Assert.Equal(0, parallelCache.LateBuilds);
+            Assert.Equal(12, lazy.LateBuilds);
+        }
+        finally
+        {
+            Directory.Delete(root, true);
+        }
+    }
+
+    [Fact]
+    public void BuildReadsTheModelTables()
+    {
+        using var file = StudioModelFile.FromBytes(TestModels.Build(12, 4, 8, 3));
+        var info = StudioModelInfo.Build("models/test.mdl", file);
+
+        Assert.Equal(12, info.BoneCount);
+        Assert.Equal(4, info.HitboxCount);
+        Assert.Equal(8, info.Sequences.Length);
+        Assert.Equal(-1, info.BoneParents[0]);
+        Assert.Equal(0, info.FindBone(View("Bip01")));
+        Assert.Equal(5, info.FindBone(View("Bip01 Bone5")));
+        Assert.Equal(2, info.FindSequence(View("seq2")));
+    }
+
+    [Fact]
+    public void PrewarmPublishesModelsAndRemembersFailures()
+    {
+        string root = Path.Combine(Path.GetTempPath(), "gsf_prewarm_test_" + Environment.ProcessId);
+        Directory.CreateDirectory(Path.Combine(root, "models"));
+        try
+        {
+            var names = new List<string>();
+            for (int i = 0; i < 3; i++)
+            {
+                names.Add($"models/monster{i}.mdl");
+                File.WriteAllBytes(Path.Combine(root, names[^1]), TestModels.Build(20, 6, 10, i));
+            }
+            File.WriteAllBytes(Path.Combine(root, "models/broken.mdl"), new byte[64]);
+            names.Add("models/broken.mdl");
+            names.Add("models/missing.mdl");
+
+            var cache = new StudioModelCache { GameDirectory = root };
+            var report = ModelPrewarm.Run(cache, names, workers: 2);
+
+            Assert.Equal(5, report.Models);
+            Assert.Equal(2, report.Failed);
+            Assert.Equal(60, report.Bones);
+            Assert.Equal(18, report.Hitboxes);
+            Assert.Equal(30, report.Sequences);
+
+            Assert.NotNull(cache.Get(View("models/MONSTER1.mdl")));
+            Assert.Null(cache.Get(View("models/missing.mdl")));
+            Assert.Equal(0, cache.LateBuilds);
+
+            // Lookups are answered from the cache, but the next prewarm tries the failed ones again.
+            Assert.Equal(2, ModelPrewarm.Run(cache, names, workers: 2).Models);
+        }
+        finally
+        {
+            Directory.Delete(root, true);
+        }
+    }
+
+    [Fact]
+    public void MissedModelIsBuiltOnFirstLookup()
+    {
+        string root = Path.Combine(Path.GetTempPath(), "gsf_prewarm_late_" + Environment.ProcessId);
+        Directory.CreateDirectory(Path.Combine(root, "models"));
+        try
+        {
+            File.WriteAllBytes(Path.Combine(root, "models/late.mdl"), TestModels.Build(8, 2, 4, 0));
+            var cache = new StudioModelCache { GameDirectory = root };
+
+            Assert.Equal(8, cache.Get(View("models/late.mdl"))!.BoneCount);
+            Assert.NotNull(cache.Get(View("models/late.mdl")));
+            Assert.Equal(1, cache.LateBuilds);
+        }
+        finally
+        {
+            Directory.Delete(root, true);
+        }
+    }
+
+    [Fact]
+    public void SharedBoneNamesRemapBetweenModels()
+    {
+        var cache = new StudioModelCache();
+        using var playerFile = StudioModelFile.FromBytes(TestModels.Build(48, 20, 4, 0));
+        using var weaponFile = StudioModelFile.FromBytes(TestModels.Build(12, 4, 4, 3));
+        var player = StudioModelInfo.Build("models/player.mdl", playerFile);
+        var weapon = StudioModelInfo.Build("models/p_weapon.mdl", weaponFile);
+        cache.Add(View("models/player.mdl"), player);
+        cache.Add(View("models/p_weapon.mdl"), weapon);
+
+        // Both use "Bip01 BoneN" names, so each weapon bone lands on the player bone of the same index.
+        var ids = weapon.BoneNameIds;
+        Assert.Equal(12, ids.Length);
+        for (int i = 0; i < ids.Length; i++)
+            Assert.Equal(i, player.BoneForNameId(ids[i]));
+    }
+
+    private static Utf8View View(string s) => new(Encoding.UTF8.GetBytes(s));
+}
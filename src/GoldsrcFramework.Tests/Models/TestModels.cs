@@ -0,0 +1,99 @@
+using System.Text;
+using GoldsrcFramework.Engine.Native;
+using StudioConstants = GoldsrcFramework.Engine.Native.Deprecation.StudioConstants;
+
+namespace GoldsrcFramework.Tests;
+
+/// <summary>
+/// Hand-built studio models for tests that need a .mdl without shipping one.
+/// </summary>
+internal static unsafe class TestModels
+{
+    /// <summary>
+    /// A valid IDST v10 model: a bone chain with "Bip01 ..." names (shared between models, as on real player and weapon
+    /// models), hitboxes, sequences across two groups with activities, attachments and one body part.
+    /// </summary>
+    public static byte[] Build(int boneCount, int hitboxCount, int sequenceCount, int seed)
+    {
+        int groups = 2;
+        int offset = sizeof(studiohdr_t);
+        int boneIndex = offset; offset += boneCount * sizeof(mstudiobone_t);
+        int hitboxIndex = offset; offset += hitboxCount * sizeof(mstudiobbox_t);
+        int seqIndex = offset; offset += sequenceCount * sizeof(mstudioseqdesc_t);
+        int groupIndex = offset; offset += groups * sizeof(mstudioseqgroup_t);
+        int attachmentIndex = offset; offset += 2 * sizeof(mstudioattachment_t);
+        int bodyPartIndex = offset; offset += sizeof(mstudiobodyparts_t);
+        int modelIndex = offset; offset += sizeof(mstudiomodel_t);
+        int animIndex = offset; offset += sequenceCount * boneCount * sizeof(mstudioanim_t);
+
+        var data = new byte[offset];
+        fixed (byte* b = data)
+        {
+            var h = (studiohdr_t*)b;
+            h->id = StudioConstants.IDSTUDIOHEADER;
+            h->version = StudioConstants.STUDIO_VERSION;
+            h->length = data.Length;
+            h->numbones = boneCount;
+            h->boneindex = boneIndex;
+            h->numhitboxes = hitboxCount;
+            h->hitboxindex = hitboxIndex;
+            h->numseq = sequenceCount;
+            h->seqindex = seqIndex;
+            h->numseqgroups = groups;
+            h->seqgroupindex = groupIndex;
+            h->numattachments = 2;
+            h->attachmentindex = attachmentIndex;
+            h->numbodyparts = 1;
+            h->bodypartindex = bodyPartIndex;
+
+            var bones = (mstudiobone_t*)(b + boneIndex);
+            for (int i = 0; i < boneCount; i++)
+            {
+                WriteName(&bones[i].name, i == 0 ? "Bip01" : $"Bip01 Bone{i}");
+                bones[i].parent = i == 0 ? -1 : (i - 1) / 2;
+            }
+
+            var hitboxes = (mstudiobbox_t*)(b + hitboxIndex);
+            for (int i = 0; i < hitboxCount; i++)
+            {
+                hitboxes[i].bone = (i * 7 + seed) % boneCount;
+                hitboxes[i].group = i % 8;
+            }
+
+            var seqs = (mstudioseqdesc_t*)(b + seqIndex);
+            for (int i = 0; i < sequenceCount; i++)
+            {
+                WriteName(&seqs[i].label, $"seq{i}");
+                seqs[i].fps = 30;
+                seqs[i].numframes = 10 + i % 20;
+                seqs[i].numblends = 1;
+                seqs[i].activity = i % 5 == 0 ? 0 : 1 + i % 12;
+                seqs[i].actweight = 1;
+                seqs[i].seqgroup = i % 3 == 2 ? 1 : 0;
+                seqs[i].animindex = seqs[i].seqgroup == 0 ? animIndex + i * boneCount * sizeof(mstudioanim_t) : 0;
+            }
+
+            var seqGroups = (mstudioseqgroup_t*)(b + groupIndex);
+            WriteName(&seqGroups[0].name, "default");
+            WriteName(&seqGroups[1].name, $"models/monster{seed}01.mdl");
+
+            var attachments = (mstudioattachment_t*)(b + attachmentIndex);
+            attachments[0].bone = boneCount - 1;
+            attachments[1].bone = boneCount / 2;
+
+            var part = (mstudiobodyparts_t*)(b + bodyPartIndex);
+            WriteName(&part->name, "body");
+            part->nummodels = 1;
+            part->@base = 1;
+            part->modelindex = modelIndex;
+        }
+        return data;
+    }
+
+    private static void WriteName<T>(T* field, string name) where T : unmanaged
+    {
+        var bytes = new Span<byte>(field, sizeof(T));
+        bytes.Clear();
+        Encoding.ASCII.GetBytes(name.AsSpan(0, Math.Min(name.Length, sizeof(T) - 1)), bytes);
+    }
+}
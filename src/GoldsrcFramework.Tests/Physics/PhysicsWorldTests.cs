@@ -0,0 +1,121 @@
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Physics;
+using Xunit;
+
+using GVector3 = GoldsrcFramework.LinearMath.Vector3;
+using SQuaternion = Stride.Core.Mathematics.Quaternion;
+using SVector3 = Stride.Core.Mathematics.Vector3;
+
+namespace GoldsrcFramework.Tests;
+
+public unsafe class PhysicsWorldTests
+{
+    private const float Frame = 1f / 60f;
+
+    [Fact]
+    public void FallingBoxIsPushedToItsEdictAndRestsOnTheFloor()
+    {
+        var edict = (edict_t*)NativeMemory.AllocZeroed((nuint)sizeof(edict_t));
+        try
+        {
+            using var world = new PhysicsWorld(updateRate: 60, threadCount: 1);
+            world.AddStaticBox(new SVector3(512, 512, 16), new SVector3(0, 0, -16));
+            edict->serialnumber = 1;
+            world.AddBox(new SVector3(8, 8, 8), new SVector3(0, 0, 64), SQuaternion.Identity).Bind(edict);
+
+            Assert.Equal(1, world.Update(Frame));
+            Assert.Equal(1, world.LastFrame.Pushed);
+            Assert.True(edict->v.origin.Z < 64);
+
+            for (int i = 0; i < 300; i++)
+                world.Update(Frame);
+
+            // Floor top at z = 0, box half extent 8.
+            Assert.InRange(edict->v.origin.Z, 6f, 10f);
+            Assert.InRange(edict->v.velocity.Z, -5f, 5f);
+        }
+        finally
+        {
+            NativeMemory.Free(edict);
+        }
+    }
+
+    [Fact]
+    public void FreedOrReusedEdictIsUnbound()
+    {
+        var edict = (edict_t*)NativeMemory.AllocZeroed((nuint)sizeof(edict_t));
+        try
+        {
+            using var world = new PhysicsWorld(updateRate: 60, threadCount: 1);
+            edict->serialnumber = 1;
+            var node = world.AddBox(new SVector3(8, 8, 8), new SVector3(0, 0, 64), SQuaternion.Identity);
+            node.Bind(edict);
+
+            world.Update(Frame);
+            Assert.Equal(1, world.LastFrame.Pushed);
+
+            edict->serialnumber = 2;
+            world.Update(Frame);
+            Assert.Equal(0, world.LastFrame.Pushed);
+            Assert.True(node.Edict == null);
+        }
+        finally
+        {
+            NativeMemory.Free(edict);
+        }
+    }
+
+    [Fact]
+    public void StepsPerFrameAreCappedAndTheRestDropped()
+    {
+        using var world = new PhysicsWorld(updateRate: 60, maxStepsPerFrame: 4, threadCount: 1);
+
+        Assert.Equal(4, world.Update(0.5f));
+        Assert.True(world.LastFrame.DroppedTime > 0);
+        Assert.InRange(world.Alpha, 0f, 1f);
+    }
+
+    [Theory]
+    [InlineData(0f, 0f, 0f)]
+    [InlineData(30f, 45f, 0f)]
+    [InlineData(-20f, 170f, 10f)]
+    public void AnglesSurviveTheQuaternionRoundTrip(float pitch, float yaw, float roll)
+    {
+        var angles = PhysNode.QuaternionToAngles(PhysNode.AnglesToQuaternion(new GVector3(pitch, yaw, roll)));
+
+        Assert.Equal(pitch, angles.X, 0.01f);
+        Assert.Equal(yaw, angles.Y, 0.01f);
+        Assert.Equal(roll, angles.Z, 0.01f);
+    }
+
+    [Fact]
+    public void EveryBoundBodyIsPushedEachFrame()
+    {
+        const int Bodies = 64;
+        var edicts = (edict_t*)NativeMemory.AllocZeroed(Bodies, (nuint)sizeof(edict_t));
+        try
+        {
+            using var world = new PhysicsWorld(updateRate: 60, threadCount: 1);
+            world.AddStaticBox(new SVector3(512, 512, 16), new SVector3(0, 0, -16));
+            for (int i = 0; i < Bodies; i++)
+            {
+                edicts[i].serialnumber = i + 1;
+                world.AddBox(new SVector3(8, 8, 8), new SVector3(i % 8 * 24f, i / 8 * 24f, 64), SQuaternion.Identity).Bind(&edicts[i]);
+            }
+
+            Assert.Equal(1, world.ThreadCount);
+            for (int frame = 0; frame < 10; frame++)
+            {
+                Assert.Equal(1, world.Update(Frame));
+                Assert.Equal(Bodies, world.LastFrame.Pushed);
+            }
+            for (int i = 0; i < Bodies; i++)
+                Assert.True(edicts[i].v.origin.Z < 64);
+        }
+        finally
+        {
+            NativeMemory.Free(edicts);
+        }
+    }
+}
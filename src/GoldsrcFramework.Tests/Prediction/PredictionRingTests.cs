@@ -0,0 +1,328 @@
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Prediction;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public unsafe class PredictionRingTests
+{
+    private const int IN_ATTACK = 1;
+
+    [Theory]
+    [InlineData(4)]
+    [InlineData(24)]
+    public void RingGivesTheSamePredictionWithFewerThinks(int latency)
+    {
+        using var ring = new PredictionRing();
+        var rerun = Play(null, latency, mispredictInterval: 97, out long rerunThinks);
+        var cached = Play(ring, latency, mispredictInterval: 97, out long cachedThinks);
+
+        Assert.Equal(rerun, cached);
+        Assert.True(cachedThinks < rerunThinks);
+        Assert.True(ring.Stats.Reused > 0);
+        Assert.True(ring.Stats.Confirmed > 0);
+        Assert.True(ring.Stats.Mispredicts > 0);
+    }
+
+    [Fact]
+    public void QuantizedServerStatesAreConfirmed()
+    {
+        using var ring = new PredictionRing();
+        Play(ring, latency: 12, mispredictInterval: 0, out _);
+
+        Assert.Equal(0, ring.Stats.Mispredicts);
+        Assert.True(ring.Stats.Confirmed > 0);
+    }
+
+    [Fact]
+    public void ReusesUnchangedCommandsUntilTheFirstChange()
+    {
+        var states = Alloc<local_state_t>(3);
+        var commands = Alloc<usercmd_t>(3);
+        using var ring = new PredictionRing();
+        try
+        {
+            states[0].client.m_iId = 1;
+            Weapons(&states[0])[1] = new weapon_data_t { m_iId = 1, m_iClip = 10 };
+            commands[1].msec = commands[2].msec = 10;
+            commands[1].buttons = commands[2].buttons = 1;
+
+            // Nothing stored yet: both commands go through the weapon code.
+            Assert.Equal(0, Pass(ring, states, commands, 2));
+            Assert.Equal(9, Weapons(&states[1])[1].m_iClip);
+            Assert.Equal(8, Weapons(&states[2])[1].m_iClip);
+
+            // Same inputs: both answered from the ring, with the weapon code's writes replayed.
+            Assert.Equal(2, Pass(ring, states, commands, 3));
+            Assert.Equal(1, states[1].client.weaponanim);
+            Assert.Equal(8, Weapons(&states[2])[1].m_iClip);
+
+            // A changed command re-runs itself and everything after it.
+            commands[1].buttons = 0;
+            Assert.Equal(0, Pass(ring, states, commands, 3));
+            Assert.Equal(10, Weapons(&states[1])[1].m_iClip);
+            Assert.Equal(0, states[1].client.weaponanim);
+
+            var stats = ring.Stats;
+            Assert.Equal(3, stats.Passes);
+            Assert.Equal(1, stats.FirstRuns);
+            Assert.Equal(2, stats.Reused);
+            Assert.Equal(3, stats.Resimulated);
+        }
+        finally
+        {
+            NativeMemory.Free(commands);
+            NativeMemory.Free(states);
+        }
+    }
+
+    [Fact]
+    public void OneUlpChangeInOriginOrTimeGoesToTheWeaponCode()
+    {
+        var states = Alloc<local_state_t>(2);
+        var cmd = Alloc<usercmd_t>(1);
+        using var ring = new PredictionRing();
+        try
+        {
+            states[0].client.origin = new Vector3(100, 200, 300);
+            cmd->msec = 10;
+            cmd->buttons = 1;
+
+            Assert.True(Simulated(0.01));
+            Assert.False(Simulated(0.01));
+
+            states[0].client.origin.X = MathF.BitIncrement(states[0].client.origin.X);
+            Assert.True(Simulated(0.01));
+            Assert.False(Simulated(0.01));
+
+            Assert.True(Simulated(Math.BitIncrement(0.01)));
+            Assert.Equal(3, ring.Stats.Resimulated);
+            Assert.Equal(2, ring.Stats.Reused);
+        }
+        finally
+        {
+            NativeMemory.Free(cmd);
+            NativeMemory.Free(states);
+        }
+
+        // Already predicted command 1 from states[0]; true when it went through the weapon code (the legacy DLL).
+        bool Simulated(double time)
+        {
+            states[1] = states[0];
+            if (ring.TryReuse(&states[0], &states[1], cmd, 0, time, 1))
+                return false;
+            states[1].client.weaponanim = 1;
+            ring.Store(&states[0], &states[1], cmd, time, 1);
+            return true;
+        }
+    }
+
+    [Fact]
+    public void AcknowledgedStateIsComparedWithThePrediction()
+    {
+        var states = Alloc<local_state_t>(3);
+        var commands = Alloc<usercmd_t>(3);
+        var server = Alloc<local_state_t>(1);
+        using var ring = new PredictionRing();
+        try
+        {
+            states[0].client.m_iId = 1;
+            Weapons(&states[0])[1] = new weapon_data_t { m_iId = 1, m_iClip = 10 };
+            commands[1].msec = commands[2].msec = 10;
+            commands[1].buttons = commands[2].buttons = 1;
+            Pass(ring, states, commands, 2);
+
+            // The server agrees on command 1, up to its 1 ms timer precision.
+            *server = states[1];
+            Weapons(server)[1].m_flNextPrimaryAttack += 0.001f;
+            ring.Acknowledge(&server->client, (weapon_data_t*)&server->weapondata);
+            Pass(ring, states, commands, 2, first: 2);
+            Assert.Equal(1, ring.Stats.Confirmed);
+
+            // The server took another bullet.
+            Weapons(server)[1].m_iClip--;
+            ring.Acknowledge(&server->client, (weapon_data_t*)&server->weapondata);
+            Pass(ring, states, commands, 2, first: 2);
+            Assert.Equal(1, ring.Stats.Mispredicts);
+            Assert.Equal(nameof(weapon_data_t.m_iClip), ring.Stats.LastMispredict);
+        }
+        finally
+        {
+            NativeMemory.Free(server);
+            NativeMemory.Free(commands);
+            NativeMemory.Free(states);
+        }
+    }
+
+    [Fact]
+    public void CompareClientAllowsNetworkPrecision()
+    {
+        var a = Alloc<clientdata_t>(2);
+        try
+        {
+            a[0].origin = new Vector3(100, 200, 300);
+            a[1] = a[0];
+            a[1].origin.X += PredictionRing.PositionTolerance / 2;
+            Assert.Null(PredictionRing.CompareClient(&a[0], &a[1]));
+
+            a[1].origin.X += PredictionRing.PositionTolerance;
+            Assert.Equal(nameof(clientdata_t.origin), PredictionRing.CompareClient(&a[0], &a[1]));
+
+            a[1] = a[0];
+            a[1].weaponanim = 3;
+            Assert.Equal(nameof(clientdata_t.weaponanim), PredictionRing.CompareClient(&a[0], &a[1]));
+        }
+        finally
+        {
+            NativeMemory.Free(a);
+        }
+    }
+
+    // The engine's side of client prediction at 100 fps for 1000 frames: the server runs each command "latency" frames
+    // late and sends its state, quantized as the delta encoder does, every third frame; every frame re-runs all
+    // unacknowledged commands through movement and the weapon code, through the ring when there is one. Every
+    // mispredictInterval server commands the server takes a bullet on its own. Returns the active clip and weapon
+    // animation predicted at each frame.
+    private static List<(int Clip, int Anim)> Play(PredictionRing? ring, int latency, int mispredictInterval, out long thinks)
+    {
+        const int frames = 1000, backup = 128;
+        var predicted = Alloc<local_state_t>(PredictionRing.DefaultCapacity);
+        var server = Alloc<local_state_t>(backup);
+        var acknowledged = Alloc<local_state_t>(1);
+        var commands = Alloc<usercmd_t>(frames + 1);
+        var result = new List<(int, int)>();
+        thinks = 0;
+
+        try
+        {
+            server->client.m_iId = 1;
+            server->client.velocity = new Vector3(250, 0, 0);
+            for (int i = 1; i <= 4; i++)
+                Weapons(server)[i] = new weapon_data_t { m_iId = i, m_iClip = 30 };
+            *acknowledged = *server;
+            for (int i = 1; i <= frames; i++)
+            {
+                commands[i].msec = 10;
+                commands[i].buttons = (ushort)((i / 40) % 3 != 2 ? IN_ATTACK : 0);
+            }
+
+            int ack = 0;
+            for (int frame = 1; frame <= frames; frame++)
+            {
+                int serverCommand = frame - latency;
+                if (serverCommand >= 1)
+                {
+                    var previous = &server[(serverCommand - 1) % backup];
+                    var current = &server[serverCommand % backup];
+                    *current = *previous;
+                    Move(current, &commands[serverCommand]);
+                    Think(previous, current, &commands[serverCommand]);
+                    if (mispredictInterval > 0 && serverCommand % mispredictInterval == 0)
+                        Weapons(current)[1].m_iClip--;
+
+                    if (frame % 3 == 0)
+                    {
+                        ack = serverCommand;
+                        *acknowledged = *current;
+                        Quantize(acknowledged);
+                        ring?.Acknowledge(&acknowledged->client, (weapon_data_t*)&acknowledged->weapondata);
+                    }
+                }
+
+                var from = acknowledged;
+                for (int command = ack + 1; command <= frame; command++)
+                {
+                    var to = &predicted[command % PredictionRing.DefaultCapacity];
+                    var cmd = &commands[command];
+                    double time = command * 0.01;
+                    *to = *from;
+                    Move(to, cmd);
+                    if (ring == null || !ring.TryReuse(from, to, cmd, command == frame ? 1 : 0, time, (uint)command))
+                    {
+                        Think(from, to, cmd);
+                        thinks++;
+                        ring?.Store(from, to, cmd, time, (uint)command);
+                    }
+                    from = to;
+                }
+
+                result.Add((Weapons(from)[1].m_iClip, from->client.weaponanim));
+            }
+            return result;
+        }
+        finally
+        {
+            NativeMemory.Free(commands);
+            NativeMemory.Free(acknowledged);
+            NativeMemory.Free(server);
+            NativeMemory.Free(predicted);
+        }
+    }
+
+    // Engine movement, before HUD_PostRunCmd.
+    private static void Move(local_state_t* to, usercmd_t* cmd) => to->client.origin += to->client.velocity * (cmd->msec / 1000f);
+
+    // HUD_WeaponsPostThink for one weapon: fire while the button is held, reload when empty.
+    private static void Think(local_state_t* from, local_state_t* to, usercmd_t* cmd)
+    {
+        ref var weapon = ref Weapons(to)[1];
+        weapon.m_flNextPrimaryAttack = MathF.Max(Weapons(from)[1].m_flNextPrimaryAttack - cmd->msec / 1000f, -0.001f);
+
+        // Expired within half a millisecond, so 1 ms quantization does not move the threshold.
+        bool ready = weapon.m_flNextPrimaryAttack <= 0.0005f;
+        to->client.weaponanim = 0;
+        if (weapon.m_iClip == 0 && ready)
+        {
+            weapon.m_iClip = 30;
+            weapon.m_flNextPrimaryAttack = 1.0f;
+            to->client.weaponanim = 2;
+        }
+        else if ((cmd->buttons & IN_ATTACK) != 0 && weapon.m_iClip > 0 && ready)
+        {
+            weapon.m_iClip--;
+            weapon.m_flNextPrimaryAttack = 0.1f;
+            to->client.weaponanim = 1;
+        }
+    }
+
+    // What survives the delta encoder: 1/8 unit positions, 1 ms timers.
+    private static void Quantize(local_state_t* state)
+    {
+        state->client.origin = new Vector3(MathF.Round(state->client.origin.X * 8) / 8, MathF.Round(state->client.origin.Y * 8) / 8,
+            MathF.Round(state->client.origin.Z * 8) / 8);
+        foreach (ref var weapon in Weapons(state))
+            weapon.m_flNextPrimaryAttack = MathF.Round(weapon.m_flNextPrimaryAttack * 1000) / 1000;
+    }
+
+    // One prediction pass over commands first..2 from states[first - 1], without movement; the weapon code fires one
+    // bullet per command with IN_ATTACK. Command "last" runs for the first time. Returns the reused count.
+    private static int Pass(PredictionRing ring, local_state_t* states, usercmd_t* commands, int last, int first = 1)
+    {
+        long reused = ring.Stats.Reused;
+        for (int command = first; command <= 2; command++)
+        {
+            var from = &states[command - 1];
+            var to = &states[command];
+            *to = *from;
+            int runfuncs = command == last ? 1 : 0;
+            if (ring.TryReuse(from, to, &commands[command], runfuncs, command * 0.01, (uint)command))
+                continue;
+
+            to->client.weaponanim = 0;
+            if ((commands[command].buttons & 1) != 0)
+            {
+                Weapons(to)[1].m_iClip--;
+                Weapons(to)[1].m_flNextPrimaryAttack = 0.1f;
+                to->client.weaponanim = 1;
+            }
+            ring.Store(from, to, &commands[command], command * 0.01, (uint)command);
+        }
+        return (int)(ring.Stats.Reused - reused);
+    }
+
+    private static Span<weapon_data_t> Weapons(local_state_t* state) => new(&state->weapondata, 64);
+
+    private static T* Alloc<T>(int count) where T : unmanaged => (T*)NativeMemory.AllocZeroed((nuint)count, (nuint)sizeof(T));
+}
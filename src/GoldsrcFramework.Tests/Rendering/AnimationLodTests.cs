@@ -0,0 +1,232 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Rendering;
+using GoldsrcFramework.Replay;
+using NativeInterop;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+/// <summary>
+/// <see cref="AnimationLod"/> against the mock engine's cvars, driven the way StudioModelRenderer drives it: one
+/// Select per draw, and a new pose pushed whenever it asks for one.
+/// </summary>
+[Collection(MockEngineCollection.Name)]
+public unsafe class AnimationLodTests : IDisposable
+{
+    private const int Bones = 2;
+    private const double FrameTime = 0.01;
+
+    private readonly AnimationLod _lod = new();
+    private readonly cl_entity_t* _entity;
+    private readonly model_t* _model;
+    private readonly studiohdr_t* _header;
+    private readonly float* _pos;
+    private readonly float* _q;
+    private StudioModelRenderer.RendererState _state;
+
+    public AnimationLodTests()
+    {
+        MockEngine.Initialize(64, "valve");
+        _lod.Init();
+        SetCvar("r_animlod", 1);
+        SetCvar("r_animlod_dist", 768);
+        SetCvar("r_animlod_pixels", 0);
+        SetCvar("r_animlod_interval", 2);
+        AnimationLod.FieldOfView = 90;
+
+        _entity = (cl_entity_t*)NativeMemory.AllocZeroed((nuint)sizeof(cl_entity_t));
+        _entity->index = 7;
+        _model = (model_t*)NativeMemory.AllocZeroed((nuint)sizeof(model_t));
+        _header = (studiohdr_t*)NativeMemory.AllocZeroed((nuint)sizeof(studiohdr_t));
+        _header->numbones = Bones;
+        _header->bbmin = new Vector3(-16, -16, 0);
+        _header->bbmax = new Vector3(16, 16, 72);
+        _pos = (float*)NativeMemory.AllocZeroed(Bones * 3, sizeof(float));
+        _q = (float*)NativeMemory.AllocZeroed(Bones * 4, sizeof(float));
+    }
+
+    public void Dispose()
+    {
+        SetCvar("r_animlod", 0);
+        NativeMemory.Free(_entity);
+        NativeMemory.Free(_model);
+        NativeMemory.Free(_header);
+        NativeMemory.Free(_pos);
+        NativeMemory.Free(_q);
+    }
+
+    [Fact]
+    public void OffDrawsEveryEntityAtFullEveryFrame()
+    {
+        SetCvar("r_animlod", 0);
+        _entity->origin = new Vector3(100_000, 0, 0);
+
+        for (int i = 0; i < 10; i++)
+        {
+            var band = Draw(out var state, out bool update);
+            Assert.Equal(AnimationLodBand.Full, band);
+            Assert.Null(state);
+            Assert.True(update);
+        }
+    }
+
+    [Theory]
+    [InlineData(0, AnimationLodBand.Full)]
+    [InlineData(767, AnimationLodBand.Full)]
+    [InlineData(768, AnimationLodBand.Reduced)]
+    [InlineData(1535, AnimationLodBand.Reduced)]
+    [InlineData(1536, AnimationLodBand.Low)]
+    [InlineData(3072, AnimationLodBand.Minimal)]
+    [InlineData(100_000, AnimationLodBand.Minimal)]
+    public void DistanceBandsDoubleFromRAnimlodDist(float distance, AnimationLodBand expected)
+    {
+        _entity->origin = new Vector3(distance, 0, 0);
+
+        Assert.Equal(expected, Draw(out _, out _));
+    }
+
+    [Theory]
+    [InlineData(2, 800, 2)]
+    [InlineData(2, 1600, 4)]
+    [InlineData(2, 3200, 8)]
+    [InlineData(3, 800, 3)]
+    [InlineData(3, 1600, 6)]
+    public void BandsUpdateThePoseEveryIntervalFrames(int interval, float distance, int expected)
+    {
+        SetCvar("r_animlod_interval", interval);
+        _entity->origin = new Vector3(distance, 0, 0);
+
+        var updates = new List<int>();
+        for (int i = 0; i < 64; i++)
+        {
+            Draw(out _, out bool update);
+            if (update)
+                updates.Add(_state.m_nFrameCount);
+        }
+
+        // The first pose is computed at once, the next on the entity's staggered slot, then every interval frames.
+        Assert.Equal(_state.m_nFrameCount - 63, updates[0]);
+        Assert.InRange(updates[1] - updates[0], 1, expected);
+        for (int i = 2; i < updates.Count; i++)
+            Assert.Equal(expected, updates[i] - updates[i - 1]);
+    }
+
+    [Fact]
+    public void NearOrLargeOnScreenKeepsFullAnimation()
+    {
+        SetCvar("r_animlod_pixels", 96);
+        var previous = MockEngine.Client->GetScreenInfo;
+        MockEngine.Client->GetScreenInfo = &ScreenInfo;
+        try
+        {
+            // 32x32x72 box 3200 units away on a 768 pixel high screen: about 10 pixels.
+            _entity->origin = new Vector3(3200, 0, 0);
+            Assert.Equal(AnimationLodBand.Minimal, Draw(out _, out _));
+
+            // Zoomed in it is large on screen again, however far it is.
+            AnimationLod.FieldOfView = 5;
+            Assert.Equal(AnimationLodBand.Full, Draw(out _, out _));
+
+            // Close but tiny: distance alone keeps it at full detail.
+            AnimationLod.FieldOfView = 90;
+            _entity->origin = new Vector3(100, 0, 0);
+            _entity->curstate.scale = 0.01f;
+            Assert.Equal(AnimationLodBand.Full, Draw(out _, out _));
+        }
+        finally
+        {
+            MockEngine.Client->GetScreenInfo = previous;
+        }
+    }
+
+    [Fact]
+    public void InterpolatedPoseIsHalfwayAtTheMidpoint()
+    {
+        var state = new AnimationLodState();
+
+        // Bone 0 moves and turns 90 degrees about z between the two poses; bone 1 stays put.
+        SetPose(0, new Vector3(0, 0, 0), 0);
+        SetPose(1, new Vector3(4, 8, 12), 0);
+        state.Push(_pos, _q, _model, _header, 0, 1, 1.0);
+        SetPose(0, new Vector3(10, -20, 30), MathF.PI / 2);
+        state.Push(_pos, _q, _model, _header, 0, 3, 1.1);
+
+        // Drawn one update behind: halfway through the next interval is halfway between the cached poses.
+        state.Interpolate(_pos, _q, Bones, 1.15);
+
+        AssertPose(0, new Vector3(5, -10, 15), MathF.PI / 4);
+        AssertPose(1, new Vector3(4, 8, 12), 0);
+
+        state.Interpolate(_pos, _q, Bones, 1.1);
+        AssertPose(0, new Vector3(0, 0, 0), 0);
+        state.Interpolate(_pos, _q, Bones, 1.3);
+        AssertPose(0, new Vector3(10, -20, 30), MathF.PI / 2);
+    }
+
+    [Fact]
+    public void PoseAfterALongGapSnaps()
+    {
+        var state = new AnimationLodState();
+
+        SetPose(0, new Vector3(0, 0, 0), 0);
+        state.Push(_pos, _q, _model, _header, 0, 1, 1.0);
+        SetPose(0, new Vector3(10, 0, 0), MathF.PI / 2);
+        state.Push(_pos, _q, _model, _header, 0, 2, 1.0 + AnimationLod.MaxInterpolationGap + 0.1);
+
+        state.Interpolate(_pos, _q, Bones, 2.0);
+        AssertPose(0, new Vector3(10, 0, 0), MathF.PI / 2);
+    }
+
+    // Next render frame, entity drawn from the origin.
+    private AnimationLodBand Draw(out AnimationLodState? state, out bool update)
+    {
+        _state.m_nFrameCount++;
+        _state.m_clTime += FrameTime;
+        fixed (StudioModelRenderer.RendererState* s = &_state)
+        {
+            var band = _lod.Select(_entity, _model, _header, s, out state, out update);
+            if (update)
+                state?.Push(_pos, _q, _model, _header, _entity->curstate.sequence, s->m_nFrameCount, s->m_clTime);
+            return band;
+        }
+    }
+
+    private void SetPose(int bone, Vector3 position, float yaw)
+    {
+        _pos[bone * 3 + 0] = position.X;
+        _pos[bone * 3 + 1] = position.Y;
+        _pos[bone * 3 + 2] = position.Z;
+        _q[bone * 4 + 0] = 0;
+        _q[bone * 4 + 1] = 0;
+        _q[bone * 4 + 2] = MathF.Sin(yaw / 2);
+        _q[bone * 4 + 3] = MathF.Cos(yaw / 2);
+    }
+
+    private void AssertPose(int bone, Vector3 position, float yaw)
+    {
+        Assert.Equal(position.X, _pos[bone * 3 + 0], 4);
+        Assert.Equal(position.Y, _pos[bone * 3 + 1], 4);
+        Assert.Equal(position.Z, _pos[bone * 3 + 2], 4);
+        Assert.Equal(0, _q[bone * 4 + 0], 4);
+        Assert.Equal(0, _q[bone * 4 + 1], 4);
+        Assert.Equal(MathF.Sin(yaw / 2), _q[bone * 4 + 2], 4);
+        Assert.Equal(MathF.Cos(yaw / 2), _q[bone * 4 + 3], 4);
+    }
+
+    private static void SetCvar(string name, float value)
+    {
+        var cvar = EngineApi.PClient->GetCvarPointer(MockEngine.Text(name));
+        cvar->value = value;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int ScreenInfo(SCREENINFO* info)
+    {
+        info->iWidth = 1024;
+        info->iHeight = 768;
+        return 1;
+    }
+}
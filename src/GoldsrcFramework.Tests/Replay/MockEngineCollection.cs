@@ -0,0 +1,13 @@
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+/// <summary>
+/// Test classes that run against <see cref="GoldsrcFramework.Replay.MockEngine"/>, whose engine tables, edicts and
+/// cvars are process-wide; xunit runs the classes of one collection one at a time.
+/// </summary>
+[CollectionDefinition(Name)]
+public sealed class MockEngineCollection
+{
+    public const string Name = "MockEngine";
+}
@@ -0,0 +1,105 @@
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using NativeInterop;
+
+namespace GoldsrcFramework.Tests;
+
+/// <summary>
+/// Server exports for the replay tests: logs the calls that matter with the state they were given, and writes to the
+/// edicts and structs it is passed so replay has something to compare. Everything else does nothing.
+/// </summary>
+internal sealed unsafe class TestServerExports : IServerExportFuncs
+{
+    private static readonly NChar* s_description = (NChar*)Marshal.StringToCoTaskMemUTF8("Replay Test");
+
+    private edict_t* _edicts;
+
+    public List<string> Log { get; } = new();
+
+    /// <summary>Health Think takes off an entity.</summary>
+    public float Damage { get; init; } = 1;
+
+    private int IndexOf(edict_t* edict) => (int)(edict - _edicts);
+
+    private static string? Text(NChar* text) => Marshal.PtrToStringUTF8((nint)text);
+
+    public void ServerActivate(edict_t* pEdictList, int edictCount, int clientMax)
+    {
+        _edicts = pEdictList;
+        Log.Add($"ServerActivate {edictCount} {clientMax}");
+    }
+
+    public int Spawn(edict_t* pent)
+    {
+        Log.Add($"Spawn {IndexOf(pent)} {pent->v.origin.X} {pent->v.origin.Y} {pent->v.origin.Z}");
+        pent->v.health = 100;
+        return 0;
+    }
+
+    public void Think(edict_t* pent)
+    {
+        Log.Add($"Think {IndexOf(pent)} {pent->v.health}");
+        pent->v.health -= Damage;
+    }
+
+    public void KeyValue(edict_t* pentKeyvalue, KeyValueData* pkvd)
+    {
+        Log.Add($"KeyValue {IndexOf(pentKeyvalue)} {Text(pkvd->szKeyName)}={Text(pkvd->szValue)}");
+        pkvd->fHandled = 1;
+    }
+
+    public NChar* GetGameDescription() => s_description;
+
+    public int ShouldCollide(edict_t* pentTouched, edict_t* pentOther) => 1;
+
+    public void GameInit() { }
+    public void Use(edict_t* pentUsed, edict_t* pentOther) { }
+    public void Touch(edict_t* pentTouched, edict_t* pentOther) { }
+    public void Blocked(edict_t* pentBlocked, edict_t* pentOther) { }
+    public void Save(edict_t* pent, SAVERESTOREDATA* pSaveData) { }
+    public int Restore(edict_t* pent, SAVERESTOREDATA* pSaveData, int globalEntity) => 0;
+    public void SetAbsBox(edict_t* pent) { }
+    public void SaveWriteFields(SAVERESTOREDATA* pSaveData, NChar* pname, void* pBaseData, TYPEDESCRIPTION* pFields, int fieldCount) { }
+    public void SaveReadFields(SAVERESTOREDATA* pSaveData, NChar* pname, void* pBaseData, TYPEDESCRIPTION* pFields, int fieldCount) { }
+    public void SaveGlobalState(SAVERESTOREDATA* pSaveData) { }
+    public void RestoreGlobalState(SAVERESTOREDATA* pSaveData) { }
+    public void ResetGlobalState() { }
+    public qboolean ClientConnect(edict_t* pEntity, NChar* pszName, NChar* pszAddress, NChar* szRejectReason) => new() { Value = 1 };
+    public void ClientDisconnect(edict_t* pEntity) { }
+    public void ClientKill(edict_t* pEntity) { }
+    public void ClientPutInServer(edict_t* pEntity) { }
+    public void ClientCommand(edict_t* pEntity) { }
+    public void ClientUserInfoChanged(edict_t* pEntity, NChar* infobuffer) { }
+    public void ServerDeactivate() { }
+    public void PlayerPreThink(edict_t* pEntity) { }
+    public void PlayerPostThink(edict_t* pEntity) { }
+    public void StartFrame() { }
+    public void ParmsNewLevel() { }
+    public void ParmsChangeLevel() { }
+    public void PlayerCustomization(edict_t* pEntity, customization_t* pCustom) { }
+    public void SpectatorConnect(edict_t* pEntity) { }
+    public void SpectatorDisconnect(edict_t* pEntity) { }
+    public void SpectatorThink(edict_t* pEntity) { }
+    public void Sys_Error(NChar* error_string) { }
+    public void PM_Move(playermove_t* ppmove, qboolean server) { }
+    public void PM_Init(playermove_t* ppmove) { }
+    public NChar PM_FindTextureType(NChar* name) => default;
+    public void SetupVisibility(edict_t* pViewEntity, edict_t* pClient, byte** pvs, byte** pas) { }
+    public void UpdateClientData(edict_t* ent, int sendweapons, clientdata_t* cd) { }
+    public int AddToFullPack(entity_state_t* state, int e, edict_t* ent, edict_t* host, int hostflags, int player, byte* pSet) => 0;
+    public void CreateBaseline(int player, int eindex, entity_state_t* baseline, edict_t* entity, int playermodelindex, Vector3* player_mins, Vector3* player_maxs) { }
+    public void RegisterEncoders() { }
+    public int GetWeaponData(edict_t* player, weapon_data_t* info) => 0;
+    public void CmdStart(edict_t* player, usercmd_t* cmd, uint random_seed) { }
+    public void CmdEnd(edict_t* player) { }
+    public int ConnectionlessPacket(netadr_t* net_from, NChar* args, NChar* response_buffer, int* response_buffer_size) => 0;
+    public int GetHullBounds(int hullnumber, float* mins, float* maxs) => 0;
+    public void CreateInstancedBaselines() { }
+    public int InconsistentFile(edict_t* player, NChar* filename, NChar* disconnect_message) => 0;
+    public int AllowLagCompensation() => 0;
+    public void OnFreeEntPrivateData(edict_t* pEnt) { }
+    public void GameShutdown() { }
+    public void CvarValue(edict_t* pEnt, NChar* value) { }
+    public void CvarValue2(edict_t* pEnt, int requestID, NChar* cvarName, NChar* value) { }
+}
@@ -0,0 +1,195 @@
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Replay;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+[Collection(MockEngineCollection.Name)]
+public unsafe class TraceReplayTests
+{
+    private const int Edicts = 64;
+
+    private static readonly TraceCall[] s_recorded =
+    {
+        TraceCall.ServerActivate, TraceCall.Spawn, TraceCall.Think, TraceCall.Think, TraceCall.KeyValue,
+        TraceCall.GetGameDescription, TraceCall.ShouldCollide,
+    };
+
+    [Fact]
+    public void CapturedCallsReadBackAndReplay()
+    {
+        WithTrace((path, recorded) =>
+        {
+            using var trace = TraceReader.Open(path);
+            Assert.False(trace.Truncated);
+            Assert.Equal(TraceFileHeader.MagicValue, trace.Header.Magic);
+            Assert.Equal(s_recorded, Calls(trace));
+
+            var replayed = new TestServerExports();
+            var report = new TraceReplayer(replayed, null).Replay(trace);
+
+            Assert.Equal(s_recorded.Length, report.Calls);
+            Assert.Equal(s_recorded.Length, report.Replayed);
+            Assert.Equal(0, report.Failed);
+            Assert.Equal(0, report.Divergent);
+            Assert.Equal(recorded.Log, replayed.Log);
+
+            // Same trace, different mod: the two Think calls write another health.
+            var changed = new TraceReplayer(new TestServerExports { Damage = 2 }, null, new TraceReplayOptions { Baseline = report.Digests })
+                .Replay(trace);
+            Assert.Equal(2, changed.Divergent);
+            Assert.Equal(2, changed.BaselineDivergent);
+        });
+    }
+
+    [Fact]
+    public void TraceCutInsideTheHeaderIsRejected()
+    {
+        WithTrace((path, _) =>
+        {
+            var bytes = File.ReadAllBytes(path);
+            File.WriteAllBytes(path, bytes[..(sizeof(TraceFileHeader) - 1)]);
+
+            Assert.Throws<InvalidDataException>(() => TraceReader.Open(path).Dispose());
+        });
+    }
+
+    [Fact]
+    public void TraceWithAnotherMagicIsRejected()
+    {
+        WithTrace((path, _) =>
+        {
+            var bytes = File.ReadAllBytes(path);
+            bytes[0] ^= 0xFF;
+            File.WriteAllBytes(path, bytes);
+
+            Assert.Throws<InvalidDataException>(() => TraceReader.Open(path).Dispose());
+        });
+    }
+
+    [Fact]
+    public void CorruptRecordThrows()
+    {
+        WithTrace((path, _) =>
+        {
+            var bytes = File.ReadAllBytes(path);
+            bytes[sizeof(TraceFileHeader)] = 0xEE; // record type of the first record
+            File.WriteAllBytes(path, bytes);
+
+            using var trace = TraceReader.Open(path);
+            Assert.Throws<InvalidDataException>(() => Calls(trace));
+        });
+    }
+
+    [Fact]
+    public void CorruptArgumentsThrowOnReplay()
+    {
+        WithTrace((path, _) =>
+        {
+            // Spawn's edict delta claims a longer state than the record holds.
+            var bytes = File.ReadAllBytes(path);
+            int spawn = RecordOffset(bytes, 1);
+            int arguments = spawn + sizeof(TraceRecordHeader) + 1 + 4;
+            bytes[arguments] = 0xFF;
+            bytes[arguments + 1] = 0x7F;
+            File.WriteAllBytes(path, bytes);
+
+            using var trace = TraceReader.Open(path);
+            Assert.Throws<InvalidDataException>(() => new TraceReplayer(new TestServerExports(), null).Replay(trace));
+        });
+    }
+
+    [Fact]
+    public void TraceCutInsideARecordReplaysUpToIt()
+    {
+        WithTrace((path, recorded) =>
+        {
+            var bytes = File.ReadAllBytes(path);
+            File.WriteAllBytes(path, bytes[..^3]);
+
+            using var trace = TraceReader.Open(path);
+            Assert.True(trace.Truncated);
+            Assert.Equal(s_recorded[..^1], Calls(trace));
+
+            var replayed = new TestServerExports();
+            var report = new TraceReplayer(replayed, null).Replay(trace);
+            Assert.Equal(s_recorded.Length - 1, report.Replayed);
+            Assert.Equal(recorded.Log, replayed.Log);
+        });
+    }
+
+    // Records s_recorded through RecordingServerExports on the mock engine.
+    private static void WithTrace(Action<string, TestServerExports> test)
+    {
+        MockEngine.Initialize(Edicts, "valve");
+        var path = Path.Combine(Path.GetTempPath(), $"replay-{Guid.NewGuid():N}.gtrc");
+        var mod = new TestServerExports();
+        var exports = new RecordingServerExports(mod);
+
+        TraceCapture.Start(path);
+        try
+        {
+            exports.ServerActivate(MockEngine.Edicts, Edicts, 32);
+
+            var entity = MockEngine.EdictAt(5);
+            entity->free.Value = 0;
+            entity->v.origin = new Vector3(64, -32, 8);
+            exports.Spawn(entity);
+            exports.Think(entity);
+            exports.Think(entity);
+
+            var kvd = new KeyValueData
+            {
+                szClassName = MockEngine.Text("func_door"),
+                szKeyName = MockEngine.Text("speed"),
+                szValue = MockEngine.Text("120"),
+            };
+            exports.KeyValue(entity, &kvd);
+            Assert.Equal(1, kvd.fHandled);
+
+            exports.GetGameDescription();
+            exports.ShouldCollide(entity, MockEngine.EdictAt(0));
+        }
+        finally
+        {
+            TraceCapture.Stop();
+        }
+
+        try
+        {
+            test(path, mod);
+        }
+        finally
+        {
+            File.Delete(path);
+        }
+    }
+
+    private static TraceCall[] Calls(TraceReader trace)
+    {
+        var calls = new List<TraceCall>();
+        foreach (var record in trace)
+        {
+            if (record.Header.Type == TraceRecordType.Call)
+                calls.Add(record.Header.Call);
+        }
+        return calls.ToArray();
+    }
+
+    // File offset of the n-th call record.
+    private static int RecordOffset(byte[] bytes, int call)
+    {
+        int offset = sizeof(TraceFileHeader);
+        while (true)
+        {
+            fixed (byte* p = &bytes[offset])
+            {
+                var header = (TraceRecordHeader*)p;
+                if (header->Type == TraceRecordType.Call && call-- == 0)
+                    return offset;
+                offset += sizeof(TraceRecordHeader) + header->Length;
+            }
+        }
+    }
+}
@@ -0,0 +1,117 @@
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Replay;
+using GoldsrcFramework.Strings;
+using NativeInterop;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+[Collection(MockEngineCollection.Name)]
+public unsafe class Utf8StringPoolTests
+{
+    [Fact]
+    public void EqualStringsShareOnePointer()
+    {
+        using var pool = new Utf8StringPool();
+
+        var model = pool.Intern("models/player.mdl");
+        Assert.True(model == pool.Intern("models/player.mdl"));
+        Assert.True(model == pool.Intern("models/player.mdl\0"u8));
+        Assert.True(model != pool.Intern("models/Player.mdl"));
+        Assert.Equal("models/player.mdl"u8.ToArray(), new Utf8View(model).Span.ToArray());
+
+        var stats = pool.Stats;
+        Assert.Equal(2, stats.Strings);
+        Assert.Equal(4, stats.Lookups);
+        Assert.Equal(2, stats.Hits);
+    }
+
+    [Fact]
+    public void SharedAndLevelStringsAreSeparate()
+    {
+        var shared = Utf8StringPool.Shared.Intern("weapon_crowbar");
+        var level = Utf8StringPool.Level.Intern("weapon_crowbar");
+
+        Assert.True(shared != level);
+        Assert.True(shared == Utf8StringPool.Shared.Intern("weapon_crowbar"));
+        Assert.True(level == Utf8StringPool.Level.Intern("weapon_crowbar"));
+    }
+
+    [Fact]
+    public void ResetDropsOnlyThatPool()
+    {
+        using var shared = new Utf8StringPool();
+        using var level = new Utf8StringPool();
+        var kept = shared.Intern("sound/items/gunpickup2.wav");
+        level.Intern("sound/items/gunpickup2.wav");
+
+        level.Reset();
+
+        Assert.Equal(0, level.Stats.Strings);
+        Assert.Equal(1, shared.Stats.Strings);
+        Assert.True(kept == shared.Intern("sound/items/gunpickup2.wav"));
+        Assert.Equal("sound/items/gunpickup2.wav"u8.ToArray(), new Utf8View(kept).Span.ToArray());
+    }
+
+    [Fact]
+    public void LevelStringsLiveUntilTheNextMapsFirstEntity()
+    {
+        MockEngine.Initialize(64, "valve");
+        var server = new FrameworkServerExports();
+        var world = MockEngine.EdictAt(0);
+        var kvd = new KeyValueData
+        {
+            szClassName = MockEngine.Text("worldspawn"),
+            szKeyName = MockEngine.Text("wad"),
+            szValue = MockEngine.Text("halflife.wad"),
+        };
+
+        server.ServerActivate(MockEngine.Edicts, 64, 32);
+        var precached = Utf8StringPool.Level.Intern("models/w_crowbar.mdl");
+        int resets = Utf8StringPool.Level.Stats.Resets;
+
+        // The engine still reads the old level's precache names while it tears the level down.
+        server.ServerDeactivate();
+        server.OnFreeEntPrivateData(MockEngine.EdictAt(1));
+        Assert.Equal(resets, Utf8StringPool.Level.Stats.Resets);
+        Assert.True(precached == Utf8StringPool.Level.Intern("models/w_crowbar.mdl"));
+
+        // worldspawn's first key of the next map.
+        server.KeyValue(world, &kvd);
+        Assert.Equal(resets + 1, Utf8StringPool.Level.Stats.Resets);
+
+        // Once per map: the rest of worldspawn and the other entities keep the new level's strings.
+        var next = Utf8StringPool.Level.Intern("models/w_crowbar.mdl");
+        server.KeyValue(world, &kvd);
+        server.Spawn(world);
+        Assert.Equal(resets + 1, Utf8StringPool.Level.Stats.Resets);
+        Assert.True(next == Utf8StringPool.Level.Intern("models/w_crowbar.mdl"));
+    }
+
+    [Fact]
+    public void PoolGrowsPastOneBlock()
+    {
+        using var pool = new Utf8StringPool(blockSize: 256);
+        var strings = new nint[200];
+        for (int i = 0; i < strings.Length; i++)
+            strings[i] = (nint)pool.Intern($"models/gib_{i:D3}.mdl");
+
+        var stats = pool.Stats;
+        Assert.Equal(strings.Length, stats.Strings);
+        Assert.True(stats.Blocks > 1);
+        Assert.True(stats.BytesReserved >= stats.BytesUsed);
+
+        // Earlier blocks are not moved or reused as the table and arena grow.
+        for (int i = 0; i < strings.Length; i++)
+        {
+            Assert.Equal(strings[i], (nint)pool.Intern($"models/gib_{i:D3}.mdl"));
+            Assert.Equal($"models/gib_{i:D3}.mdl", new Utf8View((NChar*)strings[i]).ToString());
+        }
+
+        // A string larger than a quarter block gets its own block and leaves the current one in use.
+        int blocks = pool.Stats.Blocks;
+        var large = pool.Intern(new string('x', 300));
+        Assert.Equal(blocks + 1, pool.Stats.Blocks);
+        Assert.Equal(300, new Utf8View(large).Span.Length);
+    }
+}
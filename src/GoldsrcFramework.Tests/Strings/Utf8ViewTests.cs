@@ -0,0 +1,61 @@
+using GoldsrcFramework.Strings;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public class Utf8ViewTests
+{
+    [Fact]
+    public void CompareIgnoresAsciiCaseOnly()
+    {
+        Assert.True(new Utf8View("SAY_team"u8).EqualsIgnoreCase("say_TEAM"));
+        Assert.False(new Utf8View("say"u8).EqualsIgnoreCase("saz"));
+        Assert.True(new Utf8View("weapon_crowbar"u8).StartsWithIgnoreCase("WEAPON_"u8));
+    }
+
+    [Fact]
+    public void HashesFoldLettersButNotNeighbouringPunctuation()
+    {
+        Assert.Equal(new Utf8View("ABCDEFGHIJKLMNOPQRSTUVWXYZ[@`{"u8).GetStableHashCodeIgnoreCase(),
+                     new Utf8View("abcdefghijklmnopqrstuvwxyz[@`{"u8).GetStableHashCodeIgnoreCase());
+        Assert.NotEqual(new Utf8View("[@`{"u8).GetStableHashCodeIgnoreCase(), new Utf8View("{`@["u8).GetStableHashCodeIgnoreCase());
+        Assert.NotEqual(new Utf8View("info_player_start"u8).GetStableHashCode(), new Utf8View("info_player_Start"u8).GetStableHashCode());
+    }
+
+    [Fact]
+    public void NumbersParseLikeAtoiAndAtof()
+    {
+        Assert.Equal(-42, new Utf8View("  -42abc"u8).ToInt32());
+        Assert.Equal(int.MaxValue, new Utf8View("99999999999"u8).ToInt32());
+        Assert.Equal(0, new Utf8View("x"u8).ToInt32());
+        Assert.Equal(150f, new Utf8View(" 1.5e2 "u8).ToSingle());
+        Assert.Equal(-0.25f, new Utf8View("-0.25units"u8).ToSingle());
+    }
+
+    [Fact]
+    public void TryParseRejectsTrailingText()
+    {
+        Assert.True(new Utf8View(" 12 "u8).TryParseInt32(out int i));
+        Assert.Equal(12, i);
+        Assert.False(new Utf8View("12x"u8).TryParseInt32(out _));
+        Assert.True(new Utf8View("3.75"u8).TryParseSingle(out float f));
+        Assert.Equal(3.75f, f);
+    }
+
+    [Fact]
+    public void MapLooksUpIgnoringCaseAcrossGrowth()
+    {
+        string[] names = ["say", "say_team", "buy", "buyammo1", "menuselect", "fullupdate", "drop", "VModEnable", "vban", "kill"];
+        var map = new Utf8Map<int>(ignoreCase: true, capacity: 4);
+        for (int n = 0; n < names.Length; n++)
+            map.Set(names[n], n);
+
+        for (int n = 0; n < names.Length; n++)
+        {
+            Assert.True(map.TryGetValue(new Utf8View(System.Text.Encoding.UTF8.GetBytes(names[n].ToUpperInvariant())), out int v));
+            Assert.Equal(n, v);
+        }
+        Assert.False(map.ContainsKey("sa"u8));
+        Assert.Equal(names.Length, map.Count);
+    }
+}
@@ -0,0 +1,168 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Tick;
+using Xunit;
+
+namespace GoldsrcFramework.Tests;
+
+public unsafe class ParallelTickTests
+{
+    private const int EdictCount = 4;
+
+    /// <summary>
+    /// Moves its entity by <see cref="Step"/> and copies what it saw of entity 1 into its velocity.
+    /// </summary>
+    private sealed class StepBehaviour : EntityBehaviour
+    {
+        public Vector3 Step;
+        public bool Throw;
+        public Action<IntPtr>? OnCustom;
+
+        public override void Tick(WorldSnapshot world, in EntitySnapshot self, ref TickCommandWriter commands)
+        {
+            if (Throw)
+                throw new InvalidOperationException();
+
+            commands.Move(self.Origin + Step);
+            commands.SetVelocity(world[1].Origin);
+            if (OnCustom != null)
+                commands.Custom(1);
+        }
+
+        public override void OnCommand(edict_t* edict, in TickCommand command)
+        {
+            if (command.Kind == TickCommandKind.Custom)
+                OnCustom?.Invoke((IntPtr)edict);
+        }
+    }
+
+    /// <summary>
+    /// Heads for the nearest entity of the other team, so every tick depends on where the others were.
+    /// </summary>
+    private sealed class ChaseBehaviour : EntityBehaviour
+    {
+        public override void Tick(WorldSnapshot world, in EntitySnapshot self, ref TickCommandWriter commands)
+        {
+            var entities = world.Entities;
+            int best = 0;
+            float bestDist = float.MaxValue;
+            for (int i = 1; i < entities.Length; i++)
+            {
+                float dist = (entities[i].Origin - self.Origin).LengthSquared();
+                if (entities[i].InUse && entities[i].Team != self.Team && dist < bestDist)
+                {
+                    bestDist = dist;
+                    best = i;
+                }
+            }
+
+            if (best != 0 && bestDist > 0)
+                commands.Move(self.Origin + (world[best].Origin - self.Origin) * (50 / MathF.Sqrt(bestDist)));
+        }
+    }
+
+    [Theory]
+    [InlineData(2)]
+    [InlineData(4)]
+    public void FinalStateDoesNotDependOnWorkerCount(int workers)
+    {
+        const int Entities = 257;
+        using var serial = new FakeWorld(Entities);
+        using var parallel = new FakeWorld(Entities);
+
+        foreach (var (world, workerCount) in new[] { (serial, 1), (parallel, workers) })
+        {
+            var rng = new Random(1234);
+            var tick = new ParallelTick(workerCount, chunkSize: 16);
+            for (int i = 1; i < Entities; i++)
+            {
+                world.Edicts[i].v.origin = new Vector3(rng.NextSingle() * 4096 - 2048, rng.NextSingle() * 4096 - 2048, 0);
+                world.Edicts[i].v.team = i & 1;
+                tick.Register(new ChaseBehaviour(), i);
+            }
+
+            for (int frame = 0; frame < 20; frame++)
+                tick.Run(world.Engine, world.Edicts, Entities, 1 + frame * 0.01f, 0.01f);
+        }
+
+        for (int i = 1; i < Entities; i++)
+            Assert.Equal(serial.Edicts[i].v.origin, parallel.Edicts[i].v.origin);
+    }
+
+    [Fact]
+    public void BehavioursSeeTheFrameStartSnapshot()
+    {
+        using var world = new FakeWorld();
+        var tick = new ParallelTick(workerCount: 1, chunkSize: 1);
+        tick.Register(new StepBehaviour { Step = new Vector3(10, 0, 0) }, 1);
+        tick.Register(new StepBehaviour(), 2);
+
+        tick.Run(world.Engine, world.Edicts, EdictCount, 1, 0.1f);
+
+        Assert.Equal(new Vector3(10, 0, 0), world.Edicts[1].v.origin);
+        Assert.Equal(default, world.Edicts[2].v.velocity);
+        Assert.Equal(2, tick.LastTick.Behaviours);
+        Assert.Equal(4, tick.LastTick.Commands);
+    }
+
+    [Fact]
+    public void CommandsForAReusedEdictAreDropped()
+    {
+        using var world = new FakeWorld();
+        var tick = new ParallelTick(workerCount: 1, chunkSize: 1);
+        var edicts = world.Edicts;
+        tick.Register(new StepBehaviour { OnCustom = _ => edicts[2].serialnumber++ }, 1);
+        tick.Register(new StepBehaviour { Step = new Vector3(0, 5, 0) }, 2);
+
+        tick.Run(world.Engine, world.Edicts, EdictCount, 1, 0.1f);
+
+        Assert.Equal(2, tick.LastTick.StaleCommands);
+        Assert.Equal(default, world.Edicts[2].v.origin);
+    }
+
+    [Fact]
+    public void ThrowingBehaviourIsCountedAndOthersStillApply()
+    {
+        using var world = new FakeWorld();
+        var tick = new ParallelTick(workerCount: 2, chunkSize: 1);
+        tick.Register(new StepBehaviour { Throw = true }, 1);
+        tick.Register(new StepBehaviour { Step = new Vector3(0, 0, 3) }, 2);
+
+        tick.Run(world.Engine, world.Edicts, EdictCount, 1, 0.1f);
+
+        Assert.Equal(1, tick.LastTick.Faults);
+        Assert.Equal(new Vector3(0, 0, 3), world.Edicts[2].v.origin);
+    }
+
+    private sealed class FakeWorld : IDisposable
+    {
+        public readonly edict_t* Edicts;
+        public readonly ServerEngineFuncs* Engine;
+
+        public FakeWorld(int edictCount = EdictCount)
+        {
+            Edicts = (edict_t*)NativeMemory.AllocZeroed((nuint)edictCount, (nuint)sizeof(edict_t));
+            Engine = (ServerEngineFuncs*)NativeMemory.AllocZeroed((nuint)sizeof(ServerEngineFuncs));
+            Engine->SetOrigin = &SetOrigin;
+            for (int i = 1; i < edictCount; i++)
+            {
+                Edicts[i].serialnumber = i;
+                Edicts[i].pvPrivateData = &Edicts[i];
+            }
+        }
+
+        public void Dispose()
+        {
+            NativeMemory.Free(Engine);
+            NativeMemory.Free(Edicts);
+        }
+
+        [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+        private static void SetOrigin(edict_t* e, float* origin)
+        {
+            e->v.origin = new Vector3(origin[0], origin[1], origin[2]);
+        }
+    }
+}
@@ -0,0 +1,135 @@
+using System.IO.MemoryMappedFiles;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+
+namespace GoldsrcFramework.Bsp;
+
+/// <summary>
+/// Read-only view over a BSP30 file, either memory-mapped from disk or over an in-memory buffer.
+/// Lumps are exposed as spans of the on-disk structs (dplane_t, dnode_t, dclipnode_t, ...) without copying.
+/// </summary>
+public sealed unsafe class BspFile : IDisposable
+{
+    private readonly MemoryMappedFile? _mappedFile;
+    private readonly MemoryMappedViewAccessor? _view;
+    private readonly GCHandle _pinned;
+    private byte* _base;
+    private readonly long _length;
+
+    private BspFile(MemoryMappedFile mappedFile, MemoryMappedViewAccessor view, long length)
+    {
+        _mappedFile = mappedFile;
+        _view = view;
+        _length = length;
+
+        byte* ptr = null;
+        view.SafeMemoryMappedViewHandle.AcquirePointer(ref ptr);
+        _base = ptr + view.PointerOffset;
+        Validate();
+    }
+
+    private BspFile(byte[] data)
+    {
+        _pinned = GCHandle.Alloc(data, GCHandleType.Pinned);
+        _base = (byte*)_pinned.AddrOfPinnedObject();
+        _length = data.Length;
+        Validate();
+    }
+
+    /// <summary>
+    /// Memory-map a .bsp file.
+    /// </summary>
+    public static BspFile Open(string path)
+    {
+        long length = new FileInfo(path).Length;
+        var mappedFile = MemoryMappedFile.CreateFromFile(path, FileMode.Open, null, 0, MemoryMappedFileAccess.Read);
+        try
+        {
+            var view = mappedFile.CreateViewAccessor(0, length, MemoryMappedFileAccess.Read);
+            return new BspFile(mappedFile, view, length);
+        }
+        catch
+        {
+            mappedFile.Dispose();
+            throw;
+        }
+    }
+
+    /// <summary>
+    /// Wrap an in-memory .bsp image. The array is pinned for the lifetime of the view.
+    /// </summary>
+    public static BspFile FromBytes(byte[] data) => new(data);
+
+    /// <summary>
+    /// Size of the file in bytes.
+    /// </summary>
+    public long Length => _length;
+
+    /// <summary>
+    /// The file header.
+    /// </summary>
+    public ref readonly dheader_t Header => ref *(dheader_t*)_base;
+
+    /// <summary>
+    /// Raw bytes of a lump (BspConstants.LUMP_*).
+    /// </summary>
+    public ReadOnlySpan<byte> GetLumpBytes(int lump)
+    {
+        ref readonly var l = ref Header.lumps[lump];
+        return new ReadOnlySpan<byte>(_base + l.fileofs, l.filelen);
+    }
+
+    /// <summary>
+    /// A lump as an array of <typeparamref name="T"/>.
+    /// </summary>
+    public ReadOnlySpan<T> GetLump<T>(int lump) where T : unmanaged
+    {
+        ref readonly var l = ref Header.lumps[lump];
+        if (l.filelen % sizeof(T) != 0)
+            throw new InvalidDataException($"Lump {lump} size {l.filelen} is not a multiple of {typeof(T).Name} ({sizeof(T)} bytes)");
+
+        return new ReadOnlySpan<T>(_base + l.fileofs, l.filelen / sizeof(T));
+    }
+
+    public ReadOnlySpan<dplane_t> Planes => GetLump<dplane_t>(BspConstants.LUMP_PLANES);
+    public ReadOnlySpan<dnode_t> Nodes => GetLump<dnode_t>(BspConstants.LUMP_NODES);
+    public ReadOnlySpan<dclipnode_t> ClipNodes => GetLump<dclipnode_t>(BspConstants.LUMP_CLIPNODES);
+    public ReadOnlySpan<dleaf_t> Leafs => GetLump<dleaf_t>(BspConstants.LUMP_LEAFS);
+    public ReadOnlySpan<dmodel_t> Models => GetLump<dmodel_t>(BspConstants.LUMP_MODELS);
+    public ReadOnlySpan<byte> Visibility => GetLumpBytes(BspConstants.LUMP_VISIBILITY);
+    public ReadOnlySpan<byte> Entities => GetLumpBytes(BspConstants.LUMP_ENTITIES);
+
+    private void Validate()
+    {
+        if (_length < sizeof(dheader_t))
+            throw new InvalidDataException("File is too small to be a BSP");
+
+        ref readonly var header = ref Header;
+        if (header.version != BspConstants.BSPVERSION)
+            throw new InvalidDataException($"Wrong BSP version {header.version} (should be {BspConstants.BSPVERSION})");
+
+        for (int i = 0; i < BspConstants.HEADER_LUMPS; i++)
+        {
+            ref readonly var l = ref header.lumps[i];
+            if (l.fileofs < 0 || l.filelen < 0 || (long)l.fileofs + l.filelen > _length)
+                throw new InvalidDataException($"Lump {i} is out of bounds");
+        }
+    }
+
+    public void Dispose()
+    {
+        if (_base == null)
+            return;
+
+        _base = null;
+        if (_view != null)
+        {
+            _view.SafeMemoryMappedViewHandle.ReleasePointer();
+            _view.Dispose();
+            _mappedFile!.Dispose();
+        }
+        if (_pinned.IsAllocated)
+            _pinned.Free();
+    }
+}
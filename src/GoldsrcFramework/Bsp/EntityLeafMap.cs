@@ -0,0 +1,184 @@
+using System.Numerics;
+using Vector3 = GoldsrcFramework.LinearMath.Vector3;
+
+namespace GoldsrcFramework.Bsp;
+
+/// <summary>
+/// Which leafs each entity touches and which entities touch each leaf, kept up to date from SetAbsBox.
+///
+/// Entities are linked to up to <see cref="MaxEntityLeafs"/> leafs like SV_FindTouchedLeafs; an entity spanning more
+/// is treated as visible from everywhere. "Which entities can X see" then walks only the leafs that are both in X's
+/// PVS and occupied, instead of testing every entity against the PVS.
+/// Main thread only.
+/// </summary>
+public sealed class EntityLeafMap
+{
+    /// <summary>
+    /// MAX_ENT_LEAFS.
+    /// </summary>
+    public const int MaxEntityLeafs = 48;
+
+    private const byte Overflow = byte.MaxValue;
+
+    private readonly VisibilityCache _visibility;
+    private readonly short[] _leafs;
+    private readonly byte[] _leafCounts;
+    private readonly int[] _next;
+    private readonly int[] _prev;
+    private readonly int[] _leafHead;
+    private readonly ulong[] _occupied;
+    private readonly ulong[] _everywhere;
+    private readonly int[] _scratch = new int[MaxEntityLeafs];
+
+    public EntityLeafMap(VisibilityCache visibility, int maxEntities)
+    {
+        _visibility = visibility;
+        MaxEntities = maxEntities;
+        _leafs = new short[maxEntities * MaxEntityLeafs];
+        _leafCounts = new byte[maxEntities];
+        _next = new int[maxEntities * MaxEntityLeafs];
+        _prev = new int[maxEntities * MaxEntityLeafs];
+        _leafHead = new int[visibility.LeafCount + 1];
+        _leafHead.AsSpan().Fill(-1);
+        _occupied = new ulong[visibility.RowWords];
+        _everywhere = new ulong[EntityWords];
+    }
+
+    public int MaxEntities { get; }
+
+    /// <summary>
+    /// Length in ulongs of an entity set (bit = entity index).
+    /// </summary>
+    public int EntityWords => VisBits.WordsFor(MaxEntities);
+
+    /// <summary>
+    /// Relink <paramref name="entity"/> to the leafs touched by its absolute box.
+    /// </summary>
+    public void Update(int entity, Vector3 absMin, Vector3 absMax)
+    {
+        if ((uint)entity >= (uint)MaxEntities)
+            return;
+
+        Remove(entity);
+        int count = _visibility.BoxLeafs(absMin, absMax, _scratch);
+        if (count < 0)
+        {
+            _leafCounts[entity] = Overflow;
+            VisBits.Set(_everywhere, entity);
+            return;
+        }
+
+        int baseSlot = entity * MaxEntityLeafs;
+        for (int k = 0; k < count; k++)
+        {
+            int leaf = _scratch[k];
+            if (leaf > _visibility.LeafCount)
+                continue;
+
+            int slot = baseSlot + _leafCounts[entity]++;
+            _leafs[slot] = (short)leaf;
+            int head = _leafHead[leaf];
+            _next[slot] = head;
+            _prev[slot] = -1;
+            if (head >= 0)
+                _prev[head] = slot;
+            else
+                VisBits.Set(_occupied, leaf - 1);
+            _leafHead[leaf] = slot;
+        }
+    }
+
+    /// <summary>
+    /// Unlink <paramref name="entity"/> (freed, or no longer in the world).
+    /// </summary>
+    public void Remove(int entity)
+    {
+        if ((uint)entity >= (uint)MaxEntities)
+            return;
+
+        int count = _leafCounts[entity];
+        _leafCounts[entity] = 0;
+        if (count == Overflow)
+        {
+            VisBits.Clear(_everywhere, entity);
+            return;
+        }
+
+        int baseSlot = entity * MaxEntityLeafs;
+        for (int slot = baseSlot; slot < baseSlot + count; slot++)
+        {
+            int leaf = _leafs[slot];
+            int next = _next[slot], prev = _prev[slot];
+            if (prev >= 0)
+                _next[prev] = next;
+            else
+                _leafHead[leaf] = next;
+            if (next >= 0)
+                _prev[next] = prev;
+            if (_leafHead[leaf] < 0)
+                VisBits.Clear(_occupied, leaf - 1);
+        }
+    }
+
+    public void Clear()
+    {
+        _leafCounts.AsSpan().Clear();
+        _leafHead.AsSpan().Fill(-1);
+        _occupied.AsSpan().Clear();
+        _everywhere.AsSpan().Clear();
+    }
+
+    /// <summary>
+    /// Leafs <paramref name="entity"/> is linked to; empty when it touches none or is visible from everywhere.
+    /// </summary>
+    public ReadOnlySpan<short> GetLeafs(int entity)
+    {
+        int count = _leafCounts[entity];
+        return count == Overflow ? default : _leafs.AsSpan(entity * MaxEntityLeafs, count);
+    }
+
+    public bool IsEverywhere(int entity) => _leafCounts[entity] == Overflow;
+
+    /// <summary>
+    /// True when any leaf of <paramref name="entity"/> is in <paramref name="leafSet"/> (a PVS / PAS row), as the
+    /// engine's CheckVisibility decides.
+    /// </summary>
+    public bool IsInSet(int entity, ReadOnlySpan<ulong> leafSet)
+    {
+        int count = _leafCounts[entity];
+        if (count == Overflow)
+            return true;
+
+        var leafs = _leafs.AsSpan(entity * MaxEntityLeafs, count);
+        foreach (short leaf in leafs)
+        {
+            if (VisBits.Test(leafSet, leaf - 1))
+                return true;
+        }
+        return false;
+    }
+
+    /// <summary>
+    /// Set the bit of every entity with a leaf in <paramref name="leafSet"/> in <paramref name="entities"/>
+    /// (<see cref="EntityWords"/> long). Returns the number of entities.
+    /// </summary>
+    public int CollectInSet(ReadOnlySpan<ulong> leafSet, Span<ulong> entities)
+    {
+        entities.Clear();
+        VisBits.Or(entities, _everywhere);
+
+        int words = Math.Min(leafSet.Length, _occupied.Length);
+        for (int w = 0; w < words; w++)
+        {
+            ulong hits = leafSet[w] & _occupied[w];
+            while (hits != 0)
+            {
+                int leaf = (w << 6) + BitOperations.TrailingZeroCount(hits) + 1;
+                hits &= hits - 1;
+                for (int slot = _leafHead[leaf]; slot >= 0; slot = _next[slot])
+                    VisBits.Set(entities, slot / MaxEntityLeafs);
+            }
+        }
+        return VisBits.PopCount(entities);
+    }
+}
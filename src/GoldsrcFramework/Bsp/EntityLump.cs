@@ -0,0 +1,270 @@
+using System.Numerics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Runtime.Intrinsics;
+using GoldsrcFramework.Strings;
+
+namespace GoldsrcFramework.Bsp;
+
+/// <summary>
+/// One entity of an <see cref="EntityLump"/>: its classname and key / value pairs, as views into the lump text.
+/// </summary>
+public readonly struct EntityRecord
+{
+    private readonly EntityLump _lump;
+
+    internal EntityRecord(EntityLump lump, int index)
+    {
+        _lump = lump;
+        Index = index;
+    }
+
+    /// <summary>
+    /// Position in the lump; worldspawn is 0.
+    /// </summary>
+    public int Index { get; }
+
+    public Utf8View Classname => _lump.GetClassname(Index);
+
+    public int PairCount => _lump.GetPairRange(Index).Count;
+
+    public Utf8View Key(int pair) => _lump.GetKey(_lump.GetPairRange(Index).First + pair);
+
+    public Utf8View Value(int pair) => _lump.GetValue(_lump.GetPairRange(Index).First + pair);
+
+    /// <summary>
+    /// Value of the last pair named <paramref name="key"/>, as the engine keeps the last one on duplicates.
+    /// </summary>
+    public bool TryGetValue(Utf8View key, out Utf8View value)
+    {
+        var (first, count) = _lump.GetPairRange(Index);
+        for (int i = first + count - 1; i >= first; i--)
+        {
+            if (_lump.GetKey(i).Equals(key))
+            {
+                value = _lump.GetValue(i);
+                return true;
+            }
+        }
+
+        value = default;
+        return false;
+    }
+}
+
+/// <summary>
+/// The BSP entity lump parsed in one pass: <c>{ "key" "value" ... }</c> blocks, // comments allowed between tokens.
+///
+/// The tokenizer classifies 64 bytes at a time into a bitmask of structural characters ({ } " /) with SIMD
+/// compares and walks only the set bits, so the text between tokens is never looked at byte by byte. It records
+/// offsets only; keys and values are read back as <see cref="Utf8View"/>s over a
+/// single copy of the lump, so nothing is decoded until a setter asks for it.
+/// </summary>
+public sealed class EntityLump
+{
+    private struct Pair
+    {
+        public int Key, KeyLength, Value, ValueLength;
+    }
+
+    private struct Entity
+    {
+        public int FirstPair, PairCount, ClassnamePair;
+    }
+
+    private readonly byte[] _text;
+    private Pair[] _pairs = Array.Empty<Pair>();
+    private Entity[] _entities = Array.Empty<Entity>();
+    private int _pairCount;
+    private int _entityCount;
+
+    private EntityLump(byte[] text)
+    {
+        _text = text;
+    }
+
+    /// <summary>
+    /// Parse the entity lump of <paramref name="bsp"/>. The lump is copied, so the file may be closed afterwards.
+    /// </summary>
+    public static EntityLump Load(BspFile bsp) => Parse(bsp.Entities);
+
+    /// <summary>
+    /// Parse entity lump text. Throws <see cref="InvalidDataException"/> on malformed input.
+    /// </summary>
+    public static EntityLump Parse(ReadOnlySpan<byte> text)
+    {
+        // The lump is null-terminated on disk.
+        int end = text.IndexOf((byte)0);
+        var lump = new EntityLump(text[..(end < 0 ? text.Length : end)].ToArray());
+        lump.Tokenize();
+        return lump;
+    }
+
+    /// <summary>
+    /// Number of entities, including worldspawn.
+    /// </summary>
+    public int Count => _entityCount;
+
+    /// <summary>
+    /// Total number of key / value pairs.
+    /// </summary>
+    public int PairCount => _pairCount;
+
+    /// <summary>
+    /// Size of the lump text in bytes.
+    /// </summary>
+    public int Length => _text.Length;
+
+    public EntityRecord this[int index] =>
+        (uint)index < (uint)_entityCount ? new EntityRecord(this, index) : throw new ArgumentOutOfRangeException(nameof(index));
+
+    internal Utf8View GetKey(int pair) => new(_text.AsSpan(_pairs[pair].Key, _pairs[pair].KeyLength));
+
+    internal Utf8View GetValue(int pair) => new(_text.AsSpan(_pairs[pair].Value, _pairs[pair].ValueLength));
+
+    internal (int First, int Count) GetPairRange(int entity) => (_entities[entity].FirstPair, _entities[entity].PairCount);
+
+    internal Utf8View GetClassname(int entity)
+    {
+        int pair = _entities[entity].ClassnamePair;
+        return pair < 0 ? default : GetValue(pair);
+    }
+
+    private void Tokenize()
+    {
+        ReadOnlySpan<byte> text = _text;
+
+        // Quotes come in fours per pair, braces in twos per entity: size everything once.
+        _pairs = new Pair[Math.Max(text.Count((byte)'"') / 4, 1)];
+        _entities = new Entity[Math.Max(text.Count((byte)'{'), 1)];
+
+        int entityStart = -1;
+        int stringStart = -1;
+        int pendingKey = -1, pendingKeyLength = 0;
+        int skipUntil = 0;
+
+        Span<byte> tail = stackalloc byte[64];
+        for (int block = 0; block < text.Length; block += 64)
+        {
+            ulong mask;
+            if (block + 64 <= text.Length)
+            {
+                mask = StructuralMask(text.Slice(block, 64));
+            }
+            else
+            {
+                tail.Clear();
+                text[block..].CopyTo(tail);
+                mask = StructuralMask(tail);
+            }
+
+            for (; mask != 0; mask &= mask - 1)
+            {
+                int pos = block + BitOperations.TrailingZeroCount(mask);
+                if (pos < skipUntil)
+                    continue;
+                byte c = text[pos];
+
+                // Inside a string only the closing quote counts; strings may span lines, as in COM_Parse.
+                if (stringStart >= 0)
+                {
+                    if (c != '"')
+                        continue;
+
+                    if (pendingKey < 0)
+                    {
+                        pendingKey = stringStart;
+                        pendingKeyLength = pos - stringStart;
+                    }
+                    else
+                    {
+                        AddPair(pendingKey, pendingKeyLength, stringStart, pos - stringStart);
+                        pendingKey = -1;
+                    }
+                    stringStart = -1;
+                    continue;
+                }
+
+                switch (c)
+                {
+                    case (byte)'"':
+                        if (entityStart < 0)
+                            throw Malformed(pos, "string outside an entity");
+                        stringStart = pos + 1;
+                        break;
+
+                    case (byte)'{':
+                        if (entityStart >= 0)
+                            throw Malformed(pos, "nested '{'");
+                        entityStart = _pairCount;
+                        break;
+
+                    case (byte)'}':
+                        if (entityStart < 0)
+                            throw Malformed(pos, "'}' without '{'");
+                        if (pendingKey >= 0)
+                            throw Malformed(pos, "key without value");
+                        CloseEntity(entityStart);
+                        entityStart = -1;
+                        break;
+
+                    default:
+                        // '/': a // comment runs to the end of the line; a lone '/' is stray text.
+                        if (pos + 1 < text.Length && text[pos + 1] == '/')
+                        {
+                            int eol = text[pos..].IndexOf((byte)'\n');
+                            skipUntil = eol < 0 ? text.Length : pos + eol + 1;
+                        }
+                        break;
+                }
+            }
+        }
+
+        if (stringStart >= 0)
+            throw Malformed(stringStart - 1, "unterminated string");
+        if (entityStart >= 0)
+            throw Malformed(text.Length, "missing '}'");
+    }
+
+    // Bit i set when block[i] is one of { } " /.
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static ulong StructuralMask(ReadOnlySpan<byte> block)
+    {
+        ref byte start = ref MemoryMarshal.GetReference(block);
+        ulong mask = 0;
+        for (int i = 0; i < 64; i += 16)
+        {
+            var v = Vector128.LoadUnsafe(ref start, (nuint)i);
+            var hits = Vector128.Equals(v, Vector128.Create((byte)'"')) |
+                       Vector128.Equals(v, Vector128.Create((byte)'{')) |
+                       Vector128.Equals(v, Vector128.Create((byte)'}')) |
+                       Vector128.Equals(v, Vector128.Create((byte)'/'));
+            mask |= (ulong)hits.ExtractMostSignificantBits() << i;
+        }
+        return mask;
+    }
+
+    private void AddPair(int key, int keyLength, int value, int valueLength)
+    {
+        if (_pairCount == _pairs.Length)
+            Array.Resize(ref _pairs, _pairs.Length * 2);
+        _pairs[_pairCount++] = new Pair { Key = key, KeyLength = keyLength, Value = value, ValueLength = valueLength };
+    }
+
+    private void CloseEntity(int firstPair)
+    {
+        int classname = -1;
+        for (int i = firstPair; i < _pairCount; i++)
+        {
+            if (GetKey(i).Equals("classname"u8))
+                classname = i;
+        }
+
+        if (_entityCount == _entities.Length)
+            Array.Resize(ref _entities, _entities.Length * 2);
+        _entities[_entityCount++] = new Entity { FirstPair = firstPair, PairCount = _pairCount - firstPair, ClassnamePair = classname };
+    }
+
+    private static InvalidDataException Malformed(int offset, string reason) =>
+        new($"Malformed entity lump at byte {offset}: {reason}");
+}
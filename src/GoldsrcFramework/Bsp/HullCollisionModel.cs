@@ -0,0 +1,450 @@
+using System.Runtime.CompilerServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+
+namespace GoldsrcFramework.Bsp;
+
+/// <summary>
+/// One trace against a clipping hull.
+/// </summary>
+public readonly struct HullTraceRequest
+{
+    public readonly Vector3 Start;
+    public readonly Vector3 End;
+    public readonly int Hull;
+
+    public HullTraceRequest(Vector3 start, Vector3 end, int hull = 0)
+    {
+        Start = start;
+        End = end;
+        Hull = hull;
+    }
+}
+
+/// <summary>
+/// Result of a hull trace. Same meaning as the engine's TraceResult minus the hit entity.
+/// </summary>
+public struct HullTraceResult
+{
+    /// <summary>If true, plane is not valid.</summary>
+    public bool AllSolid;
+    /// <summary>If true, the initial point was in a solid area.</summary>
+    public bool StartSolid;
+    public bool InOpen;
+    public bool InWater;
+    /// <summary>Time completed, 1.0 = didn't hit anything.</summary>
+    public float Fraction;
+    /// <summary>Final position.</summary>
+    public Vector3 EndPos;
+    /// <summary>Surface normal at impact.</summary>
+    public Vector3 PlaneNormal;
+    public float PlaneDist;
+}
+
+/// <summary>
+/// Managed copy of a brush model's clipping hulls (hull 0 = point, 1 = human, 2 = large, 3 = head/duck).
+///
+/// Point contents and traces walk the clipnode trees with the same math as SV_HullPointContents /
+/// SV_RecursiveHullCheck, so results match the engine's world traces without crossing into it.
+/// The model is immutable after construction; any number of threads may trace concurrently.
+/// </summary>
+public sealed class HullCollisionModel
+{
+    /// <summary>
+    /// 1/32 epsilon to keep floating point happy.
+    /// </summary>
+    public const float DIST_EPSILON = 0.03125f;
+
+    private struct HullPlane
+    {
+        public Vector3 Normal;
+        public float Dist;
+        public int Type;
+    }
+
+    private struct HullClipNode
+    {
+        public int PlaneNum;
+        public int Child0;
+        public int Child1;
+    }
+
+    private struct Hull
+    {
+        public HullClipNode[] ClipNodes;
+        public int FirstClipNode;
+        public int LastClipNode;
+        public Vector3 ClipMins;
+        public Vector3 ClipMaxs;
+    }
+
+    // Standard GoldSrc hull sizes (Mod_LoadClipnodes).
+    private static readonly Vector3[] s_hullMins =
+    [
+        new(0, 0, 0), new(-16, -16, -36), new(-32, -32, -32), new(-16, -16, -18),
+    ];
+    private static readonly Vector3[] s_hullMaxs =
+    [
+        new(0, 0, 0), new(16, 16, 36), new(32, 32, 32), new(16, 16, 18),
+    ];
+
+    private readonly HullPlane[] _planes;
+    private readonly Hull[] _hulls = new Hull[BspConstants.MAX_MAP_HULLS];
+
+    private HullCollisionModel(HullPlane[] planes)
+    {
+        _planes = planes;
+    }
+
+    /// <summary>
+    /// Load every brush model (world = 0, then the *N submodels) of a BSP.
+    /// The models share one copy of the planes and clipnodes.
+    /// </summary>
+    public static HullCollisionModel[] LoadAll(BspFile bsp)
+    {
+        var planes = LoadPlanes(bsp.Planes);
+        var hull0 = MakeHull0(bsp.Nodes, bsp.Leafs);
+        var clipNodes = LoadClipNodes(bsp.ClipNodes);
+
+        var models = bsp.Models;
+        var result = new HullCollisionModel[models.Length];
+        for (int i = 0; i < models.Length; i++)
+        {
+            var model = new HullCollisionModel(planes);
+            model._hulls[0] = new Hull
+            {
+                ClipNodes = hull0,
+                FirstClipNode = models[i].headnode[0],
+                LastClipNode = hull0.Length - 1,
+            };
+
+            for (int j = 1; j < BspConstants.MAX_MAP_HULLS; j++)
+            {
+                model._hulls[j] = new Hull
+                {
+                    ClipNodes = clipNodes,
+                    FirstClipNode = models[i].headnode[j],
+                    LastClipNode = clipNodes.Length - 1,
+                    ClipMins = s_hullMins[j],
+                    ClipMaxs = s_hullMaxs[j],
+                };
+            }
+
+            result[i] = model;
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// Load the world model (model 0) of a BSP.
+    /// </summary>
+    public static HullCollisionModel LoadWorld(BspFile bsp) => LoadAll(bsp)[0];
+
+    /// <summary>
+    /// Snapshot the hulls of a model loaded by the engine (e.g. sv.worldmodel or a brush entity's model).
+    /// The copy stays valid after the engine frees the model at level change.
+    /// </summary>
+    public static unsafe HullCollisionModel FromModel(model_t* model)
+    {
+        if (model == null)
+            throw new ArgumentNullException(nameof(model));
+
+        var planes = new HullPlane[model->numplanes];
+        for (int i = 0; i < planes.Length; i++)
+        {
+            ref var p = ref model->planes[i];
+            planes[i] = new HullPlane { Normal = p.normal, Dist = p.dist, Type = p.type };
+        }
+
+        var result = new HullCollisionModel(planes);
+        for (int i = 0; i < BspConstants.MAX_MAP_HULLS; i++)
+        {
+            ref var hull = ref model->hulls[i];
+            var clipNodes = Array.Empty<HullClipNode>();
+            if (hull.clipnodes != null && hull.lastclipnode >= 0)
+            {
+                clipNodes = new HullClipNode[hull.lastclipnode + 1];
+                for (int j = 0; j < clipNodes.Length; j++)
+                {
+                    ref var c = ref hull.clipnodes[j];
+                    clipNodes[j] = new HullClipNode { PlaneNum = c.planenum, Child0 = c.children[0], Child1 = c.children[1] };
+                }
+            }
+
+            result._hulls[i] = new Hull
+            {
+                ClipNodes = clipNodes,
+                FirstClipNode = hull.firstclipnode,
+                LastClipNode = hull.lastclipnode,
+                ClipMins = hull.clip_mins,
+                ClipMaxs = hull.clip_maxs,
+            };
+        }
+
+        return result;
+    }
+
+    private static HullPlane[] LoadPlanes(ReadOnlySpan<dplane_t> planes)
+    {
+        var result = new HullPlane[planes.Length];
+        for (int i = 0; i < planes.Length; i++)
+            result[i] = new HullPlane { Normal = planes[i].normal, Dist = planes[i].dist, Type = planes[i].type };
+        return result;
+    }
+
+    private static HullClipNode[] LoadClipNodes(ReadOnlySpan<dclipnode_t> clipNodes)
+    {
+        var result = new HullClipNode[clipNodes.Length];
+        for (int i = 0; i < clipNodes.Length; i++)
+            result[i] = new HullClipNode { PlaneNum = clipNodes[i].planenum, Child0 = clipNodes[i].children[0], Child1 = clipNodes[i].children[1] };
+        return result;
+    }
+
+    /// <summary>
+    /// Duplicate the drawing hull structure as a clipping hull.
+    /// Original: Mod_MakeHull0
+    /// </summary>
+    private static HullClipNode[] MakeHull0(ReadOnlySpan<dnode_t> nodes, ReadOnlySpan<dleaf_t> leafs)
+    {
+        var result = new HullClipNode[nodes.Length];
+        for (int i = 0; i < nodes.Length; i++)
+        {
+            result[i] = new HullClipNode
+            {
+                PlaneNum = nodes[i].planenum,
+                Child0 = NodeChildToClip(nodes[i].children[0], leafs),
+                Child1 = NodeChildToClip(nodes[i].children[1], leafs),
+            };
+        }
+        return result;
+
+        static int NodeChildToClip(short child, ReadOnlySpan<dleaf_t> leafs)
+            => child < 0 ? leafs[-1 - child].contents : child;
+    }
+
+    /// <summary>
+    /// Contents at <paramref name="point"/> in hull <paramref name="hullNumber"/>.
+    /// Original: SV_HullPointContents
+    /// </summary>
+    public int PointContents(Vector3 point, int hullNumber = 0)
+    {
+        ref readonly var hull = ref _hulls[hullNumber];
+        return HullPointContents(in hull, hull.FirstClipNode, point);
+    }
+
+    /// <summary>
+    /// Trace a point through hull 0.
+    /// </summary>
+    public HullTraceResult TraceLine(Vector3 start, Vector3 end) => TraceHull(start, end, 0);
+
+    /// <summary>
+    /// Trace through a specific hull; start and end are hull-space points (box origin for hulls 1-3).
+    /// Original: SV_RecursiveHullCheck via SV_ClipMoveToEntity
+    /// </summary>
+    public HullTraceResult TraceHull(Vector3 start, Vector3 end, int hullNumber)
+    {
+        ref readonly var hull = ref _hulls[hullNumber];
+
+        var trace = new HullTraceResult
+        {
+            AllSolid = true,
+            Fraction = 1,
+            EndPos = end,
+        };
+
+        RecursiveHullCheck(in hull, hull.FirstClipNode, 0, 1, start, end, ref trace);
+
+        if (trace.Fraction == 1)
+            trace.EndPos = end;
+        return trace;
+    }
+
+    /// <summary>
+    /// Trace a box, picking the hull by size like SV_HullForBsp.
+    /// </summary>
+    public HullTraceResult TraceBox(Vector3 start, Vector3 mins, Vector3 maxs, Vector3 end)
+    {
+        int hullNumber = SelectHull(mins, maxs, out var offset);
+        var trace = TraceHull(start - offset, end - offset, hullNumber);
+        trace.EndPos += offset;
+        return trace;
+    }
+
+    /// <summary>
+    /// Pick the clipping hull for a box. <paramref name="offset"/> moves box-origin points into hull space.
+    /// </summary>
+    public int SelectHull(Vector3 mins, Vector3 maxs, out Vector3 offset)
+    {
+        var size = maxs - mins;
+        int hullNumber;
+        if (size.X <= 8)
+        {
+            offset = _hulls[0].ClipMins;
+            return 0;
+        }
+
+        if (size.X <= 36)
+            hullNumber = size.Z <= 36 ? 3 : 1;
+        else
+            hullNumber = 2;
+
+        offset = _hulls[hullNumber].ClipMins - mins;
+        return hullNumber;
+    }
+
+    /// <summary>
+    /// Run many traces, spread over the thread pool when the batch is large enough.
+    /// </summary>
+    public void TraceBatch(ReadOnlyMemory<HullTraceRequest> requests, Memory<HullTraceResult> results, int chunkSize = 256)
+    {
+        if (results.Length < requests.Length)
+            throw new ArgumentException("Result buffer is smaller than the request buffer", nameof(results));
+
+        int count = requests.Length;
+        if (count <= chunkSize)
+        {
+            TraceRange(requests.Span, results.Span);
+            return;
+        }
+
+        int chunks = (count + chunkSize - 1) / chunkSize;
+        Parallel.For(0, chunks, chunk =>
+        {
+            int start = chunk * chunkSize;
+            int length = Math.Min(chunkSize, count - start);
+            TraceRange(requests.Span.Slice(start, length), results.Span.Slice(start, length));
+        });
+    }
+
+    /// <summary>
+    /// Run traces on the calling thread.
+    /// </summary>
+    public void TraceRange(ReadOnlySpan<HullTraceRequest> requests, Span<HullTraceResult> results)
+    {
+        for (int i = 0; i < requests.Length; i++)
+        {
+            ref readonly var r = ref requests[i];
+            results[i] = TraceHull(r.Start, r.End, r.Hull);
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private float PlaneDiff(in HullPlane plane, in Vector3 p)
+    {
+        if (plane.Type < 3)
+            return Unsafe.Add(ref Unsafe.AsRef(in p.X), plane.Type) - plane.Dist;
+        return plane.Normal.X * p.X + plane.Normal.Y * p.Y + plane.Normal.Z * p.Z - plane.Dist;
+    }
+
+    private int HullPointContents(in Hull hull, int num, Vector3 p)
+    {
+        var clipNodes = hull.ClipNodes;
+        var planes = _planes;
+
+        while (num >= 0)
+        {
+            if (num < hull.FirstClipNode || num > hull.LastClipNode)
+                throw new InvalidDataException("SV_HullPointContents: bad node number");
+
+            ref readonly var node = ref clipNodes[num];
+            float d = PlaneDiff(in planes[node.PlaneNum], in p);
+            num = d < 0 ? node.Child1 : node.Child0;
+        }
+
+        return num;
+    }
+
+    private bool RecursiveHullCheck(in Hull hull, int num, float p1f, float p2f, Vector3 p1, Vector3 p2, ref HullTraceResult trace)
+    {
+        // check for empty
+        if (num < 0)
+        {
+            if (num != BspConstants.CONTENTS_SOLID)
+            {
+                trace.AllSolid = false;
+                if (num == BspConstants.CONTENTS_EMPTY)
+                    trace.InOpen = true;
+                else
+                    trace.InWater = true;
+            }
+            else
+            {
+                trace.StartSolid = true;
+            }
+            return true; // empty
+        }
+
+        if (num < hull.FirstClipNode || num > hull.LastClipNode)
+            throw new InvalidDataException("SV_RecursiveHullCheck: bad node number");
+
+        // find the point distances
+        ref readonly var node = ref hull.ClipNodes[num];
+        ref readonly var plane = ref _planes[node.PlaneNum];
+
+        float t1 = PlaneDiff(in plane, in p1);
+        float t2 = PlaneDiff(in plane, in p2);
+
+        if (t1 >= 0 && t2 >= 0)
+            return RecursiveHullCheck(in hull, node.Child0, p1f, p2f, p1, p2, ref trace);
+        if (t1 < 0 && t2 < 0)
+            return RecursiveHullCheck(in hull, node.Child1, p1f, p2f, p1, p2, ref trace);
+
+        // put the crosspoint DIST_EPSILON pixels on the near side
+        float frac = t1 < 0 ? (t1 + DIST_EPSILON) / (t1 - t2) : (t1 - DIST_EPSILON) / (t1 - t2);
+        if (frac < 0)
+            frac = 0;
+        if (frac > 1)
+            frac = 1;
+
+        float midf = p1f + (p2f - p1f) * frac;
+        var mid = p1 + (p2 - p1) * frac;
+
+        int side = t1 < 0 ? 1 : 0;
+        int near = side == 0 ? node.Child0 : node.Child1;
+        int far = side == 0 ? node.Child1 : node.Child0;
+
+        // move up to the node
+        if (!RecursiveHullCheck(in hull, near, p1f, midf, p1, mid, ref trace))
+            return false;
+
+        if (HullPointContents(in hull, far, mid) != BspConstants.CONTENTS_SOLID)
+        {
+            // go past the node
+            return RecursiveHullCheck(in hull, far, midf, p2f, mid, p2, ref trace);
+        }
+
+        if (trace.AllSolid)
+            return false; // never got out of the solid area
+
+        // the other side of the node is solid, this is the impact point
+        if (side == 0)
+        {
+            trace.PlaneNormal = plane.Normal;
+            trace.PlaneDist = plane.Dist;
+        }
+        else
+        {
+            trace.PlaneNormal = -plane.Normal;
+            trace.PlaneDist = -plane.Dist;
+        }
+
+        while (HullPointContents(in hull, hull.FirstClipNode, mid) == BspConstants.CONTENTS_SOLID)
+        {
+            // shouldn't really happen, but does occasionally
+            frac -= 0.1f;
+            if (frac < 0)
+            {
+                trace.Fraction = midf;
+                trace.EndPos = mid;
+                return false;
+            }
+            midf = p1f + (p2f - p1f) * frac;
+            mid = p1 + (p2 - p1) * frac;
+        }
+
+        trace.Fraction = midf;
+        trace.EndPos = mid;
+        return false;
+    }
+}
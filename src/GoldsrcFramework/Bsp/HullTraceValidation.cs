@@ -0,0 +1,136 @@
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+
+namespace GoldsrcFramework.Bsp;
+
+/// <summary>
+/// A trace request together with the result the engine returned for it.
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct HullTraceRecord
+{
+    public HullTraceRequest Request;
+    public HullTraceResult Expected;
+}
+
+/// <summary>
+/// Outcome of comparing <see cref="HullCollisionModel"/> against recorded engine traces.
+/// </summary>
+public sealed class HullTraceValidationReport
+{
+    public int Total { get; internal set; }
+    public int Mismatches { get; internal set; }
+    public float MaxFractionError { get; internal set; }
+    public float MaxEndPosError { get; internal set; }
+
+    /// <summary>
+    /// Indices of the first mismatching records (capped).
+    /// </summary>
+    public List<int> MismatchIndices { get; } = new();
+
+    public override string ToString()
+        => $"{Total - Mismatches}/{Total} traces match (max fraction error {MaxFractionError:G4}, max endpos error {MaxEndPosError:G4})";
+}
+
+/// <summary>
+/// Records world traces from the running engine and validates the managed hull traces against them.
+///
+/// Recording uses pfnTraceHull with fNoMonsters set, so brush entities other than the world still block engine
+/// traces; record on maps or areas without them, or expect those records to show up as mismatches.
+/// </summary>
+public static unsafe class HullTraceValidation
+{
+    private const uint Magic = 0x52544847; // "GHTR"
+
+    /// <summary>
+    /// Trace through the engine and capture the result. Server side, world only.
+    /// </summary>
+    public static HullTraceRecord RecordEngineTrace(HullTraceRequest request)
+    {
+        var start = request.Start;
+        var end = request.End;
+        TraceResult tr;
+        EngineApi.PServer->TraceHull((float*)&start, (float*)&end, 1, request.Hull, null, &tr);
+
+        return new HullTraceRecord
+        {
+            Request = request,
+            Expected = new HullTraceResult
+            {
+                AllSolid = tr.fAllSolid != 0,
+                StartSolid = tr.fStartSolid != 0,
+                InOpen = tr.fInOpen != 0,
+                InWater = tr.fInWater != 0,
+                Fraction = tr.flFraction,
+                EndPos = tr.vecEndPos,
+                PlaneNormal = tr.vecPlaneNormal,
+                PlaneDist = tr.flPlaneDist,
+            },
+        };
+    }
+
+    /// <summary>
+    /// Write records to a binary file.
+    /// </summary>
+    public static void Save(string path, ReadOnlySpan<HullTraceRecord> records)
+    {
+        using var stream = File.Create(path);
+        Span<uint> header = [Magic, (uint)sizeof(HullTraceRecord), (uint)records.Length];
+        stream.Write(MemoryMarshal.AsBytes(header));
+        stream.Write(MemoryMarshal.AsBytes(records));
+    }
+
+    /// <summary>
+    /// Read records written by <see cref="Save"/>.
+    /// </summary>
+    public static HullTraceRecord[] Load(string path)
+    {
+        var data = File.ReadAllBytes(path);
+        var header = MemoryMarshal.Cast<byte, uint>(data.AsSpan(0, 12));
+        if (header[0] != Magic || header[1] != (uint)sizeof(HullTraceRecord))
+            throw new InvalidDataException($"{path} is not a hull trace recording");
+
+        var records = MemoryMarshal.Cast<byte, HullTraceRecord>(data.AsSpan(12));
+        if (records.Length < header[2])
+            throw new InvalidDataException($"{path} is truncated");
+
+        return records.Slice(0, (int)header[2]).ToArray();
+    }
+
+    /// <summary>
+    /// Replay recorded requests through <paramref name="model"/> and compare with the recorded results.
+    /// </summary>
+    public static HullTraceValidationReport Validate(HullCollisionModel model, ReadOnlySpan<HullTraceRecord> records,
+        float fractionTolerance = 1e-4f, float positionTolerance = 0.01f, int maxReportedMismatches = 32)
+    {
+        var report = new HullTraceValidationReport { Total = records.Length };
+
+        for (int i = 0; i < records.Length; i++)
+        {
+            ref readonly var record = ref records[i];
+            var actual = model.TraceHull(record.Request.Start, record.Request.End, record.Request.Hull);
+            ref readonly var expected = ref record.Expected;
+
+            float fractionError = MathF.Abs(actual.Fraction - expected.Fraction);
+            float endPosError = (actual.EndPos - expected.EndPos).Length();
+            report.MaxFractionError = MathF.Max(report.MaxFractionError, fractionError);
+            report.MaxEndPosError = MathF.Max(report.MaxEndPosError, endPosError);
+
+            bool match = actual.AllSolid == expected.AllSolid
+                         && actual.StartSolid == expected.StartSolid
+                         && fractionError <= fractionTolerance
+                         && endPosError <= positionTolerance
+                         && (expected.Fraction == 1 || (actual.PlaneNormal - expected.PlaneNormal).Length() <= positionTolerance);
+
+            if (!match)
+            {
+                report.Mismatches++;
+                if (report.MismatchIndices.Count < maxReportedMismatches)
+                    report.MismatchIndices.Add(i);
+            }
+        }
+
+        return report;
+    }
+}
@@ -0,0 +1,20 @@
+namespace GoldsrcFramework.Bsp;
+
+/// <summary>
+/// Marks a field or property of a map entity class as filled from the BSP keyvalue of the same name
+/// (or <see cref="Name"/>). Supported types: string, bool, byte, short, int, float, double, enums,
+/// and System.Numerics / LinearMath Vector3 ("x y z").
+/// </summary>
+[AttributeUsage(AttributeTargets.Field | AttributeTargets.Property, Inherited = true)]
+public sealed class KeyValueAttribute : Attribute
+{
+    public KeyValueAttribute(string? name = null)
+    {
+        Name = name;
+    }
+
+    /// <summary>
+    /// Key in the entity lump; the member name when null.
+    /// </summary>
+    public string? Name { get; }
+}
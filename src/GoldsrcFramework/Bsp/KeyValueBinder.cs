@@ -0,0 +1,176 @@
+using System.Buffers.Text;
+using System.Linq.Expressions;
+using System.Reflection;
+using GoldsrcFramework.Strings;
+
+namespace GoldsrcFramework.Bsp;
+
+/// <summary>
+/// Parses a keyvalue into a member's type.
+/// </summary>
+public delegate TValue KeyValueParser<TValue>(Utf8View value);
+
+/// <summary>
+/// Applies keyvalues to instances of <typeparamref name="T"/> through setters built once per class from its
+/// <see cref="KeyValueAttribute"/> members: the assignment is a compiled expression tree and the text is parsed
+/// straight from the <see cref="Utf8View"/>, so setting a number allocates nothing and uses no reflection.
+/// Keys match case-sensitively, as HLSDK's FStrEq does.
+/// </summary>
+public static class KeyValueBinder<T> where T : class
+{
+    private static readonly Utf8Map<KeyValueSetter<T>> s_setters = KeyValueBinder.Build<T>();
+
+    /// <summary>
+    /// Number of bound keys.
+    /// </summary>
+    public static int Count => s_setters.Count;
+
+    public static IEnumerable<string> Keys => s_setters.Keys;
+
+    /// <summary>
+    /// Set the member bound to <paramref name="key"/>. Returns false for keys the class does not declare.
+    /// </summary>
+    public static bool TrySet(T target, Utf8View key, Utf8View value)
+    {
+        if (!s_setters.TryGetValue(key, out var setter))
+            return false;
+
+        setter.Set(target, value);
+        return true;
+    }
+
+    /// <summary>
+    /// Apply every pair of <paramref name="entity"/>; returns how many were bound.
+    /// </summary>
+    public static int Apply(T target, in EntityRecord entity)
+    {
+        int bound = 0;
+        for (int i = 0; i < entity.PairCount; i++)
+        {
+            if (TrySet(target, entity.Key(i), entity.Value(i)))
+                bound++;
+        }
+        return bound;
+    }
+}
+
+/// <summary>
+/// Base of the per-member setters built by <see cref="KeyValueBinder{T}"/>.
+/// </summary>
+public abstract class KeyValueSetter<T>
+{
+    public abstract void Set(T target, Utf8View value);
+}
+
+internal sealed class KeyValueSetter<T, TValue>(Action<T, TValue> assign, KeyValueParser<TValue> parse) : KeyValueSetter<T>
+{
+    public override void Set(T target, Utf8View value) => assign(target, parse(value));
+}
+
+/// <summary>
+/// Setter construction and the value parsers shared by every <see cref="KeyValueBinder{T}"/>.
+/// </summary>
+public static class KeyValueBinder
+{
+    internal static Utf8Map<KeyValueSetter<T>> Build<T>() where T : class
+    {
+        var setters = new Utf8Map<KeyValueSetter<T>>();
+        const BindingFlags Flags = BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic;
+
+        foreach (var member in typeof(T).GetMembers(Flags))
+        {
+            if (member is not (FieldInfo or PropertyInfo))
+                continue;
+            var attribute = member.GetCustomAttribute<KeyValueAttribute>(inherit: true);
+            if (attribute == null)
+                continue;
+
+            var memberType = member is FieldInfo f ? f.FieldType : ((PropertyInfo)member).PropertyType;
+            if (member is FieldInfo { IsInitOnly: true } || member is PropertyInfo { CanWrite: false })
+                throw new InvalidOperationException($"{typeof(T).Name}.{member.Name}: [KeyValue] members must be writable.");
+
+            var (valueType, parser) = GetParser(memberType)
+                ?? throw new NotSupportedException($"{typeof(T).Name}.{member.Name}: [KeyValue] does not support {memberType.Name}.");
+
+            // (target, value) => target.Member = (MemberType)value
+            var target = Expression.Parameter(typeof(T), "target");
+            var value = Expression.Parameter(valueType, "value");
+            Expression converted = valueType == memberType ? value : Expression.Convert(value, memberType);
+            var assign = Expression.Lambda(
+                typeof(Action<,>).MakeGenericType(typeof(T), valueType),
+                Expression.Assign(Expression.MakeMemberAccess(target, member), converted),
+                target, value).Compile();
+
+            var setterType = typeof(KeyValueSetter<,>).MakeGenericType(typeof(T), valueType);
+            var setter = (KeyValueSetter<T>)Activator.CreateInstance(setterType, assign, parser)!;
+            setters.Set(attribute.Name ?? member.Name, setter);
+        }
+
+        return setters;
+    }
+
+    private static (Type, Delegate)? GetParser(Type type)
+    {
+        if (type.IsEnum)
+            return (typeof(int), (KeyValueParser<int>)ParseInt32);
+
+        return Type.GetTypeCode(type) switch
+        {
+            TypeCode.String => (type, (KeyValueParser<string>)ParseString),
+            TypeCode.Boolean => (type, (KeyValueParser<bool>)ParseBoolean),
+            TypeCode.Byte => (typeof(int), (KeyValueParser<int>)ParseInt32),
+            TypeCode.Int16 => (typeof(int), (KeyValueParser<int>)ParseInt32),
+            TypeCode.Int32 => (type, (KeyValueParser<int>)ParseInt32),
+            TypeCode.Single => (type, (KeyValueParser<float>)ParseSingle),
+            TypeCode.Double => (type, (KeyValueParser<double>)ParseDouble),
+            _ when type == typeof(System.Numerics.Vector3) => (type, (KeyValueParser<System.Numerics.Vector3>)ParseVector),
+            _ when type == typeof(LinearMath.Vector3) => (type, (KeyValueParser<LinearMath.Vector3>)ParseLinearVector),
+            _ => null,
+        };
+    }
+
+    public static string ParseString(Utf8View value) => value.ToString();
+
+    public static bool ParseBoolean(Utf8View value) => value.ToInt32() != 0;
+
+    public static int ParseInt32(Utf8View value) => value.ToInt32();
+
+    public static float ParseSingle(Utf8View value) => value.ToSingle();
+
+    public static double ParseDouble(Utf8View value)
+    {
+        var s = value.Trim().Span;
+        return Utf8Parser.TryParse(s, out double result, out _) ? result : 0;
+    }
+
+    /// <summary>
+    /// "x y z" as UTIL_StringToVector reads it: missing components are 0.
+    /// </summary>
+    public static System.Numerics.Vector3 ParseVector(Utf8View value)
+    {
+        Span<float> v = stackalloc float[3];
+        var s = value.Span;
+        for (int i = 0; i < 3; i++)
+        {
+            int start = 0;
+            while (start < s.Length && s[start] <= ' ')
+                start++;
+            s = s[start..];
+            if (s.IsEmpty)
+                break;
+
+            int end = s.IndexOfAny((byte)' ', (byte)'\t');
+            if (end < 0)
+                end = s.Length;
+            v[i] = new Utf8View(s[..end]).ToSingle();
+            s = s[end..];
+        }
+        return new System.Numerics.Vector3(v[0], v[1], v[2]);
+    }
+
+    public static LinearMath.Vector3 ParseLinearVector(Utf8View value)
+    {
+        var v = ParseVector(value);
+        return new LinearMath.Vector3(v.X, v.Y, v.Z);
+    }
+}
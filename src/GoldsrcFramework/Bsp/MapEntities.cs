@@ -0,0 +1,214 @@
+using System.Diagnostics;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Strings;
+using NativeInterop;
+
+namespace GoldsrcFramework.Bsp;
+
+/// <summary>
+/// Map entity classes created from the entity lump, by classname.
+/// </summary>
+public sealed class MapEntityClasses
+{
+    internal abstract class Factory
+    {
+        public bool Exclusive;
+        public abstract object Create(in EntityRecord record);
+    }
+
+    private sealed class Factory<T> : Factory where T : class, new()
+    {
+        public override object Create(in EntityRecord record)
+        {
+            var entity = new T();
+            KeyValueBinder<T>.Apply(entity, record);
+            return entity;
+        }
+    }
+
+    private readonly Utf8Map<Factory> _classes = new();
+
+    public int Count => _classes.Count;
+
+    /// <summary>
+    /// Create <typeparamref name="T"/> for every <paramref name="classname"/> entity of each map.
+    /// When <paramref name="exclusive"/> the class is managed only and its keyvalues are not passed on to the legacy DLL.
+    /// </summary>
+    public void Register<T>(string classname, bool exclusive = true) where T : class, new()
+    {
+        _classes.Set(classname, new Factory<T> { Exclusive = exclusive });
+    }
+
+    internal bool TryGet(Utf8View classname, out Factory factory) => _classes.TryGetValue(classname, out factory);
+}
+
+/// <summary>
+/// Managed map entity classes and their instances for the current level.
+///
+/// Classes registered with <see cref="Register{T}"/> are created straight from the memory-mapped entity lump when
+/// the level loads, with every keyvalue applied in bulk through <see cref="KeyValueBinder{T}"/>. While the engine then
+/// calls DispatchKeyValue pair by pair, <see cref="TryHandleKeyValue"/> follows along in lump order (matching on
+/// classname) and answers for the managed classes without decoding anything, binding each instance to its edict.
+/// </summary>
+public sealed unsafe class MapEntities
+{
+    private readonly MapEntityClasses _classes;
+    private readonly object?[] _instances;
+    private readonly Dictionary<nint, int> _edicts = new();
+    private int _cursor = -1;
+    private edict_t* _current;
+    private bool _currentExclusive;
+    private bool _currentManaged;
+
+    private MapEntities(EntityLump lump, MapEntityClasses classes)
+    {
+        Lump = lump;
+        _classes = classes;
+        _instances = new object?[lump.Count];
+    }
+
+    /// <summary>
+    /// Classes loaded by <see cref="LoadCurrentMap"/>.
+    /// </summary>
+    public static MapEntityClasses Classes { get; } = new();
+
+    /// <inheritdoc cref="MapEntityClasses.Register{T}"/>
+    public static void Register<T>(string classname, bool exclusive = true) where T : class, new() =>
+        Classes.Register<T>(classname, exclusive);
+
+    public static bool HasRegistrations => Classes.Count > 0;
+
+    /// <summary>
+    /// The parsed entity lump of the level.
+    /// </summary>
+    public EntityLump Lump { get; }
+
+    /// <summary>
+    /// Whether the engine is still spawning the map's entities (cleared by <see cref="EndLoad"/>).
+    /// </summary>
+    public bool Loading { get; private set; } = true;
+
+    /// <summary>
+    /// Number of managed instances created.
+    /// </summary>
+    public int ManagedCount { get; private set; }
+
+    /// <summary>
+    /// DispatchKeyValue calls answered without the legacy DLL.
+    /// </summary>
+    public int HandledKeyValues { get; private set; }
+
+    /// <summary>
+    /// Create the managed instances for <paramref name="lump"/>, for <see cref="Classes"/> unless <paramref name="classes"/> is given.
+    /// </summary>
+    public static MapEntities Load(EntityLump lump, MapEntityClasses? classes = null)
+    {
+        var entities = new MapEntities(lump, classes ?? Classes);
+        for (int i = 0; i < lump.Count; i++)
+        {
+            var record = lump[i];
+            if (entities._classes.TryGet(record.Classname, out var factory))
+            {
+                entities._instances[i] = factory.Create(record);
+                entities.ManagedCount++;
+            }
+        }
+        return entities;
+    }
+
+    /// <summary>
+    /// Memory-map maps/&lt;mapname&gt;.bsp of the running server and load it, or null when the file is not on disk
+    /// (e.g. the map is inside a pak); the engine's per-pair KeyValue path then handles everything as before.
+    /// </summary>
+    public static MapEntities? LoadCurrentMap()
+    {
+        var path = GamePaths.CurrentServerMap();
+        if (path == null)
+            return null;
+
+        try
+        {
+            using var bsp = BspFile.Open(path);
+            return Load(EntityLump.Load(bsp));
+        }
+        catch (Exception ex) when (ex is IOException or InvalidDataException or UnauthorizedAccessException)
+        {
+            Debug.WriteLine($"[MapEntities] Failed to load {path}: {ex.Message}");
+            return null;
+        }
+    }
+
+    /// <summary>
+    /// Managed instance for lump entity <paramref name="index"/>, if its class is registered.
+    /// </summary>
+    public object? this[int index] => _instances[index];
+
+    /// <summary>
+    /// Managed instance bound to <paramref name="edict"/> during loading.
+    /// </summary>
+    public T? Get<T>(edict_t* edict) where T : class =>
+        _edicts.TryGetValue((nint)edict, out int index) ? _instances[index] as T : null;
+
+    public IEnumerable<T> OfType<T>() where T : class => _instances.OfType<T>();
+
+    /// <summary>
+    /// Called from KeyValue. Returns true when the pair belongs to an exclusive managed class and needs no further dispatch.
+    /// </summary>
+    public bool TryHandleKeyValue(edict_t* edict, KeyValueData* kvd)
+    {
+        if (!Loading || edict == null)
+            return false;
+
+        if (edict != _current)
+        {
+            _current = edict;
+            Advance(new Utf8View(kvd->szClassName));
+        }
+
+        if (!_currentManaged || !_currentExclusive)
+            return false;
+
+        kvd->fHandled = 1;
+        HandledKeyValues++;
+        return true;
+    }
+
+    /// <summary>
+    /// Called from Spawn: the entity's keyvalues are complete. The engine may reuse the edict of an entity that failed
+    /// to spawn for the next one, so this, not a new edict pointer, is what ends an entity.
+    /// </summary>
+    public void OnSpawn(edict_t* edict)
+    {
+        if (edict == _current)
+            _current = null;
+    }
+
+    /// <summary>
+    /// Stop following DispatchKeyValue; entities created from now on are not from the lump. Called at ServerActivate.
+    /// </summary>
+    public void EndLoad()
+    {
+        Loading = false;
+        _current = null;
+    }
+
+    // The engine spawns lump entities in order; find the next one of this class, normally the very next entry.
+    private void Advance(Utf8View classname)
+    {
+        _currentManaged = false;
+        for (int i = _cursor + 1; i < Lump.Count; i++)
+        {
+            if (!Lump[i].Classname.Equals(classname))
+                continue;
+
+            _cursor = i;
+            if (_instances[i] != null && _classes.TryGet(classname, out var factory))
+            {
+                _currentManaged = true;
+                _currentExclusive = factory.Exclusive;
+                _edicts[(nint)_current] = i;
+            }
+            return;
+        }
+    }
+}
@@ -0,0 +1,187 @@
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+
+namespace GoldsrcFramework.Bsp;
+
+/// <summary>
+/// Server-side visibility of the current map: the <see cref="VisibilityCache"/>, the <see cref="EntityLeafMap"/> fed
+/// from SetAbsBox, and each client's PVS / PAS as of its last SetupVisibility.
+///
+/// Client rows live in pinned arrays, so they can be handed to the engine in place of ENGINE_SET_PVS /
+/// ENGINE_SET_PAS results and stay valid for the whole of that client's packet.
+/// Main thread only.
+/// </summary>
+public sealed unsafe class ServerVisibility
+{
+    private const int FL_DUCKING = 1 << 14;
+    private const int FL_PROXY = 1 << 20;
+
+    // VEC_HULL_MIN.z - VEC_DUCK_HULL_MIN.z
+    private const float DuckEyeOffset = -18;
+
+    private readonly ulong[][] _clientPvs;
+    private readonly ulong[][] _clientPas;
+    private readonly bool[] _clientValid;
+
+    public ServerVisibility(VisibilityCache cache, int maxEntities, int maxClients)
+    {
+        Cache = cache;
+        Entities = new EntityLeafMap(cache, maxEntities);
+        _clientPvs = new ulong[maxClients + 1][];
+        _clientPas = new ulong[maxClients + 1][];
+        _clientValid = new bool[maxClients + 1];
+        for (int i = 0; i <= maxClients; i++)
+        {
+            // One spare word: the engine may read a row up to its own leaf count rounded to bytes.
+            _clientPvs[i] = GC.AllocateArray<ulong>(cache.RowWords + 1, pinned: true);
+            _clientPas[i] = GC.AllocateArray<ulong>(cache.RowWords + 1, pinned: true);
+        }
+    }
+
+    /// <summary>
+    /// Visibility of the map the server is running; null when the .bsp is not on disk or cannot be read.
+    /// </summary>
+    public static ServerVisibility? LoadCurrentMap(int budgetBytes = VisibilityCache.DefaultBudgetBytes)
+    {
+        var globals = EngineApi.PGlobals;
+        var path = GamePaths.CurrentServerMap();
+        if (globals == null || path == null)
+            return null;
+
+        try
+        {
+            using var bsp = BspFile.Open(path);
+            return new ServerVisibility(VisibilityCache.Load(bsp, budgetBytes), globals->maxEntities, globals->maxClients);
+        }
+        catch (Exception ex) when (ex is IOException or InvalidDataException or UnauthorizedAccessException)
+        {
+            Debug.WriteLine($"[ServerVisibility] Failed to load {path}: {ex.Message}");
+            return null;
+        }
+    }
+
+    public VisibilityCache Cache { get; }
+
+    public EntityLeafMap Entities { get; }
+
+    public int MaxClients => _clientPvs.Length - 1;
+
+    /// <summary>
+    /// Relink an edict after the game set its absmin / absmax.
+    /// </summary>
+    public void OnSetAbsBox(edict_t* edict)
+    {
+        int index = EntityIndex(edict);
+        if (index < 0)
+            return;
+        if (edict->free.Value != 0)
+            Entities.Remove(index);
+        else
+            Entities.Update(index, edict->v.absmin, edict->v.absmax);
+    }
+
+    public void OnFree(edict_t* edict)
+    {
+        int index = EntityIndex(edict);
+        if (index >= 0)
+            Entities.Remove(index);
+    }
+
+    /// <summary>
+    /// Eye position SetupVisibility uses for a client: the view entity's origin plus view_ofs, lowered while ducking.
+    /// </summary>
+    public static Vector3 EyePosition(edict_t* viewEntity, edict_t* client)
+    {
+        var view = viewEntity != null ? viewEntity : client;
+        var eye = view->v.origin + view->v.view_ofs;
+        if ((view->v.flags & FL_DUCKING) != 0)
+            eye.Z += DuckEyeOffset;
+        return eye;
+    }
+
+    /// <summary>
+    /// SetupVisibility from the cache: the same eye and fat PVS / PAS as the game DLL's ENGINE_SET_PVS /
+    /// ENGINE_SET_PAS, written to the client's pinned rows. Proxies get no sets, as in the SDK.
+    /// </summary>
+    public void SetupVisibility(edict_t* viewEntity, edict_t* client, byte** pvs, byte** pas)
+    {
+        int index = TrackViewer(viewEntity, client);
+        if (index <= 0)
+        {
+            *pvs = null;
+            *pas = null;
+            return;
+        }
+
+        *pvs = (byte*)Unsafe.AsPointer(ref _clientPvs[index][0]);
+        *pas = (byte*)Unsafe.AsPointer(ref _clientPas[index][0]);
+    }
+
+    /// <summary>
+    /// Record the viewer of a client whose sets the game DLL computed itself. Returns the client index, or -1 for
+    /// proxies and non-clients.
+    /// </summary>
+    public int TrackViewer(edict_t* viewEntity, edict_t* client)
+    {
+        int index = EntityIndex(client);
+        if (index <= 0 || index > MaxClients || (client->v.flags & FL_PROXY) != 0)
+            return -1;
+
+        SetViewer(index, EyePosition(viewEntity, client));
+        return index;
+    }
+
+    /// <summary>
+    /// Forget the viewer of a disconnecting client.
+    /// </summary>
+    public void ResetClient(edict_t* client)
+    {
+        int index = EntityIndex(client);
+        if (index > 0 && index <= MaxClients)
+            _clientValid[index] = false;
+    }
+
+    /// <summary>
+    /// Record where client <paramref name="client"/> (1-based) sees from.
+    /// </summary>
+    public void SetViewer(int client, Vector3 eye)
+    {
+        Cache.FatPvs(eye, _clientPvs[client].AsSpan(0, Cache.RowWords));
+        Cache.FatPas(eye, _clientPas[client].AsSpan(0, Cache.RowWords));
+        _clientValid[client] = true;
+    }
+
+    /// <summary>
+    /// PVS of client <paramref name="client"/> as of its last SetupVisibility; empty before the first one.
+    /// </summary>
+    public ReadOnlySpan<ulong> GetClientPvs(int client) => _clientValid[client] ? _clientPvs[client].AsSpan(0, Cache.RowWords) : default;
+
+    public ReadOnlySpan<ulong> GetClientPas(int client) => _clientValid[client] ? _clientPas[client].AsSpan(0, Cache.RowWords) : default;
+
+    /// <summary>
+    /// Entities client <paramref name="client"/> can see, as a bitset of <see cref="EntityLeafMap.EntityWords"/>.
+    /// </summary>
+    public int CollectVisibleEntities(int client, Span<ulong> entities) => Entities.CollectInSet(GetClientPvs(client), entities);
+
+    public bool IsVisibleTo(int client, int entity) => Entities.IsInSet(entity, GetClientPvs(client));
+
+    /// <summary>
+    /// Union of the PVS of several clients, e.g. everyone spectating through one camera.
+    /// </summary>
+    public void UnionClientPvs(ReadOnlySpan<int> clients, Span<ulong> destination)
+    {
+        destination.Clear();
+        foreach (int client in clients)
+            VisBits.Or(destination, GetClientPvs(client));
+    }
+
+    private static int EntityIndex(edict_t* edict)
+    {
+        var engine = EngineApi.PServer;
+        if (edict == null || engine == null || engine->IndexOfEdict == null)
+            return -1;
+        return engine->IndexOfEdict(edict);
+    }
+}
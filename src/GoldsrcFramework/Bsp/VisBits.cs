@@ -0,0 +1,136 @@
+using System.Numerics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Runtime.Intrinsics;
+
+namespace GoldsrcFramework.Bsp;
+
+/// <summary>
+/// Bitset operations over ulong rows (PVS / PAS rows, entity sets), 256 bits at a time with Vector256
+/// (Vector128 / scalar fallback). Bit <c>i</c> of a leaf row is leaf <c>i + 1</c>, as in the engine's visdata.
+/// </summary>
+public static class VisBits
+{
+    public static int WordsFor(int bits) => (bits + 63) >> 6;
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public static bool Test(ReadOnlySpan<ulong> set, int bit) =>
+        (uint)(bit >> 6) < (uint)set.Length && (set[bit >> 6] & (1UL << bit)) != 0;
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public static void Set(Span<ulong> set, int bit) => set[bit >> 6] |= 1UL << bit;
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public static void Clear(Span<ulong> set, int bit) => set[bit >> 6] &= ~(1UL << bit);
+
+    /// <summary>
+    /// <paramref name="destination"/> |= <paramref name="source"/>.
+    /// </summary>
+    public static void Or(Span<ulong> destination, ReadOnlySpan<ulong> source)
+    {
+        if (source.Length > destination.Length)
+            throw new ArgumentException("Source is longer than destination.", nameof(source));
+
+        ref ulong d = ref MemoryMarshal.GetReference(destination);
+        ref ulong s = ref MemoryMarshal.GetReference(source);
+        int i = 0, n = source.Length;
+        if (Vector256.IsHardwareAccelerated)
+        {
+            for (; i + 4 <= n; i += 4)
+                (Vector256.LoadUnsafe(ref d, (nuint)i) | Vector256.LoadUnsafe(ref s, (nuint)i)).StoreUnsafe(ref d, (nuint)i);
+        }
+        if (Vector128.IsHardwareAccelerated)
+        {
+            for (; i + 2 <= n; i += 2)
+                (Vector128.LoadUnsafe(ref d, (nuint)i) | Vector128.LoadUnsafe(ref s, (nuint)i)).StoreUnsafe(ref d, (nuint)i);
+        }
+        for (; i < n; i++)
+            Unsafe.Add(ref d, i) |= Unsafe.Add(ref s, i);
+    }
+
+    /// <summary>
+    /// <paramref name="destination"/> &amp;= <paramref name="source"/>; words past the end of the source are cleared.
+    /// </summary>
+    public static void And(Span<ulong> destination, ReadOnlySpan<ulong> source)
+    {
+        int n = Math.Min(source.Length, destination.Length);
+        ref ulong d = ref MemoryMarshal.GetReference(destination);
+        ref ulong s = ref MemoryMarshal.GetReference(source);
+        int i = 0;
+        if (Vector256.IsHardwareAccelerated)
+        {
+            for (; i + 4 <= n; i += 4)
+                (Vector256.LoadUnsafe(ref d, (nuint)i) & Vector256.LoadUnsafe(ref s, (nuint)i)).StoreUnsafe(ref d, (nuint)i);
+        }
+        if (Vector128.IsHardwareAccelerated)
+        {
+            for (; i + 2 <= n; i += 2)
+                (Vector128.LoadUnsafe(ref d, (nuint)i) & Vector128.LoadUnsafe(ref s, (nuint)i)).StoreUnsafe(ref d, (nuint)i);
+        }
+        for (; i < n; i++)
+            Unsafe.Add(ref d, i) &= Unsafe.Add(ref s, i);
+        destination[n..].Clear();
+    }
+
+    /// <summary>
+    /// True when the two sets share a bit; stops at the first shared 256-bit block.
+    /// </summary>
+    public static bool Intersects(ReadOnlySpan<ulong> a, ReadOnlySpan<ulong> b)
+    {
+        int n = Math.Min(a.Length, b.Length);
+        ref ulong x = ref MemoryMarshal.GetReference(a);
+        ref ulong y = ref MemoryMarshal.GetReference(b);
+        int i = 0;
+        if (Vector256.IsHardwareAccelerated)
+        {
+            for (; i + 4 <= n; i += 4)
+            {
+                if ((Vector256.LoadUnsafe(ref x, (nuint)i) & Vector256.LoadUnsafe(ref y, (nuint)i)) != Vector256<ulong>.Zero)
+                    return true;
+            }
+        }
+        if (Vector128.IsHardwareAccelerated)
+        {
+            for (; i + 2 <= n; i += 2)
+            {
+                if ((Vector128.LoadUnsafe(ref x, (nuint)i) & Vector128.LoadUnsafe(ref y, (nuint)i)) != Vector128<ulong>.Zero)
+                    return true;
+            }
+        }
+        for (; i < n; i++)
+        {
+            if ((Unsafe.Add(ref x, i) & Unsafe.Add(ref y, i)) != 0)
+                return true;
+        }
+        return false;
+    }
+
+    public static int PopCount(ReadOnlySpan<ulong> set)
+    {
+        int count = 0;
+        foreach (ulong word in set)
+            count += BitOperations.PopCount(word);
+        return count;
+    }
+
+    /// <summary>
+    /// Write the index of every set bit to <paramref name="bits"/>, in order. Returns how many were written;
+    /// stops when the destination is full.
+    /// </summary>
+    public static int GetSetBits(ReadOnlySpan<ulong> set, Span<int> bits)
+    {
+        int count = 0;
+        for (int w = 0; w < set.Length; w++)
+        {
+            ulong word = set[w];
+            while (word != 0)
+            {
+                if (count == bits.Length)
+                    return count;
+                bits[count++] = (w << 6) + BitOperations.TrailingZeroCount(word);
+                word &= word - 1;
+            }
+        }
+        return count;
+    }
+}
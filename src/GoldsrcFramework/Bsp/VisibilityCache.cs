@@ -0,0 +1,521 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+
+namespace GoldsrcFramework.Bsp;
+
+/// <summary>
+/// Counters of a <see cref="VisibilityCache"/> since load.
+/// </summary>
+public readonly record struct VisibilityCacheStats(
+    long PvsHits,
+    long PvsMisses,
+    long PasHits,
+    long PasMisses,
+    long Evictions,
+    int PvsRows,
+    int PasRows,
+    long Bytes,
+    long BudgetBytes)
+{
+    public override string ToString() =>
+        $"pvs {PvsHits} hits / {PvsMisses} misses ({PvsRows} rows), pas {PasHits} hits / {PasMisses} misses ({PasRows} rows), " +
+        $"{Evictions} evictions, {Bytes / 1024} of {BudgetBytes / 1024} KB";
+}
+
+/// <summary>
+/// Decompressed PVS / PAS rows of a map, over a copy of its visdata and node tree.
+///
+/// The engine run-length decodes a leaf's visdata on every ENGINE_SET_PVS and every CheckVisibility; here each
+/// leaf is decoded once, on first use, into a bitset row (bit <c>i</c> = leaf <c>i + 1</c>, byte-compatible with the
+/// engine's rows on little-endian) kept in a fixed memory budget. Rows are evicted with the clock algorithm when the
+/// budget is full, so huge maps degrade to re-decoding rather than growing. PAS rows are the union of the PVS of
+/// every leaf a leaf can see, as SV_CalcPAS builds them, but only for leafs that are actually asked about.
+///
+/// Main thread only. Spans returned by <see cref="GetPvs"/> / <see cref="GetPas"/> stay valid until the next call
+/// that may decode a row; copy them to keep them longer.
+/// </summary>
+public sealed class VisibilityCache
+{
+    /// <summary>
+    /// Default memory for decoded rows, split evenly between PVS and PAS. Holds every row of a 4096-leaf map.
+    /// </summary>
+    public const int DefaultBudgetBytes = 4 << 20;
+
+    /// <summary>
+    /// SV_AddToFatPVS radius around the eye.
+    /// </summary>
+    public const float FatPvsRadius = 8;
+
+    private struct VisNode
+    {
+        public Vector3 Normal;
+        public float Dist;
+        public int Type;
+        public int Child0;
+        public int Child1;
+    }
+
+    private readonly byte[] _visData;
+    private readonly int[] _leafVisOffsets;
+    private readonly int[] _leafContents;
+    private readonly VisNode[] _nodes;
+    private readonly int _headNode;
+    private readonly ulong[] _allVisible;
+    private readonly int[] _scratchLeafs;
+    private readonly RowCache _pvs;
+    private readonly RowCache _pas;
+    private long _pvsHits, _pvsMisses, _pasHits, _pasMisses;
+
+    /// <param name="visData">Compressed visibility lump.</param>
+    /// <param name="leafVisOffsets">Offset into <paramref name="visData"/> per leaf, -1 for none; leaf 0 is the solid leaf.</param>
+    /// <param name="leafContents">CONTENTS_* per leaf.</param>
+    /// <param name="nodes">Node tree as (plane, children) with dnode_t child encoding (negative = leaf -1 - child).</param>
+    /// <param name="planes">Planes indexed by the nodes.</param>
+    /// <param name="headNode">World model head node.</param>
+    /// <param name="visLeafs">Leafs covered by visdata (dmodel_t.visleafs of the world).</param>
+    /// <param name="budgetBytes">Memory for decoded rows.</param>
+    public VisibilityCache(byte[] visData, int[] leafVisOffsets, int[] leafContents, ReadOnlySpan<dnode_t> nodes,
+        ReadOnlySpan<dplane_t> planes, int headNode, int visLeafs, int budgetBytes = DefaultBudgetBytes)
+    {
+        if (leafVisOffsets.Length != leafContents.Length)
+            throw new ArgumentException("Leaf arrays differ in length.", nameof(leafContents));
+        if (leafVisOffsets.Length == 0 || visLeafs < 0 || visLeafs >= leafVisOffsets.Length)
+            throw new InvalidDataException($"visleafs {visLeafs} out of range of {leafVisOffsets.Length} leafs");
+        if (!IsChildInRange(headNode, nodes.Length, leafVisOffsets.Length))
+            throw new InvalidDataException($"head node {headNode} out of range");
+
+        _visData = visData;
+        _leafVisOffsets = leafVisOffsets;
+        _leafContents = leafContents;
+        _headNode = headNode;
+        LeafCount = visLeafs;
+        RowWords = Math.Max(VisBits.WordsFor(visLeafs), 1);
+
+        _nodes = new VisNode[nodes.Length];
+        for (int i = 0; i < nodes.Length; i++)
+        {
+            if ((uint)nodes[i].planenum >= (uint)planes.Length)
+                throw new InvalidDataException($"node {i} references plane {nodes[i].planenum} of {planes.Length}");
+            if (!IsChildInRange(nodes[i].children[0], nodes.Length, leafVisOffsets.Length) ||
+                !IsChildInRange(nodes[i].children[1], nodes.Length, leafVisOffsets.Length))
+                throw new InvalidDataException($"node {i} has a child out of range");
+            ref readonly var plane = ref planes[nodes[i].planenum];
+            _nodes[i] = new VisNode
+            {
+                Normal = plane.normal,
+                Dist = plane.dist,
+                Type = plane.type,
+                Child0 = nodes[i].children[0],
+                Child1 = nodes[i].children[1],
+            };
+        }
+
+        _allVisible = new ulong[RowWords];
+        _allVisible.AsSpan().Fill(ulong.MaxValue);
+        if ((visLeafs & 63) != 0)
+            _allVisible[^1] = (1UL << visLeafs) - 1;
+
+        _scratchLeafs = new int[Math.Max(visLeafs, 1)];
+        long rowBytes = RowWords * sizeof(ulong);
+        _pvs = new RowCache(RowWords, leafVisOffsets.Length, (int)Math.Max(budgetBytes / 2 / rowBytes, 1));
+        _pas = new RowCache(RowWords, leafVisOffsets.Length, (int)Math.Max(budgetBytes / 2 / rowBytes, 1));
+        BudgetBytes = budgetBytes;
+    }
+
+    /// <summary>
+    /// Copy the visibility of the world model of <paramref name="bsp"/>.
+    /// </summary>
+    public static VisibilityCache Load(BspFile bsp, int budgetBytes = DefaultBudgetBytes)
+    {
+        var leafs = bsp.Leafs;
+        var models = bsp.Models;
+        if (leafs.Length == 0 || models.Length == 0)
+            throw new InvalidDataException("map has no leafs or no world model");
+
+        var offsets = new int[leafs.Length];
+        var contents = new int[leafs.Length];
+        for (int i = 0; i < leafs.Length; i++)
+        {
+            offsets[i] = leafs[i].visofs;
+            contents[i] = leafs[i].contents;
+        }
+
+        return new VisibilityCache(bsp.Visibility.ToArray(), offsets, contents, bsp.Nodes, bsp.Planes,
+            models[0].headnode[0], Math.Min(models[0].visleafs, leafs.Length - 1), budgetBytes);
+    }
+
+    /// <summary>
+    /// Leafs with visibility bits (leaf 0, the solid leaf, has none).
+    /// </summary>
+    public int LeafCount { get; }
+
+    /// <summary>
+    /// Length of a row in ulongs.
+    /// </summary>
+    public int RowWords { get; }
+
+    public long BudgetBytes { get; }
+
+    public VisibilityCacheStats Stats => new(_pvsHits, _pvsMisses, _pasHits, _pasMisses, _pvs.Evictions + _pas.Evictions,
+        _pvs.Count, _pas.Count, (long)(_pvs.Allocated + _pas.Allocated) * RowWords * sizeof(ulong), BudgetBytes);
+
+    public int GetContents(int leaf) => _leafContents[leaf];
+
+    /// <summary>
+    /// Leaf containing <paramref name="point"/> (Mod_PointInLeaf); 0 when outside the world.
+    /// </summary>
+    public int LeafAt(Vector3 point)
+    {
+        int node = _headNode;
+        while (node >= 0)
+        {
+            ref readonly var n = ref _nodes[node];
+            node = PlaneDistance(n, point) > 0 ? n.Child0 : n.Child1;
+        }
+        return -1 - node;
+    }
+
+    /// <summary>
+    /// Non-solid leafs touched by the box, as SV_FindTouchedLeafs links an entity. Returns the count written, or -1
+    /// when there were more than <paramref name="leafs"/> can hold (the engine then falls back to a head node test).
+    /// </summary>
+    public int BoxLeafs(Vector3 mins, Vector3 maxs, Span<int> leafs)
+    {
+        int count = 0;
+        return BoxLeafs(_headNode, mins, maxs, leafs, ref count) ? count : -1;
+    }
+
+    /// <summary>
+    /// Decoded PVS of <paramref name="leaf"/>; everything for leaf 0 and for leafs without visdata, like Mod_LeafPVS.
+    /// </summary>
+    public ReadOnlySpan<ulong> GetPvs(int leaf)
+    {
+        if (leaf <= 0 || leaf > LeafCount || _leafVisOffsets[leaf] < 0 || _visData.Length == 0)
+            return _allVisible;
+
+        if (_pvs.TryGet(leaf, out var row))
+        {
+            _pvsHits++;
+            return row;
+        }
+
+        _pvsMisses++;
+        row = _pvs.Add(leaf);
+        Decompress(_leafVisOffsets[leaf], row);
+        return row;
+    }
+
+    /// <summary>
+    /// Decoded PAS of <paramref name="leaf"/>: the union of the PVS of every leaf in its PVS.
+    /// </summary>
+    public ReadOnlySpan<ulong> GetPas(int leaf)
+    {
+        if (leaf <= 0 || leaf > LeafCount || _leafVisOffsets[leaf] < 0 || _visData.Length == 0)
+            return _allVisible;
+
+        if (_pas.TryGet(leaf, out var row))
+        {
+            _pasHits++;
+            return row;
+        }
+
+        _pasMisses++;
+        row = _pas.Add(leaf);
+        var pvs = GetPvs(leaf);
+        pvs.CopyTo(row);
+        int visible = VisBits.GetSetBits(pvs, _scratchLeafs);
+        for (int i = 0; i < visible; i++)
+            VisBits.Or(row, GetPvs(_scratchLeafs[i] + 1));
+        return row;
+    }
+
+    /// <summary>
+    /// <paramref name="destination"/> = union of the PVS of <paramref name="leafs"/>, e.g. every viewer of a client
+    /// (player plus camera) or every leaf around an eye.
+    /// </summary>
+    public void UnionPvs(ReadOnlySpan<int> leafs, Span<ulong> destination)
+    {
+        destination.Clear();
+        foreach (int leaf in leafs)
+            VisBits.Or(destination, GetPvs(leaf));
+    }
+
+    public void UnionPas(ReadOnlySpan<int> leafs, Span<ulong> destination)
+    {
+        destination.Clear();
+        foreach (int leaf in leafs)
+            VisBits.Or(destination, GetPas(leaf));
+    }
+
+    /// <summary>
+    /// PVS around an eye (ENGINE_SET_PVS): the union over every leaf within <see cref="FatPvsRadius"/>.
+    /// </summary>
+    public void FatPvs(Vector3 eye, Span<ulong> destination)
+    {
+        Span<int> leafs = stackalloc int[64];
+        int count = RadiusLeafs(eye, FatPvsRadius, leafs);
+        if (count < 0)
+            _allVisible.CopyTo(destination);
+        else
+            UnionPvs(leafs[..count], destination);
+    }
+
+    /// <summary>
+    /// PAS around an eye (ENGINE_SET_PAS).
+    /// </summary>
+    public void FatPas(Vector3 eye, Span<ulong> destination)
+    {
+        Span<int> leafs = stackalloc int[64];
+        int count = RadiusLeafs(eye, FatPvsRadius, leafs);
+        if (count < 0)
+            _allVisible.CopyTo(destination);
+        else
+            UnionPas(leafs[..count], destination);
+    }
+
+    /// <summary>
+    /// True when <paramref name="to"/> is in the PVS of <paramref name="from"/>.
+    /// </summary>
+    public bool IsVisible(int from, int to) => to > 0 && VisBits.Test(GetPvs(from), to - 1);
+
+    /// <summary>
+    /// True when leaf <paramref name="leaf"/> is in <paramref name="set"/>.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public static bool Contains(ReadOnlySpan<ulong> set, int leaf) => leaf > 0 && VisBits.Test(set, leaf - 1);
+
+    /// <summary>
+    /// Decode a leaf's PVS without touching the cache, the way the engine does on every call.
+    /// </summary>
+    public void DecompressPvs(int leaf, Span<ulong> row)
+    {
+        if (leaf <= 0 || leaf > LeafCount || _leafVisOffsets[leaf] < 0 || _visData.Length == 0)
+            _allVisible.CopyTo(row);
+        else
+            Decompress(_leafVisOffsets[leaf], row[..RowWords]);
+    }
+
+    /// <summary>
+    /// Drop every decoded row.
+    /// </summary>
+    public void Clear()
+    {
+        _pvs.Clear();
+        _pas.Clear();
+    }
+
+    // Mod_DecompressVis: a zero byte is followed by a count of zero bytes. Malformed input ends the row early;
+    // the rest stays empty.
+    private void Decompress(int offset, Span<ulong> row)
+    {
+        var output = MemoryMarshal.AsBytes(row);
+        output.Clear();
+        int rowBytes = (LeafCount + 7) >> 3;
+        var input = _visData.AsSpan();
+        int o = 0, i = offset;
+        while (o < rowBytes && (uint)i < (uint)input.Length)
+        {
+            byte b = input[i++];
+            if (b != 0)
+            {
+                output[o++] = b;
+                continue;
+            }
+            if ((uint)i >= (uint)input.Length)
+                break;
+            o += input[i++];
+        }
+
+        // Bits past the last leaf can be set by the compiler's byte padding.
+        if ((LeafCount & 63) != 0)
+            row[RowWords - 1] &= (1UL << LeafCount) - 1;
+    }
+
+    private static bool IsChildInRange(int child, int nodes, int leafs) => child >= 0 ? child < nodes : -1 - child < leafs;
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static float PlaneDistance(in VisNode node, Vector3 point) => node.Type switch
+    {
+        0 => point.X - node.Dist,
+        1 => point.Y - node.Dist,
+        2 => point.Z - node.Dist,
+        _ => Vector3.Dot(node.Normal, point) - node.Dist,
+    };
+
+    private bool BoxLeafs(int node, Vector3 mins, Vector3 maxs, Span<int> leafs, ref int count)
+    {
+        while (node >= 0)
+        {
+            ref readonly var n = ref _nodes[node];
+            int sides = BoxOnPlaneSide(n, mins, maxs);
+            if (sides == 3)
+            {
+                if (!BoxLeafs(n.Child0, mins, maxs, leafs, ref count))
+                    return false;
+                node = n.Child1;
+            }
+            else
+            {
+                node = sides == 1 ? n.Child0 : n.Child1;
+            }
+        }
+
+        int leaf = -1 - node;
+        if (_leafContents[leaf] == BspConstants.CONTENTS_SOLID)
+            return true;
+        if (count == leafs.Length)
+            return false;
+        leafs[count++] = leaf;
+        return true;
+    }
+
+    // BOX_ON_PLANE_SIDE: 1 = in front, 2 = behind, 3 = crossing.
+    private static int BoxOnPlaneSide(in VisNode node, Vector3 mins, Vector3 maxs)
+    {
+        if (node.Type < 3)
+        {
+            float lo = node.Type == 0 ? mins.X : node.Type == 1 ? mins.Y : mins.Z;
+            float hi = node.Type == 0 ? maxs.X : node.Type == 1 ? maxs.Y : maxs.Z;
+            if (node.Dist <= lo)
+                return 1;
+            if (node.Dist >= hi)
+                return 2;
+            return 3;
+        }
+
+        var n = node.Normal;
+        float near = (n.X < 0 ? maxs.X : mins.X) * n.X + (n.Y < 0 ? maxs.Y : mins.Y) * n.Y + (n.Z < 0 ? maxs.Z : mins.Z) * n.Z;
+        float far = (n.X < 0 ? mins.X : maxs.X) * n.X + (n.Y < 0 ? mins.Y : maxs.Y) * n.Y + (n.Z < 0 ? mins.Z : maxs.Z) * n.Z;
+        int sides = 0;
+        if (far >= node.Dist)
+            sides = 1;
+        if (near < node.Dist)
+            sides |= 2;
+        return sides;
+    }
+
+    // SV_AddToFatPVS: every non-solid leaf within radius of the point.
+    private int RadiusLeafs(Vector3 point, float radius, Span<int> leafs)
+    {
+        int count = 0;
+        return RadiusLeafs(_headNode, point, radius, leafs, ref count) ? count : -1;
+    }
+
+    private bool RadiusLeafs(int node, Vector3 point, float radius, Span<int> leafs, ref int count)
+    {
+        while (node >= 0)
+        {
+            ref readonly var n = ref _nodes[node];
+            float d = PlaneDistance(n, point);
+            if (d > radius)
+            {
+                node = n.Child0;
+            }
+            else if (d < -radius)
+            {
+                node = n.Child1;
+            }
+            else
+            {
+                if (!RadiusLeafs(n.Child0, point, radius, leafs, ref count))
+                    return false;
+                node = n.Child1;
+            }
+        }
+
+        int leaf = -1 - node;
+        if (_leafContents[leaf] == BspConstants.CONTENTS_SOLID)
+            return true;
+        if (count == leafs.Length)
+            return false;
+        leafs[count++] = leaf;
+        return true;
+    }
+
+    /// <summary>
+    /// Fixed number of row slots, grown on demand up to the budget, with clock (second chance) eviction.
+    /// </summary>
+    private sealed class RowCache
+    {
+        private readonly int _words;
+        private readonly int _capacity;
+        private readonly int[] _slotOfLeaf;
+        private int[] _leafOfSlot = Array.Empty<int>();
+        private bool[] _referenced = Array.Empty<bool>();
+        private ulong[] _rows = Array.Empty<ulong>();
+        private int _hand;
+
+        public RowCache(int words, int leafs, int capacity)
+        {
+            _words = words;
+            _capacity = Math.Min(capacity, Math.Max(leafs, 1));
+            _slotOfLeaf = new int[leafs];
+            _slotOfLeaf.AsSpan().Fill(-1);
+        }
+
+        public int Count { get; private set; }
+
+        public int Allocated => _leafOfSlot.Length;
+
+        public long Evictions { get; private set; }
+
+        public bool TryGet(int leaf, out Span<ulong> row)
+        {
+            int slot = _slotOfLeaf[leaf];
+            if (slot < 0)
+            {
+                row = default;
+                return false;
+            }
+            _referenced[slot] = true;
+            row = _rows.AsSpan(slot * _words, _words);
+            return true;
+        }
+
+        public Span<ulong> Add(int leaf)
+        {
+            int slot;
+            if (Count < _capacity)
+            {
+                if (Count == _leafOfSlot.Length)
+                    Grow();
+                slot = Count++;
+            }
+            else
+            {
+                while (_referenced[_hand])
+                {
+                    _referenced[_hand] = false;
+                    _hand = (_hand + 1) % _capacity;
+                }
+                slot = _hand;
+                _hand = (_hand + 1) % _capacity;
+                _slotOfLeaf[_leafOfSlot[slot]] = -1;
+                Evictions++;
+            }
+
+            _slotOfLeaf[leaf] = slot;
+            _leafOfSlot[slot] = leaf;
+            _referenced[slot] = true;
+            return _rows.AsSpan(slot * _words, _words);
+        }
+
+        public void Clear()
+        {
+            for (int i = 0; i < Count; i++)
+                _slotOfLeaf[_leafOfSlot[i]] = -1;
+            Count = 0;
+            _hand = 0;
+        }
+
+        private void Grow()
+        {
+            int size = Math.Min(Math.Max(_leafOfSlot.Length * 2, 64), _capacity);
+            Array.Resize(ref _leafOfSlot, size);
+            Array.Resize(ref _referenced, size);
+            Array.Resize(ref _rows, size * _words);
+        }
+    }
+}
@@ -2,8 +2,13 @@ using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 using GoldsrcFramework.Engine.Native;
 using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Configuration;
 using GoldsrcFramework.DependencyInjection;
+using GoldsrcFramework.Diagnostics;
+using GoldsrcFramework.Jobs;
+using GoldsrcFramework.Replay;
 using Microsoft.Extensions.Logging;
+using Microsoft.Extensions.Options;
 using NativeInterop;
 
 namespace GoldsrcFramework
@@ -24,6 +29,19 @@ namespace GoldsrcFramework
 
                 var logger = ServiceContainer.GetServiceOrNull<ILogger<object>>();
                 logger?.LogInformation("ClientMain initialized with {ClientType}", s_client.GetType().Name);
+
+                // Capture mode: record every call when Framework:CaptureTracePath is set
+                var settings = ServiceContainer.GetServiceOrNull<IOptions<FrameworkSettings>>()?.Value;
+                if (TraceCapture.StartIfConfigured(settings?.CaptureTracePath))
+                    s_client = new RecordingClientExports(s_client);
+
+                // Frame-hitch detection when Framework:FrameBudgetMilliseconds is set
+                var profiler = FrameProfiler.CreateIfConfigured("client", settings);
+                if (profiler != null)
+                    s_client = new ProfilingClientExports(s_client, profiler);
+
+                // Frame-synchronous job scheduler, shared with the server in a listen server; workers start on the first job
+                JobScheduler.EnsureShared(ServiceContainer.GetServiceOrNull<IOptions<GameSettings>>()?.Value);
             }
             catch (Exception ex)
             {
@@ -112,7 +130,15 @@ namespace GoldsrcFramework
         [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
         static int HUD_Redraw(float flTime, int intermission)
         {
-            return s_client.HUD_Redraw(flTime, intermission);
+            try
+            {
+                return s_client.HUD_Redraw(flTime, intermission);
+            }
+            finally
+            {
+                // Frame fence: jobs scheduled this frame finish before the engine gets control back
+                JobScheduler.Shared?.CompleteFrame();
+            }
         }
 
         [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
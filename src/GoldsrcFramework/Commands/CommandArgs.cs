@@ -0,0 +1,120 @@
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Strings;
+using NativeInterop;
+
+namespace GoldsrcFramework.Commands;
+
+/// <summary>
+/// Arguments of the command being executed, as <see cref="Utf8View"/>s over the engine's own buffers.
+///
+/// Read straight from Cmd_Argc / Cmd_Argv / Cmd_Args, or from a line split by <see cref="Tokenize"/>.
+/// Valid only for the duration of the command callback.
+/// </summary>
+public readonly unsafe ref struct CommandArgs
+{
+    private readonly delegate* unmanaged[Cdecl]<int, NChar*> _argv;
+    private readonly delegate* unmanaged[Cdecl]<NChar*> _args;
+    private readonly ReadOnlySpan<byte> _line;
+    private readonly ReadOnlySpan<Range> _tokens;
+    private readonly int _argsStart;
+
+    private CommandArgs(delegate* unmanaged[Cdecl]<int> argc, delegate* unmanaged[Cdecl]<int, NChar*> argv, delegate* unmanaged[Cdecl]<NChar*> args)
+    {
+        _argv = argv;
+        _args = args;
+        Count = argc != null ? argc() : 0;
+    }
+
+    private CommandArgs(ReadOnlySpan<byte> line, ReadOnlySpan<Range> tokens, int argsStart)
+    {
+        _line = line;
+        _tokens = tokens;
+        _argsStart = argsStart;
+        Count = tokens.Length;
+    }
+
+    /// <summary>
+    /// The command the server is executing (ClientCommand, server console commands).
+    /// </summary>
+    public static CommandArgs FromServer(ServerEngineFuncs* engine) => new(engine->Cmd_Argc, engine->Cmd_Argv, engine->Cmd_Args);
+
+    /// <summary>
+    /// The command the client is executing. The client API has no Cmd_Args, so <see cref="Args"/> is empty.
+    /// </summary>
+    public static CommandArgs FromClient(ClientEngineFuncs* engine) => new(engine->Cmd_Argc, engine->Cmd_Argv, null);
+
+    /// <summary>
+    /// Split <paramref name="line"/> like Cmd_TokenizeString: whitespace separated, "quoted" tokens keep their spaces,
+    /// // starts a comment. Token ranges go into <paramref name="tokens"/>; extra tokens are dropped.
+    /// </summary>
+    public static CommandArgs Tokenize(ReadOnlySpan<byte> line, Span<Range> tokens)
+    {
+        int count = 0;
+        int argsStart = line.Length;
+        int i = 0;
+        while (count < tokens.Length)
+        {
+            while (i < line.Length && line[i] <= ' ' && line[i] != 0)
+                i++;
+            if (i >= line.Length || line[i] == 0 || (line[i] == '/' && i + 1 < line.Length && line[i + 1] == '/'))
+                break;
+
+            if (count == 1)
+                argsStart = i;
+
+            if (line[i] == '"')
+            {
+                int start = ++i;
+                while (i < line.Length && line[i] != '"' && line[i] != 0)
+                    i++;
+                tokens[count++] = start..i;
+                if (i < line.Length && line[i] == '"')
+                    i++;
+            }
+            else
+            {
+                int start = i;
+                while (i < line.Length && line[i] > ' ')
+                    i++;
+                tokens[count++] = start..i;
+            }
+        }
+
+        return new CommandArgs(line, tokens[..count], argsStart);
+    }
+
+    /// <summary>
+    /// Number of arguments including the command name.
+    /// </summary>
+    public int Count { get; }
+
+    /// <summary>
+    /// Argument <paramref name="index"/>; 0 is the command name. Empty when out of range.
+    /// </summary>
+    public Utf8View this[int index]
+    {
+        get
+        {
+            if ((uint)index >= (uint)Count)
+                return default;
+            return _argv != null ? new Utf8View(_argv(index)) : new Utf8View(_line[_tokens[index]]);
+        }
+    }
+
+    public Utf8View Name => this[0];
+
+    /// <summary>
+    /// Everything after the command name, as typed (Cmd_Args); e.g. the text of a say.
+    /// </summary>
+    public Utf8View Args
+    {
+        get
+        {
+            if (_args != null)
+                return new Utf8View(_args()).Trim();
+            if (_argv != null || Count < 2)
+                return default;
+            return new Utf8View(_line[_argsStart..]).Trim();
+        }
+    }
+}
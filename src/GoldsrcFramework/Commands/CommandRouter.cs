@@ -0,0 +1,60 @@
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Strings;
+
+namespace GoldsrcFramework.Commands;
+
+/// <summary>
+/// Handler for a routed command. <paramref name="client"/> is the issuing player for ClientCommand, null for console commands.
+/// </summary>
+public unsafe delegate void CommandHandler(edict_t* client, CommandArgs args);
+
+/// <summary>
+/// Dispatches commands by name without allocating: the name in Cmd_Argv(0) is hashed in place and looked up in a
+/// <see cref="Utf8Map{TValue}"/> built when handlers are added. Names are case-insensitive, as in the engine.
+/// </summary>
+public sealed unsafe class CommandRouter
+{
+    private readonly Utf8Map<CommandHandler> _handlers = new(ignoreCase: true);
+
+    public int Count => _handlers.Count;
+
+    /// <summary>
+    /// Commands that found a handler.
+    /// </summary>
+    public long Dispatched { get; private set; }
+
+    /// <summary>
+    /// Commands that did not, and were left to the next handler (usually the legacy DLL).
+    /// </summary>
+    public long Unhandled { get; private set; }
+
+    public IEnumerable<string> Names => _handlers.Keys;
+
+    /// <summary>
+    /// Route <paramref name="name"/> to <paramref name="handler"/>, replacing any previous handler.
+    /// </summary>
+    public void Add(string name, CommandHandler handler)
+    {
+        ArgumentException.ThrowIfNullOrWhiteSpace(name);
+        ArgumentNullException.ThrowIfNull(handler);
+        _handlers.Set(name, handler);
+    }
+
+    public bool Contains(Utf8View name) => _handlers.ContainsKey(name);
+
+    /// <summary>
+    /// Run the handler for <c>args[0]</c>. Returns false when there is none.
+    /// </summary>
+    public bool TryDispatch(edict_t* client, CommandArgs args)
+    {
+        if (args.Count == 0 || !_handlers.TryGetValue(args.Name, out var handler))
+        {
+            Unhandled++;
+            return false;
+        }
+
+        Dispatched++;
+        handler(client, args);
+        return true;
+    }
+}
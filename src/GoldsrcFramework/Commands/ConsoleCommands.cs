@@ -0,0 +1,66 @@
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Strings;
+
+namespace GoldsrcFramework.Commands;
+
+/// <summary>
+/// Managed console commands. The engine's AddServerCommand / AddCommand take a callback without arguments,
+/// so every command is registered with the same trampoline, which routes on Cmd_Argv(0).
+/// </summary>
+public static unsafe class ConsoleCommands
+{
+    public static CommandRouter Server { get; } = new();
+
+    public static CommandRouter Client { get; } = new();
+
+    /// <summary>
+    /// Register a server console command. Call after GiveFnptrsToDll.
+    /// </summary>
+    public static void AddServerCommand(string name, CommandHandler handler)
+    {
+        bool known = Server.Contains(new Utf8View(Utf8StringPool.Shared.Intern(name)));
+        Server.Add(name, handler);
+        if (!known)
+            EngineApi.PServer->AddServerCommand(Utf8StringPool.Shared.Intern(name), &ServerCommand);
+    }
+
+    /// <summary>
+    /// Register a client console command. Call after the client Initialize.
+    /// </summary>
+    public static void AddClientCommand(string name, CommandHandler handler)
+    {
+        bool known = Client.Contains(new Utf8View(Utf8StringPool.Shared.Intern(name)));
+        Client.Add(name, handler);
+        if (!known)
+            EngineApi.PClient->AddCommand(Utf8StringPool.Shared.Intern(name), &ClientCommand);
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void ServerCommand()
+    {
+        try
+        {
+            Server.TryDispatch(null, CommandArgs.FromServer(EngineApi.PServer));
+        }
+        catch (Exception ex)
+        {
+            // Never let an exception unwind into the engine.
+            Debug.WriteLine($"[ConsoleCommands] Server command failed: {ex}");
+        }
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void ClientCommand()
+    {
+        try
+        {
+            Client.TryDispatch(null, CommandArgs.FromClient(EngineApi.PClient));
+        }
+        catch (Exception ex)
+        {
+            Debug.WriteLine($"[ConsoleCommands] Client command failed: {ex}");
+        }
+    }
+}
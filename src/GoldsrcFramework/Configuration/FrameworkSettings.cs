@@ -3,6 +3,7 @@ namespace GoldsrcFramework.Configuration
     /// <summary>
     /// Framework configuration settings
     /// </summary>
+    [GoldsrcSettings("Framework")]
     public class FrameworkSettings
     {
         /// <summary>
@@ -34,11 +35,32 @@ namespace GoldsrcFramework.Configuration
         /// Game client assembly name
         /// </summary>
         public string? GameClientAssembly { get; set; }
+
+        /// <summary>
+        /// Record every engine→mod call to this trace file for offline replay (empty to disable)
+        /// </summary>
+        public string? CaptureTracePath { get; set; }
+
+        /// <summary>
+        /// Frames longer than this are logged as hitches with GC / JIT / export attribution (0 to disable)
+        /// </summary>
+        public double FrameBudgetMilliseconds { get; set; } = 0;
+
+        /// <summary>
+        /// Append hitch frames to this CSV file, one per side (e.g. hitches.server.csv); empty for log output only
+        /// </summary>
+        public string? FrameHitchCsvPath { get; set; }
+
+        /// <summary>
+        /// Frames written before each hitch for context
+        /// </summary>
+        public int FrameHitchContextFrames { get; set; } = 8;
     }
 
     /// <summary>
     /// Logging configuration settings
     /// </summary>
+    [GoldsrcSettings("Logging")]
     public class LoggingSettings
     {
         /// <summary>
@@ -60,11 +82,32 @@ namespace GoldsrcFramework.Configuration
         /// Log file path
         /// </summary>
         public string? LogFilePath { get; set; }
+
+        /// <summary>
+        /// Log through the background log thread instead of the synchronous Console / Debug providers
+        /// </summary>
+        public bool Async { get; set; } = true;
+
+        /// <summary>
+        /// Size at which the log file rolls over (KB)
+        /// </summary>
+        public int FileMaxKilobytes { get; set; } = 10240;
+
+        /// <summary>
+        /// Log files kept, including the current one
+        /// </summary>
+        public int FileCount { get; set; } = 5;
+
+        /// <summary>
+        /// Records buffered per logging thread before new ones are dropped
+        /// </summary>
+        public int RingCapacity { get; set; } = 8192;
     }
 
     /// <summary>
     /// Game configuration settings
     /// </summary>
+    [GoldsrcSettings("Game")]
     public class GameSettings
     {
         /// <summary>
@@ -87,6 +130,81 @@ namespace GoldsrcFramework.Configuration
         /// </summary>
         public int PhysicsUpdateRate { get; set; } = 60;
 
+        /// <summary>
+        /// Solver substeps per physics step
+        /// </summary>
+        public int PhysicsSubsteps { get; set; } = 1;
+
+        /// <summary>
+        /// Max physics steps per server frame; excess time is dropped
+        /// </summary>
+        public int PhysicsMaxStepsPerFrame { get; set; } = 4;
+
+        /// <summary>
+        /// Physics solver threads (0 = processor count)
+        /// </summary>
+        public int PhysicsThreadCount { get; set; } = 0;
+
+        /// <summary>
+        /// Job scheduler worker threads (0 = processor count - 1)
+        /// </summary>
+        public int JobWorkerCount { get; set; } = 0;
+
+        /// <summary>
+        /// Jobs that can be scheduled between two frame fences; more run on the scheduling thread
+        /// </summary>
+        public int JobsPerFrame { get; set; } = 4096;
+
+        /// <summary>
+        /// Keep job workers off the processor the engine thread was on when they started; a hint, since the engine
+        /// thread itself is not pinned
+        /// </summary>
+        public bool PinJobWorkers { get; set; } = true;
+
+        /// <summary>
+        /// Load the map's visibility data and track which leafs entities are in, for game code that reads
+        /// FrameworkServerExports.Visibility; costs a .bsp load per level and work in every SetAbsBox and SetupVisibility
+        /// </summary>
+        public bool EnableVisibilityCache { get; set; } = false;
+
+        /// <summary>
+        /// Memory for decoded PVS / PAS rows (KB)
+        /// </summary>
+        public int VisibilityCacheKilobytes { get; set; } = 4096;
+
+        /// <summary>
+        /// Answer SetupVisibility from the visibility cache instead of the legacy game DLL; needs EnableVisibilityCache
+        /// </summary>
+        public bool ManagedSetupVisibility { get; set; } = false;
+
+        /// <summary>
+        /// Simulate temp entities in managed code (TempEntitySimulator) instead of the legacy client's HUD_TempEntUpdate
+        /// </summary>
+        public bool ManagedTempEntities { get; set; } = false;
+
+        /// <summary>
+        /// Batch MessageWriter output and replay it on Flush instead of writing each call to the engine; slower unless
+        /// engine calls are unusually expensive (see MessageWriterBenchmark)
+        /// </summary>
+        public bool BatchNetworkMessages { get; set; } = false;
+
+        /// <summary>
+        /// Record HUD_Draw*Triangles geometry drawn through FrameworkClientExports.Triangles and submit it sorted and
+        /// merged at the end of each hook, instead of drawing it directly
+        /// </summary>
+        public bool BatchTriangles { get; set; } = false;
+
+        /// <summary>
+        /// Register the managed Entity_Encode delta encoder (EntityEncoder) in place of the legacy game DLL's
+        /// </summary>
+        public bool ManagedEntityEncoder { get; set; } = false;
+
+        /// <summary>
+        /// Reuse the client's predicted weapon state for commands already run from exactly the same inputs, instead of
+        /// running HUD_PostRunCmd again
+        /// </summary>
+        public bool EnablePredictionCache { get; set; } = false;
+
         /// <summary>
         /// Custom game settings
         /// </summary>
@@ -0,0 +1,21 @@
+namespace GoldsrcFramework.Configuration
+{
+    /// <summary>
+    /// Marks a settings class bound from a modSettings.json section. The SDK's source generator emits a
+    /// reflection-free binder for it and registers it as <c>IOptions&lt;T&gt;</c> at startup.
+    /// </summary>
+    [AttributeUsage(AttributeTargets.Class, Inherited = false)]
+    public sealed class GoldsrcSettingsAttribute : Attribute
+    {
+        /// <param name="section">Configuration section, e.g. "Game"</param>
+        public GoldsrcSettingsAttribute(string section)
+        {
+            Section = section;
+        }
+
+        /// <summary>
+        /// Configuration section the class is bound from
+        /// </summary>
+        public string Section { get; }
+    }
+}
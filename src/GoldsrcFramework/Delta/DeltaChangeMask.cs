@@ -0,0 +1,107 @@
+using System.Numerics;
+using System.Runtime.CompilerServices;
+using System.Runtime.Intrinsics;
+
+namespace GoldsrcFramework.Delta;
+
+/// <summary>
+/// One bit per 4-byte word of a delta-encoded struct, set where <c>from</c> and <c>to</c> differ.
+/// Covers structs up to 1024 bytes (entity_state_t is 340).
+/// </summary>
+public unsafe struct DeltaChangeMask
+{
+    public const int MaxWords = 256;
+    public const int MaxBytes = MaxWords * 4;
+
+    private fixed ulong _bits[MaxWords / 64];
+
+    /// <summary>
+    /// Raw bits for words [64 * lane, 64 * lane + 63].
+    /// </summary>
+    public readonly ulong this[int lane] => _bits[lane];
+
+    public readonly bool IsEmpty => (_bits[0] | _bits[1] | _bits[2] | _bits[3]) == 0;
+
+    /// <summary>
+    /// Number of changed words.
+    /// </summary>
+    public readonly int Count =>
+        BitOperations.PopCount(_bits[0]) + BitOperations.PopCount(_bits[1]) +
+        BitOperations.PopCount(_bits[2]) + BitOperations.PopCount(_bits[3]);
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public readonly bool IsWordChanged(int word) => (_bits[word >> 6] & (1UL << word)) != 0;
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private void Or(int word, ulong bits) => _bits[word >> 6] |= bits << word;
+
+    /// <summary>
+    /// Compare <paramref name="size"/> bytes 32 at a time with Vector256 (Vector128 / scalar fallback).
+    /// A trailing partial word counts as one word.
+    /// </summary>
+    public static DeltaChangeMask Compute(byte* from, byte* to, int size)
+    {
+        if ((uint)size > MaxBytes)
+            throw new ArgumentOutOfRangeException(nameof(size));
+
+        var mask = new DeltaChangeMask();
+        int i = 0;
+
+        // Word indices advance by 8 (or 4), so a chunk never straddles two ulong lanes.
+        if (Vector256.IsHardwareAccelerated)
+        {
+            for (; i + 32 <= size; i += 32)
+            {
+                var eq = Vector256.Equals(Vector256.Load((uint*)(from + i)), Vector256.Load((uint*)(to + i)));
+                uint changed = ~eq.ExtractMostSignificantBits() & 0xFF;
+                if (changed != 0)
+                    mask.Or(i >> 2, changed);
+            }
+        }
+
+        if (Vector128.IsHardwareAccelerated)
+        {
+            for (; i + 16 <= size; i += 16)
+            {
+                var eq = Vector128.Equals(Vector128.Load((uint*)(from + i)), Vector128.Load((uint*)(to + i)));
+                uint changed = ~eq.ExtractMostSignificantBits() & 0xF;
+                if (changed != 0)
+                    mask.Or(i >> 2, changed);
+            }
+        }
+
+        ScalarTail(ref mask, from, to, i, size);
+        return mask;
+    }
+
+    /// <summary>
+    /// Word-by-word reference implementation.
+    /// </summary>
+    public static DeltaChangeMask ComputeScalar(byte* from, byte* to, int size)
+    {
+        if ((uint)size > MaxBytes)
+            throw new ArgumentOutOfRangeException(nameof(size));
+
+        var mask = new DeltaChangeMask();
+        ScalarTail(ref mask, from, to, 0, size);
+        return mask;
+    }
+
+    private static void ScalarTail(ref DeltaChangeMask mask, byte* from, byte* to, int i, int size)
+    {
+        for (; i + 4 <= size; i += 4)
+        {
+            if (Unsafe.ReadUnaligned<uint>(from + i) != Unsafe.ReadUnaligned<uint>(to + i))
+                mask.Or(i >> 2, 1);
+        }
+
+        for (int j = i; j < size; j++)
+        {
+            if (from[j] != to[j])
+            {
+                mask.Or(i >> 2, 1);
+                break;
+            }
+        }
+    }
+}
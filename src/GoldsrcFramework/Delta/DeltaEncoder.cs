@@ -0,0 +1,400 @@
+using System.Diagnostics;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Strings;
+
+namespace GoldsrcFramework.Delta;
+
+/// <summary>
+/// How often one struct field differed between <c>from</c> and <c>to</c>; Rate is per call made with statistics on.
+/// </summary>
+public readonly record struct DeltaFieldStatistics(string Name, int Offset, int Size, long Changes, double Rate);
+
+/// <summary>
+/// Handle to a delta field declared by <see cref="DeltaEncoder{TState}.Field"/>.
+/// </summary>
+public readonly struct DeltaField
+{
+    internal readonly int Slot;
+
+    internal DeltaField(int slot) => Slot = slot;
+}
+
+/// <summary>
+/// A conditional delta encoder registered with DeltaAddEncoder (see <see cref="DeltaEncoderRegistry"/>).
+/// The name must match the encoder named in delta.lst, e.g. "Entity_Encode".
+/// </summary>
+public abstract unsafe class DeltaEncoder
+{
+    protected DeltaEncoder(string name)
+    {
+        Name = name;
+    }
+
+    public string Name { get; }
+
+    /// <summary>
+    /// Trampoline slot assigned by <see cref="DeltaEncoderRegistry"/>, -1 while unregistered.
+    /// </summary>
+    public int Slot { get; internal set; } = -1;
+
+    /// <summary>
+    /// Engine table used for DeltaFindField / DeltaSetFieldByIndex. Set at registration.
+    /// </summary>
+    public ServerEngineFuncs* Engine { get; internal set; }
+
+    /// <summary>
+    /// Track how often each struct field changes. On by default; costs one pass over the changed words per call.
+    /// </summary>
+    public bool CollectStatistics { get; set; } = true;
+
+    public long Calls { get; protected set; }
+
+    /// <summary>
+    /// Calls where <see cref="Invoke"/> threw; the engine then keeps its own field selection.
+    /// </summary>
+    public long Faults { get; internal set; }
+
+    /// <summary>
+    /// Called by the engine for every entity, every client, every snapshot.
+    /// </summary>
+    internal abstract void Invoke(delta_s* fields, byte* from, byte* to);
+
+    /// <summary>
+    /// Per-field change counts since the last <see cref="ResetStatistics"/>, in struct order.
+    /// </summary>
+    public abstract DeltaFieldStatistics[] GetStatistics();
+
+    public abstract void ResetStatistics();
+}
+
+/// <summary>
+/// Base for managed conditional encoders over <typeparamref name="TState"/> (entity_state_t for
+/// Entity_Encode / Player_Encode / Custom_Encode).
+///
+/// Declare the fields to toggle once in the constructor with <see cref="Field"/>; their engine indices are looked up
+/// with DeltaFindField the first time the engine calls in with a delta description, so <see cref="Encode"/> only
+/// uses DeltaSetFieldByIndex / DeltaUnsetFieldByIndex. Changed fields are known up front from a SIMD compare of the two
+/// states (<see cref="DeltaEncodeContext{TState}.HasChanged"/>).
+/// </summary>
+public abstract unsafe class DeltaEncoder<TState> : DeltaEncoder where TState : unmanaged
+{
+    private struct FieldInfo
+    {
+        public string Name;
+        public int Offset;
+        public int Size;
+        public int EngineIndex;
+    }
+
+    private static readonly StructLayoutInfo s_layout = new(typeof(TState), sizeof(TState));
+
+    private FieldInfo[] _fields = new FieldInfo[8];
+    private int _fieldCount;
+    private delta_s* _resolvedFor;
+    private long _sampledCalls;
+    private readonly long[] _fieldChanges = new long[s_layout.Fields.Length];
+
+    protected DeltaEncoder(string name) : base(name)
+    {
+        if (sizeof(TState) > DeltaChangeMask.MaxBytes)
+            throw new ArgumentException($"{typeof(TState).Name} is larger than {DeltaChangeMask.MaxBytes} bytes.");
+    }
+
+    /// <summary>
+    /// Declare a delta field by its delta.lst name, e.g. "origin[0]" or "movetype". Constructor only.
+    /// </summary>
+    protected DeltaField Field(string name)
+    {
+        var (offset, size) = s_layout.Resolve(name);
+        if (_fieldCount == _fields.Length)
+            Array.Resize(ref _fields, _fields.Length * 2);
+
+        _fields[_fieldCount] = new FieldInfo { Name = name, Offset = offset, Size = size, EngineIndex = -1 };
+        _resolvedFor = null;
+        return new DeltaField(_fieldCount++);
+    }
+
+    /// <summary>
+    /// Engine index of a declared field, or -1 if the delta description has no such field (or nothing was resolved yet).
+    /// </summary>
+    public int GetEngineIndex(DeltaField field) => _fields[field.Slot].EngineIndex;
+
+    /// <summary>
+    /// Adjust which fields are sent. The engine has already marked every changed field before calling the encoder.
+    /// </summary>
+    protected abstract void Encode(ref DeltaEncodeContext<TState> context);
+
+    internal override void Invoke(delta_s* fields, byte* from, byte* to)
+    {
+        if (fields != _resolvedFor)
+            Resolve(fields);
+
+        var changed = DeltaChangeMask.Compute(from, to, sizeof(TState));
+        Calls++;
+        if (CollectStatistics)
+        {
+            _sampledCalls++;
+            if (!changed.IsEmpty)
+                Accumulate(in changed, from, to);
+        }
+
+        var context = new DeltaEncodeContext<TState>(this, fields, (TState*)from, (TState*)to, changed);
+        Encode(ref context);
+    }
+
+    internal bool HasChanged(in DeltaChangeMask changed, int slot, byte* from, byte* to)
+    {
+        ref readonly var field = ref _fields[slot];
+        if (field.Size < 4)
+            return !new ReadOnlySpan<byte>(from + field.Offset, field.Size).SequenceEqual(new ReadOnlySpan<byte>(to + field.Offset, field.Size));
+
+        int first = field.Offset >> 2;
+        int last = (field.Offset + field.Size - 1) >> 2;
+        for (int w = first; w <= last; w++)
+        {
+            if (changed.IsWordChanged(w))
+                return true;
+        }
+        return false;
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    internal void Toggle(delta_s* fields, int slot, bool send)
+    {
+        int index = _fields[slot].EngineIndex;
+        if (index < 0)
+            return;
+
+        if (send)
+            Engine->DeltaSetFieldByIndex(fields, index);
+        else
+            Engine->DeltaUnsetFieldByIndex(fields, index);
+    }
+
+    public override DeltaFieldStatistics[] GetStatistics()
+    {
+        var result = new DeltaFieldStatistics[s_layout.Fields.Length];
+        for (int i = 0; i < result.Length; i++)
+        {
+            var f = s_layout.Fields[i];
+            long changes = _fieldChanges[i];
+            result[i] = new DeltaFieldStatistics(f.Name, f.Offset, f.Size, changes, _sampledCalls > 0 ? (double)changes / _sampledCalls : 0);
+        }
+        return result;
+    }
+
+    public override void ResetStatistics()
+    {
+        Array.Clear(_fieldChanges);
+        _sampledCalls = 0;
+    }
+
+    private void Resolve(delta_s* fields)
+    {
+        _resolvedFor = fields;
+        for (int i = 0; i < _fieldCount; i++)
+        {
+            ref var field = ref _fields[i];
+            field.EngineIndex = Engine != null && Engine->DeltaFindField != null
+                ? Engine->DeltaFindField(fields, Utf8StringPool.Shared.Intern(field.Name))
+                : -1;
+
+            if (field.EngineIndex < 0)
+                Debug.WriteLine($"[DeltaEncoder] {Name}: field '{field.Name}' is not in the delta description");
+        }
+    }
+
+    // Walks only the changed words; words of one field are contiguous, so each field is counted once.
+    private void Accumulate(in DeltaChangeMask changed, byte* from, byte* to)
+    {
+        var wordField = s_layout.WordField;
+        int last = -1;
+        for (int lane = 0; lane < DeltaChangeMask.MaxWords / 64; lane++)
+        {
+            ulong bits = changed[lane];
+            while (bits != 0)
+            {
+                int word = lane * 64 + System.Numerics.BitOperations.TrailingZeroCount(bits);
+                bits &= bits - 1;
+
+                int f = wordField[word];
+                if (f >= 0)
+                {
+                    if (f != last)
+                    {
+                        _fieldChanges[f]++;
+                        last = f;
+                    }
+                    continue;
+                }
+
+                // Word holding small fields (e.g. skin / solid) or padding: compare each field.
+                foreach (int shared in s_layout.SharedWordFields[word]!)
+                {
+                    var info = s_layout.Fields[shared];
+                    if (shared != last && !new ReadOnlySpan<byte>(from + info.Offset, info.Size).SequenceEqual(new ReadOnlySpan<byte>(to + info.Offset, info.Size)))
+                    {
+                        _fieldChanges[shared]++;
+                        last = shared;
+                    }
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Field offsets of <typeparamref name="TState"/> and the word → field map, built once per type.
+    /// </summary>
+    private sealed class StructLayoutInfo
+    {
+        public readonly (string Name, int Offset, int Size, int ElementSize)[] Fields;
+        public readonly int[] WordField;
+        public readonly int[]?[] SharedWordFields;
+
+        public StructLayoutInfo(Type type, int size)
+        {
+            var fields = type.GetFields(BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic)
+                .Select(f => (Field: f, Offset: (int)Marshal.OffsetOf(type, f.Name)))
+                .OrderBy(f => f.Offset)
+                .ToArray();
+
+            Fields = new (string, int, int, int)[fields.Length];
+            for (int i = 0; i < fields.Length; i++)
+            {
+                int end = i + 1 < fields.Length ? fields[i + 1].Offset : size;
+                int fieldSize = end - fields[i].Offset;
+                var fieldType = fields[i].Field.FieldType;
+
+                // Trim trailing padding (e.g. a byte or color24 followed by an int).
+                if (!fieldType.IsGenericType)
+                    fieldSize = Math.Min(fieldSize, Marshal.SizeOf(fieldType));
+
+                Fields[i] = (fields[i].Field.Name, fields[i].Offset, fieldSize, ElementSize(fieldType, fieldSize));
+            }
+
+            int words = (size + 3) / 4;
+            WordField = new int[words];
+            SharedWordFields = new int[]?[words];
+            Array.Fill(WordField, -2);
+            for (int i = 0; i < Fields.Length; i++)
+            {
+                var f = Fields[i];
+                for (int w = f.Offset >> 2; w <= (f.Offset + f.Size - 1) >> 2; w++)
+                {
+                    if (WordField[w] == -2)
+                    {
+                        WordField[w] = i;
+                    }
+                    else
+                    {
+                        var shared = SharedWordFields[w] ?? new[] { WordField[w] };
+                        SharedWordFields[w] = [.. shared, i];
+                        WordField[w] = -1;
+                    }
+                }
+            }
+
+            // A field that does not fill its word is compared byte-wise, so padding changes are not counted.
+            for (int w = 0; w < words; w++)
+            {
+                if (WordField[w] >= 0 && Fields[WordField[w]].Size < 4)
+                {
+                    SharedWordFields[w] = new[] { WordField[w] };
+                    WordField[w] = -1;
+                }
+                else if (WordField[w] == -2)
+                {
+                    SharedWordFields[w] = Array.Empty<int>();
+                    WordField[w] = -1;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Offset and size of a delta.lst field name; "name[i]" addresses one element of an array or vector field.
+        /// </summary>
+        public (int Offset, int Size) Resolve(string name)
+        {
+            int index = 0;
+            string baseName = name;
+            int bracket = name.IndexOf('[');
+            if (bracket > 0 && name.EndsWith(']'))
+            {
+                baseName = name[..bracket];
+                index = int.Parse(name.AsSpan(bracket + 1, name.Length - bracket - 2));
+            }
+
+            foreach (var f in Fields)
+            {
+                if (f.Name != baseName)
+                    continue;
+
+                if (bracket < 0)
+                    return (f.Offset, f.Size);
+
+                if (index < 0 || (index + 1) * f.ElementSize > f.Size)
+                    break;
+                return (f.Offset + index * f.ElementSize, f.ElementSize);
+            }
+
+            throw new ArgumentException($"{typeof(TState).Name} has no field '{name}'.", nameof(name));
+        }
+
+        private static int ElementSize(Type type, int size)
+        {
+            if (type == typeof(Vector3))
+                return 4;
+
+            var inlineArray = type.GetCustomAttribute<InlineArrayAttribute>();
+            if (inlineArray != null)
+                return size / inlineArray.Length;
+
+            return size;
+        }
+    }
+}
+
+/// <summary>
+/// What an encoder sees for one entity: both states, the changed-word mask, and cached field toggles.
+/// </summary>
+public readonly unsafe ref struct DeltaEncodeContext<TState> where TState : unmanaged
+{
+    private readonly DeltaEncoder<TState> _encoder;
+    private readonly DeltaChangeMask _changed;
+
+    internal DeltaEncodeContext(DeltaEncoder<TState> encoder, delta_s* fields, TState* from, TState* to, in DeltaChangeMask changed)
+    {
+        _encoder = encoder;
+        Fields = fields;
+        From = from;
+        To = to;
+        _changed = changed;
+    }
+
+    public delta_s* Fields { get; }
+
+    public TState* From { get; }
+
+    public TState* To { get; }
+
+    public DeltaChangeMask Changed => _changed;
+
+    /// <summary>
+    /// Whether any byte of <paramref name="field"/> differs between From and To.
+    /// </summary>
+    public bool HasChanged(DeltaField field) => _encoder.HasChanged(in _changed, field.Slot, (byte*)From, (byte*)To);
+
+    /// <summary>
+    /// Force the field to be sent (DeltaSetFieldByIndex).
+    /// </summary>
+    public void Set(DeltaField field) => _encoder.Toggle(Fields, field.Slot, true);
+
+    /// <summary>
+    /// Suppress the field (DeltaUnsetFieldByIndex).
+    /// </summary>
+    public void Unset(DeltaField field) => _encoder.Toggle(Fields, field.Slot, false);
+}
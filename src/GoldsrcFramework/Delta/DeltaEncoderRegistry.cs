@@ -0,0 +1,140 @@
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Text;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Strings;
+
+namespace GoldsrcFramework.Delta;
+
+/// <summary>
+/// Hands managed <see cref="DeltaEncoder"/>s to the engine through DeltaAddEncoder.
+///
+/// The engine callback carries no user data, so each encoder gets one of <see cref="MaxEncoders"/> static
+/// [UnmanagedCallersOnly] trampolines. Encoders added before RegisterEncoders are registered when the engine asks;
+/// encoders registered after the legacy DLL's take precedence for the same name.
+/// </summary>
+public static unsafe class DeltaEncoderRegistry
+{
+    public const int MaxEncoders = 8;
+
+    private static readonly DeltaEncoder?[] s_slots = new DeltaEncoder?[MaxEncoders];
+    private static int s_count;
+    private static ServerEngineFuncs* s_engine;
+
+    public static IEnumerable<DeltaEncoder> Encoders => s_slots.Take(s_count)!;
+
+    /// <summary>
+    /// Add an encoder. Registered with the engine right away if RegisterEncoders already ran, otherwise when it does.
+    /// </summary>
+    public static void Add(DeltaEncoder encoder)
+    {
+        if (encoder.Slot >= 0)
+            return;
+        if (s_count == MaxEncoders)
+            throw new InvalidOperationException($"At most {MaxEncoders} managed delta encoders are supported.");
+
+        encoder.Slot = s_count;
+        s_slots[s_count++] = encoder;
+
+        if (s_engine != null)
+            RegisterWithEngine(s_engine, encoder);
+    }
+
+    /// <summary>
+    /// Register every added encoder with <paramref name="engine"/>. Called from RegisterEncoders.
+    /// </summary>
+    public static void RegisterAll(ServerEngineFuncs* engine)
+    {
+        s_engine = engine;
+        for (int i = 0; i < s_count; i++)
+            RegisterWithEngine(engine, s_slots[i]!);
+    }
+
+    /// <summary>
+    /// Per-field change rates of every encoder, most frequently changed first, one line each.
+    /// </summary>
+    public static string Summary(int top = 16)
+    {
+        var text = new StringBuilder();
+        foreach (var encoder in Encoders)
+        {
+            text.Append($"{encoder.Name}: {encoder.Calls} calls, {encoder.Faults} faults\n");
+            foreach (var f in encoder.GetStatistics().Where(f => f.Changes > 0).OrderByDescending(f => f.Changes).Take(top))
+                text.Append($"  {f.Name,-16} {f.Rate,8:P1} ({f.Changes})\n");
+        }
+        if (text.Length == 0)
+            text.Append("No managed delta encoders registered\n");
+        return text.ToString();
+    }
+
+    /// <summary>
+    /// Print <see cref="Summary"/> to the server console (sv_deltastats).
+    /// </summary>
+    public static void PrintStatistics(int top = 16) => EngineApi.ServerPrint(Summary(top));
+
+    private static void RegisterWithEngine(ServerEngineFuncs* engine, DeltaEncoder encoder)
+    {
+        encoder.Engine = engine;
+        engine->DeltaAddEncoder(Utf8StringPool.Shared.Intern(encoder.Name), GetTrampoline(encoder.Slot));
+    }
+
+    /// <summary>
+    /// Native entry point for a slot; exposed for headless tests that stand in for the engine.
+    /// </summary>
+    public static delegate* unmanaged[Cdecl]<delta_s*, byte*, byte*, void> GetTrampoline(int slot) => slot switch
+    {
+        0 => &Encode0,
+        1 => &Encode1,
+        2 => &Encode2,
+        3 => &Encode3,
+        4 => &Encode4,
+        5 => &Encode5,
+        6 => &Encode6,
+        7 => &Encode7,
+        _ => throw new ArgumentOutOfRangeException(nameof(slot)),
+    };
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static void Dispatch(int slot, delta_s* fields, byte* from, byte* to)
+    {
+        var encoder = s_slots[slot];
+        if (encoder == null)
+            return;
+
+        try
+        {
+            encoder.Invoke(fields, from, to);
+        }
+        catch (Exception ex)
+        {
+            // Never let an exception unwind into the engine.
+            encoder.Faults++;
+            Debug.WriteLine($"[DeltaEncoder] {encoder.Name}: {ex}");
+        }
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void Encode0(delta_s* fields, byte* from, byte* to) => Dispatch(0, fields, from, to);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void Encode1(delta_s* fields, byte* from, byte* to) => Dispatch(1, fields, from, to);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void Encode2(delta_s* fields, byte* from, byte* to) => Dispatch(2, fields, from, to);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void Encode3(delta_s* fields, byte* from, byte* to) => Dispatch(3, fields, from, to);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void Encode4(delta_s* fields, byte* from, byte* to) => Dispatch(4, fields, from, to);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void Encode5(delta_s* fields, byte* from, byte* to) => Dispatch(5, fields, from, to);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void Encode6(delta_s* fields, byte* from, byte* to) => Dispatch(6, fields, from, to);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void Encode7(delta_s* fields, byte* from, byte* to) => Dispatch(7, fields, from, to);
+}
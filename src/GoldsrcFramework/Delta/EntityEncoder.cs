@@ -0,0 +1,72 @@
+using GoldsrcFramework.Engine.Native;
+
+namespace GoldsrcFramework.Delta;
+
+/// <summary>
+/// Managed port of the HLSDK Entity_Encode conditional encoder (dlls/client.cpp).
+///
+/// - never send the origin of the local player (clientdata_t carries it at higher precision);
+/// - beams with impacttime / starttime set keep origin and angles unchanged;
+/// - MOVETYPE_FOLLOW entities with an aiment derive their origin client side;
+///   a changed aiment forces the origin to be resent.
+/// </summary>
+public sealed unsafe class EntityEncoder : DeltaEncoder<entity_state_t>
+{
+    private const int MOVETYPE_FOLLOW = 12;
+
+    private readonly DeltaField _origin0, _origin1, _origin2;
+    private readonly DeltaField _angles0, _angles1, _angles2;
+
+    public EntityEncoder() : base("Entity_Encode")
+    {
+        _origin0 = Field("origin[0]");
+        _origin1 = Field("origin[1]");
+        _origin2 = Field("origin[2]");
+        _angles0 = Field("angles[0]");
+        _angles1 = Field("angles[1]");
+        _angles2 = Field("angles[2]");
+    }
+
+    protected override void Encode(ref DeltaEncodeContext<entity_state_t> context)
+    {
+        var f = context.From;
+        var t = context.To;
+
+        bool localPlayer = Engine->GetCurrentPlayer != null && t->number - 1 == Engine->GetCurrentPlayer();
+        if (localPlayer)
+            UnsetOrigin(ref context);
+
+        if (t->impacttime != 0 && t->starttime != 0)
+        {
+            UnsetOrigin(ref context);
+            UnsetIfChanged(ref context, _angles0);
+            UnsetIfChanged(ref context, _angles1);
+            UnsetIfChanged(ref context, _angles2);
+        }
+
+        if (t->movetype == MOVETYPE_FOLLOW && t->aiment != 0)
+        {
+            UnsetOrigin(ref context);
+        }
+        else if (t->aiment != f->aiment)
+        {
+            context.Set(_origin0);
+            context.Set(_origin1);
+            context.Set(_origin2);
+        }
+    }
+
+    private void UnsetOrigin(ref DeltaEncodeContext<entity_state_t> context)
+    {
+        UnsetIfChanged(ref context, _origin0);
+        UnsetIfChanged(ref context, _origin1);
+        UnsetIfChanged(ref context, _origin2);
+    }
+
+    // Only changed fields were marked by the engine, so the others need no call.
+    private static void UnsetIfChanged(ref DeltaEncodeContext<entity_state_t> context, DeltaField field)
+    {
+        if (context.HasChanged(field))
+            context.Unset(field);
+    }
+}
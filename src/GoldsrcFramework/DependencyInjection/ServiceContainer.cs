@@ -1,5 +1,7 @@
 using GoldsrcFramework.Configuration;
 using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Generated;
+using GoldsrcFramework.Logging;
 using Microsoft.Extensions.Configuration;
 using Microsoft.Extensions.DependencyInjection;
 using Microsoft.Extensions.Logging;
@@ -20,6 +22,7 @@ namespace GoldsrcFramework.DependencyInjection
         private static bool _initialized = false;
         private static IGoldsrcModStartup? _modStartup;
         private static bool _assemblyResolverRegistered = false;
+        private static StartupMode _activeMode;
 
         /// <summary>
         /// Get the service provider
@@ -56,10 +59,17 @@ namespace GoldsrcFramework.DependencyInjection
         /// </summary>
         public static bool IsInitialized => _initialized;
 
+        /// <summary>
+        /// How the last Initialize found the mod: <see cref="StartupMode.Generated"/> or <see cref="StartupMode.Reflection"/>
+        /// </summary>
+        public static StartupMode ActiveMode => _activeMode;
+
         /// <summary>
         /// Initialize the service container
         /// </summary>
-        public static void Initialize(string? configurationPath = null)
+        /// <param name="configurationPath">Extra JSON configuration on top of modSettings.json</param>
+        /// <param name="mode">Use the source-generated registration and settings binders, reflection, or whichever the mod supports</param>
+        public static void Initialize(string? configurationPath = null, StartupMode mode = StartupMode.Auto)
         {
             if (_initialized) return;
 
@@ -70,8 +80,11 @@ namespace GoldsrcFramework.DependencyInjection
                 try
                 {
                     // Build configuration
-                    var frameworkDir = Path.GetDirectoryName(typeof(ServiceContainer).Assembly.Location);
-                    RegisterAssemblyResolver(frameworkDir);
+                    var frameworkDir = GetFrameworkDirectory();
+                    if (mode == StartupMode.Reflection)
+                    {
+                        RegisterAssemblyResolver(frameworkDir);
+                    }
 
                     var configBuilder = new ConfigurationBuilder()
                         .SetBasePath(frameworkDir ?? Directory.GetCurrentDirectory());
@@ -111,18 +124,58 @@ namespace GoldsrcFramework.DependencyInjection
                     services.AddSingleton(_configuration);
 
                     // Register options
-                    services.Configure<FrameworkSettings>(_configuration.GetSection("Framework"));
-                    services.Configure<LoggingSettings>(_configuration.GetSection("Logging"));
-                    services.Configure<GameSettings>(_configuration.GetSection("Game"));
+                    var frameworkSettings = new FrameworkSettings();
+                    var loggingSettings = new LoggingSettings();
+                    if (mode == StartupMode.Reflection)
+                    {
+                        services.Configure<FrameworkSettings>(_configuration.GetSection("Framework"));
+                        services.Configure<LoggingSettings>(_configuration.GetSection("Logging"));
+                        services.Configure<GameSettings>(_configuration.GetSection("Game"));
+                        loggingSettings = _configuration.GetSection("Logging").Get<LoggingSettings>() ?? loggingSettings;
+                    }
+                    else
+                    {
+                        // Binders generated from the [GoldsrcSettings] classes, no ConfigurationBinder
+                        GoldsrcSettingsBinder.AddGoldsrcSettings(services, _configuration);
+                        GoldsrcSettingsBinder.Bind(_configuration.GetSection("Framework"), frameworkSettings);
+                        GoldsrcSettingsBinder.Bind(_configuration.GetSection("Logging"), loggingSettings);
+                    }
 
                     // Register logging
-                    ConfigureLogging(services, _configuration);
+                    ConfigureLogging(services, _configuration, loggingSettings);
 
-                    // Register core services
-                    ConfigureCoreServices(services, _configuration);
+                    // Find the mod's generated registration; mods built without the generator fall back to scanning
+                    IGoldsrcModRegistration? serverRegistration = null, clientRegistration = null;
+                    bool reflection = mode == StartupMode.Reflection;
+                    if (!reflection)
+                    {
+                        bool found = TryGetRegistration(frameworkSettings.GameServerAssembly, frameworkDir, out serverRegistration);
+                        found &= TryGetRegistration(frameworkSettings.GameClientAssembly, frameworkDir, out clientRegistration);
+                        reflection = !found && mode == StartupMode.Auto;
+                    }
+                    _activeMode = reflection ? StartupMode.Reflection : StartupMode.Generated;
+
+                    if (reflection)
+                    {
+                        RegisterAssemblyResolver(frameworkDir);
+
+                        // Register core services
+                        ConfigureCoreServices(services, _configuration);
+
+                        // Discover and invoke mod startup class
+                        _modStartup = DiscoverModStartup(_configuration);
+                    }
+                    else
+                    {
+                        ConfigureGeneratedServices(services, serverRegistration, clientRegistration);
+                        _modStartup = CreateModStartup(clientRegistration ?? serverRegistration);
+                        serverRegistration?.ConfigureSettings(services, _configuration);
+                        if (clientRegistration != null && clientRegistration != serverRegistration)
+                        {
+                            clientRegistration.ConfigureSettings(services, _configuration);
+                        }
+                    }
 
-                    // Discover and invoke mod startup class
-                    _modStartup = DiscoverModStartup(_configuration);
                     if (_modStartup != null)
                     {
                         // Initialize the startup instance with configuration
@@ -158,6 +211,13 @@ namespace GoldsrcFramework.DependencyInjection
             }
         }
 
+        private static string? GetFrameworkDirectory()
+        {
+            // Location is empty when the framework is compiled into a native image
+            var location = typeof(ServiceContainer).Assembly.Location;
+            return string.IsNullOrEmpty(location) ? AppContext.BaseDirectory : Path.GetDirectoryName(location);
+        }
+
         private static void RegisterAssemblyResolver(string? frameworkDir)
         {
             if (_assemblyResolverRegistered || string.IsNullOrEmpty(frameworkDir))
@@ -191,14 +251,14 @@ namespace GoldsrcFramework.DependencyInjection
         /// <summary>
         /// Configure logging services
         /// </summary>
-        private static void ConfigureLogging(IServiceCollection services, IConfiguration configuration)
+        private static void ConfigureLogging(IServiceCollection services, IConfiguration configuration, LoggingSettings settings)
         {
             services.AddLogging(builder =>
             {
                 // Get logging settings
                 var loggingSection = configuration.GetSection("Logging");
-                var minLevel = loggingSection.GetValue<string>("MinimumLevel") ?? "Information";
-                var enableConsole = loggingSection.GetValue<bool>("EnableConsole", true);
+                var minLevel = settings.MinimumLevel ?? "Information";
+                var enableConsole = settings.EnableConsole;
 
                 // Parse log level
                 if (Enum.TryParse<LogLevel>(minLevel, out var logLevel))
@@ -206,9 +266,28 @@ namespace GoldsrcFramework.DependencyInjection
                     builder.SetMinimumLevel(logLevel);
                 }
 
-                // Add console logger if enabled
-                if (enableConsole)
+                if (settings.Async)
                 {
+                    // Formatting and console / file writes happen on the log thread, never in engine callbacks
+                    var sinks = new List<ILogSink>();
+                    if (enableConsole)
+                    {
+                        sinks.Add(new ConsoleLogSink());
+                        if (System.Diagnostics.Debugger.IsAttached)
+                            sinks.Add(new DebugLogSink());
+                    }
+                    if (settings.EnableFile && !string.IsNullOrEmpty(settings.LogFilePath))
+                    {
+                        sinks.Add(new RotatingFileLogSink(settings.LogFilePath, settings.FileMaxKilobytes * 1024L, settings.FileCount));
+                    }
+
+                    AsyncLog.Start(Enum.TryParse<LogLevel>(minLevel, out var asyncLevel) ? asyncLevel : LogLevel.Information,
+                        sinks, settings.RingCapacity);
+                    builder.AddProvider(new AsyncLoggerProvider());
+                }
+                else if (enableConsole)
+                {
+                    // Add console logger if enabled
                     builder.AddConsole();
                     builder.AddDebug();
                 }
@@ -269,6 +348,111 @@ namespace GoldsrcFramework.DependencyInjection
             return null;
         }
 
+        /// <summary>
+        /// Load a configured game assembly and get its generated registration. True with a null registration only if
+        /// none is configured; false if it is missing, fails to load or was built without the SDK's generator.
+        /// </summary>
+        private static bool TryGetRegistration(string? assemblyName, string? frameworkDir, out IGoldsrcModRegistration? registration)
+        {
+            registration = null;
+            if (string.IsNullOrEmpty(assemblyName))
+            {
+                // Nothing to load: a mod compiled into the same image has registered itself already
+                var registrations = GoldsrcModRegistry.Registrations;
+                registration = registrations.Count == 1 ? registrations[0] : null;
+                return true;
+            }
+
+            var assemblyPath = Path.Combine(frameworkDir ?? "", assemblyName);
+            if (!File.Exists(assemblyPath))
+            {
+                System.Diagnostics.Debug.WriteLine($"Configured game assembly not found: {assemblyPath}");
+                return false;
+            }
+
+            try
+            {
+                // The mod's own dependencies are next to it, not in the framework's deps.json
+                RegisterAssemblyResolver(frameworkDir);
+                var assembly = AssemblyLoadContext.GetLoadContext(typeof(ServiceContainer).Assembly)!
+                    .LoadFromAssemblyPath(assemblyPath);
+                registration = GoldsrcModRegistry.For(assembly);
+                return registration != null;
+            }
+            catch (Exception ex)
+            {
+                System.Diagnostics.Debug.WriteLine($"Failed to load game assembly {assemblyName}: {ex.Message}");
+                return false;
+            }
+        }
+
+        private static IGoldsrcModStartup? CreateModStartup(IGoldsrcModRegistration? registration)
+        {
+            try
+            {
+                var startup = registration?.CreateStartup();
+                if (startup != null)
+                {
+                    System.Diagnostics.Debug.WriteLine($"Discovered mod startup: {startup.GetType().FullName}");
+                }
+                return startup;
+            }
+            catch (Exception ex)
+            {
+                System.Diagnostics.Debug.WriteLine($"Failed to create mod startup: {ex.Message}");
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Register the exports created by the mod's generated registration, or the framework's
+        /// </summary>
+        private static void ConfigureGeneratedServices(IServiceCollection services, IGoldsrcModRegistration? serverRegistration,
+                                                       IGoldsrcModRegistration? clientRegistration)
+        {
+            services.AddSingleton<IServerExportFuncs>(sp =>
+            {
+                var logger = sp.GetRequiredService<ILogger<object>>();
+                try
+                {
+                    var server = serverRegistration?.CreateServerExports();
+                    if (server != null)
+                    {
+                        logger.LogInformation("Loading custom server implementation: {ServerType}", server.GetType().FullName);
+                        return server;
+                    }
+                }
+                catch (Exception ex)
+                {
+                    logger.LogError(ex, "Failed to create custom server implementation");
+                }
+
+                logger.LogInformation("Using default server implementation: FrameworkServerExports");
+                return new FrameworkServerExports();
+            });
+
+            services.AddSingleton<IClientExportFuncs>(sp =>
+            {
+                var logger = sp.GetRequiredService<ILogger<object>>();
+                try
+                {
+                    var client = clientRegistration?.CreateClientExports();
+                    if (client != null)
+                    {
+                        logger.LogInformation("Loading custom client implementation: {ClientType}", client.GetType().FullName);
+                        return client;
+                    }
+                }
+                catch (Exception ex)
+                {
+                    logger.LogError(ex, "Failed to create custom client implementation");
+                }
+
+                logger.LogInformation("Using default client implementation: FrameworkClientExports");
+                return new FrameworkClientExports();
+            });
+        }
+
         /// <summary>
         /// Configure core framework services
         /// </summary>
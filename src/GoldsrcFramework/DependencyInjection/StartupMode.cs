@@ -0,0 +1,23 @@
+namespace GoldsrcFramework.DependencyInjection
+{
+    /// <summary>
+    /// How <see cref="ServiceContainer"/> finds the mod's startup class, exports and settings
+    /// </summary>
+    public enum StartupMode
+    {
+        /// <summary>
+        /// Generated code, falling back to reflection for mods built without the SDK's generator
+        /// </summary>
+        Auto,
+
+        /// <summary>
+        /// Generated registration and settings binders only; mods without them get the framework's exports
+        /// </summary>
+        Generated,
+
+        /// <summary>
+        /// Assembly scanning, Activator.CreateInstance and ConfigurationBinder
+        /// </summary>
+        Reflection,
+    }
+}
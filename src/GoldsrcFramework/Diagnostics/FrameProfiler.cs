@@ -0,0 +1,438 @@
+using System.Diagnostics;
+using System.Globalization;
+using System.Runtime.CompilerServices;
+using GoldsrcFramework.Configuration;
+using GoldsrcFramework.Logging;
+using GoldsrcFramework.Replay;
+using Microsoft.Extensions.Logging;
+
+namespace GoldsrcFramework.Diagnostics;
+
+/// <summary>
+/// What most likely made a frame go over budget.
+/// </summary>
+public enum FrameHitchCause : byte
+{
+    None,
+    /// <summary>Garbage collection pauses cover at least half of the overrun.</summary>
+    GarbageCollection,
+    /// <summary>First-time JIT compilation on the game thread covers at least half of the overrun.</summary>
+    Jit,
+    /// <summary>Mod code: the watchdog caught an export running at the budget, or exports took most of the frame.</summary>
+    ModCode,
+    /// <summary>Time spent outside the mod's exports.</summary>
+    Engine,
+}
+
+/// <summary>
+/// One frame in the <see cref="FrameProfiler"/> ring, measured from one anchor call to the next.
+/// </summary>
+public struct FrameSample
+{
+    public long Frame;
+    /// <summary>Game time passed to the anchor call.</summary>
+    public double Time;
+    public float WallMilliseconds;
+    /// <summary>Time spent inside the mod's exports.</summary>
+    public float ModMilliseconds;
+    public int Gen0Collections;
+    public int Gen1Collections;
+    public int Gen2Collections;
+    public float GcPauseMilliseconds;
+    public long AllocatedBytes;
+    public int JitMethods;
+    public float JitMilliseconds;
+    /// <summary>The export that was running when the frame went over budget; <see cref="TraceCall.None"/> if the engine was.</summary>
+    public TraceCall Thunk;
+    public FrameHitchCause Cause;
+    public bool Hitch;
+}
+
+public readonly record struct FrameProfilerStats(
+    long Frames,
+    long Hitches,
+    long GcHitches,
+    long JitHitches,
+    long ModHitches,
+    long EngineHitches,
+    long WorstFrame,
+    float WorstMilliseconds,
+    long DroppedRows);
+
+/// <summary>
+/// Frame-hitch detector for one game thread (the server's StartFrame or the client's HUD_Frame).
+///
+/// <see cref="BeginFrame"/> closes the previous frame: wall time since the last call, GC collections per generation,
+/// GC pause time, bytes allocated on the thread and methods JIT-compiled on the thread all go into a preallocated ring.
+/// The exports are wrapped (<see cref="ProfilingServerExports"/> / <see cref="ProfilingClientExports"/>) so the
+/// profiler knows which export is running; a watchdog thread wakes up at the frame's deadline and notes it, so a
+/// frame stuck in one slow Think is attributed to Think rather than to whatever ran last.
+///
+/// A frame over budget is reported on the log with its most likely cause, and it and the frames before it are
+/// appended to a CSV file by the watchdog thread. Nothing on the game thread allocates or touches the disk.
+/// </summary>
+public sealed class FrameProfiler : IDisposable
+{
+    public const int DefaultCapacity = 1024;
+    public const int DefaultContextFrames = 8;
+
+    private const int PendingHitches = 16;
+
+    private static readonly LogTemplate s_hitch = AsyncLog.Define(LogLevel.Warning, nameof(FrameProfiler),
+        "{Profiler} frame {Frame}: {Milliseconds:F1} ms, {Cause}");
+    private static readonly LogTemplate s_hitchGc = AsyncLog.Define(LogLevel.Warning, nameof(FrameProfiler),
+        "  gc {Gen0}/{Gen1}/{Gen2} collections, {Pause:F1} ms paused");
+    private static readonly LogTemplate s_hitchCode = AsyncLog.Define(LogLevel.Warning, nameof(FrameProfiler),
+        "  {Thunk} at the deadline, {Mod:F1} ms in exports, {JitMethods} methods JIT-compiled in {Jit:F1} ms");
+    private static readonly LogTemplate s_summary = AsyncLog.Define(LogLevel.Information, nameof(FrameProfiler), "{Summary}");
+
+    private readonly string _name;
+    private readonly long _budgetTicks;
+    private readonly float _budgetMilliseconds;
+    private readonly FrameSample[] _ring;
+    private readonly int _contextFrames;
+    private readonly string? _csvPath;
+
+    // Counters at the start of the current frame.
+    private long _frame;
+    private long _frameStart;
+    private double _frameTime;
+    private long _modTicks;
+    private long _callStart;
+    private int _gen0, _gen1, _gen2;
+    private long _pauseTicks;
+    private long _allocated;
+    private long _jitMethods;
+    private long _jitTicks;
+
+    // Export running now, as a TraceCall, and (frame << 16 | thunk) once the watchdog has seen the frame overrun.
+    private volatile int _current;
+    private long _overrun = -1;
+
+    private long _lastDumped;
+    private long _hitches, _gcHitches, _jitHitches, _modHitches, _engineHitches, _dropped;
+    private long _worstFrame;
+    private float _worstMilliseconds;
+
+    // Rows waiting for the CSV writer.
+    private readonly object _pendingLock = new();
+    private readonly FrameSample[] _pending;
+    private int _pendingCount;
+    private readonly object _writeLock = new();
+    private readonly FrameSample[] _writing;
+
+    private readonly Thread? _watchdog;
+    private volatile bool _stopping;
+    private StreamWriter? _csv;
+
+    /// <param name="name">Shown in the log and the CSV, e.g. "server".</param>
+    /// <param name="budgetMilliseconds">Frames longer than this are hitches.</param>
+    /// <param name="csvPath">Where hitches are appended; null for log output only.</param>
+    /// <param name="watchdog">Start the thread that attributes overruns and writes the CSV. Without it, call
+    /// <see cref="Flush"/> to write.</param>
+    public FrameProfiler(string name, double budgetMilliseconds, string? csvPath = null,
+                         int capacity = DefaultCapacity, int contextFrames = DefaultContextFrames, bool watchdog = true)
+    {
+        _name = name;
+        _budgetMilliseconds = (float)budgetMilliseconds;
+        _budgetTicks = Math.Max(1, (long)(budgetMilliseconds * Stopwatch.Frequency / 1000));
+        _ring = new FrameSample[Math.Max(capacity, contextFrames + 1)];
+        _contextFrames = Math.Max(contextFrames, 0);
+        _pending = new FrameSample[PendingHitches * (_contextFrames + 1)];
+        _writing = new FrameSample[_pending.Length];
+        _csvPath = string.IsNullOrEmpty(csvPath) ? null : csvPath;
+
+        if (watchdog)
+        {
+            _watchdog = new Thread(WatchdogLoop)
+            {
+                Name = $"Frame watchdog ({name})",
+                IsBackground = true,
+                Priority = ThreadPriority.AboveNormal,
+            };
+            _watchdog.Start();
+        }
+    }
+
+    /// <summary>
+    /// Create a profiler if <see cref="FrameworkSettings.FrameBudgetMilliseconds"/> is set. The CSV path gets the
+    /// profiler name inserted before its extension so the server and the client do not share a file.
+    /// </summary>
+    public static FrameProfiler? CreateIfConfigured(string name, FrameworkSettings? settings)
+    {
+        if (settings == null || settings.FrameBudgetMilliseconds <= 0)
+            return null;
+
+        string? csvPath = null;
+        if (!string.IsNullOrWhiteSpace(settings.FrameHitchCsvPath))
+        {
+            var path = settings.FrameHitchCsvPath;
+            csvPath = Path.Combine(Path.GetDirectoryName(path) ?? "",
+                                   $"{Path.GetFileNameWithoutExtension(path)}.{name}{Path.GetExtension(path)}");
+        }
+        Debug.WriteLine($"[FrameProfiler] {name}: budget {settings.FrameBudgetMilliseconds} ms, hitches to {csvPath ?? "the log"}");
+        return new FrameProfiler(name, settings.FrameBudgetMilliseconds, csvPath, contextFrames: settings.FrameHitchContextFrames);
+    }
+
+    public string Name => _name;
+
+    public double BudgetMilliseconds => _budgetMilliseconds;
+
+    public long Frames => _frame;
+
+    public FrameProfilerStats Stats => new(_frame, _hitches, _gcHitches, _jitHitches, _modHitches, _engineHitches,
+                                           _worstFrame, _worstMilliseconds, Interlocked.Read(ref _dropped));
+
+    /// <summary>
+    /// Mark entry into an export. Pass the result to <see cref="Exit"/>.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public TraceCall Enter(TraceCall call)
+    {
+        var previous = (TraceCall)_current;
+        if (previous == TraceCall.None)
+            _callStart = Stopwatch.GetTimestamp();
+        _current = (int)call;
+        return previous;
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public void Exit(TraceCall previous)
+    {
+        _current = (int)previous;
+        if (previous == TraceCall.None)
+            _modTicks += Stopwatch.GetTimestamp() - _callStart;
+    }
+
+    /// <summary>
+    /// Close the previous frame and start a new one. Call first thing in the anchor export.
+    /// </summary>
+    public void BeginFrame(double time)
+    {
+        long now = Stopwatch.GetTimestamp();
+
+        // One read of each counter per frame: the end of this frame is the start of the next.
+        int gen0 = GC.CollectionCount(0);
+        int gen1 = GC.CollectionCount(1);
+        int gen2 = GC.CollectionCount(2);
+        long pause = GC.GetTotalPauseDuration().Ticks;
+        long allocated = GC.GetAllocatedBytesForCurrentThread();
+        long jitMethods = System.Runtime.JitInfo.GetCompiledMethodCount(currentThread: true);
+        long jitTicks = System.Runtime.JitInfo.GetCompilationTime(currentThread: true).Ticks;
+
+        // Calls already on the stack (BeginFrame runs inside the anchor export) count towards the new frame.
+        if (_current != (int)TraceCall.None)
+        {
+            _modTicks += now - _callStart;
+            _callStart = now;
+        }
+
+        if (_frameStart != 0)
+        {
+            ref var sample = ref _ring[_frame % _ring.Length];
+            sample.Frame = _frame;
+            sample.Time = _frameTime;
+            sample.WallMilliseconds = ToMilliseconds(now - _frameStart);
+            sample.ModMilliseconds = ToMilliseconds(_modTicks);
+            sample.Gen0Collections = gen0 - _gen0;
+            sample.Gen1Collections = gen1 - _gen1;
+            sample.Gen2Collections = gen2 - _gen2;
+            sample.GcPauseMilliseconds = (float)TimeSpan.FromTicks(pause - _pauseTicks).TotalMilliseconds;
+            sample.AllocatedBytes = allocated - _allocated;
+            sample.JitMethods = (int)(jitMethods - _jitMethods);
+            sample.JitMilliseconds = (float)TimeSpan.FromTicks(jitTicks - _jitTicks).TotalMilliseconds;
+            sample.Thunk = TraceCall.None;
+            sample.Cause = FrameHitchCause.None;
+            sample.Hitch = now - _frameStart > _budgetTicks;
+            if (sample.Hitch)
+                OnHitch(ref sample);
+        }
+
+        _gen0 = gen0;
+        _gen1 = gen1;
+        _gen2 = gen2;
+        _pauseTicks = pause;
+        _allocated = allocated;
+        _jitMethods = jitMethods;
+        _jitTicks = jitTicks;
+        _modTicks = 0;
+        _frameTime = time;
+
+        // The watchdog reads the frame number, then the start; publish in the other order.
+        Volatile.Write(ref _frame, _frame + 1);
+        Volatile.Write(ref _frameStart, now);
+    }
+
+    private void OnHitch(ref FrameSample sample)
+    {
+        long overrun = Volatile.Read(ref _overrun);
+        if (overrun >> 16 == sample.Frame)
+            sample.Thunk = (TraceCall)(ushort)overrun;
+
+        float over = sample.WallMilliseconds - _budgetMilliseconds;
+        sample.Cause = sample.GcPauseMilliseconds >= over / 2 ? FrameHitchCause.GarbageCollection
+                     : sample.JitMilliseconds >= over / 2 ? FrameHitchCause.Jit
+                     : sample.Thunk != TraceCall.None || sample.ModMilliseconds >= sample.WallMilliseconds / 2 ? FrameHitchCause.ModCode
+                     : FrameHitchCause.Engine;
+
+        _hitches++;
+        switch (sample.Cause)
+        {
+            case FrameHitchCause.GarbageCollection: _gcHitches++; break;
+            case FrameHitchCause.Jit: _jitHitches++; break;
+            case FrameHitchCause.ModCode: _modHitches++; break;
+            default: _engineHitches++; break;
+        }
+        if (sample.WallMilliseconds > _worstMilliseconds)
+        {
+            _worstMilliseconds = sample.WallMilliseconds;
+            _worstFrame = sample.Frame;
+        }
+
+        AsyncLog.Write(s_hitch, _name, sample.Frame, sample.WallMilliseconds, sample.Cause);
+        AsyncLog.Write(s_hitchGc, sample.Gen0Collections, sample.Gen1Collections, sample.Gen2Collections, sample.GcPauseMilliseconds);
+        AsyncLog.Write(s_hitchCode, sample.Thunk, sample.ModMilliseconds, sample.JitMethods, sample.JitMilliseconds);
+
+        if (_csvPath != null)
+            QueueRows(sample.Frame);
+    }
+
+    // Copy the hitch and the frames before it that have not been written yet.
+    private void QueueRows(long hitchFrame)
+    {
+        long first = Math.Max(Math.Max(hitchFrame - _contextFrames, _lastDumped + 1), 1);
+        int rows = (int)(hitchFrame - first + 1);
+        lock (_pendingLock)
+        {
+            if (_pendingCount + rows > _pending.Length)
+            {
+                Interlocked.Add(ref _dropped, rows);
+                return;
+            }
+            for (long f = first; f <= hitchFrame; f++)
+                _pending[_pendingCount++] = _ring[f % _ring.Length];
+        }
+        _lastDumped = hitchFrame;
+    }
+
+    /// <summary>
+    /// Write queued hitches to the CSV file. The watchdog does this on its own; call it when running without one.
+    /// </summary>
+    public void Flush()
+    {
+        if (_csvPath == null)
+            return;
+
+        lock (_writeLock)
+        {
+            int count;
+            lock (_pendingLock)
+            {
+                count = _pendingCount;
+                if (count == 0)
+                    return;
+                Array.Copy(_pending, _writing, count);
+                _pendingCount = 0;
+            }
+            WriteRows(_writing.AsSpan(0, count));
+        }
+    }
+
+    private void WriteRows(ReadOnlySpan<FrameSample> rows)
+    {
+        try
+        {
+            if (_csv == null)
+            {
+                bool exists = File.Exists(_csvPath) && new FileInfo(_csvPath).Length > 0;
+                _csv = new StreamWriter(new FileStream(_csvPath!, FileMode.Append, FileAccess.Write, FileShare.Read));
+                if (!exists)
+                    _csv.WriteLine("profiler,frame,time,hitch,cause,thunk,wall_ms,mod_ms,gen0,gen1,gen2,gc_pause_ms,allocated_bytes,jit_methods,jit_ms");
+            }
+            foreach (ref readonly var s in rows)
+            {
+                _csv.WriteLine(string.Create(CultureInfo.InvariantCulture,
+                    $"{_name},{s.Frame},{s.Time:F3},{(s.Hitch ? 1 : 0)},{(s.Hitch ? s.Cause : FrameHitchCause.None)},{(s.Hitch ? s.Thunk : TraceCall.None)}," +
+                    $"{s.WallMilliseconds:F3},{s.ModMilliseconds:F3},{s.Gen0Collections},{s.Gen1Collections},{s.Gen2Collections}," +
+                    $"{s.GcPauseMilliseconds:F3},{s.AllocatedBytes},{s.JitMethods},{s.JitMilliseconds:F3}"));
+            }
+            _csv.Flush();
+        }
+        catch (IOException ex)
+        {
+            Debug.WriteLine($"[FrameProfiler] Cannot write {_csvPath}: {ex.Message}");
+        }
+    }
+
+    /// <summary>
+    /// Frames, hitches by cause and wall time percentiles over the frames still in the ring.
+    /// </summary>
+    public string Summary()
+    {
+        long last = Volatile.Read(ref _frame) - 1;
+        int count = (int)Math.Min(last, _ring.Length);
+        if (count <= 0)
+            return $"{_name}: no frames yet";
+
+        var walls = new float[count];
+        for (int i = 0; i < count; i++)
+            walls[i] = _ring[(last - i) % _ring.Length].WallMilliseconds;
+        Array.Sort(walls);
+
+        var s = Stats;
+        var dropped = s.DroppedRows > 0 ? $", {s.DroppedRows} CSV rows dropped" : "";
+        return string.Create(CultureInfo.InvariantCulture,
+            $"{_name}: {s.Frames - 1} frames, {s.Hitches} over {_budgetMilliseconds:F1} ms " +
+            $"({s.GcHitches} gc, {s.JitHitches} jit, {s.ModHitches} mod, {s.EngineHitches} engine), worst {s.WorstMilliseconds:F1} ms at frame {s.WorstFrame}; " +
+            $"last {count}: p50 {Percentile(walls, 0.50):F2} ms, p99 {Percentile(walls, 0.99):F2} ms, max {walls[^1]:F2} ms{dropped}");
+    }
+
+    /// <summary>
+    /// Log <see cref="Summary"/> and write what is queued.
+    /// </summary>
+    public void LogSummary()
+    {
+        AsyncLog.Write(s_summary, Summary());
+        Flush();
+    }
+
+    private static float Percentile(float[] sorted, double p) => sorted[Math.Min((int)(sorted.Length * p), sorted.Length - 1)];
+
+    private static float ToMilliseconds(long ticks) => (float)(ticks * 1000.0 / Stopwatch.Frequency);
+
+    private void WatchdogLoop()
+    {
+        while (!_stopping)
+        {
+            long frame = Volatile.Read(ref _frame);
+            long start = Volatile.Read(ref _frameStart);
+            long deadline = start + _budgetTicks;
+            long now = Stopwatch.GetTimestamp();
+
+            if (start != 0 && now >= deadline && Volatile.Read(ref _overrun) >> 16 != frame)
+            {
+                // Best effort: the game thread may have moved on between the reads.
+                var thunk = (ushort)_current;
+                if (Volatile.Read(ref _frame) == frame)
+                    Volatile.Write(ref _overrun, frame << 16 | thunk);
+            }
+
+            Flush();
+
+            int sleep = start == 0 || now >= deadline ? 1 : (int)Math.Clamp((deadline - now) * 1000 / Stopwatch.Frequency, 0, 10);
+            Thread.Sleep(sleep);
+        }
+    }
+
+    public void Dispose()
+    {
+        _stopping = true;
+        _watchdog?.Join();
+        Flush();
+        lock (_writeLock)
+        {
+            _csv?.Dispose();
+            _csv = null;
+        }
+    }
+}
@@ -0,0 +1,125 @@
+using GoldsrcFramework.Commands;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Replay;
+
+namespace GoldsrcFramework.Diagnostics;
+
+/// <summary>
+/// Server exports wrapper that tells a <see cref="FrameProfiler"/> which export is running and starts a frame on
+/// StartFrame. Installed by ServerMain when <c>Framework:FrameBudgetMilliseconds</c> is set. Only the exports that do
+/// more than that are written here; the generator forwards the rest (<see cref="ExportWrapperAttribute"/>).
+/// </summary>
+[ExportWrapper(ExportWrapperKind.Profiling)]
+public sealed unsafe partial class ProfilingServerExports(IServerExportFuncs inner, FrameProfiler profiler) : IServerExportFuncs
+{
+    public IServerExportFuncs Inner => inner;
+
+    public FrameProfiler Profiler => profiler;
+
+    /// <summary>
+    /// sv_framestats: print the frame summary.
+    /// </summary>
+    private void StatsCommand(edict_t* client, CommandArgs args) => EngineApi.ServerPrint(profiler.Summary() + "\n");
+
+    public void GameInit()
+    {
+        var previous = profiler.Enter(TraceCall.GameInit);
+        try
+        {
+            inner.GameInit();
+        }
+        finally
+        {
+            profiler.Exit(previous);
+        }
+        ConsoleCommands.AddServerCommand("sv_framestats", StatsCommand);
+    }
+
+    public void StartFrame()
+    {
+        profiler.BeginFrame(EngineApi.PGlobals != null ? EngineApi.PGlobals->time : 0);
+        var previous = profiler.Enter(TraceCall.StartFrame);
+        try
+        {
+            inner.StartFrame();
+        }
+        finally
+        {
+            profiler.Exit(previous);
+        }
+    }
+
+    public void GameShutdown()
+    {
+        var previous = profiler.Enter(TraceCall.GameShutdown);
+        try
+        {
+            inner.GameShutdown();
+        }
+        finally
+        {
+            profiler.Exit(previous);
+        }
+        profiler.LogSummary();
+    }
+}
+
+/// <summary>
+/// Client exports wrapper that tells a <see cref="FrameProfiler"/> which export is running and starts a frame on
+/// HUD_Frame. Installed by ClientMain when <c>Framework:FrameBudgetMilliseconds</c> is set. As on the server, the
+/// generator forwards the exports not written here.
+/// </summary>
+[ExportWrapper(ExportWrapperKind.Profiling)]
+public sealed unsafe partial class ProfilingClientExports(IClientExportFuncs inner, FrameProfiler profiler) : IClientExportFuncs
+{
+    public IClientExportFuncs Inner => inner;
+
+    public FrameProfiler Profiler => profiler;
+
+    /// <summary>
+    /// cl_framestats: print the frame summary.
+    /// </summary>
+    private void StatsCommand(edict_t* client, CommandArgs args) => EngineApi.ConsolePrint(profiler.Summary() + "\n");
+
+    public void HUD_Init()
+    {
+        var previous = profiler.Enter(TraceCall.HUD_Init);
+        try
+        {
+            inner.HUD_Init();
+        }
+        finally
+        {
+            profiler.Exit(previous);
+        }
+        ConsoleCommands.AddClientCommand("cl_framestats", StatsCommand);
+    }
+
+    public void HUD_Shutdown()
+    {
+        var previous = profiler.Enter(TraceCall.HUD_Shutdown);
+        try
+        {
+            inner.HUD_Shutdown();
+        }
+        finally
+        {
+            profiler.Exit(previous);
+        }
+        profiler.LogSummary();
+    }
+
+    public void HUD_Frame(double time)
+    {
+        profiler.BeginFrame(time);
+        var previous = profiler.Enter(TraceCall.HUD_Frame);
+        try
+        {
+            inner.HUD_Frame(time);
+        }
+        finally
+        {
+            profiler.Exit(previous);
+        }
+    }
+}
@@ -0,0 +1,549 @@
+using System.Runtime.CompilerServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+
+using SimdVector = System.Numerics.Vector<float>;
+
+namespace GoldsrcFramework.Effects;
+
+/// <summary>
+/// Per-frame counters reported by <see cref="TempEntitySimulator"/>.
+/// </summary>
+public struct TempEntityFrameStats
+{
+    /// <summary>Temp entities still alive after expiry.</summary>
+    public int Active;
+    /// <summary>Temp entities whose origin went through the batched integration step.</summary>
+    public int Integrated;
+    /// <summary>Temp entities moved back to the free list this frame.</summary>
+    public int Killed;
+    /// <summary>Temp entities that hit something this frame.</summary>
+    public int Collided;
+    /// <summary>Temp entities accepted by Callback_AddVisibleEntity.</summary>
+    public int Submitted;
+}
+
+/// <summary>
+/// Managed port of the legacy client's HUD_TempEntUpdate.
+/// Owns the engine's active temp entity list for one frame: expires and fades entities,
+/// integrates linear movers in SIMD batches, then runs animation, collision, effects and
+/// Callback_AddVisibleEntity submission in list order.
+/// All working buffers are reused between frames, so a warmed-up simulator does not allocate.
+/// </summary>
+public sealed unsafe class TempEntitySimulator
+{
+    // pm_defs.h trace flags
+    private const int PM_STUDIO_BOX = 0x00000002;
+    private const int PM_WORLD_ONLY = 0x00000008;
+
+    private const int InitialCapacity = 1024;
+
+    private const TempEntityFlags GravityFlags = TempEntityFlags.FTENT_GRAVITY | TempEntityFlags.FTENT_SLOWGRAVITY;
+    private const TempEntityFlags CollideFlags = TempEntityFlags.FTENT_COLLIDEALL | TempEntityFlags.FTENT_COLLIDEWORLD;
+    private const TempEntityFlags SpecialMoveFlags = TempEntityFlags.FTENT_SPARKSHOWER | TempEntityFlags.FTENT_PLYRATTACHMENT |
+                                                     TempEntityFlags.FTENT_SINEWAVE | TempEntityFlags.FTENT_SPIRAL;
+
+    private readonly ClientEngineFuncs* _engine;
+
+    // Live entities in list order, and the SoA batch of linear movers (origin + velocity).
+    private nint[] _live = new nint[InitialCapacity];
+    private nint[] _batch = new nint[InitialCapacity];
+    private float[] _px = new float[InitialCapacity];
+    private float[] _py = new float[InitialCapacity];
+    private float[] _pz = new float[InitialCapacity];
+    private float[] _vx = new float[InitialCapacity];
+    private float[] _vy = new float[InitialCapacity];
+    private float[] _vz = new float[InitialCapacity];
+
+    // !!!BUGBUG -- This needs to be time based (kept from the original for FTENT_FLICKER parity)
+    private int _tempEntFrame;
+
+    private TempEntityFrameStats _stats;
+
+    /// <summary>
+    /// Create a simulator bound to the client engine function table.
+    /// pEventAPI and pEfxAPI may be null (headless); collision and effects are skipped then.
+    /// </summary>
+    public TempEntitySimulator(ClientEngineFuncs* engine)
+    {
+        if (engine == null)
+            throw new ArgumentNullException(nameof(engine));
+
+        _engine = engine;
+    }
+
+    /// <summary>
+    /// Use SIMD for the integration step. Defaults to hardware acceleration availability.
+    /// </summary>
+    public bool Vectorized { get; set; } = System.Numerics.Vector.IsHardwareAccelerated;
+
+    /// <summary>
+    /// Counters from the last <see cref="Update"/> call.
+    /// </summary>
+    public TempEntityFrameStats LastFrame => _stats;
+
+    /// <summary>
+    /// Simulate one frame of temp entities.
+    /// Original: void HUD_TempEntUpdate(double frametime, double client_time, double cl_gravity, TEMPENTITY** ppTempEntFree, TEMPENTITY** ppTempEntActive, ...)
+    /// </summary>
+    public void Update(double frametime, double client_time, double cl_gravity, TEMPENTITY** ppTempEntFree, TEMPENTITY** ppTempEntActive,
+        delegate* unmanaged[Cdecl]<cl_entity_t*, int> Callback_AddVisibleEntity, delegate* unmanaged[Cdecl]<TEMPENTITY*, float, void> Callback_TempEntPlaySound)
+    {
+        _stats = default;
+
+        // Nothing to simulate
+        if (*ppTempEntActive == null)
+            return;
+
+        var eventApi = _engine->pEventAPI;
+
+        // in order to have tents collide with players, we have to run the player prediction code so
+        // that the client has the player list.
+        if (eventApi != null)
+        {
+            eventApi->EV_SetUpPlayerPrediction(0, 1);
+            eventApi->EV_PushPMStates();
+            eventApi->EV_SetSolidPlayers(-1);
+        }
+
+        _tempEntFrame = (_tempEntFrame + 1) & 31;
+
+        if (frametime <= 0)
+        {
+            // Don't simulate while paused, just keep everything visible.
+            for (var pTemp = *ppTempEntActive; pTemp != null; pTemp = pTemp->next)
+            {
+                if ((pTemp->flags & (int)TempEntityFlags.FTENT_NOMODEL) == 0 && Callback_AddVisibleEntity(&pTemp->entity) != 0)
+                    _stats.Submitted++;
+                _stats.Active++;
+            }
+        }
+        else
+        {
+            int liveCount = ExpireAndMove((float)frametime, client_time, ppTempEntFree, ppTempEntActive, out int batchCount);
+
+            if (Vectorized)
+                IntegrateSimd(batchCount, (float)frametime);
+            else
+                IntegrateScalar(batchCount, (float)frametime);
+
+            ScatterOrigins(batchCount);
+
+            for (int i = 0; i < liveCount; i++)
+                Think((TEMPENTITY*)_live[i], (float)frametime, client_time, (float)(-frametime * cl_gravity), Callback_AddVisibleEntity, Callback_TempEntPlaySound);
+
+            _stats.Active = liveCount;
+            _stats.Integrated = batchCount;
+        }
+
+        // Restore state info
+        if (eventApi != null)
+            eventApi->EV_PopPMStates();
+    }
+
+    /// <summary>
+    /// Walk the active list: kill expired entities, latch prevstate origin, run the non-linear
+    /// movers in place and gather the linear movers into the SoA batch.
+    /// </summary>
+    private int ExpireAndMove(float frametime, double client_time, TEMPENTITY** ppTempEntFree, TEMPENTITY** ppTempEntActive, out int batchCount)
+    {
+        int liveCount = 0;
+        batchCount = 0;
+
+        float fastFreq = (float)(client_time * 5.5);
+        TEMPENTITY* pprev = null;
+        TEMPENTITY* pTemp = *ppTempEntActive;
+
+        while (pTemp != null)
+        {
+            TEMPENTITY* pnext = pTemp->next;
+            bool active = true;
+            float life = (float)(pTemp->die - client_time);
+
+            if (life < 0)
+            {
+                if ((pTemp->flags & (int)TempEntityFlags.FTENT_FADEOUT) != 0)
+                {
+                    if (pTemp->entity.curstate.rendermode == (int)RenderMode.kRenderNormal)
+                        pTemp->entity.curstate.rendermode = (int)RenderMode.kRenderTransTexture;
+                    pTemp->entity.curstate.renderamt = (int)(pTemp->entity.baseline.renderamt * (1 + life * pTemp->fadeSpeed));
+                    if (pTemp->entity.curstate.renderamt <= 0)
+                        active = false;
+                }
+                else
+                {
+                    active = false;
+                }
+            }
+
+            if (!active)
+            {
+                // Kill it
+                pTemp->next = *ppTempEntFree;
+                *ppTempEntFree = pTemp;
+                if (pprev == null) // Deleting at head of list
+                    *ppTempEntActive = pnext;
+                else
+                    pprev->next = pnext;
+
+                _stats.Killed++;
+                pTemp = pnext;
+                continue;
+            }
+
+            pprev = pTemp;
+            pTemp->entity.prevstate.origin = pTemp->entity.origin;
+
+            EnsureCapacity(liveCount + 1);
+            _live[liveCount++] = (nint)pTemp;
+
+            var flags = (TempEntityFlags)pTemp->flags;
+            if ((flags & SpecialMoveFlags) == 0)
+            {
+                ref var org = ref pTemp->entity.origin;
+                ref var vel = ref pTemp->entity.baseline.origin;
+                _batch[batchCount] = (nint)pTemp;
+                _px[batchCount] = org.X;
+                _py[batchCount] = org.Y;
+                _pz[batchCount] = org.Z;
+                _vx[batchCount] = vel.X;
+                _vy[batchCount] = vel.Y;
+                _vz[batchCount] = vel.Z;
+                batchCount++;
+            }
+            else
+            {
+                MoveSpecial(pTemp, flags, frametime, client_time, fastFreq);
+            }
+
+            pTemp = pnext;
+        }
+
+        return liveCount;
+    }
+
+    private void MoveSpecial(TEMPENTITY* pTemp, TempEntityFlags flags, float frametime, double client_time, float fastFreq)
+    {
+        ref var ent = ref pTemp->entity;
+
+        if ((flags & TempEntityFlags.FTENT_SPARKSHOWER) != 0)
+        {
+            // Adjust speed if it's time. Scale is next think time
+            if (client_time > ent.baseline.scale)
+            {
+                var efx = _engine->pEfxAPI;
+                if (efx != null)
+                {
+                    var origin = ent.origin;
+                    efx->R_SparkEffect((float*)&origin, 8, -200, 200);
+                }
+
+                // Reduce life
+                ent.baseline.framerate -= 0.1f;
+
+                if (ent.baseline.framerate <= 0.0f)
+                {
+                    pTemp->die = (float)client_time;
+                }
+                else
+                {
+                    // So it will die no matter what
+                    pTemp->die = (float)client_time + 0.5f;
+                    // Next think
+                    ent.baseline.scale = (float)client_time + 0.1f;
+                }
+            }
+        }
+        else if ((flags & TempEntityFlags.FTENT_PLYRATTACHMENT) != 0)
+        {
+            var pClient = _engine->GetEntityByIndex != null ? _engine->GetEntityByIndex(pTemp->clientIndex) : null;
+            if (pClient != null)
+                ent.origin = pClient->origin + pTemp->tentOffset;
+        }
+        else if ((flags & TempEntityFlags.FTENT_SINEWAVE) != 0)
+        {
+            pTemp->x += ent.baseline.origin.X * frametime;
+            pTemp->y += ent.baseline.origin.Y * frametime;
+
+            ent.origin.X = pTemp->x + MathF.Sin(ent.baseline.origin.Z + (float)client_time * ent.prevstate.frame) * (10 * ent.curstate.framerate);
+            ent.origin.Y = pTemp->y + MathF.Sin(ent.baseline.origin.Z + fastFreq + 0.7f) * (8 * ent.curstate.framerate);
+            ent.origin.Z += ent.baseline.origin.Z * frametime;
+        }
+        else // FTENT_SPIRAL
+        {
+            int phase = unchecked((int)(nint)pTemp);
+            ent.origin.X += ent.baseline.origin.X * frametime + 8 * MathF.Sin((float)client_time * 20 + phase);
+            ent.origin.Y += ent.baseline.origin.Y * frametime + 4 * MathF.Sin((float)client_time * 30 + phase);
+            ent.origin.Z += ent.baseline.origin.Z * frametime;
+        }
+    }
+
+    /// <summary>
+    /// origin += velocity * frametime over the SoA batch, Vector&lt;float&gt; lanes at a time.
+    /// </summary>
+    private void IntegrateSimd(int count, float frametime)
+    {
+        int width = SimdVector.Count;
+        int simdCount = count - count % width;
+        var dt = new SimdVector(frametime);
+
+        var px = _px.AsSpan(); var py = _py.AsSpan(); var pz = _pz.AsSpan();
+        var vx = _vx.AsSpan(); var vy = _vy.AsSpan(); var vz = _vz.AsSpan();
+
+        for (int i = 0; i < simdCount; i += width)
+        {
+            (new SimdVector(px.Slice(i)) + new SimdVector(vx.Slice(i)) * dt).CopyTo(px.Slice(i));
+            (new SimdVector(py.Slice(i)) + new SimdVector(vy.Slice(i)) * dt).CopyTo(py.Slice(i));
+            (new SimdVector(pz.Slice(i)) + new SimdVector(vz.Slice(i)) * dt).CopyTo(pz.Slice(i));
+        }
+
+        for (int i = simdCount; i < count; i++)
+        {
+            px[i] += vx[i] * frametime;
+            py[i] += vy[i] * frametime;
+            pz[i] += vz[i] * frametime;
+        }
+    }
+
+    private void IntegrateScalar(int count, float frametime)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            _px[i] += _vx[i] * frametime;
+            _py[i] += _vy[i] * frametime;
+            _pz[i] += _vz[i] * frametime;
+        }
+    }
+
+    private void ScatterOrigins(int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            var pTemp = (TEMPENTITY*)_batch[i];
+            pTemp->entity.origin = new Vector3(_px[i], _py[i], _pz[i]);
+        }
+    }
+
+    /// <summary>
+    /// Everything after the position update: sprite animation, rotation, collision, effects,
+    /// gravity, client callback and submission.
+    /// </summary>
+    private void Think(TEMPENTITY* pTemp, float frametime, double client_time, float gravity,
+        delegate* unmanaged[Cdecl]<cl_entity_t*, int> Callback_AddVisibleEntity, delegate* unmanaged[Cdecl]<TEMPENTITY*, float, void> Callback_TempEntPlaySound)
+    {
+        ref var ent = ref pTemp->entity;
+        var flags = (TempEntityFlags)pTemp->flags;
+
+        if ((flags & TempEntityFlags.FTENT_SPRANIMATE) != 0)
+        {
+            ent.curstate.frame += frametime * ent.curstate.framerate;
+            if (ent.curstate.frame >= pTemp->frameMax)
+            {
+                ent.curstate.frame -= (int)ent.curstate.frame;
+
+                if ((flags & TempEntityFlags.FTENT_SPRANIMATELOOP) == 0)
+                {
+                    // this animating sprite isn't set to loop, so destroy it.
+                    pTemp->die = (float)client_time;
+                    return;
+                }
+            }
+        }
+        else if ((flags & TempEntityFlags.FTENT_SPRCYCLE) != 0)
+        {
+            ent.curstate.frame += frametime * 10;
+            if (ent.curstate.frame >= pTemp->frameMax)
+                ent.curstate.frame -= (int)ent.curstate.frame;
+        }
+
+        if ((flags & TempEntityFlags.FTENT_ROTATE) != 0)
+        {
+            ent.angles += ent.baseline.angles * frametime;
+            ent.latched.prevangles = ent.angles;
+        }
+
+        if ((flags & CollideFlags) != 0)
+            Collide(pTemp, flags, frametime, client_time, gravity, Callback_TempEntPlaySound);
+
+        flags = (TempEntityFlags)pTemp->flags;
+
+        if ((flags & TempEntityFlags.FTENT_FLICKER) != 0 && _tempEntFrame == ent.curstate.effects)
+        {
+            var efx = _engine->pEfxAPI;
+            var dl = efx != null ? efx->CL_AllocDlight(0) : null;
+            if (dl != null)
+            {
+                dl->origin = ent.origin;
+                dl->radius = 60;
+                dl->color.r = 255;
+                dl->color.g = 120;
+                dl->color.b = 0;
+                dl->die = (float)client_time + 0.01f;
+            }
+        }
+
+        if ((flags & TempEntityFlags.FTENT_SMOKETRAIL) != 0 && _engine->pEfxAPI != null)
+        {
+            var start = ent.prevstate.origin;
+            var end = ent.origin;
+            _engine->pEfxAPI->R_RocketTrail((float*)&start, (float*)&end, 1);
+        }
+
+        if ((flags & TempEntityFlags.FTENT_GRAVITY) != 0)
+            ent.baseline.origin.Z += gravity;
+        else if ((flags & TempEntityFlags.FTENT_SLOWGRAVITY) != 0)
+            ent.baseline.origin.Z += gravity * 0.5f;
+
+        if ((flags & TempEntityFlags.FTENT_CLIENTCUSTOM) != 0 && pTemp->callback != null)
+            pTemp->callback(pTemp, frametime, (float)client_time);
+
+        // The callback may change the flags.
+        flags = (TempEntityFlags)pTemp->flags;
+
+        // Cull to PVS (not frustum cull, just PVS)
+        if ((flags & TempEntityFlags.FTENT_NOMODEL) == 0)
+        {
+            if (Callback_AddVisibleEntity(&pTemp->entity) != 0)
+            {
+                _stats.Submitted++;
+            }
+            else if ((flags & TempEntityFlags.FTENT_PERSIST) == 0)
+            {
+                // If we can't draw it this frame, just dump it. Don't fade out, just die
+                pTemp->die = (float)client_time;
+                pTemp->flags &= ~(int)TempEntityFlags.FTENT_FADEOUT;
+            }
+        }
+    }
+
+    private void Collide(TEMPENTITY* pTemp, TempEntityFlags flags, float frametime, double client_time, float gravity,
+        delegate* unmanaged[Cdecl]<TEMPENTITY*, float, void> Callback_TempEntPlaySound)
+    {
+        var eventApi = _engine->pEventAPI;
+        if (eventApi == null)
+            return;
+
+        ref var ent = ref pTemp->entity;
+        var start = ent.prevstate.origin;
+        var end = ent.origin;
+        var traceNormal = default(Vector3);
+        float traceFraction = 1;
+        var pmtrace = default(pmtrace_t);
+
+        eventApi->EV_SetTraceHull(2);
+
+        if ((flags & TempEntityFlags.FTENT_COLLIDEALL) != 0)
+        {
+            eventApi->EV_PlayerTrace((float*)&start, (float*)&end, PM_STUDIO_BOX, -1, &pmtrace);
+
+            if (pmtrace.fraction != 1)
+            {
+                var pe = pmtrace.ent != 0 ? eventApi->EV_GetPhysent(pmtrace.ent) : null;
+                if (pmtrace.ent == 0 || pe == null || pe->info != pTemp->clientIndex)
+                {
+                    traceFraction = pmtrace.fraction;
+                    traceNormal = pmtrace.plane.normal;
+
+                    if (pTemp->hitcallback != null)
+                    {
+                        pTemp->hitcallback(pTemp, &pmtrace);
+                        flags = (TempEntityFlags)pTemp->flags;
+                    }
+                }
+            }
+        }
+        else
+        {
+            eventApi->EV_PlayerTrace((float*)&start, (float*)&end, PM_STUDIO_BOX | PM_WORLD_ONLY, -1, &pmtrace);
+
+            if (pmtrace.fraction != 1)
+            {
+                traceFraction = pmtrace.fraction;
+                traceNormal = pmtrace.plane.normal;
+
+                if ((flags & TempEntityFlags.FTENT_SPARKSHOWER) != 0)
+                {
+                    // Chop spark speeds a bit more
+                    ent.baseline.origin *= 0.6f;
+                    if (ent.baseline.origin.Length() < 10)
+                        ent.baseline.framerate = 0.0f;
+                }
+
+                if (pTemp->hitcallback != null)
+                {
+                    pTemp->hitcallback(pTemp, &pmtrace);
+                    flags = (TempEntityFlags)pTemp->flags;
+                }
+            }
+        }
+
+        if (traceFraction == 1)
+            return;
+
+        // Decent collision now, and damping works
+        _stats.Collided++;
+
+        // Place at contact point
+        ent.origin = ent.prevstate.origin + ent.baseline.origin * (traceFraction * frametime);
+
+        // Damp velocity
+        float damp = pTemp->bounceFactor;
+        if ((flags & GravityFlags) != 0)
+        {
+            damp *= 0.5f;
+            if (traceNormal.Z > 0.9f) // Hit floor?
+            {
+                if (ent.baseline.origin.Z <= 0 && ent.baseline.origin.Z >= gravity * 3)
+                {
+                    damp = 0; // Stop
+                    pTemp->flags &= ~(int)(TempEntityFlags.FTENT_ROTATE | GravityFlags | TempEntityFlags.FTENT_COLLIDEWORLD | TempEntityFlags.FTENT_SMOKETRAIL);
+                    ent.angles.X = 0;
+                    ent.angles.Z = 0;
+                }
+            }
+        }
+
+        if (pTemp->hitSound != 0 && Callback_TempEntPlaySound != null)
+            Callback_TempEntPlaySound(pTemp, damp);
+
+        if ((flags & TempEntityFlags.FTENT_COLLIDEKILL) != 0)
+        {
+            // die on impact
+            pTemp->flags &= ~(int)TempEntityFlags.FTENT_FADEOUT;
+            pTemp->die = (float)client_time;
+            return;
+        }
+
+        // Reflect velocity
+        if (damp != 0)
+        {
+            float proj = Vector3.Dot(ent.baseline.origin, traceNormal);
+            ent.baseline.origin -= traceNormal * (proj * 2);
+            // Reflect rotation (fake)
+            ent.angles.Y = -ent.angles.Y;
+        }
+
+        if (damp != 1)
+        {
+            ent.baseline.origin *= damp;
+            ent.angles *= 0.9f;
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    private void EnsureCapacity(int required)
+    {
+        if (required <= _live.Length)
+            return;
+
+        int size = Math.Max(required, _live.Length * 2);
+        Array.Resize(ref _live, size);
+        Array.Resize(ref _batch, size);
+        Array.Resize(ref _px, size);
+        Array.Resize(ref _py, size);
+        Array.Resize(ref _pz, size);
+        Array.Resize(ref _vx, size);
+        Array.Resize(ref _vy, size);
+        Array.Resize(ref _vz, size);
+    }
+}
@@ -1,6 +1,10 @@
 using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Models;
+using GoldsrcFramework.Strings;
 using NativeInterop;
 using System;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
 using System.Text;
 
 namespace GoldsrcFramework
@@ -12,13 +16,160 @@ namespace GoldsrcFramework
         public static globalvars_t* PGlobals { get; private set; }
         public static engine_studio_api_t* PStudio { get; private set; }
 
+        private const int ScratchLimit = 512;
+
         public static void DrawStringCenter(string text)
         {
-            Span<byte> msg = stackalloc byte[256];
-            int _ = Encoding.UTF8.GetBytes(text, msg);
-            fixed (byte* ptr = msg)
+            using var msg = new ScratchUtf8(text, false, stackalloc byte[ScratchLimit]);
+            PClient->CenterPrint(msg.Pointer);
+        }
+
+        #region Server strings
+
+        // The engine keeps the pointer for these, so the text goes through the level pool
+        // and stays valid until the next map starts spawning.
+
+        public static int PrecacheModel(ReadOnlySpan<char> name)
+        {
+            var s = Utf8StringPool.Level.Intern(name);
+            StudioModelCache.Server.NotePrecache(s);
+            return PServer->PrecacheModel(s);
+        }
+
+        public static int PrecacheSound(ReadOnlySpan<char> name) => PServer->PrecacheSound(Utf8StringPool.Level.Intern(name));
+
+        public static void SetModel(edict_t* entity, ReadOnlySpan<char> name) => PServer->SetModel(entity, Utf8StringPool.Level.Intern(name));
+
+        public static int ModelIndex(ReadOnlySpan<char> name) => PServer->ModelIndex(Utf8StringPool.Level.Intern(name));
+
+        /// <summary>
+        /// MAKE_STRING: a string_t offset from pStringBase to a pooled copy of <paramref name="text"/>.
+        /// </summary>
+        public static int MakeString(ReadOnlySpan<char> text)
+        {
+            return (int)((byte*)Utf8StringPool.Level.Intern(text) - (byte*)PGlobals->pStringBase);
+        }
+
+        // The engine copies these immediately, so a stack buffer is enough.
+
+        /// <summary>
+        /// ALLOC_STRING: engine-owned copy, for text built at run time that should not grow the pool.
+        /// </summary>
+        public static int AllocString(ReadOnlySpan<char> text)
+        {
+            using var s = new ScratchUtf8(text, false, stackalloc byte[ScratchLimit]);
+            return PServer->AllocString(s.Pointer);
+        }
+
+        public static void ServerPrint(ReadOnlySpan<char> text)
+        {
+            using var s = new ScratchUtf8(text, false, stackalloc byte[ScratchLimit]);
+            PServer->ServerPrint(s.Pointer);
+        }
+
+        public static void ServerCommand(ReadOnlySpan<char> text)
+        {
+            using var s = new ScratchUtf8(text, false, stackalloc byte[ScratchLimit]);
+            PServer->ServerCommand(s.Pointer);
+        }
+
+        public static void ClientPrintf(edict_t* entity, PRINT_TYPE type, ReadOnlySpan<char> text)
+        {
+            using var s = new ScratchUtf8(text, false, stackalloc byte[ScratchLimit]);
+            PServer->ClientPrintf(entity, type, s.Pointer);
+        }
+
+        /// <summary>
+        /// CLIENT_COMMAND; '%' is escaped since the engine treats the text as a format string.
+        /// </summary>
+        public static void ClientCommand(edict_t* entity, ReadOnlySpan<char> text)
+        {
+            using var s = new ScratchUtf8(text, true, stackalloc byte[ScratchLimit]);
+            PServer->ClientCommand(entity, s.Pointer);
+        }
+
+        /// <summary>
+        /// ALERT; '%' is escaped since the engine treats the text as a format string.
+        /// </summary>
+        public static void AlertMessage(ALERT_TYPE type, ReadOnlySpan<char> text)
+        {
+            using var s = new ScratchUtf8(text, true, stackalloc byte[ScratchLimit]);
+            PServer->AlertMessage(type, s.Pointer);
+        }
+
+        #endregion
+
+        #region Client strings
+
+        /// <summary>
+        /// Con_DPrintf (shown with developer 1); '%' is escaped since the engine treats the text as a format string.
+        /// </summary>
+        public static void ConsoleDPrint(ReadOnlySpan<char> text)
+        {
+            using var s = new ScratchUtf8(text, true, stackalloc byte[ScratchLimit]);
+            PClient->Con_DPrintf(s.Pointer);
+        }
+
+        /// <summary>
+        /// Con_Printf; '%' is escaped since the engine treats the text as a format string.
+        /// </summary>
+        public static void ConsolePrint(ReadOnlySpan<char> text)
+        {
+            using var s = new ScratchUtf8(text, true, stackalloc byte[ScratchLimit]);
+            PClient->Con_Printf(s.Pointer);
+        }
+
+        #endregion
+
+        /// <summary>
+        /// Null-terminated UTF-8 copy in a caller-provided stack buffer, or native memory when the text does not fit.
+        /// </summary>
+        private ref struct ScratchUtf8
+        {
+            private byte* _heap;
+
+            public NChar* Pointer { get; }
+
+            public ScratchUtf8(ReadOnlySpan<char> text, bool escapePercent, Span<byte> stack)
+            {
+                int percents = escapePercent ? text.Count('%') : 0;
+                int maxBytes = Encoding.UTF8.GetMaxByteCount(text.Length) + percents + 1;
+
+                byte* p;
+                if (maxBytes <= stack.Length)
+                {
+                    // stackalloc memory is never moved
+                    p = (byte*)Unsafe.AsPointer(ref MemoryMarshal.GetReference(stack));
+                }
+                else
+                {
+                    p = _heap = (byte*)NativeMemory.Alloc((nuint)maxBytes);
+                }
+
+                var buffer = new Span<byte>(p, maxBytes);
+                int length = 0;
+                while (true)
+                {
+                    int i = percents == 0 ? -1 : text.IndexOf('%');
+                    length += Encoding.UTF8.GetBytes(i < 0 ? text : text[..i], buffer[length..]);
+                    if (i < 0)
+                        break;
+                    buffer[length++] = (byte)'%';
+                    buffer[length++] = (byte)'%';
+                    text = text[(i + 1)..];
+                }
+                buffer[length] = 0;
+
+                Pointer = (NChar*)p;
+            }
+
+            public void Dispose()
             {
-                PClient->CenterPrint((NChar*)ptr);
+                if (_heap != null)
+                {
+                    NativeMemory.Free(_heap);
+                    _heap = null;
+                }
             }
         }
 
@@ -0,0 +1,386 @@
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+
+namespace GoldsrcFramework.Entity;
+
+/// <summary>
+/// Occupancy of one private data class in <see cref="PrivateDataAllocator"/>.
+/// </summary>
+public readonly record struct PrivateDataClassStats(
+    string ClassName,
+    int BlockSize,
+    int Slabs,
+    int LiveBlocks,
+    int FreeBlocks,
+    long Allocations,
+    long Frees);
+
+/// <summary>
+/// Occupancy of a <see cref="PrivateDataAllocator"/>.
+/// </summary>
+/// <param name="ArenaBytes">Native memory reserved for arenas.</param>
+/// <param name="SlabBytes">Part of the arenas handed to classes as slabs.</param>
+/// <param name="LiveBytes">Blocks in use, headers included.</param>
+/// <param name="Occupancy">LiveBytes / ArenaBytes.</param>
+/// <param name="Fragmentation">Share of the slab bytes not in use: freed blocks waiting for their class plus the uncarved end of each slab.</param>
+/// <param name="StaleFrees">Frees of blocks from before the last <see cref="PrivateDataAllocator.Reset"/>.</param>
+public readonly record struct PrivateDataStats(
+    long ArenaBytes,
+    long SlabBytes,
+    long LiveBytes,
+    int Arenas,
+    int Classes,
+    int Slabs,
+    int LiveBlocks,
+    int FreeBlocks,
+    double Occupancy,
+    double Fragmentation,
+    long Allocations,
+    long Frees,
+    long StaleFrees,
+    int Resets);
+
+/// <summary>
+/// Allocator for edict_t::pvPrivateData of managed entities.
+///
+/// Large native arenas are carved into fixed-size slabs, each slab serving a single class, so a class's blocks are
+/// all the same size and a freed block goes straight back to its class's free list. Every block starts with a
+/// small header holding its index in a managed owner table: the entity object is found from the edict without a
+/// GCHandle, and nothing is left for the GC to track per entity. The header also records the edict it was given to,
+/// so a block is only ever freed through that edict.
+///
+/// The engine frees private data itself after calling OnFreeEntPrivateData, so <see cref="Free"/> recycles the block
+/// and clears pvPrivateData first (the engine's free of a null pointer does nothing). <see cref="Reset"/> drops every
+/// block at once and keeps the arenas for the next level. The engine frees the old level's entities after
+/// ServerDeactivate, so the framework resets at the first entity callback of the next map, once they are all freed;
+/// a block freed after a reset anyway is only unlinked from its edict, even when its memory already serves another.
+///
+/// Main thread only, like the engine callbacks it serves.
+/// </summary>
+public sealed unsafe class PrivateDataAllocator : IDisposable
+{
+    private const int Alignment = 16;
+
+    [StructLayout(LayoutKind.Sequential, Size = 16)]
+    private struct BlockHeader
+    {
+        // EdictTag of the edict the block was given to; 0 once freed.
+        public uint Edict;
+        public int ClassId;
+        public int Handle;
+        public int Generation;
+    }
+
+    private struct Arena
+    {
+        public byte* Base;
+        public nint Size;
+        public nint Used;
+    }
+
+    private sealed class ClassInfo(string name, int blockSize)
+    {
+        public readonly string Name = name;
+        public readonly int BlockSize = blockSize;
+        public byte* Cursor;
+        public byte* End;
+        public byte* FreeList;
+        public int Slabs;
+        public int Live;
+        public int Free;
+        public long Allocations;
+        public long Frees;
+    }
+
+    private readonly int _arenaBytes;
+    private readonly int _slabBytes;
+    private readonly List<ClassInfo> _classes = new();
+    private readonly Dictionary<string, int> _classIds = new(StringComparer.Ordinal);
+
+    private Arena[] _arenas = new Arena[4];
+    private int _arenaCount;
+
+    // Owner table: block header -> managed object, with a stack of unused handles.
+    private object?[] _owners = new object?[256];
+    private int[] _freeHandles = new int[256];
+    private int _freeHandleCount;
+    private int _handleCount;
+
+    private int _generation = 1;
+    private long _staleFrees;
+    private int _resets;
+
+    /// <summary>
+    /// Allocator used by the framework's OnFreeEntPrivateData, reset when the next map starts.
+    /// </summary>
+    public static PrivateDataAllocator Shared { get; } = new();
+
+    /// <param name="arenaBytes">Size of each native arena; more are added as needed.</param>
+    /// <param name="slabBytes">Size of the slabs carved from the arenas (larger for classes whose block does not fit).</param>
+    public PrivateDataAllocator(int arenaBytes = 4 << 20, int slabBytes = 64 << 10)
+    {
+        _slabBytes = Math.Max(Align(slabBytes), 4096);
+        _arenaBytes = Math.Max(Align(arenaBytes), _slabBytes);
+    }
+
+    /// <summary>
+    /// Register (or look up) a class whose private data is <paramref name="size"/> bytes; returns its id.
+    /// </summary>
+    public int RegisterClass(string className, int size)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegative(size);
+        int blockSize = Align(sizeof(BlockHeader) + Math.Max(size, sizeof(nint)));
+
+        if (_classIds.TryGetValue(className, out int id))
+        {
+            if (_classes[id].BlockSize != blockSize)
+                throw new InvalidOperationException($"Private data class '{className}' is already registered with another size");
+            return id;
+        }
+
+        id = _classes.Count;
+        _classes.Add(new ClassInfo(className, blockSize));
+        _classIds.Add(className, id);
+        return id;
+    }
+
+    /// <summary>
+    /// Register <typeparamref name="T"/> as the private data of <paramref name="className"/>.
+    /// </summary>
+    public int RegisterClass<T>(string className) where T : unmanaged => RegisterClass(className, sizeof(T));
+
+    /// <summary>
+    /// Give <paramref name="edict"/> a zeroed private data block of class <paramref name="classId"/>, owned by
+    /// <paramref name="owner"/> (see <see cref="GetOwner"/>). The edict must not have private data yet.
+    /// </summary>
+    public void* Allocate(edict_t* edict, int classId, object? owner = null)
+    {
+        if (edict->pvPrivateData != null)
+            throw new InvalidOperationException("Edict already has private data");
+
+        var info = _classes[classId];
+        byte* block = info.FreeList;
+        if (block != null)
+        {
+            info.FreeList = *(byte**)(block + sizeof(BlockHeader));
+            info.Free--;
+        }
+        else
+        {
+            if (info.Cursor + info.BlockSize > info.End)
+                NewSlab(info);
+            block = info.Cursor;
+            info.Cursor += info.BlockSize;
+        }
+
+        var header = (BlockHeader*)block;
+        header->Edict = EdictTag(edict);
+        header->ClassId = classId;
+        header->Handle = NewHandle(owner);
+        header->Generation = _generation;
+
+        void* data = block + sizeof(BlockHeader);
+        new Span<byte>(data, info.BlockSize - sizeof(BlockHeader)).Clear();
+        edict->pvPrivateData = data;
+
+        info.Live++;
+        info.Allocations++;
+        return data;
+    }
+
+    /// <summary>
+    /// Called from OnFreeEntPrivateData. When the edict's private data came from this allocator, recycle it, clear
+    /// pvPrivateData and return true; otherwise leave it alone (legacy entity).
+    /// </summary>
+    public bool Free(edict_t* edict)
+    {
+        var data = (byte*)edict->pvPrivateData;
+        if (data == null || !Owns(data))
+            return false;
+
+        edict->pvPrivateData = null;
+
+        var header = (BlockHeader*)(data - sizeof(BlockHeader));
+        if (header->Edict != EdictTag(edict) || header->Generation != _generation)
+        {
+            // Freed after a Reset: the block, or the memory it was in, already belongs to the next level.
+            _staleFrees++;
+            return true;
+        }
+
+        var info = _classes[header->ClassId];
+        ReleaseHandle(header->Handle);
+        header->Edict = 0;
+        *(byte**)data = info.FreeList;
+        info.FreeList = (byte*)header;
+        info.Free++;
+        info.Live--;
+        info.Frees++;
+        return true;
+    }
+
+    /// <summary>
+    /// Whether <paramref name="data"/> points into one of the arenas.
+    /// </summary>
+    public bool Owns(void* data)
+    {
+        var p = (byte*)data;
+        for (int i = 0; i < _arenaCount; i++)
+        {
+            ref var arena = ref _arenas[i];
+            if (p >= arena.Base && p < arena.Base + arena.Size)
+                return true;
+        }
+        return false;
+    }
+
+    /// <summary>
+    /// Managed object given to <see cref="Allocate"/> for the private data of <paramref name="edict"/>, or null.
+    /// </summary>
+    public object? GetOwner(edict_t* edict)
+    {
+        var data = (byte*)edict->pvPrivateData;
+        if (data == null || !Owns(data))
+            return null;
+
+        var header = (BlockHeader*)(data - sizeof(BlockHeader));
+        return header->Edict == EdictTag(edict) && header->Generation == _generation ? _owners[header->Handle] : null;
+    }
+
+    /// <inheritdoc cref="GetOwner"/>
+    public T? GetOwner<T>(edict_t* edict) where T : class => GetOwner(edict) as T;
+
+    /// <summary>
+    /// Drop every block and owner, once the engine has freed the level's entities. The arenas are kept for the next level.
+    /// </summary>
+    public void Reset()
+    {
+        for (int i = 0; i < _arenaCount; i++)
+            _arenas[i].Used = 0;
+
+        foreach (var info in _classes)
+        {
+            info.Cursor = info.End = info.FreeList = null;
+            info.Slabs = info.Live = info.Free = 0;
+        }
+
+        Array.Clear(_owners, 0, _handleCount);
+        _handleCount = 0;
+        _freeHandleCount = 0;
+        _generation++;
+        _resets++;
+    }
+
+    public PrivateDataStats Stats
+    {
+        get
+        {
+            long arenaBytes = 0, slabBytes = 0, liveBytes = 0, allocations = 0, frees = 0;
+            int slabs = 0, live = 0, free = 0;
+            foreach (var info in _classes)
+            {
+                slabs += info.Slabs;
+                live += info.Live;
+                free += info.Free;
+                liveBytes += (long)info.Live * info.BlockSize;
+                slabBytes += (long)info.Slabs * SlabSize(info);
+                allocations += info.Allocations;
+                frees += info.Frees;
+            }
+            for (int i = 0; i < _arenaCount; i++)
+                arenaBytes += _arenas[i].Size;
+
+            return new PrivateDataStats(
+                arenaBytes, slabBytes, liveBytes, _arenaCount, _classes.Count, slabs, live, free,
+                arenaBytes > 0 ? (double)liveBytes / arenaBytes : 0,
+                slabBytes > 0 ? 1 - (double)liveBytes / slabBytes : 0,
+                allocations, frees, _staleFrees, _resets);
+        }
+    }
+
+    public IReadOnlyList<PrivateDataClassStats> ClassStats()
+    {
+        var stats = new PrivateDataClassStats[_classes.Count];
+        for (int i = 0; i < stats.Length; i++)
+        {
+            var info = _classes[i];
+            stats[i] = new PrivateDataClassStats(info.Name, info.BlockSize, info.Slabs, info.Live, info.Free, info.Allocations, info.Frees);
+        }
+        return stats;
+    }
+
+    private void NewSlab(ClassInfo info)
+    {
+        int size = SlabSize(info);
+
+        // The tail of the current slab stays unused; slabs are not shared between classes.
+        byte* slab = null;
+        for (int i = 0; i < _arenaCount && slab == null; i++)
+        {
+            ref var arena = ref _arenas[i];
+            if (arena.Used + size <= arena.Size)
+            {
+                slab = arena.Base + arena.Used;
+                arena.Used += size;
+            }
+        }
+
+        if (slab == null)
+        {
+            if (_arenaCount == _arenas.Length)
+                Array.Resize(ref _arenas, _arenas.Length * 2);
+
+            int arenaSize = Math.Max(_arenaBytes, size);
+            ref var arena = ref _arenas[_arenaCount++];
+            arena.Base = (byte*)NativeMemory.AlignedAlloc((nuint)arenaSize, Alignment);
+            arena.Size = arenaSize;
+            arena.Used = size;
+            slab = arena.Base;
+        }
+
+        info.Cursor = slab;
+        info.End = slab + size;
+        info.Slabs++;
+    }
+
+    private int SlabSize(ClassInfo info) => info.BlockSize <= _slabBytes ? _slabBytes : info.BlockSize;
+
+    private int NewHandle(object? owner)
+    {
+        int handle;
+        if (_freeHandleCount > 0)
+        {
+            handle = _freeHandles[--_freeHandleCount];
+        }
+        else
+        {
+            if (_handleCount == _owners.Length)
+                Array.Resize(ref _owners, _owners.Length * 2);
+            handle = _handleCount++;
+        }
+
+        _owners[handle] = owner;
+        return handle;
+    }
+
+    private void ReleaseHandle(int handle)
+    {
+        _owners[handle] = null;
+        if (_freeHandleCount == _freeHandles.Length)
+            Array.Resize(ref _freeHandles, _freeHandles.Length * 2);
+        _freeHandles[_freeHandleCount++] = handle;
+    }
+
+    private static int Align(int size) => (size + Alignment - 1) & ~(Alignment - 1);
+
+    // Low bits of the edict address: edicts sit in one engine array, so these differ between edicts. Never 0.
+    private static uint EdictTag(edict_t* edict) => (uint)(nuint)edict | 1;
+
+    public void Dispose()
+    {
+        Reset();
+        for (int i = 0; i < _arenaCount; i++)
+            NativeMemory.AlignedFree(_arenas[i].Base);
+        _arenaCount = 0;
+    }
+}
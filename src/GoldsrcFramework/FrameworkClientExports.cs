@@ -1,9 +1,13 @@
 using System.Runtime.CompilerServices;
+using GoldsrcFramework.Commands;
 using GoldsrcFramework.Configuration;
 using GoldsrcFramework.DependencyInjection;
+using GoldsrcFramework.Effects;
 using GoldsrcFramework.Graphics;
 using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Models;
 using GoldsrcFramework.Physics;
+using GoldsrcFramework.Prediction;
 using GoldsrcFramework.Rendering;
 using Microsoft.Extensions.Logging;
 using Microsoft.Extensions.Options;
@@ -23,23 +27,61 @@ public unsafe class FrameworkClientExports : IClientExportFuncs
     private BepuPhysicsDemo? _physicsDemo;
     private double _physicsFrameTime;
     private bool _physicsDemoInitialized;
+    private TempEntitySimulator? _tempEntities;
+    private TriangleBatcher? _triangles;
+    private PredictionRing? _prediction;
+
+    /// <summary>
+    /// Batched TriAPI for HUD_DrawNormalTriangles / HUD_DrawTransparentTriangles, flushed at the end of each;
+    /// null when GameSettings.BatchTriangles is off.
+    /// </summary>
+    protected TriangleBatcher? Triangles => _triangles;
+
+    /// <summary>
+    /// Predicted weapon states by command number (see <see cref="PredictionRing"/>); null when GameSettings.EnablePredictionCache is off.
+    /// </summary>
+    protected PredictionRing? Prediction => _prediction;
 
     // IClientExportFuncs implementation - all based on LegacyClientInterop
     public virtual int Initialize(ClientEngineFuncs* pEnginefuncs, int iVersion)
     {
         EngineApi.ClientApiInit(pEnginefuncs);
+        var settings = GetGameSettings();
+        _tempEntities = settings.ManagedTempEntities ? new TempEntitySimulator(pEnginefuncs) : null;
+        _prediction = settings.EnablePredictionCache ? new PredictionRing() : null;
+        _triangles = settings.BatchTriangles ? new TriangleBatcher() : null;
         return LegacyClientInterop.Initialize(pEnginefuncs, iVersion);
     }
 
     public virtual void HUD_Init()
     {
         LegacyClientInterop.HUD_Init();
+        ConsoleCommands.AddClientCommand("cl_predstats", PredictionStatsCommand);
         InitPhysicsDemo();
     }
 
     public virtual int HUD_VidInit()
     {
-        return LegacyClientInterop.HUD_VidInit();
+        int result = LegacyClientInterop.HUD_VidInit();
+        _prediction?.Reset();
+        PrewarmModels();
+        return result;
+    }
+
+    /// <summary>
+    /// Build the managed data of every precached model on worker threads and load what the engine would load on
+    /// first draw (see <see cref="ModelPrewarm"/>).
+    /// </summary>
+    protected virtual void PrewarmModels()
+    {
+        try
+        {
+            ModelPrewarm.Client();
+        }
+        catch (Exception ex)
+        {
+            System.Diagnostics.Debug.WriteLine($"[ModelPrewarm] Client prewarm failed: {ex.Message}");
+        }
     }
 
     public virtual int HUD_Redraw(float flTime, int intermission)
@@ -50,7 +92,11 @@ public unsafe class FrameworkClientExports : IClientExportFuncs
 
     public virtual int HUD_UpdateClientData(client_data_t* cdata, float flTime)
     {
-        return LegacyClientInterop.HUD_UpdateClientData(cdata, flTime);
+        int result = LegacyClientInterop.HUD_UpdateClientData(cdata, flTime);
+        // Zoom included, for the screen size of studio models (AnimationLod)
+        if (cdata->fov > 0)
+            AnimationLod.FieldOfView = cdata->fov;
+        return result;
     }
 
     public virtual void HUD_Reset()
@@ -143,11 +189,29 @@ public unsafe class FrameworkClientExports : IClientExportFuncs
     {
         LegacyClientInterop.HUD_DrawNormalTriangles();
         DrawPhysicsDemo();
+        FlushTriangles();
     }
 
     public virtual void HUD_DrawTransparentTriangles()
     { 
         LegacyClientInterop.HUD_DrawTransparentTriangles();
+        FlushTriangles();
+    }
+
+    private void FlushTriangles()
+    {
+        if (_triangles == null)
+            return;
+
+        try
+        {
+            _triangles.Flush();
+        }
+        catch (Exception ex)
+        {
+            _triangles.Clear();
+            System.Diagnostics.Debug.WriteLine($"[TriangleBatcher] Flush failed: {ex.Message}");
+        }
     }
 
     public virtual void HUD_StudioEvent(mstudioevent_t* @event, cl_entity_t* entity)
@@ -157,7 +221,13 @@ public unsafe class FrameworkClientExports : IClientExportFuncs
 
     public virtual void HUD_PostRunCmd(local_state_t* from, local_state_t* to, usercmd_t* cmd, int runfuncs, double time, uint random_seed)
     {
+        // Commands already predicted from the same state are answered from the ring instead of the weapon code.
+        var prediction = _prediction;
+        if (prediction != null && prediction.TryReuse(from, to, cmd, runfuncs, time, random_seed))
+            return;
+
         LegacyClientInterop.HUD_PostRunCmd(from, to, cmd, runfuncs, time, random_seed);
+        prediction?.Store(from, to, cmd, time, random_seed);
     }
 
     public virtual void HUD_Shutdown()
@@ -178,6 +248,7 @@ public unsafe class FrameworkClientExports : IClientExportFuncs
     public virtual void HUD_TxferPredictionData(entity_state_t* ps, entity_state_t* pps, clientdata_t* pcd, clientdata_t* ppcd, weapon_data_t* wd, weapon_data_t* pwd)
     {
         LegacyClientInterop.HUD_TxferPredictionData(ps, pps, pcd, ppcd, wd, pwd);
+        _prediction?.Acknowledge(ppcd, pwd);
     }
 
     public virtual void Demo_ReadBuffer(int size, byte* buffer)
@@ -208,7 +279,11 @@ public unsafe class FrameworkClientExports : IClientExportFuncs
 
     public virtual void HUD_TempEntUpdate(double frametime, double client_time, double cl_gravity, TEMPENTITY** ppTempEntFree, TEMPENTITY** ppTempEntActive, delegate* unmanaged[Cdecl]<cl_entity_t*, int> Callback_AddVisibleEntity, delegate* unmanaged[Cdecl]<TEMPENTITY*, float, void> Callback_TempEntPlaySound)
     {
-        LegacyClientInterop.HUD_TempEntUpdate(frametime, client_time, cl_gravity, ppTempEntFree, ppTempEntActive, Callback_AddVisibleEntity, Callback_TempEntPlaySound);
+        // Simulated in managed code when GameSettings.ManagedTempEntities is on; the legacy client's version otherwise.
+        if (_tempEntities != null)
+            _tempEntities.Update(frametime, client_time, cl_gravity, ppTempEntFree, ppTempEntActive, Callback_AddVisibleEntity, Callback_TempEntPlaySound);
+        else
+            LegacyClientInterop.HUD_TempEntUpdate(frametime, client_time, cl_gravity, ppTempEntFree, ppTempEntActive, Callback_AddVisibleEntity, Callback_TempEntPlaySound);
     }
 
     public virtual cl_entity_t* HUD_GetUserEntity(int index)
@@ -247,6 +322,36 @@ public unsafe class FrameworkClientExports : IClientExportFuncs
         return LegacyClientInterop.ClientFactory();
     }
 
+    private static GameSettings GetGameSettings()
+    {
+        var settings = ServiceContainer.IsInitialized
+            ? ServiceContainer.GetServiceOrNull<IOptions<GameSettings>>()?.Value
+            : null;
+        return settings ?? new GameSettings();
+    }
+
+    /// <summary>
+    /// cl_predstats [reset]: print the <see cref="PredictionRing"/> counters.
+    /// </summary>
+    private void PredictionStatsCommand(edict_t* client, CommandArgs args)
+    {
+        if (_prediction == null)
+        {
+            EngineApi.ConsolePrint("Prediction cache is disabled (GameSettings.EnablePredictionCache)\n");
+            return;
+        }
+
+        if (args.Count > 1 && args[1].EqualsIgnoreCase("reset"))
+        {
+            _prediction.ResetStats();
+            return;
+        }
+
+        var s = _prediction.Stats;
+        EngineApi.ConsolePrint($"{s.Passes} passes, {s.Commands} commands: {s.FirstRuns} first runs, {s.Resimulated} re-simulated, {s.Reused} reused\n" +
+                               $"{s.Confirmed} confirmed, {s.Mispredicts} mispredicts (last: {s.LastMispredict ?? "none"})\n");
+    }
+
     #region Physics Demo
 
     private void InitPhysicsDemo()
@@ -295,10 +400,6 @@ public unsafe class FrameworkClientExports : IClientExportFuncs
         if (!_physicsDemoInitialized || _physicsDemo == null)
             return;
 
-        var triApi = EngineApi.PClient->pTriAPI;
-        if (triApi == null)
-            return;
-
         try
         {
             var pos = _physicsDemo.BoxPosition;
@@ -334,19 +435,41 @@ public unsafe class FrameworkClientExports : IClientExportFuncs
             edges[4] = (4, 5); edges[5] = (5, 6); edges[6] = (6, 7); edges[7] = (7, 4); // top face
             edges[8] = (0, 4); edges[9] = (1, 5); edges[10] = (2, 6); edges[11] = (3, 7); // verticals
 
-            triApi->RenderMode(5); // kRenderTransAdd
-            triApi->Color4f(0f, 1f, 0f, 1f); // green
-            triApi->Brightness(1f);
-            triApi->CullFace(TRICULLSTYLE.TRI_NONE);
+            var tri = _triangles;
+            if (tri == null)
+            {
+                var triApi = EngineApi.PClient->pTriAPI;
+                if (triApi == null)
+                    return;
+
+                triApi->RenderMode(5); // kRenderTransAdd
+                triApi->Color4f(0f, 1f, 0f, 1f); // green
+                triApi->Brightness(1f);
+                triApi->CullFace(TRICULLSTYLE.TRI_NONE);
+
+                triApi->Begin(4); // LINES
+                for (int i = 0; i < 12; i++)
+                {
+                    var (a, b) = edges[i];
+                    triApi->Vertex3f(corners[a].X, corners[a].Y, corners[a].Z);
+                    triApi->Vertex3f(corners[b].X, corners[b].Y, corners[b].Z);
+                }
+                triApi->End();
+                return;
+            }
+
+            tri.RenderMode(5); // kRenderTransAdd
+            tri.Color4f(0f, 1f, 0f, 1f); // green
+            tri.CullFace(TRICULLSTYLE.TRI_NONE);
 
-            triApi->Begin(4); // LINES
+            tri.Begin(TriPrimitive.Lines);
             for (int i = 0; i < 12; i++)
             {
                 var (a, b) = edges[i];
-                triApi->Vertex3f(corners[a].X, corners[a].Y, corners[a].Z);
-                triApi->Vertex3f(corners[b].X, corners[b].Y, corners[b].Z);
+                tri.Vertex3f(corners[a].X, corners[a].Y, corners[a].Z);
+                tri.Vertex3f(corners[b].X, corners[b].Y, corners[b].Z);
             }
-            triApi->End();
+            tri.End();
         }
         catch (Exception ex)
         {
@@ -1,6 +1,8 @@
 using GoldsrcFramework.Entity;
 using GoldsrcFramework.Engine.Native;
 using GoldsrcFramework.DependencyInjection;
+using GoldsrcFramework.Strings;
+using NativeInterop;
 using System.Reflection;
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
@@ -24,6 +26,9 @@ namespace GoldsrcFramework
 
         #region Entity System
 
+        // Allocator per class name, so repeated spawns of a class do not marshal its name again
+        private static readonly Utf8Map<IntPtr> _privateDataAllocators = new();
+
         [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
         public static IntPtr GetPrivateDataAllocator(IntPtr pszEntityClassName)
         {
@@ -31,8 +36,13 @@ namespace GoldsrcFramework
             {
                 throw new ArgumentNullException(nameof(pszEntityClassName));
             }
-            var entityClassName = Marshal.PtrToStringUTF8(pszEntityClassName)!;
-            return EntityContext.GetLegacyEntityPrivateDataAllocator(entityClassName);
+            var entityClassName = new Utf8View((NChar*)pszEntityClassName);
+            if (!_privateDataAllocators.TryGetValue(entityClassName, out var allocator))
+            {
+                allocator = EntityContext.GetLegacyEntityPrivateDataAllocator(entityClassName.ToString());
+                _privateDataAllocators.Set(entityClassName, allocator);
+            }
+            return allocator;
         }
 
         #endregion
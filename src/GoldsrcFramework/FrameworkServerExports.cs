@@ -1,6 +1,21 @@
 using System;
+using System.Runtime.CompilerServices;
 using System.Text;
+using GoldsrcFramework.Bsp;
+using GoldsrcFramework.Commands;
+using GoldsrcFramework.Configuration;
+using GoldsrcFramework.Delta;
+using GoldsrcFramework.DependencyInjection;
+using GoldsrcFramework.Entity;
+using GoldsrcFramework.Jobs;
 using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Logging;
+using GoldsrcFramework.Messages;
+using GoldsrcFramework.Models;
+using GoldsrcFramework.Physics;
+using GoldsrcFramework.Strings;
+using GoldsrcFramework.Tick;
+using Microsoft.Extensions.Options;
 using NativeInterop;
 
 namespace GoldsrcFramework.Engine.Native;
@@ -10,27 +25,123 @@ namespace GoldsrcFramework.Engine.Native;
 /// </summary>
 public unsafe class FrameworkServerExports : IServerExportFuncs
 {
+    private PhysicsWorld? _physics;
+    private ParallelTick? _tick;
+    private CommandRouter? _clientCommands;
+    private MapEntities? _mapEntities;
+    private bool _mapEntitiesLoaded;
+    private ServerVisibility? _visibility;
+    private bool _visibilityLoaded;
+    private bool _managedSetupVisibility;
+    private bool _levelEnded;
+    private EntityEncoder? _entityEncoder;
+
+    /// <summary>
+    /// Server physics world, created on first use and torn down at ServerDeactivate.
+    /// Bodies bound to edicts are synced once per StartFrame.
+    /// </summary>
+    protected PhysicsWorld Physics => _physics ??= CreatePhysicsWorld();
+
+    /// <summary>
+    /// Worker-thread tick for registered <see cref="EntityBehaviour"/>s, run at StartFrame.
+    /// Behaviours are cleared at ServerDeactivate.
+    /// </summary>
+    protected ParallelTick EntityTick => _tick ??= new ParallelTick(scheduler: JobScheduler.Shared);
+
+    /// <summary>
+    /// Managed ClientCommand handlers (say, buy, ...), tried before the legacy DLL.
+    /// </summary>
+    protected CommandRouter ClientCommands => _clientCommands ??= new CommandRouter();
+
+    /// <summary>
+    /// Managed instances of the <see cref="MapEntities.Register{T}"/> classes on the current map, built from the
+    /// entity lump when the map starts loading; null without registrations or when the .bsp is not on disk.
+    /// </summary>
+    protected MapEntities? LevelEntities => _mapEntities;
+
+    /// <summary>
+    /// Slab allocator for the private data of managed entities; blocks are recycled in OnFreeEntPrivateData and all
+    /// dropped when the next map starts, after the engine has freed the old level's entities.
+    /// </summary>
+    protected PrivateDataAllocator PrivateData => PrivateDataAllocator.Shared;
+
+    /// <summary>
+    /// Cached PVS / PAS of the current map, entity leafs and each client's view, loaded on first use in a level
+    /// (normally the first SetAbsBox); null unless GameSettings.EnableVisibilityCache is on, or when the .bsp is not on disk.
+    /// </summary>
+    protected ServerVisibility? Visibility
+    {
+        get
+        {
+            if (!_visibilityLoaded)
+            {
+                _visibilityLoaded = true;
+                var settings = GetGameSettings();
+                _managedSetupVisibility = settings.ManagedSetupVisibility;
+                _visibility = settings.EnableVisibilityCache
+                    ? ServerVisibility.LoadCurrentMap(settings.VisibilityCacheKilobytes * 1024)
+                    : null;
+            }
+            return _visibility;
+        }
+    }
+
+    private static GameSettings GetGameSettings()
+    {
+        var settings = ServiceContainer.IsInitialized
+            ? ServiceContainer.GetServiceOrNull<IOptions<GameSettings>>()?.Value
+            : null;
+        return settings ?? new GameSettings();
+    }
+
+    private static PhysicsWorld CreatePhysicsWorld() => PhysicsWorld.FromSettings(GetGameSettings());
+
+    /// <summary>
+    /// Build the managed data of every model precached this level on worker threads (see <see cref="ModelPrewarm"/>).
+    /// </summary>
+    protected virtual void PrewarmModels()
+    {
+        try
+        {
+            ModelPrewarm.Server();
+        }
+        catch (Exception ex)
+        {
+            System.Diagnostics.Debug.WriteLine($"[ModelPrewarm] Server prewarm failed: {ex.Message}");
+        }
+    }
+
+    private static readonly LogTemplate s_calling = AsyncLog.Define(Microsoft.Extensions.Logging.LogLevel.Debug, nameof(FrameworkServerExports), "Calling {Method}");
+
+    // Runs in every engine callback, some per entity per frame. Below Debug it is only the level check; otherwise a
+    // ring write, formatted and printed on the log thread.
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
     private void Log(string methodName)
     {
-        Console.WriteLine($"[FrameworkServerExports] Calling {methodName}");
+        if (AsyncLog.IsEnabled(s_calling.Level))
+            AsyncLog.Write(s_calling, methodName);
     }
 
     // DLL_FUNCTIONS implementation - all based on LegacyServerInterop
     public virtual void GameInit()
     {
         Log(nameof(GameInit));
+        MessageWriter.Batching = GetGameSettings().BatchNetworkMessages;
         LegacyServerInterop.GameInit();
+        ConsoleCommands.AddServerCommand("sv_deltastats", (_, _) => DeltaEncoderRegistry.PrintStatistics());
     }
 
     public virtual int Spawn(edict_t* pent)
     {
         Log(nameof(Spawn));
+        BeginLevel();
         var msgbuf = Encoding.UTF8.GetBytes("hello spawn from framework");
 
         fixed (byte* pDst = msgbuf)
         {
             sbyte* p = (sbyte*)pDst;
         }
+        _mapEntities?.OnSpawn(pent);
         return LegacyServerInterop.Spawn(pent);
     }
 
@@ -61,6 +172,15 @@ public unsafe class FrameworkServerExports : IServerExportFuncs
     public virtual void KeyValue(edict_t* pentKeyvalue, KeyValueData* pkvd)
     {
         Log(nameof(KeyValue));
+        BeginLevel();
+        if (!_mapEntitiesLoaded)
+        {
+            // The first KeyValue of a level is worldspawn's; parse the whole lump once here.
+            _mapEntitiesLoaded = true;
+            _mapEntities = MapEntities.HasRegistrations ? MapEntities.LoadCurrentMap() : null;
+        }
+        if (_mapEntities != null && _mapEntities.TryHandleKeyValue(pentKeyvalue, pkvd))
+            return;
         LegacyServerInterop.KeyValue(pentKeyvalue, pkvd);
     }
 
@@ -80,6 +200,7 @@ public unsafe class FrameworkServerExports : IServerExportFuncs
     {
         Log(nameof(SetAbsBox));
         LegacyServerInterop.SetAbsBox(pent);
+        Visibility?.OnSetAbsBox(pent);
     }
 
     public virtual void SaveWriteFields(SAVERESTOREDATA* pSaveData, NChar* pname, void* pBaseData, TYPEDESCRIPTION* pFields, int fieldCount)
@@ -121,6 +242,7 @@ public unsafe class FrameworkServerExports : IServerExportFuncs
     public virtual void ClientDisconnect(edict_t* pEntity)
     {
         Log(nameof(ClientDisconnect));
+        _visibility?.ResetClient(pEntity);
         LegacyServerInterop.ClientDisconnect(pEntity);
     }
 
@@ -139,6 +261,8 @@ public unsafe class FrameworkServerExports : IServerExportFuncs
     public virtual void ClientCommand(edict_t* pEntity)
     {
         Log(nameof(ClientCommand));
+        if (_clientCommands != null && _clientCommands.TryDispatch(pEntity, CommandArgs.FromServer(EngineApi.PServer)))
+            return;
         LegacyServerInterop.ClientCommand(pEntity);
     }
 
@@ -151,13 +275,38 @@ public unsafe class FrameworkServerExports : IServerExportFuncs
     public virtual void ServerActivate(edict_t* pEdictList, int edictCount, int clientMax)
     {
         Log(nameof(ServerActivate));
+        _mapEntities?.EndLoad();
+        _mapEntitiesLoaded = true;
         LegacyServerInterop.ServerActivate(pEdictList, edictCount, clientMax);
+        PrewarmModels();
     }
 
     public virtual void ServerDeactivate()
     {
         Log(nameof(ServerDeactivate));
+        _physics?.Dispose();
+        _physics = null;
+        _tick?.Clear();
+        _mapEntities = null;
+        _mapEntitiesLoaded = false;
+        _visibility = null;
+        _visibilityLoaded = false;
+        StudioModelCache.Server.Clear();
         LegacyServerInterop.ServerDeactivate();
+        _levelEnded = true;
+    }
+
+    // The old level outlives ServerDeactivate: the engine then frees its entities (SV_ClearEntities calls
+    // OnFreeEntPrivateData) and reads their string_t's and the precache names until the next map spawns. Per-level
+    // memory is dropped at the first entity callback of the next map instead (worldspawn's KeyValue), before anything
+    // of that map is pooled or allocated.
+    private void BeginLevel()
+    {
+        if (!_levelEnded)
+            return;
+        _levelEnded = false;
+        PrivateDataAllocator.Shared.Reset();
+        Utf8StringPool.Level.Reset();
     }
 
     public virtual void PlayerPreThink(edict_t* pEntity)
@@ -175,6 +324,12 @@ public unsafe class FrameworkServerExports : IServerExportFuncs
     public virtual void StartFrame()
     {
         Log(nameof(StartFrame));
+        _physics?.Update(EngineApi.PGlobals->frametime);
+        if (_tick != null && _tick.BehaviourCount > 0)
+        {
+            var globals = EngineApi.PGlobals;
+            _tick.Run(EngineApi.PServer, EngineApi.PServer->PEntityOfEntIndex(0), globals->maxEntities, globals->time, globals->frametime);
+        }
         LegacyServerInterop.StartFrame();
     }
 
@@ -247,7 +402,15 @@ public unsafe class FrameworkServerExports : IServerExportFuncs
     public virtual void SetupVisibility(edict_t* pViewEntity, edict_t* pClient, byte** pvs, byte** pas)
     {
         Log(nameof(SetupVisibility));
+        var visibility = Visibility;
+        if (visibility != null && _managedSetupVisibility)
+        {
+            visibility.SetupVisibility(pViewEntity, pClient, pvs, pas);
+            return;
+        }
+
         LegacyServerInterop.SetupVisibility(pViewEntity, pClient, pvs, pas);
+        visibility?.TrackViewer(pViewEntity, pClient);
     }
 
     public virtual void UpdateClientData(edict_t* ent, int sendweapons, clientdata_t* cd)
@@ -272,6 +435,10 @@ public unsafe class FrameworkServerExports : IServerExportFuncs
     {
         Log(nameof(RegisterEncoders));
         LegacyServerInterop.RegisterEncoders();
+        if (GetGameSettings().ManagedEntityEncoder)
+            DeltaEncoderRegistry.Add(_entityEncoder ??= new EntityEncoder());
+        // Registered after the legacy encoders so managed ones win for the same name.
+        DeltaEncoderRegistry.RegisterAll(EngineApi.PServer);
     }
 
     public virtual int GetWeaponData(edict_t* player, weapon_data_t* info)
@@ -326,6 +493,11 @@ public unsafe class FrameworkServerExports : IServerExportFuncs
     public virtual void OnFreeEntPrivateData(edict_t* pEnt)
     {
         Log(nameof(OnFreeEntPrivateData));
+        _visibility?.OnFree(pEnt);
+
+        // Managed private data has no legacy destructor; recycle it and leave the engine nothing to free.
+        if (PrivateDataAllocator.Shared.Free(pEnt))
+            return;
         LegacyServerInterop.OnFreeEntPrivateData(pEnt);
     }
 
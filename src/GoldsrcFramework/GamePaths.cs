@@ -0,0 +1,68 @@
+using GoldsrcFramework.Strings;
+using NativeInterop;
+
+namespace GoldsrcFramework
+{
+    /// <summary>
+    /// Resolves game-relative paths (maps/x.bsp, models/x.mdl) to loose files the way the engine's search path
+    /// would for files on disk: the mod directory, its _downloads directory, then valve. Files inside paks are not found.
+    /// </summary>
+    internal static unsafe class GamePaths
+    {
+        public static string? Find(string? gameDirectory, string relativePath)
+        {
+            foreach (var dir in new[] { gameDirectory, gameDirectory + "_downloads", "valve" })
+            {
+                if (string.IsNullOrEmpty(dir) || dir == "_downloads")
+                    continue;
+                var path = Path.Combine(dir, relativePath);
+                if (File.Exists(path))
+                    return path;
+            }
+            return null;
+        }
+
+        /// <summary>
+        /// Mod directory as reported by the server engine, or null before GiveFnptrsToDll.
+        /// </summary>
+        public static string? ServerGameDirectory()
+        {
+            var engine = EngineApi.PServer;
+            if (engine == null || engine->GetGameDir == null)
+                return null;
+
+            byte* gameDir = stackalloc byte[260];
+            gameDir[0] = 0;
+            engine->GetGameDir((NChar*)gameDir);
+            return new Utf8View((NChar*)gameDir).ToString();
+        }
+
+        /// <summary>
+        /// maps/&lt;mapname&gt;.bsp of the level the server is running, or null when it is not on disk.
+        /// </summary>
+        public static string? CurrentServerMap()
+        {
+            var globals = EngineApi.PGlobals;
+            if (globals == null)
+                return null;
+
+            var map = new Utf8View((NChar*)((byte*)globals->pStringBase + globals->mapname.Value));
+            if (map.IsEmpty)
+                return null;
+
+            return Find(ServerGameDirectory(), Path.Combine("maps", map.ToString() + ".bsp"));
+        }
+
+        /// <summary>
+        /// Mod directory as reported by the client engine, or null before Initialize.
+        /// </summary>
+        public static string? ClientGameDirectory()
+        {
+            var engine = EngineApi.PClient;
+            if (engine == null || engine->GetGameDirectory == null)
+                return null;
+
+            return new Utf8View(engine->GetGameDirectory()).ToString();
+        }
+    }
+}
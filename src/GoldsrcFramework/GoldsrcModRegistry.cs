@@ -0,0 +1,60 @@
+using System.Reflection;
+using System.Runtime.CompilerServices;
+
+namespace GoldsrcFramework
+{
+    /// <summary>
+    /// Registrations of source-generated mod assemblies. Each one adds itself from its module initializer, which runs
+    /// on first use of the assembly, or at process start when the mod is compiled into the same native image
+    /// </summary>
+    public static class GoldsrcModRegistry
+    {
+        private static readonly object _lock = new object();
+        private static IGoldsrcModRegistration[] _registrations = Array.Empty<IGoldsrcModRegistration>();
+
+        /// <summary>
+        /// Registrations added so far
+        /// </summary>
+        public static IReadOnlyList<IGoldsrcModRegistration> Registrations => Volatile.Read(ref _registrations);
+
+        /// <summary>
+        /// Called by the generated GoldsrcModRegistration
+        /// </summary>
+        public static void Register(IGoldsrcModRegistration registration)
+        {
+            lock (_lock)
+            {
+                if (Array.IndexOf(_registrations, registration) >= 0)
+                    return;
+                var grown = new IGoldsrcModRegistration[_registrations.Length + 1];
+                _registrations.CopyTo(grown, 0);
+                grown[^1] = registration;
+                Volatile.Write(ref _registrations, grown);
+            }
+        }
+
+        /// <summary>
+        /// Get the registration generated into <paramref name="assembly"/>, running its module initializer if that
+        /// has not happened yet. Null if the assembly was built without the generator.
+        /// </summary>
+        public static IGoldsrcModRegistration? For(Assembly assembly)
+        {
+            var registration = Find(assembly);
+            if (registration != null)
+                return registration;
+
+            RuntimeHelpers.RunModuleConstructor(assembly.ManifestModule.ModuleHandle);
+            return Find(assembly);
+        }
+
+        private static IGoldsrcModRegistration? Find(Assembly assembly)
+        {
+            foreach (var registration in Registrations)
+            {
+                if (registration.GetType().Assembly == assembly)
+                    return registration;
+            }
+            return null;
+        }
+    }
+}
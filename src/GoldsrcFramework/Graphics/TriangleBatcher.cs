@@ -0,0 +1,453 @@
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+
+namespace GoldsrcFramework.Graphics;
+
+/// <summary>
+/// Counters from the last <see cref="TriangleBatcher.Flush(triangleapi_t*)"/>.
+/// </summary>
+public struct TriangleBatchStats
+{
+    public int Primitives;
+    public int Vertices;
+    /// <summary>Begin/End pairs after merging.</summary>
+    public int Batches;
+    /// <summary>RenderMode / SpriteTexture / CullFace calls issued.</summary>
+    public int StateChanges;
+    /// <summary>TriAPI calls made by the replay.</summary>
+    public int EngineCalls;
+    /// <summary>TriAPI calls the same geometry costs when drawn one call per vertex attribute.</summary>
+    public int UnbatchedCalls;
+    public int StreamBytes;
+}
+
+/// <summary>
+/// Records TriAPI-style immediate-mode geometry and submits it in one go.
+///
+/// Primitives are kept in a pooled vertex stream. On <see cref="Flush(triangleapi_t*)"/> they are sorted by
+/// render mode / texture / cull state, but only within runs of order-independent modes (normal, additive, glow),
+/// so alpha-blended geometry keeps its submission order. Adjacent triangle / quad / line lists with the same state
+/// merge into one Begin/End, and repeated state, colors and texture coordinates are dropped. Colors and texture
+/// coordinates are only sent once they have been set, so geometry that never calls Color4f / TexCoord2f keeps using
+/// whatever the engine has current, as it would when drawn directly; such primitives are never reordered, so nothing
+/// sorted ahead of them changes what they inherit. The result is an op-stream replayed by the
+/// loader's ReplayTriangleStream, one native transition per flush (see <see cref="TriangleReplay"/>).
+///
+/// Record from HUD_DrawNormalTriangles / HUD_DrawTransparentTriangles on the client thread.
+/// </summary>
+public sealed unsafe class TriangleBatcher
+{
+    private const int kRenderNormal = 0;
+    private const int kRenderGlow = 3;
+    private const int kRenderTransAdd = 5;
+
+    [Flags]
+    private enum Attributes : byte
+    {
+        None = 0,
+        Color = 1,
+        TexCoord = 2,
+        All = Color | TexCoord,
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    private struct Vertex
+    {
+        public float X, Y, Z;
+        public float U, V;
+        public float R, G, B, A;
+        public Attributes Set;
+    }
+
+    private struct Primitive
+    {
+        public int Mode;
+        public int Cull;
+        public int Texture;
+        public TriPrimitive Code;
+        public int VertexStart;
+        public int VertexCount;
+        /// <summary>Attributes every vertex of the primitive set itself.</summary>
+        public Attributes Set;
+    }
+
+    private Vertex[] _vertices = new Vertex[1024];
+    private Primitive[] _primitives = new Primitive[128];
+    private ulong[] _order = new ulong[128];
+    private (nint Sprite, int Frame)[] _textures = new (nint, int)[16];
+    private readonly Dictionary<(nint Sprite, int Frame), int> _textureIds = new();
+    private byte[] _stream = new byte[4096];
+    private int _vertexCount;
+    private int _primitiveCount;
+    private int _length;
+
+    private int _mode;
+    private int _cull;
+    private int _texture = -1;
+    private float _u, _v;
+    private float _r = 1, _g = 1, _b = 1, _a = 1;
+    private Attributes _set;
+    private bool _open;
+    private TriangleBatchStats _stats;
+
+    /// <summary>
+    /// Counters from the last flush.
+    /// </summary>
+    public TriangleBatchStats LastFlush => _stats;
+
+    public int PendingPrimitives => _primitiveCount;
+
+    #region Recording
+
+    public void RenderMode(int mode) => _mode = mode;
+
+    public void CullFace(TRICULLSTYLE style) => _cull = (int)style;
+
+    /// <summary>
+    /// Texture for the following primitives (SpriteTexture).
+    /// </summary>
+    public void SpriteTexture(model_t* sprite, int frame)
+    {
+        if (sprite == null)
+        {
+            _texture = -1;
+            return;
+        }
+
+        // Intern (sprite, frame) so primitives sort on a small id.
+        if (!_textureIds.TryGetValue(((nint)sprite, frame), out _texture))
+        {
+            _texture = _textureIds.Count;
+            if (_texture == _textures.Length)
+                Array.Resize(ref _textures, _textures.Length * 2);
+            _textures[_texture] = ((nint)sprite, frame);
+            _textureIds.Add(((nint)sprite, frame), _texture);
+        }
+    }
+
+    public void Begin(TriPrimitive primitive)
+    {
+        if (_open)
+            throw new InvalidOperationException("TriangleBatcher: Begin called inside an open primitive.");
+        _open = true;
+
+        if (_primitiveCount == _primitives.Length)
+        {
+            Array.Resize(ref _primitives, _primitives.Length * 2);
+            Array.Resize(ref _order, _primitives.Length);
+        }
+
+        _primitives[_primitiveCount] = new Primitive
+        {
+            Mode = _mode,
+            Cull = _cull,
+            Texture = _texture,
+            Code = primitive,
+            VertexStart = _vertexCount,
+        };
+    }
+
+    public void End()
+    {
+        if (!_open)
+            throw new InvalidOperationException("TriangleBatcher: End called without Begin.");
+        _open = false;
+
+        ref var p = ref _primitives[_primitiveCount];
+        p.VertexCount = _vertexCount - p.VertexStart;
+        if (p.VertexCount > 0)
+        {
+            // Attributes only accumulate until the flush, so the first vertex has the fewest.
+            p.Set = _vertices[p.VertexStart].Set;
+            _primitiveCount++;
+        }
+    }
+
+    public void Color4f(float r, float g, float b, float a)
+    {
+        _r = r;
+        _g = g;
+        _b = b;
+        _a = a;
+        _set |= Attributes.Color;
+    }
+
+    public void Color4ub(byte r, byte g, byte b, byte a) => Color4f(r / 255f, g / 255f, b / 255f, a / 255f);
+
+    public void TexCoord2f(float u, float v)
+    {
+        _u = u;
+        _v = v;
+        _set |= Attributes.TexCoord;
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public void Vertex3f(float x, float y, float z)
+    {
+        if (_vertexCount == _vertices.Length)
+            Array.Resize(ref _vertices, _vertices.Length * 2);
+
+        ref var v = ref _vertices[_vertexCount++];
+        v.U = _u;
+        v.V = _v;
+        v.X = x;
+        v.Y = y;
+        v.Z = z;
+        v.R = _r;
+        v.G = _g;
+        v.B = _b;
+        v.A = _a;
+        v.Set = _set;
+    }
+
+    public void Vertex3fv(float* point) => Vertex3f(point[0], point[1], point[2]);
+
+    /// <summary>
+    /// Drop everything recorded since the last flush. Recording state (mode, texture, cull) is kept.
+    /// </summary>
+    public void Clear()
+    {
+        _vertexCount = 0;
+        _primitiveCount = 0;
+        _open = false;
+    }
+
+    #endregion
+
+    /// <summary>
+    /// Submit everything to the client's TriAPI.
+    /// </summary>
+    public void Flush() => Flush(EngineApi.PClient != null ? EngineApi.PClient->pTriAPI : null);
+
+    /// <summary>
+    /// Sort, merge and submit everything recorded, then clear. Leaves the engine in kRenderNormal / TRI_FRONT.
+    /// Color and texture coordinate count as unset again for what is recorded next.
+    /// </summary>
+    public void Flush(triangleapi_t* triApi)
+    {
+        _stats = default;
+        if (_open)
+            throw new InvalidOperationException("TriangleBatcher: Flush called inside an open primitive.");
+
+        if (_primitiveCount == 0 || triApi == null)
+        {
+            Clear();
+            return;
+        }
+
+        SortRuns();
+        Encode();
+        _stats.EngineCalls = TriangleReplay.Replay(triApi, new ReadOnlySpan<byte>(_stream, 0, _length));
+        _stats.StreamBytes = _length;
+
+        Clear();
+        _mode = kRenderNormal;
+        _cull = 0;
+        _set = Attributes.None;
+        ResetTextures();
+    }
+
+    /// <summary>
+    /// Encode the pending primitives without submitting them; for tests and inspection.
+    /// </summary>
+    public ReadOnlySpan<byte> EncodePending()
+    {
+        SortRuns();
+        Encode();
+        return new ReadOnlySpan<byte>(_stream, 0, _length);
+    }
+
+    // Ids are per flush; forget them so a level's worth of sprites does not pile up.
+    private void ResetTextures()
+    {
+        _texture = -1;
+        if (_textureIds.Count > 256)
+        {
+            _textureIds.Clear();
+            Array.Clear(_textures);
+        }
+    }
+
+    private static bool IsOrderIndependent(int mode) => mode is kRenderNormal or kRenderTransAdd or kRenderGlow;
+
+    // A primitive that leaves color or texture coordinate to the engine takes them from whatever was drawn before it,
+    // so it has to stay behind the same geometry.
+    private static bool IsSortable(in Primitive p) => IsOrderIndependent(p.Mode) && p.Set == Attributes.All;
+
+    private static bool IsList(TriPrimitive code) => code is TriPrimitive.Triangles or TriPrimitive.Quads or TriPrimitive.Lines;
+
+    // Sort key: mode | texture | cull | primitive code | submission index. Sorting the keys of a run is a stable
+    // sort of its primitives; the low bits give back the primitive index.
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static ulong SortKey(in Primitive p, int index) =>
+        ((ulong)(uint)p.Mode << 56) |
+        ((ulong)(uint)(p.Texture + 1) << 32) |
+        ((ulong)((uint)p.Cull & 0xF) << 28) |
+        ((ulong)((uint)p.Code & 0xF) << 24) |
+        (uint)index;
+
+    // Sort each maximal run of sortable primitives; alpha-blended ones and those inheriting color or texture
+    // coordinate stay where they are.
+    // Fills _order with primitive indices (low 24 bits) in draw order.
+    private void SortRuns()
+    {
+        if (_primitiveCount > 0xFFFFFF)
+            throw new InvalidOperationException("TriangleBatcher: too many primitives in one flush.");
+
+        var order = _order.AsSpan(0, _primitiveCount);
+        for (int i = 0; i < order.Length; i++)
+            order[i] = SortKey(_primitives[i], i);
+
+        int start = 0;
+        while (start < order.Length)
+        {
+            if (!IsSortable(_primitives[start]))
+            {
+                start++;
+                continue;
+            }
+
+            int end = start + 1;
+            while (end < order.Length && IsSortable(_primitives[end]))
+                end++;
+
+            if (end - start > 1)
+                order[start..end].Sort();
+            start = end;
+        }
+    }
+
+    private void Encode()
+    {
+        // Worst case: every primitive changes all state and every vertex its color and texture coordinate.
+        // Sized once here so the writes below need no capacity checks.
+        long capacity = (long)_primitiveCount * (5 + 5 + 13 + 5 + 1) + (long)_vertexCount * (17 + 9 + 13) + 10;
+        if (capacity > Array.MaxLength)
+            throw new InvalidOperationException("TriangleBatcher: too much geometry in one flush.");
+        if (_stream.Length < capacity)
+            _stream = new byte[Math.Max(_stream.Length * 2, (int)capacity)];
+
+        _length = 0;
+        _stats.Primitives = _primitiveCount;
+        _stats.Vertices = _vertexCount;
+
+        int mode = -1, cull = -1, texture = -1;
+        bool open = false;
+        TriPrimitive openCode = default;
+        float r = float.NaN, g = float.NaN, b = float.NaN, a = float.NaN;
+        float u = float.NaN, tv = float.NaN;
+
+        for (int i = 0; i < _primitiveCount; i++)
+        {
+            ref readonly var p = ref _primitives[(int)(_order[i] & 0xFFFFFF)];
+            bool stateChanged = p.Mode != mode || p.Texture != texture || p.Cull != cull;
+
+            // Each primitive costs RenderMode + SpriteTexture + Begin + End when drawn directly,
+            // plus Vertex3f and whichever of Color4f / TexCoord2f were set, per vertex.
+            _stats.UnbatchedCalls += 4;
+
+            if (open && (stateChanged || !IsList(p.Code) || p.Code != openCode))
+            {
+                WriteOp(TriangleOp.End);
+                open = false;
+            }
+
+            if (p.Mode != mode)
+            {
+                WriteInt(TriangleOp.RenderMode, p.Mode);
+                mode = p.Mode;
+                _stats.StateChanges++;
+            }
+            if (p.Cull != cull)
+            {
+                WriteInt(TriangleOp.CullFace, p.Cull);
+                cull = p.Cull;
+                _stats.StateChanges++;
+            }
+            if (p.Texture != texture)
+            {
+                // Untextured primitives use whatever the engine has bound, as they would when drawn directly.
+                if (p.Texture >= 0)
+                {
+                    var (sprite, frame) = _textures[p.Texture];
+                    ref byte t = ref Reserve(1 + 8 + 4);
+                    t = (byte)TriangleOp.Texture;
+                    Unsafe.WriteUnaligned(ref Unsafe.Add(ref t, 1), (ulong)sprite);
+                    Unsafe.WriteUnaligned(ref Unsafe.Add(ref t, 9), frame);
+                    _stats.StateChanges++;
+                }
+                texture = p.Texture;
+            }
+
+            if (!open)
+            {
+                WriteInt(TriangleOp.Begin, (int)p.Code);
+                open = true;
+                openCode = p.Code;
+                _stats.Batches++;
+            }
+
+            for (int v = p.VertexStart, end = p.VertexStart + p.VertexCount; v < end; v++)
+            {
+                ref readonly var vertex = ref _vertices[v];
+                _stats.UnbatchedCalls += 1 + ((vertex.Set & Attributes.Color) != 0 ? 1 : 0) +
+                                         ((vertex.Set & Attributes.TexCoord) != 0 ? 1 : 0);
+
+                if ((vertex.Set & Attributes.Color) != 0 &&
+                    (vertex.R != r || vertex.G != g || vertex.B != b || vertex.A != a))
+                {
+                    ref byte c = ref Reserve(1 + 16);
+                    c = (byte)TriangleOp.Color;
+                    Unsafe.WriteUnaligned(ref Unsafe.Add(ref c, 1), vertex.R);
+                    Unsafe.WriteUnaligned(ref Unsafe.Add(ref c, 5), vertex.G);
+                    Unsafe.WriteUnaligned(ref Unsafe.Add(ref c, 9), vertex.B);
+                    Unsafe.WriteUnaligned(ref Unsafe.Add(ref c, 13), vertex.A);
+                    (r, g, b, a) = (vertex.R, vertex.G, vertex.B, vertex.A);
+                }
+
+                if ((vertex.Set & Attributes.TexCoord) != 0 && (vertex.U != u || vertex.V != tv))
+                {
+                    ref byte t = ref Reserve(1 + 8);
+                    t = (byte)TriangleOp.TexCoord;
+                    Unsafe.WriteUnaligned(ref Unsafe.Add(ref t, 1), vertex.U);
+                    Unsafe.WriteUnaligned(ref Unsafe.Add(ref t, 5), vertex.V);
+                    (u, tv) = (vertex.U, vertex.V);
+                }
+
+                ref byte o = ref Reserve(1 + 12);
+                o = (byte)TriangleOp.Vertex;
+                Unsafe.CopyBlockUnaligned(ref Unsafe.Add(ref o, 1), ref Unsafe.As<Vertex, byte>(ref Unsafe.AsRef(in vertex)), 12);
+            }
+        }
+
+        if (open)
+            WriteOp(TriangleOp.End);
+
+        // Leave the engine in its default state like a well-behaved HUD_Draw*Triangles.
+        if (mode != kRenderNormal)
+            WriteInt(TriangleOp.RenderMode, kRenderNormal);
+        if (cull != (int)TRICULLSTYLE.TRI_FRONT)
+            WriteInt(TriangleOp.CullFace, (int)TRICULLSTYLE.TRI_FRONT);
+    }
+
+    private void WriteOp(TriangleOp op) => Reserve(1) = (byte)op;
+
+    private void WriteInt(TriangleOp op, int value)
+    {
+        ref byte p = ref Reserve(5);
+        p = (byte)op;
+        Unsafe.WriteUnaligned(ref Unsafe.Add(ref p, 1), value);
+    }
+
+    // Capacity is guaranteed by Encode.
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private ref byte Reserve(int size)
+    {
+        Debug.Assert(_length + size <= _stream.Length);
+        ref byte p = ref Unsafe.Add(ref MemoryMarshal.GetArrayDataReference(_stream), _length);
+        _length += size;
+        return ref p;
+    }
+}
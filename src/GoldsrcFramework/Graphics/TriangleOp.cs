@@ -0,0 +1,39 @@
+namespace GoldsrcFramework.Graphics;
+
+/// <summary>
+/// TriAPI primitive codes (TRI_* in triangleapi.h).
+/// </summary>
+public enum TriPrimitive
+{
+    Triangles = 0,
+    TriangleFan = 1,
+    Quads = 2,
+    Polygon = 3,
+    Lines = 4,
+    TriangleStrip = 5,
+    QuadStrip = 6,
+}
+
+/// <summary>
+/// Opcodes of the stream built by <see cref="TriangleBatcher"/>.
+/// Must match TRI_OP_* in GoldsrcFramework.Loader/loader.cpp.
+///
+/// Layout (native order, unaligned):
+///   RenderMode / Begin / CullFace   int
+///   End     -
+///   Texture uint64 model, int frame
+///   Color   float r, g, b, a
+///   TexCoord float u, v
+///   Vertex  float x, y, z
+/// </summary>
+public enum TriangleOp : byte
+{
+    RenderMode = 1,
+    Begin = 2,
+    End = 3,
+    Texture = 4,
+    Color = 5,
+    Vertex = 6,
+    CullFace = 7,
+    TexCoord = 8,
+}
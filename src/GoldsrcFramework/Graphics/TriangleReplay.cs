@@ -0,0 +1,161 @@
+using System.Buffers.Binary;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+
+namespace GoldsrcFramework.Graphics;
+
+/// <summary>
+/// Plays a <see cref="TriangleBatcher"/> stream back into the client's triangleapi_t.
+///
+/// The loader (gsfloader.dll) exports ReplayTriangleStream, which walks the stream in native code so a whole frame
+/// of batched geometry costs one managed-to-native transition. Without the loader export the stream is replayed from
+/// managed code, one TriAPI call per op.
+/// </summary>
+public static unsafe class TriangleReplay
+{
+    private const string LoaderDll = "gsfloader";
+    private const string ReplayExport = "ReplayTriangleStream";
+
+    private static delegate* unmanaged[Cdecl]<triangleapi_t*, byte*, int, int> _native;
+    private static bool _resolved;
+
+    /// <summary>
+    /// Loader replay entry, or null when running without the native loader.
+    /// </summary>
+    public static delegate* unmanaged[Cdecl]<triangleapi_t*, byte*, int, int> NativeReplay
+    {
+        get
+        {
+            if (!_resolved)
+                Resolve();
+            return _native;
+        }
+        set
+        {
+            _native = value;
+            _resolved = true;
+        }
+    }
+
+    /// <summary>
+    /// Replay <paramref name="stream"/> into <paramref name="triApi"/>. Returns the number of TriAPI calls, or -1 if the stream is malformed.
+    /// </summary>
+    public static int Replay(triangleapi_t* triApi, ReadOnlySpan<byte> stream)
+    {
+        var native = NativeReplay;
+        int calls;
+        fixed (byte* p = stream)
+        {
+            calls = native != null ? native(triApi, p, stream.Length) : ReplayManaged(triApi, stream);
+        }
+
+        if (calls < 0)
+            Debug.WriteLine($"[TriangleReplay] Malformed triangle stream ({stream.Length} bytes)");
+        return calls;
+    }
+
+    /// <summary>
+    /// Managed equivalent of the loader's ReplayTriangleStream.
+    /// </summary>
+    public static int ReplayManaged(triangleapi_t* triApi, ReadOnlySpan<byte> stream)
+    {
+        int calls = 0;
+        int pos = 0;
+        while (pos < stream.Length)
+        {
+            var op = (TriangleOp)stream[pos++];
+            var rest = stream[pos..];
+            switch (op)
+            {
+                case TriangleOp.RenderMode:
+                case TriangleOp.Begin:
+                case TriangleOp.CullFace:
+                {
+                    if (rest.Length < 4)
+                        return -1;
+                    int value = BinaryPrimitives.ReadInt32LittleEndian(rest);
+                    if (op == TriangleOp.RenderMode)
+                        triApi->RenderMode(value);
+                    else if (op == TriangleOp.Begin)
+                        triApi->Begin(value);
+                    else
+                        triApi->CullFace((TRICULLSTYLE)value);
+                    pos += 4;
+                    calls++;
+                    break;
+                }
+                case TriangleOp.End:
+                    triApi->End();
+                    calls++;
+                    break;
+                case TriangleOp.Texture:
+                {
+                    if (rest.Length < 12)
+                        return -1;
+                    var model = (model_t*)(nuint)BinaryPrimitives.ReadUInt64LittleEndian(rest);
+                    triApi->SpriteTexture(model, BinaryPrimitives.ReadInt32LittleEndian(rest[8..]));
+                    pos += 12;
+                    calls++;
+                    break;
+                }
+                case TriangleOp.Color:
+                {
+                    if (rest.Length < 16)
+                        return -1;
+                    triApi->Color4f(
+                        BinaryPrimitives.ReadSingleLittleEndian(rest),
+                        BinaryPrimitives.ReadSingleLittleEndian(rest[4..]),
+                        BinaryPrimitives.ReadSingleLittleEndian(rest[8..]),
+                        BinaryPrimitives.ReadSingleLittleEndian(rest[12..]));
+                    pos += 16;
+                    calls++;
+                    break;
+                }
+                case TriangleOp.TexCoord:
+                {
+                    if (rest.Length < 8)
+                        return -1;
+                    triApi->TexCoord2f(
+                        BinaryPrimitives.ReadSingleLittleEndian(rest),
+                        BinaryPrimitives.ReadSingleLittleEndian(rest[4..]));
+                    pos += 8;
+                    calls++;
+                    break;
+                }
+                case TriangleOp.Vertex:
+                {
+                    if (rest.Length < 12)
+                        return -1;
+                    triApi->Vertex3f(
+                        BinaryPrimitives.ReadSingleLittleEndian(rest),
+                        BinaryPrimitives.ReadSingleLittleEndian(rest[4..]),
+                        BinaryPrimitives.ReadSingleLittleEndian(rest[8..]));
+                    pos += 12;
+                    calls++;
+                    break;
+                }
+                default:
+                    return -1;
+            }
+        }
+        return calls;
+    }
+
+    private static void Resolve()
+    {
+        _resolved = true;
+        try
+        {
+            if (NativeLibrary.TryLoad(LoaderDll, out var module) &&
+                NativeLibrary.TryGetExport(module, ReplayExport, out var export))
+            {
+                _native = (delegate* unmanaged[Cdecl]<triangleapi_t*, byte*, int, int>)export;
+            }
+        }
+        catch (Exception ex)
+        {
+            Debug.WriteLine($"[TriangleReplay] Native replay unavailable: {ex.Message}");
+        }
+    }
+}
@@ -0,0 +1,33 @@
+using GoldsrcFramework.Engine.Native;
+using Microsoft.Extensions.Configuration;
+using Microsoft.Extensions.DependencyInjection;
+
+namespace GoldsrcFramework
+{
+    /// <summary>
+    /// What the framework needs from a mod assembly at startup, emitted by the SDK's source generator
+    /// (GoldsrcModRegistration) so nothing has to be discovered with reflection
+    /// </summary>
+    public interface IGoldsrcModRegistration
+    {
+        /// <summary>
+        /// Create the mod's startup class, or null if it has none
+        /// </summary>
+        IGoldsrcModStartup? CreateStartup();
+
+        /// <summary>
+        /// Create the mod's server exports, or null to use the framework's
+        /// </summary>
+        IServerExportFuncs? CreateServerExports();
+
+        /// <summary>
+        /// Create the mod's client exports, or null to use the framework's
+        /// </summary>
+        IClientExportFuncs? CreateClientExports();
+
+        /// <summary>
+        /// Register the options of the mod's [GoldsrcSettings] classes
+        /// </summary>
+        void ConfigureSettings(IServiceCollection services, IConfiguration configuration);
+    }
+}
@@ -0,0 +1,21 @@
+namespace GoldsrcFramework.Jobs;
+
+/// <summary>
+/// Unit of work for <see cref="JobScheduler.Schedule{T}"/>. Implement on a struct holding what the job needs
+/// (arrays, indices, references to the objects it updates); the scheduler copies it into per-frame storage, so
+/// scheduling does not allocate.
+/// </summary>
+public interface IJob
+{
+    void Execute();
+}
+
+/// <summary>
+/// Data-parallel work for <see cref="JobScheduler.ScheduleParallelFor{T}"/>: called with disjoint [start, end)
+/// batches of [0, length) on any number of threads. Keep the data in arrays or <see cref="Memory{T}"/> and slice
+/// it with the range, e.g. <c>_items.AsSpan(start, end - start)</c>.
+/// </summary>
+public interface IJobRange
+{
+    void Execute(int start, int end);
+}
@@ -0,0 +1,39 @@
+namespace GoldsrcFramework.Jobs;
+
+/// <summary>
+/// Reference to a scheduled job, used to wait for it or to make other jobs depend on it. A plain value: copying
+/// or dropping it costs nothing. <c>default</c> is a job that is already complete, and so is every handle from a
+/// frame that <see cref="JobScheduler.CompleteFrame"/> has closed.
+/// </summary>
+public readonly struct JobHandle
+{
+    internal readonly JobScheduler? Scheduler;
+    internal readonly int Slot;
+    internal readonly int Frame;
+
+    internal JobHandle(JobScheduler scheduler, int slot, int frame)
+    {
+        Scheduler = scheduler;
+        Slot = slot;
+        Frame = frame;
+    }
+
+    public bool IsCompleted => Scheduler == null || Scheduler.IsCompleted(this);
+
+    /// <summary>
+    /// Wait for the job, running other queued jobs meanwhile.
+    /// </summary>
+    public void Complete() => Scheduler?.Complete(this);
+
+    /// <summary>
+    /// Handle that completes when both jobs have.
+    /// </summary>
+    public static JobHandle Combine(JobHandle a, JobHandle b)
+    {
+        if (a.Scheduler == null)
+            return b;
+        if (b.Scheduler == null)
+            return a;
+        return a.Scheduler.CombineDependencies(a, b);
+    }
+}
@@ -0,0 +1,780 @@
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Configuration;
+
+namespace GoldsrcFramework.Jobs;
+
+/// <summary>
+/// Counters of a <see cref="JobScheduler"/> since it was created. Read while jobs run, they are approximate.
+/// </summary>
+public struct JobSchedulerStats
+{
+    /// <summary>Frames closed by <see cref="JobScheduler.CompleteFrame"/>.</summary>
+    public long Frames;
+    /// <summary>Jobs scheduled in closed frames; a parallel-for counts once.</summary>
+    public long Jobs;
+    /// <summary>Jobs run by the scheduling thread because the frame's job slots or a queue were full.</summary>
+    public long Inline;
+    /// <summary>Jobs or parallel-for helpers taken from another thread's queue.</summary>
+    public long Steals;
+    /// <summary>Jobs and batches that threw.</summary>
+    public long Faults;
+    /// <summary>Most jobs scheduled in one frame.</summary>
+    public int PeakJobsPerFrame;
+    /// <summary>Time the main thread spent in <see cref="JobScheduler.CompleteFrame"/>.</summary>
+    public double FenceMilliseconds;
+}
+
+/// <summary>
+/// Frame-synchronous job system on dedicated worker threads, for work the engine thread hands out and needs back
+/// before its callback returns.
+///
+/// Every thread has a work-stealing deque (<see cref="WorkStealingDeque"/>): jobs scheduled from the main thread or
+/// a worker go to the bottom of its own deque and are popped back LIFO, idle threads steal from the top of the
+/// others. Jobs scheduled from any other thread go through a locked queue. A thread that waits on a handle runs
+/// queued jobs instead of blocking. Idle workers spin briefly and then sleep, so the engine thread is not
+/// fought for between frames. The worker threads are only started by the first job scheduled, so a game that never
+/// schedules any pays nothing for the scheduler the framework creates.
+///
+/// With pinning on, the workers are restricted to the processors other than the one the main thread was running on
+/// when they started, and on Windows that processor becomes the main thread's ideal processor. The main thread itself
+/// is not pinned, so this is a placement hint: the OS may still move it onto a worker's processor.
+///
+/// Jobs live in per-frame slots: no allocation per job once each job type has been seen. <see cref="CompleteFrame"/>
+/// (called by the framework at the end of StartFrame and HUD_Redraw) waits for everything scheduled, then recycles
+/// the slots, so a job never outlives the callback that scheduled it. When a frame runs out of slots the job is run
+/// on the spot, after its dependency.
+///
+/// A job that throws is logged and counted in <see cref="JobSchedulerStats.Faults"/>; it still counts as complete,
+/// so its dependents run.
+/// </summary>
+public sealed class JobScheduler : IDisposable
+{
+    /// <summary>
+    /// Job slots per frame.
+    /// </summary>
+    public const int DefaultJobsPerFrame = 4096;
+
+    // How long an idle worker keeps looking for work before it sleeps.
+    private const double SpinMicroseconds = 100;
+    private const int Empty = -1;
+    private const int Sealed = -2;
+
+    // Slots are written by whichever threads run the job: one cache line each.
+    [StructLayout(LayoutKind.Sequential, Size = 64)]
+    private struct Slot
+    {
+        public int Length;
+        public int BatchSize;
+        public int Batches;
+        public int Cursor;        // next batch to hand out
+        public int Remaining;     // batches not finished
+        public int Pending;       // unfinished dependencies, plus one until the job is submitted
+        public int Refs;          // queue entries not run yet; the slot is free when they are
+        public int Continuations; // head of the dependents list, Sealed once the job is done
+    }
+
+    private sealed class Worker
+    {
+        public readonly WorkStealingDeque Deque;
+        public Thread? Thread;
+        public long Steals;
+        private uint _seed;
+
+        public Worker(int capacity, int index)
+        {
+            Deque = new WorkStealingDeque(capacity);
+            _seed = (uint)index * 2654435761u + 1;
+        }
+
+        public int NextVictim(int count)
+        {
+            _seed ^= _seed << 13;
+            _seed ^= _seed >> 17;
+            _seed ^= _seed << 5;
+            return (int)(_seed % (uint)count);
+        }
+    }
+
+    private abstract class JobRunner
+    {
+        public abstract string Name { get; }
+        public abstract void Run(int slot, int start, int end);
+        public abstract void Clear(int slot);
+    }
+
+    private sealed class SingleRunner<T> : JobRunner where T : struct, IJob
+    {
+        public readonly T[] Jobs;
+        public SingleRunner(int capacity) => Jobs = new T[capacity];
+        public override string Name => typeof(T).Name;
+        public override void Run(int slot, int start, int end) => Jobs[slot].Execute();
+        public override void Clear(int slot) => Jobs[slot] = default;
+    }
+
+    private sealed class RangeRunner<T> : JobRunner where T : struct, IJobRange
+    {
+        public readonly T[] Jobs;
+        public RangeRunner(int capacity) => Jobs = new T[capacity];
+        public override string Name => typeof(T).Name;
+        public override void Run(int slot, int start, int end) => Jobs[slot].Execute(start, end);
+        public override void Clear(int slot) => Jobs[slot] = default;
+    }
+
+    private struct NoopJob : IJob
+    {
+        public void Execute() { }
+    }
+
+    private struct ActionJob : IJob
+    {
+        public Action Action;
+        public void Execute() => Action();
+    }
+
+    private struct ActionRangeJob : IJobRange
+    {
+        public Action<int, int> Action;
+        public void Execute(int start, int end) => Action(start, end);
+    }
+
+    private static int s_runnerTypes;
+
+    private static class RunnerId<TRunner>
+    {
+        public static readonly int Value = Interlocked.Increment(ref s_runnerTypes) - 1;
+    }
+
+    private static readonly object s_sharedLock = new();
+    private static JobScheduler? s_shared;
+
+    [ThreadStatic]
+    private static JobScheduler? t_scheduler;
+    [ThreadStatic]
+    private static Worker? t_worker;
+
+    private readonly int _capacity;
+    private readonly Slot[] _slots;
+    private readonly JobRunner?[] _slotRunners;
+    private readonly int[] _nodeTarget;
+    private readonly int[] _nodeNext;
+    private readonly Worker[] _queues;
+    private readonly Worker _home;
+    private readonly Queue<int> _injected;
+    private readonly SemaphoreSlim _wake = new(0, int.MaxValue);
+    private readonly object _runnerLock = new();
+    private readonly object _startLock = new();
+    private readonly long _spinTicks = (long)(Stopwatch.Frequency * SpinMicroseconds / 1_000_000);
+    private readonly bool _pinWorkers;
+    private int _mainProcessor = -1;
+    private int _started;
+
+    private JobRunner?[] _runners = new JobRunner?[8];
+    private int _slotCount;
+    private int _nodeCount;
+    private int _outstanding;
+    private int _frame;
+    private int _injectedCount;
+    private int _sleeping;
+    private long _inline;
+    private long _faults;
+    private long _foreignSteals;
+    private JobSchedulerStats _stats;
+    private volatile bool _disposed;
+
+    /// <summary>
+    /// Create the scheduler; its worker threads start with the first scheduled job. The calling thread becomes the
+    /// scheduler's main thread: the one that calls <see cref="CompleteFrame"/>.
+    /// </summary>
+    /// <param name="workerCount">Worker threads; 0 uses Environment.ProcessorCount - 1, leaving a core to the main thread.</param>
+    /// <param name="jobsPerFrame">Job slots between two <see cref="CompleteFrame"/> calls.</param>
+    /// <param name="pinWorkers">Keep the workers off the processor the main thread is on when they start.</param>
+    public JobScheduler(int workerCount = 0, int jobsPerFrame = DefaultJobsPerFrame, bool pinWorkers = true)
+    {
+        if (workerCount <= 0)
+            workerCount = Math.Max(Environment.ProcessorCount - 1, 1);
+
+        _capacity = Math.Max(jobsPerFrame, 64);
+        _slots = new Slot[_capacity];
+        _slotRunners = new JobRunner?[_capacity];
+        _nodeTarget = new int[_capacity * 2];
+        _nodeNext = new int[_capacity * 2];
+        _injected = new Queue<int>(_capacity);
+        _pinWorkers = pinWorkers;
+
+        _queues = new Worker[workerCount + 1];
+        for (int i = 0; i < _queues.Length; i++)
+            _queues[i] = new Worker(_capacity, i);
+        _home = _queues[workerCount];
+        t_scheduler = this;
+        t_worker = _home;
+    }
+
+    /// <summary>
+    /// Scheduler of the framework, created by ServerMain / ClientMain at Initialize (its workers start on first use);
+    /// null before.
+    /// </summary>
+    public static JobScheduler? Shared => Volatile.Read(ref s_shared);
+
+    /// <summary>
+    /// Create <see cref="Shared"/> from the game settings the first time; later calls return the same scheduler.
+    /// Call on the engine thread.
+    /// </summary>
+    public static JobScheduler EnsureShared(GameSettings? settings)
+    {
+        lock (s_sharedLock)
+        {
+            return s_shared ??= new JobScheduler(settings?.JobWorkerCount ?? 0,
+                                                 settings?.JobsPerFrame ?? DefaultJobsPerFrame,
+                                                 settings?.PinJobWorkers ?? true);
+        }
+    }
+
+    public int WorkerCount => _queues.Length - 1;
+
+    /// <summary>
+    /// Whether the worker threads have been started, i.e. a job was scheduled.
+    /// </summary>
+    public bool IsStarted => Volatile.Read(ref _started) != 0;
+
+    public JobSchedulerStats Stats
+    {
+        get
+        {
+            var stats = _stats;
+            stats.Inline = Interlocked.Read(ref _inline);
+            stats.Faults = Interlocked.Read(ref _faults);
+            stats.Steals = Interlocked.Read(ref _foreignSteals);
+            foreach (var q in _queues)
+                stats.Steals += Volatile.Read(ref q.Steals);
+            return stats;
+        }
+    }
+
+    /// <summary>
+    /// Queue a job to run after <paramref name="dependsOn"/>.
+    /// </summary>
+    public JobHandle Schedule<T>(in T job, JobHandle dependsOn = default) where T : struct, IJob
+    {
+        int slot = AllocateSlot();
+        if (slot < 0)
+        {
+            dependsOn.Complete();
+            Interlocked.Increment(ref _inline);
+            RunInline(job);
+            return default;
+        }
+
+        var runner = GetSingleRunner<T>();
+        runner.Jobs[slot] = job;
+        Prepare(slot, runner, 1, 1, 1);
+        AddDependency(slot, dependsOn);
+        return Submit(slot);
+    }
+
+    /// <summary>
+    /// Queue a delegate. Allocation-free when the delegate is cached.
+    /// </summary>
+    public JobHandle Schedule(Action action, JobHandle dependsOn = default) =>
+        Schedule(new ActionJob { Action = action }, dependsOn);
+
+    /// <summary>
+    /// Queue <paramref name="job"/> over [0, <paramref name="length"/>) in batches, to run after
+    /// <paramref name="dependsOn"/>. Up to one helper per thread takes batches until none are left.
+    /// </summary>
+    /// <param name="batchSize">Items per call; 0 picks about four batches per thread.</param>
+    public JobHandle ScheduleParallelFor<T>(in T job, int length, int batchSize = 0, JobHandle dependsOn = default)
+        where T : struct, IJobRange
+    {
+        if (length <= 0)
+            return dependsOn;
+
+        batchSize = batchSize > 0 ? batchSize : Math.Max(length / (_queues.Length * 4), 1);
+        int batches = (int)(((long)length + batchSize - 1) / batchSize);
+
+        int slot = AllocateSlot();
+        if (slot < 0)
+        {
+            dependsOn.Complete();
+            Interlocked.Increment(ref _inline);
+            RunInline(job, length);
+            return default;
+        }
+
+        var runner = GetRangeRunner<T>();
+        runner.Jobs[slot] = job;
+        Prepare(slot, runner, length, batchSize, Math.Min(batches, _queues.Length));
+        AddDependency(slot, dependsOn);
+        return Submit(slot);
+    }
+
+    /// <summary>
+    /// Run <paramref name="job"/> over [0, <paramref name="length"/>) on the workers and this thread, and return
+    /// when it is done.
+    /// </summary>
+    public void ParallelFor<T>(in T job, int length, int batchSize = 0) where T : struct, IJobRange
+    {
+        if (length <= 0)
+            return;
+        if (_queues.Length == 1 || (batchSize > 0 && length <= batchSize))
+        {
+            RunInline(job, length);
+            return;
+        }
+        ScheduleParallelFor(job, length, batchSize).Complete();
+    }
+
+    /// <summary>
+    /// <see cref="ParallelFor{T}"/> with a delegate taking [start, end). Allocation-free when the delegate is cached.
+    /// </summary>
+    public void ParallelFor(int length, Action<int, int> body, int batchSize = 0) =>
+        ParallelFor(new ActionRangeJob { Action = body }, length, batchSize);
+
+    /// <summary>
+    /// Handle that completes when both jobs have.
+    /// </summary>
+    public JobHandle CombineDependencies(JobHandle a, JobHandle b)
+    {
+        int slot = AllocateSlot();
+        if (slot < 0)
+        {
+            a.Complete();
+            b.Complete();
+            return default;
+        }
+
+        Prepare(slot, GetSingleRunner<NoopJob>(), 1, 1, 1);
+        AddDependency(slot, a);
+        AddDependency(slot, b);
+        return Submit(slot);
+    }
+
+    /// <summary>
+    /// Handle that completes when all of <paramref name="handles"/> have.
+    /// </summary>
+    public JobHandle CombineDependencies(ReadOnlySpan<JobHandle> handles)
+    {
+        int slot = AllocateSlot();
+        if (slot < 0)
+        {
+            foreach (var handle in handles)
+                handle.Complete();
+            return default;
+        }
+
+        Prepare(slot, GetSingleRunner<NoopJob>(), 1, 1, 1);
+        foreach (var handle in handles)
+            AddDependency(slot, handle);
+        return Submit(slot);
+    }
+
+    internal bool IsCompleted(JobHandle handle) =>
+        handle.Frame != Volatile.Read(ref _frame) || Volatile.Read(ref _slots[handle.Slot].Continuations) == Sealed;
+
+    /// <summary>
+    /// Wait for <paramref name="handle"/>, running queued jobs meanwhile.
+    /// </summary>
+    public void Complete(JobHandle handle)
+    {
+        if (handle.Scheduler == null)
+            return;
+        if (handle.Scheduler != this)
+        {
+            handle.Complete();
+            return;
+        }
+        if (!IsCompleted(handle))
+            HelpUntilDone(handle.Slot);
+    }
+
+    /// <summary>
+    /// Frame fence: wait for every job scheduled since the last call, helping the workers, then recycle the job
+    /// slots. Handles from before the call read as complete. Main thread only, with nothing else scheduling.
+    /// </summary>
+    public void CompleteFrame()
+    {
+        long start = Stopwatch.GetTimestamp();
+        if (Volatile.Read(ref _outstanding) != 0)
+            HelpUntilDone(Empty);
+
+        int jobs = _slotCount;
+        if (jobs > 0)
+        {
+            _stats.Jobs += jobs;
+            _stats.PeakJobsPerFrame = Math.Max(_stats.PeakJobsPerFrame, jobs);
+            _slotCount = 0;
+            _nodeCount = 0;
+            Volatile.Write(ref _frame, _frame + 1);
+        }
+        _stats.Frames++;
+        _stats.FenceMilliseconds += Stopwatch.GetElapsedTime(start).TotalMilliseconds;
+    }
+
+    /// <summary>
+    /// Finish the outstanding jobs and stop the workers.
+    /// </summary>
+    public void Dispose()
+    {
+        if (_disposed)
+            return;
+        if (Volatile.Read(ref _outstanding) != 0)
+            HelpUntilDone(Empty);
+
+        lock (_startLock)
+            _disposed = true;
+        _wake.Release(WorkerCount);
+        for (int i = 0; i < WorkerCount; i++)
+            _queues[i].Thread?.Join();
+
+        if (t_scheduler == this)
+        {
+            t_scheduler = null;
+            t_worker = null;
+        }
+        lock (s_sharedLock)
+        {
+            if (s_shared == this)
+                s_shared = null;
+        }
+    }
+
+    // Jobs queued before the threads exist just wait in the queues; whoever completes them helps meanwhile.
+    private void StartWorkers()
+    {
+        lock (_startLock)
+        {
+            if (_started != 0 || _disposed)
+                return;
+
+            // Only the main thread knows where the main thread is.
+            if (_pinWorkers && t_scheduler == this && t_worker == _home)
+            {
+                _mainProcessor = ThreadAffinity.CurrentProcessor();
+                ThreadAffinity.PreferProcessor(_mainProcessor);
+            }
+
+            for (int i = 0; i < WorkerCount; i++)
+            {
+                var worker = _queues[i];
+                worker.Thread = new Thread(WorkerLoop)
+                {
+                    IsBackground = true,
+                    Name = $"GoldsrcFramework Job Worker {i}",
+                };
+                worker.Thread.Start(worker);
+            }
+            Volatile.Write(ref _started, 1);
+        }
+    }
+
+    private int AllocateSlot()
+    {
+        int slot = Interlocked.Increment(ref _slotCount) - 1;
+        return slot < _capacity ? slot : -1;
+    }
+
+    private void Prepare(int slot, JobRunner runner, int length, int batchSize, int copies)
+    {
+        _slotRunners[slot] = runner;
+        ref var s = ref _slots[slot];
+        s.Length = length;
+        s.BatchSize = batchSize;
+        s.Batches = (int)(((long)length + batchSize - 1) / batchSize);
+        s.Cursor = 0;
+        s.Remaining = s.Batches;
+        s.Pending = 1;
+        s.Refs = copies;
+        s.Continuations = Empty;
+        Interlocked.Increment(ref _outstanding);
+    }
+
+    private JobHandle Submit(int slot)
+    {
+        if (Volatile.Read(ref _started) == 0)
+            StartWorkers();
+
+        var handle = new JobHandle(this, slot, Volatile.Read(ref _frame));
+        Release(slot);
+        return handle;
+    }
+
+    // Make the job at `slot` wait for `dependency`.
+    private void AddDependency(int slot, JobHandle dependency)
+    {
+        if (dependency.Scheduler == null)
+            return;
+        if (dependency.Scheduler != this)
+        {
+            dependency.Complete();
+            return;
+        }
+        if (IsCompleted(dependency))
+            return;
+
+        int node = Interlocked.Increment(ref _nodeCount) - 1;
+        if (node >= _nodeNext.Length)
+        {
+            HelpUntilDone(dependency.Slot);
+            return;
+        }
+
+        _nodeTarget[node] = slot;
+        Interlocked.Increment(ref _slots[slot].Pending);
+        ref int head = ref _slots[dependency.Slot].Continuations;
+        while (true)
+        {
+            int first = Volatile.Read(ref head);
+            if (first == Sealed)
+            {
+                // Finished meanwhile. The submit reference keeps Pending above zero here.
+                Interlocked.Decrement(ref _slots[slot].Pending);
+                return;
+            }
+            _nodeNext[node] = first;
+            if (Interlocked.CompareExchange(ref head, node, first) == first)
+                return;
+        }
+    }
+
+    // Drop one reason for the job to wait; queue it when there are none left.
+    private void Release(int slot)
+    {
+        if (Interlocked.Decrement(ref _slots[slot].Pending) != 0)
+            return;
+
+        int copies = _slots[slot].Refs;
+        var self = t_scheduler == this ? t_worker : null;
+        for (int i = 0; i < copies; i++)
+        {
+            if (self == null)
+            {
+                lock (_injected)
+                {
+                    _injected.Enqueue(slot);
+                    _injectedCount++;
+                }
+            }
+            else if (!self.Deque.TryPush(slot))
+            {
+                Interlocked.Increment(ref _inline);
+                Execute(slot);
+            }
+        }
+
+        // Pairs with the barrier in WorkerLoop between announcing sleep and the last look at the queues.
+        Interlocked.MemoryBarrier();
+        int sleeping = Volatile.Read(ref _sleeping);
+        if (sleeping > 0)
+            _wake.Release(Math.Min(copies, sleeping));
+    }
+
+    // Run one queue entry: take batches until there are none left.
+    private void Execute(int slot)
+    {
+        ref var s = ref _slots[slot];
+        int done = 0;
+        while (true)
+        {
+            int batch = Interlocked.Increment(ref s.Cursor) - 1;
+            if (batch >= s.Batches)
+                break;
+
+            int start = batch * s.BatchSize;
+            var runner = _slotRunners[slot]!;
+            try
+            {
+                runner.Run(slot, start, Math.Min(start + s.BatchSize, s.Length));
+            }
+            catch (Exception ex)
+            {
+                Interlocked.Increment(ref _faults);
+                Debug.WriteLine($"[JobScheduler] {runner.Name} threw: {ex}");
+            }
+            done++;
+        }
+
+        if (done > 0 && Interlocked.Add(ref s.Remaining, -done) == 0)
+            Finish(slot);
+        if (Interlocked.Decrement(ref s.Refs) == 0)
+            Interlocked.Decrement(ref _outstanding);
+    }
+
+    private void Finish(int slot)
+    {
+        _slotRunners[slot]!.Clear(slot);
+        int node = Interlocked.Exchange(ref _slots[slot].Continuations, Sealed);
+        while (node >= 0)
+        {
+            int next = _nodeNext[node];
+            Release(_nodeTarget[node]);
+            node = next;
+        }
+    }
+
+    // Run queued jobs until `slot` is done, or until nothing is outstanding when `slot` is Empty.
+    private void HelpUntilDone(int slot)
+    {
+        var self = t_scheduler == this ? t_worker : null;
+        var spin = new SpinWait();
+        while (slot == Empty
+                   ? Volatile.Read(ref _outstanding) != 0
+                   : Volatile.Read(ref _slots[slot].Continuations) != Sealed)
+        {
+            if (TryTake(self, out int next))
+            {
+                Execute(next);
+                spin = default;
+            }
+            else
+            {
+                spin.SpinOnce(sleep1Threshold: -1);
+            }
+        }
+    }
+
+    private bool TryTake(Worker? self, out int slot)
+    {
+        if (self != null && self.Deque.TryPop(out slot))
+            return true;
+
+        if (Volatile.Read(ref _injectedCount) > 0)
+        {
+            lock (_injected)
+            {
+                if (_injected.TryDequeue(out slot))
+                {
+                    _injectedCount--;
+                    return true;
+                }
+            }
+        }
+
+        int count = _queues.Length;
+        int first = self?.NextVictim(count) ?? 0;
+        for (int i = 0; i < count; i++)
+        {
+            var victim = _queues[(first + i) % count];
+            if (victim != self && victim.Deque.TrySteal(out slot))
+            {
+                if (self != null)
+                    Volatile.Write(ref self.Steals, self.Steals + 1);
+                else
+                    Interlocked.Increment(ref _foreignSteals);
+                return true;
+            }
+        }
+
+        slot = 0;
+        return false;
+    }
+
+    private void WorkerLoop(object? state)
+    {
+        var self = (Worker)state!;
+        t_scheduler = this;
+        t_worker = self;
+        if (_pinWorkers)
+            ThreadAffinity.ExcludeProcessor(_mainProcessor);
+
+        while (!_disposed)
+        {
+            if (TryTake(self, out int slot))
+            {
+                Execute(slot);
+                continue;
+            }
+
+            // Jobs come in bursts within a frame: keep looking for a moment before paying for a wake-up.
+            bool found = false;
+            long until = Stopwatch.GetTimestamp() + _spinTicks;
+            var spin = new SpinWait();
+            while (Stopwatch.GetTimestamp() < until)
+            {
+                spin.SpinOnce(sleep1Threshold: -1);
+                if (TryTake(self, out slot))
+                {
+                    Execute(slot);
+                    found = true;
+                    break;
+                }
+            }
+            if (found)
+                continue;
+
+            Interlocked.Increment(ref _sleeping);
+            if (TryTake(self, out slot))
+            {
+                Interlocked.Decrement(ref _sleeping);
+                Execute(slot);
+                continue;
+            }
+            if (!_disposed)
+                _wake.Wait();
+            Interlocked.Decrement(ref _sleeping);
+        }
+    }
+
+    private void RunInline<T>(in T job) where T : struct, IJob
+    {
+        try
+        {
+            var copy = job;
+            copy.Execute();
+        }
+        catch (Exception ex)
+        {
+            Interlocked.Increment(ref _faults);
+            Debug.WriteLine($"[JobScheduler] {typeof(T).Name} threw: {ex}");
+        }
+    }
+
+    private void RunInline<T>(in T job, int length) where T : struct, IJobRange
+    {
+        try
+        {
+            var copy = job;
+            copy.Execute(0, length);
+        }
+        catch (Exception ex)
+        {
+            Interlocked.Increment(ref _faults);
+            Debug.WriteLine($"[JobScheduler] {typeof(T).Name} threw: {ex}");
+        }
+    }
+
+    private SingleRunner<T> GetSingleRunner<T>() where T : struct, IJob
+    {
+        int id = RunnerId<SingleRunner<T>>.Value;
+        var runners = Volatile.Read(ref _runners);
+        if (id < runners.Length && runners[id] is SingleRunner<T> runner)
+            return runner;
+        return (SingleRunner<T>)AddRunner(id, () => new SingleRunner<T>(_capacity));
+    }
+
+    private RangeRunner<T> GetRangeRunner<T>() where T : struct, IJobRange
+    {
+        int id = RunnerId<RangeRunner<T>>.Value;
+        var runners = Volatile.Read(ref _runners);
+        if (id < runners.Length && runners[id] is RangeRunner<T> runner)
+            return runner;
+        return (RangeRunner<T>)AddRunner(id, () => new RangeRunner<T>(_capacity));
+    }
+
+    // First use of a job type: the only allocation on the scheduling path.
+    private JobRunner AddRunner(int id, Func<JobRunner> create)
+    {
+        lock (_runnerLock)
+        {
+            var runners = _runners;
+            if (id < runners.Length && runners[id] is { } existing)
+                return existing;
+
+            if (id >= runners.Length)
+                Array.Resize(ref runners, Math.Max(id + 1, runners.Length * 2));
+            var runner = create();
+            runners[id] = runner;
+            Volatile.Write(ref _runners, runners);
+            return runner;
+        }
+    }
+}
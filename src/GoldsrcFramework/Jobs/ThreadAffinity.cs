@@ -0,0 +1,94 @@
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+
+namespace GoldsrcFramework.Jobs;
+
+/// <summary>
+/// Best-effort thread placement for <see cref="JobScheduler"/> workers: keep them off the processor the engine thread
+/// was on when they started. Only the workers are restricted; the engine thread is at most given that processor as
+/// its ideal one (Windows), so the OS may still schedule it elsewhere. Windows and Linux only; anything that fails
+/// leaves the thread where the OS put it.
+/// </summary>
+internal static unsafe class ThreadAffinity
+{
+    [DllImport("kernel32.dll", CallingConvention = CallingConvention.Winapi)]
+    private static extern nint GetCurrentThread();
+
+    [DllImport("kernel32.dll", CallingConvention = CallingConvention.Winapi)]
+    private static extern int GetCurrentProcessorNumber();
+
+    [DllImport("kernel32.dll", CallingConvention = CallingConvention.Winapi)]
+    private static extern nuint SetThreadAffinityMask(nint thread, nuint mask);
+
+    [DllImport("kernel32.dll", CallingConvention = CallingConvention.Winapi)]
+    private static extern int SetThreadIdealProcessor(nint thread, int processor);
+
+    [DllImport("libc", EntryPoint = "sched_getcpu")]
+    private static extern int SchedGetCpu();
+
+    [DllImport("libc", EntryPoint = "sched_setaffinity")]
+    private static extern int SchedSetAffinity(int pid, nuint size, ulong* mask);
+
+    /// <summary>
+    /// Processor the calling thread is running on, or -1.
+    /// </summary>
+    public static int CurrentProcessor()
+    {
+        try
+        {
+            if (OperatingSystem.IsWindows())
+                return GetCurrentProcessorNumber();
+            if (OperatingSystem.IsLinux())
+                return SchedGetCpu();
+        }
+        catch (Exception ex) when (ex is DllNotFoundException or EntryPointNotFoundException)
+        {
+        }
+        return -1;
+    }
+
+    /// <summary>
+    /// Prefer <paramref name="processor"/> for the calling thread without pinning it (Windows only).
+    /// </summary>
+    public static void PreferProcessor(int processor)
+    {
+        if (processor < 0 || !OperatingSystem.IsWindows())
+            return;
+        try
+        {
+            SetThreadIdealProcessor(GetCurrentThread(), processor);
+        }
+        catch (Exception ex) when (ex is DllNotFoundException or EntryPointNotFoundException)
+        {
+        }
+    }
+
+    /// <summary>
+    /// Restrict the calling thread to the processors of the process except <paramref name="processor"/>.
+    /// Skipped when that would leave nothing, or when the machine has more processors than one mask holds.
+    /// </summary>
+    public static bool ExcludeProcessor(int processor)
+    {
+        int bits = Math.Min(IntPtr.Size * 8, 64);
+        if (processor < 0 || processor >= bits || Environment.ProcessorCount < 2 || Environment.ProcessorCount > bits)
+            return false;
+        if (!OperatingSystem.IsWindows() && !OperatingSystem.IsLinux())
+            return false;
+
+        try
+        {
+            ulong mask = (ulong)(long)Process.GetCurrentProcess().ProcessorAffinity & ~(1UL << processor);
+            if (mask == 0)
+                return false;
+
+            if (OperatingSystem.IsWindows())
+                return SetThreadAffinityMask(GetCurrentThread(), (nuint)mask) != 0;
+            return SchedSetAffinity(0, sizeof(ulong), &mask) == 0;
+        }
+        catch (Exception ex) when (ex is DllNotFoundException or EntryPointNotFoundException or PlatformNotSupportedException or InvalidOperationException)
+        {
+            Debug.WriteLine($"[JobScheduler] Thread affinity not set: {ex.Message}");
+        }
+        return false;
+    }
+}
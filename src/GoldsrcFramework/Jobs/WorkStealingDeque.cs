@@ -0,0 +1,99 @@
+using System.Numerics;
+using System.Runtime.InteropServices;
+
+namespace GoldsrcFramework.Jobs;
+
+/// <summary>
+/// Bounded Chase-Lev deque of job slots. The owning thread pushes and pops at the bottom (LIFO, cache-warm);
+/// any other thread steals from the top (FIFO, the oldest and usually largest work). Never allocates after
+/// construction; a full deque rejects the push and the caller runs the job itself.
+/// </summary>
+internal sealed class WorkStealingDeque
+{
+    private readonly int[] _items;
+    private readonly int _mask;
+    private Indices _indices;
+
+    // Top is written by thieves, bottom by the owner: keep them on separate cache lines.
+    [StructLayout(LayoutKind.Explicit, Size = 192)]
+    private struct Indices
+    {
+        [FieldOffset(64)] public long Top;
+        [FieldOffset(128)] public long Bottom;
+    }
+
+    public WorkStealingDeque(int capacity)
+    {
+        _items = new int[(int)BitOperations.RoundUpToPowerOf2((uint)Math.Max(capacity, 16))];
+        _mask = _items.Length - 1;
+    }
+
+    public int Capacity => _items.Length;
+
+    /// <summary>
+    /// Approximate number of items; exact when no other thread is using the deque.
+    /// </summary>
+    public int Count => (int)Math.Max(Volatile.Read(ref _indices.Bottom) - Volatile.Read(ref _indices.Top), 0);
+
+    /// <summary>
+    /// Owner only.
+    /// </summary>
+    public bool TryPush(int item)
+    {
+        long b = Volatile.Read(ref _indices.Bottom);
+        long t = Volatile.Read(ref _indices.Top);
+        if (b - t >= _items.Length)
+            return false;
+
+        _items[b & _mask] = item;
+        Volatile.Write(ref _indices.Bottom, b + 1);
+        return true;
+    }
+
+    /// <summary>
+    /// Owner only.
+    /// </summary>
+    public bool TryPop(out int item)
+    {
+        long b = Volatile.Read(ref _indices.Bottom) - 1;
+        // Full fence: the new bottom must be visible before top is read, or a thief and the owner can both take the last item.
+        Interlocked.Exchange(ref _indices.Bottom, b);
+        long t = Volatile.Read(ref _indices.Top);
+
+        if (t > b)
+        {
+            Volatile.Write(ref _indices.Bottom, t);
+            item = 0;
+            return false;
+        }
+
+        item = _items[b & _mask];
+        if (t == b)
+        {
+            // Last item: race the thieves for it.
+            bool won = Interlocked.CompareExchange(ref _indices.Top, t + 1, t) == t;
+            Volatile.Write(ref _indices.Bottom, t + 1);
+            return won;
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// Any thread.
+    /// </summary>
+    public bool TrySteal(out int item)
+    {
+        long t = Volatile.Read(ref _indices.Top);
+        Interlocked.MemoryBarrier();
+        long b = Volatile.Read(ref _indices.Bottom);
+
+        if (t < b)
+        {
+            item = _items[t & _mask];
+            if (Interlocked.CompareExchange(ref _indices.Top, t + 1, t) == t)
+                return true;
+        }
+        item = 0;
+        return false;
+    }
+}
@@ -1,5 +1,7 @@
 using GoldsrcFramework.Engine.Native;
 using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Models;
+using GoldsrcFramework.Strings;
 using NativeInterop;
 using System.Diagnostics;
 using System.Runtime.CompilerServices;
@@ -23,9 +25,11 @@ namespace GoldsrcFramework
         private static ServerEngineFuncs* _patchedEngineFuncs = null;
         private static IntPtr _legacyServerModule = IntPtr.Zero;
         private static readonly object _legacyModuleLock = new();
-        private static readonly Dictionary<string, nuint> _legacyNameToFunction = new(StringComparer.Ordinal);
+        // 按原始名和规范化名两种 key 存放，可直接用引擎传入的 NChar* 查找
+        private static readonly Utf8Map<nuint> _legacyNameToFunction = new(capacity: 1024);
         private static readonly Dictionary<nuint, IntPtr> _legacyFunctionToName = new();
-        private static readonly Dictionary<string, IntPtr> _utf8StringCache = new(StringComparer.Ordinal);
+        // 引擎原始的 PrecacheModel，legacy DLL 的调用经由 LegacyPrecacheModel 记录后转发
+        private static delegate* unmanaged[Cdecl]<NChar*, int> _enginePrecacheModel;
 
         // 声明原版 hl.dll 的导出函数
         /// <summary>
@@ -85,6 +89,17 @@ namespace GoldsrcFramework
             }
         }
 
+        /// <summary>
+        /// 使用现成的函数表代替 libserver.dll，供离线回放（Replay/MockEngine）使用
+        /// </summary>
+        internal static void Attach(ServerExportFuncs* api, ServerNewExportFuncs* newApi)
+        {
+            if (LegacyServerApiPtr is not null)
+                return;
+
+            LegacyServerApiPtr = api;
+            LegacyServerNewApiPtr = newApi;
+        }
 
         private static void EnsureLegacyModuleLoaded()
         {
@@ -110,6 +125,8 @@ namespace GoldsrcFramework
             Buffer.MemoryCopy(source, _patchedEngineFuncs, sizeof(ServerEngineFuncs), sizeof(ServerEngineFuncs));
             _patchedEngineFuncs->FunctionFromName = &LegacyFunctionFromName;
             _patchedEngineFuncs->NameForFunction = &LegacyNameForFunction;
+            _enginePrecacheModel = source->PrecacheModel;
+            _patchedEngineFuncs->PrecacheModel = &LegacyPrecacheModel;
             return _patchedEngineFuncs;
         }
 
@@ -148,8 +165,8 @@ namespace GoldsrcFramework
                 if (nameRva == 0)
                     continue;
 
-                string? rawName = Marshal.PtrToStringUTF8((IntPtr)(basePtr + nameRva));
-                if (string.IsNullOrEmpty(rawName))
+                var rawName = new Utf8View((NChar*)(basePtr + nameRva));
+                if (rawName.IsEmpty)
                     continue;
 
                 ushort ordinal = *(ushort*)(basePtr + addressOfOrdinals + i * 2);
@@ -161,14 +178,14 @@ namespace GoldsrcFramework
                 if (functionRva >= exportRva && functionRva < exportRva + exportSize)
                     continue;
 
-                string normalizedName = NormalizeFunctionName(rawName);
+                string normalizedName = NormalizeFunctionName(rawName.ToString());
                 nuint functionAddress = (nuint)(basePtr + functionRva);
 
-                if (!_legacyNameToFunction.ContainsKey(normalizedName))
-                    _legacyNameToFunction.Add(normalizedName, functionAddress);
+                _legacyNameToFunction.TryAdd(rawName, functionAddress);
+                _legacyNameToFunction.TryAdd(normalizedName, functionAddress);
 
                 if (!_legacyFunctionToName.ContainsKey(functionAddress))
-                    _legacyFunctionToName.Add(functionAddress, GetCachedUtf8String(normalizedName));
+                    _legacyFunctionToName.Add(functionAddress, (IntPtr)Utf8StringPool.Shared.Intern(normalizedName));
             }
         }
 
@@ -184,33 +201,24 @@ namespace GoldsrcFramework
             return name;
         }
 
-        private static IntPtr GetCachedUtf8String(string text)
-        {
-            if (_utf8StringCache.TryGetValue(text, out var cached))
-                return cached;
-
-            byte[] bytes = Encoding.UTF8.GetBytes(text);
-            IntPtr memory = Marshal.AllocHGlobal(bytes.Length + 1);
-            Marshal.Copy(bytes, 0, memory, bytes.Length);
-            Marshal.WriteByte(memory, bytes.Length, 0);
-            _utf8StringCache[text] = memory;
-            return memory;
-        }
-
         [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
         private static uint LegacyFunctionFromName(NChar* pName)
         {
             if (pName == null)
                 return 0;
 
-            string name = Marshal.PtrToStringUTF8((IntPtr)pName) ?? string.Empty;
-            if (name.Length == 0)
+            var view = new Utf8View(pName);
+            if (view.IsEmpty)
                 return 0;
 
             EnsureLegacyModuleLoaded();
 
+            if (_legacyNameToFunction.TryGetValue(view, out var address))
+                return unchecked((uint)address);
+
+            string name = view.ToString();
             string normalized = NormalizeFunctionName(name);
-            if (_legacyNameToFunction.TryGetValue(normalized, out var address))
+            if (_legacyNameToFunction.TryGetValue(new Utf8View(Encoding.UTF8.GetBytes(normalized)), out address))
                 return unchecked((uint)address);
 
             if (NativeLibrary.TryGetExport(_legacyServerModule, normalized, out var exact))
@@ -236,6 +244,15 @@ namespace GoldsrcFramework
             return null;
         }
 
+        // 记录关卡加载时预缓存的模型，供 ServerActivate 时的 ModelPrewarm 使用
+        [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+        private static int LegacyPrecacheModel(NChar* s)
+        {
+            if (s != null)
+                StudioModelCache.Server.NotePrecache(s);
+            return _enginePrecacheModel(s);
+        }
+
         // DLL_FUNCTIONS 静态转发方法
         public static void GameInit() => LegacyServerApiPtr->GameDLLInit();
 
@@ -0,0 +1,529 @@
+using System.Diagnostics;
+using System.Diagnostics.CodeAnalysis;
+using System.Globalization;
+using System.Runtime.CompilerServices;
+using Microsoft.Extensions.Logging;
+
+namespace GoldsrcFramework.Logging;
+
+/// <summary>
+/// Counters of <see cref="AsyncLog"/> since start.
+/// </summary>
+public readonly record struct AsyncLogStats(long Written, long Dropped, long Drained, int Threads, int Templates);
+
+/// <summary>
+/// Logger for engine callbacks and other game-thread code that must not block or format.
+///
+/// A call checks the level, then copies the template id, a timestamp and the arguments into the calling thread's
+/// ring (<see cref="LogRing"/>): no locks, no allocation, no string work. A background thread drains every ring,
+/// formats the lines and writes them to the configured sinks in batches. When it falls behind, records are dropped
+/// and counted instead of stalling the caller; the drop count is reported in the log itself.
+///
+/// <code>
+/// static readonly LogTemplate Spawned = AsyncLog.Define(LogLevel.Debug, "Spawn", "{Class} at {X:F1} {Y:F1} {Z:F1}");
+/// AsyncLog.Write(Spawned, classname, origin.X, origin.Y, origin.Z);
+/// </code>
+///
+/// Value arguments of primitive and enum types are stored as bits; strings and other references are stored by
+/// reference and formatted on the log thread, so they must not be mutated afterwards. Other structs are boxed.
+/// </summary>
+public static class AsyncLog
+{
+    /// <summary>
+    /// Records per thread ring.
+    /// </summary>
+    public const int DefaultRingCapacity = 8192;
+
+    private static readonly object s_lock = new();
+    private static readonly object s_drainLock = new();
+    private static readonly AutoResetEvent s_wake = new(false);
+    private static LogTemplateInfo[] s_templates = new LogTemplateInfo[64];
+    private static int s_templateCount;
+    private static LogRing[] s_rings = Array.Empty<LogRing>();
+    private static ILogSink[] s_sinks = Array.Empty<ILogSink>();
+    private static LogLevel s_minimumLevel = LogLevel.None;
+    private static int s_ringCapacity = DefaultRingCapacity;
+    private static Thread? s_thread;
+    private static volatile bool s_stopping;
+    private static bool s_exitHooked;
+    private static long s_drained;
+    private static long s_reportedDrops;
+    private static long s_retiredWritten;
+    private static long s_retiredDropped;
+    private static long s_unknownTemplates;
+    private static readonly long s_startTimestamp = Stopwatch.GetTimestamp();
+    private static readonly DateTime s_startTime = DateTime.Now;
+
+    [ThreadStatic]
+    private static LogRing? t_ring;
+
+    /// <summary>
+    /// Records below this level are discarded at the call site. <see cref="LogLevel.None"/> (everything off) until
+    /// <see cref="Start"/>.
+    /// </summary>
+    public static LogLevel MinimumLevel => s_minimumLevel;
+
+    public static bool IsRunning => s_thread != null;
+
+    /// <summary>
+    /// How long the log thread sleeps when every ring is empty.
+    /// </summary>
+    public static TimeSpan DrainInterval { get; set; } = TimeSpan.FromMilliseconds(10);
+
+    /// <summary>
+    /// Start the log thread writing to <paramref name="sinks"/>. Calling again replaces the sinks and level.
+    /// </summary>
+    public static void Start(LogLevel minimumLevel, IEnumerable<ILogSink> sinks, int ringCapacity = DefaultRingCapacity)
+    {
+        lock (s_lock)
+        {
+            Flush();
+            lock (s_drainLock)
+            {
+                foreach (var sink in s_sinks)
+                    sink.Dispose();
+                s_sinks = sinks.ToArray();
+            }
+            s_ringCapacity = ringCapacity;
+            s_minimumLevel = minimumLevel;
+
+            if (s_thread == null)
+            {
+                s_stopping = false;
+                s_thread = new Thread(DrainLoop)
+                {
+                    Name = "GoldsrcFramework log",
+                    IsBackground = true,
+                    Priority = ThreadPriority.BelowNormal,
+                };
+                s_thread.Start();
+            }
+            if (!s_exitHooked)
+            {
+                s_exitHooked = true;
+                AppDomain.CurrentDomain.ProcessExit += (_, _) => Stop();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Drain what is left, stop the log thread and close the sinks.
+    /// </summary>
+    public static void Stop()
+    {
+        Thread? thread;
+        lock (s_lock)
+        {
+            thread = s_thread;
+            s_thread = null;
+            s_minimumLevel = LogLevel.None;
+            s_stopping = true;
+        }
+        if (thread == null)
+            return;
+
+        s_wake.Set();
+        thread.Join(TimeSpan.FromSeconds(2));
+        lock (s_drainLock)
+        {
+            DrainAll();
+            foreach (var sink in s_sinks)
+                sink.Dispose();
+            s_sinks = Array.Empty<ILogSink>();
+        }
+    }
+
+    /// <summary>
+    /// Write out everything logged so far, on the calling thread. For shutdown and crash paths.
+    /// </summary>
+    public static void Flush()
+    {
+        lock (s_drainLock)
+            DrainAll();
+    }
+
+    public static AsyncLogStats Stats
+    {
+        get
+        {
+            long written = Volatile.Read(ref s_retiredWritten);
+            long dropped = Volatile.Read(ref s_retiredDropped) + Volatile.Read(ref s_unknownTemplates);
+            var rings = Volatile.Read(ref s_rings);
+            foreach (var ring in rings)
+            {
+                written += ring.Written;
+                dropped += ring.Dropped;
+            }
+            return new AsyncLogStats(written, dropped, Interlocked.Read(ref s_drained), rings.Length, Volatile.Read(ref s_templateCount));
+        }
+    }
+
+    /// <summary>
+    /// Register a message template. Do this once (a static readonly field) and log through the handle.
+    /// </summary>
+    public static LogTemplate Define(LogLevel level, string category, string format)
+    {
+        var info = new LogTemplateInfo(level, category, format);
+        lock (s_lock)
+        {
+            if (s_templateCount == s_templates.Length)
+            {
+                var grown = new LogTemplateInfo[s_templates.Length * 2];
+                Array.Copy(s_templates, grown, s_templateCount);
+                Volatile.Write(ref s_templates, grown);
+            }
+            s_templates[s_templateCount] = info;
+            Volatile.Write(ref s_templateCount, s_templateCount + 1);
+            return new LogTemplate(s_templateCount - 1, level);
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public static bool IsEnabled(LogLevel level) => level >= s_minimumLevel && level != LogLevel.None;
+
+    public static void Write(LogTemplate template)
+    {
+        if (!IsEnabled(template.Level))
+            return;
+        ref var record = ref Begin(template, out var ring);
+        if (Unsafe.IsNullRef(ref record))
+            return;
+        ring.Commit();
+    }
+
+    public static void Write<T0>(LogTemplate template, T0 arg0)
+    {
+        if (!IsEnabled(template.Level))
+            return;
+        ref var record = ref Begin(template, out var ring);
+        if (Unsafe.IsNullRef(ref record))
+            return;
+        Put(ref record, 0, arg0);
+        ring.Commit();
+    }
+
+    public static void Write<T0, T1>(LogTemplate template, T0 arg0, T1 arg1)
+    {
+        if (!IsEnabled(template.Level))
+            return;
+        ref var record = ref Begin(template, out var ring);
+        if (Unsafe.IsNullRef(ref record))
+            return;
+        Put(ref record, 0, arg0);
+        Put(ref record, 1, arg1);
+        ring.Commit();
+    }
+
+    public static void Write<T0, T1, T2>(LogTemplate template, T0 arg0, T1 arg1, T2 arg2)
+    {
+        if (!IsEnabled(template.Level))
+            return;
+        ref var record = ref Begin(template, out var ring);
+        if (Unsafe.IsNullRef(ref record))
+            return;
+        Put(ref record, 0, arg0);
+        Put(ref record, 1, arg1);
+        Put(ref record, 2, arg2);
+        ring.Commit();
+    }
+
+    public static void Write<T0, T1, T2, T3>(LogTemplate template, T0 arg0, T1 arg1, T2 arg2, T3 arg3)
+    {
+        if (!IsEnabled(template.Level))
+            return;
+        ref var record = ref Begin(template, out var ring);
+        if (Unsafe.IsNullRef(ref record))
+            return;
+        Put(ref record, 0, arg0);
+        Put(ref record, 1, arg1);
+        Put(ref record, 2, arg2);
+        Put(ref record, 3, arg3);
+        ring.Commit();
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static ref LogRecord Begin(LogTemplate template, out LogRing ring)
+    {
+        ring = t_ring ?? CreateRing();
+        ref var record = ref ring.TryBeginWrite();
+        if (!Unsafe.IsNullRef(ref record))
+        {
+            record.Timestamp = Stopwatch.GetTimestamp();
+            record.Template = template.Id;
+            record.Types = 0;
+        }
+        return ref record;
+    }
+
+    // typeof(T) tests are constants after JIT specialization, so each instantiation keeps one branch.
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static void Put<T>(ref LogRecord record, int arg, T value)
+    {
+        LogArgType type;
+        ulong bits = 0;
+        if (typeof(T) == typeof(int)) { type = LogArgType.Int64; bits = (ulong)Unsafe.As<T, int>(ref value); }
+        else if (typeof(T) == typeof(long)) { type = LogArgType.Int64; bits = (ulong)Unsafe.As<T, long>(ref value); }
+        else if (typeof(T) == typeof(short)) { type = LogArgType.Int64; bits = (ulong)Unsafe.As<T, short>(ref value); }
+        else if (typeof(T) == typeof(sbyte)) { type = LogArgType.Int64; bits = (ulong)Unsafe.As<T, sbyte>(ref value); }
+        else if (typeof(T) == typeof(uint)) { type = LogArgType.UInt64; bits = Unsafe.As<T, uint>(ref value); }
+        else if (typeof(T) == typeof(ulong)) { type = LogArgType.UInt64; bits = Unsafe.As<T, ulong>(ref value); }
+        else if (typeof(T) == typeof(ushort)) { type = LogArgType.UInt64; bits = Unsafe.As<T, ushort>(ref value); }
+        else if (typeof(T) == typeof(byte)) { type = LogArgType.UInt64; bits = Unsafe.As<T, byte>(ref value); }
+        else if (typeof(T) == typeof(nint)) { type = LogArgType.Int64; bits = (ulong)Unsafe.As<T, nint>(ref value); }
+        else if (typeof(T) == typeof(float)) { type = LogArgType.Single; bits = Unsafe.As<T, uint>(ref value); }
+        else if (typeof(T) == typeof(double)) { type = LogArgType.Double; bits = Unsafe.As<T, ulong>(ref value); }
+        else if (typeof(T) == typeof(bool)) { type = LogArgType.Boolean; bits = Unsafe.As<T, bool>(ref value) ? 1UL : 0; }
+        else if (typeof(T) == typeof(char)) { type = LogArgType.Char; bits = Unsafe.As<T, char>(ref value); }
+        else if (typeof(T).IsEnum)
+        {
+            type = LogArgType.Enum;
+            bits = Unsafe.SizeOf<T>() switch
+            {
+                1 => Unsafe.As<T, byte>(ref value),
+                2 => Unsafe.As<T, ushort>(ref value),
+                4 => Unsafe.As<T, uint>(ref value),
+                _ => Unsafe.As<T, ulong>(ref value),
+            };
+            record.Refs[arg] = typeof(T);
+        }
+        else
+        {
+            type = LogArgType.Object;
+            record.Refs[arg] = value;
+        }
+
+        record.Values[arg] = bits;
+        record.Types |= (int)type << (arg * 4);
+    }
+
+    private static LogRing CreateRing()
+    {
+        var ring = new LogRing(s_ringCapacity, Thread.CurrentThread);
+        lock (s_lock)
+        {
+            var rings = new LogRing[s_rings.Length + 1];
+            s_rings.CopyTo(rings, 0);
+            rings[^1] = ring;
+            Volatile.Write(ref s_rings, rings);
+        }
+        t_ring = ring;
+        return ring;
+    }
+
+    private static void DrainLoop()
+    {
+        while (!s_stopping)
+        {
+            int drained;
+            lock (s_drainLock)
+                drained = DrainAll();
+            if (drained == 0)
+                s_wake.WaitOne(DrainInterval);
+        }
+    }
+
+    private static int DrainAll()
+    {
+        var formatter = new LineFormatter(Volatile.Read(ref s_templates), s_sinks);
+        var rings = Volatile.Read(ref s_rings);
+        int drained = 0;
+        long dropped = 0;
+        bool retire = false;
+        foreach (var ring in rings)
+        {
+            drained += ring.Drain(ref formatter);
+            dropped += ring.Dropped;
+            retire |= !ring.Owner.IsAlive && ring.IsEmpty;
+        }
+        if (formatter.UnknownTemplates > 0)
+            Interlocked.Add(ref s_unknownTemplates, formatter.UnknownTemplates);
+        dropped += Volatile.Read(ref s_retiredDropped) + Volatile.Read(ref s_unknownTemplates);
+
+        if (dropped != s_reportedDrops)
+        {
+            formatter.WriteDropNotice(dropped - s_reportedDrops, dropped);
+            s_reportedDrops = dropped;
+        }
+        if (drained > 0 || formatter.Lines > 0)
+        {
+            foreach (var sink in s_sinks)
+                sink.Flush();
+        }
+        if (retire)
+            RetireDeadRings();
+
+        Interlocked.Add(ref s_drained, drained);
+        return drained;
+    }
+
+    // Threads that exited keep their ring until it has been drained; then its counters move to the totals.
+    private static void RetireDeadRings()
+    {
+        lock (s_lock)
+        {
+            var live = new List<LogRing>(s_rings.Length);
+            foreach (var ring in s_rings)
+            {
+                if (ring.Owner.IsAlive || !ring.IsEmpty)
+                {
+                    live.Add(ring);
+                    continue;
+                }
+                Interlocked.Add(ref s_retiredWritten, ring.Written);
+                Interlocked.Add(ref s_retiredDropped, ring.Dropped);
+            }
+            Volatile.Write(ref s_rings, live.ToArray());
+        }
+    }
+
+    /// <summary>
+    /// Turns records into "HH:mm:ss.fff level category: message" lines on the log thread.
+    /// </summary>
+    private struct LineFormatter : ILogRecordReader
+    {
+        private static readonly char[] s_buffer = new char[8192];
+        private LogTemplateInfo[] _templates;
+        private readonly ILogSink[] _sinks;
+
+        public LineFormatter(LogTemplateInfo[] templates, ILogSink[] sinks)
+        {
+            _templates = templates;
+            _sinks = sinks;
+            Lines = 0;
+            UnknownTemplates = 0;
+        }
+
+        public int Lines { get; private set; }
+
+        /// <summary>
+        /// Records skipped because their template is not in the table; counted as dropped.
+        /// </summary>
+        public int UnknownTemplates { get; private set; }
+
+        public void Read(in LogRecord record)
+        {
+            if (!TryGetTemplate(record.Template, out var template))
+            {
+                UnknownTemplates++;
+                return;
+            }
+
+            var line = new LineWriter(s_buffer);
+            var time = s_startTime.AddTicks((long)((record.Timestamp - s_startTimestamp) * ((double)TimeSpan.TicksPerSecond / Stopwatch.Frequency)));
+            line.Append(time, "HH:mm:ss.fff");
+            line.Append(' ');
+            line.Append(LevelName(template.Level));
+            line.Append(' ');
+            line.Append(template.Category);
+            line.Append(": ");
+            for (int i = 0; i < template.Holes; i++)
+            {
+                line.Append(template.Literal(i));
+                if (i < LogRecord.MaxArgs)
+                    AppendArg(ref line, record, i, template.HoleFormat(i));
+            }
+            line.Append(template.Literal(template.Holes));
+            Emit(line.Written);
+        }
+
+        // A template defined after this drain started can be in a grown table the formatter has not seen yet:
+        // Define publishes the slot before returning the handle, so a fresh read of the table has it.
+        private bool TryGetTemplate(int id, [NotNullWhen(true)] out LogTemplateInfo? template)
+        {
+            if ((uint)id >= (uint)_templates.Length || _templates[id] == null)
+                _templates = Volatile.Read(ref s_templates);
+            template = (uint)id < (uint)_templates.Length ? _templates[id] : null;
+            return template != null;
+        }
+
+        public void WriteDropNotice(long dropped, long total)
+        {
+            var line = new LineWriter(s_buffer);
+            line.Append(DateTime.Now, "HH:mm:ss.fff");
+            line.Append(" warn AsyncLog: dropped ");
+            line.Append(dropped, null);
+            line.Append(" records (");
+            line.Append(total, null);
+            line.Append(" total); the log thread fell behind");
+            Emit(line.Written);
+        }
+
+        private void Emit(ReadOnlySpan<char> text)
+        {
+            foreach (var sink in _sinks)
+                sink.WriteLine(text);
+            Lines++;
+        }
+
+        private static void AppendArg(ref LineWriter line, in LogRecord record, int arg, string? format)
+        {
+            ulong bits = record.Values[arg];
+            switch (record.TypeOf(arg))
+            {
+                case LogArgType.Int64: line.Append((long)bits, format); break;
+                case LogArgType.UInt64: line.Append(bits, format); break;
+                case LogArgType.Single: line.Append(BitConverter.UInt32BitsToSingle((uint)bits), format); break;
+                case LogArgType.Double: line.Append(BitConverter.UInt64BitsToDouble(bits), format); break;
+                case LogArgType.Boolean: line.Append(bits != 0 ? "true" : "false"); break;
+                case LogArgType.Char: line.Append((char)bits); break;
+                case LogArgType.Enum:
+                    line.Append(record.Refs[arg] is Type enumType ? Enum.ToObject(enumType, bits).ToString() : bits.ToString(CultureInfo.InvariantCulture));
+                    break;
+                case LogArgType.Object:
+                    var value = record.Refs[arg];
+                    line.Append(value is IFormattable formattable ? formattable.ToString(format, CultureInfo.InvariantCulture) : value?.ToString() ?? "null");
+                    break;
+                default: line.Append("{?}"); break;
+            }
+        }
+
+        private static string LevelName(LogLevel level) => level switch
+        {
+            LogLevel.Trace => "trce",
+            LogLevel.Debug => "dbug",
+            LogLevel.Information => "info",
+            LogLevel.Warning => "warn",
+            LogLevel.Error => "fail",
+            LogLevel.Critical => "crit",
+            _ => "none",
+        };
+    }
+
+    /// <summary>
+    /// Appends into a fixed buffer, truncating what does not fit.
+    /// </summary>
+    private ref struct LineWriter
+    {
+        private readonly Span<char> _buffer;
+        private int _length;
+
+        public LineWriter(Span<char> buffer)
+        {
+            _buffer = buffer;
+            _length = 0;
+        }
+
+        public readonly ReadOnlySpan<char> Written => _buffer[.._length];
+
+        public void Append(char c)
+        {
+            if (_length < _buffer.Length)
+                _buffer[_length++] = c;
+        }
+
+        public void Append(ReadOnlySpan<char> text)
+        {
+            int n = Math.Min(text.Length, _buffer.Length - _length);
+            text[..n].CopyTo(_buffer[_length..]);
+            _length += n;
+        }
+
+        public void Append<T>(T value, string? format) where T : ISpanFormattable
+        {
+            if (value.TryFormat(_buffer[_length..], out int written, format, CultureInfo.InvariantCulture))
+                _length += written;
+            else
+                Append(value.ToString(format, CultureInfo.InvariantCulture));
+        }
+    }
+}
@@ -0,0 +1,46 @@
+using Microsoft.Extensions.Logging;
+
+namespace GoldsrcFramework.Logging;
+
+/// <summary>
+/// Microsoft.Extensions.Logging provider over <see cref="AsyncLog"/>, replacing the Console and Debug providers that
+/// write synchronously on the calling thread. The state and formatter of each call are captured (one small object)
+/// and only turned into text on the log thread.
+/// </summary>
+public sealed class AsyncLoggerProvider : ILoggerProvider
+{
+    public ILogger CreateLogger(string categoryName) => new AsyncLogger(categoryName);
+
+    public void Dispose() => AsyncLog.Flush();
+
+    private sealed class AsyncLogger : ILogger
+    {
+        private readonly LogTemplate[] _templates = new LogTemplate[(int)LogLevel.None];
+
+        public AsyncLogger(string category)
+        {
+            for (int level = 0; level < _templates.Length; level++)
+                _templates[level] = AsyncLog.Define((LogLevel)level, category, "{Message}");
+        }
+
+        public IDisposable? BeginScope<TState>(TState state) where TState : notnull => null;
+
+        public bool IsEnabled(LogLevel logLevel) => AsyncLog.IsEnabled(logLevel);
+
+        public void Log<TState>(LogLevel logLevel, EventId eventId, TState state, Exception? exception, Func<TState, Exception?, string> formatter)
+        {
+            if (!AsyncLog.IsEnabled(logLevel))
+                return;
+            AsyncLog.Write(_templates[(int)logLevel], new DeferredMessage<TState>(state, exception, formatter));
+        }
+    }
+
+    private sealed class DeferredMessage<TState>(TState state, Exception? exception, Func<TState, Exception?, string> formatter)
+    {
+        public override string ToString()
+        {
+            var message = formatter(state, exception);
+            return exception == null ? message : $"{message}\n{exception}";
+        }
+    }
+}
@@ -0,0 +1,132 @@
+using System.Numerics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+namespace GoldsrcFramework.Logging;
+
+internal enum LogArgType : byte
+{
+    None,
+    Int64,
+    UInt64,
+    Single,
+    Double,
+    Boolean,
+    Char,
+    Enum,
+    Object,
+}
+
+/// <summary>
+/// One log call: template id, timestamp and up to <see cref="MaxArgs"/> arguments. Value arguments are stored as raw
+/// bits with a 4-bit type tag each; reference arguments (strings, deferred messages) by reference.
+/// </summary>
+internal struct LogRecord
+{
+    public const int MaxArgs = 4;
+
+    public long Timestamp;
+    public int Template;
+    public int Types;
+    public LogValues Values;
+    public LogRefs Refs;
+
+    public readonly LogArgType TypeOf(int arg) => (LogArgType)((Types >> (arg * 4)) & 0xF);
+
+    [InlineArray(MaxArgs)]
+    public struct LogValues
+    {
+        private ulong _element;
+    }
+
+    [InlineArray(MaxArgs)]
+    public struct LogRefs
+    {
+        private object? _element;
+    }
+}
+
+/// <summary>
+/// Single-producer single-consumer ring of <see cref="LogRecord"/>s. The owning thread writes without locks or
+/// allocation; when the log thread falls behind and the ring is full, new records are dropped and counted rather
+/// than waited for.
+/// </summary>
+internal sealed class LogRing
+{
+    [StructLayout(LayoutKind.Explicit, Size = 128)]
+    private struct PaddedLong
+    {
+        [FieldOffset(64)]
+        public long Value;
+    }
+
+    private readonly LogRecord[] _records;
+    private readonly int _mask;
+    private PaddedLong _head;
+    private PaddedLong _tail;
+    private PaddedLong _dropped;
+
+    public LogRing(int capacity, Thread owner)
+    {
+        capacity = (int)BitOperations.RoundUpToPowerOf2((uint)Math.Max(capacity, 16));
+        _records = new LogRecord[capacity];
+        _mask = capacity - 1;
+        Owner = owner;
+    }
+
+    public Thread Owner { get; }
+
+    public int Capacity => _records.Length;
+
+    /// <summary>
+    /// Records written since creation (producer side; read with some lag from other threads).
+    /// </summary>
+    public long Written => Volatile.Read(ref _head.Value);
+
+    public long Dropped => Volatile.Read(ref _dropped.Value);
+
+    public bool IsEmpty => Volatile.Read(ref _tail.Value) == Volatile.Read(ref _head.Value);
+
+    /// <summary>
+    /// Slot for the next record, or a null ref when full. Owning thread only; follow with <see cref="Commit"/>.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public ref LogRecord TryBeginWrite()
+    {
+        long head = _head.Value;
+        if (head - Volatile.Read(ref _tail.Value) >= _records.Length)
+        {
+            Volatile.Write(ref _dropped.Value, _dropped.Value + 1);
+            return ref Unsafe.NullRef<LogRecord>();
+        }
+        return ref _records[(int)head & _mask];
+    }
+
+    /// <summary>
+    /// Publish the record returned by <see cref="TryBeginWrite"/>.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public void Commit() => Volatile.Write(ref _head.Value, _head.Value + 1);
+
+    /// <summary>
+    /// Hand every published record to <paramref name="reader"/> and free its slot. Log thread only.
+    /// </summary>
+    public int Drain<TReader>(ref TReader reader) where TReader : struct, ILogRecordReader
+    {
+        long tail = _tail.Value;
+        long head = Volatile.Read(ref _head.Value);
+        for (long i = tail; i < head; i++)
+        {
+            ref var record = ref _records[(int)i & _mask];
+            reader.Read(in record);
+            record.Refs = default;
+        }
+        Volatile.Write(ref _tail.Value, head);
+        return (int)(head - tail);
+    }
+}
+
+internal interface ILogRecordReader
+{
+    void Read(in LogRecord record);
+}
@@ -0,0 +1,148 @@
+using System.Text;
+
+namespace GoldsrcFramework.Logging;
+
+/// <summary>
+/// Destination of formatted log lines. Called only from the log thread, so implementations may block.
+/// </summary>
+public interface ILogSink : IDisposable
+{
+    /// <summary>
+    /// Write one line, without its terminator.
+    /// </summary>
+    void WriteLine(ReadOnlySpan<char> line);
+
+    /// <summary>
+    /// Called after each batch of lines.
+    /// </summary>
+    void Flush();
+}
+
+/// <summary>
+/// Standard output through one buffered writer, flushed per batch rather than per line.
+/// </summary>
+public sealed class ConsoleLogSink : ILogSink
+{
+    private readonly StreamWriter _writer = new(Console.OpenStandardOutput(), new UTF8Encoding(false), 16 * 1024) { AutoFlush = false };
+
+    public void WriteLine(ReadOnlySpan<char> line)
+    {
+        _writer.Write(line);
+        _writer.Write('\n');
+    }
+
+    public void Flush() => _writer.Flush();
+
+    public void Dispose() => _writer.Dispose();
+}
+
+/// <summary>
+/// Attached debugger output, as the Debug provider writes it.
+/// </summary>
+public sealed class DebugLogSink : ILogSink
+{
+    public void WriteLine(ReadOnlySpan<char> line) => System.Diagnostics.Debugger.Log(0, null, string.Concat(line, "\n"));
+
+    public void Flush()
+    {
+    }
+
+    public void Dispose()
+    {
+    }
+}
+
+/// <summary>
+/// Log file that rolls over at <see cref="MaxBytes"/>: x.log becomes x.1.log, x.1.log becomes x.2.log, and so on,
+/// keeping <see cref="MaxFiles"/> files in total.
+/// </summary>
+public sealed class RotatingFileLogSink : ILogSink
+{
+    private readonly string _path;
+    private readonly Encoding _encoding = new UTF8Encoding(false);
+    private FileStream? _stream;
+    private StreamWriter? _writer;
+    private long _bytes;
+
+    public RotatingFileLogSink(string path, long maxBytes = 10 << 20, int maxFiles = 5)
+    {
+        _path = Path.GetFullPath(path);
+        MaxBytes = Math.Max(maxBytes, 4096);
+        MaxFiles = Math.Max(maxFiles, 1);
+        var directory = Path.GetDirectoryName(_path);
+        if (!string.IsNullOrEmpty(directory))
+            Directory.CreateDirectory(directory);
+        Open();
+    }
+
+    public long MaxBytes { get; }
+
+    public int MaxFiles { get; }
+
+    public int Rotations { get; private set; }
+
+    public void WriteLine(ReadOnlySpan<char> line)
+    {
+        if (_writer == null)
+            return;
+
+        _writer.Write(line);
+        _writer.Write('\n');
+        _bytes += _encoding.GetByteCount(line) + 1;
+        if (_bytes >= MaxBytes)
+            Rotate();
+    }
+
+    public void Flush() => _writer?.Flush();
+
+    public void Dispose()
+    {
+        _writer?.Dispose();
+        _writer = null;
+        _stream = null;
+    }
+
+    private void Open()
+    {
+        try
+        {
+            _stream = new FileStream(_path, FileMode.Append, FileAccess.Write, FileShare.ReadWrite);
+            _writer = new StreamWriter(_stream, _encoding, 64 * 1024) { AutoFlush = false };
+            _bytes = _stream.Length;
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            System.Diagnostics.Debug.WriteLine($"[RotatingFileLogSink] Cannot open {_path}: {ex.Message}");
+            _stream = null;
+            _writer = null;
+        }
+    }
+
+    private void Rotate()
+    {
+        _writer?.Dispose();
+        _writer = null;
+        try
+        {
+            string stem = Path.Combine(Path.GetDirectoryName(_path) ?? "", Path.GetFileNameWithoutExtension(_path));
+            string extension = Path.GetExtension(_path);
+            File.Delete($"{stem}.{MaxFiles - 1}{extension}");
+            for (int i = MaxFiles - 2; i >= 1; i--)
+            {
+                string from = $"{stem}.{i}{extension}";
+                if (File.Exists(from))
+                    File.Move(from, $"{stem}.{i + 1}{extension}");
+            }
+            if (MaxFiles > 1)
+                File.Move(_path, $"{stem}.1{extension}");
+            else
+                File.Delete(_path);
+            Rotations++;
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            System.Diagnostics.Debug.WriteLine($"[RotatingFileLogSink] Rotation of {_path} failed: {ex.Message}");
+        }
+        Open();
+    }
+}
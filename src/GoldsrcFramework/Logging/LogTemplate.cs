@@ -0,0 +1,85 @@
+using System.Text;
+using Microsoft.Extensions.Logging;
+
+namespace GoldsrcFramework.Logging;
+
+/// <summary>
+/// Handle of a message template defined with <see cref="AsyncLog.Define"/>. Records carry only its id; the text is
+/// put together on the log thread.
+/// </summary>
+public readonly struct LogTemplate
+{
+    internal LogTemplate(int id, LogLevel level)
+    {
+        Id = id;
+        Level = level;
+    }
+
+    public int Id { get; }
+
+    public LogLevel Level { get; }
+}
+
+/// <summary>
+/// Parsed template: literals and argument holes in order. "{Name}" and "{0}" holes both take the next argument;
+/// "{X:F2}" passes F2 to the argument's formatter; "{{" and "}}" are literal braces.
+/// </summary>
+internal sealed class LogTemplateInfo
+{
+    private readonly string[] _literals;
+    private readonly string?[] _formats;
+
+    public LogTemplateInfo(LogLevel level, string category, string format)
+    {
+        Level = level;
+        Category = category;
+        Format = format;
+
+        var literals = new List<string>();
+        var formats = new List<string?>();
+        var literal = new StringBuilder();
+        for (int i = 0; i < format.Length; i++)
+        {
+            char c = format[i];
+            if ((c == '{' || c == '}') && i + 1 < format.Length && format[i + 1] == c)
+            {
+                literal.Append(c);
+                i++;
+                continue;
+            }
+
+            int close = c == '{' ? format.IndexOf('}', i + 1) : -1;
+            if (close < 0)
+            {
+                literal.Append(c);
+                continue;
+            }
+
+            var hole = format.AsSpan(i + 1, close - i - 1);
+            int colon = hole.IndexOf(':');
+            literals.Add(literal.ToString());
+            literal.Clear();
+            formats.Add(colon >= 0 ? hole[(colon + 1)..].ToString() : null);
+            i = close;
+        }
+        literals.Add(literal.ToString());
+
+        _literals = literals.ToArray();
+        _formats = formats.ToArray();
+    }
+
+    public LogLevel Level { get; }
+
+    public string Category { get; }
+
+    public string Format { get; }
+
+    public int Holes => _formats.Length;
+
+    /// <summary>
+    /// Literal before hole <paramref name="index"/> (or the tail at <see cref="Holes"/>).
+    /// </summary>
+    public string Literal(int index) => _literals[index];
+
+    public string? HoleFormat(int index) => _formats[index];
+}
@@ -0,0 +1,26 @@
+namespace GoldsrcFramework.Messages;
+
+/// <summary>
+/// Opcodes of the buffered message stream written by <see cref="MessageWriter"/>.
+/// Must match MSG_OP_* in GoldsrcFramework.Loader/loader.cpp.
+///
+/// Layout (little endian, unaligned):
+///   Begin   int dest, int type, byte hasOrigin, float[3] origin, uint64 edict
+///   End     -
+///   Byte / Char / Short / Long / Entity   int
+///   Angle / Coord   float
+///   String  null-terminated bytes
+/// </summary>
+public enum MessageOp : byte
+{
+    Begin = 1,
+    End = 2,
+    Byte = 3,
+    Char = 4,
+    Short = 5,
+    Long = 6,
+    Angle = 7,
+    Coord = 8,
+    String = 9,
+    Entity = 10,
+}
@@ -0,0 +1,221 @@
+using System.Buffers.Binary;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using NativeInterop;
+
+namespace GoldsrcFramework.Messages;
+
+/// <summary>
+/// Plays a <see cref="MessageWriter"/> stream back into the engine's MessageBegin / Write* / MessageEnd.
+///
+/// The loader (gsfloader.dll) exports ReplayMessageStream, which walks the stream in native code so the whole
+/// batch costs one managed-to-native transition. Without the loader export the stream is replayed from managed code,
+/// one engine call per op, which is the same cost as writing directly. Either way the whole stream is checked before
+/// the first engine call.
+/// </summary>
+public static unsafe class MessageReplay
+{
+    private const string LoaderDll = "gsfloader";
+    private const string ReplayExport = "ReplayMessageStream";
+
+    private static delegate* unmanaged[Cdecl]<ServerEngineFuncs*, byte*, int, int> _native;
+    private static bool _resolved;
+
+    /// <summary>
+    /// Loader replay entry, or null when running without the native loader.
+    /// </summary>
+    public static delegate* unmanaged[Cdecl]<ServerEngineFuncs*, byte*, int, int> NativeReplay
+    {
+        get
+        {
+            if (!_resolved)
+                Resolve();
+            return _native;
+        }
+        set
+        {
+            _native = value;
+            _resolved = true;
+        }
+    }
+
+    /// <summary>
+    /// Replay <paramref name="stream"/> into <paramref name="engine"/>. Returns the number of ops, or -1 without
+    /// calling the engine if the stream is malformed (see <see cref="Validate"/>).
+    /// </summary>
+    public static int Replay(ServerEngineFuncs* engine, ReadOnlySpan<byte> stream)
+    {
+        var native = NativeReplay;
+        int ops;
+        fixed (byte* p = stream)
+        {
+            ops = native != null ? native(engine, p, stream.Length) : ReplayManaged(engine, stream);
+        }
+
+        if (ops < 0)
+            Debug.WriteLine($"[MessageReplay] Malformed message stream ({stream.Length} bytes)");
+        return ops;
+    }
+
+    /// <summary>
+    /// Number of ops in <paramref name="stream"/>, or -1 if it is malformed: truncated or unknown ops, an unterminated
+    /// string, a Begin inside a message, a write or End outside one, or a message left open at the end.
+    /// Same rules as the loader's ValidateMessageStream.
+    /// </summary>
+    public static int Validate(ReadOnlySpan<byte> stream)
+    {
+        int ops = 0;
+        int pos = 0;
+        bool open = false;
+        while (pos < stream.Length)
+        {
+            var op = (MessageOp)stream[pos++];
+            var rest = stream[pos..];
+            int size;
+            switch (op)
+            {
+                case MessageOp.Begin:
+                    if (open)
+                        return -1;
+                    open = true;
+                    size = 29;
+                    break;
+                case MessageOp.End:
+                    if (!open)
+                        return -1;
+                    open = false;
+                    size = 0;
+                    break;
+                case MessageOp.Byte:
+                case MessageOp.Char:
+                case MessageOp.Short:
+                case MessageOp.Long:
+                case MessageOp.Entity:
+                case MessageOp.Angle:
+                case MessageOp.Coord:
+                    size = 4;
+                    break;
+                case MessageOp.String:
+                    size = rest.IndexOf((byte)0) + 1;
+                    if (size == 0)
+                        return -1;
+                    break;
+                default:
+                    return -1;
+            }
+            if (op != MessageOp.Begin && op != MessageOp.End && !open)
+                return -1;
+            if (rest.Length < size)
+                return -1;
+            pos += size;
+            ops++;
+        }
+        return open ? -1 : ops;
+    }
+
+    /// <summary>
+    /// Managed equivalent of the loader's ReplayMessageStream. The stream is validated first, so a malformed one
+    /// makes no engine calls at all instead of leaving a message open.
+    /// </summary>
+    public static int ReplayManaged(ServerEngineFuncs* engine, ReadOnlySpan<byte> stream)
+    {
+        if (Validate(stream) < 0)
+            return -1;
+
+        int ops = 0;
+        int pos = 0;
+        while (pos < stream.Length)
+        {
+            var op = (MessageOp)stream[pos++];
+            var rest = stream[pos..];
+            switch (op)
+            {
+                case MessageOp.Begin:
+                {
+                    if (rest.Length < 29)
+                        return -1;
+                    int dest = BinaryPrimitives.ReadInt32LittleEndian(rest);
+                    int type = BinaryPrimitives.ReadInt32LittleEndian(rest[4..]);
+                    bool hasOrigin = rest[8] != 0;
+                    float* origin = stackalloc float[3];
+                    origin[0] = BinaryPrimitives.ReadSingleLittleEndian(rest[9..]);
+                    origin[1] = BinaryPrimitives.ReadSingleLittleEndian(rest[13..]);
+                    origin[2] = BinaryPrimitives.ReadSingleLittleEndian(rest[17..]);
+                    var edict = (edict_t*)(nuint)BinaryPrimitives.ReadUInt64LittleEndian(rest[21..]);
+                    engine->MessageBegin(dest, type, hasOrigin ? origin : null, edict);
+                    pos += 29;
+                    break;
+                }
+                case MessageOp.End:
+                    engine->MessageEnd();
+                    break;
+                case MessageOp.Byte:
+                case MessageOp.Char:
+                case MessageOp.Short:
+                case MessageOp.Long:
+                case MessageOp.Entity:
+                {
+                    if (rest.Length < 4)
+                        return -1;
+                    int value = BinaryPrimitives.ReadInt32LittleEndian(rest);
+                    var write = op switch
+                    {
+                        MessageOp.Byte => engine->WriteByte,
+                        MessageOp.Char => engine->WriteChar,
+                        MessageOp.Short => engine->WriteShort,
+                        MessageOp.Long => engine->WriteLong,
+                        _ => engine->WriteEntity,
+                    };
+                    write(value);
+                    pos += 4;
+                    break;
+                }
+                case MessageOp.Angle:
+                case MessageOp.Coord:
+                {
+                    if (rest.Length < 4)
+                        return -1;
+                    float value = BinaryPrimitives.ReadSingleLittleEndian(rest);
+                    if (op == MessageOp.Angle)
+                        engine->WriteAngle(value);
+                    else
+                        engine->WriteCoord(value);
+                    pos += 4;
+                    break;
+                }
+                case MessageOp.String:
+                {
+                    int end = rest.IndexOf((byte)0);
+                    if (end < 0)
+                        return -1;
+                    fixed (byte* text = rest)
+                        engine->WriteString((NChar*)text);
+                    pos += end + 1;
+                    break;
+                }
+                default:
+                    return -1;
+            }
+            ops++;
+        }
+        return ops;
+    }
+
+    private static void Resolve()
+    {
+        _resolved = true;
+        try
+        {
+            if (NativeLibrary.TryLoad(LoaderDll, out var module) &&
+                NativeLibrary.TryGetExport(module, ReplayExport, out var export))
+            {
+                _native = (delegate* unmanaged[Cdecl]<ServerEngineFuncs*, byte*, int, int>)export;
+            }
+        }
+        catch (Exception ex)
+        {
+            Debug.WriteLine($"[MessageReplay] Native replay unavailable: {ex.Message}");
+        }
+    }
+}
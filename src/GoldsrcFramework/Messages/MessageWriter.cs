@@ -0,0 +1,312 @@
+using System.Buffers;
+using System.Diagnostics.CodeAnalysis;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Text;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using NativeInterop;
+
+namespace GoldsrcFramework.Messages;
+
+/// <summary>
+/// Writes network messages (MESSAGE_BEGIN ... MESSAGE_END), either straight to the engine or, when batching is on,
+/// encoded into a byte stream that <see cref="Flush(ServerEngineFuncs*)"/> sends as a whole, at the cost of a single
+/// native transition when the loader's replay export is available (see <see cref="MessageReplay"/>).
+///
+/// Batching is opt-in (<see cref="Batching"/>, Game:BatchNetworkMessages): encoding and replaying cost more than the
+/// transitions they save unless engine calls are expensive, and MessageWriterBenchmark measured the batched path at
+/// about 2.5 times the direct one. Unbatched, every call goes to the engine right away and Flush does nothing.
+///
+/// <code>
+/// var msg = new MessageWriter(stackalloc byte[512]);
+/// msg.Begin(MSG_ONE, gmsgHealth, null, player);
+/// msg.WriteByte(health);
+/// msg.End();
+/// msg.Flush();
+/// msg.Dispose();
+/// </code>
+/// A batch starts in the caller's buffer and moves to a pooled array when it runs out of room.
+/// </summary>
+public unsafe ref struct MessageWriter
+{
+    private readonly ServerEngineFuncs* _direct;
+    private Span<byte> _buffer;
+    private byte[]? _rented;
+    private int _length;
+    private int _messages;
+    private bool _open;
+
+    /// <summary>
+    /// Whether writers made with <see cref="MessageWriter(Span{byte})"/> batch until Flush. Off by default; set from
+    /// Game:BatchNetworkMessages at GameInit.
+    /// </summary>
+    public static bool Batching { get; set; }
+
+    /// <summary>
+    /// Writer for <see cref="EngineApi.PServer"/>, batching if <see cref="Batching"/> is on or there is no server engine yet.
+    /// </summary>
+    /// <param name="buffer">Room for the batch, or for transcoding strings when not batching.</param>
+    public MessageWriter(Span<byte> buffer) : this(buffer, Batching ? null : EngineApi.PServer)
+    {
+    }
+
+    /// <param name="buffer">Room for the batch, or for transcoding strings when not batching.</param>
+    /// <param name="direct">Engine to write every call to right away; null to batch until Flush.</param>
+    public MessageWriter(Span<byte> buffer, ServerEngineFuncs* direct)
+    {
+        _buffer = buffer;
+        _direct = direct;
+    }
+
+    /// <summary>
+    /// False when calls go straight to the engine.
+    /// </summary>
+    public readonly bool IsBatching => _direct == null;
+
+    /// <summary>
+    /// Encoded bytes so far; empty when not batching.
+    /// </summary>
+    public readonly ReadOnlySpan<byte> Written => _buffer[.._length];
+
+    /// <summary>
+    /// Completed messages in the batch.
+    /// </summary>
+    public readonly int MessageCount => _messages;
+
+    public void Begin(int dest, int type, Vector3* origin = null, edict_t* edict = null)
+    {
+        if (_open)
+            throw new InvalidOperationException("MessageWriter: Begin called inside an open message.");
+        _open = true;
+
+        if (_direct != null)
+        {
+            _direct->MessageBegin(dest, type, (float*)origin, edict);
+            return;
+        }
+
+        ref byte p = ref ReserveRef(1 + 4 + 4 + 1 + 12 + 8);
+        p = (byte)MessageOp.Begin;
+        Unsafe.WriteUnaligned(ref Unsafe.Add(ref p, 1), dest);
+        Unsafe.WriteUnaligned(ref Unsafe.Add(ref p, 5), type);
+        Unsafe.Add(ref p, 9) = origin != null ? (byte)1 : (byte)0;
+        Unsafe.WriteUnaligned(ref Unsafe.Add(ref p, 10), origin != null ? *origin : default);
+        Unsafe.WriteUnaligned(ref Unsafe.Add(ref p, 22), (ulong)(nuint)edict);
+    }
+
+    public void End()
+    {
+        if (!_open)
+            throw new InvalidOperationException("MessageWriter: End called without Begin.");
+        _open = false;
+        _messages++;
+        if (_direct != null)
+            _direct->MessageEnd();
+        else
+            ReserveRef(1) = (byte)MessageOp.End;
+    }
+
+    public void WriteByte(int value) => WriteInt(MessageOp.Byte, value);
+
+    public void WriteChar(int value) => WriteInt(MessageOp.Char, value);
+
+    public void WriteShort(int value) => WriteInt(MessageOp.Short, value);
+
+    public void WriteLong(int value) => WriteInt(MessageOp.Long, value);
+
+    public void WriteEntity(int value) => WriteInt(MessageOp.Entity, value);
+
+    public void WriteAngle(float value) => WriteFloat(MessageOp.Angle, value);
+
+    public void WriteCoord(float value) => WriteFloat(MessageOp.Coord, value);
+
+    public void WriteCoord(Vector3 value)
+    {
+        WriteFloat(MessageOp.Coord, value.X);
+        WriteFloat(MessageOp.Coord, value.Y);
+        WriteFloat(MessageOp.Coord, value.Z);
+    }
+
+    /// <summary>
+    /// Write text as UTF-8. Like the engine, stops at the first '\0'.
+    /// </summary>
+    public void WriteString(ReadOnlySpan<char> text)
+    {
+        EnsureOpen();
+        int end = text.IndexOf('\0');
+        if (end >= 0)
+            text = text[..end];
+
+        var span = Reserve(1 + Encoding.UTF8.GetMaxByteCount(text.Length) + 1);
+        span[0] = (byte)MessageOp.String;
+        int length = Encoding.UTF8.GetBytes(text, span[1..]);
+        span[1 + length] = 0;
+
+        if (_direct != null)
+        {
+            // The buffer only holds the text for the call.
+            _length -= span.Length;
+            fixed (byte* p = &span[1])
+                _direct->WriteString((NChar*)p);
+            return;
+        }
+
+        // Give back the unused part of the worst-case reservation.
+        _length -= span.Length - (length + 2);
+    }
+
+    /// <summary>
+    /// Write UTF-8 text, e.g. a "..."u8 literal, without transcoding. Stops at the first 0.
+    /// </summary>
+    public void WriteString(ReadOnlySpan<byte> utf8)
+    {
+        EnsureOpen();
+        int end = utf8.IndexOf((byte)0);
+        if (end >= 0)
+            utf8 = utf8[..end];
+
+        var span = Reserve(1 + utf8.Length + 1);
+        span[0] = (byte)MessageOp.String;
+        utf8.CopyTo(span[1..]);
+        span[^1] = 0;
+
+        if (_direct != null)
+        {
+            _length -= span.Length;
+            fixed (byte* p = &span[1])
+                _direct->WriteString((NChar*)p);
+        }
+    }
+
+    /// <summary>
+    /// Send every completed message to <see cref="EngineApi.PServer"/> and clear the batch. Nothing to do when not batching.
+    /// </summary>
+    public void Flush() => Flush(EngineApi.PServer);
+
+    /// <summary>
+    /// Send every completed message to <paramref name="engine"/> and clear the batch. Nothing to do when not batching.
+    /// </summary>
+    public void Flush(ServerEngineFuncs* engine)
+    {
+        if (_open)
+            throw new InvalidOperationException("MessageWriter: Flush called inside an open message.");
+
+        if (_length > 0)
+            MessageReplay.Replay(engine, _buffer[.._length]);
+        Clear();
+    }
+
+    /// <summary>
+    /// Drop everything written so far.
+    /// </summary>
+    public void Clear()
+    {
+        _length = 0;
+        _messages = 0;
+        _open = false;
+    }
+
+    /// <summary>
+    /// Return the pooled buffer, if one was rented.
+    /// </summary>
+    public void Dispose()
+    {
+        if (_rented != null)
+        {
+            ArrayPool<byte>.Shared.Return(_rented);
+            _rented = null;
+        }
+        _buffer = default;
+        Clear();
+    }
+
+    // GoldSrc only runs on little-endian x86/x64, so values are stored in native order.
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private void WriteInt(MessageOp op, int value)
+    {
+        EnsureOpen();
+        if (_direct != null)
+        {
+            WriteDirect(op, value);
+            return;
+        }
+
+        ref byte p = ref ReserveRef(5);
+        p = (byte)op;
+        Unsafe.WriteUnaligned(ref Unsafe.Add(ref p, 1), value);
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private void WriteFloat(MessageOp op, float value)
+    {
+        EnsureOpen();
+        if (_direct != null)
+        {
+            if (op == MessageOp.Angle)
+                _direct->WriteAngle(value);
+            else
+                _direct->WriteCoord(value);
+            return;
+        }
+
+        ref byte p = ref ReserveRef(5);
+        p = (byte)op;
+        Unsafe.WriteUnaligned(ref Unsafe.Add(ref p, 1), value);
+    }
+
+    private readonly void WriteDirect(MessageOp op, int value)
+    {
+        switch (op)
+        {
+            case MessageOp.Byte: _direct->WriteByte(value); break;
+            case MessageOp.Char: _direct->WriteChar(value); break;
+            case MessageOp.Short: _direct->WriteShort(value); break;
+            case MessageOp.Long: _direct->WriteLong(value); break;
+            default: _direct->WriteEntity(value); break;
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private readonly void EnsureOpen()
+    {
+        if (!_open)
+            ThrowNotOpen();
+    }
+
+    [DoesNotReturn]
+    private static void ThrowNotOpen() => throw new InvalidOperationException("MessageWriter: write outside of Begin/End.");
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private ref byte ReserveRef(int size)
+    {
+        if ((uint)(_length + size) > (uint)_buffer.Length)
+            Grow(size);
+
+        ref byte p = ref Unsafe.Add(ref MemoryMarshal.GetReference(_buffer), _length);
+        _length += size;
+        return ref p;
+    }
+
+    private Span<byte> Reserve(int size)
+    {
+        if (_length + size > _buffer.Length)
+            Grow(size);
+
+        var span = _buffer.Slice(_length, size);
+        _length += size;
+        return span;
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    private void Grow(int size)
+    {
+        var next = ArrayPool<byte>.Shared.Rent(Math.Max(_buffer.Length * 2, Math.Max(_length + size, 256)));
+        _buffer[.._length].CopyTo(next);
+        if (_rented != null)
+            ArrayPool<byte>.Shared.Return(_rented);
+        _rented = next;
+        _buffer = next;
+    }
+}
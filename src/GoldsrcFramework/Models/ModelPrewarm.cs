@@ -0,0 +1,183 @@
+using System.Diagnostics;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Rendering;
+using GoldsrcFramework.Strings;
+
+namespace GoldsrcFramework.Models;
+
+/// <summary>
+/// Timing of one <see cref="ModelPrewarm"/> pass.
+/// </summary>
+public readonly record struct ModelPrewarmReport(
+    int Models,
+    int Failed,
+    long Bytes,
+    int Bones,
+    int Hitboxes,
+    int Sequences,
+    int Workers,
+    double WallMilliseconds,
+    double WorkerMilliseconds,
+    double EngineMilliseconds,
+    string? Slowest,
+    double SlowestMilliseconds)
+{
+    public override string ToString() =>
+        $"{Models} models ({Bytes / 1024} KB, {Bones} bones, {Hitboxes} hitboxes, {Sequences} sequences, {Failed} failed) " +
+        $"in {WallMilliseconds:F1} ms on {Workers} workers ({WorkerMilliseconds:F1} ms of work), " +
+        $"engine warm {EngineMilliseconds:F1} ms, slowest {Slowest ?? "-"} {SlowestMilliseconds:F1} ms";
+}
+
+/// <summary>
+/// Level-load prewarm of studio models, so the first frames after spawning do not each pay for a model seen for
+/// the first time.
+///
+/// At HUD_VidInit (client) and ServerActivate (server) every precached .mdl is memory-mapped and validated, and its
+/// <see cref="StudioModelInfo"/> (bone hierarchy, hitbox tables, sequence lookups, bone name remap) is built on
+/// worker threads; the results are published to <see cref="StudioModelCache"/> on the main thread. On the client the
+/// engine's own per-model work, which must stay on the main thread, is then done up front as well: Mod_Extradata and
+/// the sequence group files that StudioGetAnim would otherwise load on first draw.
+/// </summary>
+public static unsafe class ModelPrewarm
+{
+    private const int MaxModels = 512;
+
+    /// <summary>
+    /// Worker threads; 0 uses Environment.ProcessorCount.
+    /// </summary>
+    public static int WorkerCount { get; set; }
+
+    /// <summary>
+    /// Skip prewarming; models are then built on first use as before.
+    /// </summary>
+    public static bool Disabled { get; set; }
+
+    public static ModelPrewarmReport LastClient { get; private set; }
+
+    public static ModelPrewarmReport LastServer { get; private set; }
+
+    /// <summary>
+    /// Build every model of <paramref name="names"/> not yet in <paramref name="cache"/>. Blocks until done.
+    /// </summary>
+    public static ModelPrewarmReport Run(StudioModelCache cache, IReadOnlyList<string> names, int workers = 0)
+    {
+        var pending = new List<string>(names.Count);
+        foreach (var name in names)
+        {
+            if (!cache.TryGet(new Utf8View(System.Text.Encoding.UTF8.GetBytes(name)), out _))
+                pending.Add(name);
+        }
+
+        var infos = new StudioModelInfo?[pending.Count];
+        var errors = new string?[pending.Count];
+        var ticks = new long[pending.Count];
+        string? gameDirectory = cache.GameDirectory;
+        var options = new ParallelOptions
+        {
+            MaxDegreeOfParallelism = workers > 0 ? workers : WorkerCount > 0 ? WorkerCount : Environment.ProcessorCount
+        };
+
+        long start = Stopwatch.GetTimestamp();
+        Parallel.For(0, pending.Count, options, i =>
+        {
+            long t0 = Stopwatch.GetTimestamp();
+            infos[i] = StudioModelCache.Load(pending[i], gameDirectory, out errors[i]);
+            ticks[i] = Stopwatch.GetTimestamp() - t0;
+        });
+
+        // Publishing interns bone names, so it stays on this thread.
+        long bytes = 0, slowestTicks = 0, workTicks = 0;
+        int failed = 0, bones = 0, hitboxes = 0, sequences = 0;
+        string? slowest = null;
+        for (int i = 0; i < pending.Count; i++)
+        {
+            cache.Add(new Utf8View(System.Text.Encoding.UTF8.GetBytes(pending[i])), infos[i]);
+            workTicks += ticks[i];
+            if (ticks[i] > slowestTicks)
+            {
+                slowestTicks = ticks[i];
+                slowest = pending[i];
+            }
+
+            if (infos[i] is not { } info)
+            {
+                failed++;
+                Debug.WriteLine($"[ModelPrewarm] {pending[i]}: {errors[i]}");
+                continue;
+            }
+            bytes += info.FileLength;
+            bones += info.BoneCount;
+            hitboxes += info.HitboxCount;
+            sequences += info.Sequences.Length;
+        }
+        double wall = Stopwatch.GetElapsedTime(start).TotalMilliseconds;
+
+        return new ModelPrewarmReport(pending.Count, failed, bytes, bones, hitboxes, sequences,
+            Math.Min(options.MaxDegreeOfParallelism, Math.Max(pending.Count, 1)),
+            wall, workTicks * 1000.0 / Stopwatch.Frequency, 0,
+            slowest, slowestTicks * 1000.0 / Stopwatch.Frequency);
+    }
+
+    /// <summary>
+    /// Client prewarm over the engine's model precache list. Call from HUD_VidInit.
+    /// </summary>
+    public static ModelPrewarmReport Client()
+    {
+        var studio = EngineApi.PStudio;
+        var cache = StudioModelCache.Client;
+        cache.Clear();
+        if (Disabled || studio == null || studio->GetModelByIndex == null)
+            return default;
+
+        cache.GameDirectory = GamePaths.ClientGameDirectory();
+        var models = new List<nint>();
+        var names = new List<string>();
+        for (int i = 1; i < MaxModels; i++)
+        {
+            model_t* model = studio->GetModelByIndex(i);
+            if (model == null || model->type != modtype_t.mod_studio)
+                continue;
+            models.Add((nint)model);
+            names.Add(StudioModelCache.ModelName(model).ToString());
+        }
+
+        var report = Run(cache, names);
+
+        long start = Stopwatch.GetTimestamp();
+        for (int i = 0; i < models.Count; i++)
+        {
+            var model = (model_t*)models[i];
+            cache.TryGet(StudioModelCache.ModelName(model), out var info);
+            cache.Bind(model, info);
+
+            var header = (studiohdr_t*)studio->Mod_Extradata(model);
+            if (header != null)
+                StudioModelRenderer.LoadSequenceGroups(model, header);
+        }
+        double engine = Stopwatch.GetElapsedTime(start).TotalMilliseconds;
+        report = report with { EngineMilliseconds = engine, WallMilliseconds = report.WallMilliseconds + engine };
+
+        LastClient = report;
+        if (EngineApi.PClient != null)
+            EngineApi.ConsoleDPrint($"[ModelPrewarm] client: {report}\n");
+        return report;
+    }
+
+    /// <summary>
+    /// Server prewarm over the models precached while the level spawned. Call from ServerActivate.
+    /// </summary>
+    public static ModelPrewarmReport Server()
+    {
+        var cache = StudioModelCache.Server;
+        if (Disabled)
+            return default;
+
+        cache.GameDirectory = GamePaths.ServerGameDirectory();
+        var report = Run(cache, cache.Precached);
+
+        LastServer = report;
+        if (EngineApi.PServer != null)
+            EngineApi.AlertMessage(ALERT_TYPE.at_console, $"[ModelPrewarm] server: {report}\n");
+        return report;
+    }
+}
@@ -0,0 +1,139 @@
+using System.Diagnostics;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Strings;
+using NativeInterop;
+
+namespace GoldsrcFramework.Models;
+
+/// <summary>
+/// <see cref="StudioModelInfo"/> of the current level's models, by precache name and (on the client) by model_t*.
+/// Filled in bulk by <see cref="ModelPrewarm"/>; a model it missed is built on first lookup, as before prewarming.
+/// Main thread only.
+/// </summary>
+public sealed unsafe class StudioModelCache
+{
+    private readonly Utf8Map<StudioModelInfo?> _byName = new(ignoreCase: true, capacity: 256);
+    private readonly Dictionary<nint, StudioModelInfo?> _byModel = new();
+    private readonly Utf8Map<int> _boneNameIds = new(capacity: 1024);
+    private readonly List<string> _precached = new();
+    private readonly Utf8Map<bool> _precachedSet = new(ignoreCase: true, capacity: 256);
+
+    public static StudioModelCache Client { get; } = new();
+
+    public static StudioModelCache Server { get; } = new();
+
+    /// <summary>
+    /// Game directory used to resolve model paths; set by <see cref="ModelPrewarm"/>.
+    /// </summary>
+    public string? GameDirectory { get; set; }
+
+    public int Count => _byName.Count;
+
+    /// <summary>
+    /// Models built on lookup because prewarm did not cover them; each one was a potential hitch.
+    /// </summary>
+    public int LateBuilds { get; private set; }
+
+    /// <summary>
+    /// .mdl names seen by <see cref="NotePrecache"/> this level.
+    /// </summary>
+    public IReadOnlyList<string> Precached => _precached;
+
+    /// <summary>
+    /// Record a model precache (server: every PrecacheModel call, ours or the legacy DLL's).
+    /// </summary>
+    public void NotePrecache(NChar* name)
+    {
+        var view = new Utf8View(name);
+        if (view.IsEmpty || !view.EndsWith(".mdl"u8) || _precachedSet.ContainsKey(view))
+            return;
+        _precachedSet.Set(view, true);
+        _precached.Add(view.ToString());
+    }
+
+    /// <summary>
+    /// Info for <paramref name="name"/>, building it now if prewarm did not. Null when the file cannot be read.
+    /// </summary>
+    public StudioModelInfo? Get(Utf8View name)
+    {
+        if (_byName.TryGetValue(name, out var info))
+            return info;
+
+        LateBuilds++;
+        info = Load(name.ToString(), GameDirectory, out var error);
+        if (error != null)
+            Debug.WriteLine($"[StudioModelCache] {name.ToString()}: {error}");
+        Add(name, info);
+        return info;
+    }
+
+    /// <summary>
+    /// Info for an engine model, cached by pointer. Null for non-studio models or unreadable files.
+    /// </summary>
+    public StudioModelInfo? Get(model_t* model)
+    {
+        if (model == null)
+            return null;
+        if (_byModel.TryGetValue((nint)model, out var info))
+            return info;
+
+        info = model->type == modtype_t.mod_studio ? Get(ModelName(model)) : null;
+        _byModel[(nint)model] = info;
+        return info;
+    }
+
+    /// <summary>
+    /// Prewarmed info for an engine model, without building anything; for per-frame callers.
+    /// </summary>
+    public StudioModelInfo? Find(model_t* model) =>
+        model != null && _byModel.TryGetValue((nint)model, out var info) ? info : null;
+
+    public bool TryGet(Utf8View name, out StudioModelInfo? info) => _byName.TryGetValue(name, out info) && info != null;
+
+    /// <summary>
+    /// Publish a built model (or null for a failed one, so it is not retried every lookup).
+    /// </summary>
+    public void Add(Utf8View name, StudioModelInfo? info)
+    {
+        info?.BindNameIds(_boneNameIds);
+        _byName.Set(name, info);
+    }
+
+    internal void Bind(model_t* model, StudioModelInfo? info) => _byModel[(nint)model] = info;
+
+    /// <summary>
+    /// Forget the level's models and precaches. Bone name ids are kept so they stay stable across levels.
+    /// </summary>
+    public void Clear()
+    {
+        _byName.Clear();
+        _byModel.Clear();
+        _precached.Clear();
+        _precachedSet.Clear();
+        LateBuilds = 0;
+    }
+
+    internal static Utf8View ModelName(model_t* model) => new((NChar*)&model->name);
+
+    internal static StudioModelInfo? Load(string name, string? gameDirectory, out string? error)
+    {
+        error = null;
+        var path = GamePaths.Find(gameDirectory, name);
+        if (path == null)
+        {
+            error = "not found on disk";
+            return null;
+        }
+
+        try
+        {
+            using var file = StudioModelFile.Open(path);
+            return StudioModelInfo.Build(name, file);
+        }
+        catch (Exception ex) when (ex is IOException or InvalidDataException or UnauthorizedAccessException)
+        {
+            error = ex.Message;
+            return null;
+        }
+    }
+}
@@ -0,0 +1,193 @@
+using System.IO.MemoryMappedFiles;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+
+namespace GoldsrcFramework.Models;
+
+/// <summary>
+/// Read-only view over a studio model (.mdl, IDST version 10), either memory-mapped from disk or over an in-memory buffer.
+/// The header and every table it points to are bounds-checked on open, so the spans below can be walked without
+/// further checks (parent bones come before their children, hitbox / attachment / controller bones exist, sequence
+/// groups and blends are in range).
+/// </summary>
+public sealed unsafe class StudioModelFile : IDisposable
+{
+    private readonly MemoryMappedFile? _mappedFile;
+    private readonly MemoryMappedViewAccessor? _view;
+    private readonly GCHandle _pinned;
+    private byte* _base;
+    private readonly long _length;
+
+    private StudioModelFile(MemoryMappedFile mappedFile, MemoryMappedViewAccessor view, long length)
+    {
+        _mappedFile = mappedFile;
+        _view = view;
+        _length = length;
+
+        byte* ptr = null;
+        view.SafeMemoryMappedViewHandle.AcquirePointer(ref ptr);
+        _base = ptr + view.PointerOffset;
+        try
+        {
+            Validate();
+        }
+        catch
+        {
+            Dispose();
+            throw;
+        }
+    }
+
+    private StudioModelFile(byte[] data)
+    {
+        _pinned = GCHandle.Alloc(data, GCHandleType.Pinned);
+        _base = (byte*)_pinned.AddrOfPinnedObject();
+        _length = data.Length;
+        try
+        {
+            Validate();
+        }
+        catch
+        {
+            Dispose();
+            throw;
+        }
+    }
+
+    /// <summary>
+    /// Memory-map a .mdl file.
+    /// </summary>
+    public static StudioModelFile Open(string path)
+    {
+        long length = new FileInfo(path).Length;
+        if (length < sizeof(studiohdr_t))
+            throw new InvalidDataException("File is too small to be a studio model");
+
+        var mappedFile = MemoryMappedFile.CreateFromFile(path, FileMode.Open, null, 0, MemoryMappedFileAccess.Read);
+        try
+        {
+            var view = mappedFile.CreateViewAccessor(0, length, MemoryMappedFileAccess.Read);
+            return new StudioModelFile(mappedFile, view, length);
+        }
+        catch
+        {
+            mappedFile.Dispose();
+            throw;
+        }
+    }
+
+    /// <summary>
+    /// Wrap an in-memory .mdl image. The array is pinned for the lifetime of the view.
+    /// </summary>
+    public static StudioModelFile FromBytes(byte[] data) => new(data);
+
+    /// <summary>
+    /// Size of the file in bytes.
+    /// </summary>
+    public long Length => _length;
+
+    public ref readonly studiohdr_t Header => ref *(studiohdr_t*)_base;
+
+    /// <summary>
+    /// The header as the engine sees it after Mod_Extradata, for code shared with the renderer.
+    /// </summary>
+    public studiohdr_t* Pointer => (studiohdr_t*)_base;
+
+    public ReadOnlySpan<mstudiobone_t> Bones => Table<mstudiobone_t>(Header.boneindex, Header.numbones);
+    public ReadOnlySpan<mstudiobonecontroller_t> BoneControllers => Table<mstudiobonecontroller_t>(Header.bonecontrollerindex, Header.numbonecontrollers);
+    public ReadOnlySpan<mstudiobbox_t> Hitboxes => Table<mstudiobbox_t>(Header.hitboxindex, Header.numhitboxes);
+    public ReadOnlySpan<mstudioseqdesc_t> Sequences => Table<mstudioseqdesc_t>(Header.seqindex, Header.numseq);
+    public ReadOnlySpan<mstudioseqgroup_t> SequenceGroups => Table<mstudioseqgroup_t>(Header.seqgroupindex, Header.numseqgroups);
+    public ReadOnlySpan<mstudiobodyparts_t> BodyParts => Table<mstudiobodyparts_t>(Header.bodypartindex, Header.numbodyparts);
+    public ReadOnlySpan<mstudioattachment_t> Attachments => Table<mstudioattachment_t>(Header.attachmentindex, Header.numattachments);
+
+    private ReadOnlySpan<T> Table<T>(int offset, int count) where T : unmanaged =>
+        count <= 0 ? default : new ReadOnlySpan<T>(_base + offset, count);
+
+    private void Validate()
+    {
+        if (_length < sizeof(studiohdr_t))
+            throw new InvalidDataException("File is too small to be a studio model");
+
+        ref readonly var h = ref Header;
+        if (h.id != StudioConstants.IDSTUDIOHEADER)
+            throw new InvalidDataException(h.id == StudioConstants.IDSTUDIOSEQHEADER
+                ? "File is a sequence group, not a studio model"
+                : "Not a studio model (bad IDST header)");
+        if (h.version != StudioConstants.STUDIO_VERSION)
+            throw new InvalidDataException($"Wrong studio model version {h.version} (should be {StudioConstants.STUDIO_VERSION})");
+
+        CheckTable("bones", h.boneindex, h.numbones, sizeof(mstudiobone_t), StudioConstants.MAXSTUDIOBONES);
+        CheckTable("bone controllers", h.bonecontrollerindex, h.numbonecontrollers, sizeof(mstudiobonecontroller_t), StudioConstants.MAXSTUDIOCONTROLLERS);
+        CheckTable("hitboxes", h.hitboxindex, h.numhitboxes, sizeof(mstudiobbox_t), int.MaxValue);
+        CheckTable("sequences", h.seqindex, h.numseq, sizeof(mstudioseqdesc_t), StudioConstants.MAXSTUDIOSEQUENCES);
+        CheckTable("sequence groups", h.seqgroupindex, h.numseqgroups, sizeof(mstudioseqgroup_t), StudioConstants.MAXSTUDIOGROUPS);
+        CheckTable("textures", h.textureindex, h.numtextures, sizeof(mstudiotexture_t), StudioConstants.MAXSTUDIOSKINS);
+        CheckTable("skins", h.skinindex, h.numskinref * Math.Max(h.numskinfamilies, 0), sizeof(short), int.MaxValue);
+        CheckTable("body parts", h.bodypartindex, h.numbodyparts, sizeof(mstudiobodyparts_t), StudioConstants.MAXSTUDIOBODYPARTS);
+        CheckTable("attachments", h.attachmentindex, h.numattachments, sizeof(mstudioattachment_t), int.MaxValue);
+
+        var bones = Bones;
+        for (int i = 0; i < bones.Length; i++)
+        {
+            // The renderer builds transforms in one forward pass, so a parent must precede its children.
+            if (bones[i].parent < -1 || bones[i].parent >= i)
+                throw new InvalidDataException($"Bone {i} has invalid parent {bones[i].parent}");
+        }
+
+        foreach (ref readonly var controller in BoneControllers)
+            CheckBone("Bone controller", controller.bone, bones.Length);
+        foreach (ref readonly var hitbox in Hitboxes)
+            CheckBone("Hitbox", hitbox.bone, bones.Length);
+        foreach (ref readonly var attachment in Attachments)
+            CheckBone("Attachment", attachment.bone, bones.Length);
+
+        var sequences = Sequences;
+        for (int i = 0; i < sequences.Length; i++)
+        {
+            ref readonly var seq = ref sequences[i];
+            if (seq.numblends < 1 || seq.numblends > 4)
+                throw new InvalidDataException($"Sequence {i} has {seq.numblends} blends");
+            if (seq.seqgroup < 0 || seq.seqgroup >= Math.Max(h.numseqgroups, 1))
+                throw new InvalidDataException($"Sequence {i} is in missing group {seq.seqgroup}");
+            if (seq.numframes < 1)
+                throw new InvalidDataException($"Sequence {i} has no frames");
+            // Animations of group 0 live in this file; the others are checked when their file is loaded.
+            if (seq.seqgroup == 0)
+                CheckTable($"sequence {i} animations", seq.animindex, seq.numblends * bones.Length, sizeof(mstudioanim_t), int.MaxValue);
+        }
+
+        foreach (ref readonly var part in BodyParts)
+            CheckTable("body part models", part.modelindex, part.nummodels, sizeof(mstudiomodel_t), StudioConstants.MAXSTUDIOMODELS);
+    }
+
+    private void CheckTable(string name, int offset, int count, int size, int max)
+    {
+        if (count < 0 || count > max)
+            throw new InvalidDataException($"Bad {name} count {count}");
+        if (count > 0 && (offset < 0 || (long)offset + (long)count * size > _length))
+            throw new InvalidDataException($"{char.ToUpperInvariant(name[0])}{name[1..]} are out of bounds");
+    }
+
+    private static void CheckBone(string what, int bone, int boneCount)
+    {
+        if ((uint)bone >= (uint)boneCount)
+            throw new InvalidDataException($"{what} refers to missing bone {bone}");
+    }
+
+    public void Dispose()
+    {
+        if (_base == null)
+            return;
+
+        _base = null;
+        if (_view != null)
+        {
+            _view.SafeMemoryMappedViewHandle.ReleasePointer();
+            _view.Dispose();
+            _mappedFile!.Dispose();
+        }
+        if (_pinned.IsAllocated)
+            _pinned.Free();
+    }
+}
@@ -0,0 +1,249 @@
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Strings;
+using NativeInterop;
+
+namespace GoldsrcFramework.Models;
+
+/// <summary>
+/// Summary of one sequence descriptor.
+/// </summary>
+public readonly record struct StudioSequenceInfo(
+    int Frames,
+    float Fps,
+    int Blends,
+    int Group,
+    int Activity,
+    int ActivityWeight,
+    int Flags,
+    int Events);
+
+/// <summary>
+/// Everything derived from a studio model that does not change while it is loaded, built once off the main thread
+/// by <see cref="ModelPrewarm"/> (or on first use for models it did not see): bone hierarchy and names, hitboxes
+/// grouped by bone, sequence / activity lookups, sequence group files, and the bone remap table used to merge
+/// bones between models (weapon on player) without comparing names every frame.
+/// </summary>
+public sealed class StudioModelInfo
+{
+    private readonly Utf8Map<int> _bonesByName;
+    private readonly Utf8Map<int> _sequencesByLabel;
+    private readonly int[] _childStart;
+    private readonly int[] _children;
+    private readonly int[] _hitboxStart;
+    private readonly mstudiobbox_t[] _hitboxes;
+    private readonly int[] _activityStart;
+    private readonly int[] _activitySequences;
+    private readonly int[] _activities;
+    private int[] _boneNameIds = Array.Empty<int>();
+    private short[] _boneByNameId = Array.Empty<short>();
+
+    private StudioModelInfo(string name, StudioModelFile file)
+    {
+        Name = name;
+        FileLength = file.Length;
+        ref readonly var header = ref file.Header;
+        Flags = header.flags;
+        Mins = header.bbmin;
+        Maxs = header.bbmax;
+        EyePosition = header.eyeposition;
+
+        // Bones: parents, names, children in CSR form (parents precede children, checked by StudioModelFile).
+        var bones = file.Bones;
+        BoneParents = new short[bones.Length];
+        BoneNames = new string[bones.Length];
+        _bonesByName = new Utf8Map<int>(ignoreCase: false, capacity: Math.Max(bones.Length, 4));
+        _childStart = new int[bones.Length + 1];
+        var parents = new int[bones.Length];
+        for (int i = 0; i < bones.Length; i++)
+        {
+            var boneName = NameOf(bones[i].name);
+            BoneParents[i] = (short)bones[i].parent;
+            parents[i] = bones[i].parent;
+            BoneNames[i] = boneName.ToString();
+            // Like StudioMergeBones' linear search, the first bone of a name wins.
+            _bonesByName.TryAdd(boneName, i);
+            if (bones[i].parent >= 0)
+                _childStart[bones[i].parent + 1]++;
+        }
+        _children = BuildCsr(_childStart, parents);
+
+        // Hitboxes grouped by bone, stable within a bone.
+        var hitboxes = file.Hitboxes;
+        _hitboxStart = new int[bones.Length + 1];
+        var hitboxBones = new int[hitboxes.Length];
+        for (int i = 0; i < hitboxes.Length; i++)
+        {
+            hitboxBones[i] = hitboxes[i].bone;
+            _hitboxStart[hitboxBones[i] + 1]++;
+        }
+        var order = BuildCsr(_hitboxStart, hitboxBones);
+        _hitboxes = new mstudiobbox_t[hitboxes.Length];
+        for (int i = 0; i < order.Length; i++)
+            _hitboxes[i] = hitboxes[order[i]];
+
+        // Sequences, by label (case-insensitive, as LookupSequence uses stricmp) and by activity.
+        var sequences = file.Sequences;
+        Sequences = new StudioSequenceInfo[sequences.Length];
+        _sequencesByLabel = new Utf8Map<int>(ignoreCase: true, capacity: Math.Max(sequences.Length, 4));
+        var activities = new SortedSet<int>();
+        for (int i = 0; i < sequences.Length; i++)
+        {
+            ref readonly var seq = ref sequences[i];
+            Sequences[i] = new StudioSequenceInfo(seq.numframes, seq.fps, seq.numblends, seq.seqgroup,
+                seq.activity, seq.actweight, seq.flags, seq.numevents);
+            _sequencesByLabel.TryAdd(NameOf(seq.label), i);
+            if (seq.activity != 0)
+                activities.Add(seq.activity);
+        }
+        _activities = activities.ToArray();
+        _activityStart = new int[_activities.Length + 1];
+        var sequenceActivities = new int[sequences.Length];
+        for (int i = 0; i < sequences.Length; i++)
+        {
+            sequenceActivities[i] = Array.BinarySearch(_activities, sequences[i].activity);
+            if (sequenceActivities[i] >= 0)
+                _activityStart[sequenceActivities[i] + 1]++;
+        }
+        _activitySequences = BuildCsr(_activityStart, sequenceActivities);
+
+        var groups = file.SequenceGroups;
+        SequenceGroupFiles = new string[Math.Max(groups.Length - 1, 0)];
+        for (int i = 1; i < groups.Length; i++)
+            SequenceGroupFiles[i - 1] = NameOf(groups[i].name).ToString();
+
+        AttachmentBones = new short[file.Attachments.Length];
+        for (int i = 0; i < AttachmentBones.Length; i++)
+            AttachmentBones[i] = (short)file.Attachments[i].bone;
+    }
+
+    /// <summary>
+    /// Build from a validated file. Safe to call from any thread; the result is read-only once published.
+    /// </summary>
+    public static StudioModelInfo Build(string name, StudioModelFile file) => new(name, file);
+
+    /// <summary>
+    /// Path as precached, e.g. models/player.mdl.
+    /// </summary>
+    public string Name { get; }
+
+    public long FileLength { get; }
+
+    public int Flags { get; }
+
+    public LinearMath.Vector3 Mins { get; }
+
+    public LinearMath.Vector3 Maxs { get; }
+
+    public LinearMath.Vector3 EyePosition { get; }
+
+    public int BoneCount => BoneParents.Length;
+
+    /// <summary>
+    /// Parent of each bone, -1 for roots. Parents always come before their children.
+    /// </summary>
+    public short[] BoneParents { get; }
+
+    public string[] BoneNames { get; }
+
+    public StudioSequenceInfo[] Sequences { get; }
+
+    /// <summary>
+    /// Files of sequence groups 1..n (group 0 is the model itself), e.g. models/scientist01.mdl.
+    /// </summary>
+    public string[] SequenceGroupFiles { get; }
+
+    public short[] AttachmentBones { get; }
+
+    public int HitboxCount => _hitboxes.Length;
+
+    public ReadOnlySpan<int> GetChildren(int bone) => _children.AsSpan(_childStart[bone], _childStart[bone + 1] - _childStart[bone]);
+
+    /// <summary>
+    /// Hitboxes attached to <paramref name="bone"/>.
+    /// </summary>
+    public ReadOnlySpan<mstudiobbox_t> GetHitboxes(int bone) => _hitboxes.AsSpan(_hitboxStart[bone], _hitboxStart[bone + 1] - _hitboxStart[bone]);
+
+    /// <summary>
+    /// All hitboxes, grouped by bone.
+    /// </summary>
+    public ReadOnlySpan<mstudiobbox_t> Hitboxes => _hitboxes;
+
+    public int FindBone(Utf8View name) => _bonesByName.TryGetValue(name, out int bone) ? bone : -1;
+
+    public int FindSequence(Utf8View label) => _sequencesByLabel.TryGetValue(label, out int sequence) ? sequence : -1;
+
+    /// <summary>
+    /// Sequences playing <paramref name="activity"/>, in model order; pick among them by <see cref="StudioSequenceInfo.ActivityWeight"/>.
+    /// </summary>
+    public ReadOnlySpan<int> GetSequencesForActivity(int activity)
+    {
+        int a = Array.BinarySearch(_activities, activity);
+        return a < 0 ? default : _activitySequences.AsSpan(_activityStart[a], _activityStart[a + 1] - _activityStart[a]);
+    }
+
+    /// <summary>
+    /// Id of each bone's name in the owning <see cref="StudioModelCache"/>.
+    /// </summary>
+    public ReadOnlySpan<int> BoneNameIds => _boneNameIds;
+
+    /// <summary>
+    /// Bone of this model with the name <paramref name="nameId"/>, or -1. Ids come from the same cache, so
+    /// <c>parent.BoneForNameId(child.BoneNameIds[i])</c> is the remap from a child bone to its parent's.
+    /// </summary>
+    public int BoneForNameId(int nameId) => (uint)nameId < (uint)_boneByNameId.Length ? _boneByNameId[nameId] : -1;
+
+    /// <summary>
+    /// Bind bone names to cache-wide ids. Called by the cache on the main thread before the info is published;
+    /// names interned later get larger ids, which <see cref="BoneForNameId"/> correctly reports as absent.
+    /// </summary>
+    internal void BindNameIds(Utf8Map<int> names)
+    {
+        var ids = new int[BoneNames.Length];
+        int max = -1;
+        for (int i = 0; i < ids.Length; i++)
+        {
+            var name = new Utf8View(System.Text.Encoding.UTF8.GetBytes(BoneNames[i]));
+            if (!names.TryGetValue(name, out ids[i]))
+            {
+                ids[i] = names.Count;
+                names.Set(name, ids[i]);
+            }
+            max = Math.Max(max, ids[i]);
+        }
+
+        var byId = new short[max + 1];
+        byId.AsSpan().Fill(-1);
+        for (int i = ids.Length - 1; i >= 0; i--)
+            byId[ids[i]] = (short)i;
+
+        _boneNameIds = ids;
+        _boneByNameId = byId;
+    }
+
+    private static unsafe Utf8View NameOf<T>(in T fixedName) where T : unmanaged
+    {
+        fixed (T* p = &fixedName)
+        {
+            var bytes = new ReadOnlySpan<byte>(p, sizeof(T));
+            int end = bytes.IndexOf((byte)0);
+            return new Utf8View(end < 0 ? bytes : bytes[..end]);
+        }
+    }
+
+    // Counting sort of item indices by bucket (negative = none): counts[k + 1] holds the size of bucket k on entry,
+    // bucket starts on exit.
+    private static int[] BuildCsr(int[] counts, int[] buckets)
+    {
+        for (int i = 1; i < counts.Length; i++)
+            counts[i] += counts[i - 1];
+
+        var items = new int[counts[^1]];
+        var next = counts.AsSpan(0, counts.Length - 1).ToArray();
+        for (int i = 0; i < buckets.Length; i++)
+        {
+            if (buckets[i] >= 0)
+                items[next[buckets[i]]++] = i;
+        }
+        return items;
+    }
+}
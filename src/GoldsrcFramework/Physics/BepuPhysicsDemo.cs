@@ -1,5 +1,3 @@
-using System.Reflection;
-using System.Runtime.CompilerServices;
 using Stride.BepuPhysics;
 using Stride.BepuPhysics.Definitions.Colliders;
 using Stride.BepuPhysics.Systems;
@@ -25,8 +23,8 @@ namespace GoldsrcFramework.Physics;
 /// The only "non-standard" parts are:
 /// - Minimal ServiceRegistry (no Game/Scene/EntityManager needed)
 /// - Dummy ShapeCacheSystem (we don't use AppendModel debug rendering)
-/// - Reflection to call internal methods (CollidableProcessor.OnSystemAdd, OnEntityComponentAdding,
-///   BepuSimulation.Update)
+/// - Internal methods (CollidableProcessor.OnSystemAdd, OnEntityComponentAdding, BepuSimulation.Update)
+///   called through compiled accessors in <see cref="StrideInternals"/>
 /// </summary>
 public class BepuPhysicsDemo
 {
@@ -39,12 +37,6 @@ public class BepuPhysicsDemo
     private readonly SVector3 _boxHalfSize = new(10f, 10f, 10f);
     private readonly SVector3 _initialPosition = new(0f, 0f, 200f);
 
-    // Cached reflection delegates for per-frame calls
-    private static readonly Action<BepuSimulation, TimeSpan> s_bepuSimulationUpdate;
-    private static readonly Action<CollidableProcessor> s_processorOnSystemAdd;
-    private static readonly Action<CollidableProcessor, Stride.Engine.Entity, CollidableComponent, CollidableComponent> s_processorOnEntityComponentAdding;
-    private static readonly Action<EntityProcessor, IServiceRegistry> s_setProcessorServices;
-
     public bool Initialized { get; private set; }
 
     /// <summary>
@@ -69,32 +61,6 @@ public class BepuPhysicsDemo
     /// </summary>
     public SQuaternion BoxRotation => _boxEntity.Transform.Rotation;
 
-    static BepuPhysicsDemo()
-    {
-        // --- Cache reflection delegates (one-time cost) ---
-
-        // BepuSimulation.Update(TimeSpan) — internal, handles Timestep + SyncActiveTransformsWithPhysics
-        var updateMethod = typeof(BepuSimulation).GetMethod("Update",
-            BindingFlags.Instance | BindingFlags.NonPublic)!;
-        s_bepuSimulationUpdate = (sim, time) => updateMethod.Invoke(sim, [time]);
-
-        // CollidableProcessor.OnSystemAdd() — protected, wires up BepuConfiguration & ShapeCache from services
-        var onSystemAddMethod = typeof(CollidableProcessor).GetMethod("OnSystemAdd",
-            BindingFlags.Instance | BindingFlags.NonPublic)!;
-        s_processorOnSystemAdd = proc => onSystemAddMethod.Invoke(proc, null);
-
-        // CollidableProcessor.OnEntityComponentAdding(Entity, CollidableComponent, CollidableComponent) — protected
-        var onEntityAddingMethod = typeof(CollidableProcessor).GetMethod("OnEntityComponentAdding",
-            BindingFlags.Instance | BindingFlags.NonPublic)!;
-        s_processorOnEntityComponentAdding = (proc, entity, comp, data) =>
-            onEntityAddingMethod.Invoke(proc, [entity, comp, data]);
-
-        // EntityProcessor.Services — public get, internal set
-        var servicesProp = typeof(EntityProcessor).GetProperty("Services",
-            BindingFlags.Instance | BindingFlags.Public)!;
-        s_setProcessorServices = (proc, svc) => servicesProp.SetValue(proc, svc);
-    }
-
     /// <summary>
     /// Initialize the physics pipeline and create the box entity via Stride ECS.
     /// </summary>
@@ -109,31 +75,8 @@ public class BepuPhysicsDemo
             PoseGravity = new SVector3(0, 0, -800f) // Match Goldsrc gravity
         };
 
-        // 2. Create BepuConfiguration with our simulation
-        var bepuConfig = new BepuConfiguration
-        {
-            BepuSimulations = [_bepuSimulation]
-        };
-
-        // 3. Create ServiceRegistry and register required services
-        _serviceRegistry = new ServiceRegistry();
-        _serviceRegistry.AddService(bepuConfig);
-
-        // Dummy ShapeCacheSystem: we never call AppendModel (debug rendering),
-        // and BoxCollider.AddToCompoundBuilder doesn't use ShapeCache at all.
-        // Using GetUninitializedObject avoids the Graphics-dependent constructor.
-        // ShapeCacheSystem is internal, so we must use reflection to get its type.
-        var shapeCacheType = typeof(BepuSimulation).Assembly.GetType("Stride.BepuPhysics.Systems.ShapeCacheSystem")!;
-        var dummyShapeCache = RuntimeHelpers.GetUninitializedObject(shapeCacheType);
-
-        // Register via reflection: _serviceRegistry.AddService<T>(service)
-        var addServiceMethod = typeof(ServiceRegistry).GetMethod("AddService")!.MakeGenericMethod(shapeCacheType);
-        addServiceMethod.Invoke(_serviceRegistry, [dummyShapeCache]);
-
-        // 4. Create CollidableProcessor and initialize it (OnSystemAdd wires up services)
-        _collidableProcessor = new CollidableProcessor();
-        s_setProcessorServices(_collidableProcessor, _serviceRegistry);
-        s_processorOnSystemAdd(_collidableProcessor);
+        // 2-4. BepuConfiguration + minimal ServiceRegistry (with dummy ShapeCacheSystem) + initialized CollidableProcessor
+        _collidableProcessor = StrideInternals.CreateProcessor(_bepuSimulation, out _serviceRegistry);
 
         // 5. Create entity with BodyComponent + BoxCollider — the Stride way
         _boxEntity = new SEntity("PhysicsBox");
@@ -156,7 +99,7 @@ public class BepuPhysicsDemo
 
         // 7. Attach entity to simulation via CollidableProcessor
         //    This triggers: ReAttach → Collider.TryAttach (creates BEPU shape) → AttachInner (creates BEPU body, sets BodyReference)
-        s_processorOnEntityComponentAdding(_collidableProcessor, _boxEntity, _bodyComponent, _bodyComponent);
+        StrideInternals.ProcessorOnEntityComponentAdding(_collidableProcessor, _boxEntity, _bodyComponent, _bodyComponent);
 
         Initialized = true;
     }
@@ -178,7 +121,7 @@ public class BepuPhysicsDemo
         if (deltaTime <= 0 || deltaTime > 0.1f)
             deltaTime = 1f / 60f;
 
-        s_bepuSimulationUpdate(_bepuSimulation, TimeSpan.FromSeconds(deltaTime));
+        StrideInternals.BepuSimulationUpdate(_bepuSimulation, TimeSpan.FromSeconds(deltaTime));
     }
 
     /// <summary>
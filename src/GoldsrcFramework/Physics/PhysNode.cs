@@ -3,14 +3,161 @@ using System.Collections.Generic;
 using System.Linq;
 using System.Text;
 using System.Threading.Tasks;
+using GoldsrcFramework.Engine.Native;
+using Stride.BepuPhysics;
+
+using SVector3 = Stride.Core.Mathematics.Vector3;
+using SQuaternion = Stride.Core.Mathematics.Quaternion;
+using SEntity = Stride.Engine.Entity;
+using GVector3 = GoldsrcFramework.LinearMath.Vector3;
 
 namespace GoldsrcFramework.Physics
 {
     /// <summary>
     /// 添加一个节点类尝试用于抽象 Goldsrc 中拥有 Transform 的对象，例如 Entity, Studio model bone, attachment 等等。
     /// 这是一个实验性质的类，看看能否用来简化物理系统的实现，如果具有可行性，可以扩展到物理系统以外的用途。
+    /// 目前用于把 <see cref="PhysicsWorld"/> 中的一个刚体绑定到一个 edict，由 PhysicsWorld 在 StartFrame 中批量同步。
     /// </summary>
-    public class PhysNode
+    public unsafe class PhysNode
     {
+        internal PhysNode(PhysicsWorld world, SEntity entity, BodyComponent body)
+        {
+            World = world;
+            Entity = entity;
+            Body = body;
+        }
+
+        /// <summary>
+        /// Owning world.
+        /// </summary>
+        public PhysicsWorld World { get; }
+
+        /// <summary>
+        /// Stride entity holding the body component.
+        /// </summary>
+        public SEntity Entity { get; }
+
+        /// <summary>
+        /// The Bepu body.
+        /// </summary>
+        public BodyComponent Body { get; }
+
+        /// <summary>
+        /// Bound edict, or null for a body that only lives in the simulation.
+        /// </summary>
+        public edict_t* Edict { get; private set; }
+
+        /// <summary>
+        /// Edict drives the body (kinematic) instead of the body driving the edict.
+        /// </summary>
+        public bool EdictDriven { get; set; }
+
+        // Dense index in PhysicsWorld's node list, -1 once removed.
+        internal int Index = -1;
+
+        private int _serialNumber;
+
+        /// <summary>
+        /// Bind the node to an edict. The binding is dropped automatically when the edict slot is freed or reused.
+        /// </summary>
+        public void Bind(edict_t* edict, bool edictDriven = false)
+        {
+            Edict = edict;
+            EdictDriven = edictDriven;
+            _serialNumber = edict != null ? edict->serialnumber : 0;
+            Body.Kinematic = edictDriven;
+        }
+
+        /// <summary>
+        /// Edict still refers to the entity this node was bound to.
+        /// </summary>
+        internal bool IsEdictValid()
+        {
+            var e = Edict;
+            if (e == null)
+                return false;
+
+            if (e->free.Value != 0 || e->serialnumber != _serialNumber)
+            {
+                Edict = null;
+                return false;
+            }
+
+            return true;
+        }
+
+        /// <summary>
+        /// edict → body: pev->origin / angles / velocity to the body pose.
+        /// </summary>
+        internal void PullFromEdict()
+        {
+            ref var v = ref Edict->v;
+            Body.Teleport(new SVector3(v.origin.X, v.origin.Y, v.origin.Z), AnglesToQuaternion(v.angles));
+            Body.LinearVelocity = new SVector3(v.velocity.X, v.velocity.Y, v.velocity.Z);
+        }
+
+        /// <summary>
+        /// body → edict: body pose and velocity to pev->origin / angles / velocity.
+        /// </summary>
+        internal void PushToEdict()
+        {
+            ref var v = ref Edict->v;
+            var position = Body.Position;
+            var velocity = Body.LinearVelocity;
+            v.origin = new GVector3(position.X, position.Y, position.Z);
+            v.angles = QuaternionToAngles(Body.Orientation);
+            v.velocity = new GVector3(velocity.X, velocity.Y, velocity.Z);
+        }
+
+        /// <summary>
+        /// Goldsrc angles (pitch, yaw, roll in degrees, Z-up) to a quaternion.
+        /// Same rotation order as AngleMatrix in mathlib.
+        /// </summary>
+        public static SQuaternion AnglesToQuaternion(GVector3 angles)
+        {
+            const float HalfDegToRad = MathF.PI / 360f;
+
+            var (sp, cp) = MathF.SinCos(angles.X * HalfDegToRad);
+            var (sy, cy) = MathF.SinCos(angles.Y * HalfDegToRad);
+            var (sr, cr) = MathF.SinCos(angles.Z * HalfDegToRad);
+
+            return new SQuaternion(
+                sr * cp * cy - cr * sp * sy,
+                cr * sp * cy + sr * cp * sy,
+                cr * cp * sy - sr * sp * cy,
+                cr * cp * cy + sr * sp * sy);
+        }
+
+        /// <summary>
+        /// Quaternion to Goldsrc angles (pitch, yaw, roll in degrees).
+        /// Same decomposition as MatrixAngles in mathlib.
+        /// </summary>
+        public static GVector3 QuaternionToAngles(SQuaternion q)
+        {
+            const float RadToDeg = 180f / MathF.PI;
+
+            float xx = q.X * q.X, yy = q.Y * q.Y, zz = q.Z * q.Z;
+            float xy = q.X * q.Y, xz = q.X * q.Z, yz = q.Y * q.Z;
+            float wx = q.W * q.X, wy = q.W * q.Y, wz = q.W * q.Z;
+
+            // forward = rotated +X, left = rotated +Y, up = rotated +Z
+            float fx = 1 - 2 * (yy + zz), fy = 2 * (xy + wz), fz = 2 * (xz - wy);
+            float lx = 2 * (xy - wz), ly = 1 - 2 * (xx + zz), lz = 2 * (yz + wx);
+            float uz = 1 - 2 * (xx + yy);
+
+            float xyDist = MathF.Sqrt(fx * fx + fy * fy);
+            if (xyDist > 0.001f)
+            {
+                return new GVector3(
+                    MathF.Atan2(-fz, xyDist) * RadToDeg,
+                    MathF.Atan2(fy, fx) * RadToDeg,
+                    MathF.Atan2(lz, uz) * RadToDeg);
+            }
+
+            return new GVector3(
+                MathF.Atan2(-fz, xyDist) * RadToDeg,
+                MathF.Atan2(-lx, ly) * RadToDeg,
+                0);
+        }
     }
 }
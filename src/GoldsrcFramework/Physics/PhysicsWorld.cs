@@ -0,0 +1,283 @@
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using BepuUtilities;
+using GoldsrcFramework.Engine.Native;
+using Stride.BepuPhysics;
+using Stride.BepuPhysics.Definitions.Colliders;
+using Stride.BepuPhysics.Systems;
+using Stride.Core;
+
+using SVector3 = Stride.Core.Mathematics.Vector3;
+using SQuaternion = Stride.Core.Mathematics.Quaternion;
+using SEntity = Stride.Engine.Entity;
+
+namespace GoldsrcFramework.Physics;
+
+/// <summary>
+/// Per-frame counters reported by <see cref="PhysicsWorld"/>.
+/// </summary>
+public struct PhysicsFrameStats
+{
+    /// <summary>Fixed steps taken this frame.</summary>
+    public int Steps;
+    /// <summary>Frame time that was dropped because MaxStepsPerFrame was reached.</summary>
+    public float DroppedTime;
+    /// <summary>Nodes synced edict → body before stepping.</summary>
+    public int Pulled;
+    /// <summary>Nodes synced body → edict after stepping.</summary>
+    public int Pushed;
+    /// <summary>Time spent in Simulation.Timestep.</summary>
+    public double StepMilliseconds;
+    /// <summary>Time spent syncing edicts.</summary>
+    public double SyncMilliseconds;
+}
+
+/// <summary>
+/// Server-side physics world on top of Stride's BepuSimulation.
+///
+/// - Fixed-timestep accumulator; each step runs Simulation.Timestep with the configured solver substeps.
+/// - Steps through a ThreadDispatcher owned by the world, sized to the core count unless configured.
+/// - Bodies are bound to edicts through <see cref="PhysNode"/> and synced in one batch per frame:
+///   edict-driven nodes are pulled before stepping, simulated nodes are pushed to their edicts after.
+///
+/// Unlike <see cref="BepuPhysicsDemo"/>, this does not go through BepuSimulation.Update, so Stride transforms
+/// are not synced; edicts are the only consumers of body poses here.
+/// </summary>
+public sealed class PhysicsWorld : IDisposable
+{
+    private readonly BepuSimulation _simulation;
+    private readonly CollidableProcessor _processor;
+    private readonly ServiceRegistry _services;
+    private readonly ThreadDispatcher _threadDispatcher;
+    private readonly List<PhysNode> _nodes = new();
+    private readonly List<SEntity> _statics = new();
+
+    private double _accumulator;
+    private PhysicsFrameStats _stats;
+    private bool _disposed;
+
+    /// <summary>
+    /// Create a world.
+    /// </summary>
+    /// <param name="updateRate">Fixed step rate in Hz.</param>
+    /// <param name="substeps">Solver substeps per fixed step.</param>
+    /// <param name="maxStepsPerFrame">Upper bound on fixed steps per frame; excess time is dropped.</param>
+    /// <param name="threadCount">Solver threads; 0 uses Environment.ProcessorCount.</param>
+    public PhysicsWorld(int updateRate = 60, int substeps = 1, int maxStepsPerFrame = 4, int threadCount = 0)
+    {
+        FixedTimeStep = 1f / Math.Max(updateRate, 1);
+        MaxStepsPerFrame = Math.Max(maxStepsPerFrame, 1);
+
+        _simulation = new BepuSimulation
+        {
+            PoseGravity = new SVector3(0, 0, -800f) // Match Goldsrc gravity
+        };
+        _simulation.Simulation.Solver.SubstepCount = Math.Max(substeps, 1);
+
+        _threadDispatcher = new ThreadDispatcher(threadCount > 0 ? threadCount : Environment.ProcessorCount);
+        _processor = StrideInternals.CreateProcessor(_simulation, out _services);
+    }
+
+    /// <summary>
+    /// Create a world from the "Game" section of modSettings.json.
+    /// </summary>
+    public static PhysicsWorld FromSettings(Configuration.GameSettings settings)
+    {
+        return new PhysicsWorld(settings.PhysicsUpdateRate, settings.PhysicsSubsteps, settings.PhysicsMaxStepsPerFrame, settings.PhysicsThreadCount);
+    }
+
+    /// <summary>
+    /// Seconds per fixed step.
+    /// </summary>
+    public float FixedTimeStep { get; }
+
+    /// <summary>
+    /// Upper bound on fixed steps per frame.
+    /// </summary>
+    public int MaxStepsPerFrame { get; }
+
+    /// <summary>
+    /// Solver thread count.
+    /// </summary>
+    public int ThreadCount => _threadDispatcher.ThreadCount;
+
+    /// <summary>
+    /// Fraction of a fixed step left in the accumulator, for interpolating between the last two steps.
+    /// </summary>
+    public float Alpha => (float)(_accumulator / FixedTimeStep);
+
+    /// <summary>
+    /// The underlying Stride simulation.
+    /// </summary>
+    public BepuSimulation Simulation => _simulation;
+
+    /// <summary>
+    /// Live nodes.
+    /// </summary>
+    public IReadOnlyList<PhysNode> Nodes => _nodes;
+
+    /// <summary>
+    /// Counters from the last <see cref="Update"/> call.
+    /// </summary>
+    public PhysicsFrameStats LastFrame => _stats;
+
+    /// <summary>
+    /// Add a dynamic box body.
+    /// </summary>
+    public PhysNode AddBox(SVector3 halfSize, SVector3 position, SQuaternion rotation)
+    {
+        var entity = new SEntity();
+        var collider = new CompoundCollider();
+        collider.Colliders.Add(new BoxCollider { Size = halfSize * 2f });
+
+        var body = new BodyComponent { Collider = collider };
+        entity.Components.Add(body);
+        entity.Transform.Position = position;
+        entity.Transform.Rotation = rotation;
+
+        StrideInternals.ProcessorOnEntityComponentAdding(_processor, entity, body, body);
+
+        var node = new PhysNode(this, entity, body) { Index = _nodes.Count };
+        _nodes.Add(node);
+        return node;
+    }
+
+    /// <summary>
+    /// Add a static box, e.g. world geometry approximations.
+    /// </summary>
+    public void AddStaticBox(SVector3 halfSize, SVector3 position)
+    {
+        var entity = new SEntity();
+        var collider = new CompoundCollider();
+        collider.Colliders.Add(new BoxCollider { Size = halfSize * 2f });
+
+        var component = new StaticComponent { Collider = collider };
+        entity.Components.Add(component);
+        entity.Transform.Position = position;
+
+        StrideInternals.ProcessorOnEntityComponentAdding(_processor, entity, component, component);
+        _statics.Add(entity);
+    }
+
+    /// <summary>
+    /// Remove a node's body from the simulation.
+    /// </summary>
+    public void Remove(PhysNode node)
+    {
+        if (node.World != this || node.Index < 0)
+            return;
+
+        StrideInternals.ProcessorOnEntityComponentRemoved(_processor, node.Entity, node.Body, node.Body);
+
+        // Swap-remove to keep the node list dense for the sync loops.
+        int index = node.Index;
+        var last = _nodes[^1];
+        _nodes[index] = last;
+        last.Index = index;
+        _nodes.RemoveAt(_nodes.Count - 1);
+        node.Index = -1;
+    }
+
+    /// <summary>
+    /// Advance the world by <paramref name="frameTime"/> seconds. Call once per StartFrame with gpGlobals->frametime.
+    /// </summary>
+    /// <returns>Number of fixed steps taken.</returns>
+    public int Update(float frameTime)
+    {
+        _stats = default;
+        if (_disposed || frameTime <= 0)
+            return 0;
+
+        long start = Stopwatch.GetTimestamp();
+        PullEdicts();
+        long pulled = Stopwatch.GetTimestamp();
+
+        _accumulator += frameTime;
+        int steps = 0;
+        while (_accumulator >= FixedTimeStep && steps < MaxStepsPerFrame)
+        {
+            _simulation.Simulation.Timestep(FixedTimeStep, _threadDispatcher);
+            _accumulator -= FixedTimeStep;
+            steps++;
+        }
+
+        // Spiral of death: drop whatever we couldn't simulate this frame.
+        if (_accumulator >= FixedTimeStep)
+        {
+            _stats.DroppedTime = (float)(_accumulator - _accumulator % FixedTimeStep);
+            _accumulator %= FixedTimeStep;
+        }
+
+        long stepped = Stopwatch.GetTimestamp();
+        if (steps > 0)
+            PushEdicts();
+        long end = Stopwatch.GetTimestamp();
+
+        _stats.Steps = steps;
+        _stats.StepMilliseconds = Stopwatch.GetElapsedTime(pulled, stepped).TotalMilliseconds;
+        _stats.SyncMilliseconds = (Stopwatch.GetElapsedTime(start, pulled) + Stopwatch.GetElapsedTime(stepped, end)).TotalMilliseconds;
+        return steps;
+    }
+
+    private unsafe void PullEdicts()
+    {
+        var nodes = CollectionsMarshal.AsSpan(_nodes);
+        int pulled = 0;
+        foreach (var node in nodes)
+        {
+            if (node.EdictDriven && node.IsEdictValid())
+            {
+                node.PullFromEdict();
+                pulled++;
+            }
+        }
+        _stats.Pulled = pulled;
+    }
+
+    private unsafe void PushEdicts()
+    {
+        var nodes = CollectionsMarshal.AsSpan(_nodes);
+        int pushed = 0;
+        foreach (var node in nodes)
+        {
+            if (!node.EdictDriven && node.IsEdictValid())
+            {
+                node.PushToEdict();
+                pushed++;
+            }
+        }
+        _stats.Pushed = pushed;
+    }
+
+    /// <summary>
+    /// Remove every body. The world stays usable.
+    /// </summary>
+    public void Clear()
+    {
+        for (int i = _nodes.Count - 1; i >= 0; i--)
+            Remove(_nodes[i]);
+
+        foreach (var entity in _statics)
+        {
+            var component = entity.Get<StaticComponent>();
+            StrideInternals.ProcessorOnEntityComponentRemoved(_processor, entity, component, component);
+        }
+        _statics.Clear();
+        _accumulator = 0;
+    }
+
+    /// <summary>
+    /// Release physics resources.
+    /// </summary>
+    public void Dispose()
+    {
+        if (_disposed)
+            return;
+
+        _disposed = true;
+        _nodes.Clear();
+        _statics.Clear();
+        _threadDispatcher.Dispose();
+        _simulation.Dispose();
+    }
+}
@@ -0,0 +1,126 @@
+using System.Linq.Expressions;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using Stride.BepuPhysics;
+using Stride.BepuPhysics.Systems;
+using Stride.Core;
+using Stride.Engine;
+
+using SEntity = Stride.Engine.Entity;
+
+namespace GoldsrcFramework.Physics;
+
+/// <summary>
+/// Compiled accessors for the Stride internals needed to drive the Bepu pipeline without a Game/Scene.
+/// Members are resolved by reflection once and compiled to delegates, so per-frame and per-body calls
+/// cost a normal delegate invocation instead of MethodInfo.Invoke (no argument arrays, no boxing).
+/// </summary>
+internal static class StrideInternals
+{
+    /// <summary>
+    /// BepuSimulation.Update(TimeSpan) — internal; Timestep + SyncActiveTransformsWithPhysics.
+    /// </summary>
+    public static readonly Action<BepuSimulation, TimeSpan> BepuSimulationUpdate;
+
+    /// <summary>
+    /// CollidableProcessor.OnSystemAdd() — protected; wires up BepuConfiguration and ShapeCache from services.
+    /// </summary>
+    public static readonly Action<CollidableProcessor> ProcessorOnSystemAdd;
+
+    /// <summary>
+    /// CollidableProcessor.OnEntityComponentAdding(Entity, CollidableComponent, CollidableComponent) — protected.
+    /// </summary>
+    public static readonly Action<CollidableProcessor, SEntity, CollidableComponent, CollidableComponent> ProcessorOnEntityComponentAdding;
+
+    /// <summary>
+    /// CollidableProcessor.OnEntityComponentRemoved(Entity, CollidableComponent, CollidableComponent) — protected.
+    /// </summary>
+    public static readonly Action<CollidableProcessor, SEntity, CollidableComponent, CollidableComponent> ProcessorOnEntityComponentRemoved;
+
+    /// <summary>
+    /// EntityProcessor.Services — public get, internal set.
+    /// </summary>
+    public static readonly Action<EntityProcessor, IServiceRegistry> SetProcessorServices;
+
+    /// <summary>
+    /// ServiceRegistry.AddService&lt;ShapeCacheSystem&gt;(dummy) — ShapeCacheSystem is internal.
+    /// </summary>
+    public static readonly Action<ServiceRegistry> AddDummyShapeCache;
+
+    static StrideInternals()
+    {
+        const BindingFlags NonPublicInstance = BindingFlags.Instance | BindingFlags.NonPublic;
+
+        BepuSimulationUpdate = CompileCall<Action<BepuSimulation, TimeSpan>>(
+            typeof(BepuSimulation).GetMethod("Update", NonPublicInstance, [typeof(TimeSpan)])!);
+
+        ProcessorOnSystemAdd = CompileCall<Action<CollidableProcessor>>(
+            typeof(CollidableProcessor).GetMethod("OnSystemAdd", NonPublicInstance)!);
+
+        ProcessorOnEntityComponentAdding = CompileCall<Action<CollidableProcessor, SEntity, CollidableComponent, CollidableComponent>>(
+            typeof(CollidableProcessor).GetMethod("OnEntityComponentAdding", NonPublicInstance)!);
+
+        ProcessorOnEntityComponentRemoved = CompileCall<Action<CollidableProcessor, SEntity, CollidableComponent, CollidableComponent>>(
+            typeof(CollidableProcessor).GetMethod("OnEntityComponentRemoved", NonPublicInstance)!);
+
+        {
+            var servicesProp = typeof(EntityProcessor).GetProperty("Services", BindingFlags.Instance | BindingFlags.Public)!;
+            var proc = Expression.Parameter(typeof(EntityProcessor), "processor");
+            var services = Expression.Parameter(typeof(IServiceRegistry), "services");
+            var assign = Expression.Assign(Expression.Property(proc, servicesProp), Expression.Convert(services, servicesProp.PropertyType));
+            SetProcessorServices = Expression.Lambda<Action<EntityProcessor, IServiceRegistry>>(assign, proc, services).Compile();
+        }
+
+        {
+            // Dummy ShapeCacheSystem: we never call AppendModel (debug rendering), and BoxCollider.AddToCompoundBuilder
+            // doesn't use ShapeCache at all. GetUninitializedObject avoids the Graphics-dependent constructor.
+            var shapeCacheType = typeof(BepuSimulation).Assembly.GetType("Stride.BepuPhysics.Systems.ShapeCacheSystem")!;
+            var addService = typeof(ServiceRegistry).GetMethod("AddService")!.MakeGenericMethod(shapeCacheType);
+            var registry = Expression.Parameter(typeof(ServiceRegistry), "registry");
+            var create = Expression.Call(typeof(RuntimeHelpers).GetMethod(nameof(RuntimeHelpers.GetUninitializedObject))!, Expression.Constant(shapeCacheType));
+            var call = Expression.Call(registry, addService, Expression.Convert(create, shapeCacheType));
+            AddDummyShapeCache = Expression.Lambda<Action<ServiceRegistry>>(call, registry).Compile();
+        }
+    }
+
+    /// <summary>
+    /// Create a CollidableProcessor bound to <paramref name="simulation"/> with the minimal service registry it needs.
+    /// </summary>
+    public static CollidableProcessor CreateProcessor(BepuSimulation simulation, out ServiceRegistry services)
+    {
+        var bepuConfig = new BepuConfiguration
+        {
+            BepuSimulations = [simulation]
+        };
+
+        services = new ServiceRegistry();
+        services.AddService(bepuConfig);
+        AddDummyShapeCache(services);
+
+        var processor = new CollidableProcessor();
+        SetProcessorServices(processor, services);
+        ProcessorOnSystemAdd(processor);
+        return processor;
+    }
+
+    /// <summary>
+    /// Compile an open-instance call to <paramref name="method"/> whose parameters match <typeparamref name="TDelegate"/>
+    /// (the first delegate parameter is the instance), converting argument types where needed.
+    /// </summary>
+    private static TDelegate CompileCall<TDelegate>(MethodInfo method) where TDelegate : Delegate
+    {
+        var invoke = typeof(TDelegate).GetMethod("Invoke")!;
+        var parameters = invoke.GetParameters().Select(p => Expression.Parameter(p.ParameterType, p.Name)).ToArray();
+        var methodParams = method.GetParameters();
+
+        var instance = Expression.Convert(parameters[0], method.DeclaringType!);
+        var args = new Expression[methodParams.Length];
+        for (int i = 0; i < methodParams.Length; i++)
+        {
+            Expression arg = parameters[i + 1];
+            args[i] = arg.Type == methodParams[i].ParameterType ? arg : Expression.Convert(arg, methodParams[i].ParameterType);
+        }
+
+        return Expression.Lambda<TDelegate>(Expression.Call(instance, method, args), parameters).Compile();
+    }
+}
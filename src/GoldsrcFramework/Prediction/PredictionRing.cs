@@ -0,0 +1,356 @@
+using System.Numerics;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using NativeInterop;
+
+using Vector3 = GoldsrcFramework.LinearMath.Vector3;
+
+namespace GoldsrcFramework.Prediction;
+
+/// <summary>
+/// Counters reported by <see cref="PredictionRing"/> since the last reset.
+/// </summary>
+public struct PredictionStats
+{
+    /// <summary>Prediction passes (the engine runs one per frame).</summary>
+    public long Passes;
+    /// <summary>HUD_PostRunCmd calls.</summary>
+    public long Commands;
+    /// <summary>Commands run for the first time (runfuncs set); always simulated.</summary>
+    public long FirstRuns;
+    /// <summary>Already predicted commands that had to go through the weapon code again.</summary>
+    public long Resimulated;
+    /// <summary>Already predicted commands answered from the ring.</summary>
+    public long Reused;
+    /// <summary>Server states that matched what was predicted for the acknowledged command.</summary>
+    public long Confirmed;
+    /// <summary>Server states that did not; every command after them is re-run.</summary>
+    public long Mispredicts;
+    /// <summary>First field that differed in the last mispredict.</summary>
+    public string? LastMispredict;
+}
+
+/// <summary>
+/// Ring of predicted weapon states for client prediction, indexed by command number.
+///
+/// Each frame the engine re-runs every unacknowledged command from the last server state: movement, then
+/// HUD_PostRunCmd with to-&gt;client holding the movement result. The weapon code only depends on that and on
+/// from-&gt;client / from-&gt;weapondata, the command and the time, so a command whose inputs are unchanged since it
+/// was last predicted gets the same output. The ring keeps those inputs and outputs per command:
+/// <list type="number">
+/// <item><see cref="Acknowledge"/> (HUD_TxferPredictionData) keeps the server state of the acknowledged command;
+/// the next pass compares it with what was predicted for that command.</item>
+/// <item><see cref="TryReuse"/> (HUD_PostRunCmd) replays the stored output when the inputs are bit for bit the ones
+/// it was computed from; after the first mismatch every remaining command of the pass is simulated.</item>
+/// <item><see cref="Store"/> keeps the output of a command that was simulated.</item>
+/// </list>
+/// Only the mispredict count compares floats with the precision the server sends them at, so delta quantization alone
+/// is not reported as a mispredict; the commands after a quantized server state are still simulated again.
+/// The engine passes the command number as random_seed, which is what the ring is indexed by.
+/// </summary>
+public sealed unsafe class PredictionRing : IDisposable
+{
+    /// <summary>CL_UPDATE_BACKUP: the engine never has more unacknowledged commands than this.</summary>
+    public const int DefaultCapacity = 64;
+
+    /// <summary>Two steps of the 1/8 unit delta encoding of origins and velocities (mispredict check only).</summary>
+    public const float PositionTolerance = 0.25f;
+
+    /// <summary>Two steps of the 1 ms delta encoding of weapon timers (mispredict check only).</summary>
+    public const float TimeTolerance = 0.002f;
+
+    private const int MaxWeapons = 64;
+
+    [StructLayout(LayoutKind.Sequential)]
+    private struct Slot
+    {
+        public uint Sequence;
+        public int Valid;
+        public double Time;
+        public usercmd_t Cmd;
+        public clientdata_t From;
+        /// <summary>to-&gt;client before the weapon code ran (the movement result).</summary>
+        public clientdata_t Moved;
+        /// <summary>to-&gt;client after.</summary>
+        public clientdata_t Result;
+        public InlineArray64<weapon_data_t> FromWeapons;
+        public InlineArray64<weapon_data_t> Weapons;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    private struct ServerState
+    {
+        public clientdata_t Client;
+        public InlineArray64<weapon_data_t> Weapons;
+    }
+
+    private Slot* _slots;
+    private ServerState* _acknowledged;
+    private readonly int _mask;
+
+    private bool _acknowledgePending;
+    private bool _rerun;
+    private local_state_t* _lastTo;
+    private uint _lastSequence;
+    private PredictionStats _stats;
+
+    /// <param name="capacity">Commands kept; rounded up to a power of two.</param>
+    public PredictionRing(int capacity = DefaultCapacity)
+    {
+        capacity = (int)BitOperations.RoundUpToPowerOf2((uint)Math.Max(capacity, 2));
+        _mask = capacity - 1;
+        _slots = (Slot*)NativeMemory.AllocZeroed((nuint)capacity, (nuint)sizeof(Slot));
+        _acknowledged = (ServerState*)NativeMemory.AllocZeroed((nuint)sizeof(ServerState));
+    }
+
+    public int Capacity => _mask + 1;
+
+    public PredictionStats Stats => _stats;
+
+    /// <summary>
+    /// Keep the server state of the acknowledged command (the post-transfer ppcd / pwd of HUD_TxferPredictionData).
+    /// </summary>
+    public void Acknowledge(clientdata_t* client, weapon_data_t* weapons)
+    {
+        _acknowledged->Client = *client;
+        new ReadOnlySpan<weapon_data_t>(weapons, MaxWeapons).CopyTo(WeaponsOf(&_acknowledged->Weapons));
+        _acknowledgePending = true;
+    }
+
+    /// <summary>
+    /// Called from HUD_PostRunCmd before the weapon code. Returns true when <paramref name="to"/> was completed from the
+    /// ring; otherwise run the weapon code and call <see cref="Store"/> with the same arguments.
+    /// </summary>
+    public bool TryReuse(local_state_t* from, local_state_t* to, usercmd_t* cmd, int runfuncs, double time, uint sequence)
+    {
+        _stats.Commands++;
+
+        // Within a pass each command starts from the state the previous one produced.
+        if (from != _lastTo || sequence != _lastSequence + 1)
+            BeginPass(sequence);
+        _lastTo = to;
+        _lastSequence = sequence;
+
+        var slot = _slots + (sequence & _mask);
+        bool reuse = !_rerun && runfuncs == 0
+                     && slot->Valid != 0 && slot->Sequence == sequence
+                     && BitConverter.DoubleToInt64Bits(slot->Time) == BitConverter.DoubleToInt64Bits(time)
+                     && SameCommand(&slot->Cmd, cmd)
+                     && SameBits(&slot->Moved, &to->client)
+                     && SameBits(&slot->From, &from->client)
+                     && SameBits(&slot->FromWeapons, &from->weapondata);
+
+        if (!reuse)
+        {
+            // Everything after this command derives from a new state.
+            _rerun = true;
+            slot->Valid = 0;
+            slot->Moved = to->client;
+            if (runfuncs != 0)
+                _stats.FirstRuns++;
+            else
+                _stats.Resimulated++;
+            return false;
+        }
+
+        // Replay what the weapon code wrote over the movement result, and its weapon state.
+        ReplayWrites(&slot->Moved, &slot->Result, &to->client);
+        to->weapondata = slot->Weapons;
+        _stats.Reused++;
+        return true;
+    }
+
+    /// <summary>
+    /// Keep the output of a command <see cref="TryReuse"/> declined, after the weapon code ran.
+    /// </summary>
+    public void Store(local_state_t* from, local_state_t* to, usercmd_t* cmd, double time, uint sequence)
+    {
+        var slot = _slots + (sequence & _mask);
+        slot->Sequence = sequence;
+        slot->Time = time;
+        slot->Cmd = *cmd;
+        slot->From = from->client;
+        slot->FromWeapons = from->weapondata;
+        slot->Result = to->client;
+        slot->Weapons = to->weapondata;
+        slot->Valid = 1;
+    }
+
+    /// <summary>
+    /// Forget every prediction (new connection or level: command numbers start over).
+    /// </summary>
+    public void Reset()
+    {
+        for (int i = 0; i <= _mask; i++)
+            _slots[i].Valid = 0;
+        _acknowledgePending = false;
+        _rerun = false;
+        _lastTo = null;
+        _lastSequence = 0;
+    }
+
+    public void ResetStats() => _stats = default;
+
+    private void BeginPass(uint sequence)
+    {
+        _stats.Passes++;
+        _rerun = false;
+
+        if (!_acknowledgePending)
+            return;
+        _acknowledgePending = false;
+
+        // The pass starts right after the acknowledged command.
+        var predicted = _slots + ((sequence - 1) & _mask);
+        if (predicted->Valid == 0 || predicted->Sequence != sequence - 1)
+            return;
+
+        var field = CompareClient(&predicted->Result, &_acknowledged->Client)
+                    ?? CompareWeapons(WeaponsOf(&predicted->Weapons), WeaponsOf(&_acknowledged->Weapons));
+        if (field == null)
+        {
+            _stats.Confirmed++;
+            return;
+        }
+
+        _stats.Mispredicts++;
+        _stats.LastMispredict = field;
+        _rerun = true;
+    }
+
+    private static Span<weapon_data_t> WeaponsOf(InlineArray64<weapon_data_t>* weapons) => new(weapons, MaxWeapons);
+
+    /// <summary>
+    /// Copy every word the weapon code changed (<paramref name="before"/> → <paramref name="after"/>) into
+    /// <paramref name="target"/>, leaving what it did not touch as the engine filled it.
+    /// </summary>
+    private static void ReplayWrites(clientdata_t* before, clientdata_t* after, clientdata_t* target)
+    {
+        var b = (uint*)before;
+        var a = (uint*)after;
+        var t = (uint*)target;
+        int words = sizeof(clientdata_t) / sizeof(uint);
+        for (int i = 0; i < words; i++)
+        {
+            if (a[i] != b[i])
+                t[i] = a[i];
+        }
+    }
+
+    // Field by field: usercmd_t has padding the engine does not clear.
+    private static bool SameCommand(usercmd_t* a, usercmd_t* b)
+    {
+        return a->msec == b->msec && a->buttons == b->buttons && a->impulse == b->impulse && a->weaponselect == b->weaponselect
+               && SameBits(a->forwardmove, b->forwardmove) && SameBits(a->sidemove, b->sidemove) && SameBits(a->upmove, b->upmove)
+               && SameBits(a->viewangles.X, b->viewangles.X) && SameBits(a->viewangles.Y, b->viewangles.Y)
+               && SameBits(a->viewangles.Z, b->viewangles.Z)
+               && a->lightlevel == b->lightlevel && a->impact_index == b->impact_index;
+    }
+
+    private static bool SameBits(float a, float b) => BitConverter.SingleToInt32Bits(a) == BitConverter.SingleToInt32Bits(b);
+
+    private static bool SameBits<T>(T* a, T* b) where T : unmanaged
+        => new ReadOnlySpan<byte>(a, sizeof(T)).SequenceEqual(new ReadOnlySpan<byte>(b, sizeof(T)));
+
+    /// <summary>
+    /// First field that differs beyond the network precision, or null. Movement timers are left to the engine.
+    /// </summary>
+    internal static string? CompareClient(clientdata_t* a, clientdata_t* b)
+    {
+        if (new ReadOnlySpan<byte>(a, sizeof(clientdata_t)).SequenceEqual(new ReadOnlySpan<byte>(b, sizeof(clientdata_t))))
+            return null;
+
+        if (!Near(a->origin, b->origin, PositionTolerance)) return nameof(clientdata_t.origin);
+        if (!Near(a->velocity, b->velocity, PositionTolerance)) return nameof(clientdata_t.velocity);
+        if (!Near(a->view_ofs, b->view_ofs, PositionTolerance)) return nameof(clientdata_t.view_ofs);
+        if (!Near(a->punchangle, b->punchangle, PositionTolerance)) return nameof(clientdata_t.punchangle);
+        if (a->flags != b->flags) return nameof(clientdata_t.flags);
+        if (a->waterlevel != b->waterlevel) return nameof(clientdata_t.waterlevel);
+        if (a->bInDuck != b->bInDuck) return nameof(clientdata_t.bInDuck);
+        if (a->deadflag != b->deadflag) return nameof(clientdata_t.deadflag);
+        if (!Near(a->health, b->health, TimeTolerance)) return nameof(clientdata_t.health);
+        if (!Near(a->maxspeed, b->maxspeed, TimeTolerance)) return nameof(clientdata_t.maxspeed);
+        if (!Near(a->fov, b->fov, TimeTolerance)) return nameof(clientdata_t.fov);
+        if (a->viewmodel != b->viewmodel) return nameof(clientdata_t.viewmodel);
+        if (a->weaponanim != b->weaponanim) return nameof(clientdata_t.weaponanim);
+        if (a->weapons != b->weapons) return nameof(clientdata_t.weapons);
+        if (a->m_iId != b->m_iId) return nameof(clientdata_t.m_iId);
+        if (!Near(a->m_flNextAttack, b->m_flNextAttack, TimeTolerance)) return nameof(clientdata_t.m_flNextAttack);
+        if (a->ammo_shells != b->ammo_shells) return nameof(clientdata_t.ammo_shells);
+        if (a->ammo_nails != b->ammo_nails) return nameof(clientdata_t.ammo_nails);
+        if (a->ammo_cells != b->ammo_cells) return nameof(clientdata_t.ammo_cells);
+        if (a->ammo_rockets != b->ammo_rockets) return nameof(clientdata_t.ammo_rockets);
+        if (a->tfstate != b->tfstate) return nameof(clientdata_t.tfstate);
+        if (a->iuser1 != b->iuser1 || a->iuser2 != b->iuser2 || a->iuser3 != b->iuser3 || a->iuser4 != b->iuser4)
+            return nameof(clientdata_t.iuser1);
+        if (!Near(a->fuser1, b->fuser1, TimeTolerance) || !Near(a->fuser2, b->fuser2, TimeTolerance) ||
+            !Near(a->fuser3, b->fuser3, TimeTolerance) || !Near(a->fuser4, b->fuser4, TimeTolerance))
+            return nameof(clientdata_t.fuser1);
+        if (!Near(a->vuser1, b->vuser1, PositionTolerance) || !Near(a->vuser2, b->vuser2, PositionTolerance) ||
+            !Near(a->vuser3, b->vuser3, PositionTolerance) || !Near(a->vuser4, b->vuser4, PositionTolerance))
+            return nameof(clientdata_t.vuser1);
+
+        var physinfoA = new ReadOnlySpan<byte>(&a->physinfo, sizeof(InlineArray256<NChar>));
+        var physinfoB = new ReadOnlySpan<byte>(&b->physinfo, sizeof(InlineArray256<NChar>));
+        if (!Terminated(physinfoA).SequenceEqual(Terminated(physinfoB))) return nameof(clientdata_t.physinfo);
+
+        return null;
+    }
+
+    /// <summary>
+    /// First weapon field that differs beyond the network precision, or null.
+    /// </summary>
+    internal static string? CompareWeapons(ReadOnlySpan<weapon_data_t> a, ReadOnlySpan<weapon_data_t> b)
+    {
+        if (MemoryMarshal.AsBytes(a).SequenceEqual(MemoryMarshal.AsBytes(b)))
+            return null;
+
+        for (int i = 0; i < a.Length; i++)
+        {
+            ref readonly var x = ref a[i];
+            ref readonly var y = ref b[i];
+            if (x.m_iId != y.m_iId) return nameof(weapon_data_t.m_iId);
+            if (x.m_iClip != y.m_iClip) return nameof(weapon_data_t.m_iClip);
+            if (x.m_fInReload != y.m_fInReload) return nameof(weapon_data_t.m_fInReload);
+            if (x.m_fInSpecialReload != y.m_fInSpecialReload) return nameof(weapon_data_t.m_fInSpecialReload);
+            if (x.m_fInZoom != y.m_fInZoom) return nameof(weapon_data_t.m_fInZoom);
+            if (x.m_iWeaponState != y.m_iWeaponState) return nameof(weapon_data_t.m_iWeaponState);
+            if (!Near(x.m_flNextPrimaryAttack, y.m_flNextPrimaryAttack, TimeTolerance)) return nameof(weapon_data_t.m_flNextPrimaryAttack);
+            if (!Near(x.m_flNextSecondaryAttack, y.m_flNextSecondaryAttack, TimeTolerance)) return nameof(weapon_data_t.m_flNextSecondaryAttack);
+            if (!Near(x.m_flTimeWeaponIdle, y.m_flTimeWeaponIdle, TimeTolerance)) return nameof(weapon_data_t.m_flTimeWeaponIdle);
+            if (!Near(x.m_flNextReload, y.m_flNextReload, TimeTolerance)) return nameof(weapon_data_t.m_flNextReload);
+            if (!Near(x.m_flPumpTime, y.m_flPumpTime, TimeTolerance)) return nameof(weapon_data_t.m_flPumpTime);
+            if (!Near(x.m_fReloadTime, y.m_fReloadTime, TimeTolerance)) return nameof(weapon_data_t.m_fReloadTime);
+            if (!Near(x.m_fAimedDamage, y.m_fAimedDamage, TimeTolerance)) return nameof(weapon_data_t.m_fAimedDamage);
+            if (!Near(x.m_fNextAimBonus, y.m_fNextAimBonus, TimeTolerance)) return nameof(weapon_data_t.m_fNextAimBonus);
+            if (x.iuser1 != y.iuser1 || x.iuser2 != y.iuser2 || x.iuser3 != y.iuser3 || x.iuser4 != y.iuser4)
+                return nameof(weapon_data_t.iuser1);
+            if (!Near(x.fuser1, y.fuser1, TimeTolerance) || !Near(x.fuser2, y.fuser2, TimeTolerance) ||
+                !Near(x.fuser3, y.fuser3, TimeTolerance) || !Near(x.fuser4, y.fuser4, TimeTolerance))
+                return nameof(weapon_data_t.fuser1);
+        }
+        return null;
+    }
+
+    private static bool Near(float a, float b, float tolerance) => MathF.Abs(a - b) <= tolerance;
+
+    private static bool Near(in Vector3 a, in Vector3 b, float tolerance)
+        => Near(a.X, b.X, tolerance) && Near(a.Y, b.Y, tolerance) && Near(a.Z, b.Z, tolerance);
+
+    private static ReadOnlySpan<byte> Terminated(ReadOnlySpan<byte> text)
+    {
+        int end = text.IndexOf((byte)0);
+        return end < 0 ? text : text[..end];
+    }
+
+    public void Dispose()
+    {
+        if (_slots == null)
+            return;
+
+        NativeMemory.Free(_slots);
+        NativeMemory.Free(_acknowledged);
+        _slots = null;
+        _acknowledged = null;
+    }
+}
@@ -0,0 +1,317 @@
+using GoldsrcFramework.Commands;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using NativeInterop;
+
+namespace GoldsrcFramework.Rendering;
+
+/// <summary>
+/// Animation level of detail, nearest first. See <see cref="AnimationLod"/> for what each band drops.
+/// </summary>
+public enum AnimationLodBand
+{
+    Full,
+    Reduced,
+    Low,
+    Minimal,
+}
+
+/// <summary>
+/// Studio model draws per <see cref="AnimationLodBand"/> since the last reset.
+/// </summary>
+public struct AnimationLodStats
+{
+    /// <summary>Render frames counted.</summary>
+    public long Frames;
+    /// <summary>Visible studio models drawn in each band.</summary>
+    public long Full, Reduced, Low, Minimal;
+    /// <summary>Draws below <see cref="AnimationLodBand.Full"/> that computed a new pose.</summary>
+    public long PoseUpdates;
+    /// <summary>Draws below <see cref="AnimationLodBand.Full"/> that interpolated between cached poses instead.</summary>
+    public long Interpolated;
+}
+
+/// <summary>
+/// Animation LOD policy for <see cref="StudioModelRenderer"/>. Entities are put in a band by their distance from the
+/// render origin and their projected height on screen; an entity is only reduced when it is both far (r_animlod_dist)
+/// and small (r_animlod_pixels), so a zoomed-in view keeps full animation. Each following band starts at twice the
+/// distance and half the height of the one before.
+/// <list type="table">
+/// <item><term>Full</term><description>every frame, all blends, previous-sequence crossfade.</description></item>
+/// <item><term>Reduced</term><description>pose every r_animlod_interval frames, no crossfade.</description></item>
+/// <item><term>Low</term><description>twice that interval, two blends at most; attachments and gait estimation only
+/// on frames that compute a pose.</description></item>
+/// <item><term>Minimal</term><description>twice again, no blends.</description></item>
+/// </list>
+/// Between pose updates bones are interpolated from the last two poses, one update behind, and the matrices are
+/// rebuilt from the current entity transform, so moving entities do not lag. Sequence changes are interpolated the
+/// same way, which stands in for the dropped crossfade. Updates are staggered by entity index.
+///
+/// Off unless r_animlod is set to 1; with it off every entity is drawn in the full band.
+/// </summary>
+public sealed unsafe class AnimationLod
+{
+    public const int BandCount = 4;
+
+    // Longest gap between two poses that is still interpolated; an entity that was not drawn for longer snaps.
+    internal const double MaxInterpolationGap = 0.5;
+
+    private cvar_t* _enabled;
+    private cvar_t* _distance;
+    private cvar_t* _pixels;
+    private cvar_t* _interval;
+
+    private AnimationLodState?[] _states = new AnimationLodState?[512];
+    private int _frame = -1;
+    private float _pixelScale;
+    private AnimationLodStats _stats;
+
+    /// <summary>
+    /// Current field of view in degrees, as set by the client dll in HUD_UpdateClientData.
+    /// </summary>
+    public static float FieldOfView { get; set; } = 90;
+
+    /// <summary>
+    /// Counters since the last <see cref="ResetStats"/>.
+    /// </summary>
+    public AnimationLodStats Stats => _stats;
+
+    public void ResetStats() => _stats = default;
+
+    /// <summary>
+    /// Register the cvars and r_animlodstats. Call once the client engine functions are known.
+    /// </summary>
+    public void Init()
+    {
+        // FCVAR_ARCHIVE
+        _enabled = EngineApi.PClient->RegisterVariable("r_animlod"u8.GetNCharPointerUnsafe(), "0"u8.GetNCharPointerUnsafe(), 1);
+        _distance = EngineApi.PClient->RegisterVariable("r_animlod_dist"u8.GetNCharPointerUnsafe(), "768"u8.GetNCharPointerUnsafe(), 1);
+        _pixels = EngineApi.PClient->RegisterVariable("r_animlod_pixels"u8.GetNCharPointerUnsafe(), "96"u8.GetNCharPointerUnsafe(), 1);
+        _interval = EngineApi.PClient->RegisterVariable("r_animlod_interval"u8.GetNCharPointerUnsafe(), "2"u8.GetNCharPointerUnsafe(), 1);
+        ConsoleCommands.AddClientCommand("r_animlodstats", StatsCommand);
+    }
+
+    /// <summary>
+    /// Choose the band of the entity being drawn and whether this draw computes a new pose. Entities without an
+    /// index (view model, temporary entities) are always drawn at <see cref="AnimationLodBand.Full"/>.
+    /// </summary>
+    /// <param name="state">Cached poses of the entity; null at <see cref="AnimationLodBand.Full"/></param>
+    /// <param name="update">True if the pose has to be computed this draw</param>
+    public AnimationLodBand Select(cl_entity_t* entity, model_t* model, studiohdr_t* header, StudioModelRenderer.RendererState* s,
+                                   out AnimationLodState? state, out bool update)
+    {
+        state = null;
+        update = true;
+        BeginFrame(s->m_nFrameCount);
+
+        int index = entity->index;
+        if (_enabled == null || _enabled->value == 0 || index <= 0)
+            return AnimationLodBand.Full;
+
+        var band = Classify(entity, header, s->m_vRenderOrigin);
+        if (band == AnimationLodBand.Full)
+        {
+            // Start over when the entity comes back, the cached poses are from another part of the animation.
+            if (index < _states.Length && _states[index] is { } stale)
+                stale.Invalidate();
+            return band;
+        }
+
+        if (index >= _states.Length)
+            Array.Resize(ref _states, Math.Max(index + 1, _states.Length * 2));
+        state = _states[index] ??= new AnimationLodState();
+
+        int interval = Interval(band);
+        int elapsed = s->m_nFrameCount - state.UpdateFrame;
+        update = !state.Matches(model, header, entity->curstate.sequence) ||
+                 s->m_clTime - state.Time1 > MaxInterpolationGap ||
+                 elapsed >= interval ||
+                 (elapsed > 0 && (s->m_nFrameCount + index) % interval == 0);
+        return band;
+    }
+
+    /// <summary>
+    /// Count a visible draw.
+    /// </summary>
+    public void Count(AnimationLodBand band, bool update)
+    {
+        switch (band)
+        {
+            case AnimationLodBand.Full: _stats.Full++; return;
+            case AnimationLodBand.Reduced: _stats.Reduced++; break;
+            case AnimationLodBand.Low: _stats.Low++; break;
+            default: _stats.Minimal++; break;
+        }
+        if (update)
+            _stats.PoseUpdates++;
+        else
+            _stats.Interpolated++;
+    }
+
+    /// <summary>Previous-sequence crossfade is only done at full detail.</summary>
+    public static bool Crossfade(AnimationLodBand band) => band == AnimationLodBand.Full;
+
+    /// <summary>Blend layers evaluated in the band (sequences have 1, 2 or 4).</summary>
+    public static int MaxBlends(AnimationLodBand band) => band switch
+    {
+        AnimationLodBand.Low => 2,
+        AnimationLodBand.Minimal => 1,
+        _ => 4,
+    };
+
+    /// <summary>Attachments and gait estimation only follow the pose in the two farthest bands.</summary>
+    public static bool SkipSecondary(AnimationLodBand band, bool update) => !update && band >= AnimationLodBand.Low;
+
+    private int Interval(AnimationLodBand band)
+    {
+        int interval = _interval == null ? 2 : Math.Clamp((int)_interval->value, 1, 16);
+        return interval << ((int)band - 1);
+    }
+
+    private AnimationLodBand Classify(cl_entity_t* entity, studiohdr_t* header, Vector3 renderOrigin)
+    {
+        float distance = (entity->origin - renderOrigin).Length();
+
+        int byDistance = BandCount - 1;
+        float near = _distance == null ? 0 : _distance->value;
+        if (near > 0)
+        {
+            byDistance = 0;
+            for (float limit = near; byDistance < BandCount - 1 && distance >= limit; limit *= 2)
+                byDistance++;
+        }
+
+        int bySize = BandCount - 1;
+        float pixels = _pixels == null ? 0 : _pixels->value;
+        if (pixels > 0 && _pixelScale > 0)
+        {
+            float scale = entity->curstate.scale > 0 ? entity->curstate.scale : 1;
+            float height = (header->bbmax - header->bbmin).Length() * scale * _pixelScale / Math.Max(distance, 1);
+            bySize = 0;
+            for (float limit = pixels; bySize < BandCount - 1 && height < limit; limit *= 0.5f)
+                bySize++;
+        }
+
+        return (AnimationLodBand)Math.Min(byDistance, bySize);
+    }
+
+    private void BeginFrame(int frame)
+    {
+        if (frame == _frame)
+            return;
+        _frame = frame;
+        _stats.Frames++;
+
+        // Pixels per unit at distance 1: half the screen height over tan(fov / 2).
+        SCREENINFO info;
+        info.iSize = sizeof(SCREENINFO);
+        float fov = Math.Clamp(FieldOfView, 1, 179);
+        _pixelScale = EngineApi.PClient->GetScreenInfo(&info) != 0
+            ? info.iHeight * 0.5f / MathF.Tan(fov * (MathF.PI / 360))
+            : 0;
+    }
+
+    /// <summary>
+    /// r_animlodstats [reset]: print draws per band.
+    /// </summary>
+    private void StatsCommand(edict_t* client, CommandArgs args)
+    {
+        if (args.Count > 1 && args[1].EqualsIgnoreCase("reset"))
+        {
+            ResetStats();
+            return;
+        }
+
+        var s = _stats;
+        double frames = Math.Max(s.Frames, 1);
+        EngineApi.ConsolePrint($"{s.Frames} frames, models per frame: {s.Full / frames:F1} full, {s.Reduced / frames:F1} reduced, " +
+                               $"{s.Low / frames:F1} low, {s.Minimal / frames:F1} minimal\n" +
+                               $"{s.PoseUpdates} pose updates, {s.Interpolated} interpolated" +
+                               (_enabled != null && _enabled->value == 0 ? " (r_animlod 0)\n" : "\n"));
+    }
+}
+
+/// <summary>
+/// Last two poses (bone positions and quaternions before the hierarchy is applied) computed for one entity.
+/// </summary>
+public sealed unsafe class AnimationLodState
+{
+    private nint _model;
+    private int _bones;
+    private int _sequence;
+    private bool _valid;
+
+    internal float[] Pos0 = Array.Empty<float>(), Q0 = Array.Empty<float>();
+    internal float[] Pos1 = Array.Empty<float>(), Q1 = Array.Empty<float>();
+    internal int UpdateFrame;
+    internal double Time0, Time1;
+
+    internal bool Matches(model_t* model, studiohdr_t* header, int sequence) =>
+        _valid && _model == (nint)model && _bones == header->numbones && _sequence == sequence;
+
+    internal void Invalidate() => _valid = false;
+
+    /// <summary>
+    /// Keep a newly computed pose. The previous one becomes the start of the interpolation unless the entity changed
+    /// model or was not drawn for a while, in which case both are the new pose.
+    /// </summary>
+    internal void Push(float* pos, float* q, model_t* model, studiohdr_t* header, int sequence, int frame, double time)
+    {
+        int bones = header->numbones;
+        bool snap = !_valid || _model != (nint)model || _bones != bones || time - Time1 > AnimationLod.MaxInterpolationGap;
+        if (Pos0.Length < bones * 3)
+        {
+            Pos0 = new float[bones * 3];
+            Pos1 = new float[bones * 3];
+            Q0 = new float[bones * 4];
+            Q1 = new float[bones * 4];
+        }
+
+        if (!snap)
+        {
+            (Pos0, Pos1) = (Pos1, Pos0);
+            (Q0, Q1) = (Q1, Q0);
+        }
+        new ReadOnlySpan<float>(pos, bones * 3).CopyTo(Pos1);
+        new ReadOnlySpan<float>(q, bones * 4).CopyTo(Q1);
+        if (snap)
+        {
+            new ReadOnlySpan<float>(pos, bones * 3).CopyTo(Pos0);
+            new ReadOnlySpan<float>(q, bones * 4).CopyTo(Q0);
+        }
+
+        Time0 = snap ? time : Time1;
+        Time1 = time;
+        UpdateFrame = frame;
+        _model = (nint)model;
+        _bones = bones;
+        _sequence = sequence;
+        _valid = true;
+    }
+
+    /// <summary>
+    /// How far from the older pose to the newer one the entity is drawn at <paramref name="time"/>.
+    /// </summary>
+    internal float Fraction(double time) => Time1 > Time0 ? (float)((time - Time1) / (Time1 - Time0)) : 1;
+
+    /// <summary>
+    /// Pose of the first <paramref name="bones"/> bones at <paramref name="time"/>: the older pose slerped towards the
+    /// newer one by <see cref="Fraction"/>, clamped to the two.
+    /// </summary>
+    internal void Interpolate(float* pos, float* q, int bones, double time)
+    {
+        float s = Math.Clamp(Fraction(time), 0, 1);
+        float s1 = 1 - s;
+
+        fixed (float* pPos0 = Pos0, pQ0 = Q0, pPos1 = Pos1, pQ1 = Q1)
+        {
+            for (int i = 0; i < bones; i++)
+            {
+                StudioMath.QuaternionSlerp(pQ0 + i * 4, pQ1 + i * 4, s, q + i * 4);
+                pos[i * 3 + 0] = pPos0[i * 3 + 0] * s1 + pPos1[i * 3 + 0] * s;
+                pos[i * 3 + 1] = pPos0[i * 3 + 1] * s1 + pPos1[i * 3 + 1] * s;
+                pos[i * 3 + 2] = pPos0[i * 3 + 2] * s1 + pPos1[i * 3 + 2] * s;
+            }
+        }
+    }
+}
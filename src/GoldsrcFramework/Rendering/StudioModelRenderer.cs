@@ -1,6 +1,7 @@
 using GoldsrcFramework.Engine.Native;
 using GoldsrcFramework.Graphics;
 using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Models;
 using Microsoft.Extensions.Logging;
 using NativeInterop;
 using System.Diagnostics;
@@ -99,6 +100,9 @@ public unsafe class StudioModelRenderer
     private int m_nCachedBones;
     // Names of cached bones
     private NChar[,] m_nCachedBoneNames = new NChar[StudioConstants.MAXSTUDIOBONES, 32];
+    // Prewarmed info of the model being drawn and of the one whose bones are cached, for the merge remap
+    private StudioModelInfo? m_pRenderInfo;
+    private StudioModelInfo? m_pCachedBonesInfo;
     // Cached bone & light transformation matrices
     private Matrix3x4[] m_rgCachedBoneTransform = new Matrix3x4[StudioConstants.MAXSTUDIOBONES];
     private Matrix3x4[] m_rgCachedLightTransform = new Matrix3x4[StudioConstants.MAXSTUDIOBONES];
@@ -156,6 +160,17 @@ public unsafe class StudioModelRenderer
     private bool m_fDoInterp;
     private bool m_fGaitEstimation;
 
+    #region Member Variables - Animation LOD
+
+    // Animation level of detail policy (r_animlod cvars)
+    private readonly AnimationLod m_animLod = new();
+    // Band of the entity being drawn, its cached poses (null at full detail) and whether this draw computes a pose
+    private AnimationLodBand m_nLodBand;
+    private AnimationLodState? m_pLodState;
+    private bool m_fLodUpdate;
+
+    #endregion
+
     #region Static Members
 
     // Engine Studio API
@@ -179,6 +194,7 @@ public unsafe class StudioModelRenderer
         // Initialize RendererState members
         m_fDoInterp = true;
         m_fGaitEstimation = true;
+        m_fLodUpdate = true;
         _s->m_clTime = 0;
         _s->m_clOldTime = 0;
         _s->m_nFrameCount = 0;
@@ -227,6 +243,8 @@ public unsafe class StudioModelRenderer
         m_plighttransform = (Matrix3x4*)IEngineStudio->StudioGetLightTransform();
         m_paliastransform = (Matrix3x4*)IEngineStudio->StudioGetAliasTransform();
         m_protationmatrix = (Matrix3x4*)IEngineStudio->StudioGetRotationMatrix();
+
+        m_animLod.Init();
     }
 
     #endregion
@@ -283,10 +301,14 @@ public unsafe class StudioModelRenderer
         }
 
         m_pRenderModel = m_pCurrentEntity->model;
+        m_pRenderInfo = StudioModelCache.Client.Find(m_pRenderModel);
         m_pStudioHeader = (studiohdr_t*)IEngineStudio->Mod_Extradata(m_pRenderModel);
         IEngineStudio->StudioSetHeader(m_pStudioHeader);
         IEngineStudio->SetRenderModel(m_pRenderModel);
 
+        // Followers take their bones from the parent's (StudioMergeBones)
+        StudioSelectLod(m_pCurrentEntity->curstate.movetype != (int)MoveType.MOVETYPE_FOLLOW);
+
         StudioSetUpTransform(false);
 
         if ((flags & STUDIO_RENDER) != 0)
@@ -297,6 +319,7 @@ public unsafe class StudioModelRenderer
 
             (*_s->m_pModelsDrawn)++;
             (*_s->m_pStudioModelCount)++; // render data cache cookie
+            m_animLod.Count(m_nLodBand, m_fLodUpdate);
 
             if (m_pStudioHeader->numbodyparts == 0)
                 return true;
@@ -315,7 +338,9 @@ public unsafe class StudioModelRenderer
 
         if ((flags & STUDIO_EVENTS) != 0)
         {
-            StudioCalcAttachments();
+            // Far away the attachments only move with the pose
+            if (!AnimationLod.SkipSecondary(m_nLodBand, m_fLodUpdate))
+                StudioCalcAttachments();
             IEngineStudio->StudioClientEvents();
             // copy attachments into global entity array
             if (m_pCurrentEntity->index > 0)
@@ -377,10 +402,13 @@ public unsafe class StudioModelRenderer
         if (m_pRenderModel == null)
             return false;
 
+        m_pRenderInfo = StudioModelCache.Client.Find(m_pRenderModel);
         m_pStudioHeader = (studiohdr_t*)IEngineStudio->Mod_Extradata(m_pRenderModel);
         IEngineStudio->StudioSetHeader(m_pStudioHeader);
         IEngineStudio->SetRenderModel(m_pRenderModel);
 
+        StudioSelectLod(true);
+
         if (pplayer->gaitsequence != 0)
         {
             Vector3 orig_angles;
@@ -421,6 +449,7 @@ public unsafe class StudioModelRenderer
 
             (*_s->m_pModelsDrawn)++;
             (*_s->m_pStudioModelCount)++; // render data cache cookie
+            m_animLod.Count(m_nLodBand, m_fLodUpdate);
 
             if (m_pStudioHeader->numbodyparts == 0)
                 return true;
@@ -435,7 +464,9 @@ public unsafe class StudioModelRenderer
 
         if ((flags & STUDIO_EVENTS) != 0)
         {
-            StudioCalcAttachments();
+            // Far away the attachments only move with the pose
+            if (!AnimationLod.SkipSecondary(m_nLodBand, m_fLodUpdate))
+                StudioCalcAttachments();
             IEngineStudio->StudioClientEvents();
             // copy attachments into global entity array
             if (m_pCurrentEntity->index > 0)
@@ -499,6 +530,7 @@ public unsafe class StudioModelRenderer
 
                 model_t* pweaponmodel = IEngineStudio->GetModelByIndex(pplayer->weaponmodel);
 
+                m_pRenderInfo = StudioModelCache.Client.Find(pweaponmodel);
                 m_pStudioHeader = (studiohdr_t*)IEngineStudio->Mod_Extradata(pweaponmodel);
                 IEngineStudio->StudioSetHeader(m_pStudioHeader);
 
@@ -508,7 +540,8 @@ public unsafe class StudioModelRenderer
 
                 StudioRenderModel();
 
-                StudioCalcAttachments();
+                if (!AnimationLod.SkipSecondary(m_nLodBand, m_fLodUpdate))
+                    StudioCalcAttachments();
 
                 *m_pCurrentEntity = saveent;
             }
@@ -517,6 +550,23 @@ public unsafe class StudioModelRenderer
         return true;
     }
 
+    /// <summary>
+    /// Pick the animation LOD band of the entity being drawn; <paramref name="eligible"/> false keeps full detail
+    /// </summary>
+    private void StudioSelectLod(bool eligible)
+    {
+        if (eligible)
+        {
+            m_nLodBand = m_animLod.Select(m_pCurrentEntity, m_pRenderModel, m_pStudioHeader, _s, out m_pLodState, out m_fLodUpdate);
+        }
+        else
+        {
+            m_nLodBand = AnimationLodBand.Full;
+            m_pLodState = null;
+            m_fLodUpdate = true;
+        }
+    }
+
     #endregion
 
     #region Bone Calculation Methods
@@ -960,7 +1010,17 @@ public unsafe class StudioModelRenderer
             return (mstudioanim_t*)((byte*)m_pStudioHeader + pseqdesc->animindex);
         }
 
-        paSequences = (cache_user_t*)pSubModel->submodels;
+        paSequences = LoadSequenceGroup(pSubModel, pseqgroup, pseqdesc->seqgroup);
+
+        return (mstudioanim_t*)((byte*)paSequences[pseqdesc->seqgroup].data + pseqdesc->animindex);
+    }
+
+    /// <summary>
+    /// The model's sequence group cache slots, with group <paramref name="group"/> loaded if it was not (or was flushed).
+    /// </summary>
+    private static cache_user_t* LoadSequenceGroup(model_t* pSubModel, mstudioseqgroup_t* pseqgroup, int group)
+    {
+        cache_user_t* paSequences = (cache_user_t*)pSubModel->submodels;
 
         if (paSequences == null)
         {
@@ -968,14 +1028,28 @@ public unsafe class StudioModelRenderer
             pSubModel->submodels = (dmodel_t*)paSequences;
         }
 
-        if (IEngineStudio->Cache_Check(&paSequences[pseqdesc->seqgroup]) == null)
+        if (IEngineStudio->Cache_Check(&paSequences[group]) == null)
         {
             NChar* namePtr = (NChar*)System.Runtime.CompilerServices.Unsafe.AsPointer(ref pseqgroup->name[0]);
             EngineApi.PClient->Con_DPrintf(namePtr);
-            IEngineStudio->LoadCacheFile(namePtr, (cache_user_t*)&paSequences[pseqdesc->seqgroup]);
+            IEngineStudio->LoadCacheFile(namePtr, (cache_user_t*)&paSequences[group]);
         }
 
-        return (mstudioanim_t*)((byte*)paSequences[pseqdesc->seqgroup].data + pseqdesc->animindex);
+        return paSequences;
+    }
+
+    /// <summary>
+    /// Load every external sequence group of a model now rather than on the first draw that needs it.
+    /// Used by <see cref="Models.ModelPrewarm"/> at level load.
+    /// </summary>
+    internal static void LoadSequenceGroups(model_t* pSubModel, studiohdr_t* pStudioHeader)
+    {
+        if (IEngineStudio == null)
+            return;
+
+        var pseqgroup = (mstudioseqgroup_t*)((byte*)pStudioHeader + pStudioHeader->seqgroupindex);
+        for (int group = 1; group < pStudioHeader->numseqgroups; group++)
+            LoadSequenceGroup(pSubModel, pseqgroup + group, group);
     }
 
     /// <summary>
@@ -1177,20 +1251,49 @@ public unsafe class StudioModelRenderer
     /// Set up model bone positions
     /// Original: void CStudioModelRenderer::StudioSetupBones()
     /// </summary>
+    /// <remarks>
+    /// Below <see cref="AnimationLodBand.Full"/> the pose is only computed on the frames <see cref="AnimationLod"/>
+    /// picks and interpolated from the cached poses otherwise; the matrices are built every draw.
+    /// </remarks>
     private void StudioSetupBones()
     {
-        int i;
+        // Allocate bone data on stack
+        Span<float> pos = stackalloc float[StudioConstants.MAXSTUDIOBONES * 3];
+        Span<float> q = stackalloc float[StudioConstants.MAXSTUDIOBONES * 4];
+
+        if (m_pCurrentEntity->curstate.sequence >= m_pStudioHeader->numseq)
+        {
+            m_pCurrentEntity->curstate.sequence = 0;
+        }
+
+        fixed (float* pPos = pos, pQ = q)
+        {
+            if (m_fLodUpdate)
+            {
+                StudioCalcPose(pPos, pQ);
+                m_pLodState?.Push(pPos, pQ, m_pRenderModel, m_pStudioHeader, m_pCurrentEntity->curstate.sequence, _s->m_nFrameCount, _s->m_clTime);
+            }
+
+            if (m_pLodState != null)
+            {
+                StudioInterpolatePose(pPos, pQ);
+            }
+
+            StudioBuildBoneTransforms(pPos, pQ);
+        }
+    }
+
+    /// <summary>
+    /// Bone positions and rotations of the current sequence, its blends and the crossfade from the previous one,
+    /// limited by the entity's animation LOD band
+    /// </summary>
+    private void StudioCalcPose(float* pPos, float* pQ)
+    {
         double f;
 
-        mstudiobone_t* pbones;
         mstudioseqdesc_t* pseqdesc;
         mstudioanim_t* panim;
 
-        // Allocate bone data on stack
-        Span<float> pos = stackalloc float[StudioConstants.MAXSTUDIOBONES * 3];
-        Span<float> q = stackalloc float[StudioConstants.MAXSTUDIOBONES * 4];
-        Span<float> bonematrix = stackalloc float[3 * 4];
-
         Span<float> pos2 = stackalloc float[StudioConstants.MAXSTUDIOBONES * 3];
         Span<float> q2 = stackalloc float[StudioConstants.MAXSTUDIOBONES * 4];
         Span<float> pos3 = stackalloc float[StudioConstants.MAXSTUDIOBONES * 3];
@@ -1198,10 +1301,7 @@ public unsafe class StudioModelRenderer
         Span<float> pos4 = stackalloc float[StudioConstants.MAXSTUDIOBONES * 3];
         Span<float> q4 = stackalloc float[StudioConstants.MAXSTUDIOBONES * 4];
 
-        if (m_pCurrentEntity->curstate.sequence >= m_pStudioHeader->numseq)
-        {
-            m_pCurrentEntity->curstate.sequence = 0;
-        }
+        int maxBlends = AnimationLod.MaxBlends(m_nLodBand);
 
         pseqdesc = m_pStudioHeader->GetSequences() + m_pCurrentEntity->curstate.sequence;
 
@@ -1214,11 +1314,11 @@ public unsafe class StudioModelRenderer
 
         panim = StudioGetAnim(m_pRenderModel, pseqdesc);
 
-        fixed (float* pPos = pos, pQ = q, pPos2 = pos2, pQ2 = q2, pPos3 = pos3, pQ3 = q3, pPos4 = pos4, pQ4 = q4)
+        fixed (float* pPos2 = pos2, pQ2 = q2, pPos3 = pos3, pQ3 = q3, pPos4 = pos4, pQ4 = q4)
         {
             StudioCalcRotations(pPos, pQ, pseqdesc, panim, (float)f);
 
-            if (pseqdesc->numblends > 1)
+            if (pseqdesc->numblends > 1 && maxBlends > 1)
             {
                 float s;
                 float dadt;
@@ -1231,7 +1331,7 @@ public unsafe class StudioModelRenderer
 
                 StudioSlerpBones(pQ, pPos, pQ2, pPos2, s);
 
-                if (pseqdesc->numblends == 4)
+                if (pseqdesc->numblends == 4 && maxBlends == 4)
                 {
                     panim += m_pStudioHeader->numbones;
                     StudioCalcRotations(pPos3, pQ3, pseqdesc, panim, (float)f);
@@ -1248,10 +1348,11 @@ public unsafe class StudioModelRenderer
             }
 
             // Blend with previous sequence if interpolating
-            if (m_fDoInterp &&
+            bool crossfade = m_fDoInterp &&
                 m_pCurrentEntity->latched.sequencetime != 0 &&
                 (m_pCurrentEntity->latched.sequencetime + 0.2 > _s->m_clTime) &&
-                (m_pCurrentEntity->latched.prevsequence < m_pStudioHeader->numseq))
+                (m_pCurrentEntity->latched.prevsequence < m_pStudioHeader->numseq);
+            if (crossfade && AnimationLod.Crossfade(m_nLodBand))
             {
                 // blend from last sequence
                 Span<float> pos1b = stackalloc float[StudioConstants.MAXSTUDIOBONES * 3];
@@ -1299,7 +1400,7 @@ public unsafe class StudioModelRenderer
                     StudioSlerpBones(pQ, pPos, pQ1b, pPos1b, s);
                 }
             }
-            else
+            else if (!crossfade)
             {
                 m_pCurrentEntity->latched.prevframe = (float)f;
             }
@@ -1312,9 +1413,6 @@ public unsafe class StudioModelRenderer
             // For non-player entities, this step is skipped.
             // Implementation deferred: Will be added when player rendering is fully implemented.
 
-            // Build final bone matrices
-            pbones = m_pStudioHeader->GetBones();
-
             // bounds checking
             if (m_pPlayerInfo is not null)
             {
@@ -1362,51 +1460,72 @@ public unsafe class StudioModelRenderer
                 //    }
                 //}
             }
+        }
+    }
 
-            fixed (float* pBonematrix = bonematrix)
+    /// <summary>
+    /// Pose of an entity drawn below full animation LOD: between its two cached poses, one update behind
+    /// </summary>
+    private void StudioInterpolatePose(float* pPos, float* pQ)
+    {
+        m_pLodState!.Interpolate(pPos, pQ, m_pStudioHeader->numbones, _s->m_clTime);
+    }
+
+    /// <summary>
+    /// Concatenate the bone hierarchy onto the model transform
+    /// </summary>
+    private void StudioBuildBoneTransforms(float* pPos, float* pQ)
+    {
+        int i;
+        mstudiobone_t* pbones;
+        Span<float> bonematrix = stackalloc float[3 * 4];
+
+        // Build final bone matrices
+        pbones = m_pStudioHeader->GetBones();
+
+        fixed (float* pBonematrix = bonematrix)
+        {
+            for (i = 0; i < m_pStudioHeader->numbones; i++)
             {
-                for (i = 0; i < m_pStudioHeader->numbones; i++)
-                {
-                    StudioMath.QuaternionMatrix(pQ + (i * 4), pBonematrix);
+                StudioMath.QuaternionMatrix(pQ + (i * 4), pBonematrix);
 
-                    pBonematrix[0 * 4 + 3] = pPos[i * 3 + 0];
-                    pBonematrix[1 * 4 + 3] = pPos[i * 3 + 1];
-                    pBonematrix[2 * 4 + 3] = pPos[i * 3 + 2];
+                pBonematrix[0 * 4 + 3] = pPos[i * 3 + 0];
+                pBonematrix[1 * 4 + 3] = pPos[i * 3 + 1];
+                pBonematrix[2 * 4 + 3] = pPos[i * 3 + 2];
 
-                    if (pbones[i].parent == -1)
+                if (pbones[i].parent == -1)
+                {
+                    if (IEngineStudio->IsHardware() != 0)
                     {
-                        if (IEngineStudio->IsHardware() != 0)
-                        {
-                            // StudioMath.ConcatTransforms(*m_protationmatrix, *(Matrix3x4*)pBonematrix, out m_pbonetransform[i]);
-                            // using ref form
-                            StudioMath.ConcatTransforms(ref *m_protationmatrix, ref *(Matrix3x4*)pBonematrix, out m_pbonetransform[i]);
-
-                            // MatrixCopy should be faster...
-                            //StudioMath.ConcatTransforms(*m_protationmatrix, *(Matrix3x4*)pBonematrix, out m_plighttransform[i]);
-                            m_plighttransform[i] = m_pbonetransform[i];
-                        }
-                        else
-                        {
-                            //StudioMath.ConcatTransforms(*m_paliastransform, *(Matrix3x4*)pBonematrix, out m_pbonetransform[i]);
-                            //StudioMath.ConcatTransforms(*m_protationmatrix, *(Matrix3x4*)pBonematrix, out m_plighttransform[i]);
-                            // using ref form
-                            StudioMath.ConcatTransforms(ref *m_paliastransform, ref *(Matrix3x4*)pBonematrix, out m_pbonetransform[i]);
-                            StudioMath.ConcatTransforms(ref *m_protationmatrix, ref *(Matrix3x4*)pBonematrix, out m_plighttransform[i]);
-                        }
+                        // StudioMath.ConcatTransforms(*m_protationmatrix, *(Matrix3x4*)pBonematrix, out m_pbonetransform[i]);
+                        // using ref form
+                        StudioMath.ConcatTransforms(ref *m_protationmatrix, ref *(Matrix3x4*)pBonematrix, out m_pbonetransform[i]);
 
-                        // Apply client-side effects to the transformation matrix
-                        StudioFxTransform(m_pCurrentEntity, m_pbonetransform + i);
+                        // MatrixCopy should be faster...
+                        //StudioMath.ConcatTransforms(*m_protationmatrix, *(Matrix3x4*)pBonematrix, out m_plighttransform[i]);
+                        m_plighttransform[i] = m_pbonetransform[i];
                     }
                     else
                     {
-                        //StudioMath.ConcatTransforms(m_pbonetransform[pbones[i].parent], *(Matrix3x4*)pBonematrix, out m_pbonetransform[i]);
-                        //StudioMath.ConcatTransforms(m_plighttransform[pbones[i].parent], *(Matrix3x4*)pBonematrix, out m_plighttransform[i]);
-
+                        //StudioMath.ConcatTransforms(*m_paliastransform, *(Matrix3x4*)pBonematrix, out m_pbonetransform[i]);
+                        //StudioMath.ConcatTransforms(*m_protationmatrix, *(Matrix3x4*)pBonematrix, out m_plighttransform[i]);
                         // using ref form
-
-                        StudioMath.ConcatTransforms(ref m_pbonetransform[pbones[i].parent], ref *(Matrix3x4*)pBonematrix, out m_pbonetransform[i]);
-                        StudioMath.ConcatTransforms(ref m_plighttransform[pbones[i].parent], ref *(Matrix3x4*)pBonematrix, out m_plighttransform[i]);
+                        StudioMath.ConcatTransforms(ref *m_paliastransform, ref *(Matrix3x4*)pBonematrix, out m_pbonetransform[i]);
+                        StudioMath.ConcatTransforms(ref *m_protationmatrix, ref *(Matrix3x4*)pBonematrix, out m_plighttransform[i]);
                     }
+
+                    // Apply client-side effects to the transformation matrix
+                    StudioFxTransform(m_pCurrentEntity, m_pbonetransform + i);
+                }
+                else
+                {
+                    //StudioMath.ConcatTransforms(m_pbonetransform[pbones[i].parent], *(Matrix3x4*)pBonematrix, out m_pbonetransform[i]);
+                    //StudioMath.ConcatTransforms(m_plighttransform[pbones[i].parent], *(Matrix3x4*)pBonematrix, out m_plighttransform[i]);
+
+                    // using ref form
+
+                    StudioMath.ConcatTransforms(ref m_pbonetransform[pbones[i].parent], ref *(Matrix3x4*)pBonematrix, out m_pbonetransform[i]);
+                    StudioMath.ConcatTransforms(ref m_plighttransform[pbones[i].parent], ref *(Matrix3x4*)pBonematrix, out m_plighttransform[i]);
                 }
             }
         }
@@ -1453,6 +1572,7 @@ public unsafe class StudioModelRenderer
         mstudiobone_t* pbones = m_pStudioHeader->GetBones();
 
         m_nCachedBones = m_pStudioHeader->numbones;
+        m_pCachedBonesInfo = m_pRenderInfo;
 
         for (i = 0; i < m_pStudioHeader->numbones; i++)
         {
@@ -1509,10 +1629,25 @@ public unsafe class StudioModelRenderer
 
             pbones = m_pStudioHeader->GetBones();
 
+            // With both models prewarmed, bone names were matched once at level load.
+            StudioModelInfo? info = m_pRenderInfo, cachedInfo = m_pCachedBonesInfo;
+            bool remap = info != null && cachedInfo != null && info.BoneCount == m_pStudioHeader->numbones;
+
             for (i = 0; i < m_pStudioHeader->numbones; i++)
             {
+                if (remap)
+                {
+                    j = cachedInfo!.BoneForNameId(info!.BoneNameIds[i]);
+                    if (j < 0 || j >= m_nCachedBones)
+                        j = m_nCachedBones;
+                }
+                else
+                {
+                    j = 0;
+                }
+
                 // Try to find cached bone
-                for (j = 0; j < m_nCachedBones; j++)
+                for (; j < m_nCachedBones; j++)
                 {
                     // Compare bone names
                     bool match = true;
@@ -2056,7 +2191,11 @@ public unsafe class StudioModelRenderer
         else if (dt > 1.0f)
             dt = 1;
 
-        StudioEstimateGait(pplayer);
+        // Between pose updates of a far player; the next estimate sees the whole movement since the last one
+        if (AnimationLod.SkipSecondary(m_nLodBand, m_fLodUpdate))
+            m_flGaitMovement = 0;
+        else
+            StudioEstimateGait(pplayer);
 
         // Calc side to side turning
         flYaw = m_pCurrentEntity->angles.Y - m_pPlayerInfo->gaityaw; // YAW
@@ -0,0 +1,34 @@
+namespace GoldsrcFramework.Replay;
+
+/// <summary>
+/// What the generated members of an <see cref="ExportWrapperAttribute"/> class do around the inner call.
+/// </summary>
+internal enum ExportWrapperKind
+{
+    /// <summary>
+    /// <c>profiler.Enter(TraceCall.X)</c> before, <c>profiler.Exit</c> in a finally (<see cref="Diagnostics.FrameProfiler"/>).
+    /// </summary>
+    Profiling,
+
+    /// <summary>
+    /// <c>TraceCapture.Begin(TraceCall.X)</c> with the edict, string and scalar arguments, <c>End</c> with the result.
+    /// </summary>
+    Recording,
+}
+
+/// <summary>
+/// Marks a partial exports wrapper with an <c>inner</c> primary constructor parameter. The SDK's source generator
+/// implements every member of its export interface that the class does not declare itself, forwarding to
+/// <c>inner</c> the way <see cref="Kind"/> says; members that need more (struct arguments, console commands, frame
+/// starts) are written by hand in the class.
+/// </summary>
+[AttributeUsage(AttributeTargets.Class, Inherited = false)]
+internal sealed class ExportWrapperAttribute : Attribute
+{
+    public ExportWrapperAttribute(ExportWrapperKind kind)
+    {
+        Kind = kind;
+    }
+
+    public ExportWrapperKind Kind { get; }
+}
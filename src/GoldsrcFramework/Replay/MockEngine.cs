@@ -0,0 +1,508 @@
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Strings;
+using NativeInterop;
+
+namespace GoldsrcFramework.Replay;
+
+/// <summary>
+/// Engine side of the export tables for offline replay: function tables, globals, an edict list and a string
+/// arena in native memory, installed into <see cref="EngineApi"/> so the exports run as they would in-game.
+///
+/// Only what the exports lean on for state is implemented (edicts, private data, strings, cvars, command
+/// arguments, time, random numbers); every other engine function is a stub that returns zero. The legacy
+/// server DLL is replaced by stub tables as well unless a real one is loaded.
+/// </summary>
+internal static unsafe class MockEngine
+{
+    private const int StringArenaSize = 32 << 20;
+    private const int MaxCommandArgs = 80;
+    private const int ClientEntityCount = 1024;
+
+    private static readonly delegate* unmanaged[Cdecl]<nint> s_zero = &Zero;
+
+    private static byte* s_strings;
+    private static int s_stringsUsed;
+    private static readonly Utf8Map<int> s_stringOffsets = new(capacity: 4096);
+    private static readonly Utf8Map<nint> s_cvars = new(ignoreCase: true, capacity: 256);
+
+    private static readonly NChar*[] s_argv = new NChar*[MaxCommandArgs];
+    private static int s_argc;
+    private static byte* s_argsLine;
+
+    private static uint s_random;
+    private static cl_entity_t* s_clientEntities;
+    private static cl_entity_t* s_viewModel;
+    private static NChar* s_gameDirectory;
+    private static NChar* s_empty;
+
+    public static ServerEngineFuncs* Server { get; private set; }
+    public static ClientEngineFuncs* Client { get; private set; }
+    public static globalvars_t* Globals { get; private set; }
+    public static movevars_t* MoveVars { get; private set; }
+    public static edict_t* Edicts { get; private set; }
+    public static int EdictCount { get; private set; }
+
+    /// <summary>
+    /// Time the client side sees through GetClientTime, set by the replayer from the recorded calls.
+    /// </summary>
+    public static float ClientTime { get; set; }
+
+    public static bool IsInitialized => Server != null;
+
+    /// <summary>
+    /// Allocate the engine state and hand it to <see cref="EngineApi"/>. With <paramref name="stubLegacyServer"/>,
+    /// the legacy server tables are stubs; otherwise libserver is loaded through <see cref="LegacyServerInterop"/>.
+    /// </summary>
+    public static void Initialize(int maxEntities, string gameDirectory, bool stubLegacyServer = true)
+    {
+        if (IsInitialized)
+            return;
+
+        s_strings = (byte*)NativeMemory.AllocZeroed(StringArenaSize);
+        s_stringsUsed = 1; // string_t 0 is the empty string
+        s_argsLine = (byte*)NativeMemory.AllocZeroed(4096);
+        s_random = 0x2545F491;
+        s_empty = (NChar*)s_strings;
+        s_gameDirectory = Text(gameDirectory);
+
+        EdictCount = Math.Max(maxEntities, 1);
+        Edicts = (edict_t*)NativeMemory.AllocZeroed((nuint)EdictCount, (nuint)sizeof(edict_t));
+        for (int i = 0; i < EdictCount; i++)
+        {
+            Edicts[i].free.Value = i != 0 ? 1 : 0;
+            Edicts[i].v.pContainingEntity = &Edicts[i];
+        }
+
+        Globals = Alloc<globalvars_t>();
+        Globals->maxEntities = EdictCount;
+        Globals->maxClients = 32;
+        Globals->pStringBase = (NChar*)s_strings;
+
+        MoveVars = Alloc<movevars_t>();
+        MoveVars->gravity = 800;
+        MoveVars->maxspeed = 320;
+        MoveVars->friction = 4;
+        MoveVars->accelerate = 10;
+        MoveVars->airaccelerate = 10;
+        MoveVars->stopspeed = 100;
+        MoveVars->stepsize = 18;
+        MoveVars->maxvelocity = 2000;
+
+        s_clientEntities = (cl_entity_t*)NativeMemory.AllocZeroed(ClientEntityCount, (nuint)sizeof(cl_entity_t));
+        for (int i = 0; i < ClientEntityCount; i++)
+            s_clientEntities[i].index = i;
+        s_viewModel = Alloc<cl_entity_t>();
+
+        Server = CreateServerFuncs();
+        Client = CreateClientFuncs();
+        EngineApi.ServerApiInit(Server, Globals);
+        EngineApi.ClientApiInit(Client);
+
+        if (stubLegacyServer)
+            LegacyServerInterop.Attach(StubTable<ServerExportFuncs>(), StubTable<ServerNewExportFuncs>());
+        else
+            LegacyServerInterop.Initialize(Server, Globals);
+    }
+
+    public static edict_t* EdictAt(int index) => (uint)index < (uint)EdictCount ? Edicts + index : null;
+
+    public static int IndexOf(edict_t* edict)
+    {
+        long index = edict - Edicts;
+        return edict != null && index >= 0 && index < EdictCount ? (int)index : -1;
+    }
+
+    /// <summary>
+    /// string_t offset of <paramref name="text"/> in the arena; equal strings share one copy.
+    /// </summary>
+    public static int StringOffset(ReadOnlySpan<byte> text)
+    {
+        if (text.IsEmpty)
+            return 0;
+        if (s_stringOffsets.TryGetValue(text, out int offset))
+            return offset;
+        if (s_stringsUsed + text.Length + 1 > StringArenaSize)
+            throw new InvalidOperationException("Replay string arena is full");
+
+        offset = s_stringsUsed;
+        text.CopyTo(new Span<byte>(s_strings + offset, text.Length));
+        s_strings[offset + text.Length] = 0;
+        s_stringsUsed += text.Length + 1;
+        s_stringOffsets.TryAdd(text, offset);
+        return offset;
+    }
+
+    public static NChar* StringAt(uint offset) => (NChar*)(s_strings + offset);
+
+    public static NChar* Text(ReadOnlySpan<byte> text) => StringAt((uint)StringOffset(text));
+
+    public static NChar* Text(string text) => Text(System.Text.Encoding.UTF8.GetBytes(text));
+
+    /// <summary>
+    /// Arguments Cmd_Argc / Cmd_Argv / Cmd_Args return until the next command.
+    /// </summary>
+    public static void SetCommand(ReadOnlySpan<nint> args)
+    {
+        s_argc = Math.Min(args.Length, MaxCommandArgs);
+        int length = 0;
+        for (int i = 0; i < s_argc; i++)
+        {
+            s_argv[i] = (NChar*)args[i];
+            if (i == 0)
+                continue;
+
+            var arg = new Utf8View((NChar*)args[i]).Span;
+            if (length + arg.Length + 2 >= 4096)
+                break;
+            if (length > 0)
+                s_argsLine[length++] = (byte)' ';
+            arg.CopyTo(new Span<byte>(s_argsLine + length, arg.Length));
+            length += arg.Length;
+        }
+        s_argsLine[length] = 0;
+    }
+
+    /// <summary>
+    /// Point the engine callbacks of a playermove_t the replayer fills in at the mock.
+    /// </summary>
+    public static void InitPlayerMove(playermove_t* pmove)
+    {
+        FillFunctionPointers((byte*)pmove, typeof(playermove_t));
+        pmove->movevars = MoveVars;
+        pmove->Sys_FloatTime = &FloatTime;
+        pmove->RandomLong = &RandomLong;
+        pmove->RandomFloat = &RandomFloat;
+        pmove->PM_PlayerTrace = &PlayerTrace;
+        pmove->PM_PlayerTraceEx = &PlayerTraceEx;
+    }
+
+    private static T* Alloc<T>() where T : unmanaged => (T*)NativeMemory.AllocZeroed((nuint)sizeof(T));
+
+    // A table of T where every slot returns zero.
+    private static T* StubTable<T>() where T : unmanaged
+    {
+        var table = Alloc<T>();
+        var slots = (nint*)table;
+        for (int i = 0; i < sizeof(T) / sizeof(nint); i++)
+            slots[i] = (nint)s_zero;
+        return table;
+    }
+
+    private static void FillFunctionPointers(byte* native, Type type)
+    {
+        foreach (var field in type.GetFields(BindingFlags.Instance | BindingFlags.Public))
+        {
+            if (field.FieldType.IsFunctionPointer)
+                *(nint*)(native + Marshal.OffsetOf(type, field.Name)) = (nint)s_zero;
+        }
+    }
+
+    private static ServerEngineFuncs* CreateServerFuncs()
+    {
+        var f = StubTable<ServerEngineFuncs>();
+        f->VecToYaw = &VecToYaw;
+        f->MakeVectors = &MakeVectors;
+        f->CreateEntity = &CreateEntity;
+        f->RemoveEntity = &RemoveEntity;
+        f->CVarRegister = &CVarRegister;
+        f->CVarGetFloat = &CVarGetFloat;
+        f->CVarGetString = &CVarGetString;
+        f->CVarGetPointer = &CVarGetPointer;
+        f->PvAllocEntPrivateData = &PvAllocEntPrivateData;
+        f->PvEntPrivateData = &PvEntPrivateData;
+        f->FreeEntPrivateData = &FreeEntPrivateData;
+        f->SzFromIndex = &SzFromIndex;
+        f->AllocString = &AllocString;
+        f->GetVarsOfEnt = &GetVarsOfEnt;
+        f->PEntityOfEntOffset = &PEntityOfEntOffset;
+        f->EntOffsetOfPEntity = &EntOffsetOfPEntity;
+        f->IndexOfEdict = &IndexOfEdict;
+        f->PEntityOfEntIndex = &PEntityOfEntIndex;
+        f->PEntityOfEntIndexAllEntities = &PEntityOfEntIndex;
+        f->FindEntityByVars = &FindEntityByVars;
+        f->Cmd_Args = &CmdArgs;
+        f->Cmd_Argv = &CmdArgv;
+        f->Cmd_Argc = &CmdArgc;
+        f->RandomLong = &RandomLong;
+        f->RandomFloat = &RandomFloat;
+        f->Time = &Time;
+        f->GetGameDir = &GetGameDir;
+        f->CheckVisibility = &CheckVisibility;
+        return f;
+    }
+
+    private static ClientEngineFuncs* CreateClientFuncs()
+    {
+        var f = StubTable<ClientEngineFuncs>();
+        f->RegisterVariable = &RegisterVariable;
+        f->GetCvarFloat = &CVarGetFloat;
+        f->GetCvarString = &CVarGetString;
+        f->GetCvarPointer = &CVarGetPointer;
+        f->Cmd_Argc = &CmdArgc;
+        f->Cmd_Argv = &CmdArgv;
+        f->GetMaxClients = &GetMaxClients;
+        f->GetClientMaxspeed = &GetClientMaxspeed;
+        f->GetLocalPlayer = &GetLocalPlayer;
+        f->GetViewModel = &GetViewModel;
+        f->GetEntityByIndex = &GetEntityByIndex;
+        f->GetClientTime = &GetClientTime;
+        f->hudGetClientOldTime = &GetClientTime;
+        f->hudGetServerGravityValue = &GetServerGravity;
+        f->GetAbsoluteTime = &FloatTime;
+        f->RandomLong = &RandomLong;
+        f->RandomFloat = &RandomFloat;
+        f->GetGameDirectory = &GetGameDirectory;
+        f->GetLevelName = &GetLevelName;
+
+        f->pTriAPI = StubTable<triangleapi_t>();
+        f->pEfxAPI = StubTable<efx_api_t>();
+        f->pEventAPI = StubTable<event_api_t>();
+        f->pDemoAPI = StubTable<demo_api_t>();
+        f->pNetAPI = StubTable<net_api_t>();
+        f->pVoiceTweak = StubTable<IVoiceTweak>();
+        return f;
+    }
+
+    // ---- Engine functions ----
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static nint Zero() => 0;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static float VecToYaw(float* v)
+    {
+        if (v[0] == 0 && v[1] == 0)
+            return 0;
+        float yaw = MathF.Atan2(v[1], v[0]) * (180 / MathF.PI);
+        return yaw < 0 ? yaw + 360 : yaw;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void MakeVectors(float* angles)
+    {
+        const float toRadians = MathF.PI / 180;
+        var (sp, cp) = MathF.SinCos(angles[0] * toRadians);
+        var (sy, cy) = MathF.SinCos(angles[1] * toRadians);
+        var (sr, cr) = MathF.SinCos(angles[2] * toRadians);
+
+        Globals->v_forward = new Vector3(cp * cy, cp * sy, -sp);
+        Globals->v_right = new Vector3(-sr * sp * cy + cr * sy, -sr * sp * sy - cr * cy, -sr * cp);
+        Globals->v_up = new Vector3(cr * sp * cy + sr * sy, cr * sp * sy - sr * cy, cr * cp);
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static edict_t* CreateEntity()
+    {
+        for (int i = Globals->maxClients + 1; i < EdictCount; i++)
+        {
+            var edict = Edicts + i;
+            if (edict->free.Value == 0)
+                continue;
+
+            int serial = edict->serialnumber + 1;
+            *edict = default;
+            edict->serialnumber = serial;
+            edict->v.pContainingEntity = edict;
+            return edict;
+        }
+        return null;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void RemoveEntity(edict_t* edict)
+    {
+        if (IndexOf(edict) <= 0)
+            return;
+        FreePrivateData(edict);
+        edict->free.Value = 1;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void CVarRegister(cvar_t* cvar)
+    {
+        if (cvar != null && cvar->name != null)
+            s_cvars.Set(new Utf8View(cvar->name), (nint)cvar);
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static cvar_t* RegisterVariable(NChar* name, NChar* value, int flags)
+    {
+        if (name == null)
+            return null;
+
+        var key = new Utf8View(name);
+        if (s_cvars.TryGetValue(key, out nint existing))
+            return (cvar_t*)existing;
+
+        var cvar = Alloc<cvar_t>();
+        cvar->name = Text(key.Span);
+        cvar->@string = value != null ? Text(new Utf8View(value).Span) : s_empty;
+        cvar->flags = flags;
+        cvar->value = value != null ? new Utf8View(value).ToSingle() : 0;
+        s_cvars.Set(key, (nint)cvar);
+        return cvar;
+    }
+
+    private static cvar_t* FindCvar(NChar* name) =>
+        name != null && s_cvars.TryGetValue(new Utf8View(name), out nint cvar) ? (cvar_t*)cvar : null;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static float CVarGetFloat(NChar* name)
+    {
+        var cvar = FindCvar(name);
+        return cvar != null ? cvar->value : 0;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static NChar* CVarGetString(NChar* name)
+    {
+        var cvar = FindCvar(name);
+        return cvar != null && cvar->@string != null ? cvar->@string : s_empty;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static cvar_t* CVarGetPointer(NChar* name) => FindCvar(name);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void* PvAllocEntPrivateData(edict_t* edict, int size)
+    {
+        FreePrivateData(edict);
+        edict->pvPrivateData = NativeMemory.AllocZeroed((nuint)Math.Max(size, 0));
+        return edict->pvPrivateData;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void* PvEntPrivateData(edict_t* edict) => edict != null ? edict->pvPrivateData : null;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void FreeEntPrivateData(edict_t* edict) => FreePrivateData(edict);
+
+    private static void FreePrivateData(edict_t* edict)
+    {
+        if (edict == null || edict->pvPrivateData == null)
+            return;
+        NativeMemory.Free(edict->pvPrivateData);
+        edict->pvPrivateData = null;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static NChar* SzFromIndex(int offset) => StringAt((uint)offset);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int AllocString(NChar* text) => text != null ? StringOffset(new Utf8View(text).Span) : 0;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static entvars_t* GetVarsOfEnt(edict_t* edict) => edict != null ? &edict->v : null;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static edict_t* PEntityOfEntOffset(int offset) => (edict_t*)((byte*)Edicts + offset);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int EntOffsetOfPEntity(edict_t* edict) => (int)((byte*)edict - (byte*)Edicts);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int IndexOfEdict(edict_t* edict) => Math.Max(IndexOf(edict), 0);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static edict_t* PEntityOfEntIndex(int index) => EdictAt(index);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static edict_t* FindEntityByVars(entvars_t* vars)
+    {
+        for (int i = 0; i < EdictCount; i++)
+        {
+            if (&Edicts[i].v == vars)
+                return Edicts + i;
+        }
+        return null;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static NChar* CmdArgs() => (NChar*)s_argsLine;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static NChar* CmdArgv(int index) => (uint)index < (uint)s_argc && s_argv[index] != null ? s_argv[index] : s_empty;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int CmdArgc() => s_argc;
+
+    // xorshift32: the same sequence on every replay of a trace.
+    private static uint NextRandom()
+    {
+        uint x = s_random;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return s_random = x;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int RandomLong(int low, int high) =>
+        high <= low ? low : low + (int)(NextRandom() % (uint)((long)high - low + 1));
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static float RandomFloat(float low, float high) => low + (high - low) * (NextRandom() >> 8) * (1f / (1 << 24));
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static float Time() => Globals->time;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static double FloatTime() => Globals->time;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static void GetGameDir(NChar* buffer)
+    {
+        var name = new Utf8View(s_gameDirectory).Span;
+        name.CopyTo(new Span<byte>(buffer, name.Length));
+        ((byte*)buffer)[name.Length] = 0;
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static NChar* GetGameDirectory() => s_gameDirectory;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static NChar* GetLevelName() => Globals->mapname.Value != 0 ? StringAt(Globals->mapname.Value) : s_empty;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int CheckVisibility(edict_t* edict, byte* set) => 1;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static int GetMaxClients() => Globals->maxClients;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static float GetClientMaxspeed() => MoveVars->maxspeed;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static float GetServerGravity() => MoveVars->gravity;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static float GetClientTime() => ClientTime;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static cl_entity_t* GetLocalPlayer() => s_clientEntities + 1;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static cl_entity_t* GetViewModel() => s_viewModel;
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static cl_entity_t* GetEntityByIndex(int index) =>
+        (uint)index < ClientEntityCount ? s_clientEntities + index : null;
+
+    // Nothing in the way: the move always completes.
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static pmtrace_t PlayerTrace(float* start, float* end, int traceFlags, int ignore) => OpenTrace(end);
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static pmtrace_t PlayerTraceEx(float* start, float* end, int traceFlags, delegate* unmanaged[Cdecl]<physent_t*, int> ignore) => OpenTrace(end);
+
+    private static pmtrace_t OpenTrace(float* end)
+    {
+        var trace = new pmtrace_t { fraction = 1, ent = -1 };
+        trace.endpos = new Vector3(end[0], end[1], end[2]);
+        return trace;
+    }
+}
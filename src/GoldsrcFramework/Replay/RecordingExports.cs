@@ -0,0 +1,291 @@
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using NativeInterop;
+
+namespace GoldsrcFramework.Replay;
+
+/// <summary>
+/// Server exports wrapper that records each call through <see cref="TraceCapture"/> around the real implementation.
+/// Installed by ServerMain when <c>Framework:CaptureTracePath</c> is set. The generator writes the exports whose edict,
+/// string and scalar arguments are all there is to record (<see cref="ExportWrapperAttribute"/>); the ones with
+/// structs, buffers or extra state are here.
+/// </summary>
+[ExportWrapper(ExportWrapperKind.Recording)]
+public sealed unsafe partial class RecordingServerExports(IServerExportFuncs inner) : IServerExportFuncs
+{
+    // The game DLLs only ever look at the first MAX_WEAPONS entries of weapon_data_t arrays.
+    internal const int MaxWeapons = 32;
+
+    // Engine buffers handed to ClientConnect / InconsistentFile.
+    internal const int RejectReasonSize = 128;
+
+    public IServerExportFuncs Inner => inner;
+
+    private static TraceCallScope Begin(TraceCall call) => TraceCapture.Begin(call);
+
+    private static TraceCallScope WithGlobals(TraceCallScope call) => call.Struct(TraceStruct.Globals, EngineApi.PGlobals, output: false);
+
+    public void GameInit()
+    {
+        var call = WithGlobals(Begin(TraceCall.GameInit));
+        inner.GameInit();
+        call.End();
+    }
+
+    public void KeyValue(edict_t* pentKeyvalue, KeyValueData* pkvd)
+    {
+        var call = Begin(TraceCall.KeyValue).Edict(pentKeyvalue).Struct(TraceStruct.KeyValueData, pkvd);
+        inner.KeyValue(pentKeyvalue, pkvd);
+        call.End();
+    }
+
+    public qboolean ClientConnect(edict_t* pEntity, NChar* pszName, NChar* pszAddress, NChar* szRejectReason)
+    {
+        var call = Begin(TraceCall.ClientConnect).Edict(pEntity).Text(pszName).Text(pszAddress).Bytes(szRejectReason, RejectReasonSize);
+        var result = inner.ClientConnect(pEntity, pszName, pszAddress, szRejectReason);
+        call.End(result.Value);
+        return result;
+    }
+
+    public void ClientCommand(edict_t* pEntity)
+    {
+        var call = Begin(TraceCall.ClientCommand).Edict(pEntity).Command();
+        inner.ClientCommand(pEntity);
+        call.End();
+    }
+
+    public void ServerActivate(edict_t* pEdictList, int edictCount, int clientMax)
+    {
+        var globals = EngineApi.PGlobals;
+        TraceCapture.SetEdictList(pEdictList, globals != null ? Math.Max(globals->maxEntities, edictCount) : edictCount);
+        var call = WithGlobals(Begin(TraceCall.ServerActivate).Int(edictCount).Int(clientMax));
+        inner.ServerActivate(pEdictList, edictCount, clientMax);
+        call.End();
+    }
+
+    public void StartFrame()
+    {
+        var call = WithGlobals(Begin(TraceCall.StartFrame));
+        inner.StartFrame();
+        call.End();
+    }
+
+    public void PM_Move(playermove_t* ppmove, qboolean server)
+    {
+        var call = Begin(TraceCall.PM_Move).Struct(TraceStruct.PlayerMove, ppmove)
+            .Struct(TraceStruct.MoveVars, ppmove != null ? ppmove->movevars : null, output: false).Int(server.Value);
+        inner.PM_Move(ppmove, server);
+        call.End();
+    }
+
+    public void PM_Init(playermove_t* ppmove)
+    {
+        var call = Begin(TraceCall.PM_Init).Struct(TraceStruct.PlayerMove, ppmove)
+            .Struct(TraceStruct.MoveVars, ppmove != null ? ppmove->movevars : null, output: false);
+        inner.PM_Init(ppmove);
+        call.End();
+    }
+
+    public void UpdateClientData(edict_t* ent, int sendweapons, clientdata_t* cd)
+    {
+        var call = Begin(TraceCall.UpdateClientData).Edict(ent).Int(sendweapons).Struct(TraceStruct.ClientData, cd);
+        inner.UpdateClientData(ent, sendweapons, cd);
+        call.End();
+    }
+
+    public int AddToFullPack(entity_state_t* state, int e, edict_t* ent, edict_t* host, int hostflags, int player, byte* pSet)
+    {
+        var call = Begin(TraceCall.AddToFullPack).Struct(TraceStruct.EntityState, state).Int(e).Edict(ent).Edict(host).Int(hostflags).Int(player);
+        return call.End(inner.AddToFullPack(state, e, ent, host, hostflags, player, pSet));
+    }
+
+    public void CreateBaseline(int player, int eindex, entity_state_t* baseline, edict_t* entity, int playermodelindex, Vector3* player_mins, Vector3* player_maxs)
+    {
+        var call = Begin(TraceCall.CreateBaseline).Int(player).Int(eindex).Struct(TraceStruct.EntityState, baseline).Edict(entity).Int(playermodelindex)
+            .Bytes(player_mins, 4 * sizeof(Vector3), output: false).Bytes(player_maxs, 4 * sizeof(Vector3), output: false);
+        inner.CreateBaseline(player, eindex, baseline, entity, playermodelindex, player_mins, player_maxs);
+        call.End();
+    }
+
+    public int GetWeaponData(edict_t* player, weapon_data_t* info)
+    {
+        var call = Begin(TraceCall.GetWeaponData).Edict(player).Structs(TraceStruct.WeaponData, info, MaxWeapons);
+        return call.End(inner.GetWeaponData(player, info));
+    }
+
+    public void CmdStart(edict_t* player, usercmd_t* cmd, uint random_seed)
+    {
+        var call = Begin(TraceCall.CmdStart).Edict(player).Struct(TraceStruct.UserCmd, cmd, output: false).Int((int)random_seed);
+        inner.CmdStart(player, cmd, random_seed);
+        call.End();
+    }
+
+    public int ConnectionlessPacket(netadr_t* net_from, NChar* args, NChar* response_buffer, int* response_buffer_size)
+    {
+        var call = Begin(TraceCall.ConnectionlessPacket).Struct(TraceStruct.NetAddress, net_from, output: false).Text(args)
+            .Bytes(response_buffer, response_buffer_size != null ? *response_buffer_size : 0).Bytes(response_buffer_size, sizeof(int));
+        return call.End(inner.ConnectionlessPacket(net_from, args, response_buffer, response_buffer_size));
+    }
+
+    public int GetHullBounds(int hullnumber, float* mins, float* maxs)
+    {
+        var call = Begin(TraceCall.GetHullBounds).Int(hullnumber).Bytes(mins, 3 * sizeof(float)).Bytes(maxs, 3 * sizeof(float));
+        return call.End(inner.GetHullBounds(hullnumber, mins, maxs));
+    }
+
+    public int InconsistentFile(edict_t* player, NChar* filename, NChar* disconnect_message)
+    {
+        var call = Begin(TraceCall.InconsistentFile).Edict(player).Text(filename);
+        return call.End(inner.InconsistentFile(player, filename, disconnect_message));
+    }
+
+    public void GameShutdown()
+    {
+        var call = Begin(TraceCall.GameShutdown);
+        inner.GameShutdown();
+        call.End();
+        TraceCapture.Stop();
+    }
+}
+
+/// <summary>
+/// Client exports wrapper that records each call through <see cref="TraceCapture"/>. Installed by ClientMain when
+/// <c>Framework:CaptureTracePath</c> is set. As on the server, only the exports the generator cannot write are here.
+/// </summary>
+[ExportWrapper(ExportWrapperKind.Recording)]
+public sealed unsafe partial class RecordingClientExports(IClientExportFuncs inner) : IClientExportFuncs
+{
+    public IClientExportFuncs Inner => inner;
+
+    private static TraceCallScope Begin(TraceCall call) => TraceCapture.Begin(call);
+
+    public int HUD_UpdateClientData(client_data_t* cdata, float flTime)
+    {
+        var call = Begin(TraceCall.HUD_UpdateClientData).Struct(TraceStruct.HudClientData, cdata).Float(flTime);
+        return call.End(inner.HUD_UpdateClientData(cdata, flTime));
+    }
+
+    public void HUD_PlayerMove(playermove_t* ppmove, qboolean server)
+    {
+        var call = Begin(TraceCall.HUD_PlayerMove).Struct(TraceStruct.PlayerMove, ppmove)
+            .Struct(TraceStruct.MoveVars, ppmove != null ? ppmove->movevars : null, output: false).Int(server.Value);
+        inner.HUD_PlayerMove(ppmove, server);
+        call.End();
+    }
+
+    public void HUD_PlayerMoveInit(playermove_t* ppmove)
+    {
+        var call = Begin(TraceCall.HUD_PlayerMoveInit).Struct(TraceStruct.PlayerMove, ppmove)
+            .Struct(TraceStruct.MoveVars, ppmove != null ? ppmove->movevars : null, output: false);
+        inner.HUD_PlayerMoveInit(ppmove);
+        call.End();
+    }
+
+    public void CL_CreateMove(float frametime, usercmd_t* cmd, int active)
+    {
+        var call = Begin(TraceCall.CL_CreateMove).Float(frametime).Struct(TraceStruct.UserCmd, cmd).Int(active);
+        inner.CL_CreateMove(frametime, cmd, active);
+        call.End();
+    }
+
+    public void CL_GetCameraOffsets(Vector3* ofs)
+    {
+        var call = Begin(TraceCall.CL_GetCameraOffsets).Bytes(ofs, sizeof(Vector3));
+        inner.CL_GetCameraOffsets(ofs);
+        call.End();
+    }
+
+    public void V_CalcRefdef(ref_params_t* pparams)
+    {
+        var call = Begin(TraceCall.V_CalcRefdef).Struct(TraceStruct.RefParams, pparams);
+        inner.V_CalcRefdef(pparams);
+        call.End();
+    }
+
+    public int HUD_AddEntity(int type, cl_entity_t* ent, NChar* modelname)
+    {
+        var call = Begin(TraceCall.HUD_AddEntity).Int(type).Struct(TraceStruct.ClientEntity, ent).Text(modelname);
+        return call.End(inner.HUD_AddEntity(type, ent, modelname));
+    }
+
+    public void HUD_StudioEvent(mstudioevent_t* @event, cl_entity_t* entity)
+    {
+        var call = Begin(TraceCall.HUD_StudioEvent).Struct(TraceStruct.StudioEvent, @event, output: false)
+            .Struct(TraceStruct.ClientEntity, entity, output: false);
+        inner.HUD_StudioEvent(@event, entity);
+        call.End();
+    }
+
+    public void HUD_PostRunCmd(local_state_t* from, local_state_t* to, usercmd_t* cmd, int runfuncs, double time, uint random_seed)
+    {
+        var call = Begin(TraceCall.HUD_PostRunCmd).Struct(TraceStruct.LocalState, from, output: false).Struct(TraceStruct.LocalState, to)
+            .Struct(TraceStruct.UserCmd, cmd, output: false).Int(runfuncs).Double(time).Int((int)random_seed);
+        inner.HUD_PostRunCmd(from, to, cmd, runfuncs, time, random_seed);
+        call.End();
+    }
+
+    public void HUD_Shutdown()
+    {
+        var call = Begin(TraceCall.HUD_Shutdown);
+        inner.HUD_Shutdown();
+        call.End();
+        TraceCapture.Stop();
+    }
+
+    public void HUD_TxferLocalOverrides(entity_state_t* state, clientdata_t* client)
+    {
+        var call = Begin(TraceCall.HUD_TxferLocalOverrides).Struct(TraceStruct.EntityState, state).Struct(TraceStruct.ClientData, client, output: false);
+        inner.HUD_TxferLocalOverrides(state, client);
+        call.End();
+    }
+
+    public void HUD_ProcessPlayerState(entity_state_t* dst, entity_state_t* src)
+    {
+        var call = Begin(TraceCall.HUD_ProcessPlayerState).Struct(TraceStruct.EntityState, dst).Struct(TraceStruct.EntityState, src, output: false);
+        inner.HUD_ProcessPlayerState(dst, src);
+        call.End();
+    }
+
+    public void HUD_TxferPredictionData(entity_state_t* ps, entity_state_t* pps, clientdata_t* pcd, clientdata_t* ppcd, weapon_data_t* wd, weapon_data_t* pwd)
+    {
+        var call = Begin(TraceCall.HUD_TxferPredictionData).Struct(TraceStruct.EntityState, ps).Struct(TraceStruct.EntityState, pps, output: false)
+            .Struct(TraceStruct.ClientData, pcd).Struct(TraceStruct.ClientData, ppcd, output: false)
+            .Structs(TraceStruct.WeaponData, wd, RecordingServerExports.MaxWeapons).Structs(TraceStruct.WeaponData, pwd, RecordingServerExports.MaxWeapons, output: false);
+        inner.HUD_TxferPredictionData(ps, pps, pcd, ppcd, wd, pwd);
+        call.End();
+    }
+
+    public void Demo_ReadBuffer(int size, byte* buffer)
+    {
+        var call = Begin(TraceCall.Demo_ReadBuffer).Int(size).Bytes(buffer, size, output: false);
+        inner.Demo_ReadBuffer(size, buffer);
+        call.End();
+    }
+
+    public int HUD_ConnectionlessPacket(netadr_t* net_from, NChar* args, NChar* response_buffer, int* response_buffer_size)
+    {
+        var call = Begin(TraceCall.HUD_ConnectionlessPacket).Struct(TraceStruct.NetAddress, net_from, output: false).Text(args)
+            .Bytes(response_buffer, response_buffer_size != null ? *response_buffer_size : 0).Bytes(response_buffer_size, sizeof(int));
+        return call.End(inner.HUD_ConnectionlessPacket(net_from, args, response_buffer, response_buffer_size));
+    }
+
+    public int HUD_GetHullBounds(int hullnumber, float* mins, float* maxs)
+    {
+        var call = Begin(TraceCall.HUD_GetHullBounds).Int(hullnumber).Bytes(mins, 3 * sizeof(float)).Bytes(maxs, 3 * sizeof(float));
+        return call.End(inner.HUD_GetHullBounds(hullnumber, mins, maxs));
+    }
+
+    public void HUD_DirectorMessage(int iSize, void* pbuf)
+    {
+        var call = Begin(TraceCall.HUD_DirectorMessage).Int(iSize).Bytes(pbuf, iSize, output: false);
+        inner.HUD_DirectorMessage(iSize, pbuf);
+        call.End();
+    }
+
+    public void HUD_ChatInputPosition(int* x, int* y)
+    {
+        var call = Begin(TraceCall.HUD_ChatInputPosition).Bytes(x, sizeof(int)).Bytes(y, sizeof(int));
+        inner.HUD_ChatInputPosition(x, y);
+        call.End();
+    }
+}
@@ -0,0 +1,650 @@
+using System.Buffers.Binary;
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Strings;
+using NativeInterop;
+
+namespace GoldsrcFramework.Replay;
+
+public readonly record struct TraceCaptureStats(long Calls, long Strings, long Bytes, string? Path);
+
+/// <summary>
+/// Capture mode of the export thunks: while running, <see cref="RecordingServerExports"/> and
+/// <see cref="RecordingClientExports"/> write every engine→mod call, its arguments and the structures they point at,
+/// to a trace file that <see cref="TraceReplayer"/> can feed back into the exports offline.
+///
+/// Each call is encoded into a per-thread buffer before the mod runs and written whole when it returns, so the file
+/// is only touched once per call and nested calls come out before the call that contains them. Edicts and structs
+/// are stored as deltas against the previous value in the same slot (see <see cref="TraceDelta"/>), strings once
+/// each as tokens. Costs a few microseconds per call; when capture is off the thunks are not wrapped at all.
+/// </summary>
+public static unsafe class TraceCapture
+{
+    private const int MaxDepth = 16;
+    private const int MaxOutputs = 8;
+
+    private static readonly object s_lock = new();
+    private static FileStream? s_file;
+    private static string? s_path;
+    private static long s_startTimestamp;
+    private static long s_calls;
+    private static long s_bytes;
+    private static volatile bool s_recording;
+
+    // Delta bases and string tokens, shared by client and server calls. Guarded by s_lock.
+    private static readonly Utf8Map<uint> s_tokens = new(capacity: 4096);
+    private static readonly Dictionary<int, TraceSlot> s_slots = new();
+    private static byte[] s_scratch = new byte[4096];
+    private static edict_t* s_edictBase;
+    private static int s_edictCount;
+
+    [ThreadStatic] private static Frame[]? t_frames;
+    [ThreadStatic] private static int t_depth;
+
+    public static bool IsRecording => s_recording;
+
+    public static TraceCaptureStats Stats
+    {
+        get
+        {
+            lock (s_lock)
+                return new TraceCaptureStats(s_calls, s_tokens.Count, s_bytes, s_path);
+        }
+    }
+
+    /// <summary>
+    /// Start writing a new trace to <paramref name="path"/>. Does nothing when already recording.
+    /// </summary>
+    public static void Start(string path)
+    {
+        lock (s_lock)
+        {
+            if (s_recording)
+                return;
+
+            s_path = Path.GetFullPath(path);
+            var directory = Path.GetDirectoryName(s_path);
+            if (!string.IsNullOrEmpty(directory))
+                Directory.CreateDirectory(directory);
+
+            s_file = new FileStream(s_path, FileMode.Create, FileAccess.Write, FileShare.Read, 1 << 16);
+            s_tokens.Clear();
+            s_slots.Clear();
+            s_edictBase = null;
+            s_calls = 0;
+            s_bytes = 0;
+            s_startTimestamp = Stopwatch.GetTimestamp();
+
+            var header = new TraceFileHeader
+            {
+                Magic = TraceFileHeader.MagicValue,
+                Version = TraceFileHeader.CurrentVersion,
+                PointerSize = IntPtr.Size,
+                MaxEntities = EngineApi.PGlobals != null ? EngineApi.PGlobals->maxEntities : 0,
+                TimestampFrequency = Stopwatch.Frequency,
+                StartedUtcTicks = DateTime.UtcNow.Ticks,
+            };
+            s_file.Write(MemoryMarshal.AsBytes(new ReadOnlySpan<TraceFileHeader>(ref header)));
+            s_bytes = sizeof(TraceFileHeader);
+            s_recording = true;
+        }
+        Debug.WriteLine($"[TraceCapture] Recording to {s_path}");
+    }
+
+    /// <summary>
+    /// Start recording if <paramref name="path"/> is set, returning whether a capture is running.
+    /// </summary>
+    public static bool StartIfConfigured(string? path)
+    {
+        if (string.IsNullOrWhiteSpace(path))
+            return s_recording;
+        try
+        {
+            Start(path);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            Debug.WriteLine($"[TraceCapture] Cannot record to {path}: {ex.Message}");
+        }
+        return s_recording;
+    }
+
+    public static void Stop()
+    {
+        lock (s_lock)
+        {
+            if (!s_recording)
+                return;
+            s_recording = false;
+            s_file!.Dispose();
+            s_file = null;
+        }
+        Debug.WriteLine($"[TraceCapture] Stopped: {s_calls} calls, {s_bytes} bytes");
+    }
+
+    /// <summary>
+    /// Begin recording a call. Returns a scope that does nothing when capture is off or nesting is too deep.
+    /// </summary>
+    internal static TraceCallScope Begin(TraceCall call)
+    {
+        if (!s_recording || t_depth >= MaxDepth)
+            return default;
+
+        var frames = t_frames ??= new Frame[MaxDepth];
+        var frame = frames[t_depth] ??= new Frame();
+        frame.Call = call;
+        frame.Depth = (byte)t_depth;
+        frame.Length = 0;
+        frame.Args = 0;
+        frame.Outputs = 0;
+        t_depth++;
+        frame.Start = Stopwatch.GetTimestamp();
+        return new TraceCallScope(frame);
+    }
+
+    /// <summary>
+    /// Point edict indices at a new edict list (ServerActivate).
+    /// </summary>
+    internal static void SetEdictList(edict_t* edicts, int count)
+    {
+        lock (s_lock)
+        {
+            s_edictBase = edicts;
+            s_edictCount = count;
+        }
+    }
+
+    internal sealed class Frame
+    {
+        public TraceCall Call;
+        public byte Depth;
+        public long Start;
+        public byte[] Buffer = new byte[1024];
+        public int Length;
+        public int Args;
+        public int Outputs;
+        public readonly Output[] Output = new Output[MaxOutputs];
+
+        public Span<byte> Reserve(int bytes)
+        {
+            if (Length + bytes > Buffer.Length)
+                Array.Resize(ref Buffer, Math.Max(Length + bytes, Buffer.Length * 2));
+            return Buffer.AsSpan(Length);
+        }
+
+        public void Put(TraceArg tag, int value)
+        {
+            var span = Reserve(5);
+            span[0] = (byte)tag;
+            BinaryPrimitives.WriteInt32LittleEndian(span[1..], value);
+            Length += 5;
+        }
+
+        public void AddOutput(TraceArg kind, void* pointer, int info)
+        {
+            if (pointer != null && Outputs < MaxOutputs)
+                Output[Outputs++] = new Output(kind, pointer, info);
+        }
+    }
+
+    internal readonly struct Output(TraceArg kind, void* pointer, int info)
+    {
+        public readonly TraceArg Kind = kind;
+        public readonly void* Pointer = pointer;
+        public readonly int Info = info;
+    }
+
+    // ---- Argument encoding, called by TraceCallScope under the lock ----
+
+    internal static void PutEdict(Frame frame, edict_t* edict)
+    {
+        lock (s_lock)
+        {
+            var map = new RecordMap();
+            int index = map.EncodeEdict(edict) - 1;
+            frame.Put(TraceArg.Edict | TraceArg.Output, index);
+            if (index >= 0)
+            {
+                int length = EncodeEdictState(edict, ref map);
+                PutDelta(frame, EdictSlot(index), length);
+                frame.AddOutput(TraceArg.Edict, edict, 0);
+            }
+        }
+    }
+
+    internal static void PutStruct(Frame frame, TraceStruct type, void* values, int count, bool output)
+    {
+        lock (s_lock)
+        {
+            if (values == null || count <= 0)
+            {
+                frame.Reserve(1)[0] = (byte)TraceArg.Null;
+                frame.Length++;
+                return;
+            }
+
+            var span = frame.Reserve(4);
+            span[0] = (byte)(output ? TraceArg.Struct | TraceArg.Output : TraceArg.Struct);
+            span[1] = (byte)type;
+            BinaryPrimitives.WriteUInt16LittleEndian(span[2..], (ushort)count);
+            frame.Length += 4;
+
+            var map = new RecordMap();
+            int length = EncodeStructs(type, (byte*)values, count, ref map, ref s_scratch);
+            PutDelta(frame, StructSlot(frame.Call, frame.Args), length);
+            if (output)
+                frame.AddOutput(TraceArg.Struct, values, (int)type | count << 8);
+        }
+    }
+
+    internal static void PutText(Frame frame, NChar* text)
+    {
+        lock (s_lock)
+        {
+            var map = new RecordMap();
+            frame.Put(TraceArg.Text, (int)map.EncodeText(text));
+        }
+    }
+
+    internal static void PutBytes(Frame frame, void* data, int length, bool output)
+    {
+        if (data == null || length < 0)
+        {
+            frame.Reserve(1)[0] = (byte)TraceArg.Null;
+            frame.Length++;
+            return;
+        }
+        frame.Put(output ? TraceArg.Bytes | TraceArg.Output : TraceArg.Bytes, length);
+        new ReadOnlySpan<byte>(data, length).CopyTo(frame.Reserve(length));
+        frame.Length += length;
+        if (output)
+            frame.AddOutput(TraceArg.Bytes, data, length);
+    }
+
+    internal static void PutCommand(Frame frame)
+    {
+        var engine = EngineApi.PServer;
+        int argc = engine != null && engine->Cmd_Argc != null ? engine->Cmd_Argc() : 0;
+        lock (s_lock)
+        {
+            var map = new RecordMap();
+            frame.Put(TraceArg.Command, argc);
+            for (int i = 0; i < argc; i++)
+            {
+                uint token = map.EncodeText(engine->Cmd_Argv(i));
+                BinaryPrimitives.WriteUInt32LittleEndian(frame.Reserve(4), token);
+                frame.Length += 4;
+            }
+        }
+    }
+
+    internal static void End(Frame frame, TraceArg returnKind, int returnValue)
+    {
+        long elapsed = Stopwatch.GetTimestamp() - frame.Start;
+        t_depth--;
+
+        lock (s_lock)
+        {
+            if (!s_recording)
+                return;
+            frame.Put(returnKind, returnValue);
+            Finish(frame, elapsed, returnValue);
+        }
+    }
+
+    /// <summary>
+    /// Text return values (GetGameDescription) are recorded as a token and enter the digest as their hash.
+    /// </summary>
+    internal static void EndText(Frame frame, NChar* text)
+    {
+        long elapsed = Stopwatch.GetTimestamp() - frame.Start;
+        t_depth--;
+
+        lock (s_lock)
+        {
+            if (!s_recording)
+                return;
+            frame.Put(TraceArg.Text, (int)Token(text));
+            Finish(frame, elapsed, TraceDigest.Text(text));
+        }
+    }
+
+    private static void Finish(Frame frame, long elapsed, long returnValue)
+    {
+        var map = new DigestMap();
+        ulong digest = Digest(frame.Output.AsSpan(0, frame.Outputs), returnValue, ref map, ref s_scratch);
+        BinaryPrimitives.WriteUInt64LittleEndian(frame.Reserve(8), digest);
+        frame.Length += 8;
+
+        var header = new TraceRecordHeader
+        {
+            Type = TraceRecordType.Call,
+            Depth = frame.Depth,
+            Call = frame.Call,
+            Length = frame.Length,
+            Start = frame.Start - s_startTimestamp,
+            Elapsed = elapsed,
+        };
+        Write(ref header, frame.Buffer.AsSpan(0, frame.Length));
+        s_calls++;
+    }
+
+    // ---- Shared with the replayer: the same encodings must come out on both sides ----
+
+    internal static int EdictSlot(int index) => -1 - index;
+
+    internal static int StructSlot(TraceCall call, int argument) => ((int)call << 8) | argument;
+
+    internal static int EdictStateSize => 8 + TraceLayout.For(TraceStruct.EntVars).MaxEncodedSize;
+
+    /// <summary>
+    /// Free flag, serial number, then the encoded entvars.
+    /// </summary>
+    internal static int EncodeEdictState<TMap>(edict_t* edict, byte* dest, ref TMap map) where TMap : struct, ITraceEncodeMap
+    {
+        Unsafe.WriteUnaligned(dest, edict->free.Value);
+        Unsafe.WriteUnaligned(dest + 4, edict->serialnumber);
+        return 8 + TraceLayout.For(TraceStruct.EntVars).Encode((byte*)&edict->v, dest + 8, ref map);
+    }
+
+    /// <summary>
+    /// Encode <paramref name="count"/> consecutive structs into <paramref name="scratch"/>, growing it as needed.
+    /// </summary>
+    internal static int EncodeStructs<TMap>(TraceStruct type, byte* values, int count, ref TMap map, ref byte[] scratch)
+        where TMap : struct, ITraceEncodeMap
+    {
+        var layout = TraceLayout.For(type);
+        int max = layout.MaxEncodedSize * count;
+        if (scratch.Length < max)
+            scratch = new byte[Math.Max(max, scratch.Length * 2)];
+
+        int length = 0;
+        fixed (byte* s = scratch)
+        {
+            for (int i = 0; i < count; i++)
+                length += layout.Encode(values + i * layout.NativeSize, s + length, ref map);
+        }
+        return length;
+    }
+
+    /// <summary>
+    /// Hash of the state a call may have changed, compared between recording and replay. Strings enter as their
+    /// text and edicts as indices, so the value does not depend on where anything lives.
+    /// </summary>
+    internal static ulong Digest<TMap>(ReadOnlySpan<Output> outputs, long returnValue, ref TMap map, ref byte[] scratch)
+        where TMap : struct, ITraceEncodeMap
+    {
+        ulong hash = TraceDigest.Add(TraceDigest.Seed, returnValue);
+        foreach (ref readonly var output in outputs)
+        {
+            int length;
+            switch (output.Kind)
+            {
+                case TraceArg.Edict:
+                    if (scratch.Length < EdictStateSize)
+                        scratch = new byte[EdictStateSize * 2];
+                    fixed (byte* s = scratch)
+                        length = EncodeEdictState((edict_t*)output.Pointer, s, ref map);
+                    hash = TraceDigest.Add(hash, scratch.AsSpan(0, length));
+                    break;
+                case TraceArg.Struct:
+                    length = EncodeStructs((TraceStruct)(output.Info & 0xFF), (byte*)output.Pointer, output.Info >> 8, ref map, ref scratch);
+                    hash = TraceDigest.Add(hash, scratch.AsSpan(0, length));
+                    break;
+                case TraceArg.Bytes:
+                    hash = TraceDigest.Add(hash, new ReadOnlySpan<byte>(output.Pointer, output.Info));
+                    break;
+            }
+        }
+        return hash;
+    }
+
+    private static int EncodeEdictState(edict_t* edict, ref RecordMap map)
+    {
+        EnsureScratch(EdictStateSize);
+        fixed (byte* scratch = s_scratch)
+            return EncodeEdictState(edict, scratch, ref map);
+    }
+
+    // Delta of s_scratch[..length] against the slot's last value, appended to the frame. Nested calls are written
+    // before the call around them although their arguments are encoded after it, so they are stored against an
+    // empty base and leave the slots alone; that keeps the chain of deltas in file order.
+    private static void PutDelta(Frame frame, int slot, int length)
+    {
+        var current = s_scratch.AsSpan(0, length);
+        if (frame.Depth > 0)
+        {
+            frame.Length += TraceDelta.Encode(default, current, frame.Reserve(TraceDelta.MaxEncodedSize(length)));
+            return;
+        }
+
+        ref var previous = ref CollectionsMarshal.GetValueRefOrAddDefault(s_slots, slot, out _);
+        int written = TraceDelta.Encode(previous.Data.AsSpan(0, previous.Length), current, frame.Reserve(TraceDelta.MaxEncodedSize(length)));
+        frame.Length += written;
+
+        if (previous.Data == null || previous.Data.Length < length)
+            previous.Data = new byte[Math.Max(length, 64)];
+        current.CopyTo(previous.Data);
+        previous.Length = length;
+    }
+
+    private static void EnsureScratch(int bytes)
+    {
+        if (s_scratch.Length < bytes)
+            s_scratch = new byte[Math.Max(bytes, s_scratch.Length * 2)];
+    }
+
+    private static void Write(ref TraceRecordHeader header, ReadOnlySpan<byte> payload)
+    {
+        s_file!.Write(MemoryMarshal.AsBytes(new ReadOnlySpan<TraceRecordHeader>(ref header)));
+        s_file.Write(payload);
+        s_bytes += sizeof(TraceRecordHeader) + payload.Length;
+    }
+
+    private static uint Token(NChar* text)
+    {
+        if (text == null || s_file == null)
+            return 0;
+
+        var view = new Utf8View(text);
+        if (s_tokens.TryGetValue(view, out uint token))
+            return token;
+
+        token = (uint)s_tokens.Count + 1;
+        s_tokens.TryAdd(view, token);
+
+        var header = new TraceRecordHeader { Type = TraceRecordType.String, Length = 4 + view.Length };
+        Span<byte> id = stackalloc byte[4];
+        BinaryPrimitives.WriteUInt32LittleEndian(id, token);
+        s_file!.Write(MemoryMarshal.AsBytes(new ReadOnlySpan<TraceRecordHeader>(ref header)));
+        s_file.Write(id);
+        s_file.Write(view.Span);
+        s_bytes += sizeof(TraceRecordHeader) + header.Length;
+        return token;
+    }
+
+    private static int EdictIndex(edict_t* edict)
+    {
+        if (edict == null)
+            return 0;
+
+        if (s_edictBase == null)
+        {
+            var engine = EngineApi.PServer;
+            if (engine == null || EngineApi.PGlobals == null)
+                return 0;
+            s_edictBase = engine->PEntityOfEntIndex(0);
+            s_edictCount = EngineApi.PGlobals->maxEntities;
+        }
+
+        long index = edict - s_edictBase;
+        return index >= 0 && index < s_edictCount ? (int)index + 1 : 0;
+    }
+
+    private static NChar* StringAt(uint offset)
+    {
+        var globals = EngineApi.PGlobals;
+        return offset == 0 || globals == null ? null : globals->pStringBase + offset;
+    }
+
+    private struct RecordMap : ITraceEncodeMap
+    {
+        public int EncodeEdict(edict_t* edict) => EdictIndex(edict);
+
+        public uint EncodeString(uint offset) => Token(StringAt(offset));
+
+        public uint EncodeText(NChar* text) => Token(text);
+    }
+
+    private struct DigestMap : ITraceEncodeMap
+    {
+        public int EncodeEdict(edict_t* edict) => EdictIndex(edict);
+
+        public uint EncodeString(uint offset) => TraceDigest.Text(StringAt(offset));
+
+        public uint EncodeText(NChar* text) => TraceDigest.Text(text);
+    }
+}
+
+internal struct TraceSlot
+{
+    public byte[] Data;
+    public int Length;
+}
+
+/// <summary>
+/// Call being recorded: arguments are added in parameter order before the mod runs, then one of the End methods
+/// with the return value. A default scope (capture off) ignores everything.
+/// </summary>
+internal readonly unsafe struct TraceCallScope
+{
+    private readonly TraceCapture.Frame? _frame;
+
+    internal TraceCallScope(TraceCapture.Frame frame)
+    {
+        _frame = frame;
+    }
+
+    public TraceCallScope Int(int value)
+    {
+        _frame?.Put(TraceArg.Int32, value);
+        return Next();
+    }
+
+    public TraceCallScope Float(float value)
+    {
+        _frame?.Put(TraceArg.Single, BitConverter.SingleToInt32Bits(value));
+        return Next();
+    }
+
+    public TraceCallScope Double(double value)
+    {
+        if (_frame != null)
+        {
+            var span = _frame.Reserve(9);
+            span[0] = (byte)TraceArg.Double;
+            BinaryPrimitives.WriteDoubleLittleEndian(span[1..], value);
+            _frame.Length += 9;
+        }
+        return Next();
+    }
+
+    public TraceCallScope Edict(edict_t* edict)
+    {
+        if (_frame != null)
+            TraceCapture.PutEdict(_frame, edict);
+        return Next();
+    }
+
+    public TraceCallScope Struct(TraceStruct type, void* value, bool output = true) => Structs(type, value, 1, output);
+
+    public TraceCallScope Structs(TraceStruct type, void* values, int count, bool output = true)
+    {
+        if (_frame != null)
+            TraceCapture.PutStruct(_frame, type, values, count, output);
+        return Next();
+    }
+
+    public TraceCallScope Text(NChar* text)
+    {
+        if (_frame != null)
+            TraceCapture.PutText(_frame, text);
+        return Next();
+    }
+
+    public TraceCallScope Bytes(void* data, int length, bool output = true)
+    {
+        if (_frame != null)
+            TraceCapture.PutBytes(_frame, data, length, output);
+        return Next();
+    }
+
+    /// <summary>
+    /// The server command arguments the mod will read through Cmd_Argv (ClientCommand).
+    /// </summary>
+    public TraceCallScope Command()
+    {
+        if (_frame != null)
+            TraceCapture.PutCommand(_frame);
+        return this;
+    }
+
+    public void End()
+    {
+        if (_frame != null)
+            TraceCapture.End(_frame, TraceArg.Null, 0);
+    }
+
+    public int End(int value)
+    {
+        if (_frame != null)
+            TraceCapture.End(_frame, TraceArg.Int32, value);
+        return value;
+    }
+
+    public NChar* End(NChar* text)
+    {
+        if (_frame != null)
+            TraceCapture.EndText(_frame, text);
+        return text;
+    }
+
+    private TraceCallScope Next()
+    {
+        if (_frame != null)
+            _frame.Args++;
+        return this;
+    }
+}
+
+/// <summary>
+/// 64-bit hash for call digests, over 8-byte words like <see cref="Utf8View.GetStableHashCode()"/>.
+/// </summary>
+internal static class TraceDigest
+{
+    public const ulong Seed = 0x9E3779B97F4A7C15;
+    private const ulong Prime = 0xC2B2AE3D27D4EB4F;
+
+    public static ulong Add(ulong hash, long value) => Mix(hash, (ulong)value);
+
+    public static ulong Add(ulong hash, ReadOnlySpan<byte> bytes)
+    {
+        hash = Mix(hash, (ulong)bytes.Length);
+        int i = 0;
+        for (; i + 8 <= bytes.Length; i += 8)
+            hash = Mix(hash, BinaryPrimitives.ReadUInt64LittleEndian(bytes[i..]));
+        ulong tail = 0;
+        for (int shift = 0; i < bytes.Length; i++, shift += 8)
+            tail |= (ulong)bytes[i] << shift;
+        return Mix(hash, tail);
+    }
+
+    public static unsafe uint Text(NChar* text) =>
+        text == null ? 0u : (uint)new Utf8View(text).GetStableHashCode() | 1u;
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static ulong Mix(ulong hash, ulong word) =>
+        System.Numerics.BitOperations.RotateLeft(hash ^ (word * Prime), 31) * 0x165667B19E3779F9;
+}
@@ -0,0 +1,238 @@
+using System.Runtime.InteropServices;
+
+namespace GoldsrcFramework.Replay;
+
+/// <summary>
+/// Engine→mod entry points a trace records: the server DLL_FUNCTIONS / NEW_DLL_FUNCTIONS, then the client exports
+/// from <see cref="ClientFirst"/> on.
+/// </summary>
+public enum TraceCall : ushort
+{
+    None,
+
+    GameInit,
+    Spawn,
+    Think,
+    Use,
+    Touch,
+    Blocked,
+    KeyValue,
+    Save,
+    Restore,
+    SetAbsBox,
+    SaveWriteFields,
+    SaveReadFields,
+    SaveGlobalState,
+    RestoreGlobalState,
+    ResetGlobalState,
+    ClientConnect,
+    ClientDisconnect,
+    ClientKill,
+    ClientPutInServer,
+    ClientCommand,
+    ClientUserInfoChanged,
+    ServerActivate,
+    ServerDeactivate,
+    PlayerPreThink,
+    PlayerPostThink,
+    StartFrame,
+    ParmsNewLevel,
+    ParmsChangeLevel,
+    GetGameDescription,
+    PlayerCustomization,
+    SpectatorConnect,
+    SpectatorDisconnect,
+    SpectatorThink,
+    Sys_Error,
+    PM_Move,
+    PM_Init,
+    PM_FindTextureType,
+    SetupVisibility,
+    UpdateClientData,
+    AddToFullPack,
+    CreateBaseline,
+    RegisterEncoders,
+    GetWeaponData,
+    CmdStart,
+    CmdEnd,
+    ConnectionlessPacket,
+    GetHullBounds,
+    CreateInstancedBaselines,
+    InconsistentFile,
+    AllowLagCompensation,
+    OnFreeEntPrivateData,
+    GameShutdown,
+    ShouldCollide,
+    CvarValue,
+    CvarValue2,
+
+    ClientFirst = 100,
+    Initialize = ClientFirst,
+    HUD_Init,
+    HUD_VidInit,
+    HUD_Redraw,
+    HUD_UpdateClientData,
+    HUD_Reset,
+    HUD_PlayerMove,
+    HUD_PlayerMoveInit,
+    HUD_PlayerMoveTexture,
+    IN_ActivateMouse,
+    IN_DeactivateMouse,
+    IN_MouseEvent,
+    IN_ClearStates,
+    IN_Accumulate,
+    CL_CreateMove,
+    CL_IsThirdPerson,
+    CL_GetCameraOffsets,
+    KB_Find,
+    CAM_Think,
+    V_CalcRefdef,
+    HUD_AddEntity,
+    HUD_CreateEntities,
+    HUD_DrawNormalTriangles,
+    HUD_DrawTransparentTriangles,
+    HUD_StudioEvent,
+    HUD_PostRunCmd,
+    HUD_Shutdown,
+    HUD_TxferLocalOverrides,
+    HUD_ProcessPlayerState,
+    HUD_TxferPredictionData,
+    Demo_ReadBuffer,
+    HUD_ConnectionlessPacket,
+    HUD_GetHullBounds,
+    HUD_Frame,
+    HUD_Key_Event,
+    HUD_TempEntUpdate,
+    HUD_GetUserEntity,
+    HUD_VoiceStatus,
+    HUD_DirectorMessage,
+    HUD_GetStudioModelInterface,
+    HUD_ChatInputPosition,
+    HUD_GetPlayerTeam,
+    ClientFactory,
+
+    Count,
+}
+
+/// <summary>
+/// Tag in front of each argument of a call record.
+/// </summary>
+public enum TraceArg : byte
+{
+    /// <summary>Null pointer.</summary>
+    Null,
+
+    /// <summary>4 bytes.</summary>
+    Int32,
+
+    /// <summary>4 bytes.</summary>
+    Single,
+
+    /// <summary>8 bytes.</summary>
+    Double,
+
+    /// <summary>Edict index (-1 for null), then a delta of free flag, serial number and entvars_t against the last state recorded for that index.</summary>
+    Edict,
+
+    /// <summary>
+    /// <see cref="TraceStruct"/> byte and a 2-byte count, then a delta of the encoded structs (see
+    /// <see cref="TraceLayout"/>) against the last value recorded in the same call and argument position.
+    /// </summary>
+    Struct,
+
+    /// <summary>String token (see <see cref="TraceRecordType.String"/>).</summary>
+    Text,
+
+    /// <summary>Length, then the bytes: in/out buffers, short float arrays.</summary>
+    Bytes,
+
+    /// <summary>Number of command arguments, then a token per argument (Cmd_Argv at the time of the call).</summary>
+    Command,
+
+    /// <summary>
+    /// Or'ed into the tag of an argument the call may write through (edicts, out structs and buffers): its state
+    /// after the call goes into the record's digest.
+    /// </summary>
+    Output = 0x80,
+}
+
+public enum TraceRecordType : byte
+{
+    /// <summary>One engine→mod call.</summary>
+    Call = 1,
+
+    /// <summary>A string token's text: token, then UTF-8 bytes. Precedes the first record that uses the token.</summary>
+    String = 2,
+}
+
+/// <summary>
+/// Start of a trace file. All values little-endian.
+/// </summary>
+[StructLayout(LayoutKind.Sequential, Pack = 4)]
+public struct TraceFileHeader
+{
+    public const uint MagicValue = 0x52545347; // "GSTR"
+    public const int CurrentVersion = 1;
+
+    public uint Magic;
+    public int Version;
+
+    /// <summary>Pointer size of the recording process; informational, the encoding does not depend on it.</summary>
+    public int PointerSize;
+
+    /// <summary>globalvars_t.maxEntities at the time recording started (0 when no server was running).</summary>
+    public int MaxEntities;
+
+    /// <summary>Stopwatch ticks per second of the recording machine.</summary>
+    public long TimestampFrequency;
+
+    /// <summary>UTC time recording started, in DateTime ticks.</summary>
+    public long StartedUtcTicks;
+
+    public long Reserved0;
+    public long Reserved1;
+}
+
+/// <summary>
+/// Header of each record. Records follow one another without padding; the payload is <see cref="Length"/> bytes.
+///
+/// A call payload is its arguments (tag + data each, in parameter order), then the return value as a tag and
+/// 4 bytes (<see cref="TraceArg.Int32"/>, <see cref="TraceArg.Text"/> or <see cref="TraceArg.Null"/>), then an
+/// 8-byte digest of everything the call could write: the edicts and structs passed in and the return value. Nested calls (an engine callback made while the mod is inside
+/// another) are written before the call that contains them and carry <see cref="Depth"/> &gt; 0.
+/// </summary>
+[StructLayout(LayoutKind.Sequential, Pack = 4)]
+public struct TraceRecordHeader
+{
+    public TraceRecordType Type;
+    public byte Depth;
+    public TraceCall Call;
+    public int Length;
+
+    /// <summary>Stopwatch ticks from the start of recording to the start of the call.</summary>
+    public long Start;
+
+    /// <summary>Stopwatch ticks the call took in the recording process.</summary>
+    public long Elapsed;
+}
+
+public static class TraceCalls
+{
+    public static bool IsClient(TraceCall call) => call >= TraceCall.ClientFirst;
+
+    /// <summary>
+    /// Whether replay can feed the call to the exports against the mock engine. The rest are recorded for their
+    /// timing only: save/restore (pointers into engine save buffers), rendering (needs a GL context and real
+    /// cl_entity_t models), and the calls that hand over engine interfaces.
+    /// </summary>
+    public static bool IsReplayable(TraceCall call) => call switch
+    {
+        TraceCall.Save or TraceCall.Restore or TraceCall.SaveWriteFields or TraceCall.SaveReadFields
+            or TraceCall.SaveGlobalState or TraceCall.RestoreGlobalState or TraceCall.PlayerCustomization => false,
+        TraceCall.Initialize or TraceCall.HUD_Init or TraceCall.HUD_VidInit or TraceCall.HUD_Redraw
+            or TraceCall.V_CalcRefdef or TraceCall.HUD_AddEntity or TraceCall.HUD_CreateEntities
+            or TraceCall.HUD_DrawNormalTriangles or TraceCall.HUD_DrawTransparentTriangles or TraceCall.HUD_StudioEvent
+            or TraceCall.HUD_TempEntUpdate or TraceCall.HUD_GetStudioModelInterface or TraceCall.ClientFactory => false,
+        _ => call is > TraceCall.None and < TraceCall.Count,
+    };
+}
@@ -0,0 +1,460 @@
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using NativeInterop;
+
+namespace GoldsrcFramework.Replay;
+
+/// <summary>
+/// Engine structures a trace stores by value.
+/// </summary>
+public enum TraceStruct : byte
+{
+    None,
+    EntVars,
+    UserCmd,
+    PlayerMove,
+    MoveVars,
+    EntityState,
+    ClientData,
+    WeaponData,
+    LocalState,
+    HudClientData,
+    KeyValueData,
+    Globals,
+    NetAddress,
+    RefParams,
+    ClientEntity,
+    StudioEvent,
+}
+
+/// <summary>
+/// Maps what a canonical encoding cannot store as-is: edict pointers become indices and strings become tokens.
+/// </summary>
+internal unsafe interface ITraceEncodeMap
+{
+    /// <summary>
+    /// Edict index + 1, or 0 for null and pointers outside the edict list.
+    /// </summary>
+    int EncodeEdict(edict_t* edict);
+
+    /// <summary>
+    /// Token for a <see cref="string_t"/> (an offset from the string base); 0 for the empty offset.
+    /// </summary>
+    uint EncodeString(uint offset);
+
+    /// <summary>
+    /// Token for a null-terminated string; 0 for null.
+    /// </summary>
+    uint EncodeText(NChar* text);
+}
+
+/// <summary>
+/// Inverse of <see cref="ITraceEncodeMap"/> on the replaying side.
+/// </summary>
+internal unsafe interface ITraceDecodeMap
+{
+    edict_t* DecodeEdict(int index);
+
+    uint DecodeString(uint token);
+
+    NChar* DecodeText(uint token);
+}
+
+/// <summary>
+/// Canonical, pointer-size independent encoding of one engine struct, built once per type from its fields.
+///
+/// Plain data is copied as-is; edict pointers are stored as 4-byte indices and strings as 4-byte tokens; other
+/// pointers (models, function tables, engine buffers) are left out, and decoding leaves whatever the destination
+/// already holds there. Arrays that come with a count field (the physent lists of playermove_t) only store the
+/// used part. A trace written by the 32-bit engine therefore replays in a 64-bit process.
+/// </summary>
+internal sealed unsafe class TraceLayout
+{
+    private enum OpKind : byte
+    {
+        Copy,
+        Edict,
+        String,
+        Text,
+        Array,
+    }
+
+    private readonly struct Op(OpKind kind, int offset, int size, int count = 0, int countOffset = -1, TraceLayout? element = null)
+    {
+        public readonly OpKind Kind = kind;
+        public readonly int Offset = offset;
+        public readonly int Size = size;
+        public readonly int Count = count;
+        public readonly int CountOffset = countOffset;
+        public readonly TraceLayout? Element = element;
+    }
+
+    // Arrays whose used length is given by an earlier field of the same struct.
+    private static readonly Dictionary<string, string> s_countFields = new()
+    {
+        ["physents"] = "numphysent",
+        ["moveents"] = "nummoveent",
+        ["visents"] = "numvisent",
+        ["touchindex"] = "numtouch",
+    };
+
+    // Pointers that look like strings but are not.
+    private static readonly HashSet<string> s_opaqueFields = new() { "pStringBase" };
+
+    private static readonly TraceLayout?[] s_layouts = new TraceLayout?[(int)TraceStruct.StudioEvent + 1];
+    private static readonly Dictionary<Type, TraceLayout> s_byType = new();
+
+    private readonly Op[] _ops;
+
+    private TraceLayout(Type type, Op[] ops)
+    {
+        Type = type;
+        _ops = ops;
+        NativeSize = SizeOf(type);
+        MaxEncodedSize = 0;
+        foreach (var op in ops)
+        {
+            MaxEncodedSize += op.Kind switch
+            {
+                OpKind.Copy => op.Size,
+                OpKind.Array => 4 + op.Count * op.Element!.MaxEncodedSize,
+                _ => 4,
+            };
+        }
+    }
+
+    public Type Type { get; }
+
+    public int NativeSize { get; }
+
+    public int MaxEncodedSize { get; }
+
+    /// <summary>
+    /// True when the struct is plain data, encoded as its own bytes.
+    /// </summary>
+    public bool IsPlain => _ops.Length == 1 && _ops[0].Kind == OpKind.Copy && _ops[0].Size == NativeSize;
+
+    public static TraceLayout For(TraceStruct type)
+    {
+        var layout = s_layouts[(int)type];
+        if (layout != null)
+            return layout;
+
+        lock (s_byType)
+        {
+            layout = Build(TypeOf(type));
+            s_layouts[(int)type] = layout;
+            return layout;
+        }
+    }
+
+    public static Type TypeOf(TraceStruct type) => type switch
+    {
+        TraceStruct.EntVars => typeof(entvars_t),
+        TraceStruct.UserCmd => typeof(usercmd_t),
+        TraceStruct.PlayerMove => typeof(playermove_t),
+        TraceStruct.MoveVars => typeof(movevars_t),
+        TraceStruct.EntityState => typeof(entity_state_t),
+        TraceStruct.ClientData => typeof(clientdata_t),
+        TraceStruct.WeaponData => typeof(weapon_data_t),
+        TraceStruct.LocalState => typeof(local_state_t),
+        TraceStruct.HudClientData => typeof(client_data_t),
+        TraceStruct.KeyValueData => typeof(KeyValueData),
+        TraceStruct.Globals => typeof(globalvars_t),
+        TraceStruct.NetAddress => typeof(netadr_t),
+        TraceStruct.RefParams => typeof(ref_params_t),
+        TraceStruct.ClientEntity => typeof(cl_entity_t),
+        TraceStruct.StudioEvent => typeof(mstudioevent_t),
+        _ => throw new ArgumentOutOfRangeException(nameof(type)),
+    };
+
+    /// <summary>
+    /// Encode <paramref name="native"/> into <paramref name="dest"/> (at least <see cref="MaxEncodedSize"/> bytes).
+    /// </summary>
+    public int Encode<TMap>(byte* native, byte* dest, ref TMap map) where TMap : struct, ITraceEncodeMap
+    {
+        byte* d = dest;
+        foreach (ref readonly var op in _ops.AsSpan())
+        {
+            byte* field = native + op.Offset;
+            switch (op.Kind)
+            {
+                case OpKind.Copy:
+                    Buffer.MemoryCopy(field, d, op.Size, op.Size);
+                    d += op.Size;
+                    break;
+                case OpKind.Edict:
+                    Unsafe.WriteUnaligned(d, map.EncodeEdict(*(edict_t**)field));
+                    d += 4;
+                    break;
+                case OpKind.String:
+                    Unsafe.WriteUnaligned(d, map.EncodeString(*(uint*)field));
+                    d += 4;
+                    break;
+                case OpKind.Text:
+                    Unsafe.WriteUnaligned(d, map.EncodeText(*(NChar**)field));
+                    d += 4;
+                    break;
+                case OpKind.Array:
+                {
+                    int count = ArrayCount(native, in op);
+                    Unsafe.WriteUnaligned(d, count);
+                    d += 4;
+                    var element = op.Element!;
+                    if (element.IsPlain)
+                    {
+                        long bytes = (long)count * element.NativeSize;
+                        Buffer.MemoryCopy(field, d, bytes, bytes);
+                        d += bytes;
+                    }
+                    else
+                    {
+                        for (int i = 0; i < count; i++)
+                            d += element.Encode(field + i * op.Size, d, ref map);
+                    }
+                    break;
+                }
+            }
+        }
+        return (int)(d - dest);
+    }
+
+    /// <summary>
+    /// Decode into <paramref name="native"/>; fields the encoding leaves out keep their current value.
+    /// Returns the bytes consumed.
+    /// </summary>
+    public int Decode<TMap>(byte* src, byte* native, ref TMap map) where TMap : struct, ITraceDecodeMap
+    {
+        byte* s = src;
+        foreach (ref readonly var op in _ops.AsSpan())
+        {
+            byte* field = native + op.Offset;
+            switch (op.Kind)
+            {
+                case OpKind.Copy:
+                    Buffer.MemoryCopy(s, field, op.Size, op.Size);
+                    s += op.Size;
+                    break;
+                case OpKind.Edict:
+                    *(edict_t**)field = map.DecodeEdict(Unsafe.ReadUnaligned<int>(s));
+                    s += 4;
+                    break;
+                case OpKind.String:
+                    *(uint*)field = map.DecodeString(Unsafe.ReadUnaligned<uint>(s));
+                    s += 4;
+                    break;
+                case OpKind.Text:
+                    *(NChar**)field = map.DecodeText(Unsafe.ReadUnaligned<uint>(s));
+                    s += 4;
+                    break;
+                case OpKind.Array:
+                {
+                    int count = Math.Clamp(Unsafe.ReadUnaligned<int>(s), 0, op.Count);
+                    s += 4;
+                    var element = op.Element!;
+                    if (element.IsPlain)
+                    {
+                        long bytes = (long)count * element.NativeSize;
+                        Buffer.MemoryCopy(s, field, bytes, bytes);
+                        s += bytes;
+                    }
+                    else
+                    {
+                        for (int i = 0; i < count; i++)
+                            s += element.Decode(s, field + i * op.Size, ref map);
+                    }
+                    break;
+                }
+            }
+        }
+        return (int)(s - src);
+    }
+
+    private static int ArrayCount(byte* native, in Op op) =>
+        op.CountOffset < 0 ? op.Count : Math.Clamp(*(int*)(native + op.CountOffset), 0, op.Count);
+
+    private static TraceLayout Build(Type type)
+    {
+        if (s_byType.TryGetValue(type, out var cached))
+            return cached;
+
+        var ops = new List<Op>();
+        var fields = type.GetFields(BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic);
+        var offsets = new Dictionary<string, int>();
+        foreach (var field in fields)
+            offsets[field.Name] = (int)Marshal.OffsetOf(type, field.Name);
+
+        foreach (var field in fields.OrderBy(f => offsets[f.Name]))
+        {
+            int offset = offsets[field.Name];
+            var ft = field.FieldType;
+
+            if (ft.IsPointer)
+            {
+                var target = ft.GetElementType();
+                if (target == typeof(edict_t))
+                    ops.Add(new Op(OpKind.Edict, offset, IntPtr.Size));
+                else if (target == typeof(NChar) && !s_opaqueFields.Contains(field.Name))
+                    ops.Add(new Op(OpKind.Text, offset, IntPtr.Size));
+                continue;
+            }
+            if (ft.IsFunctionPointer || ft == typeof(nint) || ft == typeof(nuint))
+                continue;
+            if (ft == typeof(string_t))
+            {
+                ops.Add(new Op(OpKind.String, offset, sizeof(uint)));
+                continue;
+            }
+
+            int size = SizeOf(ft);
+            var inline = ft.GetCustomAttribute<InlineArrayAttribute>();
+            if (inline != null)
+            {
+                var elementType = ft.GetFields(BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic)[0].FieldType;
+                var element = Build(elementType);
+                int countOffset = s_countFields.TryGetValue(field.Name, out var countField) && offsets.TryGetValue(countField, out var co) ? co : -1;
+                if (element.IsPlain && countOffset < 0)
+                    AddCopy(ops, offset, size);
+                else
+                    ops.Add(new Op(OpKind.Array, offset, element.NativeSize, inline.Length, countOffset, element));
+                continue;
+            }
+
+            if (ft.IsValueType && !ft.IsPrimitive && !ft.IsEnum)
+            {
+                var nested = Build(ft);
+                if (!nested.IsPlain)
+                {
+                    foreach (var op in nested._ops)
+                        ops.Add(new Op(op.Kind, offset + op.Offset, op.Size, op.Count, op.CountOffset < 0 ? -1 : offset + op.CountOffset, op.Element));
+                    continue;
+                }
+            }
+            AddCopy(ops, offset, size);
+        }
+
+        var layout = new TraceLayout(type, ops.ToArray());
+        s_byType[type] = layout;
+        return layout;
+    }
+
+    // Only back-to-back copies merge: a gap may be a skipped pointer, whose size depends on the process.
+    private static void AddCopy(List<Op> ops, int offset, int size)
+    {
+        if (ops.Count > 0 && ops[^1].Kind == OpKind.Copy && ops[^1].Offset + ops[^1].Size == offset)
+            ops[^1] = new Op(OpKind.Copy, ops[^1].Offset, ops[^1].Size + size);
+        else
+            ops.Add(new Op(OpKind.Copy, offset, size));
+    }
+
+    private static int SizeOf(Type type) =>
+        (int)typeof(Unsafe).GetMethod(nameof(Unsafe.SizeOf))!.MakeGenericMethod(type).Invoke(null, null)!;
+}
+
+/// <summary>
+/// Byte-level delta against the previous encoding of the same slot: alternating runs of unchanged and changed bytes,
+/// each length a LEB128 varint. An entity that moved is a few dozen bytes instead of its full entvars.
+/// </summary>
+internal static class TraceDelta
+{
+    // Shorter equal runs are folded into the literal; a new run costs at least two bytes.
+    private const int MinEqualRun = 4;
+
+    public static int MaxEncodedSize(int length) => 16 + length + (length / MinEqualRun + 1) * 6;
+
+    public static int Encode(ReadOnlySpan<byte> previous, ReadOnlySpan<byte> current, Span<byte> dest)
+    {
+        int w = WriteVarint(dest, 0, (uint)current.Length);
+        int i = 0;
+        while (i < current.Length)
+        {
+            int start = i;
+            while (i < current.Length && i < previous.Length && current[i] == previous[i])
+                i++;
+            int skip = i - start;
+            if (i == current.Length)
+            {
+                // Trailing equal run: an empty literal so the decoder knows where the delta ends.
+                w = WriteVarint(dest, w, (uint)skip);
+                w = WriteVarint(dest, w, 0);
+                break;
+            }
+
+            int literal = i;
+            int equal = 0;
+            while (i < current.Length)
+            {
+                if (i < previous.Length && current[i] == previous[i])
+                {
+                    if (++equal >= MinEqualRun)
+                        break;
+                }
+                else
+                {
+                    equal = 0;
+                }
+                i++;
+            }
+            if (equal >= MinEqualRun)
+                i -= equal - 1;
+            else
+                i -= equal;
+            int length = i - literal;
+
+            w = WriteVarint(dest, w, (uint)skip);
+            w = WriteVarint(dest, w, (uint)length);
+            current.Slice(literal, length).CopyTo(dest[w..]);
+            w += length;
+        }
+        return w;
+    }
+
+    /// <summary>
+    /// Apply a delta to <paramref name="buffer"/>, which holds the previous encoding and is resized to the new length.
+    /// Returns the bytes of <paramref name="delta"/> consumed.
+    /// </summary>
+    public static int Decode(ReadOnlySpan<byte> delta, ref byte[] buffer, out int length)
+    {
+        int r = ReadVarint(delta, 0, out uint total);
+        length = (int)total;
+        if (buffer.Length < length)
+            Array.Resize(ref buffer, Math.Max(length, buffer.Length * 2));
+
+        int i = 0;
+        while (i < length)
+        {
+            r = ReadVarint(delta, r, out uint skip);
+            r = ReadVarint(delta, r, out uint literal);
+            i += (int)skip;
+            delta.Slice(r, (int)literal).CopyTo(buffer.AsSpan(i));
+            r += (int)literal;
+            i += (int)literal;
+        }
+        return r;
+    }
+
+    private static int WriteVarint(Span<byte> dest, int at, uint value)
+    {
+        while (value >= 0x80)
+        {
+            dest[at++] = (byte)(value | 0x80);
+            value >>= 7;
+        }
+        dest[at++] = (byte)value;
+        return at;
+    }
+
+    private static int ReadVarint(ReadOnlySpan<byte> src, int at, out uint value)
+    {
+        value = 0;
+        for (int shift = 0; ; shift += 7)
+        {
+            byte b = src[at++];
+            value |= (uint)(b & 0x7F) << shift;
+            if (b < 0x80)
+                return at;
+        }
+    }
+}
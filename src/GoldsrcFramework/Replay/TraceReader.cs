@@ -0,0 +1,217 @@
+using System.Buffers.Binary;
+using System.IO.MemoryMappedFiles;
+
+namespace GoldsrcFramework.Replay;
+
+/// <summary>
+/// One record of a trace: its header and payload, pointing into the reader's view.
+/// </summary>
+public readonly unsafe ref struct TraceRecord
+{
+    public readonly ref readonly TraceRecordHeader Header;
+    public readonly ReadOnlySpan<byte> Payload;
+
+    internal TraceRecord(TraceRecordHeader* header)
+    {
+        Header = ref *header;
+        Payload = new ReadOnlySpan<byte>(header + 1, header->Length);
+    }
+
+    /// <summary>
+    /// Arguments of a call record: the payload without the return value and digest.
+    /// </summary>
+    public ReadOnlySpan<byte> Arguments => Payload[..^(5 + 8)];
+
+    public TraceArg ReturnKind => (TraceArg)Payload[^13];
+
+    public int ReturnValue => BinaryPrimitives.ReadInt32LittleEndian(Payload[^12..]);
+
+    public ulong Digest => BinaryPrimitives.ReadUInt64LittleEndian(Payload[^8..]);
+}
+
+/// <summary>
+/// Read-only, memory-mapped view over a trace written by <see cref="TraceCapture"/>. Records are walked in file
+/// order without copying; a record cut short by a crash ends the enumeration (see <see cref="Truncated"/>), any other
+/// malformed record throws <see cref="InvalidDataException"/>.
+/// </summary>
+public sealed unsafe class TraceReader : IDisposable
+{
+    private readonly MemoryMappedFile _mappedFile;
+    private readonly MemoryMappedViewAccessor _view;
+    private byte* _base;
+    private readonly long _length;
+
+    private TraceReader(MemoryMappedFile mappedFile, MemoryMappedViewAccessor view, long length)
+    {
+        _mappedFile = mappedFile;
+        _view = view;
+        _length = length;
+
+        byte* ptr = null;
+        view.SafeMemoryMappedViewHandle.AcquirePointer(ref ptr);
+        _base = ptr + view.PointerOffset;
+        Validate();
+    }
+
+    public static TraceReader Open(string path)
+    {
+        long length = new FileInfo(path).Length;
+        if (length < sizeof(TraceFileHeader))
+            throw new InvalidDataException("File is too small to be a trace");
+
+        var mappedFile = MemoryMappedFile.CreateFromFile(path, FileMode.Open, null, 0, MemoryMappedFileAccess.Read);
+        try
+        {
+            var view = mappedFile.CreateViewAccessor(0, length, MemoryMappedFileAccess.Read);
+            return new TraceReader(mappedFile, view, length);
+        }
+        catch
+        {
+            mappedFile.Dispose();
+            throw;
+        }
+    }
+
+    public long Length => _length;
+
+    public ref readonly TraceFileHeader Header => ref *(TraceFileHeader*)_base;
+
+    /// <summary>
+    /// Whether the last record runs past the end of the file.
+    /// </summary>
+    public bool Truncated
+    {
+        get
+        {
+            long offset = sizeof(TraceFileHeader);
+            while (offset + sizeof(TraceRecordHeader) <= _length)
+            {
+                var header = (TraceRecordHeader*)(_base + offset);
+                if (header->Length < 0)
+                    break;
+                offset += sizeof(TraceRecordHeader) + (long)header->Length;
+            }
+            return offset != _length;
+        }
+    }
+
+    public Enumerator GetEnumerator() => new(_base, _length);
+
+    private void Validate()
+    {
+        ref readonly var header = ref Header;
+        if (header.Magic != TraceFileHeader.MagicValue)
+            throw new InvalidDataException("Not a trace file");
+        if (header.Version != TraceFileHeader.CurrentVersion)
+            throw new InvalidDataException($"Wrong trace version {header.Version} (should be {TraceFileHeader.CurrentVersion})");
+        if (header.TimestampFrequency <= 0)
+            throw new InvalidDataException("Trace has no timestamp frequency");
+    }
+
+    public void Dispose()
+    {
+        if (_base == null)
+            return;
+
+        _base = null;
+        _view.SafeMemoryMappedViewHandle.ReleasePointer();
+        _view.Dispose();
+        _mappedFile.Dispose();
+    }
+
+    public ref struct Enumerator
+    {
+        private readonly byte* _base;
+        private readonly long _length;
+        private long _next;
+        private TraceRecordHeader* _current;
+
+        internal Enumerator(byte* @base, long length)
+        {
+            _base = @base;
+            _length = length;
+            _next = sizeof(TraceFileHeader);
+        }
+
+        public readonly TraceRecord Current => new(_current);
+
+        public bool MoveNext()
+        {
+            if (_next + sizeof(TraceRecordHeader) > _length)
+                return false;
+
+            var header = (TraceRecordHeader*)(_base + _next);
+            long end = _next + sizeof(TraceRecordHeader) + (long)header->Length;
+            if (end > _length)
+            {
+                _next = _length;
+                return false;
+            }
+
+            bool valid = header->Type switch
+            {
+                TraceRecordType.Call => header->Length >= 13,
+                TraceRecordType.String => header->Length >= 4,
+                _ => false,
+            };
+            if (!valid)
+                throw new InvalidDataException($"Bad {header->Type} record of {header->Length} bytes at offset {_next}");
+
+            _current = header;
+            _next = end;
+            return true;
+        }
+    }
+}
+
+/// <summary>
+/// Cursor over the arguments of a call record.
+/// </summary>
+internal ref struct TraceArgReader(ReadOnlySpan<byte> arguments)
+{
+    private readonly ReadOnlySpan<byte> _data = arguments;
+    private int _at;
+
+    public readonly bool End => _at >= _data.Length;
+
+    public TraceArg Tag() => (TraceArg)_data[_at++];
+
+    public byte Byte() => _data[_at++];
+
+    public ushort UInt16()
+    {
+        ushort value = BinaryPrimitives.ReadUInt16LittleEndian(_data[_at..]);
+        _at += 2;
+        return value;
+    }
+
+    public int Int32()
+    {
+        int value = BinaryPrimitives.ReadInt32LittleEndian(_data[_at..]);
+        _at += 4;
+        return value;
+    }
+
+    public double Double()
+    {
+        double value = BinaryPrimitives.ReadDoubleLittleEndian(_data[_at..]);
+        _at += 8;
+        return value;
+    }
+
+    public ReadOnlySpan<byte> Bytes(int length)
+    {
+        var span = _data.Slice(_at, length);
+        _at += length;
+        return span;
+    }
+
+    /// <summary>
+    /// A <see cref="TraceDelta"/> applied to <paramref name="buffer"/>; returns the new length.
+    /// </summary>
+    public int Delta(ref byte[] buffer)
+    {
+        _at += TraceDelta.Decode(_data[_at..], ref buffer, out int length);
+        return length;
+    }
+}
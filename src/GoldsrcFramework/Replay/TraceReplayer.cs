@@ -0,0 +1,583 @@
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+using NativeInterop;
+
+namespace GoldsrcFramework.Replay;
+
+/// <summary>
+/// Per entry point results of a replay. Times in microseconds per call; replayed times over every iteration.
+/// </summary>
+public readonly record struct TraceCallStats(
+    TraceCall Call,
+    long Recorded,
+    long Replayed,
+    long Divergent,
+    long BaselineDivergent,
+    long Failed,
+    double RecordedMeanMicroseconds,
+    double ReplayMeanMicroseconds,
+    double ReplayP50Microseconds,
+    double ReplayP99Microseconds);
+
+public sealed record TraceReplayReport(
+    long Calls,
+    long Replayed,
+    long Skipped,
+    long Divergent,
+    long BaselineDivergent,
+    long Failed,
+    int Iterations,
+    double RecordedMilliseconds,
+    double ReplayMilliseconds,
+    IReadOnlyList<TraceCallStats> PerCall,
+    ulong[] Digests,
+    string? FirstFailure);
+
+public sealed class TraceReplayOptions
+{
+    /// <summary>Times the whole trace is fed through the exports; timings cover every pass.</summary>
+    public int Iterations { get; set; } = 1;
+
+    /// <summary>Also run calls the engine made from inside another call (replayed in file order, as top-level calls).</summary>
+    public bool IncludeNested { get; set; }
+
+    /// <summary>Use stub tables for the legacy server DLL instead of loading it.</summary>
+    public bool StubLegacyServer { get; set; } = true;
+
+    public string GameDirectory { get; set; } = "valve";
+
+    /// <summary>Digests of an earlier replay of the same trace (<see cref="TraceReplayReport.Digests"/>) to compare with.</summary>
+    public ulong[]? Baseline { get; set; }
+}
+
+/// <summary>
+/// Feeds a trace recorded by <see cref="TraceCapture"/> back into the export implementations against
+/// <see cref="MockEngine"/>, timing each call and comparing the digest of what it wrote with the recording.
+///
+/// Edict and struct arguments are rebuilt from the trace before every call, so each call starts from the state the
+/// engine passed in-game; the digest then shows whether the mod did the same with it. Divergence against the
+/// recording also counts engine behaviour the mock does not reproduce, so regressions are best found against a
+/// <see cref="TraceReplayOptions.Baseline"/> from a known-good build.
+/// </summary>
+public sealed unsafe class TraceReplayer
+{
+    private const int MaxArgs = 16;
+    private const int MaxOutputs = 8;
+    private const int MaxCommandArgs = 80;
+
+    private readonly IServerExportFuncs? _server;
+    private readonly IClientExportFuncs? _client;
+    private readonly TraceReplayOptions _options;
+
+    private readonly Arg[] _args = new Arg[MaxArgs];
+    private readonly TraceCapture.Output[] _outputs = new TraceCapture.Output[MaxOutputs];
+    private int _outputCount;
+
+    // Mirrors of the recording's delta slots, and native memory the decoded arguments live in.
+    private readonly Dictionary<int, TraceSlot> _slots = new();
+    private readonly Dictionary<int, NativeBuffer> _natives = new();
+    private byte[] _nestedScratch = new byte[4096];
+    private byte[] _digestScratch = new byte[4096];
+    private readonly List<nint> _texts = new() { 0 };
+    private readonly List<uint> _stringOffsets = new() { 0 };
+    private NChar* _message;
+
+    public TraceReplayer(IServerExportFuncs? server, IClientExportFuncs? client, TraceReplayOptions? options = null)
+    {
+        _server = server;
+        _client = client;
+        _options = options ?? new TraceReplayOptions();
+    }
+
+    public TraceReplayReport Replay(TraceReader trace)
+    {
+        MockEngine.Initialize(Math.Max(trace.Header.MaxEntities, 2048), _options.GameDirectory, _options.StubLegacyServer);
+        if (_message == null)
+            _message = (NChar*)NativeMemory.AllocZeroed(256);
+
+        int kinds = (int)TraceCall.Count;
+        var samples = new List<long>[kinds];
+        var recorded = new long[kinds];
+        var recordedTicks = new long[kinds];
+        var divergent = new long[kinds];
+        var baselineDivergent = new long[kinds];
+        var failed = new long[kinds];
+        var digests = new List<ulong>();
+        long calls = 0, skipped = 0, replayTicks = 0;
+        string? firstFailure = null;
+        int iterations = Math.Max(_options.Iterations, 1);
+
+        for (int iteration = 0; iteration < iterations; iteration++)
+        {
+            Reset();
+            digests.Clear();
+            bool last = iteration == iterations - 1;
+
+            foreach (var record in trace)
+            {
+                ref readonly var header = ref record.Header;
+                if (header.Type == TraceRecordType.String)
+                {
+                    AddText(record.Payload);
+                    continue;
+                }
+
+                var call = header.Call;
+                if (call <= TraceCall.None || call >= TraceCall.Count)
+                    continue;
+                bool nested = header.Depth > 0;
+                bool run = (!nested || _options.IncludeNested) && TraceCalls.IsReplayable(call)
+                           && (TraceCalls.IsClient(call) ? _client != null : _server != null);
+                if (last)
+                {
+                    calls++;
+                    recorded[(int)call]++;
+                    recordedTicks[(int)call] += header.Elapsed;
+                }
+
+                // Nested records do not take part in the delta chain, so there is nothing to keep up to date.
+                if (nested && !run)
+                {
+                    skipped += last ? 1 : 0;
+                    continue;
+                }
+
+                try
+                {
+                    DecodeArguments(call, record.Arguments, nested);
+                }
+                catch (Exception ex) when (ex is IndexOutOfRangeException or ArgumentException)
+                {
+                    throw new InvalidDataException($"Arguments of {call} run past the end of the record", ex);
+                }
+                if (!run)
+                {
+                    skipped += last ? 1 : 0;
+                    continue;
+                }
+
+                long returnValue;
+                long start = Stopwatch.GetTimestamp();
+                try
+                {
+                    returnValue = TraceCalls.IsClient(call) ? InvokeClient(call) : InvokeServer(call);
+                }
+                catch (Exception ex)
+                {
+                    failed[(int)call]++;
+                    firstFailure ??= $"{call}: {ex.GetType().Name}: {ex.Message}";
+                    continue;
+                }
+                long elapsed = Stopwatch.GetTimestamp() - start;
+                replayTicks += elapsed;
+                (samples[(int)call] ??= new List<long>()).Add(elapsed);
+
+                if (!last)
+                    continue;
+
+                var map = new DigestMap();
+                ulong digest = TraceCapture.Digest(_outputs.AsSpan(0, _outputCount), returnValue, ref map, ref _digestScratch);
+                if (digest != record.Digest)
+                    divergent[(int)call]++;
+                var baseline = _options.Baseline;
+                if (baseline != null && (digests.Count >= baseline.Length || baseline[digests.Count] != digest))
+                    baselineDivergent[(int)call]++;
+                digests.Add(digest);
+            }
+        }
+
+        double toMicroseconds = 1_000_000.0 / trace.Header.TimestampFrequency;
+        double replayToMicroseconds = 1_000_000.0 / Stopwatch.Frequency;
+        var perCall = new List<TraceCallStats>();
+        long replayed = 0, totalDivergent = 0, totalBaseline = 0, totalFailed = 0, totalRecordedTicks = 0;
+        for (int i = 0; i < kinds; i++)
+        {
+            if (recorded[i] == 0)
+                continue;
+
+            var times = samples[i];
+            double mean = 0, p50 = 0, p99 = 0;
+            if (times != null && times.Count > 0)
+            {
+                times.Sort();
+                mean = times.Average() * replayToMicroseconds;
+                p50 = times[times.Count / 2] * replayToMicroseconds;
+                p99 = times[Math.Min((int)(times.Count * 0.99), times.Count - 1)] * replayToMicroseconds;
+            }
+            long replayedOnce = (times?.Count ?? 0) / iterations;
+            perCall.Add(new TraceCallStats((TraceCall)i, recorded[i], replayedOnce, divergent[i], baselineDivergent[i], failed[i] / iterations,
+                recordedTicks[i] * toMicroseconds / recorded[i], mean, p50, p99));
+
+            replayed += replayedOnce;
+            totalDivergent += divergent[i];
+            totalBaseline += baselineDivergent[i];
+            totalFailed += failed[i] / iterations;
+            totalRecordedTicks += recordedTicks[i];
+        }
+
+        return new TraceReplayReport(calls, replayed, skipped, totalDivergent, totalBaseline, totalFailed, iterations,
+            totalRecordedTicks * toMicroseconds / 1000, replayTicks * replayToMicroseconds / 1000 / iterations,
+            perCall, digests.ToArray(), firstFailure);
+    }
+
+    private void Reset()
+    {
+        _slots.Clear();
+        _texts.RemoveRange(1, _texts.Count - 1);
+        _stringOffsets.RemoveRange(1, _stringOffsets.Count - 1);
+    }
+
+    private void AddText(ReadOnlySpan<byte> payload)
+    {
+        uint token = System.Buffers.Binary.BinaryPrimitives.ReadUInt32LittleEndian(payload);
+        while (_texts.Count <= token)
+        {
+            _texts.Add(0);
+            _stringOffsets.Add(0);
+        }
+        int offset = MockEngine.StringOffset(payload[4..]);
+        _stringOffsets[(int)token] = (uint)offset;
+        _texts[(int)token] = (nint)MockEngine.StringAt((uint)offset);
+    }
+
+    private NChar* TextOf(uint token) => token < (uint)_texts.Count ? (NChar*)_texts[(int)token] : null;
+
+    // ---- Arguments ----
+
+    private struct Arg
+    {
+        public TraceArg Kind;
+        public int Int;
+        public double Double;
+        public void* Pointer;
+    }
+
+    private struct NativeBuffer
+    {
+        public byte* Pointer;
+        public int Capacity;
+    }
+
+    private int DecodeArguments(TraceCall call, ReadOnlySpan<byte> arguments, bool nested)
+    {
+        var reader = new TraceArgReader(arguments);
+        Span<nint> argv = stackalloc nint[MaxCommandArgs];
+        int count = 0;
+        _outputCount = 0;
+
+        while (!reader.End)
+        {
+            var raw = reader.Tag();
+            var tag = raw & ~TraceArg.Output;
+            ref var arg = ref _args[Math.Min(count, MaxArgs - 1)];
+            arg = new Arg { Kind = tag };
+
+            switch (tag)
+            {
+                case TraceArg.Null:
+                    break;
+                case TraceArg.Int32:
+                case TraceArg.Single:
+                    arg.Int = reader.Int32();
+                    break;
+                case TraceArg.Double:
+                    arg.Double = reader.Double();
+                    break;
+                case TraceArg.Edict:
+                {
+                    int index = reader.Int32();
+                    if (index >= 0)
+                        arg.Pointer = DecodeEdict(ref reader, index, nested);
+                    break;
+                }
+                case TraceArg.Struct:
+                {
+                    var type = (TraceStruct)reader.Byte();
+                    int structs = reader.UInt16();
+                    arg.Pointer = DecodeStructs(ref reader, type, structs, TraceCapture.StructSlot(call, count), nested);
+                    arg.Int = (int)type | structs << 8;
+                    break;
+                }
+                case TraceArg.Text:
+                    arg.Pointer = TextOf((uint)reader.Int32());
+                    break;
+                case TraceArg.Bytes:
+                {
+                    int length = reader.Int32();
+                    arg.Pointer = CopyBytes(reader.Bytes(length), TraceCapture.StructSlot(call, count));
+                    arg.Int = length;
+                    break;
+                }
+                case TraceArg.Command:
+                {
+                    int argc = reader.Int32();
+                    for (int i = 0; i < argc; i++)
+                    {
+                        var text = (nint)TextOf((uint)reader.Int32());
+                        if (i < MaxCommandArgs)
+                            argv[i] = text;
+                    }
+                    MockEngine.SetCommand(argv[..Math.Min(argc, MaxCommandArgs)]);
+                    continue; // not an argument of the export
+                }
+                default:
+                    throw new InvalidDataException($"Bad argument tag {(byte)raw} in {call}");
+            }
+
+            if ((raw & TraceArg.Output) != 0 && arg.Pointer != null && _outputCount < MaxOutputs)
+                _outputs[_outputCount++] = new TraceCapture.Output(tag, arg.Pointer, tag == TraceArg.Edict ? 0 : arg.Int);
+            count++;
+        }
+        return count;
+    }
+
+    private ref byte[] SlotBuffer(int slot, bool nested, out int length)
+    {
+        length = 0;
+        if (nested)
+            return ref _nestedScratch;
+
+        ref var entry = ref CollectionsMarshal.GetValueRefOrAddDefault(_slots, slot, out _);
+        entry.Data ??= new byte[256];
+        return ref entry.Data;
+    }
+
+    private void SetSlotLength(int slot, bool nested, int length)
+    {
+        if (!nested)
+            CollectionsMarshal.GetValueRefOrNullRef(_slots, slot).Length = length;
+    }
+
+    private edict_t* DecodeEdict(ref TraceArgReader reader, int index, bool nested)
+    {
+        int slot = TraceCapture.EdictSlot(index);
+        ref var buffer = ref SlotBuffer(slot, nested, out _);
+        int length = reader.Delta(ref buffer);
+        SetSlotLength(slot, nested, length);
+
+        var edict = MockEngine.EdictAt(index);
+        if (edict == null)
+            return null;
+
+        var map = new ReplayMap(this);
+        fixed (byte* s = buffer)
+        {
+            edict->free.Value = *(int*)s;
+            edict->serialnumber = *(int*)(s + 4);
+            TraceLayout.For(TraceStruct.EntVars).Decode(s + 8, (byte*)&edict->v, ref map);
+        }
+        return edict;
+    }
+
+    private void* DecodeStructs(ref TraceArgReader reader, TraceStruct type, int count, int slot, bool nested)
+    {
+        ref var buffer = ref SlotBuffer(slot, nested, out _);
+        int length = reader.Delta(ref buffer);
+        SetSlotLength(slot, nested, length);
+
+        var layout = TraceLayout.For(type);
+        byte* native = type switch
+        {
+            TraceStruct.Globals => (byte*)MockEngine.Globals,
+            TraceStruct.MoveVars => (byte*)MockEngine.MoveVars,
+            _ => NativeFor(slot, layout.NativeSize * count, type),
+        };
+        if (type is TraceStruct.Globals or TraceStruct.MoveVars)
+            count = 1;
+
+        var map = new ReplayMap(this);
+        fixed (byte* s = buffer)
+        {
+            int at = 0;
+            for (int i = 0; i < count && at < length; i++)
+                at += layout.Decode(s + at, native + i * layout.NativeSize, ref map);
+        }
+
+        if (type == TraceStruct.Globals)
+        {
+            var globals = MockEngine.Globals;
+            globals->maxEntities = Math.Min(globals->maxEntities, MockEngine.EdictCount);
+            globals->pSaveData = null;
+        }
+        return native;
+    }
+
+    private void* CopyBytes(ReadOnlySpan<byte> bytes, int slot)
+    {
+        // One spare zero byte: several of these buffers are C strings.
+        byte* native = NativeFor(slot, bytes.Length + 1, TraceStruct.None);
+        bytes.CopyTo(new Span<byte>(native, bytes.Length));
+        native[bytes.Length] = 0;
+        return native;
+    }
+
+    // Native memory for a slot, kept between calls so fields the trace leaves out keep their values.
+    private byte* NativeFor(int slot, int size, TraceStruct type)
+    {
+        ref var native = ref CollectionsMarshal.GetValueRefOrAddDefault(_natives, slot, out _);
+        if (native.Capacity < size)
+        {
+            var old = native;
+            native.Pointer = (byte*)NativeMemory.AllocZeroed((nuint)size);
+            if (old.Pointer != null)
+            {
+                Buffer.MemoryCopy(old.Pointer, native.Pointer, size, old.Capacity);
+                NativeMemory.Free(old.Pointer);
+            }
+            if (type == TraceStruct.PlayerMove)
+            {
+                int elementSize = sizeof(playermove_t);
+                for (int at = old.Capacity; at + elementSize <= size; at += elementSize)
+                    MockEngine.InitPlayerMove((playermove_t*)(native.Pointer + at));
+            }
+            native.Capacity = size;
+        }
+        return native.Pointer;
+    }
+
+    private edict_t* E(int i) => (edict_t*)_args[i].Pointer;
+
+    private int I(int i) => _args[i].Int;
+
+    private float F(int i) => BitConverter.Int32BitsToSingle(_args[i].Int);
+
+    private double D(int i) => _args[i].Double;
+
+    private void* P(int i) => _args[i].Pointer;
+
+    private NChar* T(int i) => (NChar*)_args[i].Pointer;
+
+    private static qboolean Q(int value) => new() { Value = value };
+
+    // ---- Dispatch: arguments in the order RecordingServerExports / RecordingClientExports wrote them ----
+
+    private long InvokeServer(TraceCall call)
+    {
+        var s = _server!;
+        switch (call)
+        {
+            case TraceCall.GameInit: s.GameInit(); break;
+            case TraceCall.Spawn: return s.Spawn(E(0));
+            case TraceCall.Think: s.Think(E(0)); break;
+            case TraceCall.Use: s.Use(E(0), E(1)); break;
+            case TraceCall.Touch: s.Touch(E(0), E(1)); break;
+            case TraceCall.Blocked: s.Blocked(E(0), E(1)); break;
+            case TraceCall.KeyValue: s.KeyValue(E(0), (KeyValueData*)P(1)); break;
+            case TraceCall.SetAbsBox: s.SetAbsBox(E(0)); break;
+            case TraceCall.ResetGlobalState: s.ResetGlobalState(); break;
+            case TraceCall.ClientConnect: return s.ClientConnect(E(0), T(1), T(2), (NChar*)P(3)).Value;
+            case TraceCall.ClientDisconnect: s.ClientDisconnect(E(0)); break;
+            case TraceCall.ClientKill: s.ClientKill(E(0)); break;
+            case TraceCall.ClientPutInServer: s.ClientPutInServer(E(0)); break;
+            case TraceCall.ClientCommand: s.ClientCommand(E(0)); break;
+            case TraceCall.ClientUserInfoChanged: s.ClientUserInfoChanged(E(0), T(1)); break;
+            case TraceCall.ServerActivate: s.ServerActivate(MockEngine.Edicts, I(0), I(1)); break;
+            case TraceCall.ServerDeactivate: s.ServerDeactivate(); break;
+            case TraceCall.PlayerPreThink: s.PlayerPreThink(E(0)); break;
+            case TraceCall.PlayerPostThink: s.PlayerPostThink(E(0)); break;
+            case TraceCall.StartFrame: s.StartFrame(); break;
+            case TraceCall.ParmsNewLevel: s.ParmsNewLevel(); break;
+            case TraceCall.ParmsChangeLevel: s.ParmsChangeLevel(); break;
+            case TraceCall.GetGameDescription: return TraceDigest.Text(s.GetGameDescription());
+            case TraceCall.SpectatorConnect: s.SpectatorConnect(E(0)); break;
+            case TraceCall.SpectatorDisconnect: s.SpectatorDisconnect(E(0)); break;
+            case TraceCall.SpectatorThink: s.SpectatorThink(E(0)); break;
+            case TraceCall.Sys_Error: s.Sys_Error(T(0)); break;
+            case TraceCall.PM_Move: s.PM_Move((playermove_t*)P(0), Q(I(2))); break;
+            case TraceCall.PM_Init: s.PM_Init((playermove_t*)P(0)); break;
+            case TraceCall.PM_FindTextureType: return (byte)s.PM_FindTextureType(T(0));
+            case TraceCall.SetupVisibility:
+            {
+                byte* pvs = null, pas = null;
+                s.SetupVisibility(E(0), E(1), &pvs, &pas);
+                break;
+            }
+            case TraceCall.UpdateClientData: s.UpdateClientData(E(0), I(1), (clientdata_t*)P(2)); break;
+            case TraceCall.AddToFullPack: return s.AddToFullPack((entity_state_t*)P(0), I(1), E(2), E(3), I(4), I(5), null);
+            case TraceCall.CreateBaseline: s.CreateBaseline(I(0), I(1), (entity_state_t*)P(2), E(3), I(4), (Vector3*)P(5), (Vector3*)P(6)); break;
+            case TraceCall.RegisterEncoders: s.RegisterEncoders(); break;
+            case TraceCall.GetWeaponData: return s.GetWeaponData(E(0), (weapon_data_t*)P(1));
+            case TraceCall.CmdStart: s.CmdStart(E(0), (usercmd_t*)P(1), (uint)I(2)); break;
+            case TraceCall.CmdEnd: s.CmdEnd(E(0)); break;
+            case TraceCall.ConnectionlessPacket: return s.ConnectionlessPacket((netadr_t*)P(0), T(1), (NChar*)P(2), (int*)P(3));
+            case TraceCall.GetHullBounds: return s.GetHullBounds(I(0), (float*)P(1), (float*)P(2));
+            case TraceCall.CreateInstancedBaselines: s.CreateInstancedBaselines(); break;
+            case TraceCall.InconsistentFile: return s.InconsistentFile(E(0), T(1), _message);
+            case TraceCall.AllowLagCompensation: return s.AllowLagCompensation();
+            case TraceCall.OnFreeEntPrivateData: s.OnFreeEntPrivateData(E(0)); break;
+            case TraceCall.GameShutdown: s.GameShutdown(); break;
+            case TraceCall.ShouldCollide: return s.ShouldCollide(E(0), E(1));
+            case TraceCall.CvarValue: s.CvarValue(E(0), T(1)); break;
+            case TraceCall.CvarValue2: s.CvarValue2(E(0), I(1), T(2), T(3)); break;
+            default: throw new NotSupportedException($"{call} is not replayable");
+        }
+        return 0;
+    }
+
+    private long InvokeClient(TraceCall call)
+    {
+        var c = _client!;
+        switch (call)
+        {
+            case TraceCall.HUD_UpdateClientData:
+                MockEngine.ClientTime = F(1);
+                return c.HUD_UpdateClientData((client_data_t*)P(0), F(1));
+            case TraceCall.HUD_Reset: c.HUD_Reset(); break;
+            case TraceCall.HUD_PlayerMove: c.HUD_PlayerMove((playermove_t*)P(0), Q(I(2))); break;
+            case TraceCall.HUD_PlayerMoveInit: c.HUD_PlayerMoveInit((playermove_t*)P(0)); break;
+            case TraceCall.HUD_PlayerMoveTexture: return (byte)c.HUD_PlayerMoveTexture(T(0));
+            case TraceCall.IN_ActivateMouse: c.IN_ActivateMouse(); break;
+            case TraceCall.IN_DeactivateMouse: c.IN_DeactivateMouse(); break;
+            case TraceCall.IN_MouseEvent: c.IN_MouseEvent(I(0)); break;
+            case TraceCall.IN_ClearStates: c.IN_ClearStates(); break;
+            case TraceCall.IN_Accumulate: c.IN_Accumulate(); break;
+            case TraceCall.CL_CreateMove: c.CL_CreateMove(F(0), (usercmd_t*)P(1), I(2)); break;
+            case TraceCall.CL_IsThirdPerson: return c.CL_IsThirdPerson();
+            case TraceCall.CL_GetCameraOffsets: c.CL_GetCameraOffsets((Vector3*)P(0)); break;
+            case TraceCall.KB_Find: c.KB_Find(T(0)); break;
+            case TraceCall.CAM_Think: c.CAM_Think(); break;
+            case TraceCall.HUD_PostRunCmd: c.HUD_PostRunCmd((local_state_t*)P(0), (local_state_t*)P(1), (usercmd_t*)P(2), I(3), D(4), (uint)I(5)); break;
+            case TraceCall.HUD_Shutdown: c.HUD_Shutdown(); break;
+            case TraceCall.HUD_TxferLocalOverrides: c.HUD_TxferLocalOverrides((entity_state_t*)P(0), (clientdata_t*)P(1)); break;
+            case TraceCall.HUD_ProcessPlayerState: c.HUD_ProcessPlayerState((entity_state_t*)P(0), (entity_state_t*)P(1)); break;
+            case TraceCall.HUD_TxferPredictionData:
+                c.HUD_TxferPredictionData((entity_state_t*)P(0), (entity_state_t*)P(1), (clientdata_t*)P(2), (clientdata_t*)P(3),
+                    (weapon_data_t*)P(4), (weapon_data_t*)P(5));
+                break;
+            case TraceCall.Demo_ReadBuffer: c.Demo_ReadBuffer(I(0), (byte*)P(1)); break;
+            case TraceCall.HUD_ConnectionlessPacket: return c.HUD_ConnectionlessPacket((netadr_t*)P(0), T(1), (NChar*)P(2), (int*)P(3));
+            case TraceCall.HUD_GetHullBounds: return c.HUD_GetHullBounds(I(0), (float*)P(1), (float*)P(2));
+            case TraceCall.HUD_Frame: c.HUD_Frame(D(0)); break;
+            case TraceCall.HUD_Key_Event: return c.HUD_Key_Event(I(0), I(1), T(2));
+            case TraceCall.HUD_GetUserEntity: c.HUD_GetUserEntity(I(0)); break;
+            case TraceCall.HUD_VoiceStatus: c.HUD_VoiceStatus(I(0), Q(I(1))); break;
+            case TraceCall.HUD_DirectorMessage: c.HUD_DirectorMessage(I(0), P(1)); break;
+            case TraceCall.HUD_ChatInputPosition: c.HUD_ChatInputPosition((int*)P(0), (int*)P(1)); break;
+            case TraceCall.HUD_GetPlayerTeam: return c.HUD_GetPlayerTeam(I(0));
+            default: throw new NotSupportedException($"{call} is not replayable");
+        }
+        return 0;
+    }
+
+    // ---- Maps between trace indices / tokens and the mock engine ----
+
+    private readonly struct ReplayMap(TraceReplayer owner) : ITraceDecodeMap
+    {
+        public edict_t* DecodeEdict(int index) => index == 0 ? null : MockEngine.EdictAt(index - 1);
+
+        public uint DecodeString(uint token) => token < (uint)owner._stringOffsets.Count ? owner._stringOffsets[(int)token] : 0;
+
+        public NChar* DecodeText(uint token) => owner.TextOf(token);
+    }
+
+    private struct DigestMap : ITraceEncodeMap
+    {
+        public int EncodeEdict(edict_t* edict) => MockEngine.IndexOf(edict) + 1;
+
+        public uint EncodeString(uint offset) => offset == 0 ? 0 : TraceDigest.Text(MockEngine.StringAt(offset));
+
+        public uint EncodeText(NChar* text) => TraceDigest.Text(text);
+    }
+}
@@ -10,8 +10,13 @@ using System.Text.Json;
 using System.Threading.Tasks;
 using GoldsrcFramework.Engine.Native;
 using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Configuration;
 using GoldsrcFramework.DependencyInjection;
+using GoldsrcFramework.Diagnostics;
+using GoldsrcFramework.Jobs;
+using GoldsrcFramework.Replay;
 using Microsoft.Extensions.Logging;
+using Microsoft.Extensions.Options;
 using NativeInterop;
 
 namespace GoldsrcFramework
@@ -42,6 +47,19 @@ namespace GoldsrcFramework
 
                 var logger = ServiceContainer.GetServiceOrNull<ILogger<object>>();
                 logger?.LogInformation("ServerMain initialized with {ServerType}", s_server.GetType().Name);
+
+                // 配置了 CaptureTracePath 时包一层录制，关闭时没有任何开销
+                var settings = ServiceContainer.GetServiceOrNull<IOptions<FrameworkSettings>>()?.Value;
+                if (TraceCapture.StartIfConfigured(settings?.CaptureTracePath))
+                    s_server = new RecordingServerExports(s_server);
+
+                // 配置了 FrameBudgetMilliseconds 时包一层帧耗时分析，记录超出预算的帧及其原因
+                var profiler = FrameProfiler.CreateIfConfigured("server", settings);
+                if (profiler != null)
+                    s_server = new ProfilingServerExports(s_server, profiler);
+
+                // 帧同步的任务调度器，工作线程数等由 Game 配置节决定；工作线程在第一次调度任务时才启动
+                JobScheduler.EnsureShared(ServiceContainer.GetServiceOrNull<IOptions<GameSettings>>()?.Value);
             }
             catch (Exception ex)
             {
@@ -279,7 +297,18 @@ namespace GoldsrcFramework
         static void PlayerPostThink(edict_t* pEntity) => s_server.PlayerPostThink(pEntity);
 
         [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
-        static void StartFrame() => s_server.StartFrame();
+        static void StartFrame()
+        {
+            try
+            {
+                s_server.StartFrame();
+            }
+            finally
+            {
+                // 帧栅栏：本帧调度的任务必须在回调返回引擎前完成
+                JobScheduler.Shared?.CompleteFrame();
+            }
+        }
 
         [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
         static void ParmsNewLevel() => s_server.ParmsNewLevel();
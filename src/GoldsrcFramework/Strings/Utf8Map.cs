@@ -0,0 +1,168 @@
+using System.Numerics;
+using System.Text;
+
+namespace GoldsrcFramework.Strings;
+
+/// <summary>
+/// Hash table keyed by UTF-8 bytes, looked up with a <see cref="Utf8View"/> straight from engine memory.
+///
+/// Keys are copied once into a single byte buffer when added; lookups hash the view with
+/// <see cref="Utf8View.GetStableHashCode(ReadOnlySpan{byte}, bool)"/>, probe an open-addressing index and compare
+/// bytes, so they never allocate. Meant for tables built at startup / registration and read every frame.
+/// Not thread-safe for writes.
+/// </summary>
+public sealed class Utf8Map<TValue>
+{
+    private struct Entry
+    {
+        public int Hash;
+        public int KeyOffset;
+        public int KeyLength;
+        public TValue Value;
+    }
+
+    private Entry[] _entries;
+    private int[] _slots;   // entry index + 1, 0 = empty
+    private byte[] _keys = new byte[256];
+    private int _keyLength;
+    private int _count;
+
+    public Utf8Map(bool ignoreCase = false, int capacity = 16)
+    {
+        IgnoreCase = ignoreCase;
+        _entries = new Entry[Math.Max(capacity, 4)];
+        _slots = new int[(int)BitOperations.RoundUpToPowerOf2((uint)_entries.Length * 2)];
+    }
+
+    /// <summary>
+    /// Keys differing only in ASCII case are the same key.
+    /// </summary>
+    public bool IgnoreCase { get; }
+
+    public int Count => _count;
+
+    public TValue this[Utf8View key] =>
+        TryGetValue(key, out var value) ? value : throw new KeyNotFoundException($"Key '{key.ToString()}' not found.");
+
+    /// <summary>
+    /// Add or replace the value for <paramref name="key"/>.
+    /// </summary>
+    public void Set(string key, TValue value) => Set(new Utf8View(Encoding.UTF8.GetBytes(key)), value);
+
+    /// <inheritdoc cref="Set(string, TValue)"/>
+    public void Set(Utf8View key, TValue value)
+    {
+        int index = Find(key, out int hash);
+        if (index >= 0)
+        {
+            _entries[index].Value = value;
+            return;
+        }
+
+        Insert(key, hash, value);
+    }
+
+    /// <summary>
+    /// Add <paramref name="key"/> unless it is already present.
+    /// </summary>
+    public bool TryAdd(string key, TValue value) => TryAdd(new Utf8View(Encoding.UTF8.GetBytes(key)), value);
+
+    /// <inheritdoc cref="TryAdd(string, TValue)"/>
+    public bool TryAdd(Utf8View key, TValue value)
+    {
+        if (Find(key, out int hash) >= 0)
+            return false;
+
+        Insert(key, hash, value);
+        return true;
+    }
+
+    public bool TryGetValue(Utf8View key, out TValue value)
+    {
+        int index = Find(key, out _);
+        if (index < 0)
+        {
+            value = default!;
+            return false;
+        }
+
+        value = _entries[index].Value;
+        return true;
+    }
+
+    public bool ContainsKey(Utf8View key) => Find(key, out _) >= 0;
+
+    /// <summary>
+    /// Keys in insertion order; allocates, for diagnostics.
+    /// </summary>
+    public IEnumerable<string> Keys
+    {
+        get
+        {
+            for (int i = 0; i < _count; i++)
+                yield return Encoding.UTF8.GetString(_keys, _entries[i].KeyOffset, _entries[i].KeyLength);
+        }
+    }
+
+    public void Clear()
+    {
+        Array.Clear(_entries, 0, _count);
+        Array.Clear(_slots);
+        _count = 0;
+        _keyLength = 0;
+    }
+
+    private int Find(Utf8View key, out int hash)
+    {
+        hash = Utf8View.GetStableHashCode(key.Span, IgnoreCase);
+        int mask = _slots.Length - 1;
+        for (int slot = hash & mask; ; slot = (slot + 1) & mask)
+        {
+            int index = _slots[slot] - 1;
+            if (index < 0)
+                return -1;
+
+            ref var entry = ref _entries[index];
+            if (entry.Hash != hash || entry.KeyLength != key.Length)
+                continue;
+
+            var stored = new Utf8View(_keys.AsSpan(entry.KeyOffset, entry.KeyLength));
+            if (IgnoreCase ? stored.EqualsIgnoreCase(key) : stored.Equals(key))
+                return index;
+        }
+    }
+
+    private void Insert(Utf8View key, int hash, TValue value)
+    {
+        if (_count == _entries.Length)
+        {
+            Array.Resize(ref _entries, _entries.Length * 2);
+            Rehash(_slots.Length * 2);
+        }
+
+        if (_keyLength + key.Length > _keys.Length)
+            Array.Resize(ref _keys, Math.Max(_keys.Length * 2, _keyLength + key.Length));
+        key.Span.CopyTo(_keys.AsSpan(_keyLength));
+
+        _entries[_count] = new Entry { Hash = hash, KeyOffset = _keyLength, KeyLength = key.Length, Value = value };
+        _keyLength += key.Length;
+        Place(_count, hash);
+        _count++;
+    }
+
+    private void Rehash(int size)
+    {
+        _slots = new int[size];
+        for (int i = 0; i < _count; i++)
+            Place(i, _entries[i].Hash);
+    }
+
+    private void Place(int index, int hash)
+    {
+        int mask = _slots.Length - 1;
+        int slot = hash & mask;
+        while (_slots[slot] != 0)
+            slot = (slot + 1) & mask;
+        _slots[slot] = index + 1;
+    }
+}
@@ -0,0 +1,256 @@
+using System.Buffers;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Text;
+using NativeInterop;
+
+namespace GoldsrcFramework.Strings;
+
+/// <summary>
+/// Counters reported by <see cref="Utf8StringPool"/>.
+/// </summary>
+public readonly record struct Utf8StringPoolStats(
+    int Strings,
+    long BytesUsed,
+    long BytesReserved,
+    int Blocks,
+    long Lookups,
+    long Hits,
+    int Resets);
+
+/// <summary>
+/// Interned, null-terminated UTF-8 strings in large native arenas, for strings the engine keeps a pointer to
+/// (precache names, pev->model / classname via MAKE_STRING, NameForFunction results...).
+///
+/// Equal strings map to the same <see cref="NChar"/>* for the lifetime of the pool. Memory is never freed per string;
+/// <see cref="Reset"/> drops everything at once. Use <see cref="Level"/> for per-map strings (reset when the next map starts)
+/// and <see cref="Shared"/> for strings that must survive level changes. Thread-safe.
+/// </summary>
+public sealed unsafe class Utf8StringPool : IDisposable
+{
+    private struct Entry
+    {
+        public int Hash;
+        public int Length;
+        public byte* Text;
+    }
+
+    private const int StackTranscodeLimit = 512;
+
+    /// <summary>
+    /// Strings that live for the whole process.
+    /// </summary>
+    public static Utf8StringPool Shared { get; } = new();
+
+    /// <summary>
+    /// Strings that live until the current map ends. The engine reads them until the next map spawns, so the framework
+    /// resets this at the first entity callback of the next map, not at ServerDeactivate.
+    /// </summary>
+    public static Utf8StringPool Level { get; } = new();
+
+    private readonly object _sync = new();
+    private readonly int _blockSize;
+    private readonly List<nint> _blocks = new();
+    private readonly List<nint> _largeBlocks = new();
+
+    private byte* _cursor;
+    private byte* _blockEnd;
+    private Entry[] _entries;
+    private int _count;
+
+    private long _bytesUsed;
+    private long _bytesReserved;
+    private long _lookups;
+    private long _hits;
+    private int _resets;
+
+    /// <param name="blockSize">Arena block size in bytes. Strings larger than a quarter block get their own block.</param>
+    public Utf8StringPool(int blockSize = 64 * 1024)
+    {
+        _blockSize = Math.Max(blockSize, 256);
+        _entries = new Entry[256];
+    }
+
+    /// <summary>
+    /// Intern a UTF-16 string.
+    /// </summary>
+    public NChar* Intern(ReadOnlySpan<char> text)
+    {
+        int maxBytes = Encoding.UTF8.GetMaxByteCount(text.Length);
+        if (maxBytes <= StackTranscodeLimit)
+        {
+            Span<byte> buffer = stackalloc byte[StackTranscodeLimit];
+            int length = Encoding.UTF8.GetBytes(text, buffer);
+            return Intern((ReadOnlySpan<byte>)buffer.Slice(0, length));
+        }
+
+        byte[] rented = ArrayPool<byte>.Shared.Rent(maxBytes);
+        try
+        {
+            int length = Encoding.UTF8.GetBytes(text, rented);
+            return Intern((ReadOnlySpan<byte>)rented.AsSpan(0, length));
+        }
+        finally
+        {
+            ArrayPool<byte>.Shared.Return(rented);
+        }
+    }
+
+    /// <summary>
+    /// Intern UTF-8 text, e.g. a "..."u8 literal. A trailing null terminator, if present, is ignored.
+    /// </summary>
+    public NChar* Intern(ReadOnlySpan<byte> utf8)
+    {
+        if (!utf8.IsEmpty && utf8[^1] == 0)
+            utf8 = utf8[..^1];
+
+        int hash = Hash(utf8);
+
+        lock (_sync)
+        {
+            _lookups++;
+
+            int mask = _entries.Length - 1;
+            int slot = hash & mask;
+            while (true)
+            {
+                ref var entry = ref _entries[slot];
+                if (entry.Text == null)
+                    break;
+
+                if (entry.Hash == hash && entry.Length == utf8.Length && new ReadOnlySpan<byte>(entry.Text, entry.Length).SequenceEqual(utf8))
+                {
+                    _hits++;
+                    return (NChar*)entry.Text;
+                }
+
+                slot = (slot + 1) & mask;
+            }
+
+            byte* text = Allocate(utf8.Length + 1);
+            utf8.CopyTo(new Span<byte>(text, utf8.Length));
+            text[utf8.Length] = 0;
+
+            _entries[slot] = new Entry { Hash = hash, Length = utf8.Length, Text = text };
+            _count++;
+            _bytesUsed += utf8.Length + 1;
+
+            // Keep the load factor under 1/2.
+            if (_count * 2 > _entries.Length)
+                Grow();
+
+            return (NChar*)text;
+        }
+    }
+
+    /// <summary>
+    /// Drop every string. Pointers handed out before are invalid afterwards; the first block is kept for reuse.
+    /// </summary>
+    public void Reset()
+    {
+        lock (_sync)
+        {
+            for (int i = 1; i < _blocks.Count; i++)
+                NativeMemory.Free((void*)_blocks[i]);
+            foreach (var block in _largeBlocks)
+                NativeMemory.Free((void*)block);
+            _largeBlocks.Clear();
+
+            if (_blocks.Count > 0)
+            {
+                var first = _blocks[0];
+                _blocks.Clear();
+                _blocks.Add(first);
+                _cursor = (byte*)first;
+                _blockEnd = _cursor + _blockSize;
+            }
+            _bytesReserved = _blocks.Count * (long)_blockSize;
+
+            Array.Clear(_entries);
+            _count = 0;
+            _bytesUsed = 0;
+            _resets++;
+        }
+    }
+
+    /// <summary>
+    /// Current counters.
+    /// </summary>
+    public Utf8StringPoolStats Stats
+    {
+        get
+        {
+            lock (_sync)
+                return new Utf8StringPoolStats(_count, _bytesUsed, _bytesReserved, _blocks.Count + _largeBlocks.Count, _lookups, _hits, _resets);
+        }
+    }
+
+    public void Dispose()
+    {
+        lock (_sync)
+        {
+            foreach (var block in _blocks)
+                NativeMemory.Free((void*)block);
+            foreach (var block in _largeBlocks)
+                NativeMemory.Free((void*)block);
+            _blocks.Clear();
+            _largeBlocks.Clear();
+            _bytesReserved = 0;
+            _cursor = _blockEnd = null;
+            Array.Clear(_entries);
+            _count = 0;
+        }
+    }
+
+    private byte* Allocate(int size)
+    {
+        if (_cursor + size <= _blockEnd)
+        {
+            byte* p = _cursor;
+            _cursor += size;
+            return p;
+        }
+
+        if (size > _blockSize / 4)
+        {
+            // Oversized: dedicated block, keep filling the current one.
+            byte* own = (byte*)NativeMemory.Alloc((nuint)size);
+            _largeBlocks.Add((nint)own);
+            _bytesReserved += size;
+            return own;
+        }
+
+        byte* block = (byte*)NativeMemory.Alloc((nuint)_blockSize);
+        _blocks.Add((nint)block);
+        _bytesReserved += _blockSize;
+        _cursor = block + size;
+        _blockEnd = block + _blockSize;
+        return block;
+    }
+
+    private void Grow()
+    {
+        var old = _entries;
+        _entries = new Entry[old.Length * 2];
+        int mask = _entries.Length - 1;
+
+        foreach (ref readonly var entry in old.AsSpan())
+        {
+            if (entry.Text == null)
+                continue;
+
+            int slot = entry.Hash & mask;
+            while (_entries[slot].Text != null)
+                slot = (slot + 1) & mask;
+            _entries[slot] = entry;
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static int Hash(ReadOnlySpan<byte> utf8)
+    {
+        var hash = new HashCode();
+        hash.AddBytes(utf8);
+        return hash.ToHashCode() & int.MaxValue;
+    }
+}
@@ -0,0 +1,293 @@
+using System.Buffers.Binary;
+using System.Buffers.Text;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Text;
+using NativeInterop;
+
+namespace GoldsrcFramework.Strings;
+
+/// <summary>
+/// Zero-copy view over a UTF-8 engine string (NChar*), for inspecting names, keyvalues and command arguments
+/// without turning them into managed strings.
+///
+/// Equality and case-insensitive compare run on the vectorized span / <see cref="Ascii"/> primitives.
+/// Case-insensitive means ASCII only, as the engine's Q_stricmp does.
+/// <see cref="GetStableHashCode()"/> does not change between runs, so it can key precomputed tables.
+/// Number parsing follows atoi / atof: leading whitespace is skipped, trailing garbage ignored.
+///
+/// The view is only valid as long as the engine keeps the string alive, which for Cmd_Argv and
+/// KeyValueData means the current callback.
+/// </summary>
+public readonly unsafe ref struct Utf8View
+{
+    private const ulong Seed = 0x9E3779B97F4A7C15;
+    private const ulong Prime1 = 0xC2B2AE3D27D4EB4F;
+    private const ulong Prime2 = 0x165667B19E3779F9;
+
+    private readonly ReadOnlySpan<byte> _bytes;
+
+    public Utf8View(ReadOnlySpan<byte> bytes)
+    {
+        _bytes = bytes;
+    }
+
+    /// <summary>
+    /// View over a null-terminated engine string; null gives an empty view.
+    /// </summary>
+    public Utf8View(NChar* text)
+    {
+        _bytes = text == null ? default : MemoryMarshal.CreateReadOnlySpanFromNullTerminated((byte*)text);
+    }
+
+    public static implicit operator Utf8View(ReadOnlySpan<byte> bytes) => new(bytes);
+
+    public static implicit operator ReadOnlySpan<byte>(Utf8View view) => view._bytes;
+
+    public ReadOnlySpan<byte> Span => _bytes;
+
+    public int Length => _bytes.Length;
+
+    public bool IsEmpty => _bytes.IsEmpty;
+
+    public byte this[int index] => _bytes[index];
+
+    public Utf8View Slice(int start) => new(_bytes[start..]);
+
+    public Utf8View Slice(int start, int length) => new(_bytes.Slice(start, length));
+
+    public int IndexOf(byte value) => _bytes.IndexOf(value);
+
+    /// <summary>
+    /// Strip leading and trailing ASCII whitespace.
+    /// </summary>
+    public Utf8View Trim() => new(_bytes[Ascii.Trim(_bytes)]);
+
+    #region Compare
+
+    public bool Equals(Utf8View other) => _bytes.SequenceEqual(other._bytes);
+
+    /// <summary>
+    /// Compare against ASCII text, e.g. a literal, without converting either side.
+    /// </summary>
+    public bool Equals(ReadOnlySpan<char> ascii) => Ascii.Equals(_bytes, ascii);
+
+    public bool EqualsIgnoreCase(Utf8View other) => Ascii.EqualsIgnoreCase(_bytes, other._bytes);
+
+    public bool EqualsIgnoreCase(ReadOnlySpan<char> ascii) => Ascii.EqualsIgnoreCase(_bytes, ascii);
+
+    public bool StartsWith(Utf8View prefix) => _bytes.StartsWith(prefix._bytes);
+
+    public bool StartsWithIgnoreCase(Utf8View prefix) =>
+        prefix.Length <= _bytes.Length && Ascii.EqualsIgnoreCase(_bytes[..prefix.Length], prefix._bytes);
+
+    public bool EndsWith(Utf8View suffix) => _bytes.EndsWith(suffix._bytes);
+
+    /// <summary>
+    /// Ordinal (byte-wise) comparison, like strcmp.
+    /// </summary>
+    public int CompareTo(Utf8View other) => _bytes.SequenceCompareTo(other._bytes);
+
+    public static bool operator ==(Utf8View left, Utf8View right) => left.Equals(right);
+
+    public static bool operator !=(Utf8View left, Utf8View right) => !left.Equals(right);
+
+    /// <summary>
+    /// Not supported: a view cannot be boxed.
+    /// </summary>
+    public override bool Equals(object? obj) => throw new NotSupportedException("Utf8View cannot be compared to a boxed value.");
+
+    public override int GetHashCode() => GetStableHashCode();
+
+    #endregion
+
+    #region Hash
+
+    /// <summary>
+    /// Hash of the bytes that is the same in every process, unlike <see cref="string.GetHashCode()"/>.
+    /// </summary>
+    public int GetStableHashCode() => GetStableHashCode(_bytes, ignoreCase: false);
+
+    /// <summary>
+    /// Stable hash that is equal for strings that differ only in ASCII case.
+    /// </summary>
+    public int GetStableHashCodeIgnoreCase() => GetStableHashCode(_bytes, ignoreCase: true);
+
+    /// <summary>
+    /// Stable hash over 8-byte words. With <paramref name="ignoreCase"/> ASCII letters are lowered in-register first.
+    /// </summary>
+    public static int GetStableHashCode(ReadOnlySpan<byte> bytes, bool ignoreCase)
+    {
+        ulong h = Seed ^ ((ulong)bytes.Length * Prime1);
+        int i = 0;
+        for (; i + 8 <= bytes.Length; i += 8)
+        {
+            ulong word = BinaryPrimitives.ReadUInt64LittleEndian(bytes[i..]);
+            h = Mix(h, ignoreCase ? ToLowerAscii(word) : word);
+        }
+
+        if (i < bytes.Length)
+        {
+            ulong tail = 0;
+            for (int shift = 0; i < bytes.Length; i++, shift += 8)
+                tail |= (ulong)bytes[i] << shift;
+            h = Mix(h, ignoreCase ? ToLowerAscii(tail) : tail);
+        }
+
+        // fmix64 from MurmurHash3
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCD;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53;
+        h ^= h >> 33;
+        return (int)h ^ (int)(h >> 32);
+    }
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static ulong Mix(ulong h, ulong word) => BitOperations.RotateLeft(h ^ (word * Prime1), 31) * Prime2;
+
+    // Lower 'A'..'Z' in all eight bytes at once; bytes >= 0x80 are left alone.
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static ulong ToLowerAscii(ulong word)
+    {
+        const ulong High = 0x8080808080808080;
+        ulong heptets = word & ~High;
+        ulong aboveZ = heptets + 0x2525252525252525;    // 0x7F - 'Z'
+        ulong atLeastA = heptets + 0x3F3F3F3F3F3F3F3F;  // 0x80 - 'A'
+        ulong upper = ~word & (atLeastA ^ aboveZ) & High;
+        return word | (upper >> 2);
+    }
+
+    #endregion
+
+    #region Numbers
+
+    /// <summary>
+    /// atoi: leading whitespace skipped, parsing stops at the first non-digit, 0 when there is no number.
+    /// Values out of range are clamped.
+    /// </summary>
+    public int ToInt32()
+    {
+        var s = _bytes[SkipWhitespace(_bytes)..];
+        bool negative = false;
+        if (!s.IsEmpty && (s[0] == '-' || s[0] == '+'))
+        {
+            negative = s[0] == '-';
+            s = s[1..];
+        }
+
+        long value = 0;
+        foreach (byte b in s)
+        {
+            uint digit = (uint)(b - '0');
+            if (digit > 9)
+                break;
+            value = Math.Min(value * 10 + digit, (long)int.MaxValue + 1);
+        }
+
+        return (int)Math.Clamp(negative ? -value : value, int.MinValue, int.MaxValue);
+    }
+
+    /// <summary>
+    /// atof: leading whitespace skipped, the longest numeric prefix is parsed, 0 when there is no number.
+    /// </summary>
+    public float ToSingle()
+    {
+        var s = _bytes[SkipWhitespace(_bytes)..];
+        if (!s.IsEmpty && s[0] == '+')
+            s = s[1..];
+        if (TryParseDecimal(s, out double fast))
+            return (float)fast;
+        // Like atof, round to double first and let the caller narrow.
+        return Utf8Parser.TryParse(s, out double value, out _) ? (float)value : 0f;
+    }
+
+    /// <summary>
+    /// Strict parse: the whole view, ignoring surrounding whitespace, must be an integer.
+    /// </summary>
+    public bool TryParseInt32(out int value)
+    {
+        var s = _bytes[Ascii.Trim(_bytes)];
+        return Utf8Parser.TryParse(s, out value, out int consumed) && consumed == s.Length && s.Length > 0;
+    }
+
+    /// <summary>
+    /// Strict parse: the whole view, ignoring surrounding whitespace, must be a number.
+    /// </summary>
+    public bool TryParseSingle(out float value)
+    {
+        var s = _bytes[Ascii.Trim(_bytes)];
+        return Utf8Parser.TryParse(s, out value, out int consumed) && consumed == s.Length && s.Length > 0;
+    }
+
+    // Fast path for the plain "-123.25" numbers that make up nearly all keyvalues: at most 15 significant digits and
+    // no exponent, so mantissa and power of ten are exact doubles and one division rounds exactly as strtod does.
+    // Anything else (exponents, long mantissas, inf/nan) goes to the general parser.
+    private static bool TryParseDecimal(ReadOnlySpan<byte> s, out double value)
+    {
+        value = 0;
+        int i = 0;
+        bool negative = false;
+        if (i < s.Length && s[i] == '-')
+        {
+            negative = true;
+            i++;
+        }
+
+        long mantissa = 0;
+        int digits = 0, scale = 0;
+        bool point = false;
+        for (; i < s.Length; i++)
+        {
+            byte b = s[i];
+            if (b == '.' && !point)
+            {
+                point = true;
+                continue;
+            }
+
+            uint digit = (uint)(b - '0');
+            if (digit > 9)
+            {
+                if ((b | 0x20) == 'e')
+                    return false;
+                break;
+            }
+
+            if (++digits > 15)
+                return false;
+            mantissa = mantissa * 10 + digit;
+            if (point)
+                scale++;
+        }
+
+        if (digits == 0)
+            return false;
+
+        value = scale == 0 ? mantissa : mantissa / s_powersOf10[scale];
+        if (negative)
+            value = -value;
+        return true;
+    }
+
+    private static readonly double[] s_powersOf10 =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+    };
+
+    private static int SkipWhitespace(ReadOnlySpan<byte> s)
+    {
+        int i = 0;
+        while (i < s.Length && s[i] <= ' ' && s[i] != 0)
+            i++;
+        return i;
+    }
+
+    #endregion
+
+    /// <summary>
+    /// Allocates a managed copy; for logging and APIs that need a string.
+    /// </summary>
+    public override string ToString() => Encoding.UTF8.GetString(_bytes);
+}
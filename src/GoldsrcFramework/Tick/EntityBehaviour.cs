@@ -0,0 +1,29 @@
+using GoldsrcFramework.Engine.Native;
+
+namespace GoldsrcFramework.Tick;
+
+/// <summary>
+/// Per-entity logic that runs on a worker thread during <see cref="ParallelTick"/>.
+///
+/// <see cref="Tick"/> must only read the snapshot and its own fields and express every world change as a command;
+/// it must not call engine functions. Commands are applied on the main thread in registration order.
+/// </summary>
+public abstract unsafe class EntityBehaviour
+{
+    /// <summary>
+    /// Edict index of the entity this behaviour drives.
+    /// </summary>
+    public int EntityIndex { get; internal set; }
+
+    /// <summary>
+    /// Run once per tick only when the entity is in use. Worker thread.
+    /// </summary>
+    public abstract void Tick(WorldSnapshot world, in EntitySnapshot self, ref TickCommandWriter commands);
+
+    /// <summary>
+    /// Apply a Fire / Custom command emitted by <see cref="Tick"/>. Main thread; engine calls are allowed here.
+    /// </summary>
+    public virtual void OnCommand(edict_t* edict, in TickCommand command)
+    {
+    }
+}
@@ -0,0 +1,255 @@
+using System.Diagnostics;
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.Jobs;
+using NativeInterop;
+
+namespace GoldsrcFramework.Tick;
+
+/// <summary>
+/// Per-tick counters reported by <see cref="ParallelTick"/>.
+/// </summary>
+public struct ParallelTickStats
+{
+    public int Behaviours;
+    public int Commands;
+    /// <summary>Commands dropped because their entity was freed or reused.</summary>
+    public int StaleCommands;
+    /// <summary>Behaviours that threw during Tick.</summary>
+    public int Faults;
+    public double CaptureMilliseconds;
+    public double TickMilliseconds;
+    public double ApplyMilliseconds;
+}
+
+/// <summary>
+/// Double-buffered parallel tick for managed entity behaviours, driven from StartFrame.
+///
+/// 1. Main thread: capture the edicts into a <see cref="WorldSnapshot"/> (the previous one stays readable as <see cref="Previous"/>).
+/// 2. Workers: behaviours are split into fixed chunks; each chunk runs on one worker and writes its own command buffer.
+/// 3. Main thread: buffers are applied in chunk order, so the result is identical for any worker count.
+/// </summary>
+public sealed unsafe class ParallelTick
+{
+    private readonly List<EntityBehaviour> _behaviours = new();
+    private readonly List<TickCommandBuffer> _buffers = new();
+    private readonly List<EntityBehaviour> _pendingRemovals = new();
+    private readonly ParallelOptions _parallelOptions;
+    private readonly Action<int> _tickChunk;
+    private readonly JobScheduler? _scheduler;
+    private readonly int _chunkSize;
+
+    private WorldSnapshot _current = new();
+    private WorldSnapshot _previous = new();
+    private int _faults;
+    private bool _running;
+    private ParallelTickStats _stats;
+
+    /// <param name="workerCount">Max threads used for behaviours; 0 uses Environment.ProcessorCount. Ignored with a scheduler.</param>
+    /// <param name="chunkSize">Behaviours per work item.</param>
+    /// <param name="scheduler">Run the chunks on this job scheduler instead of the thread pool.</param>
+    public ParallelTick(int workerCount = 0, int chunkSize = 16, JobScheduler? scheduler = null)
+    {
+        _chunkSize = Math.Max(chunkSize, 1);
+        _scheduler = scheduler;
+        _parallelOptions = new ParallelOptions
+        {
+            MaxDegreeOfParallelism = scheduler != null ? scheduler.WorkerCount + 1
+                                   : workerCount > 0 ? workerCount : Environment.ProcessorCount
+        };
+        _tickChunk = TickChunk;
+    }
+
+    /// <summary>
+    /// Snapshot for the tick in progress (or the last one).
+    /// </summary>
+    public WorldSnapshot Current => _current;
+
+    /// <summary>
+    /// Snapshot of the tick before.
+    /// </summary>
+    public WorldSnapshot Previous => _previous;
+
+    public int WorkerCount => _parallelOptions.MaxDegreeOfParallelism;
+
+    public int BehaviourCount => _behaviours.Count;
+
+    /// <summary>
+    /// Counters from the last <see cref="Run"/> call.
+    /// </summary>
+    public ParallelTickStats LastTick => _stats;
+
+    /// <summary>
+    /// Attach a behaviour to an edict. Main thread, outside of <see cref="Run"/>.
+    /// </summary>
+    public void Register(EntityBehaviour behaviour, int entityIndex)
+    {
+        behaviour.EntityIndex = entityIndex;
+        _behaviours.Add(behaviour);
+    }
+
+    /// <summary>
+    /// Detach a behaviour. Keeps the order of the others, so application order stays stable.
+    /// Called from OnCommand, the removal is deferred to the end of the tick.
+    /// </summary>
+    public void Unregister(EntityBehaviour behaviour)
+    {
+        if (_running)
+            _pendingRemovals.Add(behaviour);
+        else
+            _behaviours.Remove(behaviour);
+    }
+
+    /// <summary>
+    /// Detach every behaviour, e.g. at ServerDeactivate.
+    /// </summary>
+    public void Clear()
+    {
+        _behaviours.Clear();
+        _buffers.Clear();
+    }
+
+    /// <summary>
+    /// Run one tick. Call from StartFrame on the main thread.
+    /// </summary>
+    public void Run(ServerEngineFuncs* engine, edict_t* edicts, int edictCount, float time, float frameTime)
+    {
+        _stats = default;
+        if (_behaviours.Count == 0)
+            return;
+
+        long t0 = Stopwatch.GetTimestamp();
+        (_current, _previous) = (_previous, _current);
+        _current.Capture(edicts, edictCount, time, frameTime);
+
+        long t1 = Stopwatch.GetTimestamp();
+        int chunks = (_behaviours.Count + _chunkSize - 1) / _chunkSize;
+        while (_buffers.Count < chunks)
+            _buffers.Add(new TickCommandBuffer());
+
+        _faults = 0;
+        if (chunks == 1 || _parallelOptions.MaxDegreeOfParallelism == 1)
+        {
+            for (int i = 0; i < chunks; i++)
+                TickChunk(i);
+        }
+        else
+        {
+            if (_scheduler != null)
+                _scheduler.ParallelFor(new TickChunkJob(this), chunks, 1);
+            else
+                Parallel.For(0, chunks, _parallelOptions, _tickChunk);
+        }
+
+        long t2 = Stopwatch.GetTimestamp();
+        _running = true;
+        try
+        {
+            for (int i = 0; i < chunks; i++)
+                Apply(engine, edicts, edictCount, _buffers[i]);
+        }
+        finally
+        {
+            _running = false;
+            foreach (var behaviour in _pendingRemovals)
+                _behaviours.Remove(behaviour);
+            _pendingRemovals.Clear();
+        }
+        long t3 = Stopwatch.GetTimestamp();
+
+        _stats.Behaviours = _behaviours.Count;
+        _stats.Faults = _faults;
+        _stats.CaptureMilliseconds = Stopwatch.GetElapsedTime(t0, t1).TotalMilliseconds;
+        _stats.TickMilliseconds = Stopwatch.GetElapsedTime(t1, t2).TotalMilliseconds;
+        _stats.ApplyMilliseconds = Stopwatch.GetElapsedTime(t2, t3).TotalMilliseconds;
+
+        if (_faults > 0)
+            Debug.WriteLine($"[ParallelTick] {_faults} behaviour(s) threw during tick {_current.FrameNumber}");
+    }
+
+    private readonly struct TickChunkJob : IJobRange
+    {
+        private readonly ParallelTick _owner;
+
+        public TickChunkJob(ParallelTick owner) => _owner = owner;
+
+        public void Execute(int start, int end)
+        {
+            for (int i = start; i < end; i++)
+                _owner.TickChunk(i);
+        }
+    }
+
+    private void TickChunk(int chunk)
+    {
+        var buffer = _buffers[chunk];
+        buffer.Clear();
+
+        var world = _current;
+        int start = chunk * _chunkSize;
+        int end = Math.Min(start + _chunkSize, _behaviours.Count);
+
+        for (int i = start; i < end; i++)
+        {
+            var behaviour = _behaviours[i];
+            int index = behaviour.EntityIndex;
+            if ((uint)index >= (uint)world.Count)
+                continue;
+
+            ref readonly var self = ref world[index];
+            if (!self.InUse)
+                continue;
+
+            var writer = new TickCommandWriter(buffer, i, index, self.SerialNumber);
+            try
+            {
+                behaviour.Tick(world, in self, ref writer);
+            }
+            catch (Exception ex)
+            {
+                Interlocked.Increment(ref _faults);
+                Debug.WriteLine($"[ParallelTick] {behaviour.GetType().Name} on entity {index}: {ex}");
+            }
+        }
+    }
+
+    private void Apply(ServerEngineFuncs* engine, edict_t* edicts, int edictCount, TickCommandBuffer buffer)
+    {
+        foreach (ref readonly var c in buffer.Commands)
+        {
+            _stats.Commands++;
+
+            edict_t* e = (uint)c.Entity < (uint)edictCount ? &edicts[c.Entity] : null;
+            if (e == null || e->free.Value != 0 || e->serialnumber != c.SerialNumber)
+            {
+                _stats.StaleCommands++;
+                continue;
+            }
+
+            switch (c.Kind)
+            {
+                case TickCommandKind.SetOrigin:
+                {
+                    var origin = c.Vector;
+                    engine->SetOrigin(e, (float*)&origin);
+                    break;
+                }
+                case TickCommandKind.SetVelocity:
+                    e->v.velocity = c.Vector;
+                    break;
+                case TickCommandKind.SetAngles:
+                    e->v.angles = c.Vector;
+                    break;
+                case TickCommandKind.SetNextThink:
+                    e->v.nextthink = c.Value;
+                    break;
+                case TickCommandKind.EmitSound:
+                    engine->EmitSound(e, c.Channel, (NChar*)c.Sample, c.Value, c.Attenuation, 0, c.Pitch);
+                    break;
+                case TickCommandKind.Fire:
+                case TickCommandKind.Custom:
+                    _behaviours[c.Behaviour].OnCommand(e, in c);
+                    break;
+            }
+        }
+    }
+}
@@ -0,0 +1,162 @@
+using System.Runtime.InteropServices;
+using GoldsrcFramework.LinearMath;
+using GoldsrcFramework.Strings;
+using NativeInterop;
+
+namespace GoldsrcFramework.Tick;
+
+/// <summary>
+/// What a <see cref="TickCommand"/> does when applied on the main thread.
+/// </summary>
+public enum TickCommandKind : byte
+{
+    /// <summary>SET_ORIGIN with <see cref="TickCommand.Vector"/> (relinks the entity).</summary>
+    SetOrigin,
+    /// <summary>pev->velocity = <see cref="TickCommand.Vector"/>.</summary>
+    SetVelocity,
+    /// <summary>pev->angles = <see cref="TickCommand.Vector"/>.</summary>
+    SetAngles,
+    /// <summary>pev->nextthink = <see cref="TickCommand.Value"/>.</summary>
+    SetNextThink,
+    /// <summary>EMIT_SOUND_DYN with channel, sample, volume (Value), attenuation and pitch.</summary>
+    EmitSound,
+    /// <summary>Handed back to the behaviour's OnCommand; Vector is the aim direction.</summary>
+    Fire,
+    /// <summary>Handed back to the behaviour's OnCommand.</summary>
+    Custom,
+}
+
+/// <summary>
+/// A deferred world mutation emitted by a behaviour on a worker thread.
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+public struct TickCommand
+{
+    public TickCommandKind Kind;
+    /// <summary>Target edict index.</summary>
+    public int Entity;
+    /// <summary>Serial number of the target when the snapshot was taken; stale commands are dropped.</summary>
+    public int SerialNumber;
+    /// <summary>Index of the emitting behaviour in the tick's registration order.</summary>
+    public int Behaviour;
+    public Vector3 Vector;
+    public float Value;
+    public float Attenuation;
+    public int Channel;
+    public int Pitch;
+    /// <summary>Behaviour-defined payload for Fire / Custom.</summary>
+    public int Data;
+    /// <summary>NChar* sound sample, interned in Utf8StringPool.Shared when the command is written.</summary>
+    public nint Sample;
+}
+
+/// <summary>
+/// Growable command list written by exactly one worker at a time.
+/// </summary>
+internal sealed class TickCommandBuffer
+{
+    private TickCommand[] _items = new TickCommand[64];
+
+    public int Count { get; private set; }
+
+    public ReadOnlySpan<TickCommand> Commands => _items.AsSpan(0, Count);
+
+    public void Add(in TickCommand command)
+    {
+        if (Count == _items.Length)
+            Array.Resize(ref _items, _items.Length * 2);
+        _items[Count++] = command;
+    }
+
+    public void Clear() => Count = 0;
+}
+
+/// <summary>
+/// Command emitter handed to <see cref="EntityBehaviour.Tick"/>. Commands always target the behaviour's own entity.
+/// </summary>
+public readonly unsafe ref struct TickCommandWriter
+{
+    private readonly TickCommandBuffer _buffer;
+    private readonly int _behaviour;
+    private readonly int _entity;
+    private readonly int _serialNumber;
+
+    internal TickCommandWriter(TickCommandBuffer buffer, int behaviour, int entity, int serialNumber)
+    {
+        _buffer = buffer;
+        _behaviour = behaviour;
+        _entity = entity;
+        _serialNumber = serialNumber;
+    }
+
+    private TickCommand Create(TickCommandKind kind) => new()
+    {
+        Kind = kind,
+        Entity = _entity,
+        SerialNumber = _serialNumber,
+        Behaviour = _behaviour,
+    };
+
+    /// <summary>
+    /// Move to <paramref name="origin"/> (SET_ORIGIN).
+    /// </summary>
+    public void Move(Vector3 origin)
+    {
+        var c = Create(TickCommandKind.SetOrigin);
+        c.Vector = origin;
+        _buffer.Add(in c);
+    }
+
+    public void SetVelocity(Vector3 velocity)
+    {
+        var c = Create(TickCommandKind.SetVelocity);
+        c.Vector = velocity;
+        _buffer.Add(in c);
+    }
+
+    public void SetAngles(Vector3 angles)
+    {
+        var c = Create(TickCommandKind.SetAngles);
+        c.Vector = angles;
+        _buffer.Add(in c);
+    }
+
+    public void SetNextThink(float time)
+    {
+        var c = Create(TickCommandKind.SetNextThink);
+        c.Value = time;
+        _buffer.Add(in c);
+    }
+
+    /// <summary>
+    /// Play <paramref name="sample"/> on the entity. The name is copied, so a temporary buffer is fine.
+    /// </summary>
+    public void EmitSound(int channel, NChar* sample, float volume, float attenuation, int pitch = 100)
+    {
+        var c = Create(TickCommandKind.EmitSound);
+        c.Channel = channel;
+        // The caller's pointer is only known to be valid during Tick; the command is applied after it returns.
+        c.Sample = (nint)Utf8StringPool.Shared.Intern(MemoryMarshal.CreateReadOnlySpanFromNullTerminated((byte*)sample));
+        c.Value = volume;
+        c.Attenuation = attenuation;
+        c.Pitch = pitch;
+        _buffer.Add(in c);
+    }
+
+    public void Fire(Vector3 direction, int data = 0)
+    {
+        var c = Create(TickCommandKind.Fire);
+        c.Vector = direction;
+        c.Data = data;
+        _buffer.Add(in c);
+    }
+
+    public void Custom(int data, Vector3 vector = default, float value = 0)
+    {
+        var c = Create(TickCommandKind.Custom);
+        c.Data = data;
+        c.Vector = vector;
+        c.Value = value;
+        _buffer.Add(in c);
+    }
+}
@@ -0,0 +1,130 @@
+using GoldsrcFramework.Engine.Native;
+using GoldsrcFramework.LinearMath;
+
+namespace GoldsrcFramework.Tick;
+
+/// <summary>
+/// Frozen copy of the entvars a behaviour typically needs, taken on the main thread at the start of a tick.
+/// Entity references are stored as edict indices (0 = none / world).
+/// </summary>
+public struct EntitySnapshot
+{
+    public int Index;
+    public int SerialNumber;
+    /// <summary>False for free edict slots and slots the engine has not spawned anything in.</summary>
+    public bool InUse;
+
+    public string_t ClassName;
+    public Vector3 Origin;
+    public Vector3 Angles;
+    public Vector3 Velocity;
+    public Vector3 Mins;
+    public Vector3 Maxs;
+    public Vector3 ViewOffset;
+    public float Health;
+    public float NextThink;
+    public int MoveType;
+    public int Solid;
+    public int Flags;
+    public int Team;
+    public int DeadFlag;
+
+    public int Owner;
+    public int Enemy;
+    public int GroundEntity;
+}
+
+/// <summary>
+/// Read-only world state for one tick. Filled on the main thread, then shared by every worker.
+/// </summary>
+public sealed unsafe class WorldSnapshot
+{
+    private EntitySnapshot[] _entities = Array.Empty<EntitySnapshot>();
+
+    /// <summary>
+    /// Number of edict slots captured: up to and including the highest one in use.
+    /// </summary>
+    public int Count { get; private set; }
+
+    /// <summary>
+    /// gpGlobals->time at capture.
+    /// </summary>
+    public float Time { get; private set; }
+
+    /// <summary>
+    /// gpGlobals->frametime at capture.
+    /// </summary>
+    public float FrameTime { get; private set; }
+
+    /// <summary>
+    /// Increments on every capture.
+    /// </summary>
+    public int FrameNumber { get; private set; }
+
+    /// <summary>
+    /// Snapshot of edict <paramref name="index"/>.
+    /// </summary>
+    public ref readonly EntitySnapshot this[int index] => ref _entities[index];
+
+    /// <summary>
+    /// All captured slots, indexed by edict index.
+    /// </summary>
+    public ReadOnlySpan<EntitySnapshot> Entities => _entities.AsSpan(0, Count);
+
+    /// <summary>
+    /// Copy entvars from the engine's edict array. Main thread only.
+    /// </summary>
+    /// <param name="count">Edict slots allocated by the engine (gpGlobals->maxEntities); only the used part is copied.</param>
+    internal void Capture(edict_t* edicts, int count, float time, float frameTime)
+    {
+        // Slots past the last spawned entity are zeroed memory, not free edicts: skip them.
+        while (count > 1 && !IsInUse(&edicts[count - 1]))
+            count--;
+
+        if (_entities.Length < count)
+            _entities = new EntitySnapshot[Math.Max(count, _entities.Length * 2)];
+
+        Count = count;
+        Time = time;
+        FrameTime = frameTime;
+        FrameNumber++;
+
+        for (int i = 0; i < count; i++)
+        {
+            edict_t* e = &edicts[i];
+            ref var s = ref _entities[i];
+            s.Index = i;
+            s.SerialNumber = e->serialnumber;
+            s.InUse = IsInUse(e);
+            if (!s.InUse)
+                continue;
+
+            ref var v = ref e->v;
+            s.ClassName = v.classname;
+            s.Origin = v.origin;
+            s.Angles = v.angles;
+            s.Velocity = v.velocity;
+            s.Mins = v.mins;
+            s.Maxs = v.maxs;
+            s.ViewOffset = v.view_ofs;
+            s.Health = v.health;
+            s.NextThink = v.nextthink;
+            s.MoveType = v.movetype;
+            s.Solid = v.solid;
+            s.Flags = v.flags;
+            s.Team = v.team;
+            s.DeadFlag = v.deadflag;
+            s.Owner = IndexOf(edicts, count, v.owner);
+            s.Enemy = IndexOf(edicts, count, v.enemy);
+            s.GroundEntity = IndexOf(edicts, count, v.groundentity);
+        }
+    }
+
+    private static bool IsInUse(edict_t* e) => e->free.Value == 0 && e->pvPrivateData != null;
+
+    private static int IndexOf(edict_t* edicts, int count, edict_t* e)
+    {
+        long index = e - edicts;
+        return e != null && index > 0 && index < count ? (int)index : 0;
+    }
+}